@@ -0,0 +1,62 @@
+// mfa-bench 전용 할당 계수 훅: 전역 operator new/delete를 교체해 스레드별로 센다.
+// 서버/코어 라이브러리에는 링크되지 않는다.
+
+#include "alloc_counter.h"
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+    thread_local uint64_t alloc_count = 0;
+    thread_local uint64_t alloc_bytes = 0;
+
+    void* countedAlloc(std::size_t size) {
+        alloc_count++;
+        alloc_bytes += size;
+        void* ptr = std::malloc(size ? size : 1);
+        if (!ptr) throw std::bad_alloc();
+        return ptr;
+    }
+
+    void* countedAlignedAlloc(std::size_t size, std::align_val_t align) {
+        alloc_count++;
+        alloc_bytes += size;
+        std::size_t alignment = static_cast<std::size_t>(align);
+        if (alignment < sizeof(void*)) alignment = sizeof(void*);
+        void* ptr = nullptr;
+        if (posix_memalign(&ptr, alignment, size ? size : 1) != 0) throw std::bad_alloc();
+        return ptr;
+    }
+}
+
+namespace bench {
+
+AllocStats allocStats() {
+    AllocStats stats;
+    stats.count = alloc_count;
+    stats.bytes = alloc_bytes;
+    return stats;
+}
+
+}
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void* operator new(std::size_t size, std::align_val_t align) { return countedAlignedAlloc(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return countedAlignedAlloc(size, align); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try { return countedAlloc(size); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try { return countedAlloc(size); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
@@ -0,0 +1,38 @@
+#ifndef MFA_BENCH_ALLOC_COUNTER_H
+#define MFA_BENCH_ALLOC_COUNTER_H
+
+#include <cstdint>
+
+namespace bench {
+
+/**
+ * @brief 현재 스레드의 힙 할당 횟수/바이트 (mfa-bench 전용 전역 operator new 교체로 집계)
+ */
+struct AllocStats {
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+};
+
+AllocStats allocStats();
+
+/**
+ * @brief 구간 동안 현재 스레드에서 일어난 할당 수를 세는 도우미
+ *
+ *   bench::AllocScope scope;
+ *   handle(request);
+ *   uint64_t n = scope.count();
+ */
+class AllocScope {
+public:
+    AllocScope() : start(allocStats()) {}
+
+    uint64_t count() const { return allocStats().count - start.count; }
+    uint64_t bytes() const { return allocStats().bytes - start.bytes; }
+
+private:
+    AllocStats start;
+};
+
+}
+
+#endif // MFA_BENCH_ALLOC_COUNTER_H
@@ -0,0 +1,176 @@
+#ifndef MFA_BENCH_H
+#define MFA_BENCH_H
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+#include "logger.h"
+
+namespace bench {
+
+/**
+ * @brief 벤치마크 실행 옵션 (명령행 인자)
+ */
+struct Options {
+    std::string filter;                 // 이름에 포함된 벤치마크만 실행
+    size_t max_users = 10000000;        // 사용자 수 스윕 상한
+    std::string work_dir = "bench_data"; // 픽스처 파일 디렉토리
+    double min_seconds = 0.2;           // 측정 구간 최소 시간
+    std::string json_path;              // 비어 있지 않으면 결과를 JSON으로 저장
+};
+
+/**
+ * @brief 측정 결과 한 줄 (JSON 출력용으로 보관)
+ */
+struct Result {
+    std::string name;
+    std::string param;
+    uint64_t iterations = 0;
+    double elapsed_ns = 0;
+    std::string extra;
+};
+
+/**
+ * @brief 벤치마크 실행 컨텍스트 (옵션 접근 및 결과 보고)
+ */
+class State {
+public:
+    explicit State(const Options& opts) : options(opts) {}
+
+    const Options& options;
+
+    /**
+     * @brief 측정 결과 한 줄 보고
+     * @param name 벤치마크 이름
+     * @param param 파라미터 설명 (예: "users=1000")
+     * @param iterations 반복 횟수
+     * @param elapsed_ns 전체 소요 시간 (ns)
+     * @param extra 추가 지표 (예: "p99=1200ns")
+     */
+    void report(const std::string& name, const std::string& param,
+                uint64_t iterations, double elapsed_ns, const std::string& extra = "");
+
+    /**
+     * @brief 검증 실패 기록 (mfa-bench 종료 코드가 1이 됨)
+     * @param name 벤치마크 이름
+     * @param message 실패 내용
+     */
+    void fail(const std::string& name, const std::string& message);
+
+    bool failed() const { return !failures.empty(); }
+
+    /**
+     * @brief 지금까지의 결과와 실패를 JSON 문서로 기록 (실행끼리 diff/비교용)
+     * @param out 출력 스트림
+     */
+    void writeJSON(std::ostream& out) const;
+
+private:
+    std::vector<Result> results;
+    std::vector<std::pair<std::string, std::string>> failures;   // (벤치마크 이름, 실패 내용)
+};
+
+using BenchFn = void (*)(State&);
+
+std::vector<std::pair<std::string, BenchFn>>& registry();
+
+struct Registrar {
+    Registrar(const char* name, BenchFn fn) { registry().emplace_back(name, fn); }
+};
+
+inline uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * @brief 최소 시간 이상 fn을 반복 실행
+ * @param iterations 실제 반복 횟수를 받을 변수
+ * @return 전체 소요 시간 (ns)
+ */
+template <typename F>
+double measure(F&& fn, uint64_t& iterations, double min_seconds) {
+    uint64_t batch = 1;
+    iterations = 0;
+    uint64_t start = nowNs();
+    uint64_t elapsed = 0;
+    while (elapsed < static_cast<uint64_t>(min_seconds * 1e9)) {
+        for (uint64_t i = 0; i < batch; i++) {
+            fn(iterations + i);
+        }
+        iterations += batch;
+        if (batch < (1u << 20)) batch *= 2;
+        elapsed = nowNs() - start;
+    }
+    return static_cast<double>(elapsed);
+}
+
+/**
+ * @brief 컴파일러가 결과를 제거하지 못하게 유지
+ */
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @brief 측정 중 코어의 로그 출력을 버리는 RAII 가드
+ */
+class QuietStdout {
+    struct NullBuf : std::streambuf {
+        int overflow(int c) override { return c; }
+    } null_buf;
+    std::streambuf* saved;
+    Log::Level saved_level;
+
+public:
+    QuietStdout() : saved(std::cout.rdbuf(&null_buf)), saved_level(Log::level()) {
+        Log::setLevel(Log::Level::Off);
+    }
+    ~QuietStdout() {
+        Log::setLevel(saved_level);
+        std::cout.rdbuf(saved);
+    }
+};
+
+/**
+ * @brief 합성 users.dat 픽스처 생성 (이미 같은 크기면 재사용)
+ * @param path 파일 경로
+ * @param user_count 사용자 수
+ * @return 성공 시 true
+ */
+bool writeUserFixture(const std::string& path, size_t user_count);
+
+/**
+ * @brief 작업 디렉토리의 users_<N>.dat 픽스처를 준비
+ * @param state 실패를 기록할 컨텍스트
+ * @param name 실패를 기록할 벤치마크 이름
+ * @param user_count 사용자 수
+ * @return 픽스처 경로 (생성에 실패하면 state.fail을 부르고 빈 문자열)
+ */
+std::string prepareUserFixture(State& state, const std::string& name, size_t user_count);
+
+/**
+ * @brief TLS 벤치마크용 자체 서명 인증서/키를 PEM으로 저장 (CN=localhost, 하루 유효)
+ * @param ecdsa true면 ECDSA P-256, false면 RSA 2048
+ * @return 성공 시 true
+ */
+bool writeSelfSignedCert(const std::string& cert_path, const std::string& key_path, bool ecdsa);
+
+/**
+ * @brief 픽스처의 i번째 사용자 ID
+ */
+std::string fixtureUserId(size_t index);
+
+} // namespace bench
+
+#define MFA_BENCHMARK(fn)                                         \
+    static void fn(bench::State& state);                          \
+    static bench::Registrar fn##_registrar(#fn, fn);              \
+    static void fn(bench::State& state)
+
+#endif // MFA_BENCH_H
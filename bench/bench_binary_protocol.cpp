@@ -0,0 +1,283 @@
+#include "bench.h"
+#include "latency_histogram.h"
+#include "mfa_client.h"
+#include "mfa_core.h"
+#include "server.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+    constexpr size_t FIXTURE_USERS = 100000;
+    constexpr size_t PIPELINE_DEPTHS[] = {1, 16, 64};
+    const char WRONG_CODE[] = "123456";     // 모든 경로가 같은 일(조회 + HMAC 3번)을 하도록 틀린 코드 사용
+
+    int freePort() {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(addr);
+        int port = 0;
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0 &&
+            getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &length) == 0) {
+            port = ntohs(addr.sin_port);
+        }
+        ::close(fd);
+        return port;
+    }
+
+    int connectLoopback(int port) {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            ::close(fd);
+            return -1;
+        }
+        int yes = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+        return fd;
+    }
+
+    // 픽스처 i번째 사용자의 Base32 시크릿 (레코드: user_id 칸 + 시크릿 칸)
+    std::string fixtureSecret(const std::string& path, size_t index) {
+        std::ifstream file(path, std::ios::binary);
+        file.seekg(static_cast<std::streamoff>(index * (MAX_USER_ID_LENGTH + BASE32_ENCODED_MAX_LENGTH) +
+                                               MAX_USER_ID_LENGTH));
+        char secret[32];
+        file.read(secret, sizeof(secret));
+        return file ? std::string(secret, sizeof(secret)) : std::string();
+    }
+
+    struct RunResult {
+        uint64_t requests = 0;
+        uint64_t rejected = 0;              // 401 / Invalid (틀린 코드라 정상)
+        uint64_t unexpected = 0;
+        double elapsed_ns = 0;
+        LatencyHistogram round_trip;        // depth개를 보내고 모두 받을 때까지
+    };
+
+    /**
+     * @brief HTTP keep-alive 연결 하나로 /api/authenticate를 depth개씩 파이프라이닝
+     */
+    bool runHTTP(int port, size_t depth, double min_seconds, RunResult& result) {
+        int fd = connectLoopback(port);
+        if (fd < 0) return false;
+
+        std::string batch;
+        std::string in;
+        size_t next_user = 0;
+        uint64_t start = bench::nowNs();
+        bool ok = true;
+        while (ok && static_cast<double>(bench::nowNs() - start) < min_seconds * 1e9) {
+            batch.clear();
+            for (size_t i = 0; i < depth; i++) {
+                char body[128];
+                int body_length = snprintf(body, sizeof(body), "{\"user_id\": \"%s\", \"otp_code\": \"%s\"}",
+                                           bench::fixtureUserId(next_user++ % FIXTURE_USERS).c_str(), WRONG_CODE);
+                batch += "POST /api/authenticate HTTP/1.1\r\nHost: bench\r\nContent-Type: application/json\r\n"
+                         "Content-Length: " + std::to_string(body_length) + "\r\n\r\n";
+                batch.append(body, static_cast<size_t>(body_length));
+            }
+
+            uint64_t sent = bench::nowNs();
+            ok = ::send(fd, batch.data(), batch.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(batch.size());
+            size_t received = 0;
+            while (ok && received < depth) {
+                // 응답 하나: 상태 줄 + 헤더 + Content-Length 본문
+                size_t head_end = in.find("\r\n\r\n");
+                size_t length_pos = in.find("Content-Length: ");
+                if (head_end != std::string::npos && length_pos != std::string::npos && length_pos < head_end) {
+                    size_t total = head_end + 4 + std::stoul(in.substr(length_pos + 16));
+                    if (in.size() >= total) {
+                        int status = std::atoi(in.c_str() + 9);
+                        if (status == 401) result.rejected++;
+                        else result.unexpected++;
+                        in.erase(0, total);
+                        received++;
+                        continue;
+                    }
+                }
+                char buffer[16384];
+                ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+                if (n <= 0) ok = false;
+                else in.append(buffer, static_cast<size_t>(n));
+            }
+            result.round_trip.record(bench::nowNs() - sent);
+            result.requests += received;
+        }
+        result.elapsed_ns = static_cast<double>(bench::nowNs() - start);
+        ::close(fd);
+        return ok;
+    }
+
+    /**
+     * @brief 바이너리 프로토콜 연결 하나로 depth개씩 파이프라이닝 (요청 ID 순서도 검사)
+     */
+    bool runBinary(MFAClient& client, size_t depth, double min_seconds, RunResult& result) {
+        size_t next_user = 0;
+        uint64_t start = bench::nowNs();
+        while (static_cast<double>(bench::nowNs() - start) < min_seconds * 1e9) {
+            uint64_t sent = bench::nowNs();
+            uint32_t first_id = 0;
+            for (size_t i = 0; i < depth; i++) {
+                uint32_t request_id = 0;
+                if (!client.queue(bench::fixtureUserId(next_user++ % FIXTURE_USERS), WRONG_CODE, request_id)) {
+                    return false;
+                }
+                if (i == 0) first_id = request_id;
+            }
+            for (size_t i = 0; i < depth; i++) {
+                MFAClient::Result reply;
+                if (!client.receive(reply)) return false;
+                if (reply.status == MFAClient::Status::Invalid && reply.request_id == first_id + i) {
+                    result.rejected++;
+                } else {
+                    result.unexpected++;
+                }
+            }
+            result.round_trip.record(bench::nowNs() - sent);
+            result.requests += depth;
+        }
+        result.elapsed_ns = static_cast<double>(bench::nowNs() - start);
+        return true;
+    }
+
+    // 응답 상태 확인: 올바른 코드는 한 번만 통과, 형식 오류, 잘못된 프레임이면 연결 종료
+    void checkSemantics(bench::State& state, const std::string& user_file, int binary_port,
+                        const std::string& socket_path) {
+        MFAClient client;
+        if (!client.connectUnix(socket_path)) {
+            state.fail("binary_protocol", "unix connect: " + client.lastError());
+            return;
+        }
+
+        std::string secret = fixtureSecret(user_file, 7);
+        MFACore otp_core(state.options.work_dir + "/binary_protocol_codes.dat", StorageMode::Memory);
+        char code[8];
+        snprintf(code, sizeof(code), "%06d", otp_core.generateTOTPCode(secret));
+
+        MFAClient::Result first;
+        MFAClient::Result replay;
+        MFAClient::Result empty;
+        MFAClient::Result unknown;
+        if (!client.verify(bench::fixtureUserId(7), code, first) || !client.verify(bench::fixtureUserId(7), code, replay) ||
+            !client.verify(bench::fixtureUserId(8), "", empty) || !client.verify("no_such_user", code, unknown)) {
+            state.fail("binary_protocol", "verify: " + client.lastError());
+            return;
+        }
+        if (first.status != MFAClient::Status::Ok) state.fail("binary_protocol", "valid code was not accepted");
+        if (replay.status != MFAClient::Status::Invalid) state.fail("binary_protocol", "reused code was accepted");
+        if (empty.status != MFAClient::Status::BadRequest) state.fail("binary_protocol", "empty OTP was not a bad request");
+        if (unknown.status != MFAClient::Status::Invalid) state.fail("binary_protocol", "unknown user was not rejected");
+
+        // 길이 필드가 범위를 벗어난 프레임: 서버가 연결을 닫아야 함
+        int fd = connectLoopback(binary_port);
+        const char garbage[] = {0x00, 0x01, 0x01};
+        char buffer[16];
+        bool closed = fd >= 0 && ::send(fd, garbage, sizeof(garbage), MSG_NOSIGNAL) == sizeof(garbage) &&
+                      ::recv(fd, buffer, sizeof(buffer), 0) == 0;
+        if (fd >= 0) ::close(fd);
+        if (!closed) state.fail("binary_protocol", "malformed frame did not close the connection");
+    }
+}
+
+// 같은 인증 요청을 HTTP(/api/authenticate, epoll 리스너)와 바이너리 프로토콜(TCP, Unix 소켓)로 비교
+// - 연결 하나에 depth개 요청을 파이프라이닝하고 모두 받을 때까지를 한 번으로 측정 (closed loop)
+// - 틀린 코드로 보내 모든 경로가 같은 검증(조회 + HMAC)을 하므로 차이는 프로토콜 처리 비용
+// - 클라이언트와 서버(리액터 1개씩)가 같은 프로세스, 시도 제한 끔
+// - 올바른 코드 통과/재사용 거절/형식 오류/잘못된 프레임 처리와 응답 요청 ID 순서를 검사
+MFA_BENCHMARK(binary_protocol) {
+    std::string user_file = bench::prepareUserFixture(state, "binary_protocol", FIXTURE_USERS);
+    if (user_file.empty()) {
+        return;
+    }
+    const std::string socket_path = state.options.work_dir + "/binary_protocol.sock";
+    int http_port = freePort();
+    int binary_port = freePort();
+
+    MFAServer* server = nullptr;
+    std::thread server_thread;
+    {
+        bench::QuietStdout quiet;
+        server = new MFAServer(http_port, "", "", user_file, StorageMode::Memory);
+    }
+    server->setRateLimits(RateLimit{}, RateLimit{});
+    ServerTuning tuning;
+    tuning.listener = ListenerMode::Epoll;
+    tuning.event_threads = 1;
+    tuning.keep_alive_max_count = 1000000;
+    tuning.keep_alive_timeout_sec = 600;
+    tuning.tcp_nodelay = true;
+    tuning.binary_port = binary_port;
+    tuning.binary_socket = socket_path;
+    tuning.binary_threads = 1;
+    server->setTuning(tuning);
+    Log::Level saved_level = Log::level();
+    Log::setLevel(Log::Level::Off);
+    server_thread = std::thread([server]() { server->start(); });
+
+    bool ready = false;
+    for (int attempt = 0; attempt < 500 && !ready; attempt++) {
+        int http_fd = connectLoopback(http_port);
+        int binary_fd = connectLoopback(binary_port);
+        ready = http_fd >= 0 && binary_fd >= 0 && access(socket_path.c_str(), F_OK) == 0;
+        if (http_fd >= 0) ::close(http_fd);
+        if (binary_fd >= 0) ::close(binary_fd);
+        if (!ready) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    if (!ready) {
+        state.fail("binary_protocol", "server did not start listening");
+    } else {
+        checkSemantics(state, user_file, binary_port, socket_path);
+
+        for (size_t depth : PIPELINE_DEPTHS) {
+            for (int transport = 0; transport < 3; transport++) {
+                const char* name = transport == 0 ? "http" : transport == 1 ? "binary tcp" : "binary unix";
+                std::string param = std::string(name) + " depth=" + std::to_string(depth);
+                RunResult result;
+                bool ok;
+                if (transport == 0) {
+                    ok = runHTTP(http_port, depth, state.options.min_seconds, result);
+                } else {
+                    MFAClient client;
+                    ok = transport == 1 ? client.connectTcp("127.0.0.1", binary_port) : client.connectUnix(socket_path);
+                    ok = ok && runBinary(client, depth, state.options.min_seconds, result);
+                    if (!ok) param += ": " + client.lastError();
+                }
+                if (!ok) {
+                    state.fail("binary_protocol", param + " connection failed");
+                    continue;
+                }
+                state.report("binary_protocol", param, result.requests, result.elapsed_ns,
+                             "req/s=" +
+                                 std::to_string(static_cast<uint64_t>(result.requests * 1e9 / result.elapsed_ns)) +
+                                 " round_trip_p50=" + std::to_string(result.round_trip.percentile(50.0) / 1000) +
+                                 "us p99=" + std::to_string(result.round_trip.percentile(99.0) / 1000) + "us");
+                if (result.unexpected > 0) {
+                    state.fail("binary_protocol", param + ": " + std::to_string(result.unexpected) +
+                                                      " responses were not a rejection of the request sent");
+                }
+            }
+        }
+    }
+
+    server->stop();
+    server_thread.join();
+    {
+        bench::QuietStdout quiet;
+        delete server;
+    }
+    Log::setLevel(saved_level);
+}
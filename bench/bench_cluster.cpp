@@ -0,0 +1,424 @@
+#include "bench.h"
+#include "cluster.h"
+#include "latency_histogram.h"
+#include "logger.h"
+#include "mfa_core.h"
+#include "server.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace {
+
+    constexpr size_t CLUSTER_USERS = 600;          // 처음 세 노드에 등록하는 사용자 수
+    constexpr size_t LIST_PAGE = 100;              // 목록을 넘겨 가며 읽을 때 페이지 크기
+    constexpr size_t SMALL_LIST_PAGE = 2;          // 노드 수보다 작은 페이지 (몫이 0인 노드가 생김)
+    constexpr uint64_t CLUSTER_TIMEOUT_NS = 60ull * 1000 * 1000 * 1000;
+    const std::string CLUSTER_KEY(CLUSTER_MIN_KEY_BYTES, 'c');    // 노드끼리 나눠 가진 클러스터 키
+
+    void removeStoreFiles(const std::string& path) {
+        for (const char* suffix : {"", ".tmp", ".wal", ".wal.1", ".wal.tmp", ".map", ".idx", ".idx.tmp",
+                                   ".replay", ".replay.tmp", ".key"}) {
+            ::unlink((path + suffix).c_str());
+        }
+    }
+
+    int freePort() {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(addr);
+        int port = 0;
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0 &&
+            getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &length) == 0) {
+            port = ntohs(addr.sin_port);
+        }
+        ::close(fd);
+        return port;
+    }
+
+    // 요청 하나를 보내고 서버가 닫을 때까지 받은 응답 전체 (실패하면 빈 문자열)
+    std::string httpExchange(int port, const std::string& method, const std::string& target, const std::string& body = "",
+                             const std::string& headers = "") {
+        std::string request = method + " " + target + " HTTP/1.1\r\nHost: bench\r\nConnection: close\r\n" + headers;
+        if (!body.empty()) {
+            request += "Content-Type: application/json\r\nContent-Length: " + std::to_string(body.size()) + "\r\n";
+        }
+        request += "\r\n" + body;
+
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        timeval timeout{10, 0};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        std::string response;
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0 &&
+            ::send(fd, request.data(), request.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(request.size())) {
+            char buffer[4096];
+            ssize_t n;
+            while ((n = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+                response.append(buffer, static_cast<size_t>(n));
+            }
+        }
+        ::close(fd);
+        return response;
+    }
+
+    int statusOf(const std::string& response) {
+        return response.compare(0, 9, "HTTP/1.1 ") == 0 ? std::atoi(response.c_str() + 9) : 0;
+    }
+
+    // 응답 본문에서 "key": 뒤의 값 (문자열이면 따옴표 안, 아니면 ,}] 앞까지)
+    std::string jsonValue(const std::string& response, const std::string& key, size_t from = 0) {
+        size_t pos = response.find("\"" + key + "\"", from);
+        if (pos == std::string::npos) return "";
+        pos = response.find(':', pos);
+        if (pos == std::string::npos) return "";
+        pos = response.find_first_not_of(' ', pos + 1);
+        if (pos == std::string::npos) return "";
+        if (response[pos] == '"') {
+            size_t end = response.find('"', pos + 1);
+            return end == std::string::npos ? "" : response.substr(pos + 1, end - pos - 1);
+        }
+        size_t end = response.find_first_of(",}]", pos);
+        return response.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+    }
+
+    size_t countOf(const std::string& text, const std::string& needle) {
+        size_t count = 0;
+        for (size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + needle.size())) {
+            count++;
+        }
+        return count;
+    }
+
+    // 한 프로세스 안에서 띄우는 클러스터 노드 하나 (epoll 리스너)
+    struct Node {
+        ClusterNode config;
+        int http_port = 0;
+        std::string path;
+        std::unique_ptr<MFAServer> server;
+        std::thread thread;
+    };
+
+    void startNode(Node& node, const std::vector<ClusterNode>& members) {
+        removeStoreFiles(node.path);
+        {
+            bench::QuietStdout quiet;
+            node.server = std::make_unique<MFAServer>(node.http_port, "", "", node.path, StorageMode::Memory);
+        }
+        node.server->setRateLimits(RateLimit{}, RateLimit{});
+        ServerTuning tuning;
+        tuning.listener = ListenerMode::Epoll;
+        tuning.event_threads = 1;
+        tuning.keep_alive_max_count = 1000000;
+        tuning.cluster_nodes = members;
+        tuning.node_id = node.config.id;
+        tuning.cluster_key_file = node.path + ".key";
+        std::ofstream(tuning.cluster_key_file, std::ios::binary) << CLUSTER_KEY;
+        tuning.cluster_threads = 1;
+        node.server->setTuning(tuning);
+        MFAServer* server = node.server.get();
+        node.thread = std::thread([server]() { server->start(); });
+    }
+
+    void stopNode(Node& node) {
+        if (!node.server) return;
+        node.server->stop();
+        node.thread.join();
+        {
+            bench::QuietStdout quiet;
+            node.server.reset();
+        }
+        removeStoreFiles(node.path);
+    }
+
+    // 노드가 이 링 버전을 따르고 재배치가 끝나 있을 때까지 대기
+    bool waitRing(const Node& node, uint64_t version, size_t node_count) {
+        uint64_t deadline = bench::nowNs() + CLUSTER_TIMEOUT_NS;
+        while (bench::nowNs() < deadline) {
+            std::string response = httpExchange(node.http_port, "GET", "/api/cluster");
+            if (statusOf(response) == 200 && jsonValue(response, "version") == std::to_string(version) &&
+                jsonValue(response, "rebalance") == "null" && countOf(response, "\"share\"") == node_count) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        return false;
+    }
+
+    uint64_t nodeUsers(const Node& node) {
+        std::string response = httpExchange(node.http_port, "GET", "/api/cluster");
+        // "users"는 nodes 배열 뒤 맨 끝에 있음
+        size_t nodes_end = response.rfind(']');
+        return std::strtoull(jsonValue(response, "users", nodes_end == std::string::npos ? 0 : nodes_end).c_str(),
+                             nullptr, 10);
+    }
+
+    std::string codeFor(MFACore& core, const std::string& secret, time_t at) {
+        char code[8];
+        snprintf(code, sizeof(code), "%06d", core.generateTOTPCode(secret, at));
+        return code;
+    }
+
+    // 어느 노드로 들어가도 맡은 노드에서 인증되는지 (모두 성공한 수)
+    size_t authenticateAll(const Node& entry, MFACore& codes, const std::vector<std::string>& secrets, time_t at,
+                           LatencyHistogram* latency) {
+        size_t passed = 0;
+        for (size_t i = 0; i < secrets.size(); i++) {
+            std::string body = "{\"user_id\": \"cluster_" + std::to_string(i) + "\", \"otp_code\": \"" +
+                               codeFor(codes, secrets[i], at) + "\"}";
+            uint64_t sent = bench::nowNs();
+            std::string response = httpExchange(entry.http_port, "POST", "/api/authenticate", body);
+            if (latency) latency->record(bench::nowNs() - sent);
+            if (statusOf(response) == 200 && jsonValue(response, "success") == "true") passed++;
+        }
+        return passed;
+    }
+
+    // 커서를 따라 전체 목록을 읽은 사용자 수
+    // largest_page: 한 페이지에 나온 가장 많은 사용자 수 (limit 이하여야 함)
+    size_t listAll(const Node& entry, size_t limit, size_t& largest_page) {
+        size_t total = 0;
+        largest_page = 0;
+        std::string cursor;
+        for (size_t pages = 0; pages < CLUSTER_USERS; pages++) {
+            std::string target = "/api/users?limit=" + std::to_string(limit) + "&prefix=cluster_";
+            if (!cursor.empty()) target += "&cursor=" + cursor;
+            std::string response = httpExchange(entry.http_port, "GET", target);
+            if (statusOf(response) != 200) return 0;
+            size_t count = countOf(response, "\"cluster_");
+            largest_page = std::max(largest_page, count);
+            total += count;
+            cursor = jsonValue(response, "next_cursor");
+            if (cursor.empty() || cursor == "null") break;
+        }
+        return total;
+    }
+
+}
+
+// 한 프로세스에 세 노드 클러스터를 띄우고 (노드마다 HTTP + 내부 리스너)
+// - register: 진입 노드가 맡은 노드로 넘겨 등록하는 지연
+// - authenticate: 다른 진입 노드에서 맡은 노드로 넘겨 인증하는 지연
+// - rebalance: 네 번째 노드가 참여를 요청해 사용자를 옮겨 받고 새 링으로 바뀔 때까지
+// - 사용자가 노드에 나뉘어 있는지, 목록이 노드를 넘겨 가며 모두 나오는지,
+//   재배치 뒤에도 사용자 수와 인증이 그대로인지, 삭제가 맡은 노드에 반영되는지 검사
+MFA_BENCHMARK(cluster) {
+    Log::Level saved_level = Log::level();
+    Log::setLevel(Log::Level::Off);
+
+    std::vector<Node> nodes(4);
+    std::vector<ClusterNode> members;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        nodes[i].config.id = "n" + std::to_string(i);
+        nodes[i].config.host = "127.0.0.1";
+        nodes[i].config.port = freePort();
+        nodes[i].http_port = freePort();
+        nodes[i].path = state.options.work_dir + "/cluster_" + nodes[i].config.id + ".dat";
+        members.push_back(nodes[i].config);
+    }
+    const std::vector<ClusterNode> initial(members.begin(), members.begin() + 3);
+    for (size_t i = 0; i < 3; i++) {
+        startNode(nodes[i], initial);
+    }
+
+    std::unique_ptr<MFACore> codes;
+    const std::string codes_path = state.options.work_dir + "/cluster_codes.dat";
+    {
+        bench::QuietStdout quiet;
+        codes = std::make_unique<MFACore>(codes_path, StorageMode::Memory);
+    }
+
+    bool ready = true;
+    for (size_t i = 0; i < 3 && ready; i++) {
+        ready = waitRing(nodes[i], 1, 3);
+    }
+    if (!ready) {
+        state.fail("cluster", "three-node cluster did not come up");
+    }
+
+    // 내부 리스너는 키가 맞는 노드의 /api/cluster/* 요청과 넘겨받은 요청만 받음
+    if (ready) {
+        std::string key_header = std::string(CLUSTER_KEY_HEADER) + ": ";
+        for (unsigned char c : CLUSTER_KEY) {
+            static constexpr char DIGITS[] = "0123456789abcdef";
+            key_header += DIGITS[c >> 4];
+            key_header += DIGITS[c & 0x0f];
+        }
+        key_header += "\r\n";
+        int internal_port = nodes[0].config.port;
+        if (statusOf(httpExchange(internal_port, "GET", "/api/cluster/ring")) != 403 ||
+            statusOf(httpExchange(internal_port, "GET", "/api/cluster/ring", "",
+                                  std::string(CLUSTER_KEY_HEADER) + ": 00\r\n")) != 403) {
+            state.fail("cluster", "internal listener served a request without the cluster key");
+        }
+        if (statusOf(httpExchange(internal_port, "GET", "/api/cluster/ring", "", key_header)) != 200) {
+            state.fail("cluster", "internal listener refused a request with the cluster key");
+        }
+        if (statusOf(httpExchange(internal_port, "POST", "/api/register", "{\"user_id\": \"cluster_direct\"}",
+                                  key_header)) != 404) {
+            state.fail("cluster", "internal listener served a public route that was not forwarded");
+        }
+    }
+
+    // 등록은 모두 n0으로 보냄 (2/3은 다른 노드로 넘어감)
+    std::vector<std::string> secrets;
+    LatencyHistogram latency;
+    uint64_t start = bench::nowNs();
+    for (size_t i = 0; i < CLUSTER_USERS && ready; i++) {
+        uint64_t sent = bench::nowNs();
+        std::string response = httpExchange(nodes[0].http_port, "POST", "/api/register",
+                                            "{\"user_id\": \"cluster_" + std::to_string(i) + "\"}");
+        latency.record(bench::nowNs() - sent);
+        std::string secret = jsonValue(response, "secret");
+        if (statusOf(response) != 201 && statusOf(response) != 200) {
+            state.fail("cluster", "registration through n0 failed: " + response.substr(0, response.find("\r\n")));
+            ready = false;
+            break;
+        }
+        secrets.push_back(secret);
+    }
+    double register_ns = static_cast<double>(bench::nowNs() - start);
+    if (ready) {
+        Log::setLevel(saved_level);
+        state.report("cluster", "register via n0 nodes=3", CLUSTER_USERS, register_ns,
+                     "p50=" + std::to_string(latency.percentile(50.0) / 1000) +
+                         "us p99=" + std::to_string(latency.percentile(99.0) / 1000) + "us");
+        Log::setLevel(Log::Level::Off);
+
+        uint64_t total = 0;
+        for (size_t i = 0; i < 3; i++) {
+            uint64_t users = nodeUsers(nodes[i]);
+            if (users == 0) state.fail("cluster", nodes[i].config.id + " owns no users");
+            total += users;
+        }
+        if (total != CLUSTER_USERS) {
+            state.fail("cluster", "users on nodes add up to " + std::to_string(total) + ", expected " +
+                                      std::to_string(CLUSTER_USERS));
+        }
+
+        time_t now = time(nullptr);
+        // 배치: 여러 노드의 사용자를 섞고 마지막 항목만 틀린 코드 (이전 시간 창 코드라 뒤의 인증과 겹치지 않음)
+        std::string batch = "{\"items\": [";
+        for (size_t i = 0; i < 30; i++) {
+            std::string code = i + 1 == 30 ? "000000" : codeFor(*codes, secrets[i], now - 30);
+            batch += std::string(i ? "," : "") + "{\"user_id\": \"cluster_" + std::to_string(i) +
+                     "\", \"otp_code\": \"" + code + "\"}";
+        }
+        batch += "]}";
+        std::string batch_response = httpExchange(nodes[0].http_port, "POST", "/api/authenticate/batch", batch);
+        size_t batch_passed = countOf(batch_response, "\"success\":true");   // 응답 전체 1개 + 맞은 항목 29개
+        if (statusOf(batch_response) != 200 || batch_passed != 30) {
+            state.fail("cluster", "batch through n0 passed " + std::to_string(batch_passed) + " of 30 checks");
+        }
+
+        latency = LatencyHistogram();
+        start = bench::nowNs();
+        size_t passed = authenticateAll(nodes[1], *codes, secrets, now, &latency);
+        double auth_ns = static_cast<double>(bench::nowNs() - start);
+        if (passed != CLUSTER_USERS) {
+            state.fail("cluster", "only " + std::to_string(passed) + " users authenticated through n1");
+        }
+        Log::setLevel(saved_level);
+        state.report("cluster", "authenticate via n1 nodes=3", CLUSTER_USERS, auth_ns,
+                     "p50=" + std::to_string(latency.percentile(50.0) / 1000) +
+                         "us p99=" + std::to_string(latency.percentile(99.0) / 1000) + "us");
+        Log::setLevel(Log::Level::Off);
+
+        for (size_t limit : {LIST_PAGE, SMALL_LIST_PAGE}) {
+            size_t largest_page = 0;
+            size_t listed = listAll(nodes[2], limit, largest_page);
+            if (listed != CLUSTER_USERS) {
+                state.fail("cluster", "paged listing through n2 (limit=" + std::to_string(limit) + ") returned " +
+                                          std::to_string(listed) + " users");
+            }
+            if (largest_page > limit) {
+                state.fail("cluster", "paged listing returned " + std::to_string(largest_page) +
+                                          " users for limit=" + std::to_string(limit));
+            }
+        }
+        std::string stream = httpExchange(nodes[1].http_port, "GET", "/api/users?stream=1&prefix=cluster_");
+        if (countOf(stream, "\"cluster_") != CLUSTER_USERS) {
+            state.fail("cluster", "streamed listing through n1 returned " +
+                                      std::to_string(countOf(stream, "\"cluster_")) + " users");
+        }
+
+        // 네 번째 노드: 네 노드 목록으로 시작하면 기존 링에 자신이 없으므로 참여를 요청함
+        start = bench::nowNs();
+        startNode(nodes[3], members);
+        bool joined = true;
+        for (size_t i = 0; i < 4 && joined; i++) {
+            joined = waitRing(nodes[i], 2, 4);
+        }
+        double rebalance_ns = static_cast<double>(bench::nowNs() - start);
+        if (!joined) {
+            state.fail("cluster", "n3 did not join and finish the rebalance");
+        } else {
+            Log::setLevel(saved_level);
+            state.report("cluster", "rebalance 3->4 users=" + std::to_string(CLUSTER_USERS), CLUSTER_USERS,
+                         rebalance_ns, "moved=" + std::to_string(nodeUsers(nodes[3])));
+            Log::setLevel(Log::Level::Off);
+
+            total = 0;
+            for (size_t i = 0; i < 4; i++) {
+                total += nodeUsers(nodes[i]);
+            }
+            if (nodeUsers(nodes[3]) == 0) {
+                state.fail("cluster", "no users moved to n3");
+            }
+            if (total != CLUSTER_USERS) {
+                state.fail("cluster", "users after the rebalance add up to " + std::to_string(total));
+            }
+
+            // 다음 시간 창의 코드로 (바로 앞 인증의 재사용 방지에 걸리지 않게) 새 노드에서 인증
+            passed = authenticateAll(nodes[3], *codes, secrets, now + 30, nullptr);
+            if (passed != CLUSTER_USERS) {
+                state.fail("cluster", "only " + std::to_string(passed) + " users authenticated after the rebalance");
+            }
+            size_t largest_page = 0;
+            if (listAll(nodes[0], LIST_PAGE, largest_page) != CLUSTER_USERS || largest_page > LIST_PAGE) {
+                state.fail("cluster", "paged listing after the rebalance is incomplete or over the limit");
+            }
+
+            for (size_t i = 0; i < CLUSTER_USERS; i += 2) {
+                httpExchange(nodes[(i / 2) % 4].http_port, "DELETE", "/api/user/cluster_" + std::to_string(i));
+            }
+            total = 0;
+            for (size_t i = 0; i < 4; i++) {
+                total += nodeUsers(nodes[i]);
+            }
+            if (total != CLUSTER_USERS / 2) {
+                state.fail("cluster", "deletes through other nodes left " + std::to_string(total) + " users");
+            }
+            std::string response = httpExchange(nodes[1].http_port, "GET", "/api/qr/cluster_0");
+            if (statusOf(response) != 404) {
+                state.fail("cluster", "deleted user is still served by its owner");
+            }
+        }
+    }
+
+    for (size_t i = nodes.size(); i-- > 0;) {
+        stopNode(nodes[i]);
+    }
+    {
+        bench::QuietStdout quiet;
+        codes.reset();
+    }
+    removeStoreFiles(codes_path);
+    Log::setLevel(saved_level);
+}
@@ -0,0 +1,247 @@
+#include "bench.h"
+#include "mfa_core.h"
+#include <atomic>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+    constexpr int STRESS_THREADS = 64;
+    constexpr int ANCHOR_USERS = 256;
+
+    std::string formatCode(int code) {
+        char buf[8];
+        snprintf(buf, sizeof(buf), "%06d", code);
+        return buf;
+    }
+
+    void removeStoreFiles(const std::string& path) {
+        for (const char* suffix : {"", ".tmp", ".wal", ".wal.1", ".wal.tmp", ".map", ".idx", ".idx.tmp",
+                                   ".replay", ".replay.tmp"}) {
+            ::unlink((path + suffix).c_str());
+        }
+    }
+
+    /**
+     * @brief 스레드별 기대 상태 (각 스레드는 자기 이름 공간의 사용자만 등록/삭제)
+     */
+    struct ThreadModel {
+        std::map<std::string, std::string> live;     // user_id -> secret
+        std::map<std::string, uint64_t> accepted;    // user_id -> 마지막으로 통과한 time step
+        std::vector<std::string> deleted;
+    };
+
+    /**
+     * @brief 여러 스레드가 함께 쓰는 앵커 사용자의 통과 기록 (같은 step이 두 번 통과하면 재사용)
+     */
+    struct AnchorLog {
+        std::mutex mutex;
+        std::set<uint64_t> steps;
+    };
+
+    // 코드를 만드는 동안 time step이 바뀌지 않았으면 그 step, 바뀌었으면 0 (기대값을 정할 수 없음)
+    uint64_t codeStep(MFACore& core, const std::string& secret, std::string& code) {
+        uint64_t before = static_cast<uint64_t>(time(nullptr)) / OTP_PERIOD;
+        code = formatCode(core.generateTOTPCode(secret));
+        uint64_t after = static_cast<uint64_t>(time(nullptr)) / OTP_PERIOD;
+        return before == after ? before : 0;
+    }
+
+    struct Violations {
+        std::mutex mutex;
+        std::vector<std::string> messages;
+        std::atomic<uint64_t> count{0};
+
+        void add(const std::string& message) {
+            if (count.fetch_add(1) < 10) {
+                std::lock_guard<std::mutex> lock(mutex);
+                messages.push_back(message);
+            }
+        }
+    };
+
+    // 현재 윈도우(-1..+1) 어느 코드와도 다른 코드
+    std::string wrongCode(MFACore& core, const std::string& secret) {
+        time_t now = time(nullptr);
+        int codes[3] = {core.generateTOTPCode(secret, now - OTP_PERIOD),
+                        core.generateTOTPCode(secret, now),
+                        core.generateTOTPCode(secret, now + OTP_PERIOD)};
+        int candidate = (codes[1] + 1) % 1000000;
+        while (candidate == codes[0] || candidate == codes[1] || candidate == codes[2]) {
+            candidate = (candidate + 1) % 1000000;
+        }
+        return formatCode(candidate);
+    }
+}
+
+// 64개 스레드의 등록/삭제/인증 혼합 부하에서 불변 조건 검사
+// - 앵커 사용자는 여러 스레드가 같은 코드를 동시에 보내도 step마다 한 번만 성공, 틀린 코드로 실패
+// - 자기가 등록한 사용자는 새 step의 코드로 성공하고 이미 쓴 코드로 실패, 자기가 삭제한 사용자는 실패
+// - 종료 후 사용자 수/목록/시크릿이 모델과 일치하고, 다시 열어도 동일
+MFA_BENCHMARK(concurrency_stress) {
+    const std::pair<StorageMode, const char*> modes[] = {
+        {StorageMode::Memory, "memory"},
+        {StorageMode::Mapped, "mapped"},
+    };
+
+    for (const auto& mode : modes) {
+        std::string path = state.options.work_dir + "/stress_" + mode.second + ".dat";
+        removeStoreFiles(path);
+
+        Violations violations;
+        std::vector<ThreadModel> models(STRESS_THREADS);
+        std::vector<std::pair<std::string, std::string>> anchors;
+        std::vector<AnchorLog> anchor_logs(ANCHOR_USERS);
+        std::atomic<uint64_t> anchor_successes{0};
+        std::atomic<uint64_t> operations{0};
+        uint64_t elapsed_ns = 0;
+
+        {
+            bench::QuietStdout quiet;
+            auto core = std::make_unique<MFACore>(path, mode.first);
+
+            for (int i = 0; i < ANCHOR_USERS; i++) {
+                User user;
+                if (!core->registerUser("anchor_" + std::to_string(i), user)) {
+                    violations.add("anchor registration failed: " + std::to_string(i));
+                }
+                anchors.emplace_back(user.user_id, user.secret_base32);
+            }
+
+            std::atomic<bool> running{true};
+            std::vector<std::thread> workers;
+            uint64_t start = bench::nowNs();
+
+            for (int t = 0; t < STRESS_THREADS; t++) {
+                workers.emplace_back([&, t] {
+                    ThreadModel& model = models[t];
+                    std::mt19937_64 rng(static_cast<uint64_t>(t) * 7919 + 1);
+                    uint64_t next_id = 0;
+                    uint64_t local_ops = 0;
+
+                    while (running.load(std::memory_order_relaxed)) {
+                        unsigned roll = static_cast<unsigned>(rng() % 100);
+                        local_ops++;
+
+                        if (roll < 10) {
+                            std::string user_id = "s" + std::to_string(t) + "_" + std::to_string(next_id++);
+                            User user;
+                            if (!core->registerUser(user_id, user)) {
+                                violations.add("register failed: " + user_id);
+                                continue;
+                            }
+                            model.live.emplace(user_id, user.secret_base32);
+                        } else if (roll < 18 && !model.live.empty()) {
+                            auto it = std::next(model.live.begin(), static_cast<long>(rng() % model.live.size()));
+                            if (!core->deleteUser(it->first)) {
+                                violations.add("delete failed: " + it->first);
+                            }
+                            model.deleted.push_back(it->first);
+                            model.accepted.erase(it->first);
+                            model.live.erase(it);
+                        } else if (roll < 60) {
+                            // 다른 스레드도 같은 앵커의 같은 코드를 보내므로 성공 여부가 아니라 중복 성공을 검사
+                            size_t a = rng() % anchors.size();
+                            const auto& anchor = anchors[a];
+                            std::string code;
+                            uint64_t step = codeStep(*core, anchor.second, code);
+                            if (core->verifyTOTP(anchor.first, code)) {
+                                anchor_successes++;
+                                std::lock_guard<std::mutex> lock(anchor_logs[a].mutex);
+                                if (step != 0 && !anchor_logs[a].steps.insert(step).second) {
+                                    violations.add("replayed code accepted: " + anchor.first);
+                                }
+                            }
+                            if (roll < 25 && core->verifyTOTP(anchor.first, wrongCode(*core, anchor.second))) {
+                                violations.add("anchor accepted wrong code: " + anchor.first);
+                            }
+                        } else if (roll < 85 && !model.live.empty()) {
+                            auto it = std::next(model.live.begin(), static_cast<long>(rng() % model.live.size()));
+                            std::string code;
+                            uint64_t step = codeStep(*core, it->second, code);
+                            if (step == 0) continue;
+                            uint64_t& last = model.accepted[it->first];
+                            bool ok = core->verifyTOTP(it->first, code);
+                            if (ok != (step > last)) {
+                                violations.add(std::string(ok ? "own user replay accepted: " : "own user auth failed: ") +
+                                               it->first);
+                            }
+                            if (ok) last = step;
+                        } else if (!model.deleted.empty()) {
+                            const std::string& user_id = model.deleted[rng() % model.deleted.size()];
+                            User user;
+                            if (core->findUser(user_id, user) || core->verifyTOTP(user_id, "000000")) {
+                                violations.add("deleted user still visible: " + user_id);
+                            }
+                        } else {
+                            // 다른 스레드 사용자 조회 (결과는 검사하지 않음, 동시 변경 중 읽기 경로만 확인)
+                            User user;
+                            bench::doNotOptimize(core->findUser(
+                                "s" + std::to_string(rng() % STRESS_THREADS) + "_" + std::to_string(rng() % 64), user));
+                        }
+                    }
+                    operations += local_ops;
+                });
+            }
+
+            std::this_thread::sleep_for(std::chrono::duration<double>(std::max(state.options.min_seconds, 1.0)));
+            running = false;
+            for (auto& worker : workers) worker.join();
+            elapsed_ns = bench::nowNs() - start;
+
+            if (anchor_successes.load() == 0) {
+                violations.add("no anchor authentication succeeded");
+            }
+
+            // 종료 후 불변 조건: 모델과 저장소가 일치
+            auto checkStore = [&](MFACore& store, const char* phase) {
+                size_t expected = anchors.size();
+                for (const auto& model : models) expected += model.live.size();
+
+                if (store.userCount() != expected) {
+                    violations.add(std::string(phase) + ": userCount " + std::to_string(store.userCount()) +
+                                   " != expected " + std::to_string(expected));
+                }
+                if (store.listUsers().size() != expected) {
+                    violations.add(std::string(phase) + ": listUsers size mismatch");
+                }
+                for (const auto& model : models) {
+                    for (const auto& entry : model.live) {
+                        User user;
+                        if (!store.findUser(entry.first, user) || user.secret_base32 != entry.second) {
+                            violations.add(std::string(phase) + ": missing or wrong secret: " + entry.first);
+                        }
+                    }
+                    for (const auto& user_id : model.deleted) {
+                        User user;
+                        if (store.findUser(user_id, user)) {
+                            violations.add(std::string(phase) + ": deleted user present: " + user_id);
+                        }
+                    }
+                }
+            };
+
+            checkStore(*core, "after run");
+            core.reset();
+
+            // 재시작 후에도 같은 상태 (WAL 재생 / 매핑 파일)
+            MFACore reopened(path, mode.first);
+            checkStore(reopened, "after reopen");
+        }
+
+        removeStoreFiles(path);
+
+        for (const auto& message : violations.messages) {
+            state.fail("concurrency_stress", std::string(mode.second) + ": " + message);
+        }
+        state.report("concurrency_stress", std::string(mode.second) + " threads=" + std::to_string(STRESS_THREADS),
+                     operations, static_cast<double>(elapsed_ns),
+                     "violations=" + std::to_string(violations.count.load()));
+    }
+}
@@ -0,0 +1,172 @@
+#include "bench.h"
+#include "mfa_core.h"
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+    // 사용자 파일 없이 코어만 필요할 때 (등록하지 않으므로 파일은 생기지 않음)
+    std::unique_ptr<MFACore> makeEmptyCore(const bench::State& state, const char* name) {
+        bench::QuietStdout quiet;
+        std::string path = state.options.work_dir + "/" + name + ".dat";
+        return std::make_unique<MFACore>(path);
+    }
+
+    void removeStoreFiles(const std::string& path) {
+        for (const char* suffix : {"", ".tmp", ".wal", ".wal.1", ".wal.tmp", ".replay", ".replay.tmp"}) {
+            ::unlink((path + suffix).c_str());
+        }
+    }
+}
+
+// Base32 인코딩/디코딩 비용 (시크릿 20바이트 = 32자)
+MFA_BENCHMARK(base32_codec) {
+    auto core = makeEmptyCore(state, "base32_codec");
+
+    std::mt19937_64 rng(42);
+    std::vector<std::vector<unsigned char>> keys(256, std::vector<unsigned char>(SECRET_KEY_LENGTH));
+    for (auto& key : keys) {
+        for (auto& byte : key) byte = static_cast<unsigned char>(rng());
+    }
+    std::vector<std::string> encoded;
+    for (const auto& key : keys) encoded.push_back(core->base32_encode(key));
+
+    uint64_t iterations = 0;
+    double elapsed = bench::measure([&](uint64_t i) {
+        bench::doNotOptimize(core->base32_encode(keys[i & 255]));
+    }, iterations, state.options.min_seconds);
+    state.report("base32_codec", "encode bytes=20", iterations, elapsed);
+
+    std::vector<unsigned char> decoded;
+    elapsed = bench::measure([&](uint64_t i) {
+        bench::doNotOptimize(core->base32_decode(encoded[i & 255], decoded));
+    }, iterations, state.options.min_seconds);
+    state.report("base32_codec", "decode chars=32", iterations, elapsed);
+
+    // 왕복 검증
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (core->base32_decode(encoded[i], decoded) != static_cast<int>(SECRET_KEY_LENGTH) || decoded != keys[i]) {
+            state.fail("base32_codec", "round trip mismatch at key " + std::to_string(i));
+            break;
+        }
+    }
+}
+
+// 사용자 수에 따른 로드(loadUsersFromFile + 인덱스 구성) 시간과 findUser 조회 비용 (적중/부재)
+MFA_BENCHMARK(find_user_by_user_count) {
+    for (size_t user_count : {1000, 100000, 10000000}) {
+        if (user_count > state.options.max_users) {
+            break;
+        }
+
+        std::string path = bench::prepareUserFixture(state, "find_user_by_user_count", user_count);
+        if (path.empty()) {
+            return;
+        }
+
+        std::unique_ptr<MFACore> core;
+        uint64_t load_ns = 0;
+        {
+            bench::QuietStdout quiet;
+            uint64_t start = bench::nowNs();
+            core = std::make_unique<MFACore>(path);
+            load_ns = bench::nowNs() - start;
+        }
+        std::string param = "users=" + std::to_string(user_count);
+        state.report("find_user_by_user_count", "load " + param, user_count, static_cast<double>(load_ns),
+                     "users/s=" + std::to_string(static_cast<uint64_t>(user_count * 1e9 / load_ns)));
+
+        std::mt19937_64 rng(7);
+        std::vector<std::string> hits(4096);
+        std::vector<std::string> misses(4096);
+        for (size_t i = 0; i < hits.size(); i++) {
+            hits[i] = bench::fixtureUserId(rng() % user_count);
+            misses[i] = bench::fixtureUserId(user_count + rng() % user_count);
+        }
+
+        User user;
+        size_t found = 0;
+        uint64_t iterations = 0;
+        double elapsed = bench::measure([&](uint64_t i) {
+            found += core->findUser(hits[i & 4095], user);
+        }, iterations, state.options.min_seconds);
+        state.report("find_user_by_user_count", "hit " + param, iterations, elapsed);
+        if (found != iterations) {
+            state.fail("find_user_by_user_count", param + ": " + std::to_string(iterations - found) +
+                                                      " existing users not found");
+        }
+
+        found = 0;
+        elapsed = bench::measure([&](uint64_t i) {
+            found += core->findUser(misses[i & 4095], user);
+        }, iterations, state.options.min_seconds);
+        state.report("find_user_by_user_count", "miss " + param, iterations, elapsed);
+        if (found != 0) {
+            state.fail("find_user_by_user_count", param + ": " + std::to_string(found) + " missing users found");
+        }
+
+        bench::QuietStdout quiet;
+        core.reset();
+    }
+}
+
+// 윈도우 크기에 따른 verifyTOTP 비용 (틀린 코드 = 윈도우의 모든 후보 계산)
+MFA_BENCHMARK(verify_totp_by_window) {
+    const size_t user_count = 1000;
+    std::string path = bench::prepareUserFixture(state, "verify_totp_by_window", user_count);
+    if (path.empty()) {
+        return;
+    }
+    std::unique_ptr<MFACore> core;
+    {
+        bench::QuietStdout quiet;
+        core = std::make_unique<MFACore>(path);
+    }
+
+    std::vector<std::string> ids(1024);
+    for (size_t i = 0; i < ids.size(); i++) ids[i] = bench::fixtureUserId(i % user_count);
+
+    for (int window : {0, 1, 2, 5, 10}) {
+        uint64_t iterations = 0;
+        double elapsed = 0;
+        {
+            bench::QuietStdout quiet;     // 실패 로그
+            elapsed = bench::measure([&](uint64_t i) {
+                bench::doNotOptimize(core->verifyTOTP(ids[i & 1023], "000000", window));
+            }, iterations, state.options.min_seconds);
+        }
+        state.report("verify_totp_by_window", "window=" + std::to_string(window), iterations, elapsed,
+                     "candidates=" + std::to_string(2 * window + 1));
+    }
+
+    {
+        bench::QuietStdout quiet;
+        core.reset();
+    }
+
+    // 윈도우 끝의 코드도 통과해야 함 (새 사용자마다 처음 한 번, 재사용 방지 기록이 남지 않도록 별도 파일)
+    std::string verify_path = state.options.work_dir + "/verify_window.dat";
+    bool ok = true;
+    {
+        bench::QuietStdout quiet;
+        removeStoreFiles(verify_path);
+        MFACore verify_core(verify_path);
+        for (int window : {0, 1, 2, 5, 10}) {
+            User user;
+            ok &= verify_core.registerUser("window_" + std::to_string(window), user);
+            time_t edge = time(nullptr) - static_cast<time_t>(window) * OTP_PERIOD;
+            char code[8];
+            snprintf(code, sizeof(code), "%06d", verify_core.generateTOTPCode(user.secret_base32, edge));
+            ok &= verify_core.verifyTOTP(user.user_id, code, window);
+        }
+    }
+    removeStoreFiles(verify_path);
+    if (!ok) {
+        state.fail("verify_totp_by_window", "code at the edge of the window was rejected");
+    }
+}
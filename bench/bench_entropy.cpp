@@ -0,0 +1,141 @@
+#include "bench.h"
+#include "entropy_pool.h"
+#include "mfa_core.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+    // 이전 방식: 등록마다 /dev/urandom을 ifstream으로 열어 20바이트 읽기
+    bool legacyFill(unsigned char* out) {
+        std::ifstream urandom("/dev/urandom", std::ios::binary);
+        if (!urandom.is_open()) return false;
+        urandom.read(reinterpret_cast<char*>(out), SECRET_KEY_LENGTH);
+        return static_cast<bool>(urandom);
+    }
+
+    bool validSecret(const std::string& secret) {
+        if (secret.size() != 32) return false;
+        for (char c : secret) {
+            if (!((c >= 'A' && c <= 'Z') || (c >= '2' && c <= '7'))) return false;
+        }
+        return true;
+    }
+
+    // fork 직후 자식의 첫 바이트가 부모의 다음 바이트와 같으면 풀을 그대로 물려받은 것
+    bool forkDiverges() {
+        unsigned char warm[1];
+        Entropy::fill(warm, sizeof(warm));     // 부모 풀을 채워 둠
+
+        int fds[2];
+        if (::pipe(fds) != 0) return false;
+        pid_t pid = ::fork();
+        if (pid == 0) {
+            unsigned char child[16] = {0};
+            Entropy::fill(child, sizeof(child));
+            ssize_t written = ::write(fds[1], child, sizeof(child));
+            ::_exit(written == sizeof(child) ? 0 : 1);
+        }
+        ::close(fds[1]);
+        unsigned char parent[16];
+        unsigned char child[16] = {0};
+        Entropy::fill(parent, sizeof(parent));
+        ssize_t n = ::read(fds[0], child, sizeof(child));
+        ::close(fds[0]);
+        int status = 0;
+        ::waitpid(pid, &status, 0);
+        return n == sizeof(child) && memcmp(parent, child, sizeof(parent)) != 0;
+    }
+}
+
+// 대량 등록 시 시크릿 생성 처리량 (secrets/sec = 1e9 / ns/op)
+MFA_BENCHMARK(secret_generation) {
+    std::string path = state.options.work_dir + "/entropy_bench.dat";
+    ::unlink(path.c_str());
+    ::unlink((path + ".wal").c_str());
+    std::unique_ptr<MFACore> core;
+    {
+        bench::QuietStdout quiet;
+        core = std::make_unique<MFACore>(path);
+    }
+
+    {
+        unsigned char key[SECRET_KEY_LENGTH];
+        uint64_t iterations = 0;
+        bool ok = true;
+        double elapsed = bench::measure([&](uint64_t) {
+            ok &= legacyFill(key);
+            bench::doNotOptimize(key[0]);
+        }, iterations, state.options.min_seconds);
+        state.report("secret_generation", "legacy ifstream /dev/urandom", iterations, elapsed);
+        if (!ok) state.fail("secret_generation", "legacy /dev/urandom read failed");
+    }
+
+    {
+        std::unordered_set<std::string> seen;
+        bool valid = true;
+        uint64_t iterations = 0;
+        double elapsed = bench::measure([&](uint64_t) {
+            std::string secret = core->generateSecret();
+            valid &= validSecret(secret);
+            if (seen.size() < 200000) seen.insert(std::move(secret));
+        }, iterations, state.options.min_seconds);
+        state.report("secret_generation", std::string("generateSecret pool=") + Entropy::sourceName(),
+                     iterations, elapsed);
+        if (!valid) state.fail("secret_generation", "generateSecret returned an invalid secret");
+        if (seen.size() != std::min<uint64_t>(iterations, 200000)) {
+            state.fail("secret_generation", "duplicate secrets from generateSecret");
+        }
+    }
+
+    for (size_t batch : {100, 10000}) {
+        std::vector<std::string> secrets;
+        bool ok = true;
+        uint64_t iterations = 0;
+        double elapsed = bench::measure([&](uint64_t) {
+            ok &= core->generateSecrets(batch, secrets);
+        }, iterations, state.options.min_seconds);
+        // 시크릿 하나당 시간으로 보고
+        state.report("secret_generation", "generateSecrets batch=" + std::to_string(batch),
+                     iterations * batch, elapsed);
+        std::unordered_set<std::string> unique(secrets.begin(), secrets.end());
+        if (!ok || unique.size() != batch || !validSecret(secrets.front())) {
+            state.fail("secret_generation", "generateSecrets batch=" + std::to_string(batch) + " invalid or duplicate");
+        }
+    }
+
+    for (int threads : {2, 8}) {
+        const uint64_t per_thread = 50000;
+        uint64_t start = bench::nowNs();
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&] {
+                for (uint64_t i = 0; i < per_thread; i++) {
+                    bench::doNotOptimize(core->generateSecret());
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        state.report("secret_generation", "generateSecret threads=" + std::to_string(threads),
+                     per_thread * threads, static_cast<double>(bench::nowNs() - start));
+    }
+
+    if (!forkDiverges()) {
+        state.fail("secret_generation", "child process reused the parent's entropy pool after fork");
+    }
+
+    {
+        bench::QuietStdout quiet;
+        core.reset();
+    }
+    ::unlink(path.c_str());
+    ::unlink((path + ".wal").c_str());
+}
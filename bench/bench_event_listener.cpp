@@ -0,0 +1,467 @@
+#include "bench.h"
+#include "event_server.h"
+#include "latency_histogram.h"
+#include "server.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <openssl/ssl.h>
+
+namespace {
+
+    constexpr size_t CONNECTION_COUNTS[] = {10000, 25000, 50000};
+    constexpr size_t TLS_CONNECTIONS = 1000;             // TLS는 핸드셰이크 비용이 커서 규모를 줄여 확인
+    constexpr size_t ACTIVE_CONNECTIONS = 64;            // 나머지는 keep-alive로 쉬는 동안 요청을 보내는 연결 수
+    constexpr size_t FIXTURE_USERS = 1000;
+    constexpr size_t FD_HEADROOM = 256;                  // 연결 외에 필요한 fd (epoll, 파이프, 로그 등)
+    constexpr size_t CONNECTIONS_PER_SOURCE = 20000;     // 출발 주소(127.0.0.x) 하나가 맡을 연결 수 (임시 포트 범위 안)
+    constexpr int CLIENT_TIMEOUT_MS = 30000;
+
+    // 자식(클라이언트) 프로세스가 파이프로 돌려주는 결과
+    struct ClientResult {
+        uint64_t connected = 0;
+        uint64_t connect_ns = 0;
+        uint64_t sweep_requests = 0;        // 모든 연결에 한 번씩 동시에 보낸 요청
+        uint64_t sweep_ns = 0;
+        uint64_t active_requests = 0;
+        uint64_t active_ns = 0;
+        uint64_t p50_ns = 0;
+        uint64_t p99_ns = 0;
+        uint64_t p999_ns = 0;
+        uint64_t bad_responses = 0;         // 200/401이 아닌 응답
+        char error[160] = {0};
+    };
+
+    struct ClientConn {
+        int fd = -1;
+        SSL* ssl = nullptr;
+        std::string in;
+        uint64_t sent_ns = 0;
+        bool waiting = false;
+    };
+
+    /**
+     * @brief 연결을 모두 열고 요청을 보내는 클라이언트 (fd 한도를 서버와 나누지 않도록 자식 프로세스에서 실행)
+     */
+    class Client {
+    public:
+        Client(int port, SSL_CTX* tls, size_t seed) : port(port), tls(tls), seed(seed) {}
+
+        ~Client() {
+            for (ClientConn& conn : conns) {
+                if (conn.ssl) SSL_free(conn.ssl);
+                if (conn.fd >= 0) ::close(conn.fd);
+            }
+            if (epoll_fd >= 0) ::close(epoll_fd);
+        }
+
+        bool run(size_t count, double min_seconds, int ready_fd, int ack_fd, ClientResult& result) {
+            epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+            conns.resize(count);
+
+            uint64_t start = bench::nowNs();
+            for (size_t i = 0; i < count; i++) {
+                if (!connect(i)) return fail(result, "connect " + std::to_string(i) + ": " + strerror(errno));
+            }
+            result.connected = count;
+            result.connect_ns = bench::nowNs() - start;
+
+            // 모든 연결에 한 번씩 (서버가 모두 받아들였는지 확인 겸 전체 연결 처리량)
+            std::vector<size_t> all(count);
+            for (size_t i = 0; i < count; i++) all[i] = i;
+            start = bench::nowNs();
+            if (!sweep(all, result)) return false;
+            result.sweep_requests = count;
+            result.sweep_ns = bench::nowNs() - start;
+
+            // 부모가 서버 메모리를 재는 동안 대기
+            char signal = 'E';
+            if (::write(ready_fd, &signal, 1) != 1 || ::read(ack_fd, &signal, 1) != 1) {
+                return fail(result, "sync with server process failed");
+            }
+
+            std::vector<size_t> active;
+            size_t stride = std::max<size_t>(1, count / ACTIVE_CONNECTIONS);
+            for (size_t i = 0; i < count && active.size() < ACTIVE_CONNECTIONS; i += stride) active.push_back(i);
+            return closedLoop(active, min_seconds, result);
+        }
+
+    private:
+        int port;
+        SSL_CTX* tls;
+        size_t seed;
+        int epoll_fd = -1;
+        std::vector<ClientConn> conns;
+
+        static bool fail(ClientResult& result, const std::string& message) {
+            snprintf(result.error, sizeof(result.error), "%s", message.c_str());
+            return false;
+        }
+
+        bool connect(size_t index) {
+            ClientConn& conn = conns[index];
+            conn.fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (conn.fd < 0) return false;
+            int yes = 1;
+            setsockopt(conn.fd, IPPROTO_IP, IP_BIND_ADDRESS_NO_PORT, &yes, sizeof(yes));
+            setsockopt(conn.fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+
+            // 출발 주소를 나눠 (출발 주소, 포트) 조합이 임시 포트 범위를 넘지 않게 함
+            sockaddr_in source{};
+            source.sin_family = AF_INET;
+            source.sin_addr.s_addr = htonl(INADDR_LOOPBACK + 1 + static_cast<uint32_t>(index / CONNECTIONS_PER_SOURCE));
+            if (::bind(conn.fd, reinterpret_cast<sockaddr*>(&source), sizeof(source)) != 0) return false;
+
+            sockaddr_in target{};
+            target.sin_family = AF_INET;
+            target.sin_port = htons(static_cast<uint16_t>(port));
+            target.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            if (::connect(conn.fd, reinterpret_cast<sockaddr*>(&target), sizeof(target)) != 0) return false;
+
+            if (tls) {
+                conn.ssl = SSL_new(tls);
+                SSL_set_fd(conn.ssl, conn.fd);
+                if (SSL_connect(conn.ssl) != 1) {
+                    errno = EPROTO;
+                    return false;
+                }
+            }
+            fcntl(conn.fd, F_SETFL, fcntl(conn.fd, F_GETFL) | O_NONBLOCK);
+
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.u64 = index;
+            return epoll_ctl(epoll_fd, EPOLL_CTL_ADD, conn.fd, &event) == 0;
+        }
+
+        // 연결 번호에 따라 /health 또는 틀린 코드로 인증 (검증 경로를 끝까지 타고 401)
+        std::string request(size_t index) const {
+            if (index % 2 == 0) return "GET /health HTTP/1.1\r\nHost: bench\r\n\r\n";
+            std::string body = "{\"user_id\": \"" + bench::fixtureUserId((index + seed) % FIXTURE_USERS) +
+                               "\", \"otp_code\": \"000000\"}";
+            return "POST /api/authenticate HTTP/1.1\r\nHost: bench\r\nContent-Type: application/json\r\n"
+                   "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+        }
+
+        bool send(size_t index) {
+            ClientConn& conn = conns[index];
+            std::string data = request(index);
+            size_t offset = 0;
+            while (offset < data.size()) {
+                ssize_t n;
+                if (conn.ssl) {
+                    int written = SSL_write(conn.ssl, data.data() + offset, static_cast<int>(data.size() - offset));
+                    n = written > 0 ? written : -1;
+                    if (n < 0) {
+                        int error = SSL_get_error(conn.ssl, written);
+                        if (error != SSL_ERROR_WANT_READ && error != SSL_ERROR_WANT_WRITE) return false;
+                    }
+                } else {
+                    n = ::send(conn.fd, data.data() + offset, data.size() - offset, MSG_NOSIGNAL);
+                    if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) return false;
+                }
+                if (n > 0) offset += static_cast<size_t>(n);
+                else std::this_thread::yield();
+            }
+            conn.sent_ns = bench::nowNs();
+            conn.waiting = true;
+            return true;
+        }
+
+        // 읽을 수 있는 만큼 읽고 응답 하나가 완성되면 상태 코드 반환 (0: 아직, -1: 연결 끊김)
+        int receive(size_t index) {
+            ClientConn& conn = conns[index];
+            char buffer[4096];
+            for (;;) {
+                ssize_t n;
+                if (conn.ssl) {
+                    int got = SSL_read(conn.ssl, buffer, sizeof(buffer));
+                    if (got <= 0) {
+                        int error = SSL_get_error(conn.ssl, got);
+                        if (error == SSL_ERROR_WANT_READ || error == SSL_ERROR_WANT_WRITE) break;
+                        return -1;
+                    }
+                    n = got;
+                } else {
+                    n = ::recv(conn.fd, buffer, sizeof(buffer), 0);
+                    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+                    if (n <= 0) return -1;
+                }
+                conn.in.append(buffer, static_cast<size_t>(n));
+            }
+
+            size_t end = conn.in.find("\r\n\r\n");
+            if (end == std::string::npos) return 0;
+            size_t length_pos = conn.in.find("Content-Length: ");
+            size_t length = length_pos < end ? std::stoul(conn.in.substr(length_pos + 16)) : 0;
+            if (conn.in.size() < end + 4 + length) return 0;
+            int status = std::atoi(conn.in.c_str() + 9);
+            conn.in.erase(0, end + 4 + length);
+            conn.waiting = false;
+            return status;
+        }
+
+        bool sweep(const std::vector<size_t>& indices, ClientResult& result) {
+            for (size_t index : indices) {
+                if (!send(index)) return fail(result, "send failed on connection " + std::to_string(index));
+            }
+            size_t pending = indices.size();
+            epoll_event events[256];
+            while (pending > 0) {
+                int count = epoll_wait(epoll_fd, events, 256, CLIENT_TIMEOUT_MS);
+                if (count <= 0) return fail(result, std::to_string(pending) + " responses missing after sweep");
+                for (int i = 0; i < count; i++) {
+                    size_t index = events[i].data.u64;
+                    if (!conns[index].waiting) continue;
+                    int status = receive(index);
+                    if (status < 0) return fail(result, "connection " + std::to_string(index) + " closed by server");
+                    if (status == 0) continue;
+                    if (status != 200 && status != 401) result.bad_responses++;
+                    pending--;
+                }
+            }
+            return true;
+        }
+
+        bool closedLoop(const std::vector<size_t>& indices, double min_seconds, ClientResult& result) {
+            LatencyHistogram histogram;
+            uint64_t start = bench::nowNs();
+            uint64_t deadline = start + static_cast<uint64_t>(min_seconds * 1e9);
+            for (size_t index : indices) {
+                if (!send(index)) return fail(result, "send failed on connection " + std::to_string(index));
+            }
+            size_t outstanding = indices.size();
+            epoll_event events[256];
+            while (outstanding > 0) {
+                int count = epoll_wait(epoll_fd, events, 256, CLIENT_TIMEOUT_MS);
+                if (count <= 0) return fail(result, "responses missing in closed loop");
+                uint64_t now = bench::nowNs();
+                for (int i = 0; i < count; i++) {
+                    size_t index = events[i].data.u64;
+                    if (!conns[index].waiting) continue;
+                    int status = receive(index);
+                    if (status < 0) return fail(result, "connection " + std::to_string(index) + " closed by server");
+                    if (status == 0) continue;
+                    histogram.record(now - conns[index].sent_ns);
+                    if (status != 200 && status != 401) result.bad_responses++;
+                    if (now < deadline) {
+                        if (!send(index)) return fail(result, "send failed on connection " + std::to_string(index));
+                    } else {
+                        outstanding--;
+                    }
+                }
+            }
+            result.active_ns = bench::nowNs() - start;
+            result.active_requests = histogram.count();
+            result.p50_ns = histogram.percentile(50.0);
+            result.p99_ns = histogram.percentile(99.0);
+            result.p999_ns = histogram.percentile(99.9);
+            return true;
+        }
+    };
+
+    int freePort() {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(addr);
+        int port = 0;
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0 &&
+            getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &length) == 0) {
+            port = ntohs(addr.sin_port);
+        }
+        ::close(fd);
+        return port;
+    }
+
+    bool canConnect(int port) {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bool ok = ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+        ::close(fd);
+        return ok;
+    }
+
+    // /proc/self/status의 한 항목 (kB 또는 개수)
+    uint64_t procStatus(const std::string& key) {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.compare(0, key.size() + 1, key + ":") == 0) return std::stoull(line.substr(key.size() + 1));
+        }
+        return 0;
+    }
+
+    /**
+     * @brief 연결 count개로 한 번 측정 (클라이언트는 자식 프로세스, 서버는 이 프로세스의 MFAServer)
+     * @return 실패 시 false (메시지는 error)
+     */
+    bool runOnce(bench::State& state, size_t count, bool use_tls, const std::string& user_file, ClientResult& result,
+                 uint64_t& rss_per_connection, size_t& server_threads, std::string& error) {
+        const std::string& dir = state.options.work_dir;
+        std::string cert_path = use_tls ? dir + "/event_listener.crt" : "";
+        std::string key_path = use_tls ? dir + "/event_listener.key" : "";
+        if (use_tls && !bench::writeSelfSignedCert(cert_path, key_path, true)) {
+            error = "could not create a self-signed certificate";
+            return false;
+        }
+
+        int port = freePort();
+        int to_child[2];
+        int from_child[2];
+        int results[2];
+        if (pipe2(to_child, O_CLOEXEC) != 0 || pipe2(from_child, O_CLOEXEC) != 0 || pipe2(results, O_CLOEXEC) != 0) {
+            error = "pipe failed";
+            return false;
+        }
+
+        // 서버 스레드를 만들기 전에 fork (자식은 클라이언트 코드만 실행)
+        pid_t child = fork();
+        if (child == 0) {
+            char go = 0;
+            ClientResult client_result;
+            if (::read(to_child[0], &go, 1) == 1) {
+                SSL_CTX* tls = use_tls ? SSL_CTX_new(TLS_client_method()) : nullptr;
+                Client client(port, tls, count);
+                client.run(count, state.options.min_seconds, from_child[1], to_child[0], client_result);
+            }
+            ssize_t written = ::write(results[1], &client_result, sizeof(client_result));
+            _exit(written == sizeof(client_result) ? 0 : 1);
+        }
+        ::close(to_child[0]);
+        ::close(from_child[1]);
+        ::close(results[1]);
+
+        bool ok = child > 0;
+        {
+            bench::QuietStdout quiet;
+            MFAServer server(port, cert_path, key_path, user_file, StorageMode::Memory);
+            server.setRateLimits(RateLimit{}, RateLimit{});
+            ServerTuning tuning;
+            tuning.listener = ListenerMode::Epoll;
+            tuning.keep_alive_max_count = 1000000;
+            tuning.keep_alive_timeout_sec = 600;
+            tuning.read_timeout_sec = 600;
+            tuning.listen_backlog = 4096;
+            tuning.tcp_nodelay = true;
+            server.setTuning(tuning);
+            std::thread server_thread([&server]() { server.start(); });
+
+            uint64_t wait_start = bench::nowNs();
+            while (ok && !canConnect(port)) {
+                if (bench::nowNs() - wait_start > 5000000000ull) {
+                    error = "server did not start listening";
+                    ok = false;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+
+            uint64_t rss_before = procStatus("VmRSS");
+            char signal = 'G';
+            ok = ok && ::write(to_child[1], &signal, 1) == 1;
+            if (ok && ::read(from_child[0], &signal, 1) == 1) {
+                uint64_t rss_after = procStatus("VmRSS");
+                rss_per_connection = rss_after > rss_before ? (rss_after - rss_before) * 1024 / count : 0;
+                server_threads = procStatus("Threads");
+                ok = ::write(to_child[1], &signal, 1) == 1;
+            }
+
+            ok = ::read(results[0], &result, sizeof(result)) == sizeof(result) && ok;
+            if (child > 0) waitpid(child, nullptr, 0);
+            server.stop();
+            server_thread.join();
+        }
+        ::close(to_child[1]);
+        ::close(from_child[0]);
+        ::close(results[0]);
+
+        if (result.error[0]) error = result.error;
+        else if (!ok && error.empty()) error = "client process failed";
+        return ok && !result.error[0];
+    }
+
+    void reportRun(bench::State& state, const std::string& label, size_t count, const ClientResult& result,
+                   uint64_t rss_per_connection, size_t server_threads) {
+        state.report("event_listener_connections", label + " connect", result.connected,
+                     static_cast<double>(result.connect_ns),
+                     "conn/s=" + std::to_string(static_cast<uint64_t>(result.connected * 1e9 /
+                                                                      std::max<uint64_t>(1, result.connect_ns))) +
+                         " server_rss/conn=" + std::to_string(rss_per_connection) + "B server_threads=" +
+                         std::to_string(server_threads));
+        state.report("event_listener_connections", label + " all active", result.sweep_requests,
+                     static_cast<double>(result.sweep_ns),
+                     "req/s=" + std::to_string(static_cast<uint64_t>(result.sweep_requests * 1e9 /
+                                                                     std::max<uint64_t>(1, result.sweep_ns))));
+        state.report("event_listener_connections",
+                     label + " active=" + std::to_string(std::min(count, ACTIVE_CONNECTIONS)) + " idle=" +
+                         std::to_string(count - std::min(count, ACTIVE_CONNECTIONS)),
+                     result.active_requests, static_cast<double>(result.active_ns),
+                     "req/s=" + std::to_string(static_cast<uint64_t>(result.active_requests * 1e9 /
+                                                                     std::max<uint64_t>(1, result.active_ns))) +
+                         " p50=" + std::to_string(result.p50_ns / 1000) + "us p99=" +
+                         std::to_string(result.p99_ns / 1000) + "us p99.9=" + std::to_string(result.p999_ns / 1000) +
+                         "us");
+    }
+}
+
+// epoll 리스너의 동시 keep-alive 연결 처리 (--listener epoll)
+// - 연결 N개를 열고(connect), 모든 연결에 한 번씩 동시에 요청(all active)한 뒤,
+//   64개만 닫힌 루프로 요청하고 나머지는 쉬는 동안의 처리량과 지연(active/idle)
+// - 요청은 /health와 틀린 코드의 /api/authenticate(401)를 번갈아 보냄
+// - 서버 RSS 증가분을 연결 수로 나눈 값 = 쉬는 연결 하나의 메모리 비용
+// - 클라이언트는 자식 프로세스라 두 프로세스가 각자 RLIMIT_NOFILE을 씀 (한도를 넘는 규모는 건너뜀)
+// - TLS는 연결 1000개로 같은 경로를 확인
+MFA_BENCHMARK(event_listener_connections) {
+    std::string user_file = bench::prepareUserFixture(state, "event_listener_connections", FIXTURE_USERS);
+    if (user_file.empty()) {
+        return;
+    }
+    size_t file_limit = EventServer::raiseFileLimit();
+
+    struct Run {
+        size_t count;
+        bool tls;
+    };
+    std::vector<Run> runs;
+    for (size_t count : CONNECTION_COUNTS) runs.push_back({count, false});
+    runs.push_back({TLS_CONNECTIONS, true});
+
+    for (const Run& run : runs) {
+        std::string label = std::string(run.tls ? "tls " : "") + "connections=" + std::to_string(run.count);
+        if (run.count + FD_HEADROOM > file_limit) {
+            state.report("event_listener_connections", label, 0, 0,
+                         "skipped: RLIMIT_NOFILE=" + std::to_string(file_limit) + " (raise the hard limit)");
+            continue;
+        }
+
+        ClientResult result;
+        uint64_t rss_per_connection = 0;
+        size_t server_threads = 0;
+        std::string error;
+        if (!runOnce(state, run.count, run.tls, user_file, result, rss_per_connection, server_threads, error)) {
+            state.fail("event_listener_connections", label + ": " + error);
+            continue;
+        }
+        reportRun(state, label, run.count, result, rss_per_connection, server_threads);
+        if (result.bad_responses > 0) {
+            state.fail("event_listener_connections",
+                       label + ": " + std::to_string(result.bad_responses) + " responses were not 200/401");
+        }
+    }
+}
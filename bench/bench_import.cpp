@@ -0,0 +1,169 @@
+#include "bench.h"
+#include "mfa_core.h"
+#include "user_io.h"
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+    constexpr size_t IMPORT_CHUNK = 65536;              // 서버/mfa-admin과 같은 청크 크기
+    constexpr size_t INPUT_PIECE = 64 * 1024;           // 네트워크/파일에서 읽는 조각 크기 흉내
+
+    void removeStoreFiles(const std::string& path) {
+        for (const char* suffix : {"", ".tmp", ".wal", ".wal.1", ".wal.tmp", ".map", ".idx", ".idx.tmp",
+                                   ".replay", ".replay.tmp"}) {
+            ::unlink((path + suffix).c_str());
+        }
+    }
+
+    std::string makeInput(size_t user_count) {
+        std::string input = "user_id\n";
+        input.reserve(user_count * 16);
+        for (size_t i = 0; i < user_count; i++) {
+            input += bench::fixtureUserId(i);
+            input += '\n';
+        }
+        return input;
+    }
+
+    struct ImportRun {
+        size_t counts[4] = {0, 0, 0, 0};
+        std::unordered_map<std::string, std::string> secrets;   // 새로 등록된 사용자 (검증용, 표본)
+    };
+
+    // 서버 핸들러와 같은 경로: 조각 단위 파싱 -> 청크별 importUsers
+    ImportRun runImport(MFACore& core, const std::string& input) {
+        ImportRun run;
+        UserIO::Reader reader(UserIO::Format::CSV);
+        std::vector<ImportItem> items;
+        std::vector<size_t> lines;
+        auto flush = [&]() {
+            std::vector<ImportStatus> statuses = core.importUsers(items);
+            for (size_t i = 0; i < items.size(); i++) {
+                run.counts[static_cast<size_t>(statuses[i])]++;
+                if (statuses[i] == ImportStatus::Created && (lines[i] & 1023) == 0) {
+                    run.secrets.emplace(items[i].user_id, items[i].secret_base32);
+                }
+            }
+            items.clear();
+            lines.clear();
+        };
+        for (size_t pos = 0; pos < input.size(); pos += INPUT_PIECE) {
+            reader.feed(std::string_view(input).substr(pos, INPUT_PIECE), items, lines);
+            if (items.size() >= IMPORT_CHUNK) flush();
+        }
+        reader.finish(items, lines);
+        flush();
+        return run;
+    }
+}
+
+// 대량 등록/내보내기 처리량 (users/s)과 이전 방식(사용자마다 registerUser) 비교
+// - 모든 사용자가 한 번씩 등록되고, 같은 입력을 다시 넣으면 모두 "exists"
+// - 내보낸 시크릿이 등록 결과와 일치
+MFA_BENCHMARK(bulk_import_by_user_count) {
+    const std::pair<StorageMode, const char*> modes[] = {
+        {StorageMode::Memory, "memory"},
+        {StorageMode::Mapped, "mapped"},
+    };
+
+    // 이전 방식: 사용자마다 registerUser (요청마다 WAL 커밋을 기다림)
+    {
+        std::string path = state.options.work_dir + "/import_baseline.dat";
+        removeStoreFiles(path);
+        const size_t user_count = 2000;
+        size_t registered = 0;
+        uint64_t start = 0;
+        uint64_t elapsed_ns = 0;
+        {
+            bench::QuietStdout quiet;
+            MFACore core(path);
+            start = bench::nowNs();
+            for (size_t i = 0; i < user_count; i++) {
+                User user;
+                registered += core.registerUser(bench::fixtureUserId(i), user);
+            }
+            elapsed_ns = bench::nowNs() - start;
+        }
+        removeStoreFiles(path);
+        state.report("bulk_import_by_user_count", "registerUser loop users=" + std::to_string(user_count),
+                     user_count, static_cast<double>(elapsed_ns),
+                     "users/s=" + std::to_string(static_cast<uint64_t>(user_count * 1e9 / elapsed_ns)));
+        if (registered != user_count) {
+            state.fail("bulk_import_by_user_count", "registerUser loop registered " + std::to_string(registered));
+        }
+    }
+
+    for (size_t user_count : {10000, 100000, 1000000}) {
+        if (user_count > state.options.max_users) {
+            break;
+        }
+        std::string input = makeInput(user_count);
+
+        for (const auto& mode : modes) {
+            std::string path = state.options.work_dir + "/import_" + mode.second + ".dat";
+            removeStoreFiles(path);
+            std::string param = std::string(mode.second) + " users=" + std::to_string(user_count);
+
+            std::unique_ptr<MFACore> core;
+            {
+                bench::QuietStdout quiet;
+                core = std::make_unique<MFACore>(path, mode.first);
+            }
+
+            ImportRun first;
+            ImportRun again;
+            uint64_t import_ns = 0;
+            uint64_t dedupe_ns = 0;
+            {
+                bench::QuietStdout quiet;     // 체크포인트 로그
+                uint64_t start = bench::nowNs();
+                first = runImport(*core, input);
+                import_ns = bench::nowNs() - start;
+
+                start = bench::nowNs();
+                again = runImport(*core, input);
+                dedupe_ns = bench::nowNs() - start;
+            }
+
+            std::string exported;
+            size_t mismatched = 0;
+            uint64_t start = bench::nowNs();
+            size_t export_count = core->exportUsers([&](std::string_view user_id, std::string_view secret) {
+                UserIO::appendExportRecord(exported, UserIO::Format::CSV, user_id, secret);
+                if (exported.size() >= (1 << 20)) exported.clear();
+                auto it = first.secrets.find(std::string(user_id));
+                if (it != first.secrets.end() && it->second != secret) mismatched++;
+            });
+            uint64_t export_ns = bench::nowNs() - start;
+
+            {
+                bench::QuietStdout quiet;
+                core.reset();
+            }
+            removeStoreFiles(path);
+
+            state.report("bulk_import_by_user_count", "import " + param, user_count, static_cast<double>(import_ns),
+                         "users/s=" + std::to_string(static_cast<uint64_t>(user_count * 1e9 / import_ns)));
+            state.report("bulk_import_by_user_count", "dedupe " + param, user_count, static_cast<double>(dedupe_ns),
+                         "users/s=" + std::to_string(static_cast<uint64_t>(user_count * 1e9 / dedupe_ns)));
+            state.report("bulk_import_by_user_count", "export " + param, export_count, static_cast<double>(export_ns),
+                         "users/s=" + std::to_string(static_cast<uint64_t>(export_count * 1e9 / export_ns)));
+
+            if (first.counts[0] != user_count) {
+                state.fail("bulk_import_by_user_count", param + ": created " + std::to_string(first.counts[0]));
+            }
+            if (again.counts[1] != user_count) {
+                state.fail("bulk_import_by_user_count", param + ": re-import reported " +
+                                                            std::to_string(again.counts[1]) + " existing");
+            }
+            if (export_count != user_count || mismatched != 0) {
+                state.fail("bulk_import_by_user_count", param + ": exported " + std::to_string(export_count) +
+                                                            " users, " + std::to_string(mismatched) + " secret mismatches");
+            }
+        }
+    }
+}
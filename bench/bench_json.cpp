@@ -0,0 +1,85 @@
+#include "bench.h"
+#include "json_reader.h"
+#include <string>
+#include <string_view>
+
+namespace {
+
+    // 이전 핸들러들의 find/substr 추출 (필드마다 std::string 할당)
+    std::string legacyExtract(const std::string& body, const char* key) {
+        size_t start = body.find(key);
+        if (start == std::string::npos) return "";
+        start = body.find(":", start);
+        if (start == std::string::npos) return "";
+        start = body.find("\"", start) + 1;
+        size_t end = body.find("\"", start);
+        if (end == std::string::npos) return "";
+        return body.substr(start, end - start);
+    }
+
+    std::string batchBody(size_t items) {
+        std::string body = "{\"items\": [";
+        for (size_t i = 0; i < items; i++) {
+            if (i > 0) body += ", ";
+            body += "{\"user_id\": \"user_" + std::to_string(i) + "\", \"otp_code\": \"123456\"}";
+        }
+        body += "]}";
+        return body;
+    }
+}
+
+// 요청 본문 파싱 비용 (ns/request): 이전 find/substr 추출 vs string_view 토크나이저
+MFA_BENCHMARK(json_parse) {
+    struct Case {
+        const char* name;
+        std::string body;
+    };
+    const Case cases[] = {
+        {"register", "{\"user_id\": \"alice@example.com\"}"},
+        {"authenticate", "{\"user_id\": \"alice@example.com\", \"otp_code\": \"123456\"}"},
+        {"authenticate_pretty", "{\n  \"client\": {\"name\": \"gateway\", \"version\": [1, 2, 3]},\n"
+                                "  \"user_id\" : \"alice@example.com\",\n  \"otp_code\" : \"123456\"\n}"},
+        {"authenticate_escaped", "{\"user_id\": \"al\\u0069ce\\\"q\\\"@example.com\", \"otp_code\": \"123456\"}"},
+    };
+    const std::string_view keys[] = {"user_id", "otp_code"};
+
+    for (const Case& c : cases) {
+        uint64_t iterations = 0;
+        double elapsed = bench::measure([&](uint64_t) {
+            std::string user_id = legacyExtract(c.body, "\"user_id\"");
+            std::string otp_code = legacyExtract(c.body, "\"otp_code\"");
+            bench::doNotOptimize(user_id.size() + otp_code.size());
+        }, iterations, state.options.min_seconds);
+        state.report("json_parse", std::string("find_substr ") + c.name, iterations, elapsed);
+
+        iterations = 0;
+        elapsed = bench::measure([&](uint64_t) {
+            std::string_view fields[2];
+            char scratch[256];
+            Json::Error error = Json::parseStringFields(c.body, keys, fields, 2, scratch, sizeof(scratch));
+            bench::doNotOptimize(fields[0].size() + fields[1].size() + static_cast<size_t>(error));
+        }, iterations, state.options.min_seconds);
+        state.report("json_parse", std::string("tokenizer ") + c.name, iterations, elapsed,
+                     "bytes=" + std::to_string(c.body.size()));
+    }
+
+    // 일괄 인증 본문: 항목 하나당 비용
+    for (size_t items : {10, 100, 1000}) {
+        std::string body = batchBody(items);
+        Json::Limits limits;
+        limits.max_bytes = body.size();
+
+        uint64_t iterations = 0;
+        double elapsed = bench::measure([&](uint64_t) {
+            Json::Tokenizer tokenizer(body, limits);
+            size_t parsed = 0;
+            for (Json::Token token = tokenizer.next(); token != Json::Token::End && token != Json::Token::Error;
+                 token = tokenizer.next()) {
+                parsed += token == Json::Token::String ? tokenizer.text().size() : 0;
+            }
+            bench::doNotOptimize(parsed);
+        }, iterations, state.options.min_seconds);
+        state.report("json_parse", "tokenize batch=" + std::to_string(items), iterations * items, elapsed,
+                     "per_item");
+    }
+}
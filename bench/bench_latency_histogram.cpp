@@ -0,0 +1,47 @@
+#include "bench.h"
+#include "latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// mfa-loadgen 지연 히스토그램: 기록 비용과 백분위 정확도(정렬한 정확한 값 대비 0.1% 이내),
+// coordinated omission 보정 샘플 수 검사
+MFA_BENCHMARK(latency_histogram) {
+    std::mt19937_64 rng(42);
+    std::lognormal_distribution<double> latency(std::log(200000.0), 1.0);     // 중앙값 200us, 긴 꼬리
+    std::vector<uint64_t> values(1 << 20);
+    for (auto& value : values) value = static_cast<uint64_t>(latency(rng)) + 1;
+
+    LatencyHistogram histogram;
+    uint64_t iterations = 0;
+    double elapsed = bench::measure([&](uint64_t i) {
+        histogram.record(values[i & (values.size() - 1)]);
+    }, iterations, state.options.min_seconds);
+    state.report("latency_histogram", "record", iterations, elapsed);
+
+    histogram.reset();
+    for (uint64_t value : values) histogram.record(value);
+    std::vector<uint64_t> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+
+    for (double p : {50.0, 90.0, 99.0, 99.9, 99.99, 100.0}) {
+        size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * static_cast<double>(sorted.size())));
+        uint64_t exact = sorted[std::max<size_t>(rank, 1) - 1];
+        uint64_t estimate = histogram.percentile(p);
+        double error = std::fabs(static_cast<double>(estimate) - static_cast<double>(exact)) / static_cast<double>(exact);
+        if (error > 0.001) {
+            state.fail("latency_histogram", "p" + std::to_string(p) + " = " + std::to_string(estimate) +
+                                                " (exact " + std::to_string(exact) + ")");
+        }
+    }
+
+    // 1ms 간격으로 보내야 했는데 1초 막힌 요청 하나 = 실제 1개 + 보내지 못한 999개
+    LatencyHistogram corrected;
+    corrected.recordCorrected(1000000000, 1000000);
+    if (corrected.count() != 1000 || corrected.percentile(50.0) < 499000000 || corrected.percentile(50.0) > 501000000) {
+        state.fail("latency_histogram", "coordinated omission correction recorded " +
+                                            std::to_string(corrected.count()) + " samples, p50 " +
+                                            std::to_string(corrected.percentile(50.0)));
+    }
+}
@@ -0,0 +1,88 @@
+#include "bench.h"
+#include "alloc_counter.h"
+#include "mfa_core.h"
+#include "json_writer.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// GET /api/users 비용: 전체 목록을 한 번에 만들기 vs 커서 페이지 (limit=1000)
+MFA_BENCHMARK(list_users_by_user_count) {
+    const size_t sizes[] = {10000, 100000, 1000000};
+    const size_t page_size = 1000;
+
+    for (size_t user_count : sizes) {
+        if (user_count > state.options.max_users) {
+            break;
+        }
+
+        std::string path = bench::prepareUserFixture(state, "list_users_by_user_count", user_count);
+        if (path.empty()) {
+            return;
+        }
+
+        std::unique_ptr<MFACore> core;
+        {
+            bench::QuietStdout quiet;
+            core = std::make_unique<MFACore>(path);
+        }
+
+        // 이전 방식: listUsers() 벡터 + 전체 응답 본문
+        uint64_t full_bytes = 0;
+        uint64_t iterations = 0;
+        double elapsed = bench::measure([&](uint64_t) {
+            bench::AllocScope scope;
+            std::vector<std::string> users = core->listUsers();
+            Json::Writer& json = Json::Writer::local();
+            json.beginObject().key("users").beginArray();
+            for (const auto& user_id : users) json.string(user_id);
+            json.endArray().endObject();
+            std::string body(json.view());
+            bench::doNotOptimize(body.size());
+            full_bytes = scope.bytes();
+        }, iterations, state.options.min_seconds);
+        state.report("list_users_by_user_count", "full users=" + std::to_string(user_count), iterations, elapsed,
+                     "alloc_bytes/req=" + std::to_string(full_bytes));
+
+        // 페이지 하나 (커서 순서로 끝까지 돌아가며 측정)
+        uint64_t cursor = 0;
+        uint64_t page_bytes = 0;
+        iterations = 0;
+        elapsed = bench::measure([&](uint64_t) {
+            bench::AllocScope scope;
+            Json::Writer& json = Json::Writer::local();
+            json.beginObject().key("users").beginArray();
+            uint64_t next = 0;
+            bool more = core->scanUsers(cursor, page_size, "", [&](std::string_view user_id) {
+                json.string(user_id);
+            }, next);
+            json.endArray().endObject();
+            std::string body(json.view());
+            bench::doNotOptimize(body.size());
+            cursor = more ? next : 0;
+            if (scope.bytes() > page_bytes) page_bytes = scope.bytes();
+        }, iterations, state.options.min_seconds);
+        state.report("list_users_by_user_count", "page users=" + std::to_string(user_count), iterations, elapsed,
+                     "limit=1000 max_alloc_bytes/req=" + std::to_string(page_bytes));
+
+        // 전체를 페이지로 순회 (스트리밍 응답과 같은 경로): 누락/중복 검사
+        size_t seen = 0;
+        cursor = 0;
+        uint64_t walk_start = bench::nowNs();
+        for (bool more = true; more;) {
+            uint64_t next = 0;
+            more = core->scanUsers(cursor, page_size, "", [&](std::string_view) { seen++; }, next);
+            cursor = next;
+        }
+        uint64_t walk_ns = bench::nowNs() - walk_start;
+        state.report("list_users_by_user_count", "walk users=" + std::to_string(user_count), seen, walk_ns,
+                     "per_user");
+        if (seen != user_count) {
+            state.fail("list_users_by_user_count", "paged walk saw " + std::to_string(seen) + " of " +
+                       std::to_string(user_count) + " users");
+        }
+
+        bench::QuietStdout quiet;
+        core.reset();
+    }
+}
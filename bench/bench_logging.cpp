@@ -0,0 +1,122 @@
+#include "bench.h"
+#include "mfa_core.h"
+#include "logger.h"
+#include <atomic>
+#include <fcntl.h>
+#include <memory>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+    // 이전 handleAuthenticate + verifyTOTP가 요청마다 출력하던 줄 (동기 std::cout + std::endl)
+    void legacyRequestLog(const std::string& user_id, const std::string& otp_code) {
+        std::cout << "\n=== [DEBUG] Authenticate Request Received ===" << std::endl;
+        std::cout << "Request body: {\"user_id\": \"" << user_id << "\", \"otp_code\": \"" << otp_code << "\"}" << std::endl;
+        std::cout << "[DEBUG] Parsed user_id: '" << user_id << "'" << std::endl;
+        std::cout << "[DEBUG] Parsed otp_code: '" << otp_code << "'" << std::endl;
+        std::cout << "[DEBUG] Attempting to verify TOTP for user: " << user_id << std::endl;
+        std::cout << "[MFA_CORE] verifyTOTP called for user: " << user_id << ", OTP: " << otp_code << std::endl;
+        std::cout << "[MFA_CORE] User found, secret: JBSWY3DPEHPK3PXPJBSWY3DPEHPK3PXP" << std::endl;
+        std::cout << "[MFA_CORE] Current time: " << time(nullptr) << std::endl;
+        for (int w = -1; w <= 1; w++) {
+            std::cout << "[MFA_CORE] Window " << w << ": generated=123456, input=" << otp_code << std::endl;
+        }
+        std::cout << "[MFA_CORE] No OTP match found" << std::endl;
+        std::cout << "[DEBUG] TOTP verification result: FAILED" << std::endl;
+        std::cout << "[DEBUG] Sending failure response" << std::endl;
+        std::cout << "=== [DEBUG] Authenticate Request Completed ===" << std::endl;
+    }
+
+    // 현재 handleAuthenticate가 남기는 로그 (verifyTOTP 내부 로그는 코어에서 출력)
+    void asyncRequestLog(const std::string& user_id, const std::string& otp_code) {
+        MFA_LOG_DEBUG("SERVER", "Authenticate request received (" << user_id.size() + otp_code.size() + 32 << " bytes)");
+        MFA_LOG_DEBUG("SERVER", "Parsed user_id: '" << user_id << "', otp_code: " << Log::redact(otp_code));
+    }
+}
+
+// /api/authenticate 처리 경로의 로깅 비용: 동기 std::cout vs 비동기 링 버퍼 로거
+MFA_BENCHMARK(authenticate_logging_by_threads) {
+    const size_t user_count = 1000;
+    std::string path = bench::prepareUserFixture(state, "authenticate_logging_by_threads", user_count);
+    std::string log_path = state.options.work_dir + "/logging_bench.log";
+    if (path.empty()) {
+        return;
+    }
+
+    std::unique_ptr<MFACore> core;
+    {
+        bench::QuietStdout quiet;
+        core = std::make_unique<MFACore>(path);
+    }
+
+    struct Mode {
+        const char* name;
+        bool legacy;
+        Log::Level level;
+    };
+    const Mode modes[] = {
+        {"cout_sync", true, Log::Level::Off},
+        {"async_debug", false, Log::Level::Debug},
+        {"async_info", false, Log::Level::Info},
+    };
+    const int thread_counts[] = {1, 4, 16};
+
+    Log::Level saved_level = Log::level();
+
+    for (const Mode& mode : modes) {
+        for (int threads : thread_counts) {
+            // 실제 stdout 경로(잠금 + flush + write)를 재현하기 위해 fd 1을 파일로 교체
+            int log_fd = ::open(log_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+            if (log_fd < 0) {
+                state.fail("authenticate_logging_by_threads", "cannot open log file: " + log_path);
+                return;
+            }
+            std::cout.flush();
+            int saved_stdout = ::dup(STDOUT_FILENO);
+            ::dup2(log_fd, STDOUT_FILENO);
+            Log::setOutput(log_fd);
+            Log::setLevel(mode.level);
+            uint64_t dropped_before = Log::droppedCount();
+
+            std::atomic<bool> running{true};
+            std::atomic<uint64_t> requests{0};
+            std::vector<std::thread> workers;
+            uint64_t start = bench::nowNs();
+            for (int t = 0; t < threads; t++) {
+                workers.emplace_back([&, t] {
+                    uint64_t local = 0;
+                    for (uint64_t i = t; running.load(std::memory_order_relaxed); i += 7) {
+                        const std::string user_id = bench::fixtureUserId(i % user_count);
+                        const std::string otp_code = "000000";
+                        if (mode.legacy) {
+                            legacyRequestLog(user_id, otp_code);
+                        } else {
+                            asyncRequestLog(user_id, otp_code);
+                        }
+                        bench::doNotOptimize(core->verifyTOTP(user_id, otp_code));
+                        local++;
+                    }
+                    requests += local;
+                });
+            }
+            std::this_thread::sleep_for(std::chrono::duration<double>(std::max(state.options.min_seconds, 0.5)));
+            running = false;
+            for (auto& worker : workers) worker.join();
+            uint64_t elapsed_ns = bench::nowNs() - start;
+
+            Log::flush();
+            Log::setLevel(saved_level);
+            Log::setOutput(-1);
+            std::cout.flush();
+            ::dup2(saved_stdout, STDOUT_FILENO);
+            ::close(saved_stdout);
+            ::close(log_fd);
+
+            std::string extra = "dropped=" + std::to_string(Log::droppedCount() - dropped_before);
+            state.report("authenticate_logging", std::string(mode.name) + " threads=" + std::to_string(threads),
+                         requests, static_cast<double>(elapsed_ns), extra);
+        }
+    }
+    ::unlink(log_path.c_str());
+}
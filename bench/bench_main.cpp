@@ -0,0 +1,274 @@
+#include "bench.h"
+#include "mfa_core.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <ctime>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/rsa.h>
+#include <openssl/x509.h>
+
+namespace bench {
+
+std::vector<std::pair<std::string, BenchFn>>& registry() {
+    static std::vector<std::pair<std::string, BenchFn>> benches;
+    return benches;
+}
+
+void State::report(const std::string& name, const std::string& param,
+                   uint64_t iterations, double elapsed_ns, const std::string& extra) {
+    results.push_back(Result{name, param, iterations, elapsed_ns, extra});
+
+    double ns_per_op = iterations ? elapsed_ns / static_cast<double>(iterations) : 0.0;
+    double ops_per_sec = ns_per_op > 0 ? 1e9 / ns_per_op : 0.0;
+
+    std::cout << std::left << std::setw(28) << name
+              << std::setw(22) << param
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(14) << ns_per_op << " ns/op"
+              << std::setw(14) << std::setprecision(0) << ops_per_sec << " ops/s"
+              << (extra.empty() ? "" : "  ") << extra << std::endl;
+}
+
+void State::fail(const std::string& name, const std::string& message) {
+    failures.emplace_back(name, message);
+    std::cerr << "[FAIL] " << name << ": " << message << std::endl;
+}
+
+namespace {
+
+    void writeJSONString(std::ostream& out, const std::string& text) {
+        static const char hex[] = "0123456789abcdef";
+        out << '"';
+        for (unsigned char c : text) {
+            if (c == '"' || c == '\\') {
+                out << '\\' << c;
+            } else if (c < 0x20) {
+                out << "\\u00" << hex[c >> 4] << hex[c & 0xF];
+            } else {
+                out << c;
+            }
+        }
+        out << '"';
+    }
+
+    // 결과 하나: 실행 간 diff가 줄 단위로 보이도록 한 줄에 하나씩
+    void writeJSONResult(std::ostream& out, const Result& result) {
+        double ns_per_op = result.iterations ? result.elapsed_ns / static_cast<double>(result.iterations) : 0.0;
+        out << "{\"name\": ";
+        writeJSONString(out, result.name);
+        out << ", \"param\": ";
+        writeJSONString(out, result.param);
+        out << ", \"iterations\": " << result.iterations
+            << std::fixed << std::setprecision(1)
+            << ", \"elapsed_ns\": " << result.elapsed_ns
+            << ", \"ns_per_op\": " << ns_per_op
+            << std::setprecision(0)
+            << ", \"ops_per_sec\": " << (ns_per_op > 0 ? 1e9 / ns_per_op : 0.0)
+            << ", \"extra\": ";
+        writeJSONString(out, result.extra);
+        out << '}';
+    }
+}
+
+void State::writeJSON(std::ostream& out) const {
+    char host[256] = {0};
+    gethostname(host, sizeof(host) - 1);
+
+    out << "{\n  \"context\": {\"host\": ";
+    writeJSONString(out, host);
+    out << ", \"timestamp\": " << static_cast<long long>(time(nullptr))
+        << ", \"cpus\": " << std::thread::hardware_concurrency()
+        << ", \"min_time\": " << std::defaultfloat << options.min_seconds
+        << ", \"max_users\": " << options.max_users
+        << ", \"filter\": ";
+    writeJSONString(out, options.filter);
+    out << "},\n  \"results\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        out << (i ? ",\n    " : "\n    ");
+        writeJSONResult(out, results[i]);
+    }
+    out << (results.empty() ? "]" : "\n  ]") << ",\n  \"failures\": [";
+    for (size_t i = 0; i < failures.size(); i++) {
+        out << (i ? ",\n    " : "\n    ") << "{\"name\": ";
+        writeJSONString(out, failures[i].first);
+        out << ", \"message\": ";
+        writeJSONString(out, failures[i].second);
+        out << '}';
+    }
+    out << (failures.empty() ? "]" : "\n  ]") << "\n}\n";
+}
+
+bool writeSelfSignedCert(const std::string& cert_path, const std::string& key_path, bool ecdsa) {
+    EVP_PKEY* key = ecdsa ? EVP_EC_gen("P-256") : EVP_RSA_gen(2048);
+    X509* cert = X509_new();
+    bool ok = key && cert;
+    if (ok) {
+        ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+        X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+        X509_gmtime_adj(X509_getm_notAfter(cert), 24 * 3600);
+        X509_set_pubkey(cert, key);
+        X509_NAME* name = X509_get_subject_name(cert);
+        X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("localhost"),
+                                   -1, -1, 0);
+        X509_set_issuer_name(cert, name);
+        ok = X509_sign(cert, key, EVP_sha256()) > 0;
+    }
+    if (ok) {
+        FILE* file = fopen(cert_path.c_str(), "w");
+        ok = file && PEM_write_X509(file, cert) == 1;
+        if (file) fclose(file);
+        file = fopen(key_path.c_str(), "w");
+        ok = ok && file && PEM_write_PrivateKey(file, key, nullptr, nullptr, 0, nullptr, nullptr) == 1;
+        if (file) fclose(file);
+    }
+    X509_free(cert);
+    EVP_PKEY_free(key);
+    return ok;
+}
+
+std::string prepareUserFixture(State& state, const std::string& name, size_t user_count) {
+    std::string path = state.options.work_dir + "/users_" + std::to_string(user_count) + ".dat";
+    if (!writeUserFixture(path, user_count)) {
+        state.fail(name, "fixture generation failed: " + path);
+        return std::string();
+    }
+    return path;
+}
+
+std::string fixtureUserId(size_t index) {
+    return "user_" + std::to_string(index);
+}
+
+bool writeUserFixture(const std::string& path, size_t user_count) {
+    const size_t record_size = MAX_USER_ID_LENGTH + BASE32_ENCODED_MAX_LENGTH;
+
+    struct stat st;
+    if (stat(path.c_str(), &st) == 0 && static_cast<size_t>(st.st_size) == user_count * record_size) {
+        return true;
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    const char* base32_chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+    uint64_t rng = 0x9E3779B97F4A7C15ull;
+    std::vector<char> buffer(record_size * 4096);
+    size_t buffered = 0;
+
+    for (size_t i = 0; i < user_count; i++) {
+        char* record = buffer.data() + buffered * record_size;
+        memset(record, 0, record_size);
+
+        std::string user_id = fixtureUserId(i);
+        memcpy(record, user_id.data(), std::min(user_id.size(), size_t(MAX_USER_ID_LENGTH - 1)));
+
+        // 20바이트 시크릿 = Base32 32자
+        char* secret = record + MAX_USER_ID_LENGTH;
+        for (int c = 0; c < 32; c++) {
+            rng ^= rng << 13;
+            rng ^= rng >> 7;
+            rng ^= rng << 17;
+            secret[c] = base32_chars[rng & 0x1F];
+        }
+
+        if (++buffered == 4096) {
+            file.write(buffer.data(), buffered * record_size);
+            buffered = 0;
+        }
+    }
+    file.write(buffer.data(), buffered * record_size);
+
+    return file.good();
+}
+
+} // namespace bench
+
+static void printUsage(const char* program_name) {
+    std::cout << "MFA 벤치마크" << std::endl;
+    std::cout << "사용법: " << program_name << " [옵션]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "옵션:" << std::endl;
+    std::cout << "  --filter <문자열>    이름에 문자열이 포함된 벤치마크만 실행" << std::endl;
+    std::cout << "  --max-users <수>     사용자 수 스윕 상한 (기본값: 10000000)" << std::endl;
+    std::cout << "  --work-dir <경로>    픽스처 디렉토리 (기본값: bench_data)" << std::endl;
+    std::cout << "  --min-time <초>      측정 구간 최소 시간 (기본값: 0.2)" << std::endl;
+    std::cout << "  --json <파일>        결과를 JSON으로도 저장 (실행 간 비교용)" << std::endl;
+    std::cout << "  --fixture <수>       <work-dir>/users_<수>.dat 합성 픽스처만 생성하고 종료" << std::endl;
+    std::cout << "  --list              벤치마크 목록 출력" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    bench::Options options;
+    size_t fixture_users = 0;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "--filter" && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else if (arg == "--max-users" && i + 1 < argc) {
+            options.max_users = std::stoull(argv[++i]);
+        } else if (arg == "--work-dir" && i + 1 < argc) {
+            options.work_dir = argv[++i];
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            options.min_seconds = std::stod(argv[++i]);
+        } else if (arg == "--json" && i + 1 < argc) {
+            options.json_path = argv[++i];
+        } else if (arg == "--fixture" && i + 1 < argc) {
+            fixture_users = std::stoull(argv[++i]);
+        } else if (arg == "--list") {
+            for (const auto& entry : bench::registry()) {
+                std::cout << entry.first << std::endl;
+            }
+            return 0;
+        } else {
+            std::cerr << "오류: 알 수 없는 옵션: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    mkdir(options.work_dir.c_str(), 0755);
+
+    if (fixture_users > 0) {
+        std::string path = options.work_dir + "/users_" + std::to_string(fixture_users) + ".dat";
+        uint64_t start = bench::nowNs();
+        if (!bench::writeUserFixture(path, fixture_users)) {
+            std::cerr << "픽스처 생성 실패: " << path << std::endl;
+            return 1;
+        }
+        std::cout << path << " (" << fixture_users << " users, "
+                  << (bench::nowNs() - start) / 1000000 << "ms)" << std::endl;
+        return 0;
+    }
+
+    bench::State state(options);
+    for (const auto& entry : bench::registry()) {
+        if (!options.filter.empty() && entry.first.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        entry.second(state);
+    }
+
+    if (!options.json_path.empty()) {
+        std::ofstream json(options.json_path, std::ios::trunc);
+        state.writeJSON(json);
+        if (!json.good()) {
+            std::cerr << "JSON 결과 저장 실패: " << options.json_path << std::endl;
+            return 1;
+        }
+    }
+
+    return state.failed() ? 1 : 0;
+}
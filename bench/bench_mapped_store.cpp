@@ -0,0 +1,65 @@
+#include "bench.h"
+#include "mfa_core.h"
+#include <algorithm>
+#include <iomanip>
+#include <memory>
+#include <random>
+#include <sstream>
+
+// 매핑 저장소: 재시작 시간(사용자 수와 무관해야 함)과 인증 지연
+MFA_BENCHMARK(mapped_store_by_user_count) {
+    const size_t sizes[] = {1000, 10000, 100000, 1000000, 10000000};
+
+    for (size_t user_count : sizes) {
+        if (user_count > state.options.max_users) {
+            break;
+        }
+
+        std::string path = bench::prepareUserFixture(state, "mapped_store_by_user_count", user_count);
+        if (path.empty()) {
+            return;
+        }
+
+        double migrate_ms = 0;
+        double open_ms = 0;
+        uint64_t iterations = 0;
+        double elapsed = 0;
+        std::vector<uint64_t> samples(10000);
+        {
+            bench::QuietStdout quiet;
+
+            // 첫 실행은 users.dat에서 이전, 이후 실행은 매핑만 수행
+            uint64_t migrate_start = bench::nowNs();
+            MFACore(path, StorageMode::Mapped);
+            migrate_ms = static_cast<double>(bench::nowNs() - migrate_start) / 1e6;
+
+            uint64_t open_start = bench::nowNs();
+            auto core = std::make_unique<MFACore>(path, StorageMode::Mapped);
+            open_ms = static_cast<double>(bench::nowNs() - open_start) / 1e6;
+
+            std::mt19937_64 rng(42);
+            std::vector<std::string> ids(4096);
+            for (auto& id : ids) {
+                id = bench::fixtureUserId(rng() % user_count);
+            }
+
+            elapsed = bench::measure([&](uint64_t i) {
+                bench::doNotOptimize(core->verifyTOTP(ids[i & 4095], "000000"));
+            }, iterations, state.options.min_seconds);
+
+            for (size_t i = 0; i < samples.size(); i++) {
+                uint64_t t0 = bench::nowNs();
+                bench::doNotOptimize(core->verifyTOTP(ids[i & 4095], "000000"));
+                samples[i] = bench::nowNs() - t0;
+            }
+        }
+        std::sort(samples.begin(), samples.end());
+        uint64_t p99 = samples[samples.size() * 99 / 100];
+
+        std::ostringstream extra;
+        extra << "p99=" << p99 << "ns open=" << std::fixed << std::setprecision(2) << open_ms
+              << "ms first_open=" << std::setprecision(1) << migrate_ms << "ms";
+        state.report("mapped_store_by_user_count", "users=" + std::to_string(user_count),
+                     iterations, elapsed, extra.str());
+    }
+}
@@ -0,0 +1,79 @@
+#include "bench.h"
+#include "metrics.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    // 렌더링 결과에서 한 줄의 값 (없으면 0)
+    uint64_t sampleValue(const std::string& text, const std::string& series) {
+        size_t pos = text.find("\n" + series + " ");
+        if (pos == std::string::npos) return 0;
+        return std::stoull(text.substr(pos + series.size() + 2));
+    }
+}
+
+// /metrics 수집 비용
+// - 응답 전(라우팅 전 훅)에는 시작 시각만 읽고, 기록은 응답을 보낸 뒤(로거 훅)에 함
+// - 기록(카운터 + 히스토그램)은 50ns 미만이어야 함 (시각 읽기 비용은 따로 보고)
+// - 여러 스레드(끝난 스레드 포함)의 기록이 합계에 모두 반영되는지 검사
+MFA_BENCHMARK(metrics_overhead) {
+    uint64_t iterations = 0;
+    double elapsed = bench::measure([&](uint64_t) {
+        bench::doNotOptimize(Metrics::nowNs());
+    }, iterations, state.options.min_seconds);
+    state.report("metrics_overhead", "clock read", iterations, elapsed);
+
+    elapsed = bench::measure([&](uint64_t i) {
+        Metrics::recordRequest(Metrics::Route::Authenticate, (i & 7) ? 200 : 401, 20000 + (i & 0xFFFFF));
+    }, iterations, state.options.min_seconds);
+    double record_ns = elapsed / static_cast<double>(iterations);
+    state.report("metrics_overhead", "record request", iterations, elapsed);
+    if (record_ns >= 50.0) {
+        state.fail("metrics_overhead", "request recording costs " + std::to_string(record_ns) + " ns (>= 50 ns)");
+    }
+
+    elapsed = bench::measure([&](uint64_t) {
+        Metrics::StoreTimer timer(Metrics::StoreOp::Lookup, Metrics::sampleLookup());
+    }, iterations, state.options.min_seconds);
+    state.report("metrics_overhead", "store lookup (sampled)", iterations, elapsed);
+
+    elapsed = bench::measure([&](uint64_t) {
+        Metrics::addHMAC(3);
+    }, iterations, state.options.min_seconds);
+    state.report("metrics_overhead", "hmac counter", iterations, elapsed);
+
+    // 다른 스레드(이미 끝난 스레드)의 기록도 합계에 남는지
+    std::string before;
+    Metrics::render(before);
+    const size_t threads = 8;
+    const uint64_t per_thread = 100000;
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; t++) {
+        workers.emplace_back([] {
+            for (uint64_t i = 0; i < per_thread; i++) {
+                Metrics::recordRequest(Metrics::Route::Delete, 200, 1000 + i);
+                Metrics::addRateLimited();
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    std::string after;
+    uint64_t render_start = bench::nowNs();
+    Metrics::render(after);
+    uint64_t render_ns = bench::nowNs() - render_start;
+    state.report("metrics_overhead", "render", 1, static_cast<double>(render_ns), "bytes=" + std::to_string(after.size()));
+
+    const std::string deletes = "mfa_http_requests_total{route=\"delete\",code=\"200\"}";
+    const std::string delete_count = "mfa_http_request_duration_seconds_count{route=\"delete\"}";
+    const std::string limited = "mfa_rate_limit_rejections_total";
+    uint64_t expected = threads * per_thread;
+    if (sampleValue(after, deletes) - sampleValue(before, deletes) != expected ||
+        sampleValue(after, delete_count) - sampleValue(before, delete_count) != expected ||
+        sampleValue(after, limited) - sampleValue(before, limited) != expected) {
+        state.fail("metrics_overhead", "records from exited threads missing: " +
+                                           std::to_string(sampleValue(after, deletes)) + " delete requests");
+    }
+}
@@ -0,0 +1,88 @@
+#include "bench.h"
+#include "qr_code.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+    // 등록 응답과 같은 형태의 OTP URI (시크릿 32자)
+    std::string sampleURI(size_t i) {
+        std::string secret = "NQDYP5LF4GHYTOLH4OQ5S4D53FBQ" + std::to_string(1000 + i % 9000);
+        return "otpauth://totp/My_Awesome_Project:" + bench::fixtureUserId(i) + "?secret=" + secret +
+               "&issuer=My_Awesome_Project&algorithm=SHA1&digits=6&period=30";
+    }
+
+    bool validImage(QRCode::Format format, const std::string& image) {
+        if (format == QRCode::Format::PNG) {
+            static const char SIGNATURE[8] = {'\x89', 'P', 'N', 'G', '\r', '\n', '\x1A', '\n'};
+            return image.size() > 8 && memcmp(image.data(), SIGNATURE, 8) == 0 &&
+                   image.compare(image.size() - 8, 4, "IEND") == 0;
+        }
+        return image.compare(0, 4, "<svg") == 0 && image.size() > 6 &&
+               image.compare(image.size() - 6, 6, "</svg>") == 0;
+    }
+}
+
+// QR 코드 렌더링 처리량 (renders/sec = 1e9 / ns/op)과 인코딩된 이미지 크기, 캐시 적중 비용
+MFA_BENCHMARK(qr_render) {
+    const std::pair<QRCode::Format, const char*> formats[] = {
+        {QRCode::Format::PNG, "png"},
+        {QRCode::Format::SVG, "svg"},
+    };
+
+    for (const auto& format : formats) {
+        for (int scale : {QRCode::DEFAULT_SCALE, 8}) {
+            std::string image;
+            size_t total_bytes = 0;
+            bool ok = true;
+            uint64_t iterations = 0;
+            double elapsed = bench::measure([&](uint64_t i) {
+                ok &= QRCode::render(sampleURI(i), format.first, scale, image);
+                total_bytes += image.size();
+            }, iterations, state.options.min_seconds);
+
+            std::string param = std::string(format.second) + " scale=" + std::to_string(scale);
+            if (!ok || !validImage(format.first, image)) {
+                state.fail("qr_render", param + ": invalid image");
+            }
+            state.report("qr_render", param, iterations, elapsed,
+                         "renders/sec=" + std::to_string(static_cast<uint64_t>(iterations * 1e9 / elapsed)) +
+                             " bytes=" + std::to_string(total_bytes / iterations));
+        }
+    }
+
+    // 캐시 적중: 같은 사용자의 이미지를 반복 요청 (잠금 + LRU 갱신만)
+    {
+        QRCode::RenderCache cache(8 * 1024 * 1024);
+        std::vector<std::string> uris;
+        for (size_t i = 0; i < 256; i++) uris.push_back(sampleURI(i));
+        for (const auto& uri : uris) cache.get(uri, QRCode::Format::PNG, QRCode::DEFAULT_SCALE);
+
+        uint64_t iterations = 0;
+        double elapsed = bench::measure([&](uint64_t i) {
+            bench::doNotOptimize(cache.get(uris[i & 255], QRCode::Format::PNG, QRCode::DEFAULT_SCALE));
+        }, iterations, state.options.min_seconds);
+        state.report("qr_render", "png cached entries=256", iterations, elapsed,
+                     "hits=" + std::to_string(cache.hits()) + " misses=" + std::to_string(cache.misses()));
+        if (cache.misses() != uris.size()) {
+            state.fail("qr_render", "cached images rendered again: misses=" + std::to_string(cache.misses()));
+        }
+    }
+
+    // 용량 한도: 한도보다 훨씬 많이 넣어도 캐시 크기는 한도 이하
+    {
+        const size_t capacity = 256 * 1024;
+        QRCode::RenderCache cache(capacity);
+        for (size_t i = 0; i < 2000; i++) {
+            if (!cache.get(sampleURI(i), QRCode::Format::SVG, QRCode::DEFAULT_SCALE)) {
+                state.fail("qr_render", "render failed while filling cache");
+                break;
+            }
+        }
+        if (cache.bytes() > capacity || cache.entries() == 0) {
+            state.fail("qr_render", "cache size " + std::to_string(cache.bytes()) + " bytes for capacity " +
+                                        std::to_string(capacity));
+        }
+    }
+}
@@ -0,0 +1,164 @@
+#include "bench.h"
+#include "mfa_core.h"
+#include "rate_limiter.h"
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 인증 요청당 시도 제한 검사 비용 (ns/check)
+MFA_BENCHMARK(rate_limit_check) {
+    // 허용 경로: 서로 다른 사용자/IP 다수 (한도는 넉넉하게)
+    {
+        RateLimiter limiter(RateLimit{60000, 60}, RateLimit{60000, 60});
+        std::vector<std::string> users(65536);
+        std::vector<std::string> ips(1024);
+        for (size_t i = 0; i < users.size(); i++) users[i] = bench::fixtureUserId(i);
+        for (size_t i = 0; i < ips.size(); i++) ips[i] = "10.0." + std::to_string(i / 256) + "." + std::to_string(i % 256);
+
+        uint64_t allowed = 0;
+        uint64_t iterations = 0;
+        double elapsed = bench::measure([&](uint64_t i) {
+            uint32_t retry_after = 0;
+            allowed += limiter.allow(users[(i * 40503) & 65535], ips[i & 1023], retry_after);
+        }, iterations, state.options.min_seconds);
+        state.report("rate_limit_check", "allowed keys=65536", iterations, elapsed,
+                     "occupancy=" + std::to_string(limiter.userTable()->occupancy()));
+        bench::doNotOptimize(allowed);
+    }
+
+    // 캐시에 있는 키 하나 (검사 자체의 비용)
+    {
+        RateLimiter limiter(RateLimit{RATE_LIMIT_MAX_BURST, 1}, RateLimit{RATE_LIMIT_MAX_BURST, 1});
+        const std::string user = "alice@example.com";
+        const std::string ip = "10.0.0.1";
+        uint64_t iterations = 0;
+        double elapsed = bench::measure([&](uint64_t) {
+            uint32_t retry_after = 0;
+            bench::doNotOptimize(limiter.allow(user, ip, retry_after));
+        }, iterations, state.options.min_seconds);
+        state.report("rate_limit_check", "hot key", iterations, elapsed);
+    }
+
+    // 거부 경로: 한 사용자에 대한 반복 시도
+    {
+        RateLimiter limiter(RateLimit{10, 60}, RateLimit());
+        uint64_t iterations = 0;
+        double elapsed = bench::measure([&](uint64_t) {
+            uint32_t retry_after = 0;
+            bench::doNotOptimize(limiter.allow("victim@example.com", "", retry_after));
+        }, iterations, state.options.min_seconds);
+        state.report("rate_limit_check", "rejected", iterations, elapsed);
+    }
+
+    // 여러 스레드가 같은 테이블을 사용 (잠금 없음)
+    for (int threads : {2, 8}) {
+        RateLimiter limiter(RateLimit{60000, 60}, RateLimit{60000, 60});
+        const uint64_t per_thread = 200000;
+        uint64_t start = bench::nowNs();
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&, t] {
+                std::string user = "user_";
+                std::string ip = "192.168.0." + std::to_string(t);
+                for (uint64_t i = 0; i < per_thread; i++) {
+                    user.resize(5);
+                    user += std::to_string((i * 7919 + static_cast<uint64_t>(t)) & 16383);
+                    uint32_t retry_after = 0;
+                    bench::doNotOptimize(limiter.allow(user, ip, retry_after));
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        state.report("rate_limit_check", "threads=" + std::to_string(threads), per_thread * threads,
+                     static_cast<double>(bench::nowNs() - start));
+    }
+
+    // 동작 검사: 버스트만큼 허용 후 거부, Retry-After는 주기 이내, 가득 찬 버킷은 만료 후 재사용
+    {
+        TokenBucketTable table(RateLimit{5, 10}, 4096);
+        const uint64_t base = RateLimiter::nowMs();
+        uint64_t retry_ms = 0;
+        int allowed = 0;
+        for (int i = 0; i < 8; i++) allowed += table.consume(42, 1, base, retry_ms);
+        if (allowed != 5) {
+            state.fail("rate_limit_check", "burst of 5 allowed " + std::to_string(allowed) + " attempts");
+        }
+        if (retry_ms == 0 || retry_ms > 2000) {
+            state.fail("rate_limit_check", "retry-after " + std::to_string(retry_ms) + "ms for 1 token at 0.5/s");
+        }
+        if (!table.consume(42, 1, base + 2000, retry_ms) || table.consume(42, 1, base + 2000, retry_ms)) {
+            state.fail("rate_limit_check", "one token should refill after 2s");
+        }
+        if (!table.consume(42, 5, base + 2000 + 10000, retry_ms)) {
+            state.fail("rate_limit_check", "bucket should be full after one period");
+        }
+        // 시간이 흘러 바퀴가 한 바퀴 돌면 만료된 칸이 비워짐
+        for (uint64_t t = 0; t <= TokenBucketTable::WHEEL_SLOTS; t++) {
+            table.consume(7, 1, base + 100000 + t * TokenBucketTable::WHEEL_TICK_MS, retry_ms);
+        }
+        if (table.occupancy() != 1) {
+            state.fail("rate_limit_check", "expired buckets not swept: occupancy=" + std::to_string(table.occupancy()));
+        }
+    }
+}
+
+// 무차별 대입 공격 시뮬레이션: 한 사용자에게 무작위 OTP를 계속 보낼 때의 처리량
+// (제한 없음: 매 시도마다 조회 + HMAC, 제한 있음: 한도 이후 시도는 검사만으로 거부)
+MFA_BENCHMARK(rate_limit_flood) {
+    std::string path = bench::prepareUserFixture(state, "rate_limit_flood", 10000);
+    if (path.empty()) {
+        return;
+    }
+
+    std::unique_ptr<MFACore> core;
+    {
+        bench::QuietStdout quiet;
+        core = std::make_unique<MFACore>(path);
+    }
+
+    std::vector<std::string> codes(4096);
+    std::mt19937_64 rng(7);
+    for (auto& code : codes) {
+        std::string digits = std::to_string(rng() % 1000000);
+        code = std::string(6 - digits.size(), '0') + digits;
+    }
+    const std::string target = bench::fixtureUserId(1234);
+
+    for (int limited = 0; limited < 2; limited++) {
+        std::unique_ptr<RateLimiter> limiter;
+        if (limited) {
+            limiter = std::make_unique<RateLimiter>(RateLimit{10, 60}, RateLimit{600, 60});
+        }
+
+        uint64_t verified = 0;
+        uint64_t rejected = 0;
+        uint64_t iterations = 0;
+        double elapsed = 0;
+        {
+            bench::QuietStdout quiet;
+            elapsed = bench::measure([&](uint64_t i) {
+                // 공격자 IP 256개에서 분산 시도
+                char ip[16];
+                snprintf(ip, sizeof(ip), "203.0.113.%u", static_cast<unsigned>(i & 255));
+                uint32_t retry_after = 0;
+                if (limiter && !limiter->allow(target, ip, retry_after)) {
+                    rejected++;
+                    return;
+                }
+                verified++;
+                bench::doNotOptimize(core->verifyTOTP(target, codes[i & 4095]));
+            }, iterations, state.options.min_seconds);
+        }
+
+        state.report("rate_limit_flood", limited ? "limited user=10/60 ip=600/60" : "unlimited", iterations, elapsed,
+                     "hmac_checks=" + std::to_string(verified) + " rejected=" + std::to_string(rejected));
+        if (limited && verified > 10) {
+            state.fail("rate_limit_flood", "user limit 10/60 let " + std::to_string(verified) + " attempts through");
+        }
+    }
+
+    bench::QuietStdout quiet;
+    core.reset();
+}
@@ -0,0 +1,222 @@
+#include "bench.h"
+#include "mfa_core.h"
+#include "replay_table.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+    constexpr int REPLAY_THREADS = 8;
+    constexpr int REPLAY_USERS = 64;
+
+    std::string formatCode(int code) {
+        char buf[8];
+        snprintf(buf, sizeof(buf), "%06d", code);
+        return buf;
+    }
+
+    void removeStoreFiles(const std::string& path) {
+        for (const char* suffix : {"", ".tmp", ".wal", ".wal.1", ".wal.tmp", ".map", ".idx", ".idx.tmp",
+                                   ".replay", ".replay.tmp"}) {
+            ::unlink((path + suffix).c_str());
+        }
+    }
+}
+
+// 재사용 방지 검사 자체의 비용 (ns/check): 새 step 기록, 재사용 거부, 여러 스레드의 서로 다른 슬롯
+MFA_BENCHMARK(replay_check) {
+    {
+        ReplayTable table;
+        table.reserve(65536);   // 저장소를 연 직후처럼 청크를 미리 만들어 검사 경로에 할당이 없게 함
+        uint64_t iterations = 0;
+        uint64_t accepted = 0;
+        double elapsed = bench::measure([&](uint64_t i) {
+            // 슬롯 65536개를 돌며 매번 더 큰 step (통과 경로)
+            accepted += table.accept(i & 65535, 1000 + (i >> 16));
+        }, iterations, state.options.min_seconds);
+        state.report("replay_check", "accepted slots=65536", iterations, elapsed);
+        if (accepted != iterations) {
+            state.fail("replay_check", "fresh steps rejected: " + std::to_string(iterations - accepted));
+        }
+    }
+
+    {
+        ReplayTable table;
+        table.reset(7);
+        table.accept(7, 1000);
+        uint64_t iterations = 0;
+        uint64_t accepted = 0;
+        double elapsed = bench::measure([&](uint64_t) {
+            accepted += table.accept(7, 1000);
+        }, iterations, state.options.min_seconds);
+        state.report("replay_check", "replayed", iterations, elapsed);
+        if (accepted != 0) {
+            state.fail("replay_check", "replayed step accepted " + std::to_string(accepted) + " times");
+        }
+    }
+
+    {
+        // 기록할 수 없는 슬롯은 재사용 방지 없이 통과시키지 않고 거부
+        ReplayTable table;
+        bench::QuietStdout quiet;
+        if (table.accept(ReplayTable::MAX_SLOTS, 1000) || table.accept(UINT64_MAX - 1, 1000)) {
+            state.fail("replay_check", "slot beyond the replay table was accepted without protection");
+        }
+    }
+
+    for (int threads : {2, 8}) {
+        ReplayTable table;
+        table.reserve(262144);
+        const uint64_t per_thread = 500000;
+        uint64_t start = bench::nowNs();
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&, t] {
+                for (uint64_t i = 0; i < per_thread; i++) {
+                    uint64_t slot = (i * static_cast<uint64_t>(threads) + static_cast<uint64_t>(t)) & 262143;
+                    bench::doNotOptimize(table.accept(slot, 1000 + i));
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        state.report("replay_check", "threads=" + std::to_string(threads), per_thread * threads,
+                     static_cast<double>(bench::nowNs() - start));
+    }
+}
+
+// 여러 스레드가 같은 사용자의 같은 코드를 동시에 보내는 재사용 공격 검사
+// - 사용자마다 정확히 한 요청만 성공 (단일 인증과 일괄 인증 모두)
+// - 이미 쓴 코드와 이전 step의 코드는 실패, 재시작 후에도 실패
+// - 삭제된 사용자의 슬롯을 재사용한 새 사용자는 첫 코드로 성공
+MFA_BENCHMARK(replay_protection) {
+    const std::pair<StorageMode, const char*> modes[] = {
+        {StorageMode::Memory, "memory"},
+        {StorageMode::Mapped, "mapped"},
+    };
+
+    for (const auto& mode : modes) {
+        std::string path = state.options.work_dir + "/replay_" + mode.second + ".dat";
+        removeStoreFiles(path);
+
+        std::vector<std::string> failures;
+        std::vector<std::pair<std::string, std::string>> users;
+        std::unique_ptr<MFACore> core;
+        {
+            bench::QuietStdout quiet;
+            core = std::make_unique<MFACore>(path, mode.first);
+        }
+        for (int i = 0; i < REPLAY_USERS * 2; i++) {
+            User user;
+            if (!core->registerUser("replay_" + std::to_string(i), user)) {
+                failures.push_back("registration failed: " + std::to_string(i));
+            }
+            users.emplace_back(user.user_id, user.secret_base32);
+        }
+
+        // 1) 단일 인증: 사용자마다 REPLAY_THREADS개 스레드가 같은 코드를 동시에 제출
+        std::vector<std::string> codes(users.size());
+        for (size_t i = 0; i < users.size(); i++) {
+            codes[i] = formatCode(core->generateTOTPCode(users[i].second));
+        }
+
+        std::vector<std::atomic<int>> successes(REPLAY_USERS);
+        std::atomic<int> ready{0};
+        std::atomic<bool> go{false};
+        std::vector<std::thread> workers;
+        uint64_t start = bench::nowNs();
+        for (int t = 0; t < REPLAY_THREADS; t++) {
+            workers.emplace_back([&, t] {
+                ready++;
+                while (!go.load(std::memory_order_acquire)) {}
+                for (int k = 0; k < REPLAY_USERS; k++) {
+                    int u = (k + t * 7) % REPLAY_USERS;     // 스레드마다 순서를 바꿔 경합 위치를 섞음
+                    if (core->verifyTOTP(users[u].first, codes[u])) successes[u]++;
+                }
+            });
+        }
+        while (ready.load() < REPLAY_THREADS) std::this_thread::yield();
+        go.store(true, std::memory_order_release);
+        for (auto& worker : workers) worker.join();
+        uint64_t elapsed_ns = bench::nowNs() - start;
+
+        for (int u = 0; u < REPLAY_USERS; u++) {
+            if (successes[u].load() != 1) {
+                failures.push_back("concurrent verifyTOTP: " + users[u].first + " succeeded " +
+                                   std::to_string(successes[u].load()) + " times");
+            }
+        }
+
+        // 2) 일괄 인증: 같은 (사용자, 코드)를 여러 번 넣은 배치를 여러 스레드가 동시에 제출
+        std::vector<AuthItem> batch;
+        for (int copy = 0; copy < 4; copy++) {
+            for (size_t u = REPLAY_USERS; u < users.size(); u++) {
+                batch.push_back(AuthItem{users[u].first, codes[u]});
+            }
+        }
+        std::atomic<int> batch_successes{0};
+        workers.clear();
+        for (int t = 0; t < 4; t++) {
+            workers.emplace_back([&] {
+                for (const auto& result : core->verifyTOTPBatch(batch, ALLOWED_DRIFT_STEPS, 2)) {
+                    if (result.success) batch_successes++;
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        if (batch_successes.load() != REPLAY_USERS) {
+            failures.push_back("concurrent verifyTOTPBatch: " + std::to_string(batch_successes.load()) +
+                               " successes for " + std::to_string(REPLAY_USERS) + " users");
+        }
+
+        // 3) 이전 step의 코드도 거부 (마지막 통과 step 이하)
+        for (int u = 0; u < 8; u++) {
+            std::string previous = formatCode(core->generateTOTPCode(users[u].second, time(nullptr) - OTP_PERIOD));
+            if (previous != codes[u] && core->verifyTOTP(users[u].first, previous)) {
+                failures.push_back("previous step accepted after newer one: " + users[u].first);
+            }
+        }
+
+        // 4) 삭제 후 같은 슬롯을 받은 새 사용자는 이전 기록의 영향을 받지 않음
+        User fresh;
+        if (!core->deleteUser(users[0].first) || !core->registerUser("replay_fresh", fresh) ||
+            !core->verifyTOTP(fresh.user_id, formatCode(core->generateTOTPCode(fresh.secret_base32)))) {
+            failures.push_back("user reusing a deleted slot could not authenticate");
+        }
+
+        // 5) 저장 후 다시 열어도 이미 쓴 코드는 거부
+        if (!core->flushReplayState()) {
+            failures.push_back("flushReplayState failed");
+        }
+        {
+            bench::QuietStdout quiet;
+            core.reset();
+            core = std::make_unique<MFACore>(path, mode.first);
+        }
+        for (int u = 1; u < REPLAY_USERS; u++) {
+            if (core->verifyTOTP(users[u].first, codes[u])) {
+                failures.push_back("code accepted again after reopen: " + users[u].first);
+                break;
+            }
+        }
+        {
+            bench::QuietStdout quiet;
+            core.reset();
+        }
+        removeStoreFiles(path);
+
+        for (const auto& message : failures) {
+            state.fail("replay_protection", std::string(mode.second) + ": " + message);
+        }
+        state.report("replay_protection",
+                     std::string(mode.second) + " threads=" + std::to_string(REPLAY_THREADS) +
+                         " users=" + std::to_string(REPLAY_USERS),
+                     uint64_t(REPLAY_THREADS) * REPLAY_USERS, static_cast<double>(elapsed_ns),
+                     "violations=" + std::to_string(failures.size()));
+    }
+}
@@ -0,0 +1,342 @@
+#include "bench.h"
+#include "latency_histogram.h"
+#include "mfa_core.h"
+#include "replication.h"
+#include "server.h"
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace {
+
+    constexpr size_t SNAPSHOT_USERS = 20000;        // 팔로워가 처음 연결할 때 리더에 있는 사용자 수
+    constexpr size_t STREAM_USERS = 2000;           // 하나씩 등록하며 반영 지연을 재는 사용자 수
+    constexpr size_t BURST_USERS = 20000;           // 대량 등록 한 번으로 몰아 보내는 사용자 수
+    constexpr uint64_t CATCH_UP_TIMEOUT_NS = 30ull * 1000 * 1000 * 1000;
+    const std::string REPLICATION_KEY(32, 'k');     // 리더와 팔로워가 나눠 가진 복제 키
+
+    void removeStoreFiles(const std::string& path) {
+        for (const char* suffix : {"", ".tmp", ".wal", ".wal.1", ".wal.tmp", ".map", ".idx", ".idx.tmp",
+                                   ".replay", ".replay.tmp", ".replica", ".replica.tmp", ".key"}) {
+            ::unlink((path + suffix).c_str());
+        }
+    }
+
+    int freePort() {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(addr);
+        int port = 0;
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0 &&
+            getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &length) == 0) {
+            port = ntohs(addr.sin_port);
+        }
+        ::close(fd);
+        return port;
+    }
+
+    // 요청 하나를 보내고 서버가 닫을 때까지 받은 응답 전체 (실패하면 빈 문자열)
+    std::string httpExchange(int port, const std::string& request) {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        timeval timeout{5, 0};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        std::string response;
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0 &&
+            ::send(fd, request.data(), request.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(request.size())) {
+            char buffer[4096];
+            ssize_t n;
+            while ((n = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+                response.append(buffer, static_cast<size_t>(n));
+            }
+        }
+        ::close(fd);
+        return response;
+    }
+
+    // 팔로워가 리더의 현재 seq까지 반영할 때까지 대기
+    bool waitCaughtUp(const ReplicationLeader& leader, const ReplicationFollower& follower) {
+        uint64_t deadline = bench::nowNs() + CATCH_UP_TIMEOUT_NS;
+        while (bench::nowNs() < deadline) {
+            ReplicationFollower::Status status = follower.status();
+            if (status.epoch == leader.epoch() && status.applied_seq >= leader.lastSeq()) return true;
+            std::this_thread::yield();
+        }
+        return false;
+    }
+
+    std::string codeFor(MFACore& core, const std::string& secret) {
+        char code[8];
+        snprintf(code, sizeof(code), "%06d", core.generateTOTPCode(secret));
+        return code;
+    }
+
+    // 두 저장소의 (user_id, 시크릿)이 같은지
+    bool sameUsers(MFACore& a, MFACore& b) {
+        std::vector<std::pair<std::string, std::string>> left;
+        std::vector<std::pair<std::string, std::string>> right;
+        a.exportUsers([&](std::string_view id, std::string_view secret) { left.emplace_back(id, secret); });
+        b.exportUsers([&](std::string_view id, std::string_view secret) { right.emplace_back(id, secret); });
+        std::sort(left.begin(), left.end());
+        std::sort(right.begin(), right.end());
+        return left == right;
+    }
+
+    // 읽기 전용 팔로워 서버(epoll 리스너)가 쓰기를 리더로 돌려보내고 /api/replication에 상태를 내는지 확인
+    void checkFollowerServer(bench::State& state, const std::string& work_dir, int replication_port, int leader_http_port) {
+        const std::string path = work_dir + "/replication_server.dat";
+        removeStoreFiles(path);
+        int http_port = freePort();
+
+        MFAServer* server = nullptr;
+        {
+            bench::QuietStdout quiet;
+            server = new MFAServer(http_port, "", "", path, StorageMode::Memory);
+        }
+        ServerTuning tuning;
+        tuning.listener = ListenerMode::Epoll;
+        tuning.event_threads = 1;
+        tuning.follow = "127.0.0.1:" + std::to_string(replication_port);
+        tuning.replication_key_file = path + ".key";
+        std::ofstream(tuning.replication_key_file, std::ios::binary) << REPLICATION_KEY;
+        server->setTuning(tuning);
+        std::thread server_thread([server]() { server->start(); });
+
+        // 리더가 WELCOME으로 HTTP 포트를 알려 준 뒤에야 돌려보낼 주소가 생김
+        std::string status_body;
+        uint64_t deadline = bench::nowNs() + CATCH_UP_TIMEOUT_NS;
+        while (bench::nowNs() < deadline) {
+            status_body = httpExchange(http_port, "GET /api/replication HTTP/1.1\r\nHost: bench\r\nConnection: close\r\n\r\n");
+            if (status_body.find("\"connected\":true") != std::string::npos) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        if (status_body.find("\"role\":\"follower\"") == std::string::npos ||
+            status_body.find("\"connected\":true") == std::string::npos) {
+            state.fail("replication", "follower /api/replication did not report a connected follower");
+        }
+
+        const std::string body = "{\"user_id\": \"replica_write\"}";
+        std::string response = httpExchange(
+            http_port, "POST /api/register?via=replica HTTP/1.1\r\nHost: bench\r\nConnection: close\r\n"
+                       "Content-Type: application/json\r\nContent-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body);
+        std::string location = "Location: http://127.0.0.1:" + std::to_string(leader_http_port) + "/api/register?via=replica";
+        if (response.compare(0, 12, "HTTP/1.1 307") != 0 || response.find(location) == std::string::npos) {
+            state.fail("replication", "write on a follower was not redirected to the leader: " +
+                                          response.substr(0, response.find("\r\n")));
+        }
+
+        server->stop();
+        server_thread.join();
+        {
+            bench::QuietStdout quiet;
+            delete server;
+        }
+        removeStoreFiles(path);
+    }
+}
+
+// 리더-팔로워 복제 (같은 프로세스의 두 MFACore를 루프백 TCP로 연결, Memory 저장소)
+// - snapshot: 사용자가 있는 리더에 처음 연결한 팔로워가 스냅샷을 받아 따라잡는 시간
+// - stream: 리더에서 하나씩 등록하고 팔로워가 그 seq를 반영할 때까지 (등록 WAL + 팔로워 WAL 대기 포함)
+// - burst: 대량 등록 한 번을 팔로워가 모두 반영할 때까지의 처리량
+// - 내용 일치, 삭제 반영, OTP 재사용 방지 공유, 재시작한 팔로워의 이어 받기(스냅샷 없이)와
+//   팔로워 서버의 쓰기 요청 307 전달을 검사
+MFA_BENCHMARK(replication) {
+    const std::string leader_path = state.options.work_dir + "/replication_leader.dat";
+    const std::string follower_path = state.options.work_dir + "/replication_follower.dat";
+    removeStoreFiles(leader_path);
+    removeStoreFiles(follower_path);
+
+    Log::Level saved_level = Log::level();
+    std::unique_ptr<MFACore> leader_core;
+    std::unique_ptr<MFACore> follower_core;
+    {
+        bench::QuietStdout quiet;
+        leader_core = std::make_unique<MFACore>(leader_path, StorageMode::Memory);
+        follower_core = std::make_unique<MFACore>(follower_path, StorageMode::Memory);
+    }
+    Log::setLevel(Log::Level::Off);
+
+    const int leader_http_port = 18080;     // 팔로워가 돌려보낼 주소 확인용 (실제로 열지 않음)
+    ReplicationLeader::Config leader_config;
+    leader_config.key = REPLICATION_KEY;
+    auto leader = std::make_unique<ReplicationLeader>(*leader_core, leader_config);
+    leader->setHTTPPort(leader_http_port);
+    if (!leader->listen("127.0.0.1", 0) || !leader->start()) {
+        Log::setLevel(saved_level);
+        state.fail("replication", "leader did not start listening");
+        return;
+    }
+
+    std::vector<ImportItem> items(SNAPSHOT_USERS);
+    for (size_t i = 0; i < items.size(); i++) {
+        items[i].user_id = "snapshot_" + std::to_string(i);
+    }
+    leader_core->importUsers(items);
+
+    ReplicationFollower::Config follower_config;
+    follower_config.leader_host = "127.0.0.1";
+    follower_config.leader_port = leader->port();
+    follower_config.position_path = follower_path + ".replica";
+    follower_config.key = REPLICATION_KEY;
+    auto follower = std::make_unique<ReplicationFollower>(*follower_core, follower_config);
+
+    uint64_t start = bench::nowNs();
+    follower->start();
+    bool caught_up = waitCaughtUp(*leader, *follower);
+    double snapshot_ns = static_cast<double>(bench::nowNs() - start);
+    Log::setLevel(saved_level);
+    if (!caught_up) {
+        state.fail("replication", "follower did not catch up after the snapshot");
+    } else {
+        state.report("replication", "snapshot users=" + std::to_string(SNAPSHOT_USERS), SNAPSHOT_USERS, snapshot_ns,
+                     "users/s=" + std::to_string(static_cast<uint64_t>(SNAPSHOT_USERS * 1e9 / snapshot_ns)));
+    }
+    Log::setLevel(Log::Level::Off);
+
+    // 하나씩: 등록이 돌아온 뒤부터가 아니라 등록 호출 직전부터 팔로워 반영까지
+    LatencyHistogram lag;
+    start = bench::nowNs();
+    for (size_t i = 0; i < STREAM_USERS && caught_up; i++) {
+        uint64_t sent = bench::nowNs();
+        User user;
+        if (!leader_core->registerUser("stream_" + std::to_string(i), user)) {
+            state.fail("replication", "leader registration failed");
+            break;
+        }
+        caught_up = waitCaughtUp(*leader, *follower);
+        lag.record(bench::nowNs() - sent);
+    }
+    double stream_ns = static_cast<double>(bench::nowNs() - start);
+    Log::setLevel(saved_level);
+    if (!caught_up) {
+        state.fail("replication", "follower fell behind while streaming registrations");
+    } else {
+        state.report("replication", "stream register", STREAM_USERS, stream_ns,
+                     "lag_p50=" + std::to_string(lag.percentile(50.0) / 1000) +
+                         "us p99=" + std::to_string(lag.percentile(99.0) / 1000) + "us");
+    }
+    Log::setLevel(Log::Level::Off);
+
+    items.assign(BURST_USERS, ImportItem{});
+    for (size_t i = 0; i < items.size(); i++) {
+        items[i].user_id = "burst_" + std::to_string(i);
+    }
+    start = bench::nowNs();
+    leader_core->importUsers(items);
+    caught_up = caught_up && waitCaughtUp(*leader, *follower);
+    double burst_ns = static_cast<double>(bench::nowNs() - start);
+    Log::setLevel(saved_level);
+    if (!caught_up) {
+        state.fail("replication", "follower did not catch up after a bulk import");
+    } else {
+        state.report("replication", "burst import users=" + std::to_string(BURST_USERS), BURST_USERS, burst_ns,
+                     "records/s=" + std::to_string(static_cast<uint64_t>(BURST_USERS * 1e9 / burst_ns)));
+    }
+    Log::setLevel(Log::Level::Off);
+
+    if (caught_up) {
+        // 삭제 반영과 내용 일치
+        leader_core->deleteUser("stream_0");
+        if (!waitCaughtUp(*leader, *follower) || !sameUsers(*leader_core, *follower_core)) {
+            state.fail("replication", "follower store differs from the leader");
+        }
+
+        // 팔로워에서 통과한 코드는 리더에서 다시 쓸 수 없어야 함 (리더를 거쳐 다른 팔로워에게도 감)
+        User user;
+        leader_core->findUser("stream_1", user);
+        std::string code = codeFor(*leader_core, user.secret_base32);
+        if (!follower_core->verifyTOTP("stream_1", code)) {
+            state.fail("replication", "replicated user could not authenticate on the follower");
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            if (leader_core->verifyTOTP("stream_1", code)) {
+                state.fail("replication", "code accepted on the follower was accepted again on the leader");
+            }
+        }
+
+        // 지금 윈도우 밖의 step은 받아들이지 않음 (먼 미래 step이면 그 사용자가 잠김)
+        uint64_t now_step = static_cast<uint64_t>(time(nullptr)) / OTP_PERIOD;
+        if (leader_core->acceptReplicated("stream_2", UINT64_MAX) ||
+            leader_core->acceptReplicated("stream_2", now_step + ALLOWED_DRIFT_STEPS + 1)) {
+            state.fail("replication", "replicated accept outside the verification window was recorded");
+        }
+
+        // 복제 키가 다른 팔로워는 WELCOME도 스냅샷도 받지 못함
+        const std::string intruder_path = state.options.work_dir + "/replication_intruder.dat";
+        removeStoreFiles(intruder_path);
+        std::unique_ptr<MFACore> intruder_core;
+        {
+            bench::QuietStdout quiet;
+            intruder_core = std::make_unique<MFACore>(intruder_path, StorageMode::Memory);
+        }
+        ReplicationFollower::Config intruder_config = follower_config;
+        intruder_config.position_path.clear();
+        intruder_config.key.assign(REPLICATION_KEY.size(), 'x');
+        auto intruder = std::make_unique<ReplicationFollower>(*intruder_core, intruder_config);
+        intruder->start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        size_t intruder_users = 0;
+        intruder_core->exportUsers([&](std::string_view, std::string_view) { intruder_users++; });
+        if (intruder->status().connected || intruder_users != 0) {
+            state.fail("replication", "follower with a different replication key was served");
+        }
+        intruder->stop();
+        intruder.reset();
+        {
+            bench::QuietStdout quiet;
+            intruder_core->setAcceptListener(nullptr);
+            intruder_core.reset();
+        }
+        removeStoreFiles(intruder_path);
+
+        // 팔로워를 멈춘 동안의 변경은 다시 연결하면 로그에서 이어 받음 (스냅샷 없음)
+        follower->stop();
+        follower.reset();
+        follower_core->setAcceptListener(nullptr);
+        for (size_t i = 0; i < 100; i++) {
+            User added;
+            leader_core->registerUser("offline_" + std::to_string(i), added);
+        }
+        follower = std::make_unique<ReplicationFollower>(*follower_core, follower_config);
+        follower->start();
+        if (!waitCaughtUp(*leader, *follower) || !sameUsers(*leader_core, *follower_core)) {
+            state.fail("replication", "restarted follower did not catch up");
+        } else if (follower->status().resyncs != 0) {
+            state.fail("replication", "restarted follower took a snapshot instead of resuming from its position");
+        }
+
+        checkFollowerServer(state, state.options.work_dir, leader->port(), leader_http_port);
+    }
+
+    follower->stop();
+    leader->stop();
+    follower.reset();
+    {
+        bench::QuietStdout quiet;
+        leader_core->setMutationListener(nullptr);
+        leader_core->setAcceptListener(nullptr);
+        follower_core->setAcceptListener(nullptr);
+        leader.reset();
+        leader_core.reset();
+        follower_core.reset();
+    }
+    Log::setLevel(saved_level);
+    removeStoreFiles(leader_path);
+    removeStoreFiles(follower_path);
+}
@@ -0,0 +1,251 @@
+#include "bench.h"
+#include "alloc_counter.h"
+#include "json_reader.h"
+#include "json_writer.h"
+#include <map>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+    // httplib::Response의 헤더/본문 저장 방식을 흉내 낸 응답 (multimap 헤더 + 소유 본문)
+    struct FakeResponse {
+        int status = -1;
+        std::multimap<std::string, std::string> headers;
+        std::string body;
+
+        void set_header(const std::string& key, const std::string& value) {
+            headers.emplace(key, value);
+        }
+        void set_content(const std::string& content, const std::string& type) {
+            body = content;
+            set_header("Content-Type", type);
+        }
+        void set_content(const char* data, size_t size, const std::string& type) {
+            body.assign(data, size);
+            set_header("Content-Type", type);
+        }
+    };
+
+    // ---- 이전 경로: find/substr 추출 + ostringstream + 응답마다 CORS 헤더 4개 ----
+
+    std::string legacyExtract(const std::string& body, const char* key) {
+        size_t start = body.find(key);
+        if (start == std::string::npos) return "";
+        start = body.find(":", start);
+        if (start == std::string::npos) return "";
+        start = body.find("\"", start) + 1;
+        size_t end = body.find("\"", start);
+        if (end == std::string::npos) return "";
+        return body.substr(start, end - start);
+    }
+
+    void legacySend(FakeResponse& res, int status, const std::string& json) {
+        res.set_header("Access-Control-Allow-Origin", "*");
+        res.set_header("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
+        res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
+        res.set_header("Access-Control-Max-Age", "3600");
+        res.status = status;
+        res.set_content(json, "application/json");
+    }
+
+    void legacyRegister(const std::string& body, FakeResponse& res) {
+        std::string user_id = legacyExtract(body, "\"user_id\"");
+        std::string secret = "JBSWY3DPEHPK3PXPJBSWY3DPEHPK3PXP";
+        std::string qr_url = "/api/qr/" + user_id;
+        std::string otp_uri = "otpauth://totp/MFA%20Server:" + user_id + "?secret=" + secret + "&issuer=MFA%20Server";
+        std::ostringstream json;
+        json << "{"
+             << "\"success\": true,"
+             << "\"user_id\": \"" << user_id << "\","
+             << "\"secret\": \"" << secret << "\","
+             << "\"qr_code_url\": \"" << qr_url << "\","
+             << "\"otp_uri\": \"" << otp_uri << "\""
+             << "}";
+        legacySend(res, 200, json.str());
+    }
+
+    void legacyAuthenticate(const std::string& body, FakeResponse& res) {
+        std::string user_id = legacyExtract(body, "\"user_id\"");
+        std::string otp_code = legacyExtract(body, "\"otp_code\"");
+        bench::doNotOptimize(user_id.size() + otp_code.size());
+        legacySend(res, 200, "{\"success\": true, \"message\": \"Authentication successful\"}");
+    }
+
+    void legacyList(const std::vector<std::string>& users, FakeResponse& res) {
+        std::ostringstream json;
+        json << "{"
+             << "\"success\": true,"
+             << "\"count\": " << users.size() << ","
+             << "\"users\": [";
+        for (size_t i = 0; i < users.size(); i++) {
+            if (i > 0) json << ",";
+            json << "\"" << users[i] << "\"";
+        }
+        json << "]}";
+        legacySend(res, 200, json.str());
+    }
+
+    void legacyError(FakeResponse& res) {
+        std::string message = "Invalid request: user_id is required";
+        std::string json = "{\"success\": false, \"error\": \"" + message + "\"}";
+        legacySend(res, 400, json);
+    }
+
+    // ---- 현재 경로: string_view 파싱 + 스레드별 Json::Writer + 정적 본문/헤더 ----
+
+    const std::string JSON_CONTENT_TYPE = "application/json";
+    const std::string CORS_ALLOW_ORIGIN = "Access-Control-Allow-Origin";
+    const std::string CORS_ANY_ORIGIN = "*";
+    constexpr std::string_view AUTH_SUCCESS_BODY = "{\"success\": true, \"message\": \"Authentication successful\"}";
+    const std::string_view USER_ID_FIELD[] = {"user_id"};
+    const std::string_view AUTH_FIELDS[] = {"user_id", "otp_code"};
+
+    void writerSend(FakeResponse& res, int status, std::string_view json) {
+        res.set_header(CORS_ALLOW_ORIGIN, CORS_ANY_ORIGIN);
+        res.status = status;
+        res.set_content(json.data(), json.size(), JSON_CONTENT_TYPE);
+    }
+
+    void writerRegister(const std::string& body, FakeResponse& res) {
+        std::string_view user_id;
+        char scratch[1024];
+        Json::parseStringFields(body, USER_ID_FIELD, &user_id, 1, scratch, sizeof(scratch));
+        // 사용자 생성/URI 생성은 서버에서도 std::string을 만든다 (응답 경로 비교를 위해 동일하게 유지)
+        std::string secret = "JBSWY3DPEHPK3PXPJBSWY3DPEHPK3PXP";
+        std::string qr_url = "/api/qr/" + std::string(user_id);
+        std::string otp_uri = "otpauth://totp/MFA%20Server:" + std::string(user_id) + "?secret=" + secret + "&issuer=MFA%20Server";
+        Json::Writer& json = Json::Writer::local();
+        json.beginObject()
+            .key("success").boolean(true)
+            .key("user_id").string(user_id)
+            .key("secret").string(secret)
+            .key("qr_code_url").string(qr_url)
+            .key("otp_uri").string(otp_uri)
+            .endObject();
+        writerSend(res, 200, json.view());
+    }
+
+    void writerAuthenticate(const std::string& body, FakeResponse& res) {
+        std::string_view fields[2];
+        char scratch[1024];
+        Json::parseStringFields(body, AUTH_FIELDS, fields, 2, scratch, sizeof(scratch));
+        bench::doNotOptimize(fields[0].size() + fields[1].size());
+        writerSend(res, 200, AUTH_SUCCESS_BODY);
+    }
+
+    void writerList(const std::vector<std::string>& users, FakeResponse& res) {
+        Json::Writer& json = Json::Writer::local();
+        json.beginObject()
+            .key("success").boolean(true)
+            .key("count").number(uint64_t(users.size()))
+            .key("users").beginArray();
+        for (const auto& user_id : users) {
+            json.string(user_id);
+        }
+        json.endArray().endObject();
+        writerSend(res, 200, json.view());
+    }
+
+    void writerError(FakeResponse& res) {
+        Json::Writer& json = Json::Writer::local();
+        json.beginObject()
+            .key("success").boolean(false)
+            .key("error").string("Invalid request: ", "user_id is required", {})
+            .endObject();
+        writerSend(res, 400, json.view());
+    }
+}
+
+// 응답 생성 경로의 요청당 힙 할당 수와 ns/request (httplib 응답 객체 생성/파괴 포함)
+MFA_BENCHMARK(response_path) {
+    const std::string register_body = "{\"user_id\": \"alice@example.com\"}";
+    const std::string auth_body = "{\"user_id\": \"alice@example.com\", \"otp_code\": \"123456\"}";
+    std::vector<std::string> users;
+    for (size_t i = 0; i < 100; i++) {
+        users.push_back("user_" + std::to_string(i) + "@example.com");
+    }
+
+    struct Case {
+        const char* name;
+        void (*legacy)(const std::string&, const std::vector<std::string>&, FakeResponse&);
+        void (*writer)(const std::string&, const std::vector<std::string>&, FakeResponse&);
+        const std::string* body;
+    };
+    const Case cases[] = {
+        {"register",
+         [](const std::string& b, const std::vector<std::string>&, FakeResponse& r) { legacyRegister(b, r); },
+         [](const std::string& b, const std::vector<std::string>&, FakeResponse& r) { writerRegister(b, r); },
+         &register_body},
+        {"authenticate",
+         [](const std::string& b, const std::vector<std::string>&, FakeResponse& r) { legacyAuthenticate(b, r); },
+         [](const std::string& b, const std::vector<std::string>&, FakeResponse& r) { writerAuthenticate(b, r); },
+         &auth_body},
+        {"list_users=100",
+         [](const std::string&, const std::vector<std::string>& u, FakeResponse& r) { legacyList(u, r); },
+         [](const std::string&, const std::vector<std::string>& u, FakeResponse& r) { writerList(u, r); },
+         &register_body},
+        {"error",
+         [](const std::string&, const std::vector<std::string>&, FakeResponse& r) { legacyError(r); },
+         [](const std::string&, const std::vector<std::string>&, FakeResponse& r) { writerError(r); },
+         &register_body},
+    };
+
+    for (const Case& c : cases) {
+        for (int variant = 0; variant < 2; variant++) {
+            auto handler = variant == 0 ? c.legacy : c.writer;
+            const char* label = variant == 0 ? "legacy " : "writer ";
+
+            // 워밍업 한 번 (스레드 버퍼 최초 확보는 요청 비용에서 제외)
+            {
+                FakeResponse res;
+                handler(*c.body, users, res);
+            }
+
+            const uint64_t sample = 1000;
+            bench::AllocScope scope;
+            for (uint64_t i = 0; i < sample; i++) {
+                FakeResponse res;
+                handler(*c.body, users, res);
+                bench::doNotOptimize(res.body.size());
+            }
+            double allocs = static_cast<double>(scope.count()) / sample;
+            double bytes = static_cast<double>(scope.bytes()) / sample;
+
+            uint64_t iterations = 0;
+            double elapsed = bench::measure([&](uint64_t) {
+                FakeResponse res;
+                handler(*c.body, users, res);
+                bench::doNotOptimize(res.body.size());
+            }, iterations, state.options.min_seconds);
+
+            char extra[96];
+            snprintf(extra, sizeof(extra), "allocs/req=%.1f bytes/req=%.0f", allocs, bytes);
+            state.report("response_path", std::string(label) + c.name, iterations, elapsed, extra);
+        }
+    }
+
+    // 같은 요청에 대해 두 경로의 본문이 같은 JSON 값인지 확인 (공백 차이만 허용)
+    auto strip = [](const std::string& s) {
+        std::string out;
+        bool in_string = false;
+        for (size_t i = 0; i < s.size(); i++) {
+            char ch = s[i];
+            if (ch == '"' && (i == 0 || s[i - 1] != '\\')) in_string = !in_string;
+            if (!in_string && ch == ' ') continue;
+            out += ch;
+        }
+        return out;
+    };
+    for (const Case& c : cases) {
+        FakeResponse a;
+        FakeResponse b;
+        c.legacy(*c.body, users, a);
+        c.writer(*c.body, users, b);
+        if (strip(a.body) != strip(b.body) || a.status != b.status) {
+            state.fail("response_path", std::string(c.name) + ": body mismatch: " + a.body + " vs " + b.body);
+        }
+    }
+}
@@ -0,0 +1,298 @@
+#include "bench.h"
+#include "event_server.h"
+#include "latency_histogram.h"
+#include "metrics.h"
+#include "tls_config.h"
+#include <fstream>
+#include <optional>
+#include <string>
+#include <thread>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <openssl/rand.h>
+#include <openssl/ssl.h>
+
+namespace {
+
+    const char REQUEST[] = "GET /health HTTP/1.1\r\nHost: bench\r\nConnection: close\r\n\r\n";
+
+    /**
+     * @brief 테스트용 EventServer (자체 스레드에서 실행, 리액터 1개)
+     */
+    class TestServer {
+    public:
+        TestServer(const std::string& cert_path, const std::string& key_path,
+                   const std::optional<TLS::Settings>& tls)
+            : server(makeConfig(cert_path, key_path, tls), [](httplib::Request& req, httplib::Response& res) {
+                  (void)req; // unused parameter warning 방지
+                  res.status = 200;
+                  res.set_content("ok", "text/plain");
+              }) {
+            ok = server.bind("127.0.0.1", 0);
+            if (ok) thread = std::thread([this]() { server.run(); });
+        }
+
+        ~TestServer() {
+            server.stop();
+            if (thread.joinable()) thread.join();
+        }
+
+        bool ok = false;
+        int port() const { return server.boundPort(); }
+
+    private:
+        EventServer server;
+        std::thread thread;
+
+        static EventServer::Config makeConfig(const std::string& cert_path, const std::string& key_path,
+                                              const std::optional<TLS::Settings>& tls) {
+            EventServer::Config config;
+            config.threads = 1;
+            config.listen_backlog = 1024;
+            config.tcp_nodelay = true;
+            config.cert_path = cert_path;
+            config.key_path = key_path;
+            config.tls = tls;
+            return config;
+        }
+    };
+
+    /**
+     * @brief 연결 하나: TCP 연결 + 핸드셰이크(지연 측정) + 요청 하나 + 서버가 닫을 때까지 읽기
+     *
+     * TLS 1.3 티켓은 핸드셰이크 뒤에 오므로 응답까지 읽은 다음 세션을 꺼냅니다.
+     * @param session 재개할 세션 (없으면 전체 핸드셰이크)
+     * @param next 다음 연결에 쓸 세션 (호출자가 SSL_SESSION_free)
+     */
+    bool connectOnce(SSL_CTX* ctx, int port, SSL_SESSION* session, SSL_SESSION*& next, uint64_t& handshake_ns,
+                     bool& reused) {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        int yes = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            ::close(fd);
+            return false;
+        }
+
+        SSL* ssl = SSL_new(ctx);
+        SSL_set_fd(ssl, fd);
+        if (session) SSL_set_session(ssl, session);
+        uint64_t start = bench::nowNs();
+        bool ok = SSL_connect(ssl) == 1;
+        handshake_ns = bench::nowNs() - start;
+
+        ok = ok && SSL_write(ssl, REQUEST, sizeof(REQUEST) - 1) == static_cast<int>(sizeof(REQUEST) - 1);
+        std::string response;
+        char buffer[1024];
+        int n;
+        while (ok && (n = SSL_read(ssl, buffer, sizeof(buffer))) > 0) response.append(buffer, static_cast<size_t>(n));
+        ok = ok && response.compare(0, 15, "HTTP/1.1 200 OK") == 0;
+        // close_notify 없이 해제하면 OpenSSL이 세션을 재개 불가로 표시함
+        if (ok) SSL_shutdown(ssl);
+
+        reused = SSL_session_reused(ssl) == 1;
+        next = ok ? SSL_get1_session(ssl) : nullptr;
+        SSL_free(ssl);
+        ::close(fd);
+        return ok;
+    }
+
+    struct RunResult {
+        uint64_t connections = 0;
+        uint64_t reused = 0;
+        double elapsed_ns = 0;
+        LatencyHistogram handshake;
+    };
+
+    // 최소 시간 동안 연결을 반복 (resume이면 직전 연결의 세션으로 재개)
+    bool runConnections(SSL_CTX* ctx, int port, bool resume, double min_seconds, RunResult& result) {
+        SSL_SESSION* session = nullptr;
+        uint64_t start = bench::nowNs();
+        bool ok = true;
+        do {
+            SSL_SESSION* next = nullptr;
+            uint64_t handshake_ns = 0;
+            bool reused = false;
+            ok = connectOnce(ctx, port, resume ? session : nullptr, next, handshake_ns, reused);
+            if (session) SSL_SESSION_free(session);
+            session = next;
+            if (!ok) break;
+            result.connections++;
+            if (reused) result.reused++;
+            result.handshake.record(handshake_ns);
+        } while (static_cast<double>(bench::nowNs() - start) < min_seconds * 1e9);
+        result.elapsed_ns = static_cast<double>(bench::nowNs() - start);
+        if (session) SSL_SESSION_free(session);
+        return ok;
+    }
+
+    SSL_CTX* clientContext(int version) {
+        SSL_CTX* ctx = SSL_CTX_new(TLS_client_method());
+        SSL_CTX_set_min_proto_version(ctx, version);
+        SSL_CTX_set_max_proto_version(ctx, version);
+        SSL_CTX_set_verify(ctx, SSL_VERIFY_NONE, nullptr);
+        return ctx;
+    }
+
+    // 렌더링한 지표에서 한 줄의 값 (없으면 0)
+    uint64_t metricValue(const std::string& series) {
+        std::string text;
+        Metrics::render(text);
+        size_t pos = text.find("\n" + series + " ");
+        return pos == std::string::npos ? 0 : std::stoull(text.substr(pos + series.size() + 2));
+    }
+}
+
+// TLS 핸드셰이크 처리량과 지연 (epoll 리스너, 로컬 자체 서명 인증서, 리액터 1개, 클라이언트 1개)
+// - 서버 설정: OpenSSL 기본값 / 조정값(TLS::Settings 기본: AES-GCM 우선, X25519, 티켓 키 회전) /
+//   ECDSA P-256 인증서 / 티켓 없이 세션 캐시만
+// - TLS 1.2, 1.3 각각 전체 핸드셰이크와 직전 세션으로 재개한 핸드셰이크 비교 (handshakes/s는 요청 하나 포함)
+// - 재개 실행은 모든 연결(첫 연결 제외)이 실제로 재개되었는지, 지표의 재개 횟수가 일치하는지 검사
+// - 같은 티켓 키 파일을 쓰는 두 인스턴스끼리는 재개되고, 무작위 키끼리는 재개되지 않는지 검사
+MFA_BENCHMARK(tls_handshake) {
+    const std::string& dir = state.options.work_dir;
+    const std::string rsa_cert = dir + "/tls_rsa.crt";
+    const std::string rsa_key = dir + "/tls_rsa.key";
+    const std::string ecdsa_cert = dir + "/tls_ecdsa.crt";
+    const std::string ecdsa_key = dir + "/tls_ecdsa.key";
+    const std::string ticket_key = dir + "/tls_ticket.key";
+    if (!bench::writeSelfSignedCert(rsa_cert, rsa_key, false) ||
+        !bench::writeSelfSignedCert(ecdsa_cert, ecdsa_key, true)) {
+        state.fail("tls_handshake", "could not create self-signed certificates in " + dir);
+        return;
+    }
+    {
+        unsigned char secret[48];
+        RAND_bytes(secret, sizeof(secret));
+        std::ofstream(ticket_key, std::ios::binary).write(reinterpret_cast<const char*>(secret), sizeof(secret));
+    }
+
+    TLS::Settings tuned;
+    TLS::Settings cache_only;
+    cache_only.tickets = false;
+
+    struct Setup {
+        const char* name;
+        bool ecdsa;
+        std::optional<TLS::Settings> tls;
+    };
+    const Setup setups[] = {
+        {"openssl-default rsa2048", false, std::nullopt},
+        {"tuned rsa2048", false, tuned},
+        {"tuned ecdsa-p256", true, tuned},
+        {"tuned rsa2048 cache-only", false, cache_only},
+    };
+
+    for (const Setup& setup : setups) {
+        TestServer server(setup.ecdsa ? ecdsa_cert : rsa_cert, setup.ecdsa ? ecdsa_key : rsa_key, setup.tls);
+        if (!server.ok) {
+            state.fail("tls_handshake", std::string(setup.name) + ": server did not start");
+            continue;
+        }
+        for (int version : {TLS1_2_VERSION, TLS1_3_VERSION}) {
+            SSL_CTX* client = clientContext(version);
+            for (bool resume : {false, true}) {
+                std::string param = std::string(setup.name) + (version == TLS1_3_VERSION ? " tls1.3" : " tls1.2") +
+                                    (resume ? " resumed" : " full");
+                uint64_t resumed_before = metricValue("mfa_tls_handshakes_total{type=\"resumed\"}");
+                RunResult result;
+                if (!runConnections(client, server.port(), resume, state.options.min_seconds, result)) {
+                    state.fail("tls_handshake", param + ": connection failed");
+                    continue;
+                }
+                uint64_t resumed_counted = metricValue("mfa_tls_handshakes_total{type=\"resumed\"}") - resumed_before;
+
+                state.report("tls_handshake", param, result.connections, result.elapsed_ns,
+                             "handshakes/s=" +
+                                 std::to_string(static_cast<uint64_t>(result.connections * 1e9 / result.elapsed_ns)) +
+                                 " p50=" + std::to_string(result.handshake.percentile(50.0) / 1000) + "us p99=" +
+                                 std::to_string(result.handshake.percentile(99.0) / 1000) + "us resumed=" +
+                                 std::to_string(result.reused) + "/" + std::to_string(result.connections));
+
+                if (resume && result.reused + 1 < result.connections) {
+                    state.fail("tls_handshake", param + ": only " + std::to_string(result.reused) + " of " +
+                                                    std::to_string(result.connections) + " connections resumed");
+                }
+                if (!resume && result.reused > 0) {
+                    state.fail("tls_handshake", param + ": full handshake run resumed a session");
+                }
+                // 지표 콜백은 TLS::configure를 적용한 서버에만 있음
+                if (setup.tls && resumed_counted != result.reused) {
+                    state.fail("tls_handshake", param + ": metrics counted " + std::to_string(resumed_counted) +
+                                                    " resumed handshakes, client saw " +
+                                                    std::to_string(result.reused));
+                }
+            }
+            SSL_CTX_free(client);
+        }
+    }
+
+    // 인스턴스 간 재개: 티켓 키를 공유하면 다른 인스턴스에서 받은 티켓으로 재개됨
+    TLS::Settings shared = tuned;
+    shared.ticket_key_file = ticket_key;
+    shared.session_cache_size = 0;      // 캐시가 아니라 티켓으로 재개했는지 확인
+    TLS::Settings separate = tuned;
+    separate.session_cache_size = 0;
+    struct Pair {
+        const char* name;
+        const TLS::Settings& settings;
+        bool expect_resume;
+    };
+    const Pair pairs[] = {{"shared ticket key", shared, true}, {"random ticket keys", separate, false}};
+    for (const Pair& pair : pairs) {
+        TestServer first(rsa_cert, rsa_key, pair.settings);
+        TestServer second(rsa_cert, rsa_key, pair.settings);
+        for (int version : {TLS1_2_VERSION, TLS1_3_VERSION}) {
+            SSL_CTX* client = clientContext(version);
+            std::string param = std::string("cross-instance ") + pair.name +
+                                (version == TLS1_3_VERSION ? " tls1.3" : " tls1.2");
+            SSL_SESSION* session = nullptr;
+            SSL_SESSION* next = nullptr;
+            uint64_t first_ns = 0;
+            uint64_t second_ns = 0;
+            bool reused = false;
+            bool ok = first.ok && second.ok && connectOnce(client, first.port(), nullptr, session, first_ns, reused) &&
+                      connectOnce(client, second.port(), session, next, second_ns, reused);
+            if (session) SSL_SESSION_free(session);
+            if (next) SSL_SESSION_free(next);
+            SSL_CTX_free(client);
+
+            if (!ok) {
+                state.fail("tls_handshake", param + ": connection failed");
+                continue;
+            }
+            state.report("tls_handshake", param, 1, static_cast<double>(second_ns),
+                         std::string("resumed=") + (reused ? "yes" : "no"));
+            if (reused != pair.expect_resume) {
+                state.fail("tls_handshake", param + (reused ? ": resumed with another instance's ticket"
+                                                            : ": ticket from another instance was rejected"));
+            }
+        }
+    }
+
+    // kTLS: OpenSSL이 지원해도 커널 tls 모듈이 없으면 사용자 공간 암호화로 남음
+    if (TLS::ktlsSupported()) {
+        TLS::Settings ktls = tuned;
+        ktls.ktls = true;
+        TestServer server(rsa_cert, rsa_key, ktls);
+        SSL_CTX* client = clientContext(TLS1_2_VERSION);
+        uint64_t before = metricValue("mfa_tls_ktls_connections_total");
+        RunResult result;
+        bool ok = server.ok && runConnections(client, server.port(), true, state.options.min_seconds, result);
+        SSL_CTX_free(client);
+        if (!ok) {
+            state.fail("tls_handshake", "ktls: connection failed");
+        } else {
+            state.report("tls_handshake", "tuned rsa2048 tls1.2 resumed ktls", result.connections, result.elapsed_ns,
+                         "ktls_connections=" + std::to_string(metricValue("mfa_tls_ktls_connections_total") - before) +
+                             "/" + std::to_string(result.connections));
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#include "bench.h"
+#include "hmac_sha1.h"
+#include "mfa_core.h"
+#include <ctime>
+#include <memory>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+
+namespace {
+
+    const std::string BENCH_SECRET = "GEZDGNBVGY3TQOJQGEZDGNBVGY3TQOJQ";
+
+    // 변경 전 경로: 호출마다 Base32 디코딩 + 일회성 HMAC()
+    int legacyTOTPCode(const std::string& secret_base32, uint64_t counter) {
+        const std::string base32_chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+        std::vector<unsigned char> secret;
+        int buffer = 0, bits_left = 0;
+        for (char ch : secret_base32) {
+            if (ch == '=') break;
+            buffer = (buffer << 5) | static_cast<int>(base32_chars.find(ch));
+            bits_left += 5;
+            if (bits_left >= 8) {
+                secret.push_back(static_cast<unsigned char>(buffer >> (bits_left - 8)));
+                bits_left -= 8;
+            }
+        }
+
+        unsigned char counter_bytes[8];
+        for (int i = 7; i >= 0; i--) {
+            counter_bytes[i] = static_cast<unsigned char>(counter & 0xff);
+            counter >>= 8;
+        }
+
+        unsigned char hash[EVP_MAX_MD_SIZE];
+        unsigned int hash_len = 0;
+        HMAC(EVP_sha1(), secret.data(), secret.size(), counter_bytes, 8, hash, &hash_len);
+        return HMACSHA1::truncate(hash);
+    }
+}
+
+// TOTP 코드 생성 처리량: 변경 전 / 스레드별 EVP_MAC / 사용자별 사전 계산 상태
+MFA_BENCHMARK(totp_codes) {
+    uint64_t base_counter = static_cast<uint64_t>(time(nullptr)) / OTP_PERIOD;
+    uint64_t iterations = 0;
+    double elapsed = 0;
+
+    elapsed = bench::measure([&](uint64_t i) {
+        bench::doNotOptimize(legacyTOTPCode(BENCH_SECRET, base_counter + (i & 3)));
+    }, iterations, state.options.min_seconds);
+    state.report("totp_codes", "legacy_hmac", iterations, elapsed);
+
+    std::unique_ptr<MFACore> core;
+    {
+        bench::QuietStdout quiet;
+        core = std::make_unique<MFACore>(state.options.work_dir + "/totp_codes.dat");
+    }
+    elapsed = bench::measure([&](uint64_t i) {
+        bench::doNotOptimize(core->generateTOTPCode(BENCH_SECRET, static_cast<time_t>((base_counter + (i & 3)) * OTP_PERIOD)));
+    }, iterations, state.options.min_seconds);
+    state.report("totp_codes", "thread_evp_mac", iterations, elapsed);
+
+    const unsigned char key[] = "12345678901234567890";
+    HMACKeyState key_state;
+    HMACSHA1::precompute(key, SECRET_KEY_LENGTH, key_state);
+    elapsed = bench::measure([&](uint64_t i) {
+        bench::doNotOptimize(HMACSHA1::totpCode(key_state, base_counter + (i & 3)));
+    }, iterations, state.options.min_seconds);
+    state.report("totp_codes", "precomputed_state", iterations, elapsed);
+}
@@ -0,0 +1,107 @@
+#include "bench.h"
+#include "totp_kernel.h"
+#include <ctime>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+    // 레인 수(4/8)의 배수가 아닌 크기를 섞어 마지막 묶음의 남는 레인까지 확인
+    constexpr size_t DIFFERENTIAL_BATCH_SIZES[] = {1, 2, 3, 5, 7, 9, 13, 17, 31, 33, 1027};
+    constexpr int DIFFERENTIAL_WINDOW_COUNTS[] = {1, 2, 3, 5, 7, 9, 11, 15, 17, 31};
+
+    // 선택된 구현의 batchCodes/windowCodes를 스칼라 HMACSHA1::totpCode와 비교 (불일치 수)
+    // 레인마다 길이(1~100바이트, 블록보다 긴 키 포함)와 카운터가 다른 키를 넣어 레인/키가 섞이면 드러나게 함
+    size_t countMismatches(std::mt19937_64& rng) {
+        const size_t max_batch = DIFFERENTIAL_BATCH_SIZES[sizeof(DIFFERENTIAL_BATCH_SIZES) /
+                                                          sizeof(DIFFERENTIAL_BATCH_SIZES[0]) - 1];
+        std::vector<HMACKeyState> key_states(max_batch);
+        std::vector<const HMACKeyState*> keys(max_batch);
+        std::vector<uint64_t> counters(max_batch);
+        std::vector<int> codes(max_batch);
+        for (size_t i = 0; i < max_batch; i++) {
+            std::vector<unsigned char> key(1 + rng() % 100);
+            for (auto& b : key) b = static_cast<unsigned char>(rng());
+            HMACSHA1::precompute(key.data(), key.size(), key_states[i]);
+            keys[i] = &key_states[i];
+            counters[i] = rng() >> 16;
+        }
+
+        size_t mismatches = 0;
+        for (size_t count : DIFFERENTIAL_BATCH_SIZES) {
+            // 같은 크기도 시작 위치를 바꿔 레인에 다른 키가 들어가게 함
+            size_t offset = rng() % (max_batch - count + 1);
+            TOTPKernel::batchCodes(keys.data() + offset, counters.data() + offset, count, codes.data());
+            for (size_t i = 0; i < count; i++) {
+                if (codes[i] != HMACSHA1::totpCode(*keys[offset + i], counters[offset + i])) mismatches++;
+            }
+        }
+        for (int count : DIFFERENTIAL_WINDOW_COUNTS) {
+            for (size_t k = 0; k < 16; k++) {
+                const HMACKeyState& key = key_states[rng() % max_batch];
+                uint64_t first_counter = rng() >> 16;
+                TOTPKernel::windowCodes(key, first_counter, count, codes.data());
+                for (int j = 0; j < count; j++) {
+                    if (codes[j] != HMACSHA1::totpCode(key, first_counter + j)) mismatches++;
+                }
+            }
+        }
+        return mismatches;
+    }
+
+}
+
+// TOTP 커널 구현별 처리량: 윈도우 후보(한 사용자) / 다수 사용자 배치
+// 측정 전에 구현마다 무작위 키로 스칼라 결과와 비교해 다르면 실패로 기록
+MFA_BENCHMARK(totp_kernel) {
+    const char* implementations[] = {"scalar", "vec4", "avx2", "shani", "auto"};
+    const size_t batch_size = 1024;
+
+    std::mt19937_64 rng(7);
+    std::vector<HMACKeyState> key_states(batch_size);
+    std::vector<const HMACKeyState*> keys(batch_size);
+    std::vector<uint64_t> counters(batch_size);
+    for (size_t i = 0; i < batch_size; i++) {
+        unsigned char key[SHA1_DIGEST_LENGTH];
+        for (auto& b : key) b = static_cast<unsigned char>(rng());
+        HMACSHA1::precompute(key, sizeof(key), key_states[i]);
+        keys[i] = &key_states[i];
+        counters[i] = static_cast<uint64_t>(time(nullptr)) / 30;
+    }
+    std::vector<int> codes(batch_size);
+
+    for (const char* name : implementations) {
+        if (!TOTPKernel::selectImplementation(name)) {
+            continue;
+        }
+
+        std::mt19937_64 differential_rng(11);
+        size_t mismatches = countMismatches(differential_rng);
+        if (mismatches != 0) {
+            state.fail("totp_kernel", std::string(name) + " differs from HMACSHA1::totpCode in " +
+                                          std::to_string(mismatches) + " codes");
+        }
+
+        for (int window : {1, 3}) {
+            int count = 2 * window + 1;
+            uint64_t iterations = 0;
+            double elapsed = bench::measure([&](uint64_t i) {
+                TOTPKernel::windowCodes(key_states[i & (batch_size - 1)], counters[0] - window, count, codes.data());
+                bench::doNotOptimize(TOTPKernel::matchAny(codes.data(), count, 123456));
+            }, iterations, state.options.min_seconds);
+            state.report("totp_kernel_window", std::string(name) + " w=" + std::to_string(window),
+                         iterations, elapsed);
+        }
+
+        uint64_t iterations = 0;
+        double elapsed = bench::measure([&](uint64_t) {
+            TOTPKernel::batchCodes(keys.data(), counters.data(), batch_size, codes.data());
+            bench::doNotOptimize(codes[0]);
+        }, iterations, state.options.min_seconds);
+        state.report("totp_kernel_batch", std::string(name) + " per_code",
+                     iterations * batch_size, elapsed);
+    }
+
+    TOTPKernel::selectImplementation("auto");
+}
@@ -0,0 +1,60 @@
+#include "bench.h"
+#include "mfa_core.h"
+#include <algorithm>
+#include <iomanip>
+#include <memory>
+#include <random>
+#include <sstream>
+
+// 사용자 수에 따른 인증 지연 (인덱스 조회 + TOTP 검증)
+MFA_BENCHMARK(authenticate_by_user_count) {
+    const size_t sizes[] = {1000, 10000, 100000, 1000000, 10000000};
+
+    for (size_t user_count : sizes) {
+        if (user_count > state.options.max_users) {
+            break;
+        }
+
+        std::string path = bench::prepareUserFixture(state, "authenticate_by_user_count", user_count);
+        if (path.empty()) {
+            return;
+        }
+
+        double load_ms = 0;
+        uint64_t iterations = 0;
+        double elapsed = 0;
+        std::vector<uint64_t> samples(10000);
+        {
+            bench::QuietStdout quiet;
+
+            uint64_t load_start = bench::nowNs();
+            auto core = std::make_unique<MFACore>(path);
+            load_ms = static_cast<double>(bench::nowNs() - load_start) / 1e6;
+
+            std::mt19937_64 rng(42);
+            std::vector<std::string> ids(4096);
+            for (auto& id : ids) {
+                id = bench::fixtureUserId(rng() % user_count);
+            }
+
+            // 평균 처리량
+            elapsed = bench::measure([&](uint64_t i) {
+                bench::doNotOptimize(core->verifyTOTP(ids[i & 4095], "000000"));
+            }, iterations, state.options.min_seconds);
+
+            // 개별 요청 지연 분포
+            for (size_t i = 0; i < samples.size(); i++) {
+                uint64_t t0 = bench::nowNs();
+                bench::doNotOptimize(core->verifyTOTP(ids[i & 4095], "000000"));
+                samples[i] = bench::nowNs() - t0;
+            }
+        }
+        std::sort(samples.begin(), samples.end());
+        uint64_t p99 = samples[samples.size() * 99 / 100];
+
+        std::ostringstream extra;
+        extra << "p99=" << p99 << "ns load=" << std::fixed << std::setprecision(1) << load_ms << "ms";
+        state.report("authenticate_by_user_count", "users=" + std::to_string(user_count),
+                     iterations, elapsed, extra.str());
+    }
+}
@@ -0,0 +1,52 @@
+#include "bench.h"
+#include "mfa_core.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <unistd.h>
+
+// 동시 클라이언트 수에 따른 등록/삭제 처리량 (WAL 그룹 커밋 효과)
+MFA_BENCHMARK(wal_mutations_by_clients) {
+    const int client_counts[] = {1, 2, 4, 8, 16, 32, 64};
+
+    for (int clients : client_counts) {
+        std::string path = state.options.work_dir + "/wal_bench_" + std::to_string(clients) + ".dat";
+        ::unlink(path.c_str());
+        ::unlink((path + ".wal").c_str());
+
+        std::atomic<bool> running{true};
+        std::atomic<uint64_t> registered{0};
+        std::atomic<uint64_t> deleted{0};
+        uint64_t elapsed_ns = 0;
+
+        {
+            bench::QuietStdout quiet;
+            auto core = std::make_unique<MFACore>(path);
+
+            std::vector<std::thread> workers;
+            uint64_t start = bench::nowNs();
+            for (int t = 0; t < clients; t++) {
+                workers.emplace_back([&, t] {
+                    // 등록 후 바로 삭제해 스토어 크기를 일정하게 유지
+                    for (uint64_t i = 0; running.load(std::memory_order_relaxed); i++) {
+                        std::string user_id = "c" + std::to_string(t) + "_" + std::to_string(i);
+                        User user;
+                        if (core->registerUser(user_id, user)) registered++;
+                        if (core->deleteUser(user_id)) deleted++;
+                    }
+                });
+            }
+
+            std::this_thread::sleep_for(std::chrono::duration<double>(std::max(state.options.min_seconds, 0.5)));
+            running = false;
+            for (auto& worker : workers) worker.join();
+            elapsed_ns = bench::nowNs() - start;
+        }
+
+        ::unlink(path.c_str());
+        ::unlink((path + ".wal").c_str());
+
+        state.report("wal_mutations_by_clients", "clients=" + std::to_string(clients),
+                     registered + deleted, static_cast<double>(elapsed_ns));
+    }
+}
@@ -0,0 +1,131 @@
+#include "bench.h"
+#include "worker_pool.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace {
+
+    constexpr uint64_t BATCH_TASKS = 10000;
+
+    // 요청 하나를 처리하는 CPU 비용 흉내 (xorshift 반복)
+    uint64_t spinWork(uint64_t seed, unsigned rounds) {
+        uint64_t x = seed | 1;
+        for (unsigned i = 0; i < rounds; i++) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+        }
+        return x;
+    }
+
+    /**
+     * @brief 한 스레드가 작업을 넣고 모두 끝날 때까지의 처리량 측정
+     * @param rounds 작업 하나의 spinWork 반복 수 (0이면 빈 작업 = 큐 전달 비용)
+     * @param rejected 대기열이 가득 차 다시 넣은 횟수
+     */
+    double runBatches(WorkerPool& pool, unsigned rounds, double min_seconds, uint64_t& tasks, uint64_t& rejected) {
+        std::atomic<uint64_t> done{0};
+        std::atomic<uint64_t> sink{0};
+        tasks = 0;
+        rejected = 0;
+        uint64_t start = bench::nowNs();
+        do {
+            for (uint64_t i = 0; i < BATCH_TASKS; i++) {
+                auto task = [&done, &sink, rounds, i]() {
+                    if (rounds > 0) sink.fetch_xor(spinWork(i, rounds), std::memory_order_relaxed);
+                    done.fetch_add(1, std::memory_order_release);
+                };
+                while (!pool.submit(task)) {
+                    rejected++;
+                    std::this_thread::yield();
+                }
+            }
+            tasks += BATCH_TASKS;
+            while (done.load(std::memory_order_acquire) < tasks) std::this_thread::yield();
+        } while (static_cast<double>(bench::nowNs() - start) < min_seconds * 1e9);
+        bench::doNotOptimize(sink.load());
+        return static_cast<double>(bench::nowNs() - start);
+    }
+}
+
+// HTTP 작업 스레드 풀 (WorkerPool)
+// - 스레드 수, CPU 고정, 대기열 상한에 따른 빈 작업(전달 비용)과 짧은 CPU 작업(spin=500, 약 1.5us)의 처리량
+// - 대기열 상한: 가득 차면 submit이 바로 false이고, 받은 작업은 shutdown 전에 모두 실행되는지 검사
+MFA_BENCHMARK(worker_pool) {
+    struct Config {
+        size_t threads;
+        size_t max_queued;
+        bool pin;
+    };
+    const Config configs[] = {
+        {1, 0, false}, {4, 0, false}, {8, 0, false}, {8, 0, true}, {8, 64, false}, {32, 0, false},
+    };
+
+    for (unsigned rounds : {0u, 500u}) {
+        for (const Config& config : configs) {
+            WorkerPool pool(config.threads, config.max_queued, config.pin);
+            uint64_t tasks = 0;
+            uint64_t rejected = 0;
+            double elapsed = runBatches(pool, rounds, state.options.min_seconds, tasks, rejected);
+
+            std::string param = std::string(rounds ? "spin=500" : "empty") + " threads=" +
+                                std::to_string(config.threads);
+            if (config.max_queued) param += " max_queue=" + std::to_string(config.max_queued);
+            if (config.pin) param += " pinned";
+            state.report("worker_pool", param, tasks, elapsed,
+                         "tasks/s=" + std::to_string(static_cast<uint64_t>(tasks * 1e9 / elapsed)) +
+                             (config.max_queued ? " rejected=" + std::to_string(rejected) : ""));
+
+            if (config.pin && pool.pinnedThreads() != pool.threadCount()) {
+                state.fail("worker_pool", "pinned " + std::to_string(pool.pinnedThreads()) + " of " +
+                                              std::to_string(pool.threadCount()) + " threads");
+            }
+        }
+    }
+
+    // 대기열 상한: 스레드를 모두 막아 두고 상한까지 넣은 뒤 하나 더 넣으면 거절
+    const size_t threads = 2;
+    const size_t max_queued = 16;
+    std::mutex gate_mutex;
+    std::condition_variable gate_cv;
+    bool open = false;
+    std::atomic<size_t> started{0};
+    std::atomic<size_t> finished{0};
+    auto blocking = [&]() {
+        started.fetch_add(1);
+        std::unique_lock<std::mutex> lock(gate_mutex);
+        gate_cv.wait(lock, [&]() { return open; });
+        finished.fetch_add(1);
+    };
+    auto counting = [&]() { finished.fetch_add(1); };
+
+    bool ok = true;
+    {
+        WorkerPool pool(threads, max_queued);
+        for (size_t i = 0; i < threads; i++) ok &= pool.submit(blocking);
+        while (started.load() < threads) std::this_thread::yield();
+        for (size_t i = 0; i < max_queued; i++) ok &= pool.submit(counting);
+        if (!ok || pool.queued() != max_queued) {
+            state.fail("worker_pool", "could not fill the queue up to max_queued=" + std::to_string(max_queued));
+        }
+        if (pool.submit(counting)) {
+            state.fail("worker_pool", "task accepted beyond max_queued=" + std::to_string(max_queued));
+        }
+        {
+            std::lock_guard<std::mutex> lock(gate_mutex);
+            open = true;
+        }
+        gate_cv.notify_all();
+        pool.shutdown();
+        if (pool.submit(counting)) {
+            state.fail("worker_pool", "task accepted after shutdown");
+        }
+    }
+    if (finished.load() != threads + max_queued) {
+        state.fail("worker_pool", "shutdown dropped queued tasks: ran " + std::to_string(finished.load()) + " of " +
+                                      std::to_string(threads + max_queued));
+    }
+}
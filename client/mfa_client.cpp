@@ -0,0 +1,206 @@
+#include "mfa_client.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+    constexpr size_t READ_CHUNK = 16 * 1024;
+
+    void setNonBlocking(int fd) {
+        int flags = fcntl(fd, F_GETFL, 0);
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    }
+}
+
+MFAClient::~MFAClient() {
+    close();
+}
+
+bool MFAClient::connectTcp(const std::string& host, int port) {
+    close();
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_NUMERICSERV;
+    addrinfo* result = nullptr;
+    std::string service = std::to_string(port);
+    int status = getaddrinfo(host.c_str(), service.c_str(), &hints, &result);
+    if (status != 0) {
+        return fail("주소를 해석할 수 없습니다: " + host + ": " + gai_strerror(status));
+    }
+
+    int last_errno = 0;
+    for (addrinfo* info = result; info && fd < 0; info = info->ai_next) {
+        int candidate = socket(info->ai_family, info->ai_socktype | SOCK_CLOEXEC, info->ai_protocol);
+        if (candidate < 0) continue;
+        if (::connect(candidate, info->ai_addr, info->ai_addrlen) == 0) {
+            fd = candidate;
+        } else {
+            last_errno = errno;
+            ::close(candidate);
+        }
+    }
+    freeaddrinfo(result);
+    if (fd < 0) {
+        return fail("연결할 수 없습니다: " + host + ":" + service + ": " + strerror(last_errno));
+    }
+
+    int yes = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+    setNonBlocking(fd);
+    return true;
+}
+
+bool MFAClient::connectUnix(const std::string& path) {
+    close();
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        return fail("Unix 소켓 경로가 비었거나 너무 깁니다: " + path);
+    }
+    path.copy(addr.sun_path, path.size());
+
+    int candidate = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (candidate < 0 || ::connect(candidate, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        std::string reason = strerror(errno);
+        if (candidate >= 0) ::close(candidate);
+        return fail("연결할 수 없습니다: " + path + ": " + reason);
+    }
+    fd = candidate;
+    setNonBlocking(fd);
+    return true;
+}
+
+void MFAClient::close() {
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+    in_flight = 0;
+    out.clear();
+    out_offset = 0;
+    in.clear();
+    in_offset = 0;
+}
+
+bool MFAClient::verify(std::string_view user_id, std::string_view otp_code, Result& result) {
+    if (in_flight > 0) {
+        error = "파이프라인 요청의 응답을 모두 받기 전에는 verify()를 쓸 수 없습니다";
+        return false;
+    }
+    uint32_t request_id = 0;
+    if (!queue(user_id, otp_code, request_id) || !receive(result)) return false;
+    if (result.request_id != request_id) return fail("응답의 요청 ID가 맞지 않습니다");
+    return true;
+}
+
+bool MFAClient::queue(std::string_view user_id, std::string_view otp_code, uint32_t& request_id) {
+    if (fd < 0) {
+        error = "연결되어 있지 않습니다";
+        return false;
+    }
+    request_id = next_id++;
+    if (!BinaryProtocol::appendRequest(out, request_id, user_id, otp_code)) {
+        error = "user_id와 OTP는 각각 255바이트 이하여야 합니다";
+        return false;
+    }
+    in_flight++;
+    return true;
+}
+
+bool MFAClient::flush() {
+    while (fd >= 0 && out_offset < out.size()) {
+        ssize_t n = ::send(fd, out.data() + out_offset, out.size() - out_offset, MSG_NOSIGNAL);
+        if (n > 0) {
+            out_offset += static_cast<size_t>(n);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // 서버가 응답을 못 보내 읽기를 멈췄을 수 있으므로 기다리는 동안 응답도 받음
+            if (!waitAndTransfer(true)) return false;
+        } else {
+            return fail(std::string("요청을 보낼 수 없습니다: ") + strerror(errno));
+        }
+    }
+    if (fd < 0) return false;
+    out.clear();
+    out_offset = 0;
+    return true;
+}
+
+bool MFAClient::receive(Result& result) {
+    if (in_flight == 0) {
+        error = "기다리는 응답이 없습니다";
+        return false;
+    }
+    if (!flush()) return false;
+    for (;;) {
+        size_t consumed = 0;
+        BinaryProtocol::Reply reply;
+        BinaryProtocol::ParseResult parsed =
+            BinaryProtocol::parseReply(in.data() + in_offset, in.size() - in_offset, reply, consumed);
+        if (parsed == BinaryProtocol::ParseResult::Error) return fail("잘못된 응답 프레임");
+        if (parsed == BinaryProtocol::ParseResult::Frame) {
+            in_offset += consumed;
+            if (in_offset == in.size()) {
+                in.clear();
+                in_offset = 0;
+            }
+            in_flight--;
+            result.request_id = reply.request_id;
+            result.status = reply.status;
+            result.retry_after = reply.retry_after;
+            return true;
+        }
+        if (!readAvailable() || (in.size() - in_offset < BinaryProtocol::REPLY_FRAME_BYTES && !waitAndTransfer(false))) {
+            return false;
+        }
+    }
+}
+
+bool MFAClient::fail(const std::string& message) {
+    error = message;
+    close();
+    return false;
+}
+
+// 소켓이 준비될 때까지 기다린 뒤 읽을 수 있는 응답을 읽음 (want_write면 쓸 수 있을 때도 반환)
+bool MFAClient::waitAndTransfer(bool want_write) {
+    pollfd target{};
+    target.fd = fd;
+    target.events = static_cast<short>(POLLIN | (want_write ? POLLOUT : 0));
+    int ready;
+    do {
+        ready = ::poll(&target, 1, timeout_ms > 0 ? timeout_ms : -1);
+    } while (ready < 0 && errno == EINTR);
+    if (ready == 0) return fail("응답 대기 시간 초과");
+    if (ready < 0) return fail(std::string("poll 실패: ") + strerror(errno));
+    if (target.revents & (POLLIN | POLLHUP | POLLERR)) return readAvailable();
+    return true;
+}
+
+// 지금 읽을 수 있는 바이트를 모두 in에 추가
+bool MFAClient::readAvailable() {
+    if (in_offset > 0) {
+        in.erase(0, in_offset);
+        in_offset = 0;
+    }
+    char buffer[READ_CHUNK];
+    for (;;) {
+        ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (n > 0) {
+            in.append(buffer, static_cast<size_t>(n));
+            continue;
+        }
+        if (n == 0) return fail("서버가 연결을 닫았습니다");
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+        return fail(std::string("응답을 읽을 수 없습니다: ") + strerror(errno));
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef MFA_CLIENT_H
+#define MFA_CLIENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "binary_protocol.h"
+
+/**
+ * @brief 바이너리 검증 프로토콜 클라이언트 (mfa-server --binary-port/--binary-socket)
+ *
+ * 연결 하나를 감싸며 스레드 하나에서만 사용합니다 (여러 스레드면 스레드마다 하나씩).
+ *
+ * 동기 사용:
+ *   MFAClient client;
+ *   client.connectUnix("/run/mfa.sock");
+ *   MFAClient::Result result;
+ *   if (client.verify("alice", "123456", result) && result.status == MFAClient::Status::Ok) { ... }
+ *
+ * 파이프라이닝: queue()로 요청을 여러 개 쌓고 receive()로 같은 수만큼 응답을 받습니다.
+ * 응답은 보낸 순서대로 오며 요청 ID가 그대로 돌아옵니다. receive()는 쌓인 요청을 먼저 보내고,
+ * 보내는 동안에도 응답을 읽어 두므로 한 번에 많이 쌓아도 서로 막히지 않습니다.
+ *
+ * 오류(연결 끊김, 시간 초과, 잘못된 응답)가 나면 false를 돌려주고 연결을 닫으며, 원인은 lastError()에 남습니다.
+ */
+class MFAClient {
+public:
+    using Status = BinaryProtocol::Status;
+
+    struct Result {
+        uint32_t request_id = 0;
+        Status status = Status::ServerError;
+        uint16_t retry_after = 0;           // RateLimited일 때 다시 시도할 수 있기까지 남은 초
+    };
+
+    MFAClient() = default;
+    ~MFAClient();
+
+    MFAClient(const MFAClient&) = delete;
+    MFAClient& operator=(const MFAClient&) = delete;
+
+    bool connectTcp(const std::string& host, int port);
+    bool connectUnix(const std::string& path);
+    void close();
+    bool isConnected() const { return fd >= 0; }
+
+    /**
+     * @brief 한 번의 읽기/쓰기 대기 제한 시간 (기본값 5초, 0 이하면 무한)
+     */
+    void setTimeout(int milliseconds) { timeout_ms = milliseconds; }
+
+    /**
+     * @brief 요청 하나를 보내고 응답을 기다림 (처리 중인 파이프라인 요청이 없어야 함)
+     */
+    bool verify(std::string_view user_id, std::string_view otp_code, Result& result);
+
+    /**
+     * @brief 요청을 송신 버퍼에 추가 (flush()나 receive() 때 보냄)
+     * @param request_id 이 요청에 붙인 ID (응답과 맞춰 보는 용도)
+     * @return user_id/OTP가 255바이트를 넘거나 연결이 없으면 false
+     */
+    bool queue(std::string_view user_id, std::string_view otp_code, uint32_t& request_id);
+
+    /**
+     * @brief 송신 버퍼를 모두 보냄 (기다리는 동안 온 응답은 받아 둠)
+     */
+    bool flush();
+
+    /**
+     * @brief 다음 응답 하나를 받음 (보내지 않은 요청이 있으면 먼저 보냄)
+     */
+    bool receive(Result& result);
+
+    /**
+     * @brief 보냈거나 쌓였지만 아직 응답을 받지 않은 요청 수
+     */
+    size_t inFlight() const { return in_flight; }
+
+    const std::string& lastError() const { return error; }
+
+private:
+    int fd = -1;
+    int timeout_ms = 5000;
+    uint32_t next_id = 1;
+    size_t in_flight = 0;
+    std::string out;
+    size_t out_offset = 0;
+    std::string in;
+    size_t in_offset = 0;
+    std::string error;
+
+    bool fail(const std::string& message);
+    bool waitAndTransfer(bool want_write);
+    bool readAvailable();
+};
+
+#endif // MFA_CLIENT_H
@@ -0,0 +1,179 @@
+// Json 토크나이저 퍼징 대상
+//
+// clang: libFuzzer로 빌드 (./mfa-fuzz-json corpus/)
+// 그 외: 같은 검사를 파일 인자 또는 무작위 변형 입력으로 반복하는 드라이버
+//        (./mfa-fuzz-json [파일...] 또는 ./mfa-fuzz-json --iterations N)
+
+#include "json_reader.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+    void check(bool condition, const char* what) {
+        if (!condition) {
+            fprintf(stderr, "invariant violated: %s\n", what);
+            abort();
+        }
+    }
+
+    bool within(std::string_view part, std::string_view whole) {
+        return part.empty() ||
+               (part.data() >= whole.data() && part.data() + part.size() <= whole.data() + whole.size());
+    }
+
+    void runOne(const uint8_t* data, size_t size) {
+        // 첫 바이트로 제한값을 바꿔 가며 검사
+        unsigned depth = size > 0 ? (data[0] % 20) + 1 : 16;
+        std::string_view input(reinterpret_cast<const char*>(data), size);
+
+        Json::Limits limits;
+        limits.max_depth = depth;
+        limits.max_bytes = 4096;
+
+        // 1. 토큰 열: 진행이 멈추지 않고, 원문 view가 입력 안에 있고, 깊이 제한을 지킴
+        Json::Tokenizer tokenizer(input, limits);
+        size_t tokens = 0;
+        Json::Token token;
+        std::vector<char> buffer(size + 1);
+        do {
+            size_t before = tokenizer.offset();
+            Json::Token peeked = tokenizer.peek();
+            token = tokenizer.next();
+            check(token == peeked, "peek() and next() disagree");
+            check(tokens++ <= size + 1, "tokenizer did not make progress");
+            check(tokenizer.offset() <= size, "offset past end");
+            check(tokenizer.depth() <= depth, "depth limit exceeded");
+            check(within(tokenizer.text(), input), "token text outside input");
+
+            if (token != Json::Token::End && token != Json::Token::Error) {
+                check(tokenizer.offset() > before, "token consumed no input");
+            }
+            if (token == Json::Token::Key || token == Json::Token::String) {
+                std::string_view decoded;
+                bool ok = Json::unescape(tokenizer.text(), buffer.data(), buffer.size(), decoded);
+                if (ok) {
+                    check(decoded.size() <= tokenizer.text().size(), "decoded string longer than source");
+                }
+                if (!tokenizer.hasEscapes()) {
+                    check(ok && decoded.data() == tokenizer.text().data(), "plain string was copied");
+                }
+            }
+        } while (token != Json::Token::End && token != Json::Token::Error);
+
+        check((token == Json::Token::Error) == (tokenizer.error() != Json::Error::None), "error state mismatch");
+        check(tokenizer.next() == token, "terminal token is not sticky");
+
+        // 2. 필드 추출: 결과 view는 입력 또는 scratch 안에 있고, 성공이면 토큰 열도 End로 끝남
+        const std::string_view keys[] = {"user_id", "otp_code", "items"};
+        std::string_view values[3];
+        char scratch[64];
+        Json::Error error = Json::parseStringFields(input, keys, values, 3, scratch, sizeof(scratch), limits);
+        for (const auto& value : values) {
+            check(within(value, input) || within(value, std::string_view(scratch, sizeof(scratch))),
+                  "field view outside input and scratch");
+        }
+        if (error == Json::Error::None) {
+            check(token == Json::Token::End, "fields parsed but token stream failed");
+        }
+
+        // 3. skipValue: 최상위 값 하나를 건너뛰면 바로 End여야 함
+        Json::Tokenizer skipper(input, limits);
+        if (skipper.skipValue()) {
+            check(skipper.depth() == 0, "skipValue left container open");
+            Json::Token after = skipper.next();
+            check(after == Json::Token::End || after == Json::Token::Error, "value after top-level value");
+            check((after == Json::Token::End) == (token == Json::Token::End), "skipValue disagrees with next()");
+        }
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    runOne(data, size);
+    return 0;
+}
+
+#ifdef MFA_FUZZ_STANDALONE
+
+namespace {
+
+    const char* const SEEDS[] = {
+        "{\"user_id\": \"alice\"}",
+        "{\"user_id\": \"alice\", \"otp_code\": \"123456\"}",
+        "{\"items\": [{\"user_id\": \"a\", \"otp_code\": \"1\"}, {\"user_id\": \"b\", \"otp_code\": \"2\"}]}",
+        "{\"user_id\": \"a\\\"b\\\\c\\u00e9\\ud83d\\ude00\", \"n\": [1, -2.5e+3, true, false, null, {}]}",
+        "[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]",
+        "  {\"a\" : { \"b\" : [ 0 , 1e5 , \"\\/\" ] } }  ",
+    };
+
+    const char ALPHABET[] = "{}[]:,\"\\ u0123456789abcdefABCDEF.-+eEtrunlfsx\n\t";
+
+    uint64_t next_random(uint64_t& state) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    std::string mutate(std::string input, uint64_t& rng) {
+        int edits = static_cast<int>(next_random(rng) % 8) + 1;
+        for (int e = 0; e < edits; e++) {
+            size_t pos = input.empty() ? 0 : next_random(rng) % (input.size() + 1);
+            char c = ALPHABET[next_random(rng) % (sizeof(ALPHABET) - 1)];
+            switch (next_random(rng) % 4) {
+            case 0: input.insert(pos, 1, c); break;
+            case 1: if (pos < input.size()) input.erase(pos, 1); break;
+            case 2: if (pos < input.size()) input[pos] = c; break;
+            default: input = input.substr(0, pos); break;
+            }
+        }
+        return input;
+    }
+}
+
+int main(int argc, char** argv) {
+    long iterations = 1000000;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc) {
+            iterations = std::atol(argv[++i]);
+        } else {
+            files.push_back(arg);
+        }
+    }
+
+    // 파일이 주어지면 각 파일을 한 번씩 실행 (크래시 재현용)
+    if (!files.empty()) {
+        for (const auto& path : files) {
+            FILE* file = fopen(path.c_str(), "rb");
+            if (!file) {
+                fprintf(stderr, "cannot open %s\n", path.c_str());
+                return 1;
+            }
+            std::string data;
+            char chunk[4096];
+            size_t n;
+            while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) data.append(chunk, n);
+            fclose(file);
+            runOne(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+        }
+        printf("%zu inputs OK\n", files.size());
+        return 0;
+    }
+
+    uint64_t rng = 0x9E3779B97F4A7C15ull;
+    const size_t seed_count = sizeof(SEEDS) / sizeof(SEEDS[0]);
+    for (long i = 0; i < iterations; i++) {
+        std::string input = mutate(SEEDS[next_random(rng) % seed_count], rng);
+        runOne(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+    }
+    printf("%ld iterations OK\n", iterations);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,87 @@
+#include "latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+
+size_t LatencyHistogram::indexFor(uint64_t value) {
+    if (value < SUB_BUCKET_COUNT) {
+        return static_cast<size_t>(value);
+    }
+    // 최상위 비트 위치에 따라 shift만큼 잘라내면 sub는 [1024, 2048) 구간
+    int shift = 63 - __builtin_clzll(value) - (SIGNIFICANT_BITS - 1);
+    uint64_t sub = value >> shift;
+    return static_cast<size_t>(SUB_BUCKET_COUNT + static_cast<uint64_t>(shift - 1) * SUB_BUCKET_HALF +
+                               (sub - SUB_BUCKET_HALF));
+}
+
+uint64_t LatencyHistogram::highestEquivalent(size_t index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    uint64_t offset = index - SUB_BUCKET_COUNT;
+    int shift = static_cast<int>(offset / SUB_BUCKET_HALF) + 1;
+    uint64_t sub = SUB_BUCKET_HALF + offset % SUB_BUCKET_HALF;
+    return ((sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t value_ns) {
+    value_ns = std::min(value_ns, MAX_VALUE);
+    size_t index = indexFor(value_ns);
+    if (index >= counts.size()) {
+        counts.resize(index + 1 + SUB_BUCKET_HALF, 0);
+    }
+    counts[index]++;
+    total++;
+    sum += value_ns;
+    min_value = std::min(min_value, value_ns);
+    max_value = std::max(max_value, value_ns);
+}
+
+void LatencyHistogram::recordCorrected(uint64_t value_ns, uint64_t expected_interval_ns) {
+    record(value_ns);
+    if (expected_interval_ns == 0) {
+        return;
+    }
+    for (uint64_t missed = value_ns; missed >= 2 * expected_interval_ns;) {
+        missed -= expected_interval_ns;
+        record(missed);
+    }
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    if (other.counts.size() > counts.size()) {
+        counts.resize(other.counts.size(), 0);
+    }
+    for (size_t i = 0; i < other.counts.size(); i++) {
+        counts[i] += other.counts[i];
+    }
+    total += other.total;
+    sum += other.sum;
+    min_value = std::min(min_value, other.min_value);
+    max_value = std::max(max_value, other.max_value);
+}
+
+uint64_t LatencyHistogram::percentile(double percentile) const {
+    if (total == 0) {
+        return 0;
+    }
+    percentile = std::clamp(percentile, 0.0, 100.0);
+    uint64_t target = static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(total)));
+    target = std::max<uint64_t>(target, 1);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        seen += counts[i];
+        if (seen >= target) {
+            return std::min(highestEquivalent(i), max_value);
+        }
+    }
+    return max_value;
+}
+
+void LatencyHistogram::reset() {
+    counts.clear();
+    total = 0;
+    sum = 0;
+    min_value = UINT64_MAX;
+    max_value = 0;
+}
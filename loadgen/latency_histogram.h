@@ -0,0 +1,69 @@
+#ifndef MFA_LATENCY_HISTOGRAM_H
+#define MFA_LATENCY_HISTOGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief HDR(High Dynamic Range) 방식 지연 히스토그램 (ns 단위)
+ *
+ * 값의 최상위 11비트만 남기는 로그-선형 버킷을 써서 1ns~수십 초 범위 전체에서
+ * 상대 오차 0.1% 이하(유효 숫자 3자리)로 p99.99 같은 꼬리 백분위를 구합니다.
+ * 기록은 카운터 증가 한 번이며, 스레드마다 하나씩 두고 끝에 merge()로 합칩니다.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SIGNIFICANT_BITS = 11;                           // 2048 = 유효 숫자 3자리
+    static constexpr uint64_t SUB_BUCKET_COUNT = 1ull << SIGNIFICANT_BITS;
+    static constexpr uint64_t SUB_BUCKET_HALF = SUB_BUCKET_COUNT / 2;
+    static constexpr uint64_t MAX_VALUE = (1ull << 40) - 1;               // 약 18분 (넘으면 잘라서 기록)
+
+    /**
+     * @brief 값 하나 기록
+     * @param value_ns 지연 (ns)
+     */
+    void record(uint64_t value_ns);
+
+    /**
+     * @brief coordinated omission 보정 기록
+     *
+     * 요청이 expected_interval_ns마다 나가야 했는데 value_ns만큼 막혀 있었다면, 그동안 보내지
+     * 못한 요청들이 겪었을 지연(value - interval, value - 2*interval, ...)을 함께 기록합니다.
+     *
+     * @param value_ns 측정한 지연 (ns)
+     * @param expected_interval_ns 요청 간 예상 간격 (0이면 보정 없음)
+     */
+    void recordCorrected(uint64_t value_ns, uint64_t expected_interval_ns);
+
+    /**
+     * @brief 다른 히스토그램의 기록을 더함
+     */
+    void merge(const LatencyHistogram& other);
+
+    /**
+     * @brief 백분위 값 (해당 버킷의 최댓값, HdrHistogram과 같은 기준)
+     * @param percentile 0~100
+     * @return 지연 (ns), 기록이 없으면 0
+     */
+    uint64_t percentile(double percentile) const;
+
+    uint64_t count() const { return total; }
+    uint64_t min() const { return total ? min_value : 0; }
+    uint64_t max() const { return max_value; }
+    double mean() const { return total ? static_cast<double>(sum) / static_cast<double>(total) : 0.0; }
+
+    void reset();
+
+private:
+    std::vector<uint64_t> counts;       // 필요한 만큼만 늘림 (대부분의 지연은 앞쪽 버킷)
+    uint64_t total = 0;
+    uint64_t min_value = UINT64_MAX;
+    uint64_t max_value = 0;
+    uint64_t sum = 0;
+
+    static size_t indexFor(uint64_t value);
+    static uint64_t highestEquivalent(size_t index);
+};
+
+#endif // MFA_LATENCY_HISTOGRAM_H
@@ -0,0 +1,690 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+#include "latency_histogram.h"
+#include "json_reader.h"
+#include "logger.h"
+#include "mfa_core.h"
+#include "server.h"
+
+namespace {
+
+    enum Route : size_t {
+        ROUTE_REGISTER,
+        ROUTE_AUTHENTICATE,
+        ROUTE_LIST,
+        ROUTE_DELETE,
+        ROUTE_COUNT
+    };
+
+    const char* const ROUTE_NAMES[ROUTE_COUNT] = {"register", "authenticate", "list", "delete"};
+
+    constexpr size_t PRELOAD_CHUNK = 10000;                 // POST /api/users/bulk 요청당 사용자 수
+    constexpr int DEFAULT_LOCAL_PORT = 18080;
+    const double REPORT_PERCENTILES[] = {50.0, 90.0, 99.0, 99.9, 99.99};
+
+    struct Options {
+        std::string target;                 // 비어 있으면 같은 프로세스에 서버 시작
+        int port = DEFAULT_LOCAL_PORT;
+        std::string cert_path;
+        std::string key_path;
+        std::string data_file = "loadgen_data/users.dat";
+        StorageMode storage_mode = StorageMode::Memory;
+        size_t connections = 16;
+        double duration_seconds = 10.0;
+        double warmup_seconds = 2.0;
+        double rate = 0;                    // 0이면 closed loop, 아니면 전체 초당 요청 수 (open loop)
+        unsigned weights[ROUTE_COUNT] = {5, 90, 3, 2};
+        size_t preload_users = 10000;
+        size_t list_limit = 100;
+        bool verify_certificate = false;
+        std::string json_path;
+        Log::Level log_level = Log::Level::Warn;
+        ServerTuning tuning;                // 내장 서버 설정
+    };
+
+    /**
+     * @brief 라우트별 측정 결과
+     *
+     * latency는 요청을 보냈어야 하는 시각부터 잰 지연(coordinated omission 보정),
+     * service는 실제로 보낸 시각부터 잰 지연입니다.
+     */
+    struct RouteStats {
+        LatencyHistogram latency;
+        LatencyHistogram service;
+        uint64_t success = 0;           // 2xx
+        uint64_t client_error = 0;      // 4xx (재사용된 OTP 401, 시도 제한 429 등)
+        uint64_t server_error = 0;      // 5xx
+        uint64_t failed = 0;            // 연결/전송 실패
+
+        void merge(const RouteStats& other) {
+            latency.merge(other.latency);
+            service.merge(other.service);
+            success += other.success;
+            client_error += other.client_error;
+            server_error += other.server_error;
+            failed += other.failed;
+        }
+    };
+
+    struct PreloadedUser {
+        std::string user_id;
+        std::string secret;
+    };
+
+    uint64_t nowNs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    void sleepUntilNs(uint64_t deadline) {
+        uint64_t now = nowNs();
+        if (deadline > now) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(deadline - now));
+        }
+    }
+
+    void printUsage(const char* program_name) {
+        std::cout << "MFA HTTP 부하 생성기" << std::endl;
+        std::cout << "사용법: " << program_name << " [옵션]" << std::endl;
+        std::cout << std::endl;
+        std::cout << "대상:" << std::endl;
+        std::cout << "  --target <URL>       실행 중인 서버 (예: http://127.0.0.1:8080, https://host:8443)" << std::endl;
+        std::cout << "                       없으면 같은 프로세스에 MFAServer를 띄워 측정" << std::endl;
+        std::cout << "  --port <포트>        내장 서버 포트 (기본값: " << DEFAULT_LOCAL_PORT << ")" << std::endl;
+        std::cout << "  --cert/--key <파일>  내장 서버 SSL 인증서/키" << std::endl;
+        std::cout << "  --data <파일>        내장 서버 사용자 데이터 파일 (기본값: loadgen_data/users.dat)" << std::endl;
+        std::cout << "  --storage <방식>     내장 서버 저장소: memory | mapped (기본값: memory)" << std::endl;
+        std::cout << "  --verify-cert        HTTPS 대상의 인증서 검증 (기본값: 검증 안 함)" << std::endl;
+        std::cout << std::endl;
+        std::cout << "내장 서버 튜닝 (mfa-server와 같은 옵션):" << std::endl;
+        ServerTuning::printUsage(std::cout);
+        std::cout << std::endl;
+        std::cout << "부하:" << std::endl;
+        std::cout << "  --connections <수>   keep-alive 연결 수 (연결마다 스레드 하나, 기본값: 16)" << std::endl;
+        std::cout << "  --duration <초>      측정 시간 (기본값: 10)" << std::endl;
+        std::cout << "  --warmup <초>        측정 전 예열 시간 (기본값: 2)" << std::endl;
+        std::cout << "  --rate <초당 요청>   open loop 목표 처리량 (없으면 closed loop)" << std::endl;
+        std::cout << "  --mix <가중치>       register=5,authenticate=90,list=3,delete=2 형식 (기본값)" << std::endl;
+        std::cout << "  --users <수>         인증 대상으로 미리 등록할 사용자 수 (기본값: 10000)" << std::endl;
+        std::cout << "  --list-limit <수>    목록 요청의 limit (기본값: 100)" << std::endl;
+        std::cout << std::endl;
+        std::cout << "출력:" << std::endl;
+        std::cout << "  --json <파일>        결과를 JSON으로도 저장" << std::endl;
+        std::cout << "  --log-level <레벨>   내장 서버 로그 레벨 (기본값: warn)" << std::endl;
+        std::cout << "  --help              이 도움말 출력" << std::endl;
+    }
+
+    bool parseMix(const std::string& text, unsigned (&weights)[ROUTE_COUNT]) {
+        unsigned parsed[ROUTE_COUNT] = {0, 0, 0, 0};
+        std::stringstream stream(text);
+        std::string entry;
+        while (std::getline(stream, entry, ',')) {
+            size_t eq = entry.find('=');
+            if (eq == std::string::npos) return false;
+            std::string name = entry.substr(0, eq);
+            size_t route = 0;
+            while (route < ROUTE_COUNT && name != ROUTE_NAMES[route]) route++;
+            if (route == ROUTE_COUNT) return false;
+            try {
+                int value = std::stoi(entry.substr(eq + 1));
+                if (value < 0) return false;
+                parsed[route] = static_cast<unsigned>(value);
+            } catch (const std::exception&) {
+                return false;
+            }
+        }
+        unsigned total = 0;
+        for (unsigned weight : parsed) total += weight;
+        if (total == 0) return false;
+        std::copy(std::begin(parsed), std::end(parsed), std::begin(weights));
+        return true;
+    }
+
+    std::unique_ptr<httplib::Client> makeClient(const std::string& base_url, const Options& options) {
+        auto client = std::make_unique<httplib::Client>(base_url);
+        client->set_keep_alive(true);
+        client->set_connection_timeout(5);
+        client->set_read_timeout(30);
+        client->set_write_timeout(30);
+        client->enable_server_certificate_verification(options.verify_certificate);
+        return client;
+    }
+
+    // 대량 등록 결과(line,user_id,secret,status)에서 새로 등록된 사용자만 추림
+    void collectCreated(const std::string& body, std::vector<PreloadedUser>& users) {
+        size_t pos = body.find('\n');       // 헤더
+        while (pos != std::string::npos && pos + 1 < body.size()) {
+            size_t end = body.find('\n', pos + 1);
+            std::string_view line(body.data() + pos + 1, (end == std::string::npos ? body.size() : end) - pos - 1);
+            pos = end;
+
+            size_t c1 = line.find(',');
+            size_t c2 = c1 == std::string_view::npos ? c1 : line.find(',', c1 + 1);
+            size_t c3 = c2 == std::string_view::npos ? c2 : line.find(',', c2 + 1);
+            if (c3 == std::string_view::npos || line.substr(c3 + 1) != "created") {
+                continue;
+            }
+            users.push_back({std::string(line.substr(c1 + 1, c2 - c1 - 1)), std::string(line.substr(c2 + 1, c3 - c2 - 1))});
+        }
+    }
+
+    std::string registerBody(const std::string& user_id) {
+        return "{\"user_id\": \"" + user_id + "\"}";
+    }
+
+    bool extractSecret(const std::string& body, std::string& secret) {
+        static const std::string_view keys[] = {"secret"};
+        std::string_view fields[1];
+        char scratch[256];
+        if (Json::parseStringFields(body, keys, fields, 1, scratch, sizeof(scratch)) != Json::Error::None ||
+            fields[0].empty()) {
+            return false;
+        }
+        secret.assign(fields[0]);
+        return true;
+    }
+
+    /**
+     * @brief 인증 대상 사용자 미리 등록 (대량 등록 API, 없는 서버면 /api/register로 한 명씩)
+     */
+    bool preloadUsers(httplib::Client& client, const std::string& run_id, size_t count,
+                      std::vector<PreloadedUser>& users) {
+        users.reserve(count);
+        for (size_t begin = 0; begin < count; begin += PRELOAD_CHUNK) {
+            size_t end = std::min(count, begin + PRELOAD_CHUNK);
+            std::string body = "user_id\n";
+            for (size_t i = begin; i < end; i++) {
+                body += "lg" + run_id + "_" + std::to_string(i) + "\n";
+            }
+            auto result = client.Post("/api/users/bulk", body, "text/csv");
+            if (result && result->status == 200) {
+                collectCreated(result->body, users);
+                continue;
+            }
+            if (result && result->status != 404) {
+                std::cerr << "오류: 대량 등록 실패 (HTTP " << result->status << ")" << std::endl;
+                return false;
+            }
+            for (size_t i = begin; i < end; i++) {
+                std::string user_id = "lg" + run_id + "_" + std::to_string(i);
+                auto single = client.Post("/api/register", registerBody(user_id), "application/json");
+                PreloadedUser user{user_id, std::string()};
+                if (!single || single->status != 200 || !extractSecret(single->body, user.secret)) {
+                    std::cerr << "오류: 사용자 등록 실패: " << user_id << std::endl;
+                    return false;
+                }
+                users.push_back(std::move(user));
+            }
+        }
+        return !users.empty() || count == 0;
+    }
+
+    /**
+     * @brief 연결 하나를 담당하는 작업자
+     */
+    class Worker {
+    public:
+        Worker(size_t id, const Options& options, const std::string& base_url, const std::string& run_id,
+               const std::vector<PreloadedUser>& users, MFACore& otp_core)
+            : id(id), options(options), run_id(run_id), users(users), otp_core(otp_core),
+              client(makeClient(base_url, options)), rng(0x9E3779B97F4A7C15ull * (id + 1)) {
+            for (unsigned weight : options.weights) total_weight += weight;
+        }
+
+        void run(uint64_t start_ns, uint64_t measure_start_ns, uint64_t end_ns) {
+            // open loop: 연결마다 connections/rate 간격으로 보낼 시각을 미리 정해 둠 (밀리면 지연에 포함)
+            const uint64_t interval_ns = options.rate > 0
+                ? static_cast<uint64_t>(1e9 * static_cast<double>(options.connections) / options.rate)
+                : 0;
+            uint64_t next_send = start_ns + (interval_ns * id) / options.connections;
+            LatencyHistogram warmup_service;
+            uint64_t expected_interval_ns = 0;
+            bool measuring = false;
+
+            for (;;) {
+                uint64_t intended = 0;
+                if (interval_ns > 0) {
+                    intended = next_send;
+                    next_send += interval_ns;
+                    if (intended >= end_ns) break;
+                    sleepUntilNs(intended);
+                }
+                uint64_t sent = nowNs();
+                if (sent >= end_ns) break;
+                if (interval_ns == 0) intended = sent;
+
+                if (!measuring && intended >= measure_start_ns) {
+                    // closed loop는 예열 구간의 평균 응답 시간을 요청 간 예상 간격으로 써서 보정
+                    measuring = true;
+                    expected_interval_ns = static_cast<uint64_t>(warmup_service.mean());
+                }
+
+                int status = 0;
+                Route route = issue(status);
+                uint64_t done = nowNs();
+
+                if (!measuring) {
+                    warmup_service.record(done - sent);
+                    continue;
+                }
+                RouteStats& route_stats = stats[route];
+                if (interval_ns > 0) {
+                    route_stats.latency.record(done - intended);
+                } else {
+                    route_stats.latency.recordCorrected(done - sent, expected_interval_ns);
+                }
+                route_stats.service.record(done - sent);
+                if (status <= 0) route_stats.failed++;
+                else if (status < 400) route_stats.success++;
+                else if (status < 500) route_stats.client_error++;
+                else route_stats.server_error++;
+            }
+        }
+
+        const RouteStats& routeStats(size_t route) const { return stats[route]; }
+
+    private:
+        size_t id;
+        const Options& options;
+        const std::string& run_id;
+        const std::vector<PreloadedUser>& users;
+        MFACore& otp_core;
+        std::unique_ptr<httplib::Client> client;
+        uint64_t rng;
+        unsigned total_weight = 0;
+        RouteStats stats[ROUTE_COUNT];
+        std::vector<std::string> registered;        // 이 작업자가 등록한 사용자 (삭제 대상)
+        size_t next_user_number = 0;
+
+        uint64_t nextRandom() {
+            rng ^= rng << 13;
+            rng ^= rng >> 7;
+            rng ^= rng << 17;
+            return rng;
+        }
+
+        Route pickRoute() {
+            unsigned pick = static_cast<unsigned>(nextRandom() % total_weight);
+            for (size_t route = 0; route < ROUTE_COUNT; route++) {
+                if (pick < options.weights[route]) return static_cast<Route>(route);
+                pick -= options.weights[route];
+            }
+            return ROUTE_AUTHENTICATE;
+        }
+
+        static int statusOf(const httplib::Result& result) {
+            return result ? result->status : -1;
+        }
+
+        Route issue(int& status) {
+            Route route = pickRoute();
+            // 미리 등록한 사용자가 없으면 인증 대신, 지울 사용자가 없으면 삭제 대신 등록
+            if ((route == ROUTE_AUTHENTICATE && users.empty()) || (route == ROUTE_DELETE && registered.empty())) {
+                route = ROUTE_REGISTER;
+            }
+
+            switch (route) {
+                case ROUTE_REGISTER: {
+                    std::string user_id = "lg" + run_id + "_w" + std::to_string(id) + "_" +
+                                          std::to_string(next_user_number++);
+                    auto result = client->Post("/api/register", registerBody(user_id), "application/json");
+                    status = statusOf(result);
+                    if (status == 200) registered.push_back(std::move(user_id));
+                    break;
+                }
+                case ROUTE_AUTHENTICATE: {
+                    const PreloadedUser& user = users[nextRandom() % users.size()];
+                    char body[160];
+                    int length = snprintf(body, sizeof(body), "{\"user_id\": \"%s\", \"otp_code\": \"%06d\"}",
+                                          user.user_id.c_str(), otp_core.generateTOTPCode(user.secret));
+                    auto result = client->Post("/api/authenticate", std::string(body, static_cast<size_t>(length)),
+                                               "application/json");
+                    status = statusOf(result);
+                    break;
+                }
+                case ROUTE_LIST: {
+                    auto result = client->Get("/api/users?limit=" + std::to_string(options.list_limit));
+                    status = statusOf(result);
+                    break;
+                }
+                case ROUTE_DELETE: {
+                    std::string user_id = std::move(registered.back());
+                    registered.pop_back();
+                    auto result = client->Delete("/api/user/" + user_id);
+                    status = statusOf(result);
+                    break;
+                }
+                default:
+                    break;
+            }
+            return route;
+        }
+    };
+
+    std::string formatMicros(uint64_t ns) {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(ns < 10000000 ? 1 : 0) << static_cast<double>(ns) / 1000.0;
+        return out.str();
+    }
+
+    void printReport(const RouteStats (&routes)[ROUTE_COUNT], const RouteStats& all, double seconds,
+                     const Options& options) {
+        std::cout << std::endl;
+        std::cout << (options.rate > 0 ? "open loop " : "closed loop ") << options.connections << " connections, "
+                  << std::fixed << std::setprecision(1) << seconds << "s"
+                  << (options.rate > 0 ? ", target " + std::to_string(static_cast<uint64_t>(options.rate)) + " req/s"
+                                       : std::string())
+                  << std::endl;
+        std::cout << "지연 단위: us (보내야 했던 시각 기준, coordinated omission 보정)" << std::endl;
+        std::cout << std::left << std::setw(14) << "route" << std::right
+                  << std::setw(10) << "requests" << std::setw(11) << "req/s"
+                  << std::setw(9) << "2xx" << std::setw(8) << "4xx" << std::setw(7) << "5xx" << std::setw(7) << "err";
+        for (double p : REPORT_PERCENTILES) {
+            std::ostringstream label;
+            label << "p" << p;
+            std::cout << std::setw(10) << label.str();
+        }
+        std::cout << std::setw(10) << "max" << std::setw(12) << "svc p99" << std::endl;
+
+        auto printRow = [&](const char* name, const RouteStats& stats) {
+            uint64_t count = stats.service.count();
+            if (count == 0) return;
+            std::cout << std::left << std::setw(14) << name << std::right
+                      << std::setw(10) << count
+                      << std::setw(11) << std::fixed << std::setprecision(0) << static_cast<double>(count) / seconds
+                      << std::setw(9) << stats.success << std::setw(8) << stats.client_error
+                      << std::setw(7) << stats.server_error << std::setw(7) << stats.failed;
+            for (double p : REPORT_PERCENTILES) {
+                std::cout << std::setw(10) << formatMicros(stats.latency.percentile(p));
+            }
+            std::cout << std::setw(10) << formatMicros(stats.latency.max())
+                      << std::setw(12) << formatMicros(stats.service.percentile(99.0)) << std::endl;
+        };
+        for (size_t route = 0; route < ROUTE_COUNT; route++) {
+            printRow(ROUTE_NAMES[route], routes[route]);
+        }
+        printRow("all", all);
+    }
+
+    void writeJSONRoute(std::ostream& out, const char* name, const RouteStats& stats, double seconds) {
+        out << "{\"route\": \"" << name << "\", \"requests\": " << stats.service.count()
+            << ", \"throughput\": " << std::fixed << std::setprecision(1)
+            << static_cast<double>(stats.service.count()) / seconds
+            << ", \"2xx\": " << stats.success << ", \"4xx\": " << stats.client_error
+            << ", \"5xx\": " << stats.server_error << ", \"errors\": " << stats.failed
+            << ", \"latency_ns\": {";
+        for (double p : REPORT_PERCENTILES) {
+            std::ostringstream label;
+            label << "p" << p;
+            out << "\"" << label.str() << "\": " << stats.latency.percentile(p) << ", ";
+        }
+        out << "\"max\": " << stats.latency.max() << ", \"mean\": " << std::setprecision(0) << stats.latency.mean()
+            << "}, \"service_ns\": {\"p50\": " << stats.service.percentile(50.0)
+            << ", \"p99\": " << stats.service.percentile(99.0) << ", \"max\": " << stats.service.max() << "}}";
+    }
+
+    bool writeJSON(const std::string& path, const RouteStats (&routes)[ROUTE_COUNT], const RouteStats& all,
+                   double seconds, const Options& options, const std::string& target) {
+        std::ofstream out(path, std::ios::trunc);
+        out << "{\n  \"context\": {\"target\": \"" << target << "\", \"mode\": \""
+            << (options.rate > 0 ? "open" : "closed") << "\", \"connections\": " << options.connections
+            << ", \"rate\": " << std::fixed << std::setprecision(1) << options.rate
+            << ", \"duration\": " << seconds << ", \"users\": " << options.preload_users
+            << ", \"timestamp\": " << static_cast<long long>(time(nullptr));
+        if (options.target.empty()) {
+            const ServerTuning& tuning = options.tuning;
+            out << ", \"server\": {\"listener\": \"" << (tuning.listener == ListenerMode::Epoll ? "epoll" : "threads")
+                << "\", \"event_threads\": " << tuning.event_threads
+                << ", \"workers\": " << tuning.worker_threads << ", \"max_queue\": " << tuning.max_queued
+                << ", \"pin_workers\": " << (tuning.pin_workers ? "true" : "false")
+                << ", \"keep_alive_max\": " << tuning.keep_alive_max_count
+                << ", \"keep_alive_timeout\": " << tuning.keep_alive_timeout_sec
+                << ", \"read_timeout\": " << tuning.read_timeout_sec << ", \"write_timeout\": " << tuning.write_timeout_sec
+                << ", \"backlog\": " << tuning.listen_backlog
+                << ", \"tcp_nodelay\": " << (tuning.tcp_nodelay ? "true" : "false") << "}";
+        }
+        out << "},\n  \"routes\": [";
+        bool first = true;
+        for (size_t route = 0; route < ROUTE_COUNT; route++) {
+            if (routes[route].service.count() == 0) continue;
+            out << (first ? "\n    " : ",\n    ");
+            writeJSONRoute(out, ROUTE_NAMES[route], routes[route], seconds);
+            first = false;
+        }
+        out << "\n  ],\n  \"all\": ";
+        writeJSONRoute(out, "all", all, seconds);
+        out << "\n}\n";
+        return out.good();
+    }
+
+    void removeScratchFiles(const std::string& path) {
+        for (const char* suffix : {"", ".tmp", ".wal", ".wal.1", ".wal.tmp", ".replay", ".replay.tmp"}) {
+            ::unlink((path + suffix).c_str());
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        try {
+            if (arg == "--help" || arg == "-h") {
+                printUsage(argv[0]);
+                return 0;
+            }
+            else if (arg == "--target" && i + 1 < argc) {
+                options.target = argv[++i];
+                while (!options.target.empty() && options.target.back() == '/') options.target.pop_back();
+            }
+            else if (arg == "--port" && i + 1 < argc) {
+                options.port = std::stoi(argv[++i]);
+            }
+            else if (arg == "--cert" && i + 1 < argc) {
+                options.cert_path = argv[++i];
+            }
+            else if (arg == "--key" && i + 1 < argc) {
+                options.key_path = argv[++i];
+            }
+            else if (arg == "--data" && i + 1 < argc) {
+                options.data_file = argv[++i];
+            }
+            else if (arg == "--storage" && i + 1 < argc) {
+                std::string mode = argv[++i];
+                if (mode == "memory") {
+                    options.storage_mode = StorageMode::Memory;
+                } else if (mode == "mapped") {
+                    options.storage_mode = StorageMode::Mapped;
+                } else {
+                    std::cerr << "오류: 유효하지 않은 저장소 방식: " << mode << std::endl;
+                    return 1;
+                }
+            }
+            else if (arg == "--verify-cert") {
+                options.verify_certificate = true;
+            }
+            else if (arg == "--connections" && i + 1 < argc) {
+                options.connections = std::stoul(argv[++i]);
+            }
+            else if (arg == "--duration" && i + 1 < argc) {
+                options.duration_seconds = std::stod(argv[++i]);
+            }
+            else if (arg == "--warmup" && i + 1 < argc) {
+                options.warmup_seconds = std::stod(argv[++i]);
+            }
+            else if (arg == "--rate" && i + 1 < argc) {
+                options.rate = std::stod(argv[++i]);
+            }
+            else if (arg == "--mix" && i + 1 < argc) {
+                if (!parseMix(argv[++i], options.weights)) {
+                    std::cerr << "오류: 유효하지 않은 요청 비율: " << argv[i]
+                              << " (예: register=5,authenticate=90,list=3,delete=2)" << std::endl;
+                    return 1;
+                }
+            }
+            else if (arg == "--users" && i + 1 < argc) {
+                options.preload_users = std::stoul(argv[++i]);
+            }
+            else if (arg == "--list-limit" && i + 1 < argc) {
+                options.list_limit = std::stoul(argv[++i]);
+            }
+            else if (arg == "--json" && i + 1 < argc) {
+                options.json_path = argv[++i];
+            }
+            else if (arg == "--log-level" && i + 1 < argc) {
+                if (!Log::parseLevel(argv[++i], options.log_level)) {
+                    std::cerr << "오류: 유효하지 않은 로그 레벨: " << argv[i] << std::endl;
+                    return 1;
+                }
+            }
+            else if (ServerTuning::isOption(arg) && i + 1 < argc) {
+                std::string error;
+                if (!ServerTuning::parseOption(arg, argv[++i], options.tuning, error)) {
+                    std::cerr << "오류: " << error << std::endl;
+                    return 1;
+                }
+            }
+            else {
+                std::cerr << "오류: 알 수 없는 옵션: " << arg << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "오류: 유효하지 않은 값: " << arg << " " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    if (options.connections == 0 || options.duration_seconds <= 0 || options.warmup_seconds < 0 ||
+        options.rate < 0) {
+        std::cerr << "오류: 연결 수, 측정 시간, 예열 시간, 목표 처리량은 양수여야 합니다." << std::endl;
+        return 1;
+    }
+
+    Log::setOutput(STDERR_FILENO);
+    Log::setLevel(options.log_level);
+
+    // 대상이 없으면 같은 프로세스에 서버 시작 (시도 제한 없이 순수 처리 비용 측정)
+    std::unique_ptr<MFAServer> server;
+    std::thread server_thread;
+    std::string base_url = options.target;
+    if (base_url.empty()) {
+        size_t slash = options.data_file.rfind('/');
+        if (slash != std::string::npos && slash > 0) {
+            mkdir(options.data_file.substr(0, slash).c_str(), 0755);
+        }
+        try {
+            server = std::make_unique<MFAServer>(options.port, options.cert_path, options.key_path,
+                                                 options.data_file, options.storage_mode);
+        } catch (const std::exception& e) {
+            std::cerr << "오류: 서버 초기화 실패: " << e.what() << std::endl;
+            return 1;
+        }
+        server->setRateLimits(RateLimit{}, RateLimit{});
+        server->setTuning(options.tuning);
+        server_thread = std::thread([&server]() { server->start(); });
+        base_url = std::string(server->isSSLEnabled() ? "https" : "http") + "://127.0.0.1:" + std::to_string(options.port);
+    }
+
+    auto stopServer = [&]() {
+        if (server) {
+            server->stop();
+            server_thread.join();
+            server.reset();
+        }
+    };
+
+    auto setup_client = makeClient(base_url, options);
+    bool ready = false;
+    for (int attempt = 0; attempt < 100 && !ready; attempt++) {
+        auto result = setup_client->Get("/health");
+        ready = result && result->status == 200;
+        if (!ready) std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    if (!ready) {
+        std::cerr << "오류: 서버에 연결할 수 없습니다: " << base_url << std::endl;
+        stopServer();
+        return 1;
+    }
+
+    // 실행마다 다른 사용자 ID를 쓰도록 실행 ID를 붙임
+    std::ostringstream run_id_stream;
+    run_id_stream << std::hex << (static_cast<uint64_t>(time(nullptr)) ^ (static_cast<uint64_t>(getpid()) << 20));
+    const std::string run_id = run_id_stream.str();
+
+    std::cout << "대상: " << base_url << (server ? " (내장 서버)" : "") << std::endl;
+    std::vector<PreloadedUser> users;
+    uint64_t preload_start = nowNs();
+    if (options.weights[ROUTE_AUTHENTICATE] > 0 &&
+        !preloadUsers(*setup_client, run_id, options.preload_users, users)) {
+        stopServer();
+        return 1;
+    }
+    std::cout << "사용자 " << users.size() << "명 등록 ("
+              << (nowNs() - preload_start) / 1000000 << "ms)" << std::endl;
+
+    // OTP는 서버와 같은 코드 경로(MFACore::generateTOTPCode)로 계산 (등록하지 않으므로 파일은 쓰지 않음)
+    const std::string otp_scratch = options.data_file + ".loadgen-otp";
+    int exit_code = 0;
+    {
+        MFACore otp_core(otp_scratch);
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        for (size_t i = 0; i < options.connections; i++) {
+            workers.push_back(std::make_unique<Worker>(i, options, base_url, run_id, users, otp_core));
+        }
+
+        uint64_t start_ns = nowNs();
+        uint64_t measure_start_ns = start_ns + static_cast<uint64_t>(options.warmup_seconds * 1e9);
+        uint64_t end_ns = measure_start_ns + static_cast<uint64_t>(options.duration_seconds * 1e9);
+        std::cout << "예열 " << options.warmup_seconds << "초, 측정 " << options.duration_seconds << "초..." << std::endl;
+
+        std::vector<std::thread> threads;
+        for (auto& worker : workers) {
+            threads.emplace_back([&worker, start_ns, measure_start_ns, end_ns]() {
+                worker->run(start_ns, measure_start_ns, end_ns);
+            });
+        }
+        for (auto& thread : threads) thread.join();
+        double seconds = static_cast<double>(nowNs() - measure_start_ns) / 1e9;
+
+        RouteStats routes[ROUTE_COUNT];
+        RouteStats all;
+        for (const auto& worker : workers) {
+            for (size_t route = 0; route < ROUTE_COUNT; route++) {
+                routes[route].merge(worker->routeStats(route));
+                all.merge(worker->routeStats(route));
+            }
+        }
+
+        printReport(routes, all, seconds, options);
+        if (options.rate > 0 && static_cast<double>(all.service.count()) / seconds < options.rate * 0.95) {
+            std::cout << "경고: 목표 처리량에 도달하지 못했습니다 (서버 또는 연결 수 부족)" << std::endl;
+        }
+        if (!options.json_path.empty() &&
+            !writeJSON(options.json_path, routes, all, seconds, options, server ? "embedded" : base_url)) {
+            std::cerr << "오류: JSON 결과 저장 실패: " << options.json_path << std::endl;
+            exit_code = 1;
+        }
+    }
+    removeScratchFiles(otp_scratch);
+
+    stopServer();
+    Log::shutdown();
+    return exit_code;
+}
@@ -0,0 +1,275 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include "mfa_core.h"
+#include "user_io.h"
+#include "logger.h"
+
+namespace {
+
+    constexpr size_t IO_BUFFER_SIZE = 1 << 20;          // 입력 읽기/출력 쓰기 단위
+    constexpr size_t IMPORT_CHUNK_ITEMS = 65536;        // importUsers() 한 번에 넘기는 항목 수
+
+    void printUsage(const char* program_name) {
+        std::cout << "MFA 사용자 대량 가져오기/내보내기" << std::endl;
+        std::cout << "사용법: " << program_name << " <import|export> [옵션] [입력 파일]" << std::endl;
+        std::cout << std::endl;
+        std::cout << "명령:" << std::endl;
+        std::cout << "  import [파일]        CSV/NDJSON 사용자 목록 등록 (파일이 없거나 -면 표준 입력)" << std::endl;
+        std::cout << "                       결과(line,user_id,secret,status)는 --output으로 출력" << std::endl;
+        std::cout << "  export               모든 사용자를 user_id,secret으로 출력" << std::endl;
+        std::cout << std::endl;
+        std::cout << "옵션:" << std::endl;
+        std::cout << "  --data <파일>        사용자 데이터 파일 경로 (기본값: data/users.dat)" << std::endl;
+        std::cout << "  --storage <방식>     사용자 저장소: memory | mapped (기본값: memory)" << std::endl;
+        std::cout << "  --format <형식>      csv | ndjson (기본값: 입력 파일 확장자, 없으면 csv)" << std::endl;
+        std::cout << "  --output <파일>      출력 파일 (기본값: 표준 출력)" << std::endl;
+        std::cout << "  --threads <수>       시크릿 생성/키 계산 스레드 수 (기본값: 코어 수)" << std::endl;
+        std::cout << "  --log-level <레벨>   로그 레벨: debug | info | warn | error | off (기본값: warn)" << std::endl;
+        std::cout << "  --help              이 도움말 출력" << std::endl;
+        std::cout << std::endl;
+        std::cout << "memory 저장소는 서버가 실행 중이지 않을 때만 사용하세요 (실행 중인 서버에는 POST /api/users/bulk)." << std::endl;
+    }
+
+    bool writeAll(int fd, const std::string& data) {
+        size_t written = 0;
+        while (written < data.size()) {
+            ssize_t n = ::write(fd, data.data() + written, data.size() - written);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            written += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    bool endsWith(const std::string& text, const std::string& suffix) {
+        return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    double secondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    struct ImportTotals {
+        size_t counts[4] = {0, 0, 0, 0};    // ImportStatus 순서
+        size_t total = 0;
+    };
+
+    // 모인 항목을 등록하고 결과 줄을 출력
+    bool importChunk(MFACore& core, UserIO::Format format, std::vector<ImportItem>& items, std::vector<size_t>& lines,
+                     unsigned int threads, int out_fd, std::string& out, ImportTotals& totals) {
+        std::vector<ImportStatus> statuses = core.importUsers(items, threads);
+        for (size_t i = 0; i < items.size(); i++) {
+            UserIO::appendResultRecord(out, format, lines[i], items[i], statuses[i]);
+            totals.counts[static_cast<size_t>(statuses[i])]++;
+            if (out.size() >= IO_BUFFER_SIZE) {
+                if (!writeAll(out_fd, out)) return false;
+                out.clear();
+            }
+        }
+        totals.total += items.size();
+        items.clear();
+        lines.clear();
+        return true;
+    }
+
+    int runImport(MFACore& core, UserIO::Format format, int in_fd, int out_fd, unsigned int threads) {
+        auto start = std::chrono::steady_clock::now();
+        UserIO::Reader reader(format);
+        std::vector<ImportItem> items;
+        std::vector<size_t> lines;
+        ImportTotals totals;
+        std::string out;
+        out.reserve(IO_BUFFER_SIZE + 4096);
+        UserIO::appendResultHeader(out, format);
+
+        std::vector<char> buffer(IO_BUFFER_SIZE);
+        for (;;) {
+            ssize_t n = ::read(in_fd, buffer.data(), buffer.size());
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0) {
+                std::cerr << "오류: 입력 읽기 실패" << std::endl;
+                return 1;
+            }
+            if (n == 0) break;
+            reader.feed(std::string_view(buffer.data(), static_cast<size_t>(n)), items, lines);
+            if (items.size() >= IMPORT_CHUNK_ITEMS &&
+                !importChunk(core, format, items, lines, threads, out_fd, out, totals)) {
+                std::cerr << "오류: 결과 출력 실패" << std::endl;
+                return 1;
+            }
+        }
+        reader.finish(items, lines);
+        if (!importChunk(core, format, items, lines, threads, out_fd, out, totals) || !writeAll(out_fd, out)) {
+            std::cerr << "오류: 결과 출력 실패" << std::endl;
+            return 1;
+        }
+
+        double elapsed = secondsSince(start);
+        std::cerr << "가져오기 완료: " << totals.total << "줄, 등록 " << totals.counts[0]
+                  << ", 이미 있음 " << totals.counts[1] << ", 형식 오류 " << totals.counts[2]
+                  << ", 실패 " << totals.counts[3] << " (" << elapsed << "초, "
+                  << static_cast<uint64_t>(totals.total / std::max(elapsed, 1e-9)) << " users/s)" << std::endl;
+        return totals.counts[static_cast<size_t>(ImportStatus::Failed)] == 0 ? 0 : 1;
+    }
+
+    int runExport(MFACore& core, UserIO::Format format, int out_fd) {
+        auto start = std::chrono::steady_clock::now();
+        std::string out;
+        out.reserve(IO_BUFFER_SIZE + 4096);
+        UserIO::appendExportHeader(out, format);
+
+        bool ok = true;
+        size_t count = core.exportUsers([&](std::string_view user_id, std::string_view secret) {
+            UserIO::appendExportRecord(out, format, user_id, secret);
+            if (out.size() >= IO_BUFFER_SIZE) {
+                ok = ok && writeAll(out_fd, out);
+                out.clear();
+            }
+        });
+        ok = ok && writeAll(out_fd, out);
+        if (!ok) {
+            std::cerr << "오류: 출력 실패" << std::endl;
+            return 1;
+        }
+
+        double elapsed = secondsSince(start);
+        std::cerr << "내보내기 완료: " << count << "명 (" << elapsed << "초, "
+                  << static_cast<uint64_t>(count / std::max(elapsed, 1e-9)) << " users/s)" << std::endl;
+        return 0;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::string command = argv[1];
+    if (command == "--help" || command == "-h") {
+        printUsage(argv[0]);
+        return 0;
+    }
+    if (command != "import" && command != "export") {
+        std::cerr << "오류: 알 수 없는 명령: " << command << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::string data_file = DEFAULT_USER_FILE;
+    StorageMode storage_mode = StorageMode::Memory;
+    std::string input_path;
+    std::string output_path;
+    std::string format_name;
+    unsigned int threads = 0;
+    Log::Level log_level = Log::Level::Warn;
+
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        }
+        else if (arg == "--data" && i + 1 < argc) {
+            data_file = argv[++i];
+        }
+        else if (arg == "--storage" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode == "memory") {
+                storage_mode = StorageMode::Memory;
+            } else if (mode == "mapped") {
+                storage_mode = StorageMode::Mapped;
+            } else {
+                std::cerr << "오류: 유효하지 않은 저장소 방식: " << mode << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--format" && i + 1 < argc) {
+            format_name = argv[++i];
+        }
+        else if (arg == "--output" && i + 1 < argc) {
+            output_path = argv[++i];
+        }
+        else if (arg == "--threads" && i + 1 < argc) {
+            try {
+                int value = std::stoi(argv[++i]);
+                if (value <= 0) {
+                    std::cerr << "오류: 유효하지 않은 스레드 수: " << value << std::endl;
+                    return 1;
+                }
+                threads = static_cast<unsigned int>(value);
+            } catch (const std::exception&) {
+                std::cerr << "오류: 유효하지 않은 스레드 수: " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--log-level" && i + 1 < argc) {
+            if (!Log::parseLevel(argv[++i], log_level)) {
+                std::cerr << "오류: 유효하지 않은 로그 레벨: " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else if (command == "import" && input_path.empty() && (arg == "-" || arg[0] != '-')) {
+            input_path = arg;
+        }
+        else {
+            std::cerr << "오류: 알 수 없는 옵션: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    UserIO::Format format = UserIO::Format::CSV;
+    if (!format_name.empty()) {
+        if (!UserIO::parseFormat(format_name, format)) {
+            std::cerr << "오류: 유효하지 않은 형식: " << format_name << " (csv | ndjson)" << std::endl;
+            return 1;
+        }
+    } else if (endsWith(input_path, ".ndjson") || endsWith(input_path, ".jsonl")) {
+        format = UserIO::Format::NDJSON;
+    }
+
+    // 출력(표준 출력일 수 있음)에 로그가 섞이지 않도록 로그는 표준 오류로
+    Log::setOutput(STDERR_FILENO);
+    Log::setLevel(log_level);
+
+    int in_fd = STDIN_FILENO;
+    if (!input_path.empty() && input_path != "-") {
+        in_fd = ::open(input_path.c_str(), O_RDONLY);
+        if (in_fd < 0) {
+            std::cerr << "오류: 입력 파일을 열 수 없습니다: " << input_path << std::endl;
+            return 1;
+        }
+    }
+    int out_fd = STDOUT_FILENO;
+    if (!output_path.empty()) {
+        out_fd = ::open(output_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+        if (out_fd < 0) {
+            std::cerr << "오류: 출력 파일을 열 수 없습니다: " << output_path << std::endl;
+            return 1;
+        }
+    }
+
+    int status = 1;
+    try {
+        MFACore core(data_file, storage_mode);
+        status = command == "import" ? runImport(core, format, in_fd, out_fd, threads) : runExport(core, format, out_fd);
+    } catch (const std::exception& e) {
+        std::cerr << "오류: " << e.what() << std::endl;
+    }
+
+    if (out_fd != STDOUT_FILENO && ::close(out_fd) != 0) {
+        std::cerr << "오류: 출력 파일 닫기 실패: " << output_path << std::endl;
+        status = 1;
+    }
+    if (in_fd != STDIN_FILENO) ::close(in_fd);
+    Log::shutdown();
+    return status;
+}
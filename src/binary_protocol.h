@@ -0,0 +1,173 @@
+#ifndef BINARY_PROTOCOL_H
+#define BINARY_PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief OTP 검증 전용 바이너리 프로토콜 (TCP/Unix 도메인 소켓)
+ *
+ * 같은 호스트/망의 서비스가 코드 확인만 하려고 /api/authenticate를 부르면 비용 대부분이
+ * HTTP 헤더 해석, JSON, CORS 헤더에 들어갑니다. 이 프로토콜은 길이가 앞에 붙은 작은 프레임만 씁니다.
+ * 모든 정수는 빅 엔디언입니다.
+ *
+ * 요청:  u16 길이 | u8 종류(VERIFY) | u32 요청 ID | u8 user_id 길이 | user_id | u8 OTP 길이 | OTP
+ * 응답:  u16 길이 | u8 종류(VERIFY_REPLY) | u32 요청 ID | u8 상태 | u16 retry_after(초)
+ *
+ * 길이는 자기 자신(2바이트)을 뺀 프레임 크기입니다. 한 연결에 응답을 기다리지 않고 요청을 여러 개
+ * 보낼 수 있고(파이프라이닝), 응답은 요청 순서대로 오며 요청 ID를 그대로 돌려줍니다.
+ * 길이가 범위를 벗어나거나 종류를 모르면 프레임 경계를 믿을 수 없으므로 서버가 연결을 닫습니다.
+ */
+namespace BinaryProtocol {
+
+    enum class FrameType : uint8_t {
+        Verify = 0x01,
+        VerifyReply = 0x81
+    };
+
+    enum class Status : uint8_t {
+        Ok = 0,                         // 코드 일치
+        Invalid = 1,                    // 코드 불일치, 재사용된 코드, 없는 사용자
+        RateLimited = 2,                // 시도 제한 (retry_after초 뒤 다시)
+        BadRequest = 3,                 // user_id/OTP가 비었거나 형식 오류
+        ServerError = 4
+    };
+
+    constexpr size_t LENGTH_BYTES = 2;
+    constexpr size_t MAX_FIELD_BYTES = 255;
+    constexpr size_t MIN_REQUEST_BYTES = 1 + 4 + 1 + 1;                                   // 길이 필드 제외
+    constexpr size_t MAX_REQUEST_BYTES = MIN_REQUEST_BYTES + 2 * MAX_FIELD_BYTES;
+    constexpr size_t REPLY_BYTES = 1 + 4 + 1 + 2;
+    constexpr size_t REPLY_FRAME_BYTES = LENGTH_BYTES + REPLY_BYTES;
+
+    struct Request {
+        uint32_t request_id = 0;
+        std::string_view user_id;       // 입력 버퍼를 가리킴
+        std::string_view otp_code;
+    };
+
+    struct Reply {
+        uint32_t request_id = 0;
+        Status status = Status::ServerError;
+        uint16_t retry_after = 0;
+    };
+
+    enum class ParseResult {
+        Frame,                          // 프레임 하나를 꺼냄 (consumed만큼 버퍼에서 제거)
+        Incomplete,                     // 더 받아야 함
+        Error                           // 프레임 경계를 알 수 없음 (연결을 닫아야 함)
+    };
+
+    inline void putU16(char* out, uint16_t value) {
+        out[0] = static_cast<char>(value >> 8);
+        out[1] = static_cast<char>(value);
+    }
+
+    inline void putU32(char* out, uint32_t value) {
+        out[0] = static_cast<char>(value >> 24);
+        out[1] = static_cast<char>(value >> 16);
+        out[2] = static_cast<char>(value >> 8);
+        out[3] = static_cast<char>(value);
+    }
+
+    inline uint16_t getU16(const char* in) {
+        const auto* p = reinterpret_cast<const unsigned char*>(in);
+        return static_cast<uint16_t>((p[0] << 8) | p[1]);
+    }
+
+    inline uint32_t getU32(const char* in) {
+        const auto* p = reinterpret_cast<const unsigned char*>(in);
+        return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+    }
+
+    /**
+     * @brief 검증 요청 프레임을 out 뒤에 추가
+     * @return user_id나 OTP가 255바이트를 넘으면 false (out은 그대로)
+     */
+    inline bool appendRequest(std::string& out, uint32_t request_id, std::string_view user_id,
+                              std::string_view otp_code) {
+        if (user_id.size() > MAX_FIELD_BYTES || otp_code.size() > MAX_FIELD_BYTES) return false;
+        size_t length = MIN_REQUEST_BYTES + user_id.size() + otp_code.size();
+        size_t offset = out.size();
+        out.resize(offset + LENGTH_BYTES + length);
+        char* p = &out[offset];
+        putU16(p, static_cast<uint16_t>(length));
+        p[2] = static_cast<char>(FrameType::Verify);
+        putU32(p + 3, request_id);
+        p[7] = static_cast<char>(user_id.size());
+        user_id.copy(p + 8, user_id.size());
+        p[8 + user_id.size()] = static_cast<char>(otp_code.size());
+        otp_code.copy(p + 9 + user_id.size(), otp_code.size());
+        return true;
+    }
+
+    /**
+     * @brief 버퍼 앞의 요청 프레임 하나 해석 (필드는 data를 가리키는 view)
+     *
+     * 프레임 길이는 맞지만 안쪽 필드 길이가 어긋나면 Frame을 돌려주고 user_id/OTP를 비워
+     * BadRequest로 응답하게 합니다 (요청 ID는 알 수 있으므로).
+     */
+    inline ParseResult parseRequest(const char* data, size_t size, Request& request, size_t& consumed) {
+        if (size < LENGTH_BYTES) return ParseResult::Incomplete;
+        size_t length = getU16(data);
+        if (length < MIN_REQUEST_BYTES || length > MAX_REQUEST_BYTES) return ParseResult::Error;
+        if (size < LENGTH_BYTES + length) return ParseResult::Incomplete;
+        const char* p = data + LENGTH_BYTES;
+        if (static_cast<FrameType>(p[0]) != FrameType::Verify) return ParseResult::Error;
+
+        consumed = LENGTH_BYTES + length;
+        request.request_id = getU32(p + 1);
+        request.user_id = {};
+        request.otp_code = {};
+        size_t user_length = static_cast<unsigned char>(p[5]);
+        if (MIN_REQUEST_BYTES + user_length > length) return ParseResult::Frame;
+        size_t otp_length = static_cast<unsigned char>(p[6 + user_length]);
+        if (MIN_REQUEST_BYTES + user_length + otp_length != length) return ParseResult::Frame;
+        request.user_id = std::string_view(p + 6, user_length);
+        request.otp_code = std::string_view(p + 7 + user_length, otp_length);
+        return ParseResult::Frame;
+    }
+
+    /**
+     * @brief 응답 프레임을 out에 씀 (REPLY_FRAME_BYTES바이트)
+     */
+    inline void writeReply(char* out, const Reply& reply) {
+        putU16(out, static_cast<uint16_t>(REPLY_BYTES));
+        out[2] = static_cast<char>(FrameType::VerifyReply);
+        putU32(out + 3, reply.request_id);
+        out[7] = static_cast<char>(reply.status);
+        putU16(out + 8, reply.retry_after);
+    }
+
+    /**
+     * @brief 버퍼 앞의 응답 프레임 하나 해석
+     */
+    inline ParseResult parseReply(const char* data, size_t size, Reply& reply, size_t& consumed) {
+        if (size < LENGTH_BYTES) return ParseResult::Incomplete;
+        size_t length = getU16(data);
+        if (length != REPLY_BYTES) return ParseResult::Error;
+        if (size < REPLY_FRAME_BYTES) return ParseResult::Incomplete;
+        const char* p = data + LENGTH_BYTES;
+        if (static_cast<FrameType>(p[0]) != FrameType::VerifyReply) return ParseResult::Error;
+        reply.request_id = getU32(p + 1);
+        reply.status = static_cast<Status>(p[5]);
+        reply.retry_after = getU16(p + 6);
+        consumed = REPLY_FRAME_BYTES;
+        return ParseResult::Frame;
+    }
+
+    inline const char* statusName(Status status) {
+        switch (status) {
+            case Status::Ok: return "ok";
+            case Status::Invalid: return "invalid";
+            case Status::RateLimited: return "rate_limited";
+            case Status::BadRequest: return "bad_request";
+            case Status::ServerError: return "server_error";
+        }
+        return "unknown";
+    }
+}
+
+#endif // BINARY_PROTOCOL_H
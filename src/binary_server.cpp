@@ -0,0 +1,450 @@
+#include "binary_server.h"
+#include "logger.h"
+#include "worker_pool.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+    constexpr int MAX_EVENTS = 256;
+    constexpr int ACCEPT_BATCH = 64;                     // 한 번 깨어났을 때 최대 수락 수 (다른 리액터에도 기회를 줌)
+    constexpr size_t READ_CHUNK = 16 * 1024;
+}
+
+/**
+ * @brief 연결 하나의 상태 (리액터 스레드만 접근)
+ */
+struct BinaryServer::Connection {
+    int fd = -1;
+    std::string peer;
+    std::string in;                     // 아직 완성되지 않은 요청 프레임
+    std::string out;
+    size_t out_offset = 0;
+    bool peer_closed = false;           // 상대가 쓰기를 닫음 (남은 응답을 보내고 닫음)
+    std::vector<Item> batch;            // 작업 스레드로 넘긴 묶음 (요청이 in을 가리키므로 끝날 때까지 in을 그대로 둠)
+    size_t batch_bytes = 0;             // 그 묶음이 차지한 in 앞부분
+    bool busy = false;                  // 작업 스레드가 batch를 처리 중
+    bool closing = false;               // busy 중에 닫힘 (작업이 끝나면 정리)
+    Connection* prev = nullptr;
+    Connection* next = nullptr;
+
+    size_t pendingOutput() const { return out.size() - out_offset; }
+};
+
+class BinaryServer::Reactor {
+public:
+    explicit Reactor(BinaryServer& owner) : server(owner), listen_tags(owner.listen_fds.size()) {}
+
+    ~Reactor() {
+        while (head) closeConnection(head);
+        // 작업 풀은 이미 멈췄으므로 남은 완료는 닫힌 연결뿐
+        for (Connection* conn : completed) {
+            if (conn->closing) destroy(conn);
+        }
+        if (epoll_fd >= 0) ::close(epoll_fd);
+        if (wake_fd >= 0) ::close(wake_fd);
+        if (spare_fd >= 0) ::close(spare_fd);
+    }
+
+    bool init() {
+        epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        spare_fd = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+        if (epoll_fd < 0 || wake_fd < 0) return false;
+
+        epoll_event event{};
+        for (size_t i = 0; i < server.listen_fds.size(); i++) {
+            event.events = EPOLLIN | EPOLLEXCLUSIVE;
+            event.data.ptr = &listen_tags[i];
+            if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, server.listen_fds[i], &event) != 0) return false;
+        }
+
+        event.events = EPOLLIN;
+        event.data.ptr = &wake_tag;
+        return epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &event) == 0;
+    }
+
+    void wake() {
+        uint64_t one = 1;
+        ssize_t written = ::write(wake_fd, &one, sizeof(one));
+        (void)written;
+    }
+
+    void run() {
+        epoll_event events[MAX_EVENTS];
+        while (!server.stopping.load(std::memory_order_acquire)) {
+            int count = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
+            if (count < 0 && errno != EINTR) {
+                MFA_LOG_ERROR("BINARY", "epoll_wait 실패: " << strerror(errno));
+                break;
+            }
+            bool woken = false;
+            for (int i = 0; i < count; i++) {
+                void* tag = events[i].data.ptr;
+                if (tag == &wake_tag) {
+                    uint64_t value = 0;
+                    ssize_t n = ::read(wake_fd, &value, sizeof(value));
+                    (void)n;
+                    woken = true;
+                    continue;
+                }
+                char* listen_tag = static_cast<char*>(tag);
+                if (!listen_tags.empty() && listen_tag >= &listen_tags.front() && listen_tag <= &listen_tags.back()) {
+                    acceptConnections(static_cast<size_t>(listen_tag - &listen_tags.front()));
+                } else {
+                    handleEvent(static_cast<Connection*>(tag), events[i].events);
+                }
+            }
+            // 이번에 받은 이벤트를 다 처리한 뒤 정리해야 같은 묶음의 이벤트가 지운 연결을 가리키지 않음
+            if (woken) completeOffloaded();
+        }
+        while (head) closeConnection(head);
+    }
+
+private:
+    BinaryServer& server;
+    int epoll_fd = -1;
+    int wake_fd = -1;
+    int spare_fd = -1;                  // fd가 바닥났을 때 대기 연결을 받아 바로 닫는 데 쓰는 예비 fd
+    std::vector<char> listen_tags;      // 수신 소켓마다 하나 (epoll 이벤트 구분용)
+    char wake_tag = 0;
+    Connection* head = nullptr;
+    std::vector<Item> items;            // 핸들러에 넘기는 요청 묶음 (연결끼리 재사용)
+    std::mutex completed_mutex;
+    std::vector<Connection*> completed; // 작업 스레드가 batch를 끝낸 연결 (리액터가 꺼내 응답을 씀)
+
+    void acceptConnections(size_t index) {
+        int listen_fd = server.listen_fds[index];
+        bool is_unix = server.listen_unix[index];
+        for (int i = 0; i < ACCEPT_BATCH; i++) {
+            sockaddr_storage addr{};
+            socklen_t length = sizeof(addr);
+            int fd = accept4(listen_fd, reinterpret_cast<sockaddr*>(&addr), &length, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) continue;
+                if ((errno == EMFILE || errno == ENFILE) && spare_fd >= 0) {
+                    // 받지 못한 연결이 남아 있으면 수신 소켓이 계속 깨어나므로 하나 받아 바로 닫음
+                    ::close(spare_fd);
+                    int dropped = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+                    if (dropped >= 0) ::close(dropped);
+                    spare_fd = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+                    MFA_LOG_WARN("BINARY", "열 수 있는 파일 수 한도에 도달해 연결을 거절했습니다.");
+                }
+                return;
+            }
+
+            Connection* conn = new Connection();
+            conn->fd = fd;
+            if (is_unix) {
+                // 같은 호스트의 프로세스는 IP가 없으므로 uid별로 시도 제한
+                ucred credentials{};
+                socklen_t size = sizeof(credentials);
+                conn->peer = getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &size) == 0
+                                 ? "uid:" + std::to_string(credentials.uid)
+                                 : "unix";
+            } else {
+                // 요청/응답이 작고 파이프라이닝하므로 Nagle로 응답을 묶어 기다리지 않음
+                int yes = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+                char host[INET6_ADDRSTRLEN] = {0};
+                if (addr.ss_family == AF_INET) {
+                    inet_ntop(AF_INET, &reinterpret_cast<sockaddr_in*>(&addr)->sin_addr, host, sizeof(host));
+                } else if (addr.ss_family == AF_INET6) {
+                    inet_ntop(AF_INET6, &reinterpret_cast<sockaddr_in6*>(&addr)->sin6_addr, host, sizeof(host));
+                }
+                conn->peer = host;
+            }
+
+            conn->next = head;
+            if (head) head->prev = conn;
+            head = conn;
+            server.open_connections.fetch_add(1, std::memory_order_relaxed);
+
+            epoll_event event{};
+            event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+            event.data.ptr = conn;
+            if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+                closeConnection(conn);
+            }
+        }
+    }
+
+    // 송신 버퍼를 비우고, 상한 아래면 읽을 수 없을 때까지 읽고 처리
+    void handleEvent(Connection* conn, uint32_t events) {
+        if (conn->closing) return;
+        if (events & EPOLLERR) {
+            closeConnection(conn);
+            return;
+        }
+        char buffer[READ_CHUNK];
+        for (;;) {
+            if (!flushOutput(conn)) return;
+            if (conn->busy) return;     // 작업 스레드가 끝나면 completeOffloaded에서 이어 감
+            if (conn->pendingOutput() > server.config.max_pending_bytes) return;    // EPOLLOUT에서 이어 감
+            if (conn->peer_closed) {
+                if (conn->pendingOutput() == 0) closeConnection(conn);
+                return;
+            }
+
+            ssize_t n = ::recv(conn->fd, buffer, sizeof(buffer), 0);
+            if (n > 0) {
+                conn->in.append(buffer, static_cast<size_t>(n));
+                if (!processRequests(conn)) return;
+            } else if (n == 0) {
+                conn->peer_closed = true;
+            } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return;
+            } else if (errno != EINTR) {
+                closeConnection(conn);
+                return;
+            }
+        }
+    }
+
+    // false면 연결을 닫았음
+    bool flushOutput(Connection* conn) {
+        while (conn->pendingOutput() > 0) {
+            ssize_t n = ::send(conn->fd, conn->out.data() + conn->out_offset, conn->pendingOutput(), MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+                closeConnection(conn);
+                return false;
+            }
+            conn->out_offset += static_cast<size_t>(n);
+        }
+        conn->out.clear();
+        conn->out_offset = 0;
+        return true;
+    }
+
+    // in에 있는 완성된 요청 프레임을 한 묶음으로 처리하고 응답을 out에 추가. false면 연결을 닫았음
+    bool processRequests(Connection* conn) {
+        items.clear();
+        size_t offset = 0;
+        for (;;) {
+            Item item;
+            size_t consumed = 0;
+            BinaryProtocol::ParseResult result =
+                BinaryProtocol::parseRequest(conn->in.data() + offset, conn->in.size() - offset, item.request, consumed);
+            if (result == BinaryProtocol::ParseResult::Incomplete) break;
+            if (result == BinaryProtocol::ParseResult::Error) {
+                MFA_LOG_DEBUG("BINARY", "잘못된 프레임으로 연결을 닫습니다: " << conn->peer);
+                closeConnection(conn);
+                return false;
+            }
+            items.push_back(item);
+            offset += consumed;
+        }
+        if (items.empty()) return true;
+
+        if (server.offload_pool && server.offload(items.data(), items.size())) {
+            conn->batch.swap(items);
+            conn->batch_bytes = offset;
+            conn->busy = true;
+            if (server.offload_pool->submit([this, conn]() { handleOffloaded(conn); })) {
+                return true;
+            }
+            conn->busy = false;             // 종료 중이라 작업 풀이 받지 않으면 여기서 처리
+            items.swap(conn->batch);
+        }
+        runHandler(items.data(), items.size(), conn->peer);
+        writeReplies(conn, items, offset);
+        return true;
+    }
+
+    void runHandler(Item* batch, size_t count, const std::string& peer) {
+        try {
+            server.handler(batch, count, peer);
+        } catch (const std::exception& e) {
+            MFA_LOG_ERROR("BINARY", "요청 처리 중 예외: " << e.what());
+        }
+    }
+
+    // 묶음의 응답을 out에 추가하고 그 요청 프레임(in 앞 consumed 바이트)을 버림
+    void writeReplies(Connection* conn, const std::vector<Item>& batch, size_t consumed) {
+        size_t base = conn->out.size();
+        conn->out.resize(base + batch.size() * BinaryProtocol::REPLY_FRAME_BYTES);
+        char* out = &conn->out[base];
+        for (const Item& item : batch) {
+            BinaryProtocol::writeReply(out, {item.request.request_id, item.status, item.retry_after});
+            out += BinaryProtocol::REPLY_FRAME_BYTES;
+        }
+        conn->in.erase(0, consumed);
+    }
+
+    // 작업 스레드에서 실행 (busy인 동안 리액터는 conn의 in과 batch를 건드리지 않음)
+    void handleOffloaded(Connection* conn) {
+        runHandler(conn->batch.data(), conn->batch.size(), conn->peer);
+        {
+            std::lock_guard<std::mutex> lock(completed_mutex);
+            completed.push_back(conn);
+        }
+        wake();
+    }
+
+    void completeOffloaded() {
+        std::vector<Connection*> done;
+        {
+            std::lock_guard<std::mutex> lock(completed_mutex);
+            done.swap(completed);
+        }
+        for (Connection* conn : done) {
+            conn->busy = false;
+            if (conn->closing) {
+                destroy(conn);
+                continue;
+            }
+            writeReplies(conn, conn->batch, conn->batch_bytes);
+            handleEvent(conn, 0);           // 응답을 보내고 기다리는 동안 온 프레임을 이어서 읽음
+        }
+    }
+
+    void closeConnection(Connection* conn) {
+        if (conn->prev) conn->prev->next = conn->next;
+        else head = conn->next;
+        if (conn->next) conn->next->prev = conn->prev;
+        conn->prev = conn->next = nullptr;
+        if (conn->busy) {
+            // 작업 스레드가 아직 연결 상태를 쓰므로 끝난 뒤(completeOffloaded) 정리
+            conn->closing = true;
+            return;
+        }
+        destroy(conn);
+    }
+
+    void destroy(Connection* conn) {
+        ::close(conn->fd);
+        delete conn;
+        server.open_connections.fetch_sub(1, std::memory_order_relaxed);
+    }
+};
+
+BinaryServer::BinaryServer(const Config& config, Handler handler, Offload offload)
+    : config(config), handler(std::move(handler)), offload(std::move(offload)) {
+    if (this->config.threads == 0) {
+        this->config.threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (this->offload && this->config.offload_threads > 0) {
+        offload_pool = std::make_unique<WorkerPool>(this->config.offload_threads);
+    }
+}
+
+BinaryServer::~BinaryServer() {
+    stop();
+}
+
+bool BinaryServer::listenTcp(const std::string& host, int port) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE | AI_NUMERICSERV;
+    addrinfo* result = nullptr;
+    std::string service = std::to_string(port);
+    if (getaddrinfo(host.empty() ? nullptr : host.c_str(), service.c_str(), &hints, &result) != 0) {
+        MFA_LOG_ERROR("BINARY", "주소를 해석할 수 없습니다: " << host);
+        return false;
+    }
+
+    int listen_fd = -1;
+    for (addrinfo* info = result; info && listen_fd < 0; info = info->ai_next) {
+        int fd = socket(info->ai_family, info->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, info->ai_protocol);
+        if (fd < 0) continue;
+        int yes = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+        if (::bind(fd, info->ai_addr, info->ai_addrlen) == 0 && ::listen(fd, config.listen_backlog) == 0) {
+            listen_fd = fd;
+        } else {
+            ::close(fd);
+        }
+    }
+    freeaddrinfo(result);
+    if (listen_fd < 0) {
+        MFA_LOG_ERROR("BINARY", "포트 " << port << "에 바인드할 수 없습니다: " << strerror(errno));
+        return false;
+    }
+
+    sockaddr_storage addr{};
+    socklen_t length = sizeof(addr);
+    getsockname(listen_fd, reinterpret_cast<sockaddr*>(&addr), &length);
+    tcp_port = addr.ss_family == AF_INET6 ? ntohs(reinterpret_cast<sockaddr_in6*>(&addr)->sin6_port)
+                                          : ntohs(reinterpret_cast<sockaddr_in*>(&addr)->sin_port);
+    listen_fds.push_back(listen_fd);
+    listen_unix.push_back(false);
+    return true;
+}
+
+bool BinaryServer::listenUnix(const std::string& path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        MFA_LOG_ERROR("BINARY", "Unix 소켓 경로가 비었거나 너무 깁니다: " << path);
+        return false;
+    }
+    path.copy(addr.sun_path, path.size());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+    ::unlink(path.c_str());             // 이전 실행이 남긴 소켓 파일
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(fd, config.listen_backlog) != 0) {
+        MFA_LOG_ERROR("BINARY", "Unix 소켓을 열 수 없습니다: " << path << ": " << strerror(errno));
+        ::close(fd);
+        return false;
+    }
+    unix_path = path;
+    listen_fds.push_back(fd);
+    listen_unix.push_back(true);
+    return true;
+}
+
+bool BinaryServer::start() {
+    if (listen_fds.empty() || !reactors.empty()) return false;
+
+    for (size_t i = 0; i < config.threads; i++) {
+        auto reactor = std::make_unique<Reactor>(*this);
+        if (!reactor->init()) {
+            MFA_LOG_ERROR("BINARY", "epoll 초기화 실패: " << strerror(errno));
+            reactors.clear();
+            return false;
+        }
+        reactors.push_back(std::move(reactor));
+    }
+    for (auto& reactor : reactors) {
+        Reactor* target = reactor.get();
+        threads.emplace_back([target]() { target->run(); });
+    }
+    return true;
+}
+
+void BinaryServer::stop() {
+    stopping.store(true, std::memory_order_release);
+    for (auto& reactor : reactors) reactor->wake();
+    for (auto& thread : threads) {
+        if (thread.joinable()) thread.join();
+    }
+    threads.clear();
+    // 남은 작업이 리액터에 완료를 넣을 수 있으므로 리액터보다 먼저 멈춤
+    if (offload_pool) offload_pool->shutdown();
+    reactors.clear();
+    for (int fd : listen_fds) ::close(fd);
+    listen_fds.clear();
+    listen_unix.clear();
+    if (!unix_path.empty()) {
+        ::unlink(unix_path.c_str());
+        unix_path.clear();
+    }
+}
@@ -0,0 +1,107 @@
+#ifndef BINARY_SERVER_H
+#define BINARY_SERVER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "binary_protocol.h"
+
+class WorkerPool;
+
+/**
+ * @brief 바이너리 검증 프로토콜 리스너 (TCP + Unix 도메인 소켓, epoll)
+ *
+ * EventServer와 같은 구조(리액터마다 epoll, 수신 소켓은 EPOLLEXCLUSIVE, 연결은 edge-triggered)이지만
+ * HTTP 대신 BinaryProtocol 프레임만 다룹니다. 한 번 읽은 바이트에 들어 있는 요청 프레임을 모두 꺼내
+ * 핸들러를 한 번만 부르므로, 파이프라이닝된 요청은 한 묶음으로 검증됩니다.
+ *
+ * - 리액터 스레드는 start()가 만들고 stop()/소멸자가 정리 (HTTP 리스너와 같이 돌기 위해 블로킹하지 않음)
+ * - 송신 대기 바이트가 max_pending_bytes를 넘으면 응답이 빠질 때까지 그 연결에서 읽지 않음
+ * - 연결은 상대가 닫을 때까지 유지 (쉬는 연결 비용은 소켓과 연결 상태 구조체뿐)
+ * - Offload가 고른 묶음(다른 노드의 응답을 기다리는 묶음 등)은 작업 스레드에서 핸들러를 부르고, 끝나면 리액터가
+ *   응답을 씀. 그동안 그 연결의 다음 프레임은 처리하지 않음
+ */
+class BinaryServer {
+public:
+    struct Config {
+        size_t threads = 1;                     // 리액터 스레드 수 (0이면 코어 수)
+        int listen_backlog = 128;
+        size_t max_pending_bytes = 256 * 1024;  // 연결별 송신 대기 상한 (넘으면 읽기 중단)
+        size_t offload_threads = 0;             // Offload가 고른 묶음을 처리할 작업 스레드 수 (0이면 모두 리액터에서)
+    };
+
+    /**
+     * @brief 요청 하나와 그 결과 (핸들러가 status/retry_after를 채움)
+     */
+    struct Item {
+        BinaryProtocol::Request request;
+        BinaryProtocol::Status status = BinaryProtocol::Status::ServerError;
+        uint16_t retry_after = 0;
+    };
+
+    /**
+     * @brief 한 연결에서 읽은 요청 묶음 처리 (리액터 스레드에서 호출)
+     * @param peer 시도 제한 키: TCP는 상대 IP, Unix 소켓은 "uid:<상대 프로세스 uid>"
+     */
+    using Handler = std::function<void(Item* items, size_t count, const std::string& peer)>;
+
+    /**
+     * @brief 묶음을 리액터 대신 작업 스레드에서 처리할지 (리액터 스레드에서 핸들러보다 먼저 호출, 가볍게)
+     */
+    using Offload = std::function<bool(const Item* items, size_t count)>;
+
+    BinaryServer(const Config& config, Handler handler, Offload offload = nullptr);
+    ~BinaryServer();
+
+    BinaryServer(const BinaryServer&) = delete;
+    BinaryServer& operator=(const BinaryServer&) = delete;
+
+    /**
+     * @brief TCP 수신 소켓 추가 (start() 전에 호출)
+     * @param port 0이면 임의 포트 (tcpPort()로 확인)
+     */
+    bool listenTcp(const std::string& host, int port);
+
+    /**
+     * @brief Unix 도메인 수신 소켓 추가 (이미 있는 소켓 파일은 지우고 만들며, 종료 시 지움)
+     */
+    bool listenUnix(const std::string& path);
+
+    /**
+     * @brief 리액터 스레드 시작 (바로 반환)
+     */
+    bool start();
+
+    /**
+     * @brief 리액터를 깨워 종료하고 스레드가 끝날 때까지 기다림 (모든 연결을 닫음)
+     */
+    void stop();
+
+    int tcpPort() const { return tcp_port; }
+    size_t connectionCount() const { return open_connections.load(std::memory_order_relaxed); }
+
+private:
+    class Reactor;
+    struct Connection;
+
+    Config config;
+    Handler handler;
+    Offload offload;
+    std::unique_ptr<WorkerPool> offload_pool;       // offload_threads가 0이면 없음
+    std::vector<int> listen_fds;
+    std::vector<bool> listen_unix;                  // listen_fds와 같은 순서
+    std::string unix_path;
+    int tcp_port = 0;
+    std::vector<std::unique_ptr<Reactor>> reactors;
+    std::vector<std::thread> threads;
+    std::atomic<bool> stopping{false};
+    std::atomic<size_t> open_connections{0};
+};
+
+#endif // BINARY_SERVER_H
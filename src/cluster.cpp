@@ -0,0 +1,1128 @@
+#include "cluster.h"
+#include "replication.h"
+#include "logger.h"
+#include "metrics.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <openssl/crypto.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+    constexpr size_t MAX_RESPONSE_HEADER_BYTES = 64 * 1024;
+    constexpr size_t MAX_RESPONSE_BODY_BYTES = 256 * 1024 * 1024;   // 목록 한 페이지(최대 10000명)보다 넉넉히
+    constexpr int DIRTY_FLUSH_ROUNDS = 3;       // 쓰기를 막기 전에 복사 중 바뀐 사용자를 다시 보내는 최대 횟수
+    constexpr int JOIN_RETRY_MS = 1000;
+    constexpr int COMMIT_RETRY_MS = 1000;
+
+    bool validNodeId(std::string_view id) {
+        if (id.empty() || id.size() > 64) return false;
+        for (char c : id) {
+            bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+                      c == '_' || c == '.' || c == '-';
+            if (!ok) return false;
+        }
+        return true;
+    }
+
+    bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); i++) {
+            char x = a[i];
+            char y = b[i];
+            if (x >= 'A' && x <= 'Z') x = static_cast<char>(x - 'A' + 'a');
+            if (y >= 'A' && y <= 'Z') y = static_cast<char>(y - 'A' + 'a');
+            if (x != y) return false;
+        }
+        return true;
+    }
+
+    std::string toHex(std::string_view bytes) {
+        static constexpr char DIGITS[] = "0123456789abcdef";
+        std::string hex;
+        hex.reserve(bytes.size() * 2);
+        for (unsigned char c : bytes) {
+            hex.push_back(DIGITS[c >> 4]);
+            hex.push_back(DIGITS[c & 0x0f]);
+        }
+        return hex;
+    }
+
+    std::string_view trim(std::string_view text) {
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+        while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) text.remove_suffix(1);
+        return text;
+    }
+
+    void setTimeouts(int fd, int milliseconds) {
+        timeval timeout{};
+        timeout.tv_sec = milliseconds / 1000;
+        timeout.tv_usec = (milliseconds % 1000) * 1000;
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));    // connect()에도 적용됨
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    }
+
+    bool sendAll(int fd, const std::string& data) {
+        size_t offset = 0;
+        while (offset < data.size()) {
+            ssize_t n = ::send(fd, data.data() + offset, data.size() - offset, MSG_NOSIGNAL);
+            if (n > 0) {
+                offset += static_cast<size_t>(n);
+            } else if (n < 0 && errno == EINTR) {
+                continue;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 읽은 바이트를 in에 추가, 상대가 닫았으면 0, 오류/시간 초과면 -1
+    int receiveSome(int fd, std::string& in) {
+        char buffer[64 * 1024];
+        for (;;) {
+            ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+            if (n > 0) {
+                in.append(buffer, static_cast<size_t>(n));
+                return 1;
+            }
+            if (n == 0) return 0;
+            if (errno == EINTR) continue;
+            return -1;
+        }
+    }
+
+    bool parseUnsigned(std::string_view text, uint64_t& value) {
+        if (text.empty() || text.size() > 20) return false;
+        value = 0;
+        for (char c : text) {
+            if (c < '0' || c > '9') return false;
+            value = value * 10 + static_cast<uint64_t>(c - '0');
+        }
+        return true;
+    }
+
+    std::vector<std::string_view> splitLines(std::string_view text) {
+        std::vector<std::string_view> lines;
+        while (!text.empty()) {
+            size_t end = text.find('\n');
+            std::string_view line = text.substr(0, end);
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            if (!line.empty()) lines.push_back(line);
+            if (end == std::string_view::npos) break;
+            text.remove_prefix(end + 1);
+        }
+        return lines;
+    }
+
+    std::vector<std::string_view> splitWords(std::string_view line) {
+        std::vector<std::string_view> words;
+        size_t start = 0;
+        while (start < line.size()) {
+            while (start < line.size() && line[start] == ' ') start++;
+            size_t end = line.find(' ', start);
+            if (end == std::string_view::npos) end = line.size();
+            if (end > start) words.push_back(line.substr(start, end - start));
+            start = end;
+        }
+        return words;
+    }
+
+    uint64_t millisecondsSince(uint64_t since_ns, uint64_t now_ns) {
+        return now_ns > since_ns ? (now_ns - since_ns) / 1000000 : 0;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// ClusterNode / HashRing
+// ---------------------------------------------------------------------------
+
+std::string ClusterNode::address() const {
+    if (host.find(':') != std::string::npos) {
+        return "[" + host + "]:" + std::to_string(port);
+    }
+    return host + ":" + std::to_string(port);
+}
+
+HashRing::HashRing(std::vector<ClusterNode> nodes, uint64_t version, size_t vnodes)
+    : members(std::move(nodes)), ring_version(version), virtual_nodes(vnodes == 0 ? 1 : vnodes) {
+    // 노드를 받은 순서와 무관하게 모든 노드가 같은 링을 만들도록 id 순으로 정렬
+    std::sort(members.begin(), members.end(), [](const ClusterNode& a, const ClusterNode& b) { return a.id < b.id; });
+    points.reserve(members.size() * virtual_nodes);
+    for (uint32_t i = 0; i < members.size(); i++) {
+        for (size_t v = 0; v < virtual_nodes; v++) {
+            points.emplace_back(hash(members[i].id + "#" + std::to_string(v)), i);
+        }
+    }
+    std::sort(points.begin(), points.end());
+
+    shares.assign(members.size(), 0.0);
+    if (points.size() == 1) {
+        shares[0] = 1.0;
+    } else {
+        for (size_t k = 0; k < points.size(); k++) {
+            uint64_t previous = points[k == 0 ? points.size() - 1 : k - 1].first;
+            shares[points[k].second] += static_cast<double>(points[k].first - previous) / 18446744073709551616.0;
+        }
+    }
+}
+
+uint64_t HashRing::hash(std::string_view key) {
+    // FNV-1a 뒤에 splitmix64 마무리 (짧고 비슷한 "id#i" 키도 링에 고르게 흩어지도록)
+    uint64_t h = 1469598103934665603ULL;
+    for (char c : key) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ULL;
+    }
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+const ClusterNode* HashRing::owner(std::string_view user_id) const {
+    if (points.empty()) return nullptr;
+    uint64_t h = hash(user_id);
+    auto it = std::lower_bound(points.begin(), points.end(), std::make_pair(h, uint32_t(0)));
+    if (it == points.end()) it = points.begin();
+    return &members[it->second];
+}
+
+const ClusterNode* HashRing::find(std::string_view node_id) const {
+    for (const ClusterNode& node : members) {
+        if (node.id == node_id) return &node;
+    }
+    return nullptr;
+}
+
+double HashRing::share(size_t index) const {
+    return index < shares.size() ? shares[index] : 0.0;
+}
+
+std::string HashRing::serialize() const {
+    std::string text = "ring " + std::to_string(ring_version) + " " + std::to_string(virtual_nodes) + "\n";
+    for (const ClusterNode& node : members) {
+        text += node.id + " " + node.host + " " + std::to_string(node.port) + "\n";
+    }
+    return text;
+}
+
+bool HashRing::parse(std::string_view text, HashRing& ring) {
+    std::vector<std::string_view> lines = splitLines(text);
+    if (lines.size() < 2) return false;
+    std::vector<std::string_view> header = splitWords(lines[0]);
+    uint64_t version = 0;
+    uint64_t vnodes = 0;
+    if (header.size() != 3 || header[0] != "ring" || !parseUnsigned(header[1], version) ||
+        !parseUnsigned(header[2], vnodes) || vnodes == 0 || vnodes > 4096) {
+        return false;
+    }
+    std::vector<ClusterNode> nodes;
+    for (size_t i = 1; i < lines.size(); i++) {
+        std::vector<std::string_view> words = splitWords(lines[i]);
+        uint64_t port = 0;
+        if (words.size() != 3 || !validNodeId(words[0]) || !parseUnsigned(words[2], port) || port == 0 || port > 65535) {
+            return false;
+        }
+        for (const ClusterNode& existing : nodes) {
+            if (existing.id == words[0]) return false;
+        }
+        nodes.push_back(ClusterNode{std::string(words[0]), std::string(words[1]), static_cast<int>(port)});
+    }
+    ring = HashRing(std::move(nodes), version, static_cast<size_t>(vnodes));
+    return true;
+}
+
+bool HashRing::parseNodes(std::string_view text, std::vector<ClusterNode>& nodes) {
+    nodes.clear();
+    while (!text.empty()) {
+        size_t end = text.find(',');
+        std::string_view entry = trim(text.substr(0, end));
+        text = end == std::string_view::npos ? std::string_view() : text.substr(end + 1);
+        if (entry.empty()) continue;
+
+        size_t equals = entry.find('=');
+        if (equals == std::string_view::npos) return false;
+        ClusterNode node;
+        node.id.assign(entry.substr(0, equals));
+        if (!validNodeId(node.id) || !ReplicationFollower::parseAddress(entry.substr(equals + 1), node.host, node.port)) {
+            return false;
+        }
+        for (const ClusterNode& existing : nodes) {
+            if (existing.id == node.id) return false;
+        }
+        nodes.push_back(std::move(node));
+    }
+    return !nodes.empty();
+}
+
+// ---------------------------------------------------------------------------
+// PeerClient
+// ---------------------------------------------------------------------------
+
+std::string_view PeerClient::Response::header(std::string_view name) const {
+    for (const auto& [key, value] : headers) {
+        if (equalsIgnoreCase(key, name)) return value;
+    }
+    return {};
+}
+
+PeerClient::PeerClient(std::string_view key, int timeout_ms) : key_header(toHex(key)), timeout_ms(timeout_ms) {}
+
+PeerClient::~PeerClient() {
+    closeIdle();
+}
+
+void PeerClient::closeIdle() {
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    for (auto& [address, idle] : pool) {
+        for (const Idle& connection : idle) {
+            ::close(connection.fd);
+        }
+    }
+    pool.clear();
+}
+
+int PeerClient::take(const ClusterNode& node, bool& reused) {
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        auto it = pool.find(node.address());
+        if (it != pool.end()) {
+            uint64_t now = Metrics::nowNs();
+            while (!it->second.empty()) {
+                Idle connection = it->second.back();
+                it->second.pop_back();
+                if (millisecondsSince(connection.since_ns, now) < static_cast<uint64_t>(CLUSTER_IDLE_REUSE_MS)) {
+                    reused = true;
+                    return connection.fd;
+                }
+                ::close(connection.fd);
+            }
+        }
+    }
+    reused = false;
+    return connectTo(node);
+}
+
+void PeerClient::give(const ClusterNode& node, int fd) {
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    pool[node.address()].push_back(Idle{fd, Metrics::nowNs()});
+}
+
+int PeerClient::connectTo(const ClusterNode& node) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_NUMERICSERV;
+    addrinfo* result = nullptr;
+    std::string service = std::to_string(node.port);
+    if (getaddrinfo(node.host.c_str(), service.c_str(), &hints, &result) != 0) {
+        errno = EHOSTUNREACH;
+        return -1;
+    }
+
+    int fd = -1;
+    int last_errno = 0;
+    for (addrinfo* info = result; info && fd < 0; info = info->ai_next) {
+        int candidate = socket(info->ai_family, info->ai_socktype | SOCK_CLOEXEC, info->ai_protocol);
+        if (candidate < 0) continue;
+        setTimeouts(candidate, timeout_ms);
+        if (::connect(candidate, info->ai_addr, info->ai_addrlen) == 0) {
+            fd = candidate;
+        } else {
+            last_errno = errno;
+            ::close(candidate);
+        }
+    }
+    freeaddrinfo(result);
+    if (fd < 0) {
+        errno = last_errno;
+        return -1;
+    }
+    int yes = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+    return fd;
+}
+
+bool PeerClient::request(const ClusterNode& node, std::string_view method, std::string_view target,
+                         std::string_view content_type, std::string_view body, Response& response, bool forwarded) {
+    std::string request;
+    request.reserve(224 + key_header.size() + target.size() + body.size());
+    request.append(method).append(" ").append(target).append(" HTTP/1.1\r\nHost: ").append(node.address()).append("\r\n");
+    request.append(CLUSTER_KEY_HEADER).append(": ").append(key_header).append("\r\n");
+    if (forwarded) {
+        request.append(CLUSTER_FORWARDED_HEADER).append(": 1\r\n");
+    }
+    if (!content_type.empty()) {
+        request.append("Content-Type: ").append(content_type).append("\r\n");
+    }
+    request.append("Content-Length: ").append(std::to_string(body.size())).append("\r\n\r\n").append(body);
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        bool reused = false;
+        int fd = take(node, reused);
+        if (fd < 0) return false;
+
+        response = Response{};
+        bool keep_alive = false;
+        bool received_any = false;
+        if (exchange(fd, request, response, keep_alive, received_any)) {
+            if (keep_alive) {
+                give(node, fd);
+            } else {
+                ::close(fd);
+            }
+            return true;
+        }
+        ::close(fd);
+        // 다시 쓴 연결이 응답 전에 끊겼으면 상대가 유휴 연결을 닫은 것이므로 새 연결로 한 번 더
+        if (!reused || received_any) return false;
+    }
+    return false;
+}
+
+bool PeerClient::exchange(int fd, const std::string& request, Response& response, bool& keep_alive, bool& received_any) {
+    keep_alive = false;
+    received_any = false;
+    if (!sendAll(fd, request)) return false;
+
+    std::string data;
+    size_t header_end;
+    while ((header_end = data.find("\r\n\r\n")) == std::string::npos) {
+        if (data.size() > MAX_RESPONSE_HEADER_BYTES || receiveSome(fd, data) <= 0) return false;
+        received_any = true;
+    }
+
+    // 상태 줄과 헤더
+    std::vector<std::string_view> lines = splitLines(std::string_view(data).substr(0, header_end));
+    if (lines.empty() || lines[0].size() < 12 || lines[0].substr(0, 5) != "HTTP/") return false;
+    bool http10 = lines[0].substr(0, 8) == "HTTP/1.0";
+    uint64_t status = 0;
+    if (!parseUnsigned(lines[0].substr(9, 3), status)) return false;
+    response.status = static_cast<int>(status);
+
+    uint64_t content_length = 0;
+    bool has_length = false;
+    bool chunked = false;
+    keep_alive = !http10;
+    for (size_t i = 1; i < lines.size(); i++) {
+        size_t colon = lines[i].find(':');
+        if (colon == std::string_view::npos) continue;
+        std::string_view name = trim(lines[i].substr(0, colon));
+        std::string_view value = trim(lines[i].substr(colon + 1));
+        if (equalsIgnoreCase(name, "Content-Length")) {
+            if (!parseUnsigned(value, content_length) || content_length > MAX_RESPONSE_BODY_BYTES) return false;
+            has_length = true;
+        } else if (equalsIgnoreCase(name, "Transfer-Encoding")) {
+            chunked = equalsIgnoreCase(value, "chunked");
+        } else if (equalsIgnoreCase(name, "Connection")) {
+            keep_alive = equalsIgnoreCase(value, "keep-alive") || (!http10 && !equalsIgnoreCase(value, "close"));
+        }
+        response.headers.emplace_back(std::string(name), std::string(value));
+    }
+
+    size_t pos = header_end + 4;
+    if (chunked) {
+        auto readLine = [&](std::string& line) {
+            size_t eol;
+            while ((eol = data.find("\r\n", pos)) == std::string::npos) {
+                if (data.size() - pos > 1024 || receiveSome(fd, data) <= 0) return false;
+            }
+            line.assign(data, pos, eol - pos);
+            pos = eol + 2;
+            return true;
+        };
+        std::string line;
+        for (;;) {
+            if (!readLine(line)) return false;
+            char* end = nullptr;
+            unsigned long long size = std::strtoull(line.c_str(), &end, 16);
+            if (end == line.c_str()) return false;
+            if (size == 0) {
+                // 트레일러 (쓰지 않음) 뒤 빈 줄까지
+                do {
+                    if (!readLine(line)) return false;
+                } while (!line.empty());
+                break;
+            }
+            if (response.body.size() + size > MAX_RESPONSE_BODY_BYTES) return false;
+            while (data.size() - pos < size + 2) {
+                if (receiveSome(fd, data) <= 0) return false;
+            }
+            response.body.append(data, pos, size);
+            pos += size + 2;
+            if (pos > 1024 * 1024) {
+                data.erase(0, pos);
+                pos = 0;
+            }
+        }
+        return true;
+    }
+
+    response.body.assign(data, pos, std::string::npos);
+    if (has_length) {
+        while (response.body.size() < content_length) {
+            if (receiveSome(fd, response.body) <= 0) return false;
+        }
+        response.body.resize(content_length);
+        return true;
+    }
+    if (response.status == 204 || response.status == 304) {
+        return true;
+    }
+    // 길이가 없으면 상대가 닫을 때까지가 본문
+    keep_alive = false;
+    for (;;) {
+        if (response.body.size() > MAX_RESPONSE_BODY_BYTES) return false;
+        int result = receiveSome(fd, response.body);
+        if (result == 0) return true;
+        if (result < 0) return false;
+    }
+}
+
+void PeerClient::requestAll(std::vector<Call>& calls) {
+    auto run = [this](Call& call) {
+        call.ok = request(*call.node, call.method, call.target, call.content_type, call.body, call.response,
+                          call.forwarded);
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(calls.size() > 1 ? calls.size() - 1 : 0);
+    for (size_t i = 1; i < calls.size(); i++) {
+        workers.emplace_back(run, std::ref(calls[i]));
+    }
+    if (!calls.empty()) {
+        run(calls[0]);
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Cluster
+// ---------------------------------------------------------------------------
+
+bool Cluster::WriteGuard::moving(std::string_view user_id) const {
+    if (!pending || !cluster) return false;
+    const ClusterNode* from = ring->owner(user_id);
+    const ClusterNode* to = pending->owner(user_id);
+    return from && to && from->id == cluster->config.node_id && to->id != cluster->config.node_id;
+}
+
+bool Cluster::WriteGuard::blocked(std::string_view user_id) const {
+    return frozen && moving(user_id);
+}
+
+void Cluster::WriteGuard::changed(std::string_view user_id) {
+    if (!moving(user_id)) return;
+    std::lock_guard<std::mutex> lock(cluster->dirty_mutex);
+    cluster->dirty.emplace(user_id);
+}
+
+Cluster::Cluster(MFACore& core, const Config& config)
+    : core(core), config(config), peer_client(config.key) {
+    if (!config.node_id.empty()) {
+        for (const ClusterNode& node : config.nodes) {
+            if (node.id == config.node_id) self_node = node;
+        }
+    }
+    current = std::make_shared<const HashRing>(config.nodes, 1, config.vnodes);
+    current_version.store(1, std::memory_order_release);
+}
+
+Cluster::~Cluster() {
+    stop();
+}
+
+bool Cluster::authorized(std::string_view key_header) const {
+    const std::string& expected = peer_client.keyHeader();
+    return !expected.empty() && key_header.size() == expected.size() &&
+           CRYPTO_memcmp(key_header.data(), expected.data(), expected.size()) == 0;
+}
+
+bool Cluster::start() {
+    // 다른 노드가 더 새 링(또는 명령행과 다른 링)을 갖고 있으면 그것을 따름 (이 노드가 다시 시작했거나 새로 참여하는 경우)
+    std::shared_ptr<const HashRing> mine = ring();
+    std::shared_ptr<const HashRing> best;
+    for (const ClusterNode& node : config.nodes) {
+        if (node.id == config.node_id) continue;
+        HashRing fetched;
+        if (!fetchRing(node, fetched)) continue;
+        if (!best || fetched.version() > best->version()) {
+            best = std::make_shared<const HashRing>(std::move(fetched));
+        }
+    }
+    if (best && (best->version() != mine->version() || best->serialize() != mine->serialize())) {
+        adopt(best, true);
+        MFA_LOG_INFO("CLUSTER", "다른 노드의 링을 따릅니다 (버전 " << best->version() << ", 노드 " << best->nodes().size() << "개)");
+    }
+
+    if (self() && !ring()->find(config.node_id)) {
+        spawn([this] { requestJoin(); });
+    }
+    return true;
+}
+
+void Cluster::stop() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stopping.store(true, std::memory_order_release);
+    }
+    sleep_cv.notify_all();
+    std::vector<std::thread> running;
+    {
+        std::lock_guard<std::mutex> lock(threads_mutex);
+        running.swap(threads);
+    }
+    for (std::thread& thread : running) {
+        if (thread.joinable()) thread.join();
+    }
+    peer_client.closeIdle();
+}
+
+void Cluster::spawn(std::function<void()> task) {
+    std::lock_guard<std::mutex> lock(threads_mutex);
+    if (stopping.load(std::memory_order_acquire)) return;
+    threads.emplace_back(std::move(task));
+}
+
+bool Cluster::sleepFor(int milliseconds) {
+    std::unique_lock<std::mutex> lock(sleep_mutex);
+    sleep_cv.wait_for(lock, std::chrono::milliseconds(milliseconds),
+                      [this] { return stopping.load(std::memory_order_acquire); });
+    return !stopping.load(std::memory_order_acquire);
+}
+
+std::shared_ptr<const HashRing> Cluster::ring() const {
+    std::lock_guard<std::mutex> lock(ring_mutex);
+    return current;
+}
+
+uint64_t Cluster::ringVersion() const {
+    return current_version.load(std::memory_order_acquire);
+}
+
+bool Cluster::route(std::string_view user_id, ClusterNode& owner) const {
+    std::shared_ptr<const HashRing> snapshot = ring();
+    const ClusterNode* node = snapshot->owner(user_id);
+    if (!node || node->id == config.node_id) return false;
+    owner = *node;
+    return true;
+}
+
+bool Cluster::owns(std::string_view user_id) const {
+    if (config.node_id.empty()) return false;
+    std::lock_guard<std::mutex> lock(ring_mutex);
+    const ClusterNode* node = current->owner(user_id);
+    if (node && node->id == config.node_id) return true;
+    node = pending ? pending->owner(user_id) : nullptr;
+    return node && node->id == config.node_id;
+}
+
+bool Cluster::fetchRing(const ClusterNode& node, HashRing& fetched) {
+    PeerClient::Response response;
+    return peer_client.request(node, "GET", "/api/cluster/ring", {}, {}, response) &&
+           response.status == 200 && HashRing::parse(response.body, fetched);
+}
+
+void Cluster::noteRingVersion(const ClusterNode& from, uint64_t version) {
+    if (version <= ringVersion()) return;
+    HashRing fetched;
+    if (fetchRing(from, fetched)) {
+        adopt(std::make_shared<const HashRing>(std::move(fetched)), false);
+    }
+}
+
+void Cluster::adopt(std::shared_ptr<const HashRing> next, bool force) {
+    {
+        std::unique_lock<std::shared_mutex> gate(write_gate);
+        std::lock_guard<std::mutex> lock(ring_mutex);
+        if (!force && next->version() <= current->version()) return;
+        current = next;
+        current_version.store(next->version(), std::memory_order_release);
+        if (pending && pending->version() <= next->version()) {
+            // commit을 놓친 경우 (조정 노드가 다른 노드에 먼저 commit)
+            pending.reset();
+            frozen = false;
+            migration_state = MigrationState::Idle;
+        }
+    }
+    MFA_LOG_INFO("CLUSTER", "링 버전 " << next->version() << "으로 바뀌었습니다");
+    spawn([this] { dropForeignUsers(); });
+}
+
+Cluster::WriteGuard Cluster::guardWrites() {
+    // 재배치 여부와 관계없이 shared lock을 먼저 잡아, prepare가 pending을 정하는 순간과 겹친 쓰기가 없게 함
+    WriteGuard guard;
+    guard.cluster = this;
+    guard.lock = std::shared_lock<std::shared_mutex>(write_gate);
+    {
+        std::lock_guard<std::mutex> lock(ring_mutex);
+        guard.ring = current;
+        guard.pending = pending;
+    }
+    guard.frozen = frozen;
+    return guard;
+}
+
+bool Cluster::addNode(const ClusterNode& node, std::string& error) {
+    if (!validNodeId(node.id) || node.host.empty() || node.port <= 0 || node.port > 65535) {
+        error = "Invalid node";
+        return false;
+    }
+    if (config.node_id.empty()) {
+        error = "Router node cannot coordinate";
+        return false;
+    }
+
+    std::shared_ptr<const HashRing> next;
+    {
+        std::lock_guard<std::mutex> lock(ring_mutex);
+        const ClusterNode* existing = current->find(node.id);
+        if (existing) {
+            if (*existing == node) return true;   // 이미 참여함
+            error = "Node id already in use";
+            return false;
+        }
+        std::vector<ClusterNode> nodes = current->nodes();
+        nodes.push_back(node);
+        if (pending) {
+            // 조정 노드가 멈춰 남은 재배치와 같은 추가면 이어서 조정
+            HashRing expected(nodes, current->version() + 1, current->vnodes());
+            if (coordinating || pending->serialize() != expected.serialize()) {
+                error = "Rebalance in progress";
+                return false;
+            }
+            next = pending;
+        } else {
+            next = std::make_shared<const HashRing>(std::move(nodes), current->version() + 1, current->vnodes());
+        }
+        coordinating = true;
+        last_error.clear();
+    }
+    MFA_LOG_INFO("CLUSTER", "노드 추가 재배치를 시작합니다: " << node.id << " (" << node.address()
+                 << "), 링 버전 " << next->version());
+    spawn([this, next] { coordinate(next); });
+    return true;
+}
+
+void Cluster::requestJoin() {
+    std::string body = "{\"id\":\"" + config.node_id + "\",\"address\":\"" + self_node.address() + "\"}";
+    while (!stopping.load(std::memory_order_acquire)) {
+        std::shared_ptr<const HashRing> snapshot = ring();
+        if (snapshot->find(config.node_id)) return;
+        for (const ClusterNode& node : snapshot->nodes()) {
+            PeerClient::Response response;
+            if (!peer_client.request(node, "POST", "/api/cluster/nodes", "application/json", body, response)) continue;
+            if (response.status == 202) {
+                MFA_LOG_INFO("CLUSTER", node.id << " 노드에 참여를 요청했습니다");
+                return;
+            }
+            // 409면 진행 중인 재배치가 끝난 뒤 다시 요청
+            break;
+        }
+        if (!sleepFor(JOIN_RETRY_MS)) return;
+    }
+}
+
+bool Cluster::prepare(const HashRing& next, std::string& error) {
+    std::shared_ptr<const HashRing> target;
+    {
+        // write_gate를 먼저 잡아 pending이 바뀌는 순간 진행 중인 쓰기가 없게 함 (dirty 추적 누락 방지)
+        std::unique_lock<std::shared_mutex> gate(write_gate);
+        std::lock_guard<std::mutex> lock(ring_mutex);
+        if (pending) {
+            if (pending->version() == next.version() && pending->serialize() == next.serialize()) return true;
+            error = "Rebalance in progress";
+            return false;
+        }
+        if (next.version() <= current->version()) {
+            error = "Stale ring version";
+            return false;
+        }
+        target = std::make_shared<const HashRing>(next);
+        pending = target;
+        frozen = false;
+        migration_state = MigrationState::Copying;
+        moving_users = 0;
+        sent_users = 0;
+        last_error.clear();
+    }
+    {
+        std::lock_guard<std::mutex> lock(dirty_mutex);
+        dirty.clear();
+    }
+    spawn([this, target] { migrate(target); });
+    return true;
+}
+
+bool Cluster::stillPending(const std::shared_ptr<const HashRing>& next) const {
+    std::lock_guard<std::mutex> lock(ring_mutex);
+    return pending == next && !stopping.load(std::memory_order_acquire);
+}
+
+void Cluster::migrate(std::shared_ptr<const HashRing> next) {
+    std::shared_ptr<const HashRing> from = ring();
+    const std::string& self_id = config.node_id;
+
+    // 1. 옮겨 갈 사용자 복사
+    std::vector<WALRecord> records;
+    core.exportUsers([&](std::string_view user_id, std::string_view secret_base32) {
+        const ClusterNode* old_owner = from->owner(user_id);
+        const ClusterNode* new_owner = next->owner(user_id);
+        if (old_owner && new_owner && old_owner->id == self_id && new_owner->id != self_id) {
+            records.push_back(WALRecord{WALOp::Register, 0, std::string(user_id), std::string(secret_base32)});
+        }
+    });
+    {
+        std::lock_guard<std::mutex> lock(ring_mutex);
+        moving_users = records.size();
+    }
+    MFA_LOG_INFO("CLUSTER", "링 버전 " << next->version() << " 준비: 옮겨 갈 사용자 " << records.size() << "명");
+    if (!stillPending(next)) return;
+    if (!sendChanges(*next, records)) {
+        failMigration("Transfer failed");
+        return;
+    }
+    records.clear();
+    records.shrink_to_fit();
+
+    // 2. 복사 중 바뀐 사용자를 다시 보냄 (쓰기를 막는 시간을 줄이기 위해 막기 전에 몇 번)
+    for (int round = 0; round < DIRTY_FLUSH_ROUNDS; round++) {
+        if (!stillPending(next)) return;
+        {
+            std::lock_guard<std::mutex> lock(dirty_mutex);
+            if (dirty.empty()) break;
+        }
+        if (!flushDirty(*next)) {
+            failMigration("Transfer failed");
+            return;
+        }
+    }
+
+    // 3. 옮겨 갈 사용자의 쓰기를 막고(진행 중인 쓰기가 끝날 때까지 기다림) 마지막 변경을 보냄
+    {
+        std::unique_lock<std::shared_mutex> gate(write_gate);
+        std::lock_guard<std::mutex> lock(ring_mutex);
+        if (pending != next) return;
+        frozen = true;
+    }
+    if (!flushDirty(*next)) {
+        failMigration("Transfer failed");
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(ring_mutex);
+    if (pending == next && migration_state == MigrationState::Copying) {
+        migration_state = MigrationState::Ready;
+        MFA_LOG_INFO("CLUSTER", "링 버전 " << next->version() << " 복사 완료 (" << sent_users << "건 전송)");
+    }
+}
+
+bool Cluster::flushDirty(const HashRing& next) {
+    std::unordered_set<std::string> changed;
+    {
+        std::lock_guard<std::mutex> lock(dirty_mutex);
+        changed.swap(dirty);
+    }
+    if (changed.empty()) return true;
+
+    std::vector<WALRecord> records;
+    records.reserve(changed.size());
+    User user;
+    for (const std::string& user_id : changed) {
+        if (core.findUser(user_id, user)) {
+            records.push_back(WALRecord{WALOp::Register, 0, user_id, user.secret_base32});
+        } else {
+            records.push_back(WALRecord{WALOp::Delete, 0, user_id, {}});
+        }
+    }
+    if (sendChanges(next, records)) return true;
+
+    // 실패하면 다음 시도에서 다시 보내도록 되돌림
+    std::lock_guard<std::mutex> lock(dirty_mutex);
+    dirty.insert(changed.begin(), changed.end());
+    return false;
+}
+
+bool Cluster::sendChanges(const HashRing& next, const std::vector<WALRecord>& records) {
+    std::unordered_map<std::string, std::vector<const WALRecord*>> by_owner;
+    for (const WALRecord& record : records) {
+        const ClusterNode* owner = next.owner(record.user_id);
+        if (owner) by_owner[owner->id].push_back(&record);
+    }
+
+    for (const auto& [owner_id, items] : by_owner) {
+        const ClusterNode* owner = next.find(owner_id);
+        for (size_t start = 0; start < items.size(); start += CLUSTER_TRANSFER_BATCH) {
+            size_t end = std::min(items.size(), start + CLUSTER_TRANSFER_BATCH);
+            std::string body;
+            for (size_t i = start; i < end; i++) {
+                ClusterProtocol::putU8(body, static_cast<uint8_t>(items[i]->op));
+                ClusterProtocol::putString(body, items[i]->user_id);
+                ClusterProtocol::putString(body, items[i]->secret_base32);
+            }
+            PeerClient::Response response;
+            if (!peer_client.request(*owner, "POST", "/api/cluster/transfer", ClusterProtocol::CONTENT_TYPE, body, response) ||
+                response.status != 200) {
+                MFA_LOG_WARN("CLUSTER", owner_id << " 노드로 사용자를 옮기지 못했습니다 (상태 " << response.status << ")");
+                return false;
+            }
+            std::lock_guard<std::mutex> lock(ring_mutex);
+            sent_users += end - start;
+        }
+    }
+    return true;
+}
+
+bool Cluster::applyTransfer(std::string_view body) {
+    ClusterProtocol::Reader reader(body.data(), body.size());
+    std::vector<WALRecord> records;
+    while (!reader.atEnd()) {
+        WALRecord record;
+        uint8_t op = reader.u8();
+        record.user_id.assign(reader.str());
+        record.secret_base32.assign(reader.str());
+        if (!reader.ok() || (op != static_cast<uint8_t>(WALOp::Register) && op != static_cast<uint8_t>(WALOp::Delete)) ||
+            !MFACore::isValidUserId(record.user_id)) {
+            return false;
+        }
+        record.op = static_cast<WALOp>(op);
+        records.push_back(std::move(record));
+    }
+    return core.applyReplicated(records);
+}
+
+bool Cluster::commit(uint64_t version) {
+    {
+        std::unique_lock<std::shared_mutex> gate(write_gate);
+        std::lock_guard<std::mutex> lock(ring_mutex);
+        if (!pending || pending->version() != version) {
+            return current->version() >= version;     // 이미 반영한 commit을 다시 받은 경우
+        }
+        current = pending;
+        current_version.store(version, std::memory_order_release);
+        pending.reset();
+        frozen = false;
+        migration_state = MigrationState::Idle;
+    }
+    {
+        std::lock_guard<std::mutex> lock(dirty_mutex);
+        dirty.clear();
+    }
+    MFA_LOG_INFO("CLUSTER", "링 버전 " << version << " 반영");
+    spawn([this] { dropForeignUsers(); });
+    return true;
+}
+
+bool Cluster::abort(uint64_t version) {
+    {
+        std::unique_lock<std::shared_mutex> gate(write_gate);
+        std::lock_guard<std::mutex> lock(ring_mutex);
+        if (!pending || pending->version() != version) return true;
+        pending.reset();
+        frozen = false;
+        migration_state = MigrationState::Idle;
+    }
+    {
+        std::lock_guard<std::mutex> lock(dirty_mutex);
+        dirty.clear();
+    }
+    MFA_LOG_WARN("CLUSTER", "링 버전 " << version << " 재배치 취소");
+    // 새 주인으로서 받아 둔 복사본은 지움
+    spawn([this] { dropForeignUsers(); });
+    return true;
+}
+
+Cluster::MigrationState Cluster::migrationState(uint64_t& version) const {
+    std::lock_guard<std::mutex> lock(ring_mutex);
+    version = pending ? pending->version() : current->version();
+    return migration_state;
+}
+
+void Cluster::failMigration(const std::string& message) {
+    std::lock_guard<std::mutex> lock(ring_mutex);
+    if (!pending) return;
+    migration_state = MigrationState::Failed;
+    last_error = message;
+    MFA_LOG_ERROR("CLUSTER", "링 버전 " << pending->version() << " 재배치 실패: " << message);
+}
+
+bool Cluster::callMember(const ClusterNode& node, std::string_view method, std::string_view target,
+                         std::string_view body, PeerClient::Response& response) {
+    return peer_client.request(node, method, target, "text/plain", body, response);
+}
+
+void Cluster::coordinate(std::shared_ptr<const HashRing> next) {
+    const uint64_t version = next->version();
+    const std::string version_text = std::to_string(version);
+    auto finish = [this](const std::string& error) {
+        std::lock_guard<std::mutex> lock(ring_mutex);
+        coordinating = false;
+        if (!error.empty()) last_error = error;
+    };
+
+    // 1. prepare
+    std::string ring_text = next->serialize();
+    for (const ClusterNode& node : next->nodes()) {
+        std::string error;
+        bool ok;
+        if (node.id == config.node_id) {
+            ok = prepare(*next, error);
+        } else {
+            PeerClient::Response response;
+            ok = callMember(node, "POST", "/api/cluster/prepare", ring_text, response) && response.status == 200;
+            if (!ok) error = "prepare failed on " + node.id;
+        }
+        if (!ok) {
+            MFA_LOG_ERROR("CLUSTER", "재배치 준비 실패: " << error);
+            abortMembers(*next);
+            finish(error);
+            return;
+        }
+    }
+
+    // 2. 모든 노드가 복사를 마칠 때까지 기다림
+    uint64_t deadline = Metrics::nowNs() + uint64_t(CLUSTER_MIGRATION_TIMEOUT_SEC) * 1000000000ULL;
+    for (;;) {
+        bool all_ready = true;
+        std::string failure;
+        for (const ClusterNode& node : next->nodes()) {
+            MigrationState state;
+            uint64_t node_version = 0;
+            if (node.id == config.node_id) {
+                state = migrationState(node_version);
+            } else {
+                PeerClient::Response response;
+                if (!callMember(node, "GET", "/api/cluster/migration", {}, response) || response.status != 200) {
+                    all_ready = false;      // 잠시 응답이 없으면 다음 확인에서 다시
+                    continue;
+                }
+                std::vector<std::string_view> words = splitWords(trim(response.body.substr(0, response.body.find('\n'))));
+                if (words.size() != 2 || !parseUnsigned(words[1], node_version)) {
+                    failure = "bad migration state from " + node.id;
+                    break;
+                }
+                state = words[0] == "ready" ? MigrationState::Ready
+                      : words[0] == "copying" ? MigrationState::Copying
+                      : words[0] == "failed" ? MigrationState::Failed : MigrationState::Idle;
+            }
+            if (node_version != version || state == MigrationState::Failed || state == MigrationState::Idle) {
+                // 참여 노드가 다시 시작해 준비 상태를 잃었거나 복사에 실패
+                failure = "migration failed on " + node.id;
+                break;
+            }
+            if (state != MigrationState::Ready) all_ready = false;
+        }
+        if (failure.empty() && Metrics::nowNs() > deadline) failure = "migration timed out";
+        if (!failure.empty()) {
+            MFA_LOG_ERROR("CLUSTER", "재배치를 취소합니다: " << failure);
+            abortMembers(*next);
+            finish(failure);
+            return;
+        }
+        if (all_ready) break;
+        if (!sleepFor(CLUSTER_MIGRATION_POLL_MS)) {
+            finish({});
+            return;
+        }
+    }
+
+    // 3. commit (모두 준비된 뒤에는 취소하지 않고 반영될 때까지 다시 시도)
+    for (const ClusterNode& node : next->nodes()) {
+        if (node.id == config.node_id) continue;
+        for (;;) {
+            PeerClient::Response response;
+            if (callMember(node, "POST", "/api/cluster/commit", version_text, response) && response.status == 200) break;
+            MFA_LOG_WARN("CLUSTER", node.id << " 노드에 commit을 보내지 못했습니다 (다시 시도)");
+            if (!sleepFor(COMMIT_RETRY_MS)) {
+                finish({});
+                return;
+            }
+        }
+    }
+    commit(version);
+    MFA_LOG_INFO("CLUSTER", "재배치 완료: 링 버전 " << version << ", 노드 " << next->nodes().size() << "개");
+    finish({});
+}
+
+void Cluster::abortMembers(const HashRing& next) {
+    std::string version_text = std::to_string(next.version());
+    for (const ClusterNode& node : next.nodes()) {
+        if (node.id == config.node_id) {
+            abort(next.version());
+            continue;
+        }
+        PeerClient::Response response;
+        callMember(node, "POST", "/api/cluster/abort", version_text, response);
+    }
+}
+
+void Cluster::dropForeignUsers() {
+    if (config.node_id.empty()) return;
+    std::shared_ptr<const HashRing> snapshot;
+    std::shared_ptr<const HashRing> next;
+    {
+        std::lock_guard<std::mutex> lock(ring_mutex);
+        snapshot = current;
+        next = pending;
+    }
+    // 링에 아직 없는 노드(참여 전, 취소된 참여)가 들고 있는 사용자는 모두 지움 (다시 참여할 때 새로 받음)
+    std::vector<WALRecord> records;
+    core.exportUsers([&](std::string_view user_id, std::string_view) {
+        const ClusterNode* owner = snapshot->owner(user_id);
+        const ClusterNode* future = next ? next->owner(user_id) : nullptr;
+        if (owner && owner->id != config.node_id && !(future && future->id == config.node_id)) {
+            records.push_back(WALRecord{WALOp::Delete, 0, std::string(user_id), {}});
+        }
+    });
+    if (records.empty()) return;
+
+    size_t dropped = 0;
+    for (size_t start = 0; start < records.size(); start += CLUSTER_TRANSFER_BATCH) {
+        if (stopping.load(std::memory_order_acquire)) return;
+        // 사이에 링이 또 바뀌었으면 그 링 기준으로 다시 정리됨
+        if (ringVersion() != snapshot->version()) return;
+        size_t end = std::min(records.size(), start + CLUSTER_TRANSFER_BATCH);
+        std::vector<WALRecord> chunk(records.begin() + start, records.begin() + end);
+        if (!core.applyReplicated(chunk)) {
+            MFA_LOG_ERROR("CLUSTER", "맡지 않는 사용자를 지우지 못했습니다");
+            return;
+        }
+        dropped += chunk.size();
+    }
+    MFA_LOG_INFO("CLUSTER", "더 이상 맡지 않는 사용자 " << dropped << "명을 지웠습니다");
+}
+
+Cluster::Status Cluster::status() const {
+    Status result;
+    std::lock_guard<std::mutex> lock(ring_mutex);
+    result.ring = current;
+    result.pending = pending;
+    result.state = migration_state;
+    result.moving_users = moving_users;
+    result.sent_users = sent_users;
+    result.coordinating = coordinating;
+    result.last_error = last_error;
+    return result;
+}
+
+const char* Cluster::stateName(MigrationState state) {
+    switch (state) {
+        case MigrationState::Idle: return "idle";
+        case MigrationState::Copying: return "copying";
+        case MigrationState::Ready: return "ready";
+        case MigrationState::Failed: return "failed";
+    }
+    return "idle";
+}
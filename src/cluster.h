@@ -0,0 +1,367 @@
+#ifndef CLUSTER_H
+#define CLUSTER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "mfa_core.h"
+#include "replication_protocol.h"
+
+constexpr size_t DEFAULT_CLUSTER_VNODES = 128;          // 노드 하나가 링에 찍는 가상 노드 수
+constexpr int CLUSTER_REQUEST_TIMEOUT_MS = 5000;        // 노드 간 요청 하나의 송수신 제한 시간
+constexpr int CLUSTER_IDLE_REUSE_MS = 2000;             // 이보다 오래 쉰 풀 연결은 다시 쓰지 않음 (상대의 keep-alive 만료 전)
+constexpr size_t CLUSTER_TRANSFER_BATCH = 1024;         // 재배치 때 요청 하나로 옮기는 사용자 수
+constexpr int CLUSTER_MIGRATION_POLL_MS = 100;          // 조정 노드가 참여 노드의 복사 상태를 확인하는 주기
+constexpr int CLUSTER_MIGRATION_TIMEOUT_SEC = 3600;     // 참여 노드가 모두 준비될 때까지 기다리는 최대 시간
+constexpr char CLUSTER_RING_HEADER[] = "X-MFA-Ring";    // 내부 리스너 응답에 붙는 링 버전 (더 새 링을 알아채는 데 사용)
+constexpr char CLUSTER_KEY_HEADER[] = "X-MFA-Cluster-Key";  // 노드 간 요청마다 붙는 클러스터 키 (16진수)
+constexpr char CLUSTER_FORWARDED_HEADER[] = "X-MFA-Forwarded";  // 공개 API 요청을 주인 노드로 넘긴 것임을 표시
+constexpr size_t CLUSTER_MIN_KEY_BYTES = 32;
+
+/**
+ * @brief 클러스터 구성원 하나 (주소는 노드 간 요청을 받는 내부 리스너)
+ */
+struct ClusterNode {
+    std::string id;
+    std::string host;
+    int port = 0;
+
+    std::string address() const;
+    bool operator==(const ClusterNode& other) const { return id == other.id && host == other.host && port == other.port; }
+};
+
+/**
+ * @brief 일관 해시 링 (불변, 버전마다 새로 만듦)
+ *
+ * 노드마다 "id#i"(i < vnodes)의 해시를 링에 찍고, user_id의 해시에서 시계 방향으로 처음 만나는 점의
+ * 노드가 그 사용자를 맡습니다. 노드를 하나 더하면 기존 노드마다 약 1/(N+1)씩만 새 노드로 옮겨 갑니다.
+ */
+class HashRing {
+public:
+    HashRing() = default;
+    HashRing(std::vector<ClusterNode> nodes, uint64_t version, size_t vnodes);
+
+    /**
+     * @brief user_id를 맡은 노드 (노드가 없으면 nullptr)
+     */
+    const ClusterNode* owner(std::string_view user_id) const;
+
+    const ClusterNode* find(std::string_view node_id) const;
+    const std::vector<ClusterNode>& nodes() const { return members; }
+    uint64_t version() const { return ring_version; }
+    size_t vnodes() const { return virtual_nodes; }
+
+    /**
+     * @brief i번째 노드가 맡은 해시 공간 비율 (0~1, 분포 확인용)
+     */
+    double share(size_t index) const;
+
+    /**
+     * @brief 노드 간 교환용 텍스트 ("ring <버전> <vnodes>" 줄 뒤에 "<id> <host> <port>" 줄들)
+     */
+    std::string serialize() const;
+    static bool parse(std::string_view text, HashRing& ring);
+
+    /**
+     * @brief --cluster 값 해석 ("id=host:port,id=host:port,...")
+     */
+    static bool parseNodes(std::string_view text, std::vector<ClusterNode>& nodes);
+
+    static uint64_t hash(std::string_view key);
+
+private:
+    std::vector<ClusterNode> members;
+    std::vector<std::pair<uint64_t, uint32_t>> points;  // (해시, 노드 번호), 해시 순
+    std::vector<double> shares;                         // 노드별로 맡은 해시 공간 비율
+    uint64_t ring_version = 0;
+    size_t virtual_nodes = DEFAULT_CLUSTER_VNODES;
+};
+
+/**
+ * @brief 노드 간 HTTP/1.1 요청 (노드마다 keep-alive 연결을 풀에 두고 다시 씀)
+ *
+ * 여러 스레드가 함께 쓸 수 있으며, 연결 하나는 요청 하나가 끝날 때까지 그 스레드만 씁니다.
+ * 다시 쓴 연결이 응답 전에 닫혀 있으면(상대의 keep-alive 만료) 새 연결로 한 번 더 보냅니다.
+ */
+class PeerClient {
+public:
+    struct Response {
+        int status = 0;
+        std::vector<std::pair<std::string, std::string>> headers;
+        std::string body;
+
+        std::string_view header(std::string_view name) const;
+    };
+
+    struct Call {
+        const ClusterNode* node;
+        std::string method;
+        std::string target;
+        std::string content_type;
+        std::string body;
+        Response response;
+        bool ok = false;
+        bool forwarded = false;             // request()의 forwarded
+    };
+
+    /**
+     * @param key 요청마다 CLUSTER_KEY_HEADER로 붙일 클러스터 키 (원본 바이트)
+     */
+    explicit PeerClient(std::string_view key = {}, int timeout_ms = CLUSTER_REQUEST_TIMEOUT_MS);
+    ~PeerClient();
+
+    PeerClient(const PeerClient&) = delete;
+    PeerClient& operator=(const PeerClient&) = delete;
+
+    /**
+     * @brief 요청 하나를 보내고 응답을 받음
+     * @param forwarded 공개 API 요청을 주인 노드로 넘기는 것이면 true (CLUSTER_FORWARDED_HEADER를 붙임)
+     * @return 연결/송수신 실패면 false (HTTP 오류 상태는 true와 response.status로)
+     */
+    bool request(const ClusterNode& node, std::string_view method, std::string_view target,
+                 std::string_view content_type, std::string_view body, Response& response, bool forwarded = false);
+
+    /**
+     * @brief 여러 노드에 동시에 요청 (첫 요청은 호출 스레드에서, 나머지는 요청마다 스레드 하나)
+     */
+    void requestAll(std::vector<Call>& calls);
+
+    void closeIdle();
+
+    const std::string& keyHeader() const { return key_header; }
+
+private:
+    struct Idle {
+        int fd;
+        uint64_t since_ns;
+    };
+
+    std::string key_header;                 // 16진수로 바꾼 클러스터 키
+    int timeout_ms;
+    std::mutex pool_mutex;
+    std::unordered_map<std::string, std::vector<Idle>> pool;   // 주소별 쉬는 연결
+
+    int take(const ClusterNode& node, bool& reused);
+    void give(const ClusterNode& node, int fd);
+    int connectTo(const ClusterNode& node);
+    bool exchange(int fd, const std::string& request, Response& response, bool& keep_alive, bool& received_any);
+};
+
+/**
+ * @brief 내부 요청 본문 (길이를 앞에 둔 바이너리, 읽기는 ReplicationProtocol::FrameReader)
+ *
+ *   /api/cluster/transfer  요청: (u8 op | str user_id | str secret)...      응답: 없음
+ *   /api/cluster/verify    요청: (str user_id | str otp_code)...           응답: (u8 BinaryProtocol::Status | u16 retry_after)...
+ *   /api/cluster/import    요청: (str user_id | str secret)...             응답: (u8 ImportStatus)...
+ */
+namespace ClusterProtocol {
+    constexpr char CONTENT_TYPE[] = "application/octet-stream";
+
+    inline void putU8(std::string& out, uint8_t value) { out.push_back(static_cast<char>(value)); }
+
+    inline void putU16(std::string& out, uint16_t value) {
+        putU8(out, static_cast<uint8_t>(value >> 8));
+        putU8(out, static_cast<uint8_t>(value));
+    }
+
+    inline void putString(std::string& out, std::string_view value) {
+        size_t length = value.size() < 255 ? value.size() : 255;
+        putU8(out, static_cast<uint8_t>(length));
+        out.append(value.data(), length);
+    }
+
+    using Reader = ReplicationProtocol::FrameReader;
+}
+
+/**
+ * @brief 일관 해시 샤딩 (--cluster, --node-id)
+ *
+ * 모든 노드가 같은 링으로 user_id를 맡을 노드를 정하고, 맡지 않은 사용자의 요청은 그 노드의
+ * 내부 리스너로 넘깁니다 (어느 노드든 라우터 역할, --node-id 없이 라우터로만 둘 수도 있음).
+ * 내부 리스너로 온 요청은 다시 넘기지 않으므로 노드끼리 서로 기다리며 막히지 않습니다.
+ *
+ * 노드 추가(재배치)는 받은 노드가 조정합니다:
+ *   1. prepare: 모든 노드에 새 링을 보내면, 각 노드는 옮겨 갈 사용자를 새 주인에게 복사하고
+ *      복사 중 바뀐 사용자는 다시 보낸 뒤, 옮겨 갈 사용자의 쓰기를 잠시 막고(503) 마지막 변경을 보냄
+ *   2. 모두 준비되면 commit: 각 노드가 새 링으로 바꾸고 더 이상 맡지 않는 사용자를 지움
+ * 복사가 끝날 때까지 요청은 이전 링으로 처리되며, 막히는 것은 준비 후 commit까지 옮겨 가는 사용자의 쓰기뿐입니다.
+ * 링은 메모리에만 두므로 다시 시작한 노드는 --cluster의 노드들에게 더 새 링을 물어 따릅니다.
+ */
+class Cluster {
+public:
+    struct Config {
+        std::string node_id;                // 비우면 사용자를 맡지 않는 라우터
+        std::vector<ClusterNode> nodes;     // 시작 링 (자기 자신 포함)
+        size_t vnodes = DEFAULT_CLUSTER_VNODES;
+        std::string key;                    // 노드끼리 나눠 가진 클러스터 키 (CLUSTER_MIN_KEY_BYTES 이상)
+    };
+
+    enum class MigrationState : uint8_t {
+        Idle,
+        Copying,        // 옮겨 갈 사용자를 새 주인에게 복사하는 중
+        Ready,          // 복사 완료, 옮겨 갈 사용자의 쓰기를 막고 commit을 기다림
+        Failed
+    };
+
+    struct Status {
+        std::shared_ptr<const HashRing> ring;
+        std::shared_ptr<const HashRing> pending;    // 재배치 중일 때만
+        MigrationState state = MigrationState::Idle;
+        size_t moving_users = 0;                    // 이번 재배치로 이 노드에서 옮겨 가는 사용자 수
+        size_t sent_users = 0;                      // 그중 보낸 수 (다시 보낸 변경 포함)
+        bool coordinating = false;                  // 이 노드가 재배치를 조정하는 중
+        std::string last_error;
+    };
+
+    /**
+     * @brief 쓰기(등록/삭제) 중 재배치와의 경계 (재배치 중이면 shared lock을 잡음)
+     *
+     * 옮겨 갈 사용자의 쓰기는 changed()로 알려 새 주인에게 다시 보내게 하고,
+     * blocked()면(복사가 끝나 commit을 기다리는 중) 쓰지 않고 503으로 응답해야 합니다.
+     */
+    class WriteGuard {
+    public:
+        WriteGuard() = default;
+        bool blocked(std::string_view user_id) const;
+        void changed(std::string_view user_id);
+
+    private:
+        friend class Cluster;
+        Cluster* cluster = nullptr;
+        std::shared_ptr<const HashRing> ring;
+        std::shared_ptr<const HashRing> pending;
+        std::shared_lock<std::shared_mutex> lock;
+        bool frozen = false;
+
+        bool moving(std::string_view user_id) const;
+    };
+
+    /**
+     * @brief core는 Cluster보다 오래 살아 있어야 함 (스레드는 stop()에서 정리)
+     */
+    Cluster(MFACore& core, const Config& config);
+    ~Cluster();
+
+    Cluster(const Cluster&) = delete;
+    Cluster& operator=(const Cluster&) = delete;
+
+    /**
+     * @brief 다른 노드에게 더 새 링을 물어 따르고, 그 링에 자신이 없으면 참여를 요청 (내부 리스너를 연 뒤 호출)
+     */
+    bool start();
+    void stop();
+
+    const std::string& nodeId() const { return config.node_id; }
+
+    /**
+     * @brief 이 노드의 내부 리스너 주소 (라우터면 nullptr)
+     */
+    const ClusterNode* self() const { return self_node.id.empty() ? nullptr : &self_node; }
+
+    std::shared_ptr<const HashRing> ring() const;
+    uint64_t ringVersion() const;
+
+    /**
+     * @brief 현재 링에서 user_id를 다른 노드가 맡으면 owner에 담고 true
+     */
+    bool route(std::string_view user_id, ClusterNode& owner) const;
+
+    /**
+     * @brief 내부 요청으로 받은 사용자를 이 노드가 처리해도 되는지 (현재 링이나 재배치 중인 새 링의 주인)
+     */
+    bool owns(std::string_view user_id) const;
+
+    /**
+     * @brief 내부 리스너 응답의 링 버전이 더 새로우면 그 노드에게 링을 받아 따름
+     */
+    void noteRingVersion(const ClusterNode& from, uint64_t version);
+
+    WriteGuard guardWrites();
+
+    PeerClient& peers() { return peer_client; }
+
+    /**
+     * @brief 내부 리스너로 온 요청의 CLUSTER_KEY_HEADER 값이 이 노드의 클러스터 키와 같은지
+     */
+    bool authorized(std::string_view key_header) const;
+
+    /**
+     * @brief 노드 추가 재배치를 시작 (조정은 백그라운드 스레드, 바로 반환)
+     * @return 다른 재배치가 진행 중이거나 같은 id가 다른 주소로 있으면 false
+     */
+    bool addNode(const ClusterNode& node, std::string& error);
+
+    /**
+     * @brief 조정 노드가 보낸 새 링으로 복사 시작 (같은 링을 다시 받으면 그대로 성공)
+     */
+    bool prepare(const HashRing& next, std::string& error);
+    bool commit(uint64_t version);
+    bool abort(uint64_t version);
+    MigrationState migrationState(uint64_t& version) const;
+
+    /**
+     * @brief /api/cluster/transfer 본문 반영 (덮어쓰기/삭제라 같은 본문을 다시 받아도 결과가 같음)
+     */
+    bool applyTransfer(std::string_view body);
+
+    Status status() const;
+
+    static const char* stateName(MigrationState state);
+
+private:
+    MFACore& core;
+    Config config;
+    ClusterNode self_node;
+    PeerClient peer_client;
+    std::atomic<bool> stopping{false};
+
+    mutable std::mutex ring_mutex;
+    std::shared_ptr<const HashRing> current;
+    std::shared_ptr<const HashRing> pending;
+    std::atomic<uint64_t> current_version{0};
+    MigrationState migration_state = MigrationState::Idle;
+    size_t moving_users = 0;
+    size_t sent_users = 0;
+    bool coordinating = false;
+    std::string last_error;
+
+    std::shared_mutex write_gate;               // 쓰기(shared)와 옮겨 가는 사용자 쓰기 막기(unique) 사이
+    bool frozen = false;                        // write_gate를 잡고 읽고 씀
+    std::mutex dirty_mutex;
+    std::unordered_set<std::string> dirty;      // 복사 중 바뀐, 옮겨 가는 사용자
+
+    std::mutex threads_mutex;
+    std::vector<std::thread> threads;           // 복사/조정/정리/참여 스레드 (stop()에서 join)
+    std::mutex sleep_mutex;
+    std::condition_variable sleep_cv;
+
+    void spawn(std::function<void()> task);
+    bool sleepFor(int milliseconds);
+    void adopt(std::shared_ptr<const HashRing> ring, bool force);
+    bool fetchRing(const ClusterNode& node, HashRing& ring);
+    void requestJoin();
+    void migrate(std::shared_ptr<const HashRing> next);
+    bool sendChanges(const HashRing& next, const std::vector<WALRecord>& records);
+    bool flushDirty(const HashRing& next);
+    bool stillPending(const std::shared_ptr<const HashRing>& next) const;
+    void coordinate(std::shared_ptr<const HashRing> next);
+    bool callMember(const ClusterNode& node, std::string_view method, std::string_view target,
+                    std::string_view body, PeerClient::Response& response);
+    void abortMembers(const HashRing& next);
+    void dropForeignUsers();
+    void failMigration(const std::string& message);
+};
+
+#endif // CLUSTER_H
@@ -0,0 +1,108 @@
+#include "entropy_pool.h"
+#include <atomic>
+#include <cerrno>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <pthread.h>
+#include <openssl/crypto.h>
+#include <openssl/rand.h>
+#if __has_include(<sys/random.h>)
+#include <sys/random.h>
+#define MFA_HAVE_GETRANDOM 1
+#endif
+
+namespace {
+
+    // fork() 때마다 증가 (자식에서 물려받은 풀을 버리기 위함)
+    std::atomic<unsigned> fork_generation{0};
+
+    void onFork() {
+        fork_generation.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::atomic<bool> use_openssl{false};    // getrandom이 없는 커널이면 OpenSSL DRBG만 사용
+
+    bool systemFill(unsigned char* out, size_t size) {
+#ifdef MFA_HAVE_GETRANDOM
+        if (!use_openssl.load(std::memory_order_relaxed)) {
+            size_t filled = 0;
+            while (filled < size) {
+                ssize_t n = ::getrandom(out + filled, size - filled, 0);
+                if (n < 0 && errno == EINTR) continue;
+                if (n < 0) {
+                    if (errno != ENOSYS) return false;
+                    use_openssl.store(true, std::memory_order_relaxed);
+                    break;
+                }
+                filled += static_cast<size_t>(n);
+            }
+            if (filled == size) return true;
+        }
+#endif
+        // OpenSSL DRBG (fork 감지와 재시드는 OpenSSL이 처리)
+        while (size > 0) {
+            int n = static_cast<int>(size < INT_MAX ? size : INT_MAX);
+            if (RAND_bytes(out, n) != 1) return false;
+            out += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    struct Pool {
+        unsigned char buffer[Entropy::POOL_SIZE];
+        size_t pos = Entropy::POOL_SIZE;    // 다음에 넘겨줄 위치 (POOL_SIZE면 비어 있음)
+        unsigned generation = 0;
+
+        ~Pool() {
+            OPENSSL_cleanse(buffer, sizeof(buffer));
+        }
+    };
+
+    Pool& localPool() {
+        static pthread_once_t once = PTHREAD_ONCE_INIT;
+        pthread_once(&once, [] { pthread_atfork(nullptr, nullptr, onFork); });
+        thread_local Pool pool;
+        return pool;
+    }
+}
+
+namespace Entropy {
+
+    bool fill(unsigned char* out, size_t size) {
+        if (size >= POOL_SIZE) {
+            return systemFill(out, size);
+        }
+
+        Pool& pool = localPool();
+        unsigned generation = fork_generation.load(std::memory_order_relaxed);
+        if (pool.generation != generation) {
+            OPENSSL_cleanse(pool.buffer, sizeof(pool.buffer));
+            pool.pos = POOL_SIZE;
+            pool.generation = generation;
+        }
+
+        while (size > 0) {
+            if (pool.pos == POOL_SIZE) {
+                if (!systemFill(pool.buffer, POOL_SIZE)) return false;
+                pool.pos = 0;
+            }
+            size_t n = std::min(size, POOL_SIZE - pool.pos);
+            memcpy(out, pool.buffer + pool.pos, n);
+            // 넘겨준 바이트는 다시 나가거나 메모리에 남지 않도록 즉시 지움
+            OPENSSL_cleanse(pool.buffer + pool.pos, n);
+            pool.pos += n;
+            out += n;
+            size -= n;
+        }
+        return true;
+    }
+
+    const char* sourceName() {
+#ifdef MFA_HAVE_GETRANDOM
+        if (!use_openssl.load(std::memory_order_relaxed)) return "getrandom";
+#endif
+        return "openssl";
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef ENTROPY_POOL_H
+#define ENTROPY_POOL_H
+
+#include <cstddef>
+
+/**
+ * @brief 시크릿 생성용 스레드별 엔트로피 풀
+ *
+ * 스레드마다 POOL_SIZE 바이트 버퍼를 두고 비면 getrandom()(없으면 OpenSSL DRBG)으로
+ * 한 번에 채웁니다. 등록 한 번에 필요한 20바이트는 대부분 시스템 콜 없이 버퍼에서
+ * 복사되며, 넘겨준 바이트는 버퍼에서 바로 지웁니다.
+ * fork() 뒤 자식 프로세스는 부모와 같은 버퍼를 물려받으므로, pthread_atfork로 세대를
+ * 올려 자식의 모든 스레드가 다음 요청에서 버퍼를 버리고 다시 채우게 합니다.
+ * 암호학적으로 안전한 소스를 모두 쓸 수 없으면 실패하며, 약한 난수로 대체하지 않습니다.
+ */
+namespace Entropy {
+
+    constexpr size_t POOL_SIZE = 4096;
+
+    /**
+     * @brief 난수 바이트 채우기
+     * @param out 결과 버퍼
+     * @param size 바이트 수 (POOL_SIZE 이상이면 풀을 거치지 않고 직접 채움)
+     * @return 안전한 소스에서 채우지 못하면 false (out 내용은 정의되지 않음)
+     */
+    bool fill(unsigned char* out, size_t size);
+
+    /**
+     * @brief 풀을 채우는 소스 이름 ("getrandom", "openssl") - 벤치마크/로그용
+     */
+    const char* sourceName();
+}
+
+#endif // ENTROPY_POOL_H
@@ -0,0 +1,146 @@
+#include "epoch.h"
+#include <atomic>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace Epoch {
+
+    namespace {
+
+        constexpr uint64_t INACTIVE = 0;
+        constexpr size_t RECLAIM_THRESHOLD = 64;    // 이만큼 쌓이면 retire() 때 회수 시도
+
+        /**
+         * @brief 스레드별 읽기 상태 (스레드가 끝나면 다른 스레드가 재사용, 해제하지 않음)
+         */
+        struct Participant {
+            std::atomic<uint64_t> epoch{INACTIVE};  // 읽기 구간 진입 시점의 전역 에포크
+            std::atomic<bool> in_use{false};
+            Participant* next = nullptr;
+        };
+
+        struct Retired {
+            uint64_t epoch;
+            std::function<void()> deleter;
+        };
+
+        std::atomic<uint64_t> global_epoch{1};
+        std::atomic<Participant*> participants{nullptr};
+
+        std::mutex retire_mutex;
+        std::vector<Retired> retired;
+
+        Participant* acquireParticipant() {
+            // 종료된 스레드가 남긴 기록부터 재사용
+            for (Participant* p = participants.load(std::memory_order_acquire); p; p = p->next) {
+                bool expected = false;
+                if (!p->in_use.load(std::memory_order_relaxed) &&
+                    p->in_use.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                    return p;
+                }
+            }
+
+            Participant* p = new Participant();
+            p->in_use.store(true, std::memory_order_relaxed);
+            Participant* head = participants.load(std::memory_order_relaxed);
+            do {
+                p->next = head;
+            } while (!participants.compare_exchange_weak(head, p, std::memory_order_release,
+                                                         std::memory_order_relaxed));
+            return p;
+        }
+
+        struct LocalState {
+            Participant* participant = nullptr;
+            unsigned depth = 0;
+
+            ~LocalState() {
+                if (participant) {
+                    participant->epoch.store(INACTIVE, std::memory_order_release);
+                    participant->in_use.store(false, std::memory_order_release);
+                }
+            }
+        };
+
+        thread_local LocalState local;
+
+        /**
+         * @brief 진행 중인 읽기 구간 중 가장 오래된 에포크 (없으면 UINT64_MAX)
+         */
+        uint64_t oldestActiveEpoch() {
+            uint64_t oldest = UINT64_MAX;
+            for (Participant* p = participants.load(std::memory_order_acquire); p; p = p->next) {
+                uint64_t e = p->epoch.load(std::memory_order_acquire);
+                if (e != INACTIVE && e < oldest) {
+                    oldest = e;
+                }
+            }
+            return oldest;
+        }
+
+        // retire_mutex를 잡은 상태에서 호출
+        size_t reclaimLocked() {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            uint64_t oldest = oldestActiveEpoch();
+
+            // 떼어낸 시점 이후에 시작한 읽기 구간만 남아 있으면 해제해도 안전
+            std::vector<std::function<void()>> ready;
+            size_t kept = 0;
+            for (auto& item : retired) {
+                if (item.epoch < oldest) {
+                    ready.push_back(std::move(item.deleter));
+                } else {
+                    retired[kept++] = std::move(item);
+                }
+            }
+            retired.resize(kept);
+
+            for (auto& deleter : ready) {
+                deleter();
+            }
+            return kept;
+        }
+    }
+
+    Guard::Guard() {
+        if (local.depth++ > 0) {
+            return;
+        }
+        if (!local.participant) {
+            local.participant = acquireParticipant();
+        }
+
+        // 에포크 공개 후 펜스: 쓰기 쪽이 이 기록을 못 봤다면, 이후의 읽기는 떼어내기 이후 상태를 봄
+        local.participant->epoch.store(global_epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    Guard::~Guard() {
+        if (--local.depth == 0) {
+            local.participant->epoch.store(INACTIVE, std::memory_order_release);
+        }
+    }
+
+    void retire(std::function<void()> deleter) {
+        // 떼어내기(호출자의 저장)를 에포크 증가보다 먼저 보이게 함
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        uint64_t epoch = global_epoch.fetch_add(1, std::memory_order_acq_rel);
+
+        std::lock_guard<std::mutex> lock(retire_mutex);
+        retired.push_back({epoch, std::move(deleter)});
+        if (retired.size() >= RECLAIM_THRESHOLD) {
+            reclaimLocked();
+        }
+    }
+
+    size_t reclaim() {
+        std::lock_guard<std::mutex> lock(retire_mutex);
+        return reclaimLocked();
+    }
+
+    size_t pendingCount() {
+        std::lock_guard<std::mutex> lock(retire_mutex);
+        return retired.size();
+    }
+}
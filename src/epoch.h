@@ -0,0 +1,50 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include <cstdint>
+#include <functional>
+
+/**
+ * @brief 에포크 기반 메모리 회수 (RCU 방식)
+ *
+ * 읽기 쪽은 Epoch::Guard 범위 안에서 잠금 없이 공유 구조체를 읽고,
+ * 쓰기 쪽은 구조체에서 떼어낸 객체를 Epoch::retire()로 넘깁니다.
+ * 떼어내기 전에 시작한 읽기 구간이 모두 끝난 뒤에만 객체가 해제되므로
+ * 읽기 쪽은 대기나 재시도 없이 항상 유효한 메모리를 봅니다.
+ *
+ * 읽기 구간 진입/이탈 비용은 스레드 로컬 기록 한 번과 펜스 한 번입니다.
+ */
+namespace Epoch {
+
+    /**
+     * @brief 읽기 구간 (중첩 가능). 이 범위 안에서 얻은 포인터는 범위를 벗어나기 전까지 유효
+     */
+    class Guard {
+    public:
+        Guard();
+        ~Guard();
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+    };
+
+    /**
+     * @brief 공유 구조체에서 이미 떼어낸 객체의 해제를 예약
+     *
+     * 진행 중인 읽기 구간이 모두 끝난 뒤 deleter가 호출됩니다 (호출 스레드는 대기하지 않음).
+     */
+    void retire(std::function<void()> deleter);
+
+    /**
+     * @brief 안전해진 예약 객체를 지금 해제
+     * @return 아직 해제되지 않고 남은 객체 수
+     */
+    size_t reclaim();
+
+    /**
+     * @brief 해제 대기 중인 객체 수
+     */
+    size_t pendingCount();
+}
+
+#endif // EPOCH_H
@@ -0,0 +1,1089 @@
+#include "event_server.h"
+#include "logger.h"
+#include "worker_pool.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <mutex>
+#include <string_view>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+
+namespace {
+
+    constexpr int MAX_EVENTS = 256;
+    constexpr int ACCEPT_BATCH = 64;                     // 한 번 깨어났을 때 최대 수락 수 (다른 리액터에도 기회를 줌)
+    constexpr size_t READ_CHUNK = 16 * 1024;
+    constexpr size_t OUTPUT_HIGH_WATER = 64 * 1024;      // 송신 대기 바이트가 이만큼 쌓이면 읽기/스트림 생성을 멈춤
+    constexpr int SWEEP_INTERVAL_MS = 1000;              // 시간 초과 연결 정리 주기
+
+    uint64_t nowMs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    const char* statusMessage(int status) {
+        switch (status) {
+            case 100: return "Continue";
+            case 200: return "OK";
+            case 201: return "Created";
+            case 204: return "No Content";
+            case 307: return "Temporary Redirect";
+            case 400: return "Bad Request";
+            case 401: return "Unauthorized";
+            case 403: return "Forbidden";
+            case 404: return "Not Found";
+            case 405: return "Method Not Allowed";
+            case 408: return "Request Timeout";
+            case 409: return "Conflict";
+            case 413: return "Payload Too Large";
+            case 415: return "Unsupported Media Type";
+            case 429: return "Too Many Requests";
+            case 431: return "Request Header Fields Too Large";
+            case 500: return "Internal Server Error";
+            case 501: return "Not Implemented";
+            case 503: return "Service Unavailable";
+            case 505: return "HTTP Version Not Supported";
+            default: return status < 400 ? "OK" : (status < 500 ? "Bad Request" : "Internal Server Error");
+        }
+    }
+
+    bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); i++) {
+            char x = a[i] >= 'A' && a[i] <= 'Z' ? static_cast<char>(a[i] + 32) : a[i];
+            char y = b[i] >= 'A' && b[i] <= 'Z' ? static_cast<char>(b[i] + 32) : b[i];
+            if (x != y) return false;
+        }
+        return true;
+    }
+
+    std::string_view trim(std::string_view text) {
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+        while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) text.remove_suffix(1);
+        return text;
+    }
+
+    int hexDigit(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    // %XX 디코딩 (쿼리 문자열이면 '+'도 공백으로)
+    std::string decodeURL(std::string_view text, bool query) {
+        std::string out;
+        out.reserve(text.size());
+        for (size_t i = 0; i < text.size(); i++) {
+            char c = text[i];
+            if (c == '%' && i + 2 < text.size() && hexDigit(text[i + 1]) >= 0 && hexDigit(text[i + 2]) >= 0) {
+                out += static_cast<char>(hexDigit(text[i + 1]) * 16 + hexDigit(text[i + 2]));
+                i += 2;
+            } else if (c == '+' && query) {
+                out += ' ';
+            } else {
+                out += c;
+            }
+        }
+        return out;
+    }
+
+    void parseQuery(std::string_view query, httplib::Params& params) {
+        while (!query.empty()) {
+            size_t amp = query.find('&');
+            std::string_view pair = query.substr(0, amp);
+            query = amp == std::string_view::npos ? std::string_view() : query.substr(amp + 1);
+            if (pair.empty()) continue;
+            size_t eq = pair.find('=');
+            std::string key = decodeURL(pair.substr(0, eq), true);
+            std::string value = eq == std::string_view::npos ? std::string() : decodeURL(pair.substr(eq + 1), true);
+            params.emplace(std::move(key), std::move(value));
+        }
+    }
+
+    void appendHex(std::string& out, size_t value) {
+        char digits[2 * sizeof(size_t)];
+        auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value, 16);
+        (void)ec;
+        out.append(digits, end);
+    }
+
+    void appendNumber(std::string& out, size_t value) {
+        char digits[24];
+        auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+        (void)ec;
+        out.append(digits, end);
+    }
+}
+
+/**
+ * @brief 연결 하나의 상태 (리액터 스레드만 접근)
+ */
+struct EventServer::Connection {
+    // 청크 인코딩 요청 본문 해석 단계
+    enum class ChunkState { Size, Data, DataEnd, Trailer, Done };
+
+    int fd = -1;
+    SSL* ssl = nullptr;
+    bool handshake_done = true;
+    std::string remote_addr;
+    int remote_port = 0;
+
+    std::string in;                     // 받았지만 아직 처리하지 않은 바이트
+    size_t header_scan = 0;             // 헤더 끝("\r\n\r\n")을 이어서 찾을 위치
+    bool headers_parsed = false;
+    size_t header_length = 0;           // in에서 본문이 시작하는 위치
+    size_t content_length = 0;
+    bool chunked_body = false;
+    ChunkState chunk_state = ChunkState::Size;
+    size_t chunk_remaining = 0;
+    size_t body_scan = 0;               // 청크 본문을 이어서 해석할 위치 (in 기준)
+    bool keep_alive = false;
+    bool sent_continue = false;
+    httplib::Request request;
+
+    std::string out;                    // 보낼 바이트
+    size_t out_offset = 0;
+    httplib::ContentProvider provider;  // 진행 중인 스트리밍 응답
+    httplib::ContentProviderResourceReleaser releaser;
+    size_t provider_offset = 0;
+    size_t provider_length = 0;
+    bool provider_chunked = false;
+    bool provider_done = false;
+    bool close_after_write = false;
+    bool read_paused = false;           // 송신 대기/스트리밍/종료 예정이라 입력 처리를 미룸
+    bool busy = false;                  // 작업 스레드가 이 연결의 요청이나 스트림을 처리 중
+    bool closing = false;               // busy 중에 닫힘 (작업이 끝나면 정리)
+    bool stream_on_worker = false;      // 작업 스레드에서 처리한 요청의 스트림 (다음 부분도 작업 스레드에서 생성)
+
+    size_t requests = 0;
+    uint64_t last_active_ms = 0;
+    Connection* prev = nullptr;         // 리액터의 활동 순서 목록 (앞이 가장 오래 쉼)
+    Connection* next = nullptr;
+
+    size_t pendingOutput() const { return out.size() - out_offset; }
+
+    void resetRequest() {
+        request = httplib::Request();
+        request.remote_addr = remote_addr;
+        request.remote_port = remote_port;
+        header_scan = 0;
+        headers_parsed = false;
+        header_length = 0;
+        content_length = 0;
+        chunked_body = false;
+        chunk_state = ChunkState::Size;
+        chunk_remaining = 0;
+        body_scan = 0;
+        keep_alive = false;
+        sent_continue = false;
+    }
+};
+
+/**
+ * @brief epoll 인스턴스 하나와 그 위의 연결들을 돌리는 이벤트 루프
+ */
+class EventServer::Reactor {
+public:
+    explicit Reactor(EventServer& owner) : server(owner) {}
+
+    ~Reactor() {
+        while (head) closeConnection(head);
+        // 작업 풀은 이미 멈췄으므로 남은 완료는 닫힌 연결뿐
+        for (Completion& done : completed) {
+            if (done.conn->closing) destroy(done.conn);
+        }
+        if (epoll_fd >= 0) ::close(epoll_fd);
+        if (wake_fd >= 0) ::close(wake_fd);
+        if (spare_fd >= 0) ::close(spare_fd);
+    }
+
+    bool init() {
+        epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        spare_fd = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+        if (epoll_fd < 0 || wake_fd < 0) return false;
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLEXCLUSIVE;
+        event.data.ptr = &listen_tag;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, server.listen_fd, &event) != 0) return false;
+
+        event.events = EPOLLIN;
+        event.data.ptr = &wake_tag;
+        return epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &event) == 0;
+    }
+
+    void wake() {
+        uint64_t one = 1;
+        ssize_t written = ::write(wake_fd, &one, sizeof(one));
+        (void)written;
+    }
+
+    void run() {
+        epoll_event events[MAX_EVENTS];
+        uint64_t last_sweep = nowMs();
+        while (!server.stopping.load(std::memory_order_acquire)) {
+            int count = epoll_wait(epoll_fd, events, MAX_EVENTS, SWEEP_INTERVAL_MS);
+            if (count < 0 && errno != EINTR) {
+                MFA_LOG_ERROR("EVENT", "epoll_wait 실패: " << strerror(errno));
+                break;
+            }
+            now_ms = nowMs();
+            bool woken = false;
+            for (int i = 0; i < count; i++) {
+                void* tag = events[i].data.ptr;
+                if (tag == &listen_tag) {
+                    acceptConnections();
+                } else if (tag == &wake_tag) {
+                    uint64_t value = 0;
+                    ssize_t n = ::read(wake_fd, &value, sizeof(value));
+                    (void)n;
+                    woken = true;
+                } else {
+                    handleEvent(static_cast<Connection*>(tag), events[i].events);
+                }
+            }
+            // 이번에 받은 이벤트를 다 처리한 뒤 정리해야 같은 묶음의 이벤트가 지운 연결을 가리키지 않음
+            if (woken) completeOffloaded();
+            if (now_ms - last_sweep >= SWEEP_INTERVAL_MS) {
+                closeExpired();
+                last_sweep = now_ms;
+            }
+        }
+        while (head) closeConnection(head);
+    }
+
+private:
+    // 작업 스레드가 끝낸 요청의 응답 또는 스트림 다음 부분
+    struct Completion {
+        Connection* conn = nullptr;
+        httplib::Response res;
+        std::string data;
+        bool stream = false;
+        bool ok = true;
+    };
+
+    EventServer& server;
+    int epoll_fd = -1;
+    int wake_fd = -1;
+    int spare_fd = -1;                  // fd가 바닥났을 때 대기 연결을 받아 바로 닫는 데 쓰는 예비 fd
+    char listen_tag = 0;
+    char wake_tag = 0;
+    uint64_t now_ms = 0;
+    Connection* head = nullptr;
+    Connection* tail = nullptr;
+    std::mutex completed_mutex;
+    std::vector<Completion> completed;  // 작업 스레드가 넣고 리액터가 꺼냄
+
+    void acceptConnections() {
+        for (int i = 0; i < ACCEPT_BATCH; i++) {
+            sockaddr_storage addr{};
+            socklen_t length = sizeof(addr);
+            int fd = accept4(server.listen_fd, reinterpret_cast<sockaddr*>(&addr), &length,
+                             SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) continue;
+                if ((errno == EMFILE || errno == ENFILE) && spare_fd >= 0) {
+                    // 받지 못한 연결이 남아 있으면 수신 소켓이 계속 깨어나므로 하나 받아 바로 닫음
+                    ::close(spare_fd);
+                    int dropped = accept4(server.listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+                    if (dropped >= 0) ::close(dropped);
+                    spare_fd = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+                    MFA_LOG_WARN("EVENT", "열 수 있는 파일 수 한도에 도달해 연결을 거절했습니다.");
+                }
+                return;
+            }
+
+            if (server.config.tcp_nodelay) {
+                int yes = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+            }
+
+            Connection* conn = new Connection();
+            conn->fd = fd;
+            char host[INET6_ADDRSTRLEN] = {0};
+            if (addr.ss_family == AF_INET) {
+                auto* in4 = reinterpret_cast<sockaddr_in*>(&addr);
+                inet_ntop(AF_INET, &in4->sin_addr, host, sizeof(host));
+                conn->remote_port = ntohs(in4->sin_port);
+            } else if (addr.ss_family == AF_INET6) {
+                auto* in6 = reinterpret_cast<sockaddr_in6*>(&addr);
+                inet_ntop(AF_INET6, &in6->sin6_addr, host, sizeof(host));
+                conn->remote_port = ntohs(in6->sin6_port);
+            }
+            conn->remote_addr = host;
+            conn->resetRequest();
+
+            if (server.ssl_ctx) {
+                conn->ssl = SSL_new(server.ssl_ctx);
+                if (!conn->ssl || SSL_set_fd(conn->ssl, fd) != 1) {
+                    if (conn->ssl) SSL_free(conn->ssl);
+                    ::close(fd);
+                    delete conn;
+                    continue;
+                }
+                SSL_set_accept_state(conn->ssl);
+                conn->handshake_done = false;
+            }
+
+            conn->last_active_ms = now_ms;
+            append(conn);
+            server.open_connections.fetch_add(1, std::memory_order_relaxed);
+
+            epoll_event event{};
+            event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+            event.data.ptr = conn;
+            if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+                closeConnection(conn);
+            }
+        }
+    }
+
+    void handleEvent(Connection* conn, uint32_t events) {
+        if (conn->closing) return;
+        if (events & EPOLLERR) {
+            closeConnection(conn);
+            return;
+        }
+        if (!conn->handshake_done) {
+            int result = handshake(conn);
+            if (result < 0) {
+                closeConnection(conn);
+                return;
+            }
+            if (result == 0) return;
+        }
+        if (!readInput(conn)) return;
+        flushOutput(conn);
+    }
+
+    // 1: 완료, 0: 더 기다림, -1: 실패
+    int handshake(Connection* conn) {
+        ERR_clear_error();
+        int result = SSL_do_handshake(conn->ssl);
+        if (result == 1) {
+            conn->handshake_done = true;
+            touch(conn);
+            return 1;
+        }
+        int error = SSL_get_error(conn->ssl, result);
+        if (error == SSL_ERROR_WANT_READ || error == SSL_ERROR_WANT_WRITE) return 0;
+        ERR_clear_error();
+        return -1;
+    }
+
+    // 받은 바이트 수, 0: 상대가 닫음, -1: 지금은 없음, -2: 오류
+    ssize_t receive(Connection* conn, char* buffer, size_t size) {
+        if (conn->ssl) {
+            ERR_clear_error();
+            int n = SSL_read(conn->ssl, buffer, static_cast<int>(size));
+            if (n > 0) return n;
+            int error = SSL_get_error(conn->ssl, n);
+            if (error == SSL_ERROR_WANT_READ || error == SSL_ERROR_WANT_WRITE) return -1;
+            if (error == SSL_ERROR_ZERO_RETURN) return 0;
+            ERR_clear_error();
+            return -2;
+        }
+        for (;;) {
+            ssize_t n = ::recv(conn->fd, buffer, size, 0);
+            if (n >= 0) return n;
+            if (errno == EINTR) continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK ? -1 : -2;
+        }
+    }
+
+    ssize_t transmit(Connection* conn, const char* data, size_t size) {
+        if (conn->ssl) {
+            ERR_clear_error();
+            int n = SSL_write(conn->ssl, data, static_cast<int>(std::min<size_t>(size, INT32_MAX)));
+            if (n > 0) return n;
+            int error = SSL_get_error(conn->ssl, n);
+            if (error == SSL_ERROR_WANT_READ || error == SSL_ERROR_WANT_WRITE) return -1;
+            ERR_clear_error();
+            return -2;
+        }
+        for (;;) {
+            ssize_t n = ::send(conn->fd, data, size, MSG_NOSIGNAL);
+            if (n >= 0) return n;
+            if (errno == EINTR) continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK ? -1 : -2;
+        }
+    }
+
+    // false면 연결을 닫았음
+    bool readInput(Connection* conn) {
+        char buffer[READ_CHUNK];
+        while (!conn->read_paused) {
+            ssize_t n = receive(conn, buffer, sizeof(buffer));
+            if (n == -1) return true;
+            if (n <= 0) {
+                closeConnection(conn);
+                return false;
+            }
+            touch(conn);
+            conn->in.append(buffer, static_cast<size_t>(n));
+            if (!processRequests(conn)) return false;
+        }
+        return true;
+    }
+
+    // 송신 버퍼를 비우고, 비면 스트림 다음 청크 생성/미뤄 둔 입력 처리를 이어 감. false면 연결을 닫았음
+    bool flushOutput(Connection* conn) {
+        for (;;) {
+            while (conn->pendingOutput() > 0) {
+                ssize_t n = transmit(conn, conn->out.data() + conn->out_offset, conn->pendingOutput());
+                if (n == -1) return true;
+                if (n < 0) {
+                    closeConnection(conn);
+                    return false;
+                }
+                conn->out_offset += static_cast<size_t>(n);
+                touch(conn);
+            }
+            conn->out.clear();
+            conn->out_offset = 0;
+            if (conn->busy) return true;    // 작업 스레드가 끝나면 completeOffloaded에서 이어 감
+
+            if (conn->provider) {
+                if (!pumpStream(conn)) return false;
+                if (conn->busy) return true;
+                if (conn->pendingOutput() > 0) continue;
+            }
+            if (conn->close_after_write) {
+                closeConnection(conn);
+                return false;
+            }
+            if (conn->read_paused) {
+                conn->read_paused = false;
+                if (!processRequests(conn) || !readInput(conn)) return false;
+                if (conn->pendingOutput() > 0) continue;
+            }
+            return true;
+        }
+    }
+
+    // in에 있는 완성된 요청을 순서대로 처리. false면 연결을 닫았음
+    bool processRequests(Connection* conn) {
+        for (;;) {
+            if (conn->busy || conn->provider || conn->close_after_write || conn->pendingOutput() >= OUTPUT_HIGH_WATER) {
+                conn->read_paused = true;
+                return true;
+            }
+
+            if (!conn->headers_parsed) {
+                size_t from = conn->header_scan > 3 ? conn->header_scan - 3 : 0;
+                size_t end = conn->in.find("\r\n\r\n", from);
+                if (end == std::string::npos) {
+                    conn->header_scan = conn->in.size();
+                    if (conn->in.size() > server.config.max_header_bytes) {
+                        return rejectRequest(conn, 431);
+                    }
+                    return true;
+                }
+                if (end > server.config.max_header_bytes) {
+                    return rejectRequest(conn, 431);
+                }
+                int status = parseHeaders(conn, std::string_view(conn->in.data(), end));
+                if (status != 0) {
+                    return rejectRequest(conn, status);
+                }
+                conn->headers_parsed = true;
+                conn->header_length = end + 4;
+                conn->body_scan = conn->header_length;
+            }
+
+            size_t consumed = 0;
+            if (conn->chunked_body) {
+                int status = decodeChunks(conn, consumed);
+                if (status > 0) return rejectRequest(conn, status);
+                if (status < 0) return expectContinue(conn);
+            } else {
+                if (conn->in.size() - conn->header_length < conn->content_length) {
+                    return expectContinue(conn);
+                }
+                conn->request.body.assign(conn->in, conn->header_length, conn->content_length);
+                consumed = conn->header_length + conn->content_length;
+            }
+
+            conn->in.erase(0, consumed);
+            if (!handleRequest(conn)) continue;     // 작업 스레드로 넘김 (위에서 입력 처리를 멈춤)
+            conn->resetRequest();
+        }
+    }
+
+    // 본문을 다 받기 전에 Expect: 100-continue에 답함
+    bool expectContinue(Connection* conn) {
+        if (!conn->sent_continue && conn->request.has_header("Expect") &&
+            equalsIgnoreCase(conn->request.get_header_value("Expect"), "100-continue")) {
+            conn->out += "HTTP/1.1 100 Continue\r\n\r\n";
+            conn->sent_continue = true;
+        }
+        return true;
+    }
+
+    // 요청 줄과 헤더 해석. 0이면 성공, 아니면 응답할 오류 상태 코드
+    int parseHeaders(Connection* conn, std::string_view head) {
+        httplib::Request& req = conn->request;
+        size_t line_end = head.find("\r\n");
+        std::string_view line = head.substr(0, line_end);
+        size_t sp1 = line.find(' ');
+        size_t sp2 = sp1 == std::string_view::npos ? sp1 : line.find(' ', sp1 + 1);
+        if (sp1 == std::string_view::npos || sp2 == std::string_view::npos || sp1 == 0) return 400;
+
+        req.method.assign(line.substr(0, sp1));
+        std::string_view target = line.substr(sp1 + 1, sp2 - sp1 - 1);
+        std::string_view version = line.substr(sp2 + 1);
+        if (version != "HTTP/1.1" && version != "HTTP/1.0") return 505;
+        req.version.assign(version);
+        req.target.assign(target);
+
+        size_t question = target.find('?');
+        req.path = decodeURL(target.substr(0, question), false);
+        if (question != std::string_view::npos) {
+            parseQuery(target.substr(question + 1), req.params);
+        }
+
+        bool has_length = false;
+        std::string_view connection_header;
+        std::string_view rest = line_end == std::string_view::npos ? std::string_view() : head.substr(line_end + 2);
+        while (!rest.empty()) {
+            size_t end = rest.find("\r\n");
+            std::string_view header = rest.substr(0, end);
+            rest = end == std::string_view::npos ? std::string_view() : rest.substr(end + 2);
+
+            size_t colon = header.find(':');
+            if (colon == std::string_view::npos || colon == 0 || header.front() == ' ' || header.front() == '\t') {
+                return 400;
+            }
+            std::string_view name = header.substr(0, colon);
+            std::string_view value = trim(header.substr(colon + 1));
+
+            if (equalsIgnoreCase(name, "Content-Length")) {
+                size_t length = 0;
+                auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), length);
+                if (ec != std::errc() || ptr != value.data() + value.size() || (has_length && length != conn->content_length)) {
+                    return 400;
+                }
+                has_length = true;
+                conn->content_length = length;
+            } else if (equalsIgnoreCase(name, "Transfer-Encoding")) {
+                if (!equalsIgnoreCase(value, "chunked")) return 501;
+                conn->chunked_body = true;
+            } else if (equalsIgnoreCase(name, "Connection")) {
+                connection_header = value;
+            }
+            req.headers.emplace(std::string(name), std::string(value));
+        }
+
+        // 길이와 청크 인코딩이 같이 오면 중간 프록시와 본문 경계를 다르게 볼 수 있으므로 거절
+        if (has_length && conn->chunked_body) return 400;
+        if (conn->content_length > server.config.max_body_bytes) return 413;
+
+        if (version == "HTTP/1.1") {
+            conn->keep_alive = !equalsIgnoreCase(connection_header, "close");
+        } else {
+            conn->keep_alive = equalsIgnoreCase(connection_header, "keep-alive");
+        }
+        return 0;
+    }
+
+    // 청크 본문을 이어서 해석. 0: 완료(consumed에 소비한 바이트), -1: 더 받아야 함, >0: 오류 상태 코드
+    int decodeChunks(Connection* conn, size_t& consumed) {
+        using State = Connection::ChunkState;
+        std::string& in = conn->in;
+        std::string& body = conn->request.body;
+        size_t& pos = conn->body_scan;
+
+        for (;;) {
+            switch (conn->chunk_state) {
+                case State::Size: {
+                    size_t end = in.find("\r\n", pos);
+                    if (end == std::string::npos) return in.size() - pos > 64 ? 400 : -1;
+                    std::string_view line(in.data() + pos, end - pos);
+                    line = line.substr(0, line.find(';'));      // 청크 확장은 무시
+                    line = trim(line);
+                    size_t size = 0;
+                    auto [ptr, ec] = std::from_chars(line.data(), line.data() + line.size(), size, 16);
+                    if (line.empty() || ec != std::errc() || ptr != line.data() + line.size()) return 400;
+                    if (body.size() + size > server.config.max_body_bytes) return 413;
+                    pos = end + 2;
+                    conn->chunk_remaining = size;
+                    conn->chunk_state = size == 0 ? State::Trailer : State::Data;
+                    break;
+                }
+                case State::Data: {
+                    size_t take = std::min(conn->chunk_remaining, in.size() - pos);
+                    body.append(in, pos, take);
+                    pos += take;
+                    conn->chunk_remaining -= take;
+                    if (conn->chunk_remaining > 0) return -1;
+                    conn->chunk_state = State::DataEnd;
+                    break;
+                }
+                case State::DataEnd:
+                    if (in.size() - pos < 2) return -1;
+                    if (in.compare(pos, 2, "\r\n") != 0) return 400;
+                    pos += 2;
+                    conn->chunk_state = State::Size;
+                    break;
+                case State::Trailer: {
+                    // 빈 줄이면 끝, 아니면 트레일러 헤더들을 건너뜀
+                    if (in.size() - pos < 2) return -1;
+                    if (in.compare(pos, 2, "\r\n") == 0) {
+                        pos += 2;
+                    } else {
+                        size_t end = in.find("\r\n\r\n", pos);
+                        if (end == std::string::npos) return in.size() - pos > server.config.max_header_bytes ? 431 : -1;
+                        pos = end + 4;
+                    }
+                    conn->chunk_state = State::Done;
+                    break;
+                }
+                case State::Done:
+                    consumed = pos;
+                    return 0;
+            }
+        }
+    }
+
+    // 잘못된 요청: 오류 응답 후 연결 종료
+    bool rejectRequest(Connection* conn, int status) {
+        httplib::Response res;
+        res.status = status;
+        conn->request.method = conn->request.method.empty() ? "GET" : conn->request.method;
+        writeResponse(conn, res, false);
+        conn->close_after_write = true;
+        conn->read_paused = true;
+        conn->in.clear();
+        return true;
+    }
+
+    // false면 작업 스레드로 넘겼음 (응답은 completeOffloaded에서 보냄)
+    bool handleRequest(Connection* conn) {
+        httplib::Request& req = conn->request;
+        httplib::Response res;
+        if (server.offload_pool && server.offload(req)) {
+            conn->busy = true;
+            if (server.offload_pool->submit([this, conn]() { dispatchOffloaded(conn); })) {
+                return false;
+            }
+            conn->busy = false;
+            res.status = 503;               // 종료 중이라 작업 풀이 받지 않음
+        } else {
+            dispatch(req, res);
+        }
+
+        respond(conn, res);
+        if (server.logger) server.logger(req, res);
+        return true;
+    }
+
+    void dispatch(httplib::Request& req, httplib::Response& res) {
+        try {
+            server.dispatcher(req, res);
+        } catch (const std::exception& e) {
+            MFA_LOG_ERROR("EVENT", "요청 처리 중 예외: " << e.what());
+            res = httplib::Response();
+            res.status = 500;
+        }
+        if (res.status == -1) res.status = 200;
+    }
+
+    void respond(Connection* conn, httplib::Response& res) {
+        conn->requests++;
+        bool keep_alive = conn->keep_alive && conn->requests < server.config.keep_alive_max_count &&
+                          !server.stopping.load(std::memory_order_relaxed);
+        writeResponse(conn, res, keep_alive);
+        if (!keep_alive) conn->close_after_write = true;
+    }
+
+    // 작업 스레드에서 실행 (busy인 동안 리액터는 conn의 요청과 스트림 상태를 건드리지 않음)
+    void dispatchOffloaded(Connection* conn) {
+        Completion done;
+        done.conn = conn;
+        dispatch(conn->request, done.res);
+        // 지표 등 로거가 쓰는 스레드 상태가 디스패처와 같은 스레드에 있으므로 여기서 기록
+        if (server.logger) server.logger(conn->request, done.res);
+        post(std::move(done));
+    }
+
+    void pumpOffloaded(Connection* conn) {
+        Completion done;
+        done.conn = conn;
+        done.stream = true;
+        done.ok = produceStream(conn, done.data, 0);
+        post(std::move(done));
+    }
+
+    void post(Completion&& done) {
+        {
+            std::lock_guard<std::mutex> lock(completed_mutex);
+            completed.push_back(std::move(done));
+        }
+        wake();
+    }
+
+    void completeOffloaded() {
+        std::vector<Completion> batch;
+        {
+            std::lock_guard<std::mutex> lock(completed_mutex);
+            batch.swap(completed);
+        }
+        for (Completion& done : batch) {
+            Connection* conn = done.conn;
+            conn->busy = false;
+            if (conn->closing) {
+                destroy(conn);
+                continue;
+            }
+            touch(conn);
+            if (done.stream) {
+                if (!done.ok) {
+                    closeConnection(conn);
+                    continue;
+                }
+                conn->out += done.data;
+                finishStream(conn);
+            } else {
+                respond(conn, done.res);
+                conn->stream_on_worker = static_cast<bool>(conn->provider);
+                conn->resetRequest();
+            }
+            flushOutput(conn);
+        }
+    }
+
+    void writeResponse(Connection* conn, httplib::Response& res, bool keep_alive) {
+        std::string& out = conn->out;
+        out += "HTTP/1.1 ";
+        appendNumber(out, static_cast<size_t>(res.status));
+        out += ' ';
+        out += statusMessage(res.status);
+        out += "\r\n";
+        for (const auto& header : res.headers) {
+            if (equalsIgnoreCase(header.first, "Content-Length") || equalsIgnoreCase(header.first, "Connection") ||
+                equalsIgnoreCase(header.first, "Transfer-Encoding")) {
+                continue;
+            }
+            out += header.first;
+            out += ": ";
+            out += header.second;
+            out += "\r\n";
+        }
+
+        bool streaming = static_cast<bool>(res.content_provider_);
+        if (streaming && res.is_chunked_content_provider_) {
+            out += "Transfer-Encoding: chunked\r\n";
+        } else {
+            out += "Content-Length: ";
+            appendNumber(out, streaming ? res.content_length_ : res.body.size());
+            out += "\r\n";
+        }
+        if (keep_alive) {
+            out += "Connection: keep-alive\r\nKeep-Alive: timeout=";
+            appendNumber(out, static_cast<size_t>(server.config.keep_alive_timeout_sec));
+            out += ", max=";
+            appendNumber(out, server.config.keep_alive_max_count - conn->requests);
+            out += "\r\n\r\n";
+        } else {
+            out += "Connection: close\r\n\r\n";
+        }
+
+        bool head = conn->request.method == "HEAD";
+        if (streaming) {
+            if (head) {
+                if (res.content_provider_resource_releaser_) res.content_provider_resource_releaser_(true);
+                return;
+            }
+            conn->provider = std::move(res.content_provider_);
+            conn->releaser = std::move(res.content_provider_resource_releaser_);
+            conn->provider_offset = 0;
+            conn->provider_length = res.content_length_;
+            conn->provider_chunked = res.is_chunked_content_provider_;
+            conn->provider_done = false;
+            res.content_provider_ = nullptr;
+        } else if (!head) {
+            out += res.body;
+        }
+    }
+
+    // 송신 대기 바이트가 적은 동안 스트림 다음 부분을 생성. false면 연결을 닫았음
+    bool pumpStream(Connection* conn) {
+        if (conn->stream_on_worker) {
+            conn->busy = true;
+            if (server.offload_pool->submit([this, conn]() { pumpOffloaded(conn); })) {
+                return true;
+            }
+            conn->busy = false;
+            closeConnection(conn);
+            return false;
+        }
+        if (!produceStream(conn, conn->out, conn->out_offset)) {
+            closeConnection(conn);
+            return false;
+        }
+        finishStream(conn);
+        return true;
+    }
+
+    // out[sent..]이 OUTPUT_HIGH_WATER보다 적은 동안 스트림을 out에 이어 씀. false면 생성 실패
+    bool produceStream(Connection* conn, std::string& out, size_t sent) {
+        httplib::DataSink sink;
+        sink.write = [conn, &out](const char* data, size_t size) {
+            if (size == 0) return true;
+            if (conn->provider_chunked) {
+                appendHex(out, size);
+                out += "\r\n";
+                out.append(data, size);
+                out += "\r\n";
+            } else {
+                out.append(data, size);
+            }
+            conn->provider_offset += size;
+            return true;
+        };
+        sink.is_writable = []() { return true; };
+        sink.done = [conn, &out]() {
+            if (conn->provider_done) return;
+            conn->provider_done = true;
+            if (conn->provider_chunked) out += "0\r\n\r\n";
+        };
+
+        while (conn->provider && !conn->provider_done && out.size() - sent < OUTPUT_HIGH_WATER) {
+            size_t remaining = conn->provider_chunked ? 0 : conn->provider_length - conn->provider_offset;
+            if (!conn->provider(conn->provider_offset, remaining, sink)) {
+                return false;
+            }
+            if (!conn->provider_chunked && conn->provider_offset >= conn->provider_length) {
+                conn->provider_done = true;
+            }
+        }
+        return true;
+    }
+
+    void finishStream(Connection* conn) {
+        if (!conn->provider_done) return;
+        if (conn->releaser) conn->releaser(true);
+        conn->provider = nullptr;
+        conn->releaser = nullptr;
+        conn->provider_done = false;
+        conn->stream_on_worker = false;
+    }
+
+    void closeExpired() {
+        const uint64_t keep_alive_ms = static_cast<uint64_t>(server.config.keep_alive_timeout_sec) * 1000;
+        const uint64_t read_ms = static_cast<uint64_t>(server.config.read_timeout_sec) * 1000;
+        const uint64_t write_ms = static_cast<uint64_t>(server.config.write_timeout_sec) * 1000;
+        const uint64_t shortest = std::min({keep_alive_ms, read_ms, write_ms});
+
+        Connection* conn = head;
+        while (conn && now_ms - conn->last_active_ms >= shortest) {
+            Connection* next = conn->next;
+            if (conn->busy) {
+                conn = next;                // 작업 스레드를 기다리는 중 (노드 간 요청의 시간 초과가 따로 있음)
+                continue;
+            }
+            uint64_t idle = now_ms - conn->last_active_ms;
+            uint64_t limit = keep_alive_ms;
+            if (conn->pendingOutput() > 0 || conn->provider) {
+                limit = write_ms;
+            } else if (!conn->handshake_done || !conn->in.empty() || conn->headers_parsed) {
+                limit = read_ms;
+            }
+            if (idle >= limit) closeConnection(conn);
+            conn = next;
+        }
+    }
+
+    void append(Connection* conn) {
+        conn->prev = tail;
+        conn->next = nullptr;
+        if (tail) tail->next = conn;
+        else head = conn;
+        tail = conn;
+    }
+
+    void unlink(Connection* conn) {
+        if (conn->prev) conn->prev->next = conn->next;
+        else head = conn->next;
+        if (conn->next) conn->next->prev = conn->prev;
+        else tail = conn->prev;
+        conn->prev = conn->next = nullptr;
+    }
+
+    // 활동이 있던 연결을 목록 끝으로 (시간 초과 검사는 앞에서부터)
+    void touch(Connection* conn) {
+        conn->last_active_ms = now_ms;
+        if (conn != tail) {
+            unlink(conn);
+            append(conn);
+        }
+    }
+
+    void closeConnection(Connection* conn) {
+        unlink(conn);
+        if (conn->busy) {
+            // 작업 스레드가 아직 연결 상태를 쓰므로 끝난 뒤(completeOffloaded) 정리
+            conn->closing = true;
+            return;
+        }
+        destroy(conn);
+    }
+
+    void destroy(Connection* conn) {
+        if (conn->releaser) conn->releaser(false);
+        if (conn->ssl) {
+            if (conn->handshake_done) SSL_shutdown(conn->ssl);
+            SSL_free(conn->ssl);
+            ERR_clear_error();
+        }
+        ::close(conn->fd);
+        delete conn;
+        server.open_connections.fetch_sub(1, std::memory_order_relaxed);
+    }
+};
+
+EventServer::EventServer(const Config& config, Dispatcher dispatcher, Logger logger, Offload offload)
+    : config(config), dispatcher(std::move(dispatcher)), logger(std::move(logger)), offload(std::move(offload)) {
+    if (this->config.threads == 0) {
+        this->config.threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (this->config.keep_alive_max_count == 0) {
+        this->config.keep_alive_max_count = 1;
+    }
+    if (this->offload && this->config.offload_threads > 0) {
+        offload_pool = std::make_unique<WorkerPool>(this->config.offload_threads);
+    }
+    signal(SIGPIPE, SIG_IGN);           // TLS 쓰기는 MSG_NOSIGNAL을 쓸 수 없음
+}
+
+EventServer::~EventServer() {
+    // run() 도중 종료 신호로 exit()하는 경우에도 다른 리액터가 끝난 뒤에 정리
+    stop();
+    for (auto& thread : threads) {
+        if (thread.joinable()) thread.join();
+    }
+    // 남은 작업이 리액터에 완료를 넣을 수 있으므로 리액터보다 먼저 멈춤
+    if (offload_pool) offload_pool->shutdown();
+    reactors.clear();
+    if (listen_fd >= 0) ::close(listen_fd);
+    if (ssl_ctx) SSL_CTX_free(ssl_ctx);
+}
+
+size_t EventServer::raiseFileLimit() {
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0) return 0;
+    if (limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+        getrlimit(RLIMIT_NOFILE, &limit);
+    }
+    return static_cast<size_t>(limit.rlim_cur);
+}
+
+bool EventServer::bind(const std::string& host, int port) {
+    if (!config.cert_path.empty() && !config.key_path.empty()) {
+        ssl_ctx = SSL_CTX_new(TLS_server_method());
+        if (!ssl_ctx) return false;
+        SSL_CTX_set_min_proto_version(ssl_ctx, TLS1_2_VERSION);
+        // 쉬는 연결이 읽기/쓰기 버퍼(약 34KB)를 붙잡지 않도록 반납
+        SSL_CTX_set_mode(ssl_ctx, SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER |
+                                      SSL_MODE_RELEASE_BUFFERS);
+        if (SSL_CTX_use_certificate_chain_file(ssl_ctx, config.cert_path.c_str()) != 1 ||
+            SSL_CTX_use_PrivateKey_file(ssl_ctx, config.key_path.c_str(), SSL_FILETYPE_PEM) != 1 ||
+            SSL_CTX_check_private_key(ssl_ctx) != 1) {
+            MFA_LOG_ERROR("EVENT", "SSL 인증서/키를 읽을 수 없습니다: " << config.cert_path << ", " << config.key_path);
+            ERR_clear_error();
+            return false;
+        }
+        std::string error;
+        if (config.tls && !TLS::configure(ssl_ctx, *config.tls, error)) {
+            MFA_LOG_ERROR("EVENT", "TLS 설정을 적용하지 못했습니다: " << error);
+            return false;
+        }
+    }
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE | AI_NUMERICSERV;
+    addrinfo* result = nullptr;
+    std::string service = std::to_string(port);
+    if (getaddrinfo(host.empty() ? nullptr : host.c_str(), service.c_str(), &hints, &result) != 0) {
+        MFA_LOG_ERROR("EVENT", "주소를 해석할 수 없습니다: " << host);
+        return false;
+    }
+
+    for (addrinfo* info = result; info && listen_fd < 0; info = info->ai_next) {
+        int fd = socket(info->ai_family, info->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, info->ai_protocol);
+        if (fd < 0) continue;
+        int yes = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+        if (config.tcp_nodelay) setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+        if (::bind(fd, info->ai_addr, info->ai_addrlen) == 0 && ::listen(fd, config.listen_backlog) == 0) {
+            listen_fd = fd;
+        } else {
+            ::close(fd);
+        }
+    }
+    freeaddrinfo(result);
+    if (listen_fd < 0) {
+        MFA_LOG_ERROR("EVENT", "포트 " << port << "에 바인드할 수 없습니다: " << strerror(errno));
+        return false;
+    }
+
+    sockaddr_storage addr{};
+    socklen_t length = sizeof(addr);
+    getsockname(listen_fd, reinterpret_cast<sockaddr*>(&addr), &length);
+    bound_port = addr.ss_family == AF_INET6 ? ntohs(reinterpret_cast<sockaddr_in6*>(&addr)->sin6_port)
+                                            : ntohs(reinterpret_cast<sockaddr_in*>(&addr)->sin_port);
+
+    for (size_t i = 0; i < config.threads; i++) {
+        auto reactor = std::make_unique<Reactor>(*this);
+        if (!reactor->init()) {
+            MFA_LOG_ERROR("EVENT", "epoll 초기화 실패: " << strerror(errno));
+            reactors.clear();
+            return false;
+        }
+        reactors.push_back(std::move(reactor));
+    }
+    return true;
+}
+
+bool EventServer::run() {
+    if (reactors.empty()) return false;
+
+    running.store(true, std::memory_order_release);
+    for (size_t i = 1; i < reactors.size(); i++) {
+        Reactor* reactor = reactors[i].get();
+        threads.emplace_back([reactor]() { reactor->run(); });
+    }
+    reactors[0]->run();
+    for (auto& thread : threads) {
+        if (thread.joinable()) thread.join();
+    }
+    // 돌려준 뒤에는 디스패처가 불리지 않도록 넘긴 요청을 마저 처리하고 작업 스레드를 합류
+    if (offload_pool) offload_pool->shutdown();
+    running.store(false, std::memory_order_release);
+    return true;
+}
+
+void EventServer::stop() {
+    stopping.store(true, std::memory_order_release);
+    for (auto& reactor : reactors) reactor->wake();
+}
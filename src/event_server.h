@@ -0,0 +1,123 @@
+#ifndef EVENT_SERVER_H
+#define EVENT_SERVER_H
+
+#include <atomic>
+#include <cstddef>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <httplib.h>
+#include "tls_config.h"
+
+typedef struct ssl_ctx_st SSL_CTX;
+class WorkerPool;
+
+/**
+ * @brief epoll 기반 HTTP/1.1(+TLS) 리스너
+ *
+ * httplib::Server는 연결 하나가 keep-alive 동안 작업 스레드 하나를 차지하므로, 쉬고 있는 연결이
+ * 수천 개면 스레드가 모자라 처리량이 무너집니다. 이 리스너는 소수의 리액터 스레드가 각자 epoll로
+ * 연결 수만 개를 나눠 맡고, 요청이 완성되면 그 스레드에서 바로 디스패처(httplib::Request/Response를
+ * 받는 같은 핸들러)를 호출합니다. 쉬는 연결의 비용은 소켓과 연결 상태 구조체뿐입니다.
+ *
+ * - 모든 리액터가 같은 수신 소켓을 EPOLLEXCLUSIVE로 기다리고, 깨어난 리액터가 수락한 연결을 끝까지 맡음
+ * - 연결 소켓은 edge-triggered로 한 번만 등록 (읽기/쓰기 가능할 때까지 읽고 씀, epoll_ctl 재호출 없음)
+ * - 파이프라이닝된 요청은 순서대로 처리하고, 청크 스트리밍 응답은 송신 버퍼가 빌 때마다 이어서 생성
+ * - 핸들러는 리액터 스레드에서 실행되므로 오래 막히는 작업(WAL 반영 대기 등) 동안 같은 리액터의 다른 연결도 기다림
+ * - 단, Offload가 고른 요청(다른 노드의 응답을 기다리는 요청 등)은 작업 스레드에서 디스패처와 스트림 생성을 돌리고
+ *   완성된 응답만 리액터가 받아 보냄. 그동안 그 연결의 다음 요청은 처리하지 않음
+ */
+class EventServer {
+public:
+    struct Config {
+        size_t threads = 0;                 // 리액터 스레드 수 (0이면 코어 수)
+        size_t keep_alive_max_count = 5;    // 연결 하나로 처리할 최대 요청 수
+        time_t keep_alive_timeout_sec = 5;  // 요청 사이 유휴 시간
+        time_t read_timeout_sec = 5;        // 요청(헤더/본문)을 다 받을 때까지 기다리는 시간
+        time_t write_timeout_sec = 5;       // 응답을 보내지 못하고 기다리는 시간
+        int listen_backlog = 5;
+        bool tcp_nodelay = false;
+        size_t max_header_bytes = 8192;
+        size_t max_body_bytes = 8 * 1024 * 1024;
+        std::string cert_path;              // 둘 다 있으면 TLS
+        std::string key_path;
+        std::optional<TLS::Settings> tls;   // 없으면 OpenSSL 기본값 (세션 캐시만 켜짐)
+        size_t offload_threads = 0;         // Offload가 고른 요청을 처리할 작업 스레드 수 (0이면 모두 리액터에서)
+    };
+
+    /**
+     * @brief 완성된 요청 하나를 처리 (라우팅 포함, 리액터 스레드에서 호출)
+     */
+    using Dispatcher = std::function<void(httplib::Request&, httplib::Response&)>;
+
+    /**
+     * @brief 응답을 송신 버퍼에 넣은 직후 호출 (httplib 로거와 같은 용도)
+     */
+    using Logger = std::function<void(const httplib::Request&, const httplib::Response&)>;
+
+    /**
+     * @brief 요청을 리액터 대신 작업 스레드에서 처리할지 (리액터 스레드에서 디스패처보다 먼저 호출, 가볍게)
+     */
+    using Offload = std::function<bool(const httplib::Request&)>;
+
+    EventServer(const Config& config, Dispatcher dispatcher, Logger logger = nullptr, Offload offload = nullptr);
+    ~EventServer();
+
+    EventServer(const EventServer&) = delete;
+    EventServer& operator=(const EventServer&) = delete;
+
+    /**
+     * @brief 수신 소켓 생성 (TLS면 인증서도 이때 읽음)
+     * @param port 0이면 임의 포트 (boundPort()로 확인)
+     * @return 실패 시 false (원인은 로그)
+     */
+    bool bind(const std::string& host, int port);
+
+    /**
+     * @brief 리액터 스레드를 돌리고 stop()까지 블로킹 (호출 스레드가 첫 리액터가 됨)
+     */
+    bool run();
+
+    /**
+     * @brief 모든 리액터를 깨워 종료 (시그널 핸들러에서 불러도 됨)
+     */
+    void stop();
+
+    bool isRunning() const { return running.load(std::memory_order_acquire); }
+    int boundPort() const { return bound_port; }
+
+    /**
+     * @brief 열려 있는 연결 수 (통계용)
+     */
+    size_t connectionCount() const { return open_connections.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief RLIMIT_NOFILE 소프트 한도를 하드 한도까지 올림
+     * @return 올린 뒤의 소프트 한도
+     */
+    static size_t raiseFileLimit();
+
+private:
+    class Reactor;
+    struct Connection;
+
+    Config config;
+    Dispatcher dispatcher;
+    Logger logger;
+    Offload offload;
+    std::unique_ptr<WorkerPool> offload_pool;   // offload_threads가 0이면 없음
+    SSL_CTX* ssl_ctx = nullptr;
+    int listen_fd = -1;
+    int bound_port = 0;
+    std::vector<std::unique_ptr<Reactor>> reactors;
+    std::vector<std::thread> threads;           // 첫 리액터는 run()을 부른 스레드
+    std::atomic<bool> running{false};
+    std::atomic<bool> stopping{false};
+    std::atomic<size_t> open_connections{0};
+};
+
+#endif // EVENT_SERVER_H
@@ -1,7 +1,8 @@
 #include "../server.h"
 #include "../mfa_core.h"
+#include "../json_reader.h"
+#include "../json_writer.h"
 #include <iostream>
-#include <sstream>
 
 // 이 파일은 나중에 server.cpp에서 분리된 인증 핸들러 로직을 담을 예정입니다.
 // 현재는 기본 구조만 제공합니다.
@@ -18,42 +19,29 @@ namespace AuthHandler {
     AuthRequest parseAuthRequest(const std::string& json_body) {
         AuthRequest req;
         
-        // 간단한 JSON 파싱 (나중에 nlohmann/json으로 교체 예정)
-        size_t user_start = json_body.find("\"user_id\"");
-        size_t otp_start = json_body.find("\"otp_code\"");
-        
-        if (user_start == std::string::npos || otp_start == std::string::npos) {
+        // 공용 토크나이저로 파싱 (형식 오류면 invalid)
+        static constexpr std::string_view keys[] = {"user_id", "otp_code"};
+        std::string_view fields[2];
+        char scratch[256];
+        if (Json::parseStringFields(json_body, keys, fields, 2, scratch, sizeof(scratch)) != Json::Error::None) {
             return req; // invalid
         }
         
-        // user_id 추출
-        user_start = json_body.find(":", user_start);
-        user_start = json_body.find("\"", user_start) + 1;
-        size_t user_end = json_body.find("\"", user_start);
-        req.user_id = json_body.substr(user_start, user_end - user_start);
-        
-        // otp_code 추출
-        otp_start = json_body.find(":", otp_start);
-        otp_start = json_body.find("\"", otp_start) + 1;
-        size_t otp_end = json_body.find("\"", otp_start);
-        req.otp_code = json_body.substr(otp_start, otp_end - otp_start);
-        
+        req.user_id = std::string(fields[0]);
+        req.otp_code = std::string(fields[1]);
         req.valid = !req.user_id.empty() && !req.otp_code.empty();
         return req;
     }
     
     // 응답 JSON 생성
     std::string createAuthResponse(bool success, const std::string& message = "") {
-        std::ostringstream json;
-        json << "{"
-             << "\"success\": " << (success ? "true" : "false");
-        
+        Json::Writer& json = Json::Writer::local();
+        json.beginObject().key("success").boolean(success);
         if (!message.empty()) {
-            json << ",\"message\": \"" << message << "\"";
+            json.key("message").string(message);
         }
-        
-        json << "}";
-        return json.str();
+        json.endObject();
+        return std::string(json.view());
     }
     
     // OTP 코드 검증
@@ -70,4 +58,4 @@ namespace AuthHandler {
 
 // 향후 구현될 함수들:
 // void handleAuthRequest(MFACore* mfa_core, const std::string& request_body, std::string& response);
-// bool rateLimitCheck(const std::string& user_id);
+// (시도 제한은 RateLimiter(src/rate_limiter.h)로 구현되어 MFAServer::handleAuthenticate에서 검사)
@@ -1,51 +1,44 @@
 #include "../server.h"
 #include "../mfa_core.h"
+#include "../json_reader.h"
+#include "../json_writer.h"
 #include <iostream>
-#include <sstream>
 
 // 이 파일은 나중에 server.cpp에서 분리된 핸들러 로직을 담을 예정입니다.
 // 현재는 기본 구조만 제공합니다.
 
 namespace RegisterHandler {
     
-    // JSON 파싱 헬퍼 함수 (간단한 구현)
+    // JSON 파싱 헬퍼 함수 (공용 토크나이저 사용, 형식 오류면 빈 문자열)
     std::string extractUserID(const std::string& json_body) {
-        // 간단한 JSON 파싱 (나중에 nlohmann/json으로 교체 예정)
-        size_t start = json_body.find("\"user_id\"");
-        if (start == std::string::npos) return "";
-        
-        start = json_body.find(":", start);
-        if (start == std::string::npos) return "";
-        
-        start = json_body.find("\"", start);
-        if (start == std::string::npos) return "";
-        start++;
-        
-        size_t end = json_body.find("\"", start);
-        if (end == std::string::npos) return "";
-        
-        return json_body.substr(start, end - start);
+        static constexpr std::string_view keys[] = {"user_id"};
+        std::string_view user_id;
+        char scratch[256];
+        if (Json::parseStringFields(json_body, keys, &user_id, 1, scratch, sizeof(scratch)) != Json::Error::None) {
+            return "";
+        }
+        return std::string(user_id);
     }
     
     // 응답 JSON 생성 함수
     std::string createSuccessResponse(const User& user, const std::string& qr_url) {
-        std::ostringstream json;
-        json << "{"
-             << "\"success\": true,"
-             << "\"user_id\": \"" << user.user_id << "\","
-             << "\"secret\": \"" << user.secret_base32 << "\","
-             << "\"qr_code_url\": \"" << qr_url << "\""
-             << "}";
-        return json.str();
+        Json::Writer& json = Json::Writer::local();
+        json.beginObject()
+            .key("success").boolean(true)
+            .key("user_id").string(user.user_id)
+            .key("secret").string(user.secret_base32)
+            .key("qr_code_url").string(qr_url)
+            .endObject();
+        return std::string(json.view());
     }
     
     std::string createErrorResponse(const std::string& error) {
-        std::ostringstream json;
-        json << "{"
-             << "\"success\": false,"
-             << "\"error\": \"" << error << "\""
-             << "}";
-        return json.str();
+        Json::Writer& json = Json::Writer::local();
+        json.beginObject()
+            .key("success").boolean(false)
+            .key("error").string(error)
+            .endObject();
+        return std::string(json.view());
     }
 }
 
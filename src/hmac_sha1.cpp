@@ -0,0 +1,141 @@
+#include "hmac_sha1.h"
+#include <cstring>
+#include <openssl/evp.h>
+
+namespace {
+
+    constexpr uint32_t SHA1_INIT[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+
+    inline uint32_t rotl(uint32_t x, int n) {
+        return (x << n) | (x >> (32 - n));
+    }
+
+    inline uint32_t loadBE32(const unsigned char* p) {
+        return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+    }
+
+    inline void storeBE32(unsigned char* p, uint32_t v) {
+        p[0] = static_cast<unsigned char>(v >> 24);
+        p[1] = static_cast<unsigned char>(v >> 16);
+        p[2] = static_cast<unsigned char>(v >> 8);
+        p[3] = static_cast<unsigned char>(v);
+    }
+
+    inline void storeBE64(unsigned char* p, uint64_t v) {
+        storeBE32(p, static_cast<uint32_t>(v >> 32));
+        storeBE32(p + 4, static_cast<uint32_t>(v));
+    }
+}
+
+namespace HMACSHA1 {
+
+    void compress(uint32_t state[5], const unsigned char block[SHA1_BLOCK_LENGTH]) {
+        uint32_t w[16];
+        for (int i = 0; i < 16; i++) {
+            w[i] = loadBE32(block + i * 4);
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+
+        // 16워드 순환 메시지 스케줄 + 완전 전개 라운드
+#define SHA1_W(i) (w[(i) & 15] = rotl(w[((i) + 13) & 15] ^ w[((i) + 8) & 15] ^ w[((i) + 2) & 15] ^ w[(i) & 15], 1))
+#define SHA1_R0(v, x, y, z, u, i) u += ((x & (y ^ z)) ^ z) + w[i] + 0x5A827999u + rotl(v, 5); x = rotl(x, 30);
+#define SHA1_R1(v, x, y, z, u, i) u += ((x & (y ^ z)) ^ z) + SHA1_W(i) + 0x5A827999u + rotl(v, 5); x = rotl(x, 30);
+#define SHA1_R2(v, x, y, z, u, i) u += (x ^ y ^ z) + SHA1_W(i) + 0x6ED9EBA1u + rotl(v, 5); x = rotl(x, 30);
+#define SHA1_R3(v, x, y, z, u, i) u += (((x | y) & z) | (x & y)) + SHA1_W(i) + 0x8F1BBCDCu + rotl(v, 5); x = rotl(x, 30);
+#define SHA1_R4(v, x, y, z, u, i) u += (x ^ y ^ z) + SHA1_W(i) + 0xCA62C1D6u + rotl(v, 5); x = rotl(x, 30);
+
+        SHA1_R0(a, b, c, d, e, 0)  SHA1_R0(e, a, b, c, d, 1)  SHA1_R0(d, e, a, b, c, 2)  SHA1_R0(c, d, e, a, b, 3)
+        SHA1_R0(b, c, d, e, a, 4)  SHA1_R0(a, b, c, d, e, 5)  SHA1_R0(e, a, b, c, d, 6)  SHA1_R0(d, e, a, b, c, 7)
+        SHA1_R0(c, d, e, a, b, 8)  SHA1_R0(b, c, d, e, a, 9)  SHA1_R0(a, b, c, d, e, 10) SHA1_R0(e, a, b, c, d, 11)
+        SHA1_R0(d, e, a, b, c, 12) SHA1_R0(c, d, e, a, b, 13) SHA1_R0(b, c, d, e, a, 14) SHA1_R0(a, b, c, d, e, 15)
+        SHA1_R1(e, a, b, c, d, 16) SHA1_R1(d, e, a, b, c, 17) SHA1_R1(c, d, e, a, b, 18) SHA1_R1(b, c, d, e, a, 19)
+        SHA1_R2(a, b, c, d, e, 20) SHA1_R2(e, a, b, c, d, 21) SHA1_R2(d, e, a, b, c, 22) SHA1_R2(c, d, e, a, b, 23)
+        SHA1_R2(b, c, d, e, a, 24) SHA1_R2(a, b, c, d, e, 25) SHA1_R2(e, a, b, c, d, 26) SHA1_R2(d, e, a, b, c, 27)
+        SHA1_R2(c, d, e, a, b, 28) SHA1_R2(b, c, d, e, a, 29) SHA1_R2(a, b, c, d, e, 30) SHA1_R2(e, a, b, c, d, 31)
+        SHA1_R2(d, e, a, b, c, 32) SHA1_R2(c, d, e, a, b, 33) SHA1_R2(b, c, d, e, a, 34) SHA1_R2(a, b, c, d, e, 35)
+        SHA1_R2(e, a, b, c, d, 36) SHA1_R2(d, e, a, b, c, 37) SHA1_R2(c, d, e, a, b, 38) SHA1_R2(b, c, d, e, a, 39)
+        SHA1_R3(a, b, c, d, e, 40) SHA1_R3(e, a, b, c, d, 41) SHA1_R3(d, e, a, b, c, 42) SHA1_R3(c, d, e, a, b, 43)
+        SHA1_R3(b, c, d, e, a, 44) SHA1_R3(a, b, c, d, e, 45) SHA1_R3(e, a, b, c, d, 46) SHA1_R3(d, e, a, b, c, 47)
+        SHA1_R3(c, d, e, a, b, 48) SHA1_R3(b, c, d, e, a, 49) SHA1_R3(a, b, c, d, e, 50) SHA1_R3(e, a, b, c, d, 51)
+        SHA1_R3(d, e, a, b, c, 52) SHA1_R3(c, d, e, a, b, 53) SHA1_R3(b, c, d, e, a, 54) SHA1_R3(a, b, c, d, e, 55)
+        SHA1_R3(e, a, b, c, d, 56) SHA1_R3(d, e, a, b, c, 57) SHA1_R3(c, d, e, a, b, 58) SHA1_R3(b, c, d, e, a, 59)
+        SHA1_R4(a, b, c, d, e, 60) SHA1_R4(e, a, b, c, d, 61) SHA1_R4(d, e, a, b, c, 62) SHA1_R4(c, d, e, a, b, 63)
+        SHA1_R4(b, c, d, e, a, 64) SHA1_R4(a, b, c, d, e, 65) SHA1_R4(e, a, b, c, d, 66) SHA1_R4(d, e, a, b, c, 67)
+        SHA1_R4(c, d, e, a, b, 68) SHA1_R4(b, c, d, e, a, 69) SHA1_R4(a, b, c, d, e, 70) SHA1_R4(e, a, b, c, d, 71)
+        SHA1_R4(d, e, a, b, c, 72) SHA1_R4(c, d, e, a, b, 73) SHA1_R4(b, c, d, e, a, 74) SHA1_R4(a, b, c, d, e, 75)
+        SHA1_R4(e, a, b, c, d, 76) SHA1_R4(d, e, a, b, c, 77) SHA1_R4(c, d, e, a, b, 78) SHA1_R4(b, c, d, e, a, 79)
+
+#undef SHA1_W
+#undef SHA1_R0
+#undef SHA1_R1
+#undef SHA1_R2
+#undef SHA1_R3
+#undef SHA1_R4
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+    }
+
+    bool precompute(const unsigned char* key, size_t key_len, HMACKeyState& state) {
+        unsigned char key_block[SHA1_BLOCK_LENGTH] = {0};
+
+        // 블록보다 긴 키는 SHA-1 해시로 대체 (RFC 2104)
+        if (key_len > SHA1_BLOCK_LENGTH) {
+            unsigned int digest_len = 0;
+            if (!EVP_Digest(key, key_len, key_block, &digest_len, EVP_sha1(), nullptr)) {
+                state.valid = false;
+                return false;
+            }
+        } else if (key_len > 0) {
+            memcpy(key_block, key, key_len);
+        }
+
+        unsigned char pad[SHA1_BLOCK_LENGTH];
+
+        for (int i = 0; i < SHA1_BLOCK_LENGTH; i++) pad[i] = key_block[i] ^ 0x36;
+        memcpy(state.inner, SHA1_INIT, sizeof(SHA1_INIT));
+        compress(state.inner, pad);
+
+        for (int i = 0; i < SHA1_BLOCK_LENGTH; i++) pad[i] = key_block[i] ^ 0x5c;
+        memcpy(state.outer, SHA1_INIT, sizeof(SHA1_INIT));
+        compress(state.outer, pad);
+
+        state.valid = true;
+        return true;
+    }
+
+    void macCounter(const HMACKeyState& state, uint64_t counter, unsigned char digest[SHA1_DIGEST_LENGTH]) {
+        unsigned char block[SHA1_BLOCK_LENGTH] = {0};
+        uint32_t h[5];
+
+        // 내부 해시: (K ^ ipad) || counter, 전체 길이 64 + 8 바이트
+        storeBE64(block, counter);
+        block[8] = 0x80;
+        storeBE64(block + 56, uint64_t(SHA1_BLOCK_LENGTH + 8) * 8);
+        memcpy(h, state.inner, sizeof(h));
+        compress(h, block);
+
+        // 외부 해시: (K ^ opad) || inner_digest, 전체 길이 64 + 20 바이트
+        memset(block, 0, sizeof(block));
+        for (int i = 0; i < 5; i++) storeBE32(block + i * 4, h[i]);
+        block[SHA1_DIGEST_LENGTH] = 0x80;
+        storeBE64(block + 56, uint64_t(SHA1_BLOCK_LENGTH + SHA1_DIGEST_LENGTH) * 8);
+        memcpy(h, state.outer, sizeof(h));
+        compress(h, block);
+
+        for (int i = 0; i < 5; i++) storeBE32(digest + i * 4, h[i]);
+    }
+
+    int truncate(const unsigned char digest[SHA1_DIGEST_LENGTH]) {
+        int offset = digest[SHA1_DIGEST_LENGTH - 1] & 0xf;
+        int code = ((digest[offset] & 0x7f) << 24) |
+                   ((digest[offset + 1] & 0xff) << 16) |
+                   ((digest[offset + 2] & 0xff) << 8) |
+                   (digest[offset + 3] & 0xff);
+        return code % 1000000;
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef HMAC_SHA1_H
+#define HMAC_SHA1_H
+
+#include <cstddef>
+#include <cstdint>
+
+constexpr int SHA1_DIGEST_LENGTH = 20;
+constexpr int SHA1_BLOCK_LENGTH = 64;
+
+/**
+ * @brief 사용자별로 미리 계산해 두는 HMAC-SHA1 키 상태
+ *
+ * 키 블록(K ^ ipad, K ^ opad)을 한 번 압축한 중간 상태를 보관하므로
+ * 8바이트 카운터 MAC 한 번에 SHA-1 압축 두 번만 수행합니다.
+ */
+struct HMACKeyState {
+    uint32_t inner[5] = {0, 0, 0, 0, 0};
+    uint32_t outer[5] = {0, 0, 0, 0, 0};
+    bool valid = false;
+};
+
+namespace HMACSHA1 {
+
+    /**
+     * @brief SHA-1 압축 함수 (블록 1개)
+     * @param state 5워드 해시 상태 (갱신됨)
+     * @param block 64바이트 입력 블록
+     */
+    void compress(uint32_t state[5], const unsigned char block[SHA1_BLOCK_LENGTH]);
+
+    /**
+     * @brief 원본 키로부터 HMAC 중간 상태 계산
+     * @param key 디코딩된 시크릿 키
+     * @param key_len 키 길이
+     * @param state 결과를 받을 키 상태
+     * @return 성공 시 true
+     */
+    bool precompute(const unsigned char* key, size_t key_len, HMACKeyState& state);
+
+    /**
+     * @brief 8바이트 빅엔디언 카운터에 대한 HMAC-SHA1 계산 (힙 할당 없음)
+     * @param state 미리 계산된 키 상태
+     * @param counter TOTP 시간 카운터
+     * @param digest 20바이트 결과
+     */
+    void macCounter(const HMACKeyState& state, uint64_t counter, unsigned char digest[SHA1_DIGEST_LENGTH]);
+
+    /**
+     * @brief RFC 4226 dynamic truncation 후 6자리 코드 반환
+     */
+    int truncate(const unsigned char digest[SHA1_DIGEST_LENGTH]);
+
+    /**
+     * @brief 미리 계산된 키 상태로 TOTP 코드 계산
+     * @param state 키 상태
+     * @param counter 시간 카운터 (time / OTP_PERIOD)
+     * @return 6자리 TOTP 코드
+     */
+    inline int totpCode(const HMACKeyState& state, uint64_t counter) {
+        unsigned char digest[SHA1_DIGEST_LENGTH];
+        macCounter(state, counter, digest);
+        return truncate(digest);
+    }
+}
+
+#endif // HMAC_SHA1_H
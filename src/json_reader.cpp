@@ -0,0 +1,449 @@
+#include "json_reader.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Json {
+
+    namespace {
+
+        inline bool isSpace(char c) {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+        }
+
+        inline bool isDigit(char c) {
+            return c >= '0' && c <= '9';
+        }
+
+        inline int hexValue(char c) {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return -1;
+        }
+
+        bool readHex4(std::string_view raw, size_t pos, uint32_t& value) {
+            if (pos + 4 > raw.size()) return false;
+            value = 0;
+            for (size_t i = 0; i < 4; i++) {
+                int digit = hexValue(raw[pos + i]);
+                if (digit < 0) return false;
+                value = (value << 4) | static_cast<uint32_t>(digit);
+            }
+            return true;
+        }
+
+        size_t encodeUTF8(uint32_t cp, char* out) {
+            if (cp < 0x80) {
+                out[0] = static_cast<char>(cp);
+                return 1;
+            }
+            if (cp < 0x800) {
+                out[0] = static_cast<char>(0xC0 | (cp >> 6));
+                out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+                return 2;
+            }
+            if (cp < 0x10000) {
+                out[0] = static_cast<char>(0xE0 | (cp >> 12));
+                out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+                return 3;
+            }
+            out[0] = static_cast<char>(0xF0 | (cp >> 18));
+            out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+            return 4;
+        }
+
+        // 문자열 스캔 중 멈춰야 하는 바이트 ('"', '\\', 제어 문자)
+        struct StringStopTable {
+            bool stop[256] = {};
+            constexpr StringStopTable() {
+                for (int c = 0; c < 0x20; c++) stop[c] = true;
+                stop[static_cast<unsigned char>('"')] = true;
+                stop[static_cast<unsigned char>('\\')] = true;
+            }
+        };
+        constexpr StringStopTable STRING_STOP;
+
+        constexpr size_t KEY_BUFFER_SIZE = 128;   // 이스케이프된 키 비교용 (더 긴 키는 일치하지 않는 것으로 처리)
+    }
+
+    Tokenizer::Tokenizer(std::string_view input, Limits limits)
+        : input(input), limits(limits) {
+        this->limits.max_depth = std::min(this->limits.max_depth, MAX_DEPTH_LIMIT);
+        if (input.size() > limits.max_bytes) {
+            err = Error::TooLarge;
+        }
+    }
+
+    Token Tokenizer::fail(Error e) {
+        if (err == Error::None) {
+            err = e;
+        }
+        current_text = {};
+        return Token::Error;
+    }
+
+    Token Tokenizer::next() {
+        if (err != Error::None) {
+            return Token::Error;
+        }
+
+        for (;;) {
+            while (pos < input.size() && isSpace(input[pos])) pos++;
+
+            if (pos == input.size()) {
+                return expect == Expect::Done ? Token::End : fail(Error::Truncated);
+            }
+
+            char c = input[pos];
+            switch (expect) {
+            case Expect::Value:
+                return readValue(c);
+
+            case Expect::ValueOrEnd:
+                if (c == ']') return close(false);
+                return readValue(c);
+
+            case Expect::KeyOrEnd:
+                if (c == '}') return close(true);
+                if (c != '"') return fail(Error::Syntax);
+                return readString(Token::Key);
+
+            case Expect::Key:
+                if (c != '"') return fail(Error::Syntax);
+                return readString(Token::Key);
+
+            case Expect::Colon:
+                if (c != ':') return fail(Error::Syntax);
+                pos++;
+                expect = Expect::Value;
+                continue;
+
+            case Expect::CommaOrEnd:
+                if (c == ',') {
+                    pos++;
+                    expect = inObject() ? Expect::Key : Expect::Value;
+                    continue;
+                }
+                if (c == '}' && inObject()) return close(true);
+                if (c == ']' && !inObject()) return close(false);
+                return fail(Error::Syntax);
+
+            case Expect::Done:
+                return fail(Error::Syntax);
+            }
+        }
+    }
+
+    Token Tokenizer::peek() const {
+        Tokenizer copy = *this;
+        return copy.next();
+    }
+
+    Token Tokenizer::readValue(char c) {
+        switch (c) {
+        case '{': return open(true);
+        case '[': return open(false);
+        case '"': return readString(Token::String);
+        case 't': return readLiteral("true", Token::True);
+        case 'f': return readLiteral("false", Token::False);
+        case 'n': return readLiteral("null", Token::Null);
+        default:
+            if (c == '-' || isDigit(c)) return readNumber();
+            return fail(Error::Syntax);
+        }
+    }
+
+    Token Tokenizer::readString(Token kind) {
+        size_t start = ++pos;
+        bool escaped = false;
+
+        const char* data = input.data();
+        const size_t size = input.size();
+        while (pos < size) {
+            // 일반 문자는 표 한 번으로 건너뜀
+            while (pos < size && !STRING_STOP.stop[static_cast<unsigned char>(data[pos])]) pos++;
+            if (pos == size) break;
+
+            char c = data[pos];
+            if (c == '"') {
+                current_text = input.substr(start, pos - start);
+                current_escaped = escaped;
+                pos++;
+                if (kind == Token::Key) {
+                    expect = Expect::Colon;
+                } else {
+                    afterValue();
+                }
+                return kind;
+            }
+            if (static_cast<unsigned char>(c) < 0x20) {
+                return fail(Error::BadString);
+            }
+            if (c == '\\') {
+                escaped = true;
+                if (++pos == input.size()) break;
+                switch (input[pos]) {
+                case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+                    break;
+                case 'u': {
+                    uint32_t unit;
+                    if (!readHex4(input, pos + 1, unit)) {
+                        return pos + 5 > input.size() ? fail(Error::Truncated) : fail(Error::BadString);
+                    }
+                    pos += 4;
+                    break;
+                }
+                default:
+                    return fail(Error::BadString);
+                }
+            }
+            pos++;
+        }
+        return fail(Error::Truncated);
+    }
+
+    Token Tokenizer::readNumber() {
+        size_t start = pos;
+        if (input[pos] == '-') pos++;
+
+        // 정수부: 0 또는 0이 아닌 숫자로 시작
+        if (pos == input.size()) return fail(Error::Truncated);
+        if (input[pos] == '0') {
+            pos++;
+        } else if (isDigit(input[pos])) {
+            while (pos < input.size() && isDigit(input[pos])) pos++;
+        } else {
+            return fail(Error::Syntax);
+        }
+
+        if (pos < input.size() && input[pos] == '.') {
+            pos++;
+            if (pos == input.size()) return fail(Error::Truncated);
+            if (!isDigit(input[pos])) return fail(Error::Syntax);
+            while (pos < input.size() && isDigit(input[pos])) pos++;
+        }
+
+        if (pos < input.size() && (input[pos] == 'e' || input[pos] == 'E')) {
+            pos++;
+            if (pos < input.size() && (input[pos] == '+' || input[pos] == '-')) pos++;
+            if (pos == input.size()) return fail(Error::Truncated);
+            if (!isDigit(input[pos])) return fail(Error::Syntax);
+            while (pos < input.size() && isDigit(input[pos])) pos++;
+        }
+
+        current_text = input.substr(start, pos - start);
+        current_escaped = false;
+        afterValue();
+        return Token::Number;
+    }
+
+    Token Tokenizer::readLiteral(std::string_view word, Token kind) {
+        std::string_view rest = input.substr(pos, word.size());
+        if (rest != word) {
+            return word.compare(0, rest.size(), rest) == 0 ? fail(Error::Truncated) : fail(Error::Syntax);
+        }
+        pos += word.size();
+        current_text = {};
+        afterValue();
+        return kind;
+    }
+
+    Token Tokenizer::open(bool is_object) {
+        if (level >= limits.max_depth) {
+            return fail(Error::TooDeep);
+        }
+        uint64_t bit = uint64_t(1) << level;
+        object_bits = is_object ? (object_bits | bit) : (object_bits & ~bit);
+        level++;
+        pos++;
+        current_text = {};
+        expect = is_object ? Expect::KeyOrEnd : Expect::ValueOrEnd;
+        return is_object ? Token::ObjectBegin : Token::ArrayBegin;
+    }
+
+    Token Tokenizer::close(bool is_object) {
+        level--;
+        pos++;
+        current_text = {};
+        afterValue();
+        return is_object ? Token::ObjectEnd : Token::ArrayEnd;
+    }
+
+    void Tokenizer::afterValue() {
+        expect = level == 0 ? Expect::Done : Expect::CommaOrEnd;
+    }
+
+    bool Tokenizer::skipValue() {
+        unsigned start_level = level;
+        Token token = next();
+        if (token == Token::ObjectBegin || token == Token::ArrayBegin) {
+            while (level > start_level) {
+                token = next();
+                if (token == Token::Error) return false;
+            }
+            return true;
+        }
+        return token != Token::Error && token != Token::End &&
+               token != Token::ObjectEnd && token != Token::ArrayEnd;
+    }
+
+    bool unescape(std::string_view raw, char* buf, size_t capacity, std::string_view& out) {
+        if (raw.find('\\') == std::string_view::npos) {
+            out = raw;
+            return true;
+        }
+
+        size_t n = 0;
+        for (size_t i = 0; i < raw.size(); i++) {
+            char c = raw[i];
+            if (c != '\\') {
+                if (n == capacity) return false;
+                buf[n++] = c;
+                continue;
+            }
+
+            if (++i == raw.size()) return false;
+            char decoded;
+            switch (raw[i]) {
+            case '"': decoded = '"'; break;
+            case '\\': decoded = '\\'; break;
+            case '/': decoded = '/'; break;
+            case 'b': decoded = '\b'; break;
+            case 'f': decoded = '\f'; break;
+            case 'n': decoded = '\n'; break;
+            case 'r': decoded = '\r'; break;
+            case 't': decoded = '\t'; break;
+            case 'u': {
+                uint32_t cp;
+                if (!readHex4(raw, i + 1, cp)) return false;
+                i += 4;
+
+                // 서로게이트 쌍은 \uD8xx\uDCxx 형태로만 허용
+                if (cp >= 0xDC00 && cp <= 0xDFFF) return false;
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    uint32_t low;
+                    if (i + 2 >= raw.size() || raw[i + 1] != '\\' || raw[i + 2] != 'u' ||
+                        !readHex4(raw, i + 3, low) || low < 0xDC00 || low > 0xDFFF) {
+                        return false;
+                    }
+                    i += 6;
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                }
+
+                char utf8[4];
+                size_t len = encodeUTF8(cp, utf8);
+                if (capacity - n < len) return false;
+                memcpy(buf + n, utf8, len);
+                n += len;
+                continue;
+            }
+            default:
+                return false;
+            }
+
+            if (n == capacity) return false;
+            buf[n++] = decoded;
+        }
+
+        out = std::string_view(buf, n);
+        return true;
+    }
+
+    Error readStringFields(Tokenizer& tokenizer, const std::string_view* keys, std::string_view* values,
+                           bool* found, size_t count, char* scratch, size_t scratch_size) {
+        for (size_t i = 0; i < count; i++) {
+            values[i] = {};
+            if (found) found[i] = false;
+        }
+
+        Token token = tokenizer.next();
+        if (token != Token::ObjectBegin) {
+            return token == Token::Error ? tokenizer.error() : Error::NotObject;
+        }
+        const unsigned object_level = tokenizer.depth();
+        size_t scratch_used = 0;
+
+        for (;;) {
+            token = tokenizer.next();
+            if (token == Token::ObjectEnd) {
+                return Error::None;
+            }
+            if (token != Token::Key) {
+                return tokenizer.error();
+            }
+
+            // 키도 이스케이프될 수 있으므로 디코딩 후 비교
+            std::string_view key = tokenizer.text();
+            char key_buffer[KEY_BUFFER_SIZE];
+            if (tokenizer.hasEscapes() && !unescape(key, key_buffer, sizeof(key_buffer), key)) {
+                key = {};
+            }
+
+            size_t index = count;
+            for (size_t i = 0; i < count; i++) {
+                if (keys[i] == key) {
+                    index = i;
+                    break;
+                }
+            }
+
+            if (index == count) {
+                if (!tokenizer.skipValue()) return tokenizer.error();
+                continue;
+            }
+
+            token = tokenizer.next();
+            if (token == Token::String) {
+                std::string_view value = tokenizer.text();
+                if (tokenizer.hasEscapes()) {
+                    if (!unescape(value, scratch + scratch_used, scratch_size - scratch_used, value)) {
+                        return Error::BadString;
+                    }
+                    scratch_used += value.size();
+                }
+                values[index] = value;
+                if (found) found[index] = true;
+                continue;
+            }
+
+            values[index] = {};
+            if (found) found[index] = false;
+            if (token == Token::ObjectBegin || token == Token::ArrayBegin) {
+                while (tokenizer.depth() > object_level) {
+                    if (tokenizer.next() == Token::Error) return tokenizer.error();
+                }
+            } else if (token == Token::Error) {
+                return tokenizer.error();
+            }
+        }
+    }
+
+    Error parseStringFields(std::string_view body, const std::string_view* keys, std::string_view* values,
+                            size_t count, char* scratch, size_t scratch_size, Limits limits) {
+        Tokenizer tokenizer(body, limits);
+        Error error = readStringFields(tokenizer, keys, values, nullptr, count, scratch, scratch_size);
+        if (error != Error::None) {
+            return error;
+        }
+        if (tokenizer.next() != Token::End) {
+            return tokenizer.error();
+        }
+        return Error::None;
+    }
+
+    const char* errorMessage(Error error) {
+        switch (error) {
+        case Error::None: return "ok";
+        case Error::TooLarge: return "request body too large";
+        case Error::TooDeep: return "JSON nested too deeply";
+        case Error::Syntax: return "malformed JSON";
+        case Error::BadString: return "invalid JSON string";
+        case Error::Truncated: return "truncated JSON";
+        case Error::NotObject: return "JSON object expected";
+        }
+        return "malformed JSON";
+    }
+}
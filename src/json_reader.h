@@ -0,0 +1,159 @@
+#ifndef JSON_READER_H
+#define JSON_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @brief 요청 본문용 스트리밍 JSON 토크나이저 (할당 없음)
+ *
+ * 본문 버퍼 위의 string_view만 반환하며 DOM을 만들지 않습니다.
+ * - 문자열은 따옴표를 뺀 원문 그대로 반환하고, 이스케이프가 있을 때만
+ *   호출자가 준 버퍼에 디코딩합니다 (Json::unescape).
+ * - 본문 크기와 중첩 깊이는 Limits로 제한하며, 초과 시 즉시 오류로 멈춥니다.
+ * - 오류는 한 번 발생하면 유지되며, 이후 next()는 항상 Token::Error를 반환합니다.
+ */
+namespace Json {
+
+    enum class Token : uint8_t {
+        ObjectBegin,
+        ObjectEnd,
+        ArrayBegin,
+        ArrayEnd,
+        Key,        // 객체 키 (text()는 따옴표 안의 원문)
+        String,     // 문자열 값 (text()는 따옴표 안의 원문)
+        Number,     // 숫자 값 (text()는 원문)
+        True,
+        False,
+        Null,
+        End,        // 최상위 값이 끝났고 뒤에 공백만 남음
+        Error
+    };
+
+    enum class Error : uint8_t {
+        None,
+        TooLarge,       // 본문이 max_bytes를 넘음
+        TooDeep,        // 중첩 깊이가 max_depth를 넘음
+        Syntax,         // 문법 오류 (잘못된 토큰, 구분자 누락, 뒤에 남은 문자 등)
+        BadString,      // 잘못된 이스케이프, 제어 문자, 닫히지 않은 문자열
+        Truncated,      // 값이 끝나기 전에 본문이 끝남
+        NotObject       // 객체가 와야 할 자리에 다른 값이 옴
+    };
+
+    /**
+     * @brief 파싱 제한
+     */
+    struct Limits {
+        size_t max_bytes = 16 * 1024;
+        unsigned max_depth = 16;        // 최대 64
+    };
+
+    constexpr unsigned MAX_DEPTH_LIMIT = 64;
+
+    class Tokenizer {
+    public:
+        explicit Tokenizer(std::string_view input, Limits limits = Limits());
+
+        /**
+         * @brief 다음 토큰 읽기 (':'와 ','는 내부에서 검사하고 건너뜀)
+         */
+        Token next();
+
+        /**
+         * @brief 다음 토큰을 소비하지 않고 확인
+         */
+        Token peek() const;
+
+        /**
+         * @brief 현재 Key/String/Number 토큰의 원문 (본문 버퍼를 가리킴)
+         */
+        std::string_view text() const { return current_text; }
+
+        /**
+         * @brief 현재 문자열 토큰에 이스케이프가 있는지 (없으면 text()를 그대로 사용 가능)
+         */
+        bool hasEscapes() const { return current_escaped; }
+
+        /**
+         * @brief 다음 값 하나를 통째로 건너뜀 (객체/배열이면 닫힐 때까지)
+         * @return 오류 없이 건너뛰었으면 true
+         */
+        bool skipValue();
+
+        Error error() const { return err; }
+        size_t offset() const { return pos; }
+        unsigned depth() const { return level; }
+
+    private:
+        enum class Expect : uint8_t {
+            Value,          // 값
+            ValueOrEnd,     // '[' 직후: 값 또는 ']'
+            KeyOrEnd,       // '{' 직후: 키 또는 '}'
+            Key,            // ',' 직후 객체 안: 키
+            Colon,          // 키 직후: ':'
+            CommaOrEnd,     // 값 직후 컨테이너 안: ',' 또는 닫는 괄호
+            Done            // 최상위 값 완료
+        };
+
+        std::string_view input;
+        Limits limits;
+        size_t pos = 0;
+        unsigned level = 0;
+        uint64_t object_bits = 0;   // 깊이별 컨테이너 종류 (1: 객체, 0: 배열)
+        Expect expect = Expect::Value;
+        Error err = Error::None;
+
+        std::string_view current_text;
+        bool current_escaped = false;
+
+        Token fail(Error e);
+        Token readValue(char c);
+        Token readString(Token kind);
+        Token readNumber();
+        Token readLiteral(std::string_view word, Token kind);
+        Token open(bool is_object);
+        Token close(bool is_object);
+        void afterValue();
+        bool inObject() const { return level > 0 && ((object_bits >> (level - 1)) & 1); }
+    };
+
+    /**
+     * @brief 문자열 원문의 이스케이프를 UTF-8로 디코딩
+     * @param raw Tokenizer::text()로 얻은 원문 (따옴표 제외)
+     * @param buf 출력 버퍼
+     * @param capacity 출력 버퍼 크기
+     * @param out 결과 (이스케이프가 없으면 raw 그대로, 있으면 buf를 가리킴)
+     * @return 잘못된 이스케이프이거나 버퍼가 부족하면 false
+     */
+    bool unescape(std::string_view raw, char* buf, size_t capacity, std::string_view& out);
+
+    /**
+     * @brief 객체 하나에서 지정한 키의 문자열 값만 추출
+     *
+     * 토크나이저는 객체 시작('{') 직전에 있어야 하며, 호출 후에는 객체 끝('}') 직후에 있습니다.
+     * 지정하지 않은 키의 값은 종류와 무관하게 건너뛰고, 같은 키가 여러 번 나오면 마지막 값을 씁니다.
+     * 지정한 키의 값이 문자열이 아니면 찾지 못한 것으로 둡니다.
+     * 이스케이프가 있는 값은 scratch에 디코딩되므로 scratch는 결과를 쓰는 동안 유지되어야 합니다.
+     * @param keys 찾을 키 목록
+     * @param values 키별 결과 (찾지 못하면 빈 값)
+     * @param found 키별 발견 여부 (nullptr이면 생략)
+     * @return 오류 종류 (Error::None이면 성공)
+     */
+    Error readStringFields(Tokenizer& tokenizer, const std::string_view* keys, std::string_view* values,
+                           bool* found, size_t count, char* scratch, size_t scratch_size);
+
+    /**
+     * @brief 본문 전체가 객체 하나인 요청에서 문자열 필드 추출 (객체 뒤에 다른 값이 있으면 오류)
+     * @return 오류 종류 (Error::None이면 성공)
+     */
+    Error parseStringFields(std::string_view body, const std::string_view* keys, std::string_view* values,
+                            size_t count, char* scratch, size_t scratch_size, Limits limits = Limits());
+
+    /**
+     * @brief 오류 설명 (응답 메시지용)
+     */
+    const char* errorMessage(Error error);
+}
+
+#endif // JSON_READER_H
@@ -0,0 +1,164 @@
+#include "json_writer.h"
+#include <charconv>
+
+namespace Json {
+
+    void appendEscaped(std::string& out, std::string_view value) {
+        static const char hex[] = "0123456789abcdef";
+
+        // 이스케이프가 필요 없는 구간은 한 번에 복사
+        size_t run = 0;
+        for (size_t i = 0; i < value.size(); i++) {
+            unsigned char c = static_cast<unsigned char>(value[i]);
+            if (c >= 0x20 && c != '"' && c != '\\') {
+                continue;
+            }
+
+            out.append(value.data() + run, i - run);
+            run = i + 1;
+            switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default: {
+                char escaped[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+                out.append(escaped, sizeof(escaped));
+            }
+            }
+        }
+        out.append(value.data() + run, value.size() - run);
+    }
+
+    Writer::Writer() {
+        buffer.reserve(INITIAL_CAPACITY);
+    }
+
+    Writer& Writer::local() {
+        thread_local Writer writer;
+        writer.clear();
+        return writer;
+    }
+
+    void Writer::clear() {
+        if (buffer.capacity() > RETAIN_LIMIT) {
+            std::string().swap(buffer);
+            buffer.reserve(INITIAL_CAPACITY);
+        }
+        buffer.clear();     // 용량은 유지
+        depth = 0;
+        has_items = 0;
+        after_key = false;
+    }
+
+    void Writer::separate() {
+        if (after_key) {
+            after_key = false;
+            return;
+        }
+        if (depth == 0) {
+            return;
+        }
+        uint64_t bit = uint64_t(1) << (depth - 1);
+        if (has_items & bit) {
+            buffer += ',';
+        }
+        has_items |= bit;
+    }
+
+    void Writer::open(char c) {
+        separate();
+        buffer += c;
+        if (depth < MAX_DEPTH) {
+            has_items &= ~(uint64_t(1) << depth);
+        }
+        depth++;
+    }
+
+    void Writer::close(char c) {
+        buffer += c;
+        if (depth > 0) depth--;
+    }
+
+    Writer& Writer::beginObject() {
+        open('{');
+        return *this;
+    }
+
+    Writer& Writer::endObject() {
+        close('}');
+        return *this;
+    }
+
+    Writer& Writer::beginArray() {
+        open('[');
+        return *this;
+    }
+
+    Writer& Writer::endArray() {
+        close(']');
+        return *this;
+    }
+
+    Writer& Writer::key(std::string_view name) {
+        separate();
+        buffer += '"';
+        appendEscaped(buffer, name);
+        buffer += "\":";
+        after_key = true;
+        return *this;
+    }
+
+    Writer& Writer::string(std::string_view value) {
+        separate();
+        buffer += '"';
+        appendEscaped(buffer, value);
+        buffer += '"';
+        return *this;
+    }
+
+    Writer& Writer::string(std::string_view prefix, std::string_view value, std::string_view suffix) {
+        separate();
+        buffer += '"';
+        appendEscaped(buffer, prefix);
+        appendEscaped(buffer, value);
+        appendEscaped(buffer, suffix);
+        buffer += '"';
+        return *this;
+    }
+
+    Writer& Writer::number(uint64_t value) {
+        separate();
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        buffer.append(digits, static_cast<size_t>(result.ptr - digits));
+        return *this;
+    }
+
+    Writer& Writer::number(int64_t value) {
+        separate();
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        buffer.append(digits, static_cast<size_t>(result.ptr - digits));
+        return *this;
+    }
+
+    Writer& Writer::boolean(bool value) {
+        separate();
+        buffer += value ? "true" : "false";
+        return *this;
+    }
+
+    Writer& Writer::null() {
+        separate();
+        buffer += "null";
+        return *this;
+    }
+
+    Writer& Writer::raw(std::string_view json) {
+        separate();
+        buffer += json;
+        return *this;
+    }
+}
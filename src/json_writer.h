@@ -0,0 +1,85 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Json {
+
+    /**
+     * @brief 문자열을 JSON 이스케이프하여 out 뒤에 붙임 (따옴표는 붙이지 않음)
+     */
+    void appendEscaped(std::string& out, std::string_view value);
+
+    /**
+     * @brief 스레드별 재사용 버퍼에 JSON 응답을 쓰는 빌더
+     *
+     * 버퍼는 스레드마다 하나이며 응답이 끝나도 용량을 유지하므로,
+     * 요청 처리 중에는 버퍼 재할당이 없습니다 (더 큰 응답이 처음 나올 때만 늘어남).
+     * 큰 목록 응답 등으로 RETAIN_LIMIT를 넘게 커진 버퍼는 다음 응답 전에 초기 크기로 되돌립니다.
+     * 쉼표는 자동으로 넣고, 문자열 값과 키는 항상 이스케이프합니다.
+     *
+     * 사용 예:
+     *   Json::Writer& json = Json::Writer::local();
+     *   json.beginObject().key("success").boolean(true).key("user_id").string(id).endObject();
+     *   send(json.view());
+     */
+    class Writer {
+    public:
+        static constexpr size_t INITIAL_CAPACITY = 4096;
+        static constexpr size_t RETAIN_LIMIT = 1024 * 1024;    // 이보다 커진 버퍼는 다음 응답 전에 반납
+        static constexpr unsigned MAX_DEPTH = 64;
+
+        Writer();
+
+        /**
+         * @brief 현재 스레드의 빌더 (내용을 비운 상태로 반환)
+         *
+         * 반환된 참조는 같은 스레드에서 다음 local() 호출 전까지만 유효합니다.
+         */
+        static Writer& local();
+
+        void clear();
+
+        Writer& beginObject();
+        Writer& endObject();
+        Writer& beginArray();
+        Writer& endArray();
+
+        Writer& key(std::string_view name);
+        Writer& string(std::string_view value);
+
+        /**
+         * @brief 세 조각을 이어 붙인 문자열 값 하나를 씀 (메시지 중간에 사용자 ID를 넣을 때)
+         */
+        Writer& string(std::string_view prefix, std::string_view value, std::string_view suffix);
+
+        Writer& number(uint64_t value);
+        Writer& number(int64_t value);
+        Writer& boolean(bool value);
+        Writer& null();
+
+        /**
+         * @brief 이미 JSON인 조각을 그대로 값으로 씀 (쉼표만 처리)
+         */
+        Writer& raw(std::string_view json);
+
+        std::string_view view() const { return buffer; }
+        size_t size() const { return buffer.size(); }
+        size_t capacity() const { return buffer.capacity(); }
+
+    private:
+        std::string buffer;
+        unsigned depth = 0;
+        uint64_t has_items = 0;     // 깊이별 "이미 값이 있음" 비트 (쉼표 판단)
+        bool after_key = false;
+
+        void separate();
+        void open(char c);
+        void close(char c);
+    };
+}
+
+#endif // JSON_WRITER_H
@@ -0,0 +1,375 @@
+#include "logger.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+namespace Log {
+
+    namespace detail {
+        std::atomic<uint8_t> runtime_level{static_cast<uint8_t>(Level::Info)};
+    }
+
+    namespace {
+
+        constexpr size_t TEXT_CAPACITY = sizeof(Entry::text);
+        constexpr auto WRITER_INTERVAL = std::chrono::milliseconds(5);
+
+        static_assert((RING_CAPACITY & (RING_CAPACITY - 1)) == 0, "RING_CAPACITY는 2의 거듭제곱이어야 합니다");
+
+        /**
+         * @brief 스레드 전용 SPSC 링 (생산자: 소유 스레드, 소비자: writer 스레드)
+         */
+        struct Ring {
+            Entry entries[RING_CAPACITY];
+            alignas(64) std::atomic<uint64_t> head{0};     // 생산자가 다음에 쓸 위치
+            alignas(64) std::atomic<uint64_t> tail{0};     // 소비자가 다음에 읽을 위치
+            std::atomic<uint64_t> dropped{0};
+            std::atomic<bool> closed{false};               // 소유 스레드 종료
+            uint32_t thread_id = 0;
+        };
+
+        const char* levelName(Level level) {
+            switch (level) {
+                case Level::Debug: return "DEBUG";
+                case Level::Info:  return "INFO ";
+                case Level::Warn:  return "WARN ";
+                case Level::Error: return "ERROR";
+                default:           return "?    ";
+            }
+        }
+
+        uint64_t realtimeNs() {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+        }
+
+        void writeAll(int fd, const std::string& data) {
+            size_t written = 0;
+            while (written < data.size()) {
+                ssize_t n = ::write(fd, data.data() + written, data.size() - written);
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) return;
+                written += static_cast<size_t>(n);
+            }
+        }
+
+        /**
+         * @brief 링 목록과 writer 스레드 (프로세스 종료 시까지 유지)
+         */
+        class Writer {
+            std::mutex registry_mutex;
+            std::vector<std::shared_ptr<Ring>> rings;
+            uint32_t next_thread_id = 1;
+
+            std::mutex drain_mutex;                 // writer 스레드와 flush() 직렬화
+            std::mutex wake_mutex;
+            std::condition_variable wake_cv;
+            std::thread thread;
+            bool stopping = false;
+
+            uint64_t reported_drops = 0;
+            uint64_t retired_drops = 0;             // 정리된 링에서 버려진 메시지 수
+            uint64_t last_drop_report_ns = 0;
+            time_t cached_second = -1;
+            char cached_prefix[32] = {0};
+
+            void formatEntry(const Entry& entry, uint32_t thread_id, std::string& out) {
+                time_t seconds = static_cast<time_t>(entry.timestamp_ns / 1000000000ull);
+                if (seconds != cached_second) {
+                    struct tm tm_utc;
+                    gmtime_r(&seconds, &tm_utc);
+                    strftime(cached_prefix, sizeof(cached_prefix), "%Y-%m-%dT%H:%M:%S", &tm_utc);
+                    cached_second = seconds;
+                }
+
+                char header[96];
+                int n = snprintf(header, sizeof(header), "%s.%06uZ %s t%u ", cached_prefix,
+                                 static_cast<unsigned>((entry.timestamp_ns / 1000) % 1000000),
+                                 levelName(entry.level), thread_id);
+                out.append(header, static_cast<size_t>(n));
+                out.append(entry.text, entry.length);
+                out.push_back('\n');
+            }
+
+        public:
+            std::atomic<bool> stopped{false};
+            std::atomic<int> output_fd{-1};
+
+            Writer() {
+                thread = std::thread([this] { run(); });
+            }
+
+            std::shared_ptr<Ring> registerRing() {
+                auto ring = std::make_shared<Ring>();
+                std::lock_guard<std::mutex> lock(registry_mutex);
+                ring->thread_id = next_thread_id++;
+                rings.push_back(ring);
+                return ring;
+            }
+
+            void wake() { wake_cv.notify_one(); }
+
+            /**
+             * @brief 모든 링의 공개된 항목을 시간순으로 출력
+             */
+            void drain() {
+                std::lock_guard<std::mutex> drain_lock(drain_mutex);
+
+                std::vector<std::shared_ptr<Ring>> snapshot;
+                {
+                    std::lock_guard<std::mutex> lock(registry_mutex);
+                    // 종료된 스레드의 빈 링 정리
+                    rings.erase(std::remove_if(rings.begin(), rings.end(), [this](const std::shared_ptr<Ring>& r) {
+                        bool finished = r->closed.load(std::memory_order_acquire) &&
+                                        r->tail.load(std::memory_order_relaxed) == r->head.load(std::memory_order_acquire);
+                        if (finished) retired_drops += r->dropped.load(std::memory_order_relaxed);
+                        return finished;
+                    }), rings.end());
+                    snapshot = rings;
+                }
+
+                struct Pending {
+                    const Entry* entry;
+                    uint32_t thread_id;
+                };
+                std::vector<Pending> pending;
+                std::vector<uint64_t> heads(snapshot.size());
+                uint64_t drops = retired_drops;
+
+                for (size_t r = 0; r < snapshot.size(); r++) {
+                    Ring& ring = *snapshot[r];
+                    uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+                    heads[r] = ring.head.load(std::memory_order_acquire);
+                    for (uint64_t i = tail; i < heads[r]; i++) {
+                        pending.push_back({&ring.entries[i & (RING_CAPACITY - 1)], ring.thread_id});
+                    }
+                    drops += ring.dropped.load(std::memory_order_relaxed);
+                }
+
+                if (!pending.empty()) {
+                    std::stable_sort(pending.begin(), pending.end(), [](const Pending& a, const Pending& b) {
+                        return a.entry->timestamp_ns < b.entry->timestamp_ns;
+                    });
+
+                    std::string out;
+                    std::string err;
+                    out.reserve(pending.size() * 128);
+                    int fd = output_fd.load(std::memory_order_relaxed);
+                    for (const auto& p : pending) {
+                        bool to_err = fd < 0 && p.entry->level >= Level::Warn;
+                        formatEntry(*p.entry, p.thread_id, to_err ? err : out);
+                    }
+                    if (!out.empty()) writeAll(fd < 0 ? STDOUT_FILENO : fd, out);
+                    if (!err.empty()) writeAll(STDERR_FILENO, err);
+                }
+
+                // 출력이 끝난 뒤에야 생산자가 항목을 재사용할 수 있음
+                for (size_t r = 0; r < snapshot.size(); r++) {
+                    snapshot[r]->tail.store(heads[r], std::memory_order_release);
+                }
+
+                // 버림 알림은 초당 한 번으로 제한 (종료 시에는 즉시)
+                uint64_t now = realtimeNs();
+                if (drops > reported_drops && (stopped.load(std::memory_order_relaxed) || now - last_drop_report_ns >= 1000000000ull)) {
+                    last_drop_report_ns = now;
+                    std::string notice = "[LOGGER] " + std::to_string(drops - reported_drops) +
+                                         " messages dropped (ring buffer full)\n";
+                    writeAll(STDERR_FILENO, notice);
+                    reported_drops = drops;
+                }
+            }
+
+            void run() {
+                std::unique_lock<std::mutex> lock(wake_mutex);
+                while (!stopping) {
+                    wake_cv.wait_for(lock, WRITER_INTERVAL);
+                    lock.unlock();
+                    drain();
+                    lock.lock();
+                }
+            }
+
+            void stop() {
+                if (stopped.exchange(true)) {
+                    return;
+                }
+                {
+                    std::lock_guard<std::mutex> lock(wake_mutex);
+                    stopping = true;
+                }
+                wake_cv.notify_one();
+                if (thread.joinable()) {
+                    thread.join();
+                }
+                drain();
+            }
+
+            uint64_t droppedTotal() {
+                std::lock_guard<std::mutex> lock(registry_mutex);
+                uint64_t total = retired_drops;
+                for (const auto& ring : rings) total += ring->dropped.load(std::memory_order_relaxed);
+                return total;
+            }
+        };
+
+        // 종료 중인 스레드가 로그를 남길 수 있으므로 소멸시키지 않음 (atexit에서 정리)
+        Writer& writer() {
+            static Writer* instance = [] {
+                Writer* w = new Writer();
+                std::atexit([] { writer().stop(); });
+                return w;
+            }();
+            return *instance;
+        }
+
+        /**
+         * @brief 스레드 종료 시 링을 닫힘으로 표시 (남은 항목은 writer가 출력 후 정리)
+         */
+        struct RingHandle {
+            std::shared_ptr<Ring> ring;
+            ~RingHandle() {
+                if (ring) ring->closed.store(true, std::memory_order_release);
+            }
+        };
+
+        thread_local RingHandle ring_handle;
+        thread_local Entry sync_entry;   // 링이 가득 찼거나 writer가 종료된 경우 사용
+    }
+
+    void setLevel(Level level) {
+        detail::runtime_level.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+    }
+
+    Level level() {
+        return static_cast<Level>(detail::runtime_level.load(std::memory_order_relaxed));
+    }
+
+    bool parseLevel(std::string_view name, Level& level) {
+        if (name == "debug") level = Level::Debug;
+        else if (name == "info") level = Level::Info;
+        else if (name == "warn") level = Level::Warn;
+        else if (name == "error") level = Level::Error;
+        else if (name == "off") level = Level::Off;
+        else return false;
+        return true;
+    }
+
+    void setOutput(int fd) {
+        flush();
+        writer().output_fd.store(fd, std::memory_order_relaxed);
+    }
+
+    void flush() {
+        writer().drain();
+    }
+
+    void shutdown() {
+        writer().stop();
+    }
+
+    uint64_t droppedCount() {
+        return writer().droppedTotal();
+    }
+
+    Line::Line(Level level, const char* component) {
+        Writer& w = writer();
+        entry = &sync_entry;
+
+        if (!w.stopped.load(std::memory_order_acquire)) {
+            if (!ring_handle.ring) {
+                ring_handle.ring = w.registerRing();
+            }
+            Ring& ring = *ring_handle.ring;
+            uint64_t head = ring.head.load(std::memory_order_relaxed);
+            if (head - ring.tail.load(std::memory_order_acquire) < RING_CAPACITY) {
+                entry = &ring.entries[head & (RING_CAPACITY - 1)];
+            }
+        }
+
+        entry->timestamp_ns = realtimeNs();
+        entry->level = level;
+        if (component && *component) {
+            *this << '[' << component << "] ";
+        }
+    }
+
+    Line::~Line() {
+        if (truncated && length >= 3) {
+            memcpy(entry->text + length - 3, "...", 3);
+        }
+        entry->length = static_cast<uint32_t>(length);
+
+        if (entry != &sync_entry) {
+            Ring& ring = *ring_handle.ring;
+            uint64_t head = ring.head.load(std::memory_order_relaxed) + 1;
+            ring.head.store(head, std::memory_order_release);
+            // 오류이거나 링이 절반 이상 찼으면 주기를 기다리지 않고 writer를 깨움
+            if (entry->level >= Level::Error ||
+                head - ring.tail.load(std::memory_order_relaxed) == RING_CAPACITY / 2) {
+                writer().wake();
+            }
+            return;
+        }
+
+        Writer& w = writer();
+        if (!w.stopped.load(std::memory_order_acquire)) {
+            // 링이 가득 참: 요청 스레드를 막지 않고 버림
+            ring_handle.ring->dropped.fetch_add(1, std::memory_order_relaxed);
+            w.wake();
+            return;
+        }
+
+        // writer 종료 후 (프로세스 종료 중): 직접 출력
+        std::string line(entry->text, entry->length);
+        line.push_back('\n');
+        int fd = w.output_fd.load(std::memory_order_relaxed);
+        writeAll(fd >= 0 ? fd : (entry->level >= Level::Warn ? STDERR_FILENO : STDOUT_FILENO), line);
+    }
+
+    void Line::append(const char* data, size_t size) {
+        size_t room = TEXT_CAPACITY - length;
+        if (size > room) {
+            size = room;
+            truncated = true;
+        }
+        memcpy(entry->text + length, data, size);
+        length += size;
+    }
+
+    void Line::appendSigned(long long value) {
+        char buf[24];
+        auto result = std::to_chars(buf, buf + sizeof(buf), value);
+        append(buf, static_cast<size_t>(result.ptr - buf));
+    }
+
+    void Line::appendUnsigned(unsigned long long value) {
+        char buf[24];
+        auto result = std::to_chars(buf, buf + sizeof(buf), value);
+        append(buf, static_cast<size_t>(result.ptr - buf));
+    }
+
+    Line& Line::operator<<(double value) {
+        char buf[32];
+        int n = snprintf(buf, sizeof(buf), "%.3f", value);
+        append(buf, static_cast<size_t>(n));
+        return *this;
+    }
+
+    Line& Line::operator<<(Redacted value) {
+        char buf[32];
+        int n = snprintf(buf, sizeof(buf), "<redacted:%zu>", value.length);
+        append(buf, static_cast<size_t>(n));
+        return *this;
+    }
+}
@@ -0,0 +1,184 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * @brief 비동기 링 버퍼 로거
+ *
+ * 각 스레드는 자기 전용 단일 생산자/단일 소비자 링 버퍼에 메시지를 바로 포맷하고,
+ * 백그라운드 writer 스레드가 모든 링을 모아 시간순으로 한 번의 write로 출력합니다.
+ * 요청 처리 스레드는 stdout 잠금이나 flush를 기다리지 않으며, 링이 가득 차면
+ * 메시지를 버리고 버린 개수만 기록합니다.
+ *
+ * 레벨 필터링은 두 단계입니다.
+ * - 컴파일 시: MFA_LOG_MIN_LEVEL 미만의 MFA_LOG_* 문장은 인자 평가까지 제거됨
+ *   (기본값: NDEBUG 빌드는 Info, 그 외 Debug)
+ * - 실행 시: Log::setLevel()로 설정한 레벨 미만은 포맷하지 않음
+ *
+ * 시크릿과 OTP는 Log::redact()로 감싸서 출력하면 길이만 남습니다.
+ */
+
+#ifndef MFA_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define MFA_LOG_MIN_LEVEL 1
+#else
+#define MFA_LOG_MIN_LEVEL 0
+#endif
+#endif
+
+namespace Log {
+
+    enum class Level : uint8_t {
+        Debug = 0,
+        Info = 1,
+        Warn = 2,
+        Error = 3,
+        Off = 4
+    };
+
+    constexpr size_t ENTRY_SIZE = 256;      // 링 버퍼 항목 크기 (메시지는 잘림)
+    constexpr size_t RING_CAPACITY = 1024;  // 스레드당 항목 수 (2의 거듭제곱)
+
+    /**
+     * @brief 링 버퍼 항목
+     */
+    struct Entry {
+        uint64_t timestamp_ns;
+        uint32_t length;
+        Level level;
+        char text[ENTRY_SIZE - 16];
+    };
+
+    static_assert(sizeof(Entry) == ENTRY_SIZE, "Log::Entry 크기가 변경되었습니다");
+
+    namespace detail {
+        extern std::atomic<uint8_t> runtime_level;
+    }
+
+    constexpr int COMPILED_MIN_LEVEL = MFA_LOG_MIN_LEVEL;
+
+    /**
+     * @brief 컴파일 시 남길 레벨인지 확인 (MFA_LOG_MIN_LEVEL)
+     */
+    constexpr bool compiledIn(Level level) {
+        return static_cast<int>(level) >= COMPILED_MIN_LEVEL;
+    }
+
+    /**
+     * @brief 실행 시 레벨 확인 (포맷 전 빠른 경로)
+     */
+    inline bool enabled(Level level) {
+        return static_cast<uint8_t>(level) >= detail::runtime_level.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 실행 시 최소 레벨 설정 (컴파일 시 제거된 문장은 되살아나지 않음)
+     */
+    void setLevel(Level level);
+    Level level();
+
+    /**
+     * @brief "debug" / "info" / "warn" / "error" / "off" 문자열을 레벨로 변환
+     * @return 알 수 없는 이름이면 false
+     */
+    bool parseLevel(std::string_view name, Level& level);
+
+    /**
+     * @brief 출력 파일 디스크립터 지정 (-1이면 기본값: Warn 이상은 stderr, 나머지는 stdout)
+     */
+    void setOutput(int fd);
+
+    /**
+     * @brief 지금까지 기록된 메시지를 모두 출력할 때까지 대기
+     */
+    void flush();
+
+    /**
+     * @brief writer 스레드 종료 (남은 메시지 출력). 이후 메시지는 동기적으로 출력
+     */
+    void shutdown();
+
+    /**
+     * @brief 링이 가득 차서 버려진 메시지 수
+     */
+    uint64_t droppedCount();
+
+    /**
+     * @brief 로그에 값 대신 길이만 남기는 래퍼
+     */
+    struct Redacted {
+        size_t length;
+    };
+
+    inline Redacted redact(std::string_view value) {
+        return Redacted{value.size()};
+    }
+
+    /**
+     * @brief 한 줄의 로그 메시지를 링 버퍼 항목에 직접 포맷
+     *
+     * 생성 시 현재 스레드의 링에서 항목을 예약하고, 소멸 시 writer에 공개합니다.
+     */
+    class Line {
+        Entry* entry;
+        size_t length = 0;
+        bool truncated = false;
+
+        void append(const char* data, size_t size);
+
+    public:
+        Line(Level level, const char* component);
+        ~Line();
+
+        Line(const Line&) = delete;
+        Line& operator=(const Line&) = delete;
+
+        Line& operator<<(std::string_view value) {
+            append(value.data(), value.size());
+            return *this;
+        }
+        Line& operator<<(const std::string& value) { return *this << std::string_view(value); }
+        Line& operator<<(const char* value) { return *this << std::string_view(value ? value : "(null)"); }
+        Line& operator<<(char value) {
+            append(&value, 1);
+            return *this;
+        }
+        Line& operator<<(bool value) { return *this << (value ? "true" : "false"); }
+        Line& operator<<(double value);
+        Line& operator<<(Redacted value);
+
+        template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+        Line& operator<<(T value) {
+            if (std::is_signed<T>::value) appendSigned(static_cast<long long>(value));
+            else appendUnsigned(static_cast<unsigned long long>(value));
+            return *this;
+        }
+
+    private:
+        void appendSigned(long long value);
+        void appendUnsigned(unsigned long long value);
+    };
+}
+
+#define MFA_LOG_AT(level, component, message)                                      \
+    do {                                                                          \
+        if constexpr (Log::compiledIn(level)) {                                  \
+            if (Log::enabled(level)) {                                            \
+                Log::Line mfa_log_line_(level, component);                        \
+                mfa_log_line_ << message;                                         \
+            }                                                                     \
+        }                                                                         \
+    } while (0)
+
+#define MFA_LOG_DEBUG(component, message) MFA_LOG_AT(Log::Level::Debug, component, message)
+#define MFA_LOG_INFO(component, message) MFA_LOG_AT(Log::Level::Info, component, message)
+#define MFA_LOG_WARN(component, message) MFA_LOG_AT(Log::Level::Warn, component, message)
+#define MFA_LOG_ERROR(component, message) MFA_LOG_AT(Log::Level::Error, component, message)
+
+#endif // LOGGER_H
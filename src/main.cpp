@@ -4,6 +4,7 @@
 #include <memory>
 #include "server.h"
 #include "mfa_core.h"
+#include "logger.h"
 
 // 전역 서버 인스턴스 (시그널 핸들링용)
 std::unique_ptr<MFAServer> g_server;
@@ -26,11 +27,26 @@ void printUsage(const char* program_name) {
     std::cout << "  --cert <파일>        SSL 인증서 파일 경로" << std::endl;
     std::cout << "  --key <파일>         SSL 키 파일 경로" << std::endl;
     std::cout << "  --data <파일>        사용자 데이터 파일 경로 (기본값: data/users.dat)" << std::endl;
+    std::cout << "  --storage <방식>     사용자 저장소: memory | mapped (기본값: memory)" << std::endl;
+    std::cout << "  --log-level <레벨>   로그 레벨: debug | info | warn | error | off (기본값: info)" << std::endl;
+    std::cout << "  --max-batch <수>     일괄 인증 요청당 최대 항목 수 (기본값: " << DEFAULT_MAX_BATCH_SIZE << ")" << std::endl;
+    std::cout << "  --max-import <수>    대량 등록 요청당 최대 사용자 수 (기본값: " << DEFAULT_MAX_IMPORT_ITEMS << ")" << std::endl;
+    std::cout << "  --rate-limit-user <N/초>  사용자별 인증 시도 한도, off면 끔 (기본값: "
+              << DEFAULT_USER_RATE_LIMIT.burst << "/" << DEFAULT_USER_RATE_LIMIT.period_seconds << ")" << std::endl;
+    std::cout << "  --rate-limit-ip <N/초>    클라이언트 IP별 인증 시도 한도, off면 끔 (기본값: "
+              << DEFAULT_IP_RATE_LIMIT.burst << "/" << DEFAULT_IP_RATE_LIMIT.period_seconds << ")" << std::endl;
+    ServerTuning::printUsage(std::cout);
     std::cout << "  --help              이 도움말 출력" << std::endl;
     std::cout << std::endl;
     std::cout << "예시:" << std::endl;
     std::cout << "  HTTP 모드:  " << program_name << " --port 8080" << std::endl;
     std::cout << "  HTTPS 모드: " << program_name << " --port 8443 --cert server.crt --key server.key" << std::endl;
+    std::cout << "  복제:       " << program_name << " --port 8080 --replication-port 9443 --replication-key repl.key"
+              << std::endl;
+    std::cout << "              " << program_name << " --port 8081 --data data/replica.dat --follow 127.0.0.1:9443"
+              << " --replication-key repl.key" << std::endl;
+    std::cout << "  샤딩:       " << program_name << " --port 8080 --listener epoll --node-id a --cluster-key cluster.key"
+              << " --cluster a=10.0.0.1:7000,b=10.0.0.2:7000,c=10.0.0.3:7000" << std::endl;
 }
 
 int main(int argc, char* argv[]) {
@@ -39,6 +55,12 @@ int main(int argc, char* argv[]) {
     std::string cert_path;
     std::string key_path;
     std::string data_file = DEFAULT_USER_FILE;
+    size_t max_batch_size = DEFAULT_MAX_BATCH_SIZE;
+    size_t max_import_items = DEFAULT_MAX_IMPORT_ITEMS;
+    StorageMode storage_mode = StorageMode::Memory;
+    RateLimit user_rate_limit = DEFAULT_USER_RATE_LIMIT;
+    RateLimit ip_rate_limit = DEFAULT_IP_RATE_LIMIT;
+    ServerTuning tuning;
 
     // 명령행 인자 파싱
     for (int i = 1; i < argc; i++) {
@@ -69,6 +91,65 @@ int main(int argc, char* argv[]) {
         else if (arg == "--data" && i + 1 < argc) {
             data_file = argv[++i];
         }
+        else if (arg == "--storage" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode == "memory") {
+                storage_mode = StorageMode::Memory;
+            } else if (mode == "mapped") {
+                storage_mode = StorageMode::Mapped;
+            } else {
+                std::cerr << "오류: 유효하지 않은 저장소 방식: " << mode << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--log-level" && i + 1 < argc) {
+            Log::Level level;
+            if (!Log::parseLevel(argv[++i], level)) {
+                std::cerr << "오류: 유효하지 않은 로그 레벨: " << argv[i] << std::endl;
+                return 1;
+            }
+            Log::setLevel(level);
+        }
+        else if (arg == "--max-batch" && i + 1 < argc) {
+            try {
+                long long value = std::stoll(argv[++i]);
+                if (value <= 0) {
+                    std::cerr << "오류: 유효하지 않은 배치 크기: " << value << std::endl;
+                    return 1;
+                }
+                max_batch_size = static_cast<size_t>(value);
+            } catch (const std::exception&) {
+                std::cerr << "오류: 유효하지 않은 배치 크기: " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--max-import" && i + 1 < argc) {
+            try {
+                long long value = std::stoll(argv[++i]);
+                if (value <= 0) {
+                    std::cerr << "오류: 유효하지 않은 대량 등록 한도: " << value << std::endl;
+                    return 1;
+                }
+                max_import_items = static_cast<size_t>(value);
+            } catch (const std::exception&) {
+                std::cerr << "오류: 유효하지 않은 대량 등록 한도: " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else if ((arg == "--rate-limit-user" || arg == "--rate-limit-ip") && i + 1 < argc) {
+            RateLimit& limit = arg == "--rate-limit-user" ? user_rate_limit : ip_rate_limit;
+            if (!RateLimit::parse(argv[++i], limit)) {
+                std::cerr << "오류: 유효하지 않은 시도 한도: " << argv[i] << " (예: 10/60, off)" << std::endl;
+                return 1;
+            }
+        }
+        else if (ServerTuning::isOption(arg) && i + 1 < argc) {
+            std::string error;
+            if (!ServerTuning::parseOption(arg, argv[++i], tuning, error)) {
+                std::cerr << "오류: " << error << std::endl;
+                return 1;
+            }
+        }
         else {
             std::cerr << "오류: 알 수 없는 옵션: " << arg << std::endl;
             printUsage(argv[0]);
@@ -85,7 +166,11 @@ int main(int argc, char* argv[]) {
 
     try {
         // 서버 생성
-        g_server = std::make_unique<MFAServer>(port, cert_path, key_path, data_file);
+        g_server = std::make_unique<MFAServer>(port, cert_path, key_path, data_file, storage_mode);
+        g_server->setMaxBatchSize(max_batch_size);
+        g_server->setMaxImportItems(max_import_items);
+        g_server->setRateLimits(user_rate_limit, ip_rate_limit);
+        g_server->setTuning(tuning);
 
         // 시그널 핸들러 등록
         signal(SIGINT, signalHandler);
@@ -96,6 +181,50 @@ int main(int argc, char* argv[]) {
         std::cout << "포트: " << port << std::endl;
         std::cout << "프로토콜: " << (g_server->isSSLEnabled() ? "HTTPS" : "HTTP") << std::endl;
         std::cout << "데이터 파일: " << data_file << std::endl;
+        std::cout << "저장소: " << (storage_mode == StorageMode::Mapped ? "mapped" : "memory") << std::endl;
+        std::cout << "인증 시도 한도: 사용자 ";
+        if (user_rate_limit.enabled()) std::cout << user_rate_limit.burst << "/" << user_rate_limit.period_seconds << "s";
+        else std::cout << "off";
+        std::cout << ", IP ";
+        if (ip_rate_limit.enabled()) std::cout << ip_rate_limit.burst << "/" << ip_rate_limit.period_seconds << "s";
+        else std::cout << "off";
+        std::cout << std::endl;
+        if (tuning.listener == ListenerMode::Epoll) {
+            std::cout << "리스너: epoll, 리액터 스레드 ";
+            if (tuning.event_threads > 0) std::cout << tuning.event_threads;
+            else std::cout << "코어 수";
+            std::cout << std::endl;
+        } else {
+            std::cout << "작업 스레드: ";
+            if (tuning.worker_threads > 0) std::cout << tuning.worker_threads;
+            else std::cout << "기본값";
+            std::cout << ", 대기 연결 상한 ";
+            if (tuning.max_queued > 0) std::cout << tuning.max_queued;
+            else std::cout << "없음";
+            std::cout << (tuning.pin_workers ? ", CPU 고정" : "") << std::endl;
+        }
+        std::cout << "연결: keep-alive " << tuning.keep_alive_max_count << "회/" << tuning.keep_alive_timeout_sec
+                  << "s, 읽기/쓰기 제한 " << tuning.read_timeout_sec << "s/" << tuning.write_timeout_sec
+                  << "s, 대기열 " << tuning.listen_backlog << ", TCP_NODELAY " << (tuning.tcp_nodelay ? "on" : "off")
+                  << std::endl;
+        
+        if (tuning.binary_port != 0 || !tuning.binary_socket.empty()) {
+            std::cout << "바이너리 검증 프로토콜:";
+            if (tuning.binary_port != 0) std::cout << " TCP " << tuning.binary_port;
+            if (!tuning.binary_socket.empty()) std::cout << " Unix " << tuning.binary_socket;
+            std::cout << ", 리액터 스레드 " << tuning.binary_threads << std::endl;
+        }
+        if (tuning.replication_port != 0) {
+            std::cout << "복제: 리더, 포트 " << tuning.replication_port << ", 최근 변경 "
+                      << tuning.replication_log_entries << "개 보관" << std::endl;
+        } else if (!tuning.follow.empty()) {
+            std::cout << "복제: 읽기 전용 팔로워, 리더 " << tuning.follow << std::endl;
+        }
+        if (!tuning.cluster_nodes.empty()) {
+            std::cout << "샤딩: " << (tuning.node_id.empty() ? std::string("라우터") : "노드 " + tuning.node_id)
+                      << ", 구성 노드 " << tuning.cluster_nodes.size() << "개, 가상 노드 " << tuning.cluster_vnodes
+                      << "개" << std::endl;
+        }
         
         if (g_server->isSSLEnabled()) {
             std::cout << "SSL 인증서: " << cert_path << std::endl;
@@ -106,9 +235,16 @@ int main(int argc, char* argv[]) {
         std::cout << "API 엔드포인트:" << std::endl;
         std::cout << "  POST /api/register      - 사용자 등록" << std::endl;
         std::cout << "  POST /api/authenticate  - OTP 인증" << std::endl;
+        std::cout << "  POST /api/authenticate/batch - 일괄 OTP 인증" << std::endl;
+        std::cout << "  POST /api/users/bulk    - 사용자 대량 등록 (CSV/NDJSON)" << std::endl;
         std::cout << "  DELETE /api/user/<id>   - 사용자 삭제" << std::endl;
-        std::cout << "  GET /api/users          - 사용자 목록" << std::endl;
+        std::cout << "  GET /api/users          - 사용자 목록 (?cursor=&limit=&prefix=&stream=1)" << std::endl;
+        std::cout << "  GET /api/qr/<id>        - QR 코드 이미지 (?format=png|svg&scale=)" << std::endl;
+        std::cout << "  GET /api/replication    - 복제 상태 (역할, seq, 팔로워 지연)" << std::endl;
+        std::cout << "  GET /api/cluster        - 샤딩 상태 (링, 노드별 몫, 재배치)" << std::endl;
+        std::cout << "  POST /api/cluster/nodes - 노드 추가 (내부 리스너 전용, 온라인 재배치)" << std::endl;
         std::cout << "  GET /health             - 헬스 체크" << std::endl;
+        std::cout << "  GET /metrics            - 운영 지표 (Prometheus)" << std::endl;
         std::cout << std::endl;
 
         // 서버 시작
@@ -0,0 +1,614 @@
+#include "mapped_user_store.h"
+#include "logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+    constexpr char DATA_MAGIC[8] = {'M', 'F', 'A', 'M', 'A', 'P', '0', '1'};
+    constexpr char INDEX_MAGIC[8] = {'M', 'F', 'A', 'I', 'D', 'X', '0', '1'};
+    constexpr uint32_t STORE_VERSION = 1;
+    constexpr size_t DATA_HEADER_SIZE = 4096;
+    constexpr size_t INDEX_HEADER_SIZE = 64;
+    constexpr uint64_t INITIAL_CAPACITY = 1024;
+    constexpr uint64_t INITIAL_BUCKETS = 2048;
+    constexpr uint32_t EMPTY_BUCKET = 0;
+    constexpr uint32_t TOMBSTONE = 0xFFFFFFFFu;
+
+    constexpr uint8_t SLOT_EMPTY = 0;
+    constexpr uint8_t SLOT_LIVE = 1;
+    constexpr uint8_t SLOT_FREE = 2;
+
+    struct DataHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t record_size;
+        uint64_t capacity;            // 매핑된 레코드 수
+        uint64_t high_water;          // 사용된 최대 슬롯 + 1
+        uint64_t live_count;
+        uint64_t free_head;           // 빈 슬롯 리스트 머리 (slot + 1)
+        uint64_t index_generation;    // 인덱스 재구성 시 증가
+    };
+
+    struct IndexHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t bucket_count;        // 2의 거듭제곱
+        uint64_t used;                // 사용 중 + 삭제 표시 버킷 수
+        uint64_t generation;
+    };
+
+    static_assert(sizeof(DataHeader) <= DATA_HEADER_SIZE, "DataHeader too large");
+    static_assert(sizeof(IndexHeader) <= INDEX_HEADER_SIZE, "IndexHeader too large");
+
+    // FNV-1a 64비트
+    uint64_t hashUserId(std::string_view user_id) {
+        uint64_t h = 0xcbf29ce484222325ull;
+        for (unsigned char c : user_id) {
+            h ^= c;
+            h *= 0x100000001b3ull;
+        }
+        return h;
+    }
+
+    bool idEquals(const MappedUserRecord& record, std::string_view user_id) {
+        return user_id.size() < static_cast<size_t>(MAPPED_USER_ID_LENGTH) &&
+               memcmp(record.user_id, user_id.data(), user_id.size()) == 0 &&
+               record.user_id[user_id.size()] == '\0';
+    }
+
+    DataHeader* dataHeader(const unsigned char* base) {
+        return reinterpret_cast<DataHeader*>(const_cast<unsigned char*>(base));
+    }
+
+    MappedUserRecord* records(const unsigned char* base) {
+        return reinterpret_cast<MappedUserRecord*>(const_cast<unsigned char*>(base) + DATA_HEADER_SIZE);
+    }
+
+    IndexHeader* indexHeader(const unsigned char* base) {
+        return reinterpret_cast<IndexHeader*>(const_cast<unsigned char*>(base));
+    }
+
+    uint32_t* buckets(const unsigned char* base) {
+        return reinterpret_cast<uint32_t*>(const_cast<unsigned char*>(base) + INDEX_HEADER_SIZE);
+    }
+
+    bool fileSize(int fd, size_t& size) {
+        struct stat st;
+        if (fstat(fd, &st) != 0) return false;
+        size = static_cast<size_t>(st.st_size);
+        return true;
+    }
+}
+
+MappedUserStore::MappedUserStore(const std::string& base_path)
+    : data_path(base_path + ".map"), index_path(base_path + ".idx") {}
+
+MappedUserStore::~MappedUserStore() {
+    if (writable) {
+        sync();
+    }
+    for (Mapping* m : retired) {
+        munmap(m->base, m->length);
+        delete m;
+    }
+    for (Mapping* m : {data_map.load(), index_map.load()}) {
+        if (m) {
+            munmap(m->base, m->length);
+            delete m;
+        }
+    }
+    if (data_fd >= 0) ::close(data_fd);
+    if (index_fd >= 0) ::close(index_fd);
+}
+
+bool MappedUserStore::createFiles() {
+    // 데이터 파일: 헤더 + 초기 용량 (sparse)
+    if (ftruncate(data_fd, static_cast<off_t>(DATA_HEADER_SIZE + INITIAL_CAPACITY * sizeof(MappedUserRecord))) != 0) {
+        return false;
+    }
+    DataHeader header = {};
+    memcpy(header.magic, DATA_MAGIC, sizeof(DATA_MAGIC));
+    header.version = STORE_VERSION;
+    header.record_size = sizeof(MappedUserRecord);
+    header.capacity = INITIAL_CAPACITY;
+    header.index_generation = 1;
+    if (pwrite(data_fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))) {
+        return false;
+    }
+
+    if (ftruncate(index_fd, static_cast<off_t>(INDEX_HEADER_SIZE + INITIAL_BUCKETS * sizeof(uint32_t))) != 0) {
+        return false;
+    }
+    IndexHeader index_header = {};
+    memcpy(index_header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    index_header.version = STORE_VERSION;
+    index_header.bucket_count = INITIAL_BUCKETS;
+    index_header.generation = 1;
+    if (pwrite(index_fd, &index_header, sizeof(index_header), 0) != static_cast<ssize_t>(sizeof(index_header))) {
+        return false;
+    }
+
+    return fdatasync(data_fd) == 0 && fdatasync(index_fd) == 0;
+}
+
+bool MappedUserStore::open() {
+    data_fd = ::open(data_path.c_str(), O_RDWR | O_CREAT, 0600);
+    if (data_fd < 0) {
+        // 쓰기 권한이 없으면 읽기 전용으로 공유
+        data_fd = ::open(data_path.c_str(), O_RDONLY);
+        if (data_fd < 0) {
+            MFA_LOG_ERROR("MAPPED_STORE", "데이터 파일 열기 실패: " << data_path);
+            return false;
+        }
+    } else {
+        // 한 호스트에서 writer는 하나만 허용 (나머지 프로세스는 읽기 전용)
+        writable = flock(data_fd, LOCK_EX | LOCK_NB) == 0;
+    }
+
+    index_fd = ::open(index_path.c_str(), writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0600);
+    if (index_fd < 0) {
+        MFA_LOG_ERROR("MAPPED_STORE", "인덱스 파일 열기 실패: " << index_path);
+        return false;
+    }
+
+    size_t size = 0;
+    if (!fileSize(data_fd, size)) {
+        return false;
+    }
+    if (size == 0) {
+        if (!writable || !createFiles()) {
+            MFA_LOG_ERROR("MAPPED_STORE", "저장소 초기화 실패: " << data_path);
+            return false;
+        }
+    }
+
+    if (!mapData() || !mapIndex()) {
+        return false;
+    }
+    if (writable && !slotsConsistent()) {
+        MFA_LOG_WARN("MAPPED_STORE", "빈 슬롯 정보가 레코드와 맞지 않습니다 (쓰기 중 중단). 레코드로 다시 구성합니다: "
+                     << data_path);
+        if (!recoverSlots()) {
+            MFA_LOG_ERROR("MAPPED_STORE", "빈 슬롯 복구 실패: " << data_path);
+            return false;
+        }
+    }
+
+    const DataHeader* header = dataHeader(data_map.load()->base);
+    MFA_LOG_INFO("MAPPED_STORE", "Opened " << data_path << " (" << header->live_count << " users, "
+                 << (writable ? "read-write" : "read-only") << ")");
+    return true;
+}
+
+bool MappedUserStore::mapData() {
+    size_t size = 0;
+    if (!fileSize(data_fd, size) || size < DATA_HEADER_SIZE) {
+        return false;
+    }
+
+    int prot = writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    void* base = mmap(nullptr, size, prot, MAP_SHARED, data_fd, 0);
+    if (base == MAP_FAILED) {
+        MFA_LOG_ERROR("MAPPED_STORE", "mmap 실패: " << strerror(errno));
+        return false;
+    }
+
+    const DataHeader* header = dataHeader(static_cast<unsigned char*>(base));
+    if (memcmp(header->magic, DATA_MAGIC, sizeof(DATA_MAGIC)) != 0 ||
+        header->version != STORE_VERSION ||
+        header->record_size != sizeof(MappedUserRecord) ||
+        DATA_HEADER_SIZE + header->capacity * sizeof(MappedUserRecord) > size) {
+        MFA_LOG_ERROR("MAPPED_STORE", "데이터 파일 형식 오류: " << data_path);
+        munmap(base, size);
+        return false;
+    }
+
+    Mapping* mapping = new Mapping{static_cast<unsigned char*>(base), size};
+    Mapping* old = data_map.exchange(mapping, std::memory_order_acq_rel);
+    if (old) retired.push_back(old);
+    return true;
+}
+
+bool MappedUserStore::mapIndex() {
+    size_t size = 0;
+    if (!fileSize(index_fd, size) || size < INDEX_HEADER_SIZE) {
+        return false;
+    }
+
+    int prot = writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    void* base = mmap(nullptr, size, prot, MAP_SHARED, index_fd, 0);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+
+    const IndexHeader* header = indexHeader(static_cast<unsigned char*>(base));
+    uint64_t bucket_count = header->bucket_count;
+    if (memcmp(header->magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 ||
+        header->version != STORE_VERSION ||
+        bucket_count == 0 || (bucket_count & (bucket_count - 1)) != 0 ||
+        INDEX_HEADER_SIZE + bucket_count * sizeof(uint32_t) > size) {
+        MFA_LOG_ERROR("MAPPED_STORE", "인덱스 파일 형식 오류: " << index_path);
+        munmap(base, size);
+        return false;
+    }
+
+    Mapping* mapping = new Mapping{static_cast<unsigned char*>(base), size};
+    Mapping* old = index_map.exchange(mapping, std::memory_order_acq_rel);
+    if (old) retired.push_back(old);
+    return true;
+}
+
+void MappedUserStore::refreshIfChanged() const {
+    if (writable) {
+        return; // writer 프로세스는 직접 매핑을 교체함
+    }
+
+    // 다른 프로세스(writer)가 파일을 키우거나 인덱스를 재구성했는지 확인
+    const Mapping* data = data_map.load(std::memory_order_acquire);
+    const Mapping* index = index_map.load(std::memory_order_acquire);
+    const DataHeader* header = dataHeader(data->base);
+    uint64_t capacity = __atomic_load_n(&header->capacity, __ATOMIC_ACQUIRE);
+    uint64_t generation = __atomic_load_n(&header->index_generation, __ATOMIC_ACQUIRE);
+
+    bool data_grown = DATA_HEADER_SIZE + capacity * sizeof(MappedUserRecord) > data->length;
+    bool index_changed = indexHeader(index->base)->generation != generation;
+    if (!data_grown && !index_changed) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(remap_mutex);
+    auto* self = const_cast<MappedUserStore*>(this);
+    if (data_grown && data_map.load() == data) {
+        self->mapData();
+    }
+    if (index_changed && index_map.load() == index) {
+        // 재구성된 인덱스는 rename으로 교체되므로 파일을 다시 엶
+        int fd = ::open(index_path.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            ::close(self->index_fd);
+            self->index_fd = fd;
+            self->mapIndex();
+        }
+    }
+}
+
+const MappedUserRecord* MappedUserStore::find(std::string_view user_id, uint64_t* slot) const {
+    refreshIfChanged();
+
+    const Mapping* data = data_map.load(std::memory_order_acquire);
+    const Mapping* index = index_map.load(std::memory_order_acquire);
+    const IndexHeader* header = indexHeader(index->base);
+    const uint32_t* table = buckets(index->base);
+    const MappedUserRecord* recs = records(data->base);
+    const uint64_t capacity = (data->length - DATA_HEADER_SIZE) / sizeof(MappedUserRecord);
+
+    uint64_t mask = header->bucket_count - 1;
+    uint64_t pos = hashUserId(user_id) & mask;
+
+    for (uint64_t probe = 0; probe <= mask; probe++, pos = (pos + 1) & mask) {
+        uint32_t value = __atomic_load_n(&table[pos], __ATOMIC_ACQUIRE);
+        if (value == EMPTY_BUCKET) {
+            return nullptr;
+        }
+        if (value == TOMBSTONE || value - 1 >= capacity) {
+            continue;
+        }
+
+        const MappedUserRecord& record = recs[value - 1];
+        if (__atomic_load_n(&record.state, __ATOMIC_ACQUIRE) == SLOT_LIVE && idEquals(record, user_id)) {
+            if (slot) *slot = value - 1;
+            return &record;
+        }
+    }
+    return nullptr;
+}
+
+bool MappedUserStore::findKey(std::string_view user_id, HMACKeyState& key, uint64_t* slot) const {
+    for (int attempt = 0; attempt < 4; attempt++) {
+        const MappedUserRecord* record = find(user_id, slot);
+        if (!record) {
+            return false;
+        }
+
+        key = record->key;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (__atomic_load_n(&record->state, __ATOMIC_ACQUIRE) == SLOT_LIVE && idEquals(*record, user_id)) {
+            return true;
+        }
+        // 복사 중에 슬롯이 삭제/재사용됨: 다시 조회
+    }
+    return false;
+}
+
+bool MappedUserStore::findSecret(std::string_view user_id, std::string& secret_base32) const {
+    for (int attempt = 0; attempt < 4; attempt++) {
+        const MappedUserRecord* record = find(user_id);
+        if (!record) {
+            return false;
+        }
+
+        char copy[MAPPED_SECRET_LENGTH];
+        memcpy(copy, record->secret_base32, sizeof(copy));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (__atomic_load_n(&record->state, __ATOMIC_ACQUIRE) == SLOT_LIVE && idEquals(*record, user_id)) {
+            secret_base32.assign(copy, strnlen(copy, sizeof(copy)));
+            return true;
+        }
+    }
+    return false;
+}
+
+void MappedUserStore::syncRange(const void* addr, size_t len) const {
+    // msync는 페이지 정렬된 주소가 필요
+    const uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    uintptr_t start = reinterpret_cast<uintptr_t>(addr) & ~(page - 1);
+    uintptr_t end = reinterpret_cast<uintptr_t>(addr) + len;
+    msync(reinterpret_cast<void*>(start), end - start, MS_SYNC);
+}
+
+bool MappedUserStore::growData() {
+    const DataHeader* header = dataHeader(data_map.load()->base);
+    uint64_t new_capacity = header->capacity * 2;
+
+    if (ftruncate(data_fd, static_cast<off_t>(DATA_HEADER_SIZE + new_capacity * sizeof(MappedUserRecord))) != 0) {
+        return false;
+    }
+    if (!mapData()) {
+        return false;
+    }
+
+    DataHeader* new_header = dataHeader(data_map.load()->base);
+    __atomic_store_n(&new_header->capacity, new_capacity, __ATOMIC_RELEASE);
+    syncRange(new_header, sizeof(DataHeader));
+    return true;
+}
+
+uint64_t MappedUserStore::allocateSlot() {
+    DataHeader* header = dataHeader(data_map.load()->base);
+
+    if (header->free_head != 0) {
+        uint64_t slot = header->free_head - 1;
+        header->free_head = records(data_map.load()->base)[slot].next_free;
+        return slot;
+    }
+
+    if (header->high_water >= header->capacity) {
+        if (!growData()) {
+            return UINT64_MAX;
+        }
+        header = dataHeader(data_map.load()->base);
+    }
+    return header->high_water++;
+}
+
+bool MappedUserStore::slotsConsistent() const {
+    // 다음에 나눠 줄 슬롯이 정말 비어 있는지만 확인 (O(1), 정상 종료한 파일은 항상 통과)
+    const DataHeader* header = dataHeader(data_map.load()->base);
+    const MappedUserRecord* recs = records(data_map.load()->base);
+    if (header->high_water > header->capacity || header->live_count > header->high_water) {
+        return false;
+    }
+    if (header->free_head != 0 &&
+        (header->free_head > header->high_water || recs[header->free_head - 1].state != SLOT_FREE)) {
+        return false;
+    }
+    return header->high_water == header->capacity || recs[header->high_water].state == SLOT_EMPTY;
+}
+
+bool MappedUserStore::recoverSlots() {
+    // 레코드 상태를 기준으로 high_water, 빈 슬롯 리스트, 사용자 수를 다시 계산
+    DataHeader* header = dataHeader(data_map.load()->base);
+    MappedUserRecord* recs = records(data_map.load()->base);
+    uint64_t high_water = 0;
+    for (uint64_t slot = 0; slot < header->capacity; slot++) {
+        if (recs[slot].state != SLOT_EMPTY) high_water = slot + 1;
+    }
+    uint64_t free_head = 0;
+    uint64_t live_count = 0;
+    for (uint64_t slot = high_water; slot-- > 0;) {
+        if (recs[slot].state == SLOT_LIVE) {
+            live_count++;
+            continue;
+        }
+        recs[slot].state = SLOT_FREE;
+        recs[slot].next_free = static_cast<uint32_t>(free_head);
+        free_head = slot + 1;
+    }
+    syncRange(recs, high_water * sizeof(MappedUserRecord));
+
+    header->high_water = high_water;
+    header->free_head = free_head;
+    header->live_count = live_count;
+    syncRange(header, sizeof(DataHeader));
+
+    // 버킷이 가리키는 슬롯이 바뀌었을 수 있으므로 사용 중인 레코드로 인덱스도 다시 만듦
+    return rebuildIndex(indexHeader(index_map.load()->base)->bucket_count);
+}
+
+bool MappedUserStore::rebuildIndex(uint64_t bucket_count) {
+    // 새 인덱스를 임시 파일에 만든 뒤 rename으로 교체 (읽기 전용 프로세스는 세대 번호로 감지)
+    std::string tmp_path = index_path + ".tmp";
+    int fd = ::open(tmp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        return false;
+    }
+
+    size_t size = INDEX_HEADER_SIZE + bucket_count * sizeof(uint32_t);
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ::close(fd);
+        return false;
+    }
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        ::close(fd);
+        return false;
+    }
+
+    DataHeader* data_header = dataHeader(data_map.load()->base);
+    const MappedUserRecord* recs = records(data_map.load()->base);
+
+    IndexHeader* header = indexHeader(static_cast<unsigned char*>(base));
+    memcpy(header->magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    header->version = STORE_VERSION;
+    header->bucket_count = bucket_count;
+    header->generation = data_header->index_generation + 1;
+
+    uint32_t* table = buckets(static_cast<unsigned char*>(base));
+    uint64_t mask = bucket_count - 1;
+    for (uint64_t slot = 0; slot < data_header->high_water; slot++) {
+        if (recs[slot].state != SLOT_LIVE) continue;
+        std::string_view id(recs[slot].user_id, strnlen(recs[slot].user_id, MAPPED_USER_ID_LENGTH));
+        uint64_t pos = hashUserId(id) & mask;
+        while (table[pos] != EMPTY_BUCKET) pos = (pos + 1) & mask;
+        table[pos] = static_cast<uint32_t>(slot + 1);
+        header->used++;
+    }
+
+    msync(base, size, MS_SYNC);
+    munmap(base, size);
+
+    if (::rename(tmp_path.c_str(), index_path.c_str()) != 0) {
+        ::close(fd);
+        return false;
+    }
+    ::close(index_fd);
+    index_fd = fd;
+    if (!mapIndex()) {
+        return false;
+    }
+
+    __atomic_store_n(&data_header->index_generation, header->generation, __ATOMIC_RELEASE);
+    syncRange(data_header, sizeof(DataHeader));
+    return true;
+}
+
+bool MappedUserStore::insert(std::string_view user_id, std::string_view secret_base32, const HMACKeyState& key,
+                             bool durable) {
+    if (!writable || user_id.empty() ||
+        user_id.size() >= static_cast<size_t>(MAPPED_USER_ID_LENGTH) ||
+        secret_base32.size() >= static_cast<size_t>(MAPPED_SECRET_LENGTH)) {
+        return false;
+    }
+    if (find(user_id)) {
+        return false;
+    }
+
+    // 부하율 70% 초과 시 인덱스 확장 (삭제 표시가 많으면 같은 크기로 재구성)
+    const IndexHeader* index_header = indexHeader(index_map.load()->base);
+    if ((index_header->used + 1) * 10 > index_header->bucket_count * 7) {
+        uint64_t live = dataHeader(data_map.load()->base)->live_count + 1;
+        uint64_t new_count = index_header->bucket_count;
+        while (live * 10 > new_count * 5) new_count *= 2;
+        if (!rebuildIndex(new_count)) {
+            return false;
+        }
+    }
+
+    uint64_t slot = allocateSlot();
+    if (slot == UINT64_MAX || slot >= TOMBSTONE - 1) {
+        return false;
+    }
+    // 0) 할당을 먼저 디스크에 반영 (헤더가 나중이면 중간에 죽었을 때 사용 중인 슬롯을 다시 나눠 줌)
+    if (durable) syncRange(dataHeader(data_map.load()->base), sizeof(DataHeader));
+
+    // 1) 레코드 기록 후 디스크 반영
+    MappedUserRecord* record = &records(data_map.load()->base)[slot];
+    // 잠금 없이 읽는 쪽이 재사용 중인 슬롯을 사용 중으로 보지 않도록 상태를 먼저 내림
+    __atomic_store_n(&record->state, SLOT_EMPTY, __ATOMIC_RELEASE);
+    std::atomic_thread_fence(std::memory_order_release);
+    *record = MappedUserRecord{};
+    memcpy(record->user_id, user_id.data(), user_id.size());
+    memcpy(record->secret_base32, secret_base32.data(), secret_base32.size());
+    record->key = key;
+    __atomic_store_n(&record->state, SLOT_LIVE, __ATOMIC_RELEASE);
+    if (durable) syncRange(record, sizeof(*record));
+
+    // 2) 인덱스 버킷 공개 (레코드가 먼저 기록되어 있으므로 중간에 죽어도 고아 레코드만 남음)
+    Mapping* index = index_map.load();
+    IndexHeader* header = indexHeader(index->base);
+    uint32_t* table = buckets(index->base);
+    uint64_t mask = header->bucket_count - 1;
+    uint64_t pos = hashUserId(user_id) & mask;
+    while (table[pos] != EMPTY_BUCKET && table[pos] != TOMBSTONE) pos = (pos + 1) & mask;
+    if (table[pos] == EMPTY_BUCKET) header->used++;
+    __atomic_store_n(&table[pos], static_cast<uint32_t>(slot + 1), __ATOMIC_RELEASE);
+    if (durable) syncRange(&table[pos], sizeof(uint32_t));
+
+    DataHeader* data_header = dataHeader(data_map.load()->base);
+    data_header->live_count++;
+    if (durable) syncRange(data_header, sizeof(DataHeader));
+    return true;
+}
+
+bool MappedUserStore::remove(std::string_view user_id) {
+    if (!writable) {
+        return false;
+    }
+
+    Mapping* index = index_map.load();
+    uint32_t* table = buckets(index->base);
+    uint64_t mask = indexHeader(index->base)->bucket_count - 1;
+    uint64_t pos = hashUserId(user_id) & mask;
+    MappedUserRecord* recs = records(data_map.load()->base);
+
+    for (uint64_t probe = 0; probe <= mask; probe++, pos = (pos + 1) & mask) {
+        uint32_t value = table[pos];
+        if (value == EMPTY_BUCKET) {
+            return false;
+        }
+        if (value == TOMBSTONE) {
+            continue;
+        }
+
+        MappedUserRecord& record = recs[value - 1];
+        if (record.state != SLOT_LIVE || !idEquals(record, user_id)) {
+            continue;
+        }
+
+        // 레코드를 먼저 삭제 상태로 반영한 뒤(중간에 죽어도 인덱스 재구성 때 되살아나지 않음)
+        // 인덱스에서 제거하고, 마지막으로 슬롯을 빈 슬롯 리스트로 반환
+        DataHeader* header = dataHeader(data_map.load()->base);
+        record.next_free = static_cast<uint32_t>(header->free_head);
+        __atomic_store_n(&record.state, SLOT_FREE, __ATOMIC_RELEASE);
+        syncRange(&record, sizeof(record));
+
+        __atomic_store_n(&table[pos], TOMBSTONE, __ATOMIC_RELEASE);
+        syncRange(&table[pos], sizeof(uint32_t));
+
+        header->free_head = value;
+        header->live_count--;
+        syncRange(header, sizeof(DataHeader));
+        return true;
+    }
+    return false;
+}
+
+bool MappedUserStore::sync() {
+    const Mapping* data = data_map.load();
+    const Mapping* index = index_map.load();
+    bool ok = true;
+    if (data) ok = msync(data->base, data->length, MS_SYNC) == 0 && ok;
+    if (index) ok = msync(index->base, index->length, MS_SYNC) == 0 && ok;
+    return ok;
+}
+
+size_t MappedUserStore::size() const {
+    refreshIfChanged();
+    return static_cast<size_t>(__atomic_load_n(&dataHeader(data_map.load()->base)->live_count, __ATOMIC_ACQUIRE));
+}
+
+const MappedUserRecord* MappedUserStore::recordsBegin(uint64_t& count) const {
+    refreshIfChanged();
+    const Mapping* data = data_map.load(std::memory_order_acquire);
+    uint64_t capacity = (data->length - DATA_HEADER_SIZE) / sizeof(MappedUserRecord);
+    count = std::min<uint64_t>(__atomic_load_n(&dataHeader(data->base)->high_water, __ATOMIC_ACQUIRE), capacity);
+    return records(data->base);
+}
@@ -0,0 +1,202 @@
+#ifndef MAPPED_USER_STORE_H
+#define MAPPED_USER_STORE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "hmac_sha1.h"
+
+// users.dat와 같은 필드 폭 (mfa_core.h의 상수와 동일해야 함)
+constexpr int MAPPED_USER_ID_LENGTH = 50;
+constexpr int MAPPED_SECRET_LENGTH = 64;
+
+/**
+ * @brief 매핑 파일의 고정 크기 사용자 레코드
+ *
+ * 기존 users.dat 레코드(user_id 50바이트 + secret 64바이트) 뒤에 상태와
+ * 미리 계산된 HMAC 키 상태를 붙여, 조회 시 파싱/디코딩이 필요 없도록 합니다.
+ */
+struct MappedUserRecord {
+    char user_id[MAPPED_USER_ID_LENGTH];
+    char secret_base32[MAPPED_SECRET_LENGTH];
+    uint8_t state;                  // 0: 빈 슬롯, 1: 사용 중, 2: 삭제됨(빈 슬롯 리스트)
+    uint8_t reserved[5];
+    HMACKeyState key;
+    uint32_t next_free;             // 삭제된 슬롯의 다음 빈 슬롯 (slot + 1)
+    uint8_t padding[8];
+};
+
+static_assert(sizeof(MappedUserRecord) == 176, "MappedUserRecord 레이아웃이 변경되었습니다");
+
+/**
+ * @brief mmap 기반 고정 레코드 사용자 저장소 + 파일 기반 오픈 어드레싱 해시 인덱스
+ *
+ * - <base>.map: 헤더(4KB) + MappedUserRecord 배열
+ * - <base>.idx: 헤더(64B) + uint32 버킷 배열 (0: 빈 버킷, 0xFFFFFFFF: 삭제 표시, 그 외 slot + 1)
+ *
+ * 시작 시 파일을 매핑하고 헤더만 검증하므로 파일 크기와 무관하게 O(1)입니다.
+ * (쓰기 도중 중단되어 헤더의 빈 슬롯 정보가 레코드와 어긋난 경우에만 레코드를 훑어 복구합니다.)
+ * 같은 호스트의 여러 프로세스가 MAP_SHARED로 같은 페이지 캐시를 공유하며,
+ * 파일 잠금(flock)을 얻은 프로세스 하나만 쓰기가 가능하고 나머지는 읽기 전용으로 열립니다.
+ * 조회는 잠금 없이 수행되며, 파일 확장/인덱스 재구성 시 이전 매핑은 닫을 때까지 유지됩니다.
+ */
+class MappedUserStore {
+private:
+    struct Mapping {
+        unsigned char* base = nullptr;
+        size_t length = 0;
+    };
+
+    std::string data_path;
+    std::string index_path;
+    int data_fd = -1;
+    int index_fd = -1;
+    bool writable = false;
+
+    std::atomic<Mapping*> data_map{nullptr};
+    std::atomic<Mapping*> index_map{nullptr};
+    std::vector<Mapping*> retired;        // 교체된 매핑 (소멸 시 해제)
+    mutable std::mutex remap_mutex;
+
+    bool createFiles();
+    bool mapData();
+    bool mapIndex();
+    bool growData();
+    bool rebuildIndex(uint64_t bucket_count);
+    void refreshIfChanged() const;
+    uint64_t allocateSlot();
+    bool slotsConsistent() const;
+    bool recoverSlots();
+    void syncRange(const void* addr, size_t len) const;
+
+public:
+    /**
+     * @brief 생성자
+     * @param base_path 파일 경로 접두사 (<base>.map, <base>.idx)
+     */
+    explicit MappedUserStore(const std::string& base_path);
+    ~MappedUserStore();
+
+    MappedUserStore(const MappedUserStore&) = delete;
+    MappedUserStore& operator=(const MappedUserStore&) = delete;
+
+    /**
+     * @brief 파일 열기/매핑 (없으면 생성)
+     * @return 성공 시 true
+     */
+    bool open();
+
+    /**
+     * @brief 사용자 조회 (잠금/복사 없음)
+     * @param slot 레코드 슬롯 번호를 받을 변수 (nullptr이면 생략)
+     * @return 레코드 포인터, 없으면 nullptr
+     */
+    const MappedUserRecord* find(std::string_view user_id, uint64_t* slot = nullptr) const;
+
+    /**
+     * @brief 사용자 키 상태 복사 (잠금 없음)
+     *
+     * 복사 후 레코드가 여전히 같은 사용자의 사용 중 레코드인지 다시 확인하므로,
+     * 동시에 삭제되어 슬롯이 재사용되어도 다른 사용자의 키를 반환하지 않습니다.
+     * @param slot 레코드 슬롯 번호를 받을 변수 (nullptr이면 생략)
+     * @return 찾았으면 true
+     */
+    bool findKey(std::string_view user_id, HMACKeyState& key, uint64_t* slot = nullptr) const;
+
+    /**
+     * @brief 사용자 시크릿 복사 (잠금 없음, findKey와 같은 재확인)
+     * @return 찾았으면 true
+     */
+    bool findSecret(std::string_view user_id, std::string& secret_base32) const;
+
+    /**
+     * @brief 사용자 추가 (단일 writer, 호출자가 직렬화)
+     * @param durable false면 msync를 생략 (대량 적재 후 sync()를 한 번 호출)
+     * @return 성공 시 true, 중복이거나 읽기 전용이면 false
+     */
+    bool insert(std::string_view user_id, std::string_view secret_base32, const HMACKeyState& key,
+                bool durable = true);
+
+    /**
+     * @brief 사용자 삭제 (단일 writer, 호출자가 직렬화)
+     * @return 삭제했으면 true
+     */
+    bool remove(std::string_view user_id);
+
+    /**
+     * @brief 사용 중인 레코드를 슬롯 순서로 순회
+     */
+    template <typename Fn>
+    void forEach(Fn&& fn) const;
+
+    /**
+     * @brief 슬롯 순서로 cursor부터 사용 중인 레코드의 user_id를 최대 limit개 순회 (잠금 없음)
+     *
+     * 슬롯 번호는 레코드가 옮겨지지 않으므로 안정적인 커서가 됩니다.
+     * user_id는 복사 후 슬롯 상태를 다시 확인해 전달합니다.
+     * @param cursor 시작 슬롯 (처음이면 0)
+     * @param limit 최대 레코드 수
+     * @param max_slots 한 번에 검사할 최대 슬롯 수
+     * @param prefix user_id 접두사 필터 (빈 문자열이면 전체)
+     * @param fn 레코드마다 호출 (std::string_view user_id)
+     * @param next 다음 커서를 받을 변수
+     * @return 남은 슬롯이 있으면 true
+     */
+    template <typename Fn>
+    bool scan(uint64_t cursor, size_t limit, size_t max_slots, std::string_view prefix,
+              Fn&& fn, uint64_t& next) const;
+
+    /**
+     * @brief 변경된 페이지를 디스크에 반영
+     */
+    bool sync();
+
+    size_t size() const;
+    bool isWritable() const { return writable; }
+
+    // forEach 구현용
+    const MappedUserRecord* recordsBegin(uint64_t& count) const;
+};
+
+template <typename Fn>
+void MappedUserStore::forEach(Fn&& fn) const {
+    uint64_t count = 0;
+    const MappedUserRecord* records = recordsBegin(count);
+    for (uint64_t slot = 0; slot < count; slot++) {
+        if (__atomic_load_n(&records[slot].state, __ATOMIC_ACQUIRE) == 1) {
+            fn(records[slot]);
+        }
+    }
+}
+
+template <typename Fn>
+bool MappedUserStore::scan(uint64_t cursor, size_t limit, size_t max_slots, std::string_view prefix,
+                           Fn&& fn, uint64_t& next) const {
+    uint64_t count = 0;
+    const MappedUserRecord* records = recordsBegin(count);
+    size_t visited = 0;
+    uint64_t slot = cursor;
+    for (; slot < count && visited < limit && slot - cursor < max_slots; slot++) {
+        const MappedUserRecord& record = records[slot];
+        if (__atomic_load_n(&record.state, __ATOMIC_ACQUIRE) != 1) continue;
+
+        char user_id[MAPPED_USER_ID_LENGTH];
+        memcpy(user_id, record.user_id, sizeof(user_id));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (__atomic_load_n(&record.state, __ATOMIC_ACQUIRE) != 1) continue;
+
+        std::string_view id(user_id, strnlen(user_id, sizeof(user_id)));
+        if (id.compare(0, prefix.size(), prefix) != 0) continue;
+        fn(id);
+        visited++;
+    }
+    next = slot;
+    return slot < count;
+}
+
+#endif // MAPPED_USER_STORE_H
@@ -0,0 +1,295 @@
+#include "metrics.h"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+namespace Metrics {
+
+    namespace {
+
+        /**
+         * @brief 한 스레드만 쓰는 카운터 (쓰기는 RMW 없이 load + store, 수집 스레드는 relaxed load)
+         */
+        struct Counter {
+            std::atomic<uint64_t> value{0};
+
+            void add(uint64_t n) { value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+            uint64_t get() const { return value.load(std::memory_order_relaxed); }
+        };
+
+        struct Histogram {
+            Counter buckets[BUCKET_COUNT];
+            Counter sum_ns;
+
+            void record(uint64_t value_ns) {
+                buckets[bucketIndex(value_ns)].add(1);
+                sum_ns.add(value_ns);
+            }
+
+            static size_t bucketIndex(uint64_t value) {
+                if (value < (uint64_t(1) << MIN_BUCKET_BITS)) {
+                    return 0;
+                }
+                unsigned msb = 63u - static_cast<unsigned>(__builtin_clzll(value));
+                if (msb >= MAX_BUCKET_BITS) {
+                    return BUCKET_COUNT - 1;
+                }
+                unsigned half = static_cast<unsigned>(value >> (msb - 1)) & 1u;
+                return 1 + (msb - MIN_BUCKET_BITS) * 2 + half;
+            }
+        };
+
+        // 자주 나오는 상태 코드만 따로 세고 나머지는 "other"
+        constexpr int STATUS_CODES[] = {200, 400, 401, 403, 404, 405, 409, 413, 415, 429, 500, 503};
+        constexpr size_t STATUS_SLOTS = sizeof(STATUS_CODES) / sizeof(STATUS_CODES[0]) + 1;
+
+        size_t statusSlot(int status) {
+            for (size_t i = 0; i < STATUS_SLOTS - 1; i++) {
+                if (STATUS_CODES[i] == status) return i;
+            }
+            return STATUS_SLOTS - 1;
+        }
+
+        struct RouteCounters {
+            Counter status[STATUS_SLOTS];
+            Histogram latency;
+        };
+
+        struct Shard {
+            RouteCounters routes[ROUTE_COUNT];
+            Histogram store_time[STORE_OP_COUNT];
+            Counter store_ops[STORE_OP_COUNT];
+            Counter hmac;
+            Counter rate_limited;
+            uint32_t lookup_tick = 0;       // 소유 스레드 전용
+
+            void addTo(Shard& total) const {
+                for (size_t r = 0; r < ROUTE_COUNT; r++) {
+                    for (size_t s = 0; s < STATUS_SLOTS; s++) total.routes[r].status[s].add(routes[r].status[s].get());
+                    addHistogram(routes[r].latency, total.routes[r].latency);
+                }
+                for (size_t o = 0; o < STORE_OP_COUNT; o++) {
+                    addHistogram(store_time[o], total.store_time[o]);
+                    total.store_ops[o].add(store_ops[o].get());
+                }
+                total.hmac.add(hmac.get());
+                total.rate_limited.add(rate_limited.get());
+            }
+
+            static void addHistogram(const Histogram& from, Histogram& to) {
+                for (size_t b = 0; b < BUCKET_COUNT; b++) to.buckets[b].add(from.buckets[b].get());
+                to.sum_ns.add(from.sum_ns.get());
+            }
+        };
+
+        struct Registry {
+            std::mutex mutex;
+            std::vector<Shard*> shards;
+            Shard retired;                  // 끝난 스레드의 누적값
+        };
+
+        // 스레드 종료 시 소멸자에서도 쓰이므로 해제하지 않음
+        Registry& registry() {
+            static Registry* instance = new Registry();
+            return *instance;
+        }
+
+        struct ShardHandle {
+            Shard* shard;
+
+            ShardHandle() : shard(new Shard()) {
+                Registry& reg = registry();
+                std::lock_guard<std::mutex> lock(reg.mutex);
+                reg.shards.push_back(shard);
+            }
+
+            ~ShardHandle() {
+                Registry& reg = registry();
+                std::lock_guard<std::mutex> lock(reg.mutex);
+                shard->addTo(reg.retired);
+                reg.shards.erase(std::find(reg.shards.begin(), reg.shards.end(), shard));
+                delete shard;
+            }
+        };
+
+        Shard& localShard() {
+            thread_local ShardHandle handle;
+            return *handle.shard;
+        }
+
+        std::atomic<int64_t> queue_depth{0};
+        std::atomic<uint64_t> queue_rejected{0};
+        std::atomic<uint64_t> tls_handshakes[2]{};         // [0] 전체, [1] 재개 (핸드셰이크는 요청보다 드묾)
+        std::atomic<uint64_t> tls_ktls{0};
+
+        const char* const ROUTE_LABELS[ROUTE_COUNT] = {
+            "register", "authenticate", "authenticate_batch", "bulk_import", "delete",
+            "list", "qr", "health", "metrics", "options", "binary_verify", "replication", "cluster",
+            "other"
+        };
+        const char* const STORE_OP_LABELS[STORE_OP_COUNT] = {"lookup", "insert", "remove"};
+
+        void appendf(std::string& out, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+        void appendf(std::string& out, const char* format, ...) {
+            char buffer[256];
+            va_list args;
+            va_start(args, format);
+            int written = vsnprintf(buffer, sizeof(buffer), format, args);
+            va_end(args);
+            if (written > 0) out.append(buffer, std::min(static_cast<size_t>(written), sizeof(buffer) - 1));
+        }
+
+        void appendHeader(std::string& out, const char* name, const char* help, const char* type) {
+            appendf(out, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+        }
+
+        double bucketUpperSeconds(size_t index) {
+            if (index == 0) {
+                return static_cast<double>(uint64_t(1) << MIN_BUCKET_BITS) / 1e9;
+            }
+            unsigned msb = MIN_BUCKET_BITS + static_cast<unsigned>((index - 1) / 2);
+            double base = static_cast<double>(uint64_t(1) << msb);
+            return ((index - 1) % 2 == 0 ? base * 1.5 : base * 2.0) / 1e9;
+        }
+
+        void appendHistogram(std::string& out, const char* name, const char* label, const char* value,
+                             const Histogram& histogram) {
+            uint64_t cumulative = 0;
+            for (size_t b = 0; b < BUCKET_COUNT - 1; b++) {
+                cumulative += histogram.buckets[b].get();
+                appendf(out, "%s_bucket{%s=\"%s\",le=\"%.9g\"} %llu\n", name, label, value, bucketUpperSeconds(b),
+                        static_cast<unsigned long long>(cumulative));
+            }
+            cumulative += histogram.buckets[BUCKET_COUNT - 1].get();
+            appendf(out, "%s_bucket{%s=\"%s\",le=\"+Inf\"} %llu\n", name, label, value,
+                    static_cast<unsigned long long>(cumulative));
+            appendf(out, "%s_sum{%s=\"%s\"} %.9f\n", name, label, value,
+                    static_cast<double>(histogram.sum_ns.get()) / 1e9);
+            appendf(out, "%s_count{%s=\"%s\"} %llu\n", name, label, value, static_cast<unsigned long long>(cumulative));
+        }
+
+        uint64_t histogramCount(const Histogram& histogram) {
+            uint64_t count = 0;
+            for (size_t b = 0; b < BUCKET_COUNT; b++) count += histogram.buckets[b].get();
+            return count;
+        }
+    }
+
+    void recordRequest(Route route, int status, uint64_t duration_ns) {
+        RouteCounters& counters = localShard().routes[static_cast<size_t>(route)];
+        counters.status[statusSlot(status)].add(1);
+        counters.latency.record(duration_ns);
+    }
+
+    void countStoreOp(StoreOp op, uint64_t count) {
+        localShard().store_ops[static_cast<size_t>(op)].add(count);
+    }
+
+    void recordStoreTime(StoreOp op, uint64_t duration_ns) {
+        localShard().store_time[static_cast<size_t>(op)].record(duration_ns);
+    }
+
+    bool sampleLookup() {
+        return localShard().lookup_tick++ % LOOKUP_SAMPLE_INTERVAL == 0;
+    }
+
+    void addHMAC(uint64_t count) {
+        localShard().hmac.add(count);
+    }
+
+    void addRateLimited(uint64_t count) {
+        localShard().rate_limited.add(count);
+    }
+
+    void addQueueDepth(int64_t delta) {
+        queue_depth.fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    void addQueueRejected(uint64_t count) {
+        queue_rejected.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    void addTLSHandshake(bool resumed, bool ktls) {
+        tls_handshakes[resumed ? 1 : 0].fetch_add(1, std::memory_order_relaxed);
+        if (ktls) tls_ktls.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void renderGauge(std::string& out, const char* name, const char* help, double value) {
+        appendHeader(out, name, help, "gauge");
+        appendf(out, "%s %.17g\n", name, value);
+    }
+
+    void render(std::string& out) {
+        // 수집 중에만 잠금 (기록 경로는 잠그지 않음)
+        Shard total;
+        {
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.retired.addTo(total);
+            for (const Shard* shard : reg.shards) shard->addTo(total);
+        }
+
+        appendHeader(out, "mfa_http_requests_total", "HTTP requests by route and status code.", "counter");
+        for (size_t r = 0; r < ROUTE_COUNT; r++) {
+            for (size_t s = 0; s < STATUS_SLOTS; s++) {
+                uint64_t count = total.routes[r].status[s].get();
+                if (count == 0) continue;
+                if (s == STATUS_SLOTS - 1) {
+                    appendf(out, "mfa_http_requests_total{route=\"%s\",code=\"other\"} %llu\n", ROUTE_LABELS[r],
+                            static_cast<unsigned long long>(count));
+                } else {
+                    appendf(out, "mfa_http_requests_total{route=\"%s\",code=\"%d\"} %llu\n", ROUTE_LABELS[r],
+                            STATUS_CODES[s], static_cast<unsigned long long>(count));
+                }
+            }
+        }
+
+        appendHeader(out, "mfa_http_request_duration_seconds", "HTTP request latency by route.", "histogram");
+        for (size_t r = 0; r < ROUTE_COUNT; r++) {
+            if (histogramCount(total.routes[r].latency) == 0) continue;
+            appendHistogram(out, "mfa_http_request_duration_seconds", "route", ROUTE_LABELS[r], total.routes[r].latency);
+        }
+
+        appendHeader(out, "mfa_store_operations_total", "User store operations.", "counter");
+        for (size_t o = 0; o < STORE_OP_COUNT; o++) {
+            appendf(out, "mfa_store_operations_total{op=\"%s\"} %llu\n", STORE_OP_LABELS[o],
+                    static_cast<unsigned long long>(total.store_ops[o].get()));
+        }
+
+        appendHeader(out, "mfa_store_operation_duration_seconds",
+                     "User store operation latency (lookups sampled 1 in 64).", "histogram");
+        for (size_t o = 0; o < STORE_OP_COUNT; o++) {
+            if (histogramCount(total.store_time[o]) == 0) continue;
+            appendHistogram(out, "mfa_store_operation_duration_seconds", "op", STORE_OP_LABELS[o], total.store_time[o]);
+        }
+
+        appendHeader(out, "mfa_hmac_computations_total", "TOTP HMAC-SHA1 computations.", "counter");
+        appendf(out, "mfa_hmac_computations_total %llu\n", static_cast<unsigned long long>(total.hmac.get()));
+
+        appendHeader(out, "mfa_rate_limit_rejections_total", "Authentication attempts rejected by the rate limiter.",
+                     "counter");
+        appendf(out, "mfa_rate_limit_rejections_total %llu\n", static_cast<unsigned long long>(total.rate_limited.get()));
+
+        appendHeader(out, "mfa_http_queue_rejections_total", "Connections closed because the worker queue was full.",
+                     "counter");
+        appendf(out, "mfa_http_queue_rejections_total %llu\n",
+                static_cast<unsigned long long>(queue_rejected.load(std::memory_order_relaxed)));
+
+        appendHeader(out, "mfa_tls_handshakes_total", "Completed TLS handshakes by type.", "counter");
+        appendf(out, "mfa_tls_handshakes_total{type=\"full\"} %llu\n",
+                static_cast<unsigned long long>(tls_handshakes[0].load(std::memory_order_relaxed)));
+        appendf(out, "mfa_tls_handshakes_total{type=\"resumed\"} %llu\n",
+                static_cast<unsigned long long>(tls_handshakes[1].load(std::memory_order_relaxed)));
+
+        appendHeader(out, "mfa_tls_ktls_connections_total", "TLS connections whose record layer runs in the kernel.",
+                     "counter");
+        appendf(out, "mfa_tls_ktls_connections_total %llu\n",
+                static_cast<unsigned long long>(tls_ktls.load(std::memory_order_relaxed)));
+
+        renderGauge(out, "mfa_http_queue_depth", "Accepted connections waiting for a worker thread.",
+                    static_cast<double>(std::max<int64_t>(0, queue_depth.load(std::memory_order_relaxed))));
+    }
+}
@@ -0,0 +1,141 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Prometheus 형식 운영 지표 (/metrics)
+ *
+ * 값은 스레드마다 따로 두는 카운터/히스토그램 샤드에 쌓입니다. 샤드는 그 스레드만 쓰므로
+ * 기록은 원자적 RMW 없이 relaxed load + store 한 번이고, 수집(render)할 때만 모든 샤드를
+ * relaxed load로 합칩니다. 스레드가 끝나면 샤드 값은 누적분에 합쳐지므로 사라지지 않습니다.
+ *
+ * 히스토그램은 옥타브마다 버킷 2개(2^k, 1.5 * 2^k)를 두는 로그-선형 구간(1us ~ 약 17초)이며,
+ * 버킷 위치는 최상위 비트 위치로 바로 계산합니다.
+ */
+namespace Metrics {
+
+    enum class Route : uint8_t {
+        Register,
+        Authenticate,
+        AuthenticateBatch,
+        BulkImport,
+        Delete,
+        List,
+        QRCode,
+        Health,
+        Metrics,
+        Options,
+        BinaryVerify,                   // 바이너리 프로토콜 검증 요청 (상태는 같은 뜻의 HTTP 코드로 기록)
+        Replication,                    // GET /api/replication
+        Cluster,                        // /api/cluster/* (노드 간 요청 포함)
+        Other,                          // 라우트에 걸리지 않은 요청 (404 등)
+        Count
+    };
+
+    enum class StoreOp : uint8_t {
+        Lookup,                         // 인증 경로의 키 조회 (시간은 LOOKUP_SAMPLE_INTERVAL번에 한 번만 측정)
+        Insert,                         // 등록 (WAL/msync 반영 대기 포함)
+        Remove,                         // 삭제 (WAL/msync 반영 대기 포함)
+        Count
+    };
+
+    constexpr size_t ROUTE_COUNT = static_cast<size_t>(Route::Count);
+    constexpr size_t STORE_OP_COUNT = static_cast<size_t>(StoreOp::Count);
+    constexpr unsigned MIN_BUCKET_BITS = 10;                        // 첫 버킷 상한 2^10ns (약 1us)
+    constexpr unsigned MAX_BUCKET_BITS = 34;                        // 마지막 유한 버킷 상한 2^34ns (약 17초)
+    constexpr size_t BUCKET_COUNT = 2 + 2 * (MAX_BUCKET_BITS - MIN_BUCKET_BITS);   // 첫 버킷 + 옥타브당 2개 + 초과
+    constexpr uint32_t LOOKUP_SAMPLE_INTERVAL = 64;
+
+    inline uint64_t nowNs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    /**
+     * @brief HTTP 요청 하나 기록 (응답을 보낸 뒤 호출)
+     * @param route 라우트
+     * @param status HTTP 상태 코드
+     * @param duration_ns 요청 처리 시간 (ns)
+     */
+    void recordRequest(Route route, int status, uint64_t duration_ns);
+
+    /**
+     * @brief 저장소 작업 횟수만 기록
+     */
+    void countStoreOp(StoreOp op, uint64_t count = 1);
+
+    /**
+     * @brief 저장소 작업 시간 기록 (횟수는 countStoreOp로 따로 셈)
+     */
+    void recordStoreTime(StoreOp op, uint64_t duration_ns);
+
+    /**
+     * @brief 이번 조회의 시간을 잴지 결정 (스레드별로 LOOKUP_SAMPLE_INTERVAL번에 한 번 true)
+     */
+    bool sampleLookup();
+
+    /**
+     * @brief HMAC(TOTP 코드) 계산 횟수 추가
+     */
+    void addHMAC(uint64_t count);
+
+    /**
+     * @brief 시도 제한으로 거절한 인증 항목 수 추가
+     */
+    void addRateLimited(uint64_t count = 1);
+
+    /**
+     * @brief 작업 큐에서 처리를 기다리는 연결 수 증감 (여러 스레드가 바꾸는 게이지)
+     */
+    void addQueueDepth(int64_t delta);
+
+    /**
+     * @brief 대기열이 가득 차 바로 닫은 연결 수 추가
+     */
+    void addQueueRejected(uint64_t count = 1);
+
+    /**
+     * @brief 끝난 TLS 핸드셰이크 하나 기록
+     * @param resumed 세션 재개(티켓/캐시)였는지
+     * @param ktls 레코드 암호화를 커널(kTLS)이 맡았는지
+     */
+    void addTLSHandshake(bool resumed, bool ktls);
+
+    /**
+     * @brief 모든 지표를 Prometheus 텍스트 형식으로 추가
+     * @param out 출력 버퍼 (뒤에 추가)
+     */
+    void render(std::string& out);
+
+    /**
+     * @brief 이름 붙은 게이지 한 줄을 Prometheus 형식으로 추가 (HELP/TYPE 포함)
+     */
+    void renderGauge(std::string& out, const char* name, const char* help, double value);
+
+    /**
+     * @brief 저장소 작업 시간 측정 RAII 가드 (횟수는 항상, 시간은 sampled일 때만)
+     */
+    class StoreTimer {
+    public:
+        explicit StoreTimer(StoreOp op, bool sampled = true)
+            : op(op), start(sampled ? nowNs() : 0) {}
+        ~StoreTimer() {
+            countStoreOp(op);
+            if (start) recordStoreTime(op, nowNs() - start);
+        }
+
+        StoreTimer(const StoreTimer&) = delete;
+        StoreTimer& operator=(const StoreTimer&) = delete;
+
+    private:
+        StoreOp op;
+        uint64_t start;
+    };
+}
+
+#endif // METRICS_H
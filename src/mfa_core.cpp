@@ -1,17 +1,105 @@
 #include "mfa_core.h"
+#include "totp_kernel.h"
+#include "logger.h"
+#include "entropy_pool.h"
+#include "metrics.h"
 #include <fstream>
-#include <iostream>
 #include <sstream>
 #include <iomanip>
 #include <cstring>
 #include <ctime>
-#include <random>
 #include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+#include <stdexcept>
 #include <algorithm>
+#include <chrono>
+#include <thread>
 #include <openssl/hmac.h>
 #include <openssl/evp.h>
+#include <openssl/crypto.h>
+#include <openssl/opensslv.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#include <openssl/params.h>
+#endif
 
-MFACore::MFACore(const std::string& user_file) : user_file_path(user_file) {
+namespace {
+
+    // Base32 문자 -> 5비트 값 (유효하지 않은 문자는 -1)
+    struct Base32Table {
+        signed char values[256];
+
+        constexpr Base32Table() : values() {
+            for (int i = 0; i < 256; i++) values[i] = -1;
+            for (int i = 0; i < 26; i++) values['A' + i] = static_cast<signed char>(i);
+            for (int i = 0; i < 6; i++) values['2' + i] = static_cast<signed char>(26 + i);
+        }
+    };
+
+    constexpr Base32Table BASE32_TABLE;
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    /**
+     * @brief 스레드별로 재사용하는 EVP_MAC(HMAC-SHA1) 컨텍스트
+     */
+    class ThreadMACContext {
+        EVP_MAC* mac = nullptr;
+        EVP_MAC_CTX* ctx = nullptr;
+
+    public:
+        ThreadMACContext() {
+            mac = EVP_MAC_fetch(nullptr, "HMAC", nullptr);
+            if (mac) ctx = EVP_MAC_CTX_new(mac);
+        }
+
+        ~ThreadMACContext() {
+            EVP_MAC_CTX_free(ctx);
+            EVP_MAC_free(mac);
+        }
+
+        bool compute(const unsigned char* key, size_t key_len, const unsigned char* data, size_t data_len,
+                     unsigned char* out, unsigned int* out_len) {
+            if (!ctx) return false;
+
+            char digest_name[] = "SHA1";
+            OSSL_PARAM params[] = {
+                OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, digest_name, 0),
+                OSSL_PARAM_construct_end()
+            };
+
+            size_t len = 0;
+            if (!EVP_MAC_init(ctx, key, key_len, params) ||
+                !EVP_MAC_update(ctx, data, data_len) ||
+                !EVP_MAC_final(ctx, out, &len, EVP_MAX_MD_SIZE)) {
+                return false;
+            }
+            *out_len = static_cast<unsigned int>(len);
+            return true;
+        }
+    };
+#else
+    class ThreadMACContext {
+        HMAC_CTX* ctx = HMAC_CTX_new();
+
+    public:
+        ~ThreadMACContext() { HMAC_CTX_free(ctx); }
+
+        bool compute(const unsigned char* key, size_t key_len, const unsigned char* data, size_t data_len,
+                     unsigned char* out, unsigned int* out_len) {
+            return ctx &&
+                   HMAC_Init_ex(ctx, key, static_cast<int>(key_len), EVP_sha1(), nullptr) &&
+                   HMAC_Update(ctx, data, data_len) &&
+                   HMAC_Final(ctx, out, out_len);
+        }
+    };
+#endif
+
+    thread_local ThreadMACContext thread_mac;
+}
+
+MFACore::MFACore(const std::string& user_file, StorageMode mode)
+    : user_file_path(user_file), storage_mode(mode), replay_path(user_file + ".replay") {
     // 데이터 디렉토리가 없으면 생성
     if (user_file_path.find('/') != std::string::npos) {
         std::string dir = user_file_path.substr(0, user_file_path.find_last_of('/'));
@@ -19,10 +107,230 @@ MFACore::MFACore(const std::string& user_file) : user_file_path(user_file) {
         int result = system(("mkdir -p " + dir).c_str());
         (void)result; // unused variable warning 방지
     }
+
+    if (storage_mode == StorageMode::Mapped) {
+        // 파일을 매핑하고 헤더만 검증 (사용자 수와 무관하게 즉시 시작)
+        mapped_store = std::make_unique<MappedUserStore>(user_file_path);
+        if (!mapped_store->open()) {
+            throw std::runtime_error("매핑 저장소를 열 수 없습니다: " + user_file_path + ".map");
+        }
+        if (mapped_store->isWritable() && mapped_store->size() == 0) {
+            migrateToMappedStore();
+        }
+        // 기존 사용자 슬롯의 재사용 방지 청크를 미리 만듦 (인증 경로는 할당 없음)
+        uint64_t slot_count = 0;
+        mapped_store->recordsBegin(slot_count);
+        replay_table.reserve(slot_count);
+        loadReplayState();
+        checkpoint_thread = std::thread(&MFACore::checkpointLoop, this);
+        return;
+    }
+
+    // 사용자 파일은 여기서 한 번만 읽고 이후 조회는 메모리 인덱스로 처리
+    loadUserIndex();
+
+    // 마지막 체크포인트 이후의 변경 사항을 WAL에서 재생
+    wal = std::make_unique<UserWAL>(user_file_path + ".wal");
+    std::vector<WALRecord> replay;
+    bool has_rotated = false;
+    if (!wal->open(replay, has_rotated)) {
+        throw std::runtime_error("WAL 파일을 열 수 없습니다: " + user_file_path + ".wal");
+    }
+    for (const auto& record : replay) {
+        applyWALRecord(record);
+    }
+    MFA_LOG_INFO("MFA_CORE", "WAL replayed: " << replay.size() << " records, " << user_table.size() << " users");
+
+    // 이전 체크포인트가 중단되었으면 지금 완료
+    if (has_rotated) {
+        checkpoint();
+    }
+
+    loadReplayState();
+    checkpoint_thread = std::thread(&MFACore::checkpointLoop, this);
+}
+
+MFACore::~MFACore() {
+    {
+        std::lock_guard<std::mutex> lock(checkpoint_mutex);
+        stopping = true;
+    }
+    checkpoint_cv.notify_all();
+    if (checkpoint_thread.joinable()) {
+        checkpoint_thread.join();
+    }
+    flushReplayState();
+    // wal 소멸자가 남은 버퍼를 기록한 뒤 커밋 스레드를 종료
+}
+
+void MFACore::loadUserIndex() {
+    std::vector<User> users = loadUsersFromFile();
+
+    user_table.clear();
+    user_table.reserve(users.size());
+
+    for (const auto& user : users) {
+        // 중복 레코드는 기존 findUser와 동일하게 첫 번째 레코드만 유효 (insert가 거부)
+        if (user.user_id.empty()) {
+            continue;
+        }
+        HMACKeyState key;
+        computeKeyState(user.secret_base32, key);
+        uint32_t slot = 0;
+        if (user_table.insert(user, key, &slot)) {
+            replay_table.reset(slot);   // 인증 경로에서 청크를 만들지 않도록 미리 준비
+        }
+    }
+
+    MFA_LOG_INFO("MFA_CORE", "User index loaded: " << user_table.size() << " users");
+}
+
+void MFACore::insertIntoIndex(const User& user) {
+    HMACKeyState key;
+    computeKeyState(user.secret_base32, key);
+    insertIntoIndex(user, key);
+}
+
+bool MFACore::insertIntoIndex(const User& user, const HMACKeyState& key) {
+    uint32_t slot = 0;
+    if (!user_table.insert(user, key, &slot)) {
+        return false;
+    }
+    // 삭제된 사용자의 슬롯을 재사용할 수 있으므로 이전 기록을 지움
+    replay_table.reset(slot);
+    return true;
+}
+
+bool MFACore::removeFromIndex(const std::string& user_id) {
+    return user_table.remove(user_id);
+}
+
+void MFACore::migrateToMappedStore() {
+    bool has_snapshot = ::access(user_file_path.c_str(), F_OK) == 0;
+    bool has_wal = ::access((user_file_path + ".wal").c_str(), F_OK) == 0;
+    if (!has_snapshot && !has_wal) {
+        return;
+    }
+
+    // 기존 경로(스냅샷 + WAL 재생)로 최신 상태를 구성한 뒤 매핑 저장소에 복사
+    // 원본 파일은 건드리지 않으므로 Memory 모드로 되돌아가면 이전 상태에서 시작함
+    loadUserIndex();
+    if (has_wal) {
+        UserWAL legacy_wal(user_file_path + ".wal");
+        std::vector<WALRecord> replay;
+        bool has_rotated = false;
+        if (legacy_wal.open(replay, has_rotated)) {
+            for (const auto& record : replay) {
+                applyWALRecord(record);
+            }
+        }
+    }
+
+    size_t migrated = 0;
+    user_table.forEach([&](const UserRecord& record) {
+        if (mapped_store->insert(record.user.user_id, record.user.secret_base32, record.key, false)) {
+            migrated++;
+        }
+    });
+    mapped_store->sync();
+    user_table.clear();
+
+    MFA_LOG_INFO("MFA_CORE", "Migrated " << migrated << " users to mapped store");
+}
+
+bool MFACore::lookupKey(std::string_view user_id, HMACKeyState& key, uint64_t& slot) const {
+    Metrics::StoreTimer timer(Metrics::StoreOp::Lookup, Metrics::sampleLookup());
+    if (mapped_store) {
+        return mapped_store->findKey(user_id, key, &slot);
+    }
+    uint32_t record_slot = 0;
+    if (!user_table.find(user_id, nullptr, &key, &record_slot)) {
+        return false;
+    }
+    slot = record_slot;
+    return true;
+}
+
+void MFACore::loadReplayState() {
+    std::vector<ReplayEntry> entries;
+    if (!ReplayTable::readFile(replay_path, entries)) {
+        MFA_LOG_WARN("MFA_CORE", "재사용 방지 파일을 읽을 수 없습니다: " << replay_path);
+        return;
+    }
+
+    // 앞으로 올 step은 정상적으로 통과한 기록일 수 없음 (받아들이면 그 사용자는 그때까지 인증할 수 없음)
+    uint64_t latest = static_cast<uint64_t>(time(nullptr)) / OTP_PERIOD + ALLOWED_DRIFT_STEPS;
+    size_t restored = 0;
+    for (const auto& entry : entries) {
+        HMACKeyState key;
+        uint64_t slot = 0;
+        if (entry.step <= latest && lookupKey(entry.user_id, key, slot) && replay_table.accept(slot, entry.step)) {
+            restored++;
+        }
+    }
+    replay_table.takeDirty();   // 파일 내용 그대로이므로 다시 쓸 필요 없음
+
+    if (!entries.empty()) {
+        MFA_LOG_INFO("MFA_CORE", "Replay state restored: " << restored << "/" << entries.size() << " users");
+    }
+}
+
+bool MFACore::flushReplayState() {
+    // 읽기 전용으로 연 프로세스는 쓰기 프로세스의 파일을 덮어쓰지 않음
+    if (mapped_store && !mapped_store->isWritable()) {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(replay_flush_mutex);
+    if (!replay_table.takeDirty()) {
+        return true;
+    }
+
+    // 윈도우 밖으로 밀려난 오래된 step은 다시 통과할 수 없으므로 최근 기록만 저장
+    uint64_t now_step = static_cast<uint64_t>(time(nullptr)) / OTP_PERIOD;
+    uint64_t oldest = now_step > REPLAY_RETAIN_STEPS ? now_step - REPLAY_RETAIN_STEPS : 1;
+    std::vector<ReplayEntry> entries;
+    auto collect = [&](std::string_view user_id, uint64_t slot) {
+        uint64_t step = replay_table.lastStep(slot);
+        if (step >= oldest) {
+            entries.push_back(ReplayEntry{std::string(user_id), step});
+        }
+    };
+
+    if (mapped_store) {
+        uint64_t count = 0;
+        const MappedUserRecord* records = mapped_store->recordsBegin(count);
+        for (uint64_t slot = 0; slot < count; slot++) {
+            const MappedUserRecord& record = records[slot];
+            if (__atomic_load_n(&record.state, __ATOMIC_ACQUIRE) == 1) {
+                collect(std::string_view(record.user_id, strnlen(record.user_id, MAPPED_USER_ID_LENGTH)), slot);
+            }
+        }
+    } else {
+        user_table.forEach([&](const UserRecord& record) {
+            collect(record.user.user_id, record.slot);
+        });
+    }
+
+    if (!ReplayTable::writeFile(replay_path, entries)) {
+        MFA_LOG_ERROR("MFA_CORE", "재사용 방지 파일 기록 실패: " << replay_path);
+        return false;
+    }
+    MFA_LOG_DEBUG("MFA_CORE", "Replay state flushed: " << entries.size() << " users");
+    return true;
+}
+
+void MFACore::applyWALRecord(const WALRecord& record) {
+    // 재생은 멱등: 스냅샷에 이미 반영된 레코드를 다시 적용해도 결과가 같음
+    if (record.op == WALOp::Register) {
+        removeFromIndex(record.user_id);
+        insertIntoIndex(User(record.user_id, record.secret_base32));
+    } else if (record.op == WALOp::Delete) {
+        removeFromIndex(record.user_id);
+    }
 }
 
 int MFACore::base32_decode(const std::string& encoded, std::vector<unsigned char>& result) {
-    const std::string base32_chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
     int buffer = 0;
     int bits_left = 0;
     int count = 0;
@@ -31,9 +339,9 @@ int MFACore::base32_decode(const std::string& encoded, std::vector<unsigned char
     result.reserve(encoded.length() * 5 / 8);
     
     for (size_t i = 0; i < encoded.length() && encoded[i] != '='; i++) {
-        size_t pos = base32_chars.find(encoded[i]);
-        if (pos == std::string::npos) {
-            std::cerr << "Base32 디코딩 오류: 유효하지 않은 문자 '" << encoded[i] << "'" << std::endl;
+        int pos = BASE32_TABLE.values[static_cast<unsigned char>(encoded[i])];
+        if (pos < 0) {
+            MFA_LOG_WARN("MFA_CORE", "Base32 디코딩 오류: 유효하지 않은 문자 (위치 " << i << ")");
             return -1;
         }
         
@@ -50,15 +358,29 @@ int MFACore::base32_decode(const std::string& encoded, std::vector<unsigned char
     return count;
 }
 
+bool MFACore::computeKeyState(const std::string& secret_base32, HMACKeyState& state) {
+    std::vector<unsigned char> secret;
+    if (base32_decode(secret_base32, secret) <= 0) {
+        state.valid = false;
+        return false;
+    }
+    return HMACSHA1::precompute(secret.data(), secret.size(), state);
+}
+
 std::string MFACore::base32_encode(const std::vector<unsigned char>& data) {
-    const std::string base32_chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+    return base32_encode(data.data(), data.size());
+}
+
+std::string MFACore::base32_encode(const unsigned char* data, size_t size) {
+    static constexpr char base32_chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
     std::string result;
+    result.reserve((size * 8 + 39) / 40 * 8);
     
     int buffer = 0;
     int bits_left = 0;
     
-    for (unsigned char byte : data) {
-        buffer = (buffer << 8) | byte;
+    for (size_t i = 0; i < size; i++) {
+        buffer = (buffer << 8) | data[i];
         bits_left += 8;
         
         while (bits_left >= 5) {
@@ -81,63 +403,380 @@ std::string MFACore::base32_encode(const std::vector<unsigned char>& data) {
 }
 
 std::string MFACore::generateSecret() {
-    std::vector<unsigned char> key(SECRET_KEY_LENGTH);
+    // 스레드별 엔트로피 풀에서 가져오므로 대부분 시스템 콜/파일 열기 없음
+    unsigned char key[SECRET_KEY_LENGTH];
+    if (!Entropy::fill(key, sizeof(key))) {
+        MFA_LOG_ERROR("MFA_CORE", "안전한 난수 소스를 사용할 수 없습니다 (" << Entropy::sourceName() << ")");
+        return std::string();
+    }
     
-    // /dev/urandom에서 랜덤 바이트 생성
-    std::ifstream urandom("/dev/urandom", std::ios::binary);
-    if (urandom.is_open()) {
-        urandom.read(reinterpret_cast<char*>(key.data()), SECRET_KEY_LENGTH);
-        urandom.close();
-    } else {
-        // fallback: C++ random number generator
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dis(0, 255);
+    std::string secret = base32_encode(key, sizeof(key));
+    OPENSSL_cleanse(key, sizeof(key));
+    return secret;
+}
+
+bool MFACore::generateSecrets(size_t count, std::vector<std::string>& secrets) {
+    secrets.clear();
+    secrets.reserve(count);
+    
+    // 한 번에 채우므로 대량 등록 시 POOL_SIZE 이상이면 시스템 콜 한 번으로 끝남
+    std::vector<unsigned char> keys(count * SECRET_KEY_LENGTH);
+    if (!Entropy::fill(keys.data(), keys.size())) {
+        MFA_LOG_ERROR("MFA_CORE", "안전한 난수 소스를 사용할 수 없습니다 (" << Entropy::sourceName() << ")");
+        return false;
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        secrets.push_back(base32_encode(keys.data() + i * SECRET_KEY_LENGTH, SECRET_KEY_LENGTH));
+    }
+    OPENSSL_cleanse(keys.data(), keys.size());
+    return true;
+}
+
+bool MFACore::registerUser(const std::string& user_id, User& user) {
+    MFA_LOG_DEBUG("MFA_CORE", "registerUser called with user_id: " << user_id);
+    
+    // 파일 레코드에 담을 수 없는 ID는 거부 (스냅샷에서 잘리거나 NUL 앞까지만 남지 않도록)
+    if (!isValidUserId(user_id)) {
+        MFA_LOG_DEBUG("MFA_CORE", "Invalid user_id (length " << user_id.size() << ")");
+        return false;
+    }
+    
+    // 시크릿 생성은 뮤텍스 밖에서 수행
+    std::string secret = generateSecret();
+    if (secret.empty()) {
+        return false;
+    }
+    Metrics::StoreTimer timer(Metrics::StoreOp::Insert);
+    uint64_t lsn = 0;
+    
+    if (mapped_store) {
+        HMACKeyState key;
+        computeKeyState(secret, key);
+        
+        std::lock_guard<std::mutex> lock(mutation_mutex);
+        if (mapped_store->find(user_id)) {
+            MFA_LOG_DEBUG("MFA_CORE", "User already exists: " << user_id);
+            return false;
+        }
         
-        for (int i = 0; i < SECRET_KEY_LENGTH; i++) {
-            key[i] = static_cast<unsigned char>(dis(gen));
+        // 레코드와 인덱스 버킷을 msync한 뒤 반환하므로 별도의 WAL이 필요 없음
+        if (!mapped_store->insert(user_id, secret, key)) {
+            MFA_LOG_ERROR("MFA_CORE", "Mapped store insert failed for: " << user_id);
+            return false;
         }
+        uint64_t slot = 0;
+        if (mapped_store->find(user_id, &slot)) {
+            // 삭제된 사용자의 슬롯을 재사용할 수 있으므로 이전 기록을 지움
+            replay_table.reset(slot);
+        }
+        if (mutation_listener) mutation_listener(WALOp::Register, user_id, secret);
+        user.user_id = user_id;
+        user.secret_base32 = secret;
+        return true;
     }
     
-    return base32_encode(key);
+    {
+        std::lock_guard<std::mutex> lock(mutation_mutex);
+        
+        // 중복 확인 (디스크 반영을 기다리는 같은 ID의 등록 포함)
+        if (user_table.find(user_id, nullptr, nullptr) || pending_registrations.count(user_id)) {
+            MFA_LOG_DEBUG("MFA_CORE", "User already exists: " << user_id);
+            return false; // 이미 존재하는 사용자
+        }
+        
+        MFA_LOG_DEBUG("MFA_CORE", "User not found, creating new user");
+        
+        // 새 사용자 생성
+        user.user_id = user_id;
+        user.secret_base32 = secret;
+        
+        MFA_LOG_DEBUG("MFA_CORE", "Generated secret: " << Log::redact(user.secret_base32));
+        
+        lsn = wal->append(WALOp::Register, user.user_id, user.secret_base32);
+        if (lsn == 0) {
+            MFA_LOG_ERROR("MFA_CORE", "WAL append failed for: " << user_id);
+            return false;
+        }
+        // 디스크에 반영되기 전에는 인증/복제에 보이지 않도록 인덱스에 넣지 않고 표시만 함
+        pending_registrations.emplace(user.user_id, user);
+    }
+    
+    // 뮤텍스 밖에서 대기하므로 동시 등록들이 한 번의 fdatasync로 묶임
+    bool durable = wal->waitDurable(lsn);
+    MFA_LOG_DEBUG("MFA_CORE", "WAL commit result: " << (durable ? "SUCCESS" : "FAILED"));
+    
+    {
+        std::lock_guard<std::mutex> lock(mutation_mutex);
+        // 기다리는 동안 복제/재배치로 같은 ID가 바뀌었으면 표시가 지워져 있음 (그 변경이 WAL에서도 뒤에 있음)
+        auto pending = pending_registrations.find(user_id);
+        if (pending == pending_registrations.end() || pending->second.secret_base32 != user.secret_base32) {
+            return false;
+        }
+        pending_registrations.erase(pending);
+        if (!durable) {
+            return false;
+        }
+        insertIntoIndex(user);
+        if (mutation_listener) mutation_listener(WALOp::Register, user.user_id, user.secret_base32);
+    }
+    
+    if (wal->sizeBytes() >= WAL_CHECKPOINT_BYTES) {
+        checkpoint_cv.notify_one();
+    }
+    return true;
 }
 
-bool MFACore::registerUser(const std::string& user_id, User& user) {
-    std::cout << "[MFA_CORE] registerUser called with user_id: " << user_id << std::endl;
+void MFACore::prepareImport(std::vector<ImportItem>& items, size_t begin, size_t end,
+                            std::vector<HMACKeyState>& keys, std::vector<ImportStatus>& statuses) {
+    size_t missing = 0;
+    for (size_t i = begin; i < end; i++) {
+        if (items[i].secret_base32.empty()) missing++;
+    }
+    
+    // 이 청크에 필요한 시크릿을 스레드별 엔트로피 풀에서 한 번에 생성
+    std::vector<std::string> generated;
+    bool generated_ok = missing == 0 || generateSecrets(missing, generated);
+    size_t next_secret = 0;
+    
+    std::vector<unsigned char> decoded;
+    for (size_t i = begin; i < end; i++) {
+        ImportItem& item = items[i];
+        if (!isValidUserId(item.user_id)) {
+            statuses[i] = ImportStatus::Invalid;
+            continue;
+        }
+        
+        if (item.secret_base32.empty()) {
+            if (!generated_ok) {
+                statuses[i] = ImportStatus::Failed;
+                continue;
+            }
+            item.secret_base32 = std::move(generated[next_secret++]);
+        } else if (item.secret_base32.size() >= static_cast<size_t>(BASE32_ENCODED_MAX_LENGTH) ||
+                   base32_decode(item.secret_base32, decoded) < static_cast<int>(MIN_IMPORTED_SECRET_BYTES)) {
+            // 다른 시스템에서 옮겨 오는 시크릿은 레코드에 들어가고 충분히 길어야 함
+            statuses[i] = ImportStatus::Invalid;
+            continue;
+        }
+        
+        statuses[i] = computeKeyState(item.secret_base32, keys[i]) ? ImportStatus::Created : ImportStatus::Invalid;
+    }
+}
+
+std::vector<ImportStatus> MFACore::importUsers(std::vector<ImportItem>& items, unsigned int max_threads) {
+    std::vector<ImportStatus> statuses(items.size(), ImportStatus::Invalid);
+    if (items.empty()) {
+        return statuses;
+    }
+    if (mapped_store && !mapped_store->isWritable()) {
+        MFA_LOG_ERROR("MFA_CORE", "읽기 전용 저장소에는 대량 등록할 수 없습니다: " << user_file_path);
+        std::fill(statuses.begin(), statuses.end(), ImportStatus::Failed);
+        return statuses;
+    }
+    
+    // 1단계: 시크릿 생성/검증과 키 계산 (잠금 밖, 청크별 병렬)
+    std::vector<HMACKeyState> keys(items.size());
+    constexpr size_t MIN_ITEMS_PER_THREAD = 1024;
+    unsigned int thread_count = max_threads ? max_threads : std::max(1u, std::thread::hardware_concurrency());
+    thread_count = static_cast<unsigned int>(std::min<size_t>(thread_count, (items.size() + MIN_ITEMS_PER_THREAD - 1) / MIN_ITEMS_PER_THREAD));
+    thread_count = std::max(1u, thread_count);
     
-    // 중복 확인
-    User existing_user;
-    if (findUser(user_id, existing_user)) {
-        std::cout << "[MFA_CORE] User already exists: " << user_id << std::endl;
-        return false; // 이미 존재하는 사용자
+    size_t chunk_size = (items.size() + thread_count - 1) / thread_count;
+    std::vector<std::thread> workers;
+    for (unsigned int t = 1; t < thread_count; t++) {
+        size_t begin = t * chunk_size;
+        size_t end = std::min(items.size(), begin + chunk_size);
+        if (begin < end) {
+            workers.emplace_back([&, begin, end] { prepareImport(items, begin, end, keys, statuses); });
+        }
     }
+    prepareImport(items, 0, std::min(items.size(), chunk_size), keys, statuses);
+    for (auto& worker : workers) worker.join();
     
-    std::cout << "[MFA_CORE] User not found, creating new user" << std::endl;
+    // 2단계: 중복 확인과 저장 (IMPORT_LOCK_BATCH명씩 잠금을 잡아 다른 등록/삭제가 끼어들 수 있게 함)
+    size_t created = 0;
+    uint64_t last_lsn = 0;
+    for (size_t begin = 0; begin < items.size(); begin += IMPORT_LOCK_BATCH) {
+        size_t end = std::min(items.size(), begin + IMPORT_LOCK_BATCH);
+        std::lock_guard<std::mutex> lock(mutation_mutex);
+        
+        if (!mapped_store) {
+            user_table.reserve(user_table.size() + (end - begin));
+        }
+        for (size_t i = begin; i < end; i++) {
+            if (statuses[i] != ImportStatus::Created) continue;
+            const ImportItem& item = items[i];
+            
+            if (mapped_store) {
+                if (mapped_store->find(item.user_id)) {
+                    statuses[i] = ImportStatus::Exists;
+                } else if (!mapped_store->insert(item.user_id, item.secret_base32, keys[i], false)) {
+                    statuses[i] = ImportStatus::Failed;
+                } else {
+                    uint64_t slot = 0;
+                    if (mapped_store->find(item.user_id, &slot)) {
+                        replay_table.reset(slot);
+                    }
+                    if (mutation_listener) mutation_listener(WALOp::Register, item.user_id, item.secret_base32);
+                    created++;
+                }
+                continue;
+            }
+            
+            if (user_table.find(item.user_id, nullptr, nullptr) || pending_registrations.count(item.user_id)) {
+                statuses[i] = ImportStatus::Exists;
+                continue;
+            }
+            uint64_t lsn = wal->append(WALOp::Register, item.user_id, item.secret_base32);
+            if (lsn == 0) {
+                statuses[i] = ImportStatus::Failed;
+                continue;
+            }
+            insertIntoIndex(User{item.user_id, item.secret_base32}, keys[i]);
+            if (mutation_listener) mutation_listener(WALOp::Register, item.user_id, item.secret_base32);
+            last_lsn = lsn;
+            created++;
+        }
+    }
     
-    // 새 사용자 생성
-    user.user_id = user_id;
-    user.secret_base32 = generateSecret();
+    // 3단계: 디스크 반영을 한 번만 기다림
+    bool durable = mapped_store ? (created == 0 || mapped_store->sync()) : (last_lsn == 0 || wal->waitDurable(last_lsn));
+    if (!durable) {
+        MFA_LOG_ERROR("MFA_CORE", "대량 등록 반영 실패: " << created << "명 되돌림");
+        std::lock_guard<std::mutex> lock(mutation_mutex);
+        for (size_t i = 0; i < items.size(); i++) {
+            if (statuses[i] != ImportStatus::Created) continue;
+            bool removed = mapped_store ? mapped_store->remove(items[i].user_id) : removeFromIndex(items[i].user_id);
+            if (removed && mutation_listener) mutation_listener(WALOp::Delete, items[i].user_id, {});
+            statuses[i] = ImportStatus::Failed;
+        }
+        return statuses;
+    }
     
-    std::cout << "[MFA_CORE] Generated secret: " << user.secret_base32 << std::endl;
+    Metrics::countStoreOp(Metrics::StoreOp::Insert, created);
+    if (wal && wal->sizeBytes() >= WAL_CHECKPOINT_BYTES) {
+        checkpoint_cv.notify_one();
+    }
+    MFA_LOG_DEBUG("MFA_CORE", "Bulk import: " << created << "/" << items.size() << " users created");
+    return statuses;
+}
+
+bool MFACore::applyReplicated(const std::vector<WALRecord>& records) {
+    if (records.empty()) {
+        return true;
+    }
+    if (mapped_store && !mapped_store->isWritable()) {
+        MFA_LOG_ERROR("MFA_CORE", "읽기 전용 저장소에는 복제 변경을 반영할 수 없습니다: " << user_file_path);
+        return false;
+    }
     
-    // 파일에 저장
-    bool result = saveUserToFile(user);
-    std::cout << "[MFA_CORE] saveUserToFile result: " << (result ? "SUCCESS" : "FAILED") << std::endl;
+    // HMAC 키 계산은 잠금 밖에서
+    std::vector<HMACKeyState> keys(records.size());
+    for (size_t i = 0; i < records.size(); i++) {
+        if (records[i].op == WALOp::Register && !computeKeyState(records[i].secret_base32, keys[i])) {
+            MFA_LOG_WARN("MFA_CORE", "복제된 시크릿 형식이 잘못되어 건너뜁니다: " << records[i].user_id);
+        }
+    }
     
-    return result;
+    uint64_t last_lsn = 0;
+    size_t inserted = 0;
+    size_t removed = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutation_mutex);
+        std::string current_secret;
+        User current;
+        
+        for (size_t i = 0; i < records.size(); i++) {
+            const WALRecord& record = records[i];
+            bool is_register = record.op == WALOp::Register;
+            if (is_register && !keys[i].valid) continue;
+            
+            if (mapped_store) {
+                bool exists = mapped_store->findSecret(record.user_id, current_secret);
+                if (is_register && exists && current_secret == record.secret_base32) continue;
+                if (exists) {
+                    mapped_store->remove(record.user_id);
+                    removed++;
+                }
+                if (!is_register) {
+                    if (exists && mutation_listener) mutation_listener(WALOp::Delete, record.user_id, {});
+                    continue;
+                }
+                if (!mapped_store->insert(record.user_id, record.secret_base32, keys[i], false)) {
+                    MFA_LOG_ERROR("MFA_CORE", "Mapped store insert failed for: " << record.user_id);
+                    return false;
+                }
+                uint64_t slot = 0;
+                if (mapped_store->find(record.user_id, &slot)) {
+                    replay_table.reset(slot);
+                }
+                inserted++;
+                if (mutation_listener) mutation_listener(WALOp::Register, record.user_id, record.secret_base32);
+                continue;
+            }
+            
+            // 디스크 반영을 기다리는 같은 ID의 등록은 이 변경으로 대체 (WAL에서 그 등록보다 뒤에 남김)
+            bool superseded = pending_registrations.erase(record.user_id) != 0;
+            bool exists = user_table.find(record.user_id, &current, nullptr);
+            if (is_register && exists && current.secret_base32 == record.secret_base32) continue;
+            if (exists || superseded) {
+                uint64_t lsn = wal->append(WALOp::Delete, record.user_id);
+                if (lsn == 0) return false;
+                if (exists) {
+                    removeFromIndex(record.user_id);
+                    removed++;
+                }
+                last_lsn = lsn;
+            }
+            if (!is_register) {
+                if (exists && mutation_listener) mutation_listener(WALOp::Delete, record.user_id, {});
+                continue;
+            }
+            uint64_t lsn = wal->append(WALOp::Register, record.user_id, record.secret_base32);
+            if (lsn == 0) return false;
+            insertIntoIndex(User{record.user_id, record.secret_base32}, keys[i]);
+            last_lsn = lsn;
+            inserted++;
+            if (mutation_listener) mutation_listener(WALOp::Register, record.user_id, record.secret_base32);
+        }
+    }
+    
+    bool durable = mapped_store ? (inserted == 0 || mapped_store->sync()) : (last_lsn == 0 || wal->waitDurable(last_lsn));
+    if (!durable) {
+        MFA_LOG_ERROR("MFA_CORE", "복제 변경 반영 실패 (" << records.size() << "건)");
+        return false;
+    }
+    
+    Metrics::countStoreOp(Metrics::StoreOp::Insert, inserted);
+    Metrics::countStoreOp(Metrics::StoreOp::Remove, removed);
+    if (wal && wal->sizeBytes() >= WAL_CHECKPOINT_BYTES) {
+        checkpoint_cv.notify_one();
+    }
+    return true;
+}
+
+bool MFACore::acceptReplicated(std::string_view user_id, uint64_t step) {
+    // 지금 검증 윈도우 밖의 step은 통과한 OTP일 수 없음 (먼 미래 step은 사용자를 잠가 버림)
+    uint64_t now_step = static_cast<uint64_t>(time(nullptr)) / OTP_PERIOD;
+    if (step + ALLOWED_DRIFT_STEPS < now_step || step > now_step + ALLOWED_DRIFT_STEPS) {
+        return false;
+    }
+    HMACKeyState key;
+    uint64_t slot = 0;
+    return lookupKey(user_id, key, slot) && replay_table.accept(slot, step);
 }
 
 bool MFACore::findUser(const std::string& user_id, User& user) {
-    std::vector<User> users = loadUsersFromFile();
-    
-    for (const auto& u : users) {
-        if (u.user_id == user_id) {
-            user = u;
-            return true;
+    if (mapped_store) {
+        if (!mapped_store->findSecret(user_id, user.secret_base32)) {
+            return false;
         }
+        user.user_id = user_id;
+        return true;
     }
     
-    return false;
+    return user_table.find(user_id, &user, nullptr);
 }
 
 int MFACore::generateTOTPCode(const std::string& secret_base32, time_t time_value) {
@@ -148,7 +787,7 @@ int MFACore::generateTOTPCode(const std::string& secret_base32, time_t time_valu
     std::vector<unsigned char> secret;
     int secret_len = base32_decode(secret_base32, secret);
     if (secret_len <= 0) {
-        std::cerr << "TOTP 생성 실패: Base32 디코딩 오류" << std::endl;
+        MFA_LOG_ERROR("MFA_CORE", "TOTP 생성 실패: Base32 디코딩 오류");
         return -1;
     }
     
@@ -164,10 +803,14 @@ int MFACore::generateTOTPCode(const std::string& secret_base32, time_t time_valu
     unsigned char hash[EVP_MAX_MD_SIZE];
     unsigned int hash_len = 0;
     
-    HMAC(EVP_sha1(), secret.data(), secret.size(), counter_bytes, 8, hash, &hash_len);
+    // 스레드별 MAC 컨텍스트 재사용 (호출마다 컨텍스트를 만들지 않음)
+    Metrics::addHMAC(1);
+    if (!thread_mac.compute(secret.data(), secret.size(), counter_bytes, 8, hash, &hash_len)) {
+        hash_len = 0;
+    }
     
     if (hash_len == 0) {
-        std::cerr << "HMAC 계산 실패" << std::endl;
+        MFA_LOG_ERROR("MFA_CORE", "HMAC 계산 실패");
         return -1;
     }
     
@@ -181,48 +824,173 @@ int MFACore::generateTOTPCode(const std::string& secret_base32, time_t time_valu
     return code % 1000000;
 }
 
-bool MFACore::verifyTOTP(const std::string& user_id, const std::string& otp_code, int window) {
-    std::cout << "[MFA_CORE] verifyTOTP called for user: " << user_id << ", OTP: " << otp_code << std::endl;
+bool MFACore::verifyTOTP(std::string_view user_id, std::string_view otp_code, int window) {
+    MFA_LOG_DEBUG("MFA_CORE", "verifyTOTP called for user: " << user_id << ", OTP: " << Log::redact(otp_code));
     
-    User user;
-    if (!findUser(user_id, user)) {
-        std::cout << "[MFA_CORE] User not found: " << user_id << std::endl;
+    HMACKeyState key;
+    uint64_t slot = 0;
+    if (!lookupKey(user_id, key, slot)) {
+        MFA_LOG_DEBUG("MFA_CORE", "User not found: " << user_id);
         return false;
     }
     
-    std::cout << "[MFA_CORE] User found, secret: " << user.secret_base32 << std::endl;
+    MFA_LOG_DEBUG("MFA_CORE", "User found: " << user_id);
     
-    int input_code;
-    try {
-        input_code = std::stoi(otp_code);
-    } catch (const std::exception&) {
-        std::cout << "[MFA_CORE] Invalid OTP format: " << otp_code << std::endl;
+    if (!key.valid) {
+        MFA_LOG_WARN("MFA_CORE", "Invalid secret for user: " << user_id);
         return false;
     }
     
-    if (input_code < 0 || input_code > 999999) {
-        std::cout << "[MFA_CORE] OTP out of range: " << input_code << std::endl;
+    // 일괄 인증과 같은 규칙 (숫자만, 최대 6자리)
+    int input_code = parseOTPCode(otp_code);
+    if (input_code < 0) {
+        MFA_LOG_DEBUG("MFA_CORE", "Invalid OTP format: " << Log::redact(otp_code));
         return false;
     }
     
     time_t current_time = time(nullptr);
-    std::cout << "[MFA_CORE] Current time: " << current_time << std::endl;
+    MFA_LOG_DEBUG("MFA_CORE", "Current time: " << current_time);
+    
+    // 윈도우 후보 전체를 커널로 한 번에 계산한 뒤 분기 없이 비교 (조기 종료 없음)
+    uint64_t first_counter = static_cast<uint64_t>(current_time) / OTP_PERIOD - static_cast<uint64_t>(window);
+    int candidate_count = 2 * window + 1;
+    int codes[TOTPKernel::MAX_WINDOW_CANDIDATES];
+    int matched_index = -1;
+    
+    for (int done = 0; done < candidate_count; done += TOTPKernel::MAX_WINDOW_CANDIDATES) {
+        int n = std::min(candidate_count - done, TOTPKernel::MAX_WINDOW_CANDIDATES);
+        TOTPKernel::windowCodes(key, first_counter + static_cast<uint64_t>(done), n, codes);
     
-    // 윈도우 범위 내에서 검증
-    for (int i = -window; i <= window; i++) {
-        time_t check_time = current_time + (i * OTP_PERIOD);
-        int generated = generateTOTPCode(user.secret_base32, check_time);
+        int index = TOTPKernel::matchIndex(codes, n, input_code);
+        if (index >= 0) matched_index = done + index;
+    }
+    Metrics::addHMAC(static_cast<uint64_t>(candidate_count));
+    
+    MFA_LOG_DEBUG("MFA_CORE", (matched_index >= 0 ? "OTP match found" : "No OTP match found")
+                  << " (" << candidate_count << " candidates, kernel: " << TOTPKernel::implementationName() << ")");
+    if (matched_index < 0) {
+        return false;
+    }
+    
+    // 일치한 step이 마지막으로 통과한 step보다 커야 함 (동시 제출 중에도 하나만 통과)
+    uint64_t step = first_counter + static_cast<uint64_t>(matched_index);
+    if (!replay_table.accept(slot, step)) {
+        MFA_LOG_DEBUG("MFA_CORE", "OTP already used for user: " << user_id);
+        return false;
+    }
+    if (accept_listener) accept_listener(user_id, step);
+    return true;
+}
+
+bool MFACore::isValidUserId(std::string_view user_id) {
+    // NUL이 있으면 스냅샷/매핑 레코드에서 그 앞까지만 남아 다른 ID와 겹침
+    return !user_id.empty() && user_id.size() < static_cast<size_t>(MAX_USER_ID_LENGTH) &&
+           user_id.find('\0') == std::string_view::npos;
+}
+
+int MFACore::parseOTPCode(std::string_view otp_code) {
+    if (otp_code.empty() || otp_code.size() > static_cast<size_t>(OTP_DIGITS)) {
+        return -1;
+    }
+    
+    int value = 0;
+    for (char c : otp_code) {
+        if (c < '0' || c > '9') return -1;
+        value = value * 10 + (c - '0');
+    }
+    return value;
+}
+
+std::vector<AuthItemResult> MFACore::verifyTOTPBatch(const std::vector<AuthItem>& items, int window, unsigned int max_threads) {
+    using Clock = std::chrono::steady_clock;
+    
+    std::vector<AuthItemResult> results(items.size());
+    std::vector<HMACKeyState> key_copies(items.size());
+    std::vector<const HMACKeyState*> keys(items.size(), nullptr);
+    std::vector<uint64_t> slots(items.size(), 0);
+    std::vector<int> input_codes(items.size(), -1);
+    
+    // 1단계: 한 번의 인덱스 패스로 모든 사용자 조회
+    for (size_t i = 0; i < items.size(); i++) {
+        auto start = Clock::now();
         
-        std::cout << "[MFA_CORE] Window " << i << ": generated=" << generated << ", input=" << input_code << std::endl;
+        input_codes[i] = parseOTPCode(items[i].otp_code);
+        if (items[i].user_id.empty() || input_codes[i] < 0) {
+            results[i].valid_request = false;
+        } else {
+            if (lookupKey(items[i].user_id, key_copies[i], slots[i]) && key_copies[i].valid) {
+                keys[i] = &key_copies[i];
+            }
+        }
         
-        if (generated == input_code) {
-            std::cout << "[MFA_CORE] OTP match found at window " << i << std::endl;
-            return true;
+        results[i].lookup_ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    }
+    
+    // 2단계: 청크별로 (키, 카운터) 후보를 펼쳐 커널 배치로 계산
+    const int candidate_count = 2 * window + 1;
+    const uint64_t first_counter = static_cast<uint64_t>(time(nullptr)) / OTP_PERIOD - static_cast<uint64_t>(window);
+    
+    auto verifyChunk = [&](size_t begin, size_t end) {
+        auto start = Clock::now();
+        
+        std::vector<const HMACKeyState*> chunk_keys;
+        std::vector<uint64_t> counters;
+        std::vector<size_t> owners;
+        chunk_keys.reserve((end - begin) * candidate_count);
+        counters.reserve((end - begin) * candidate_count);
+        owners.reserve(end - begin);
+        
+        for (size_t i = begin; i < end; i++) {
+            if (!keys[i]) continue;
+            owners.push_back(i);
+            for (int c = 0; c < candidate_count; c++) {
+                chunk_keys.push_back(keys[i]);
+                counters.push_back(first_counter + static_cast<uint64_t>(c));
+            }
+        }
+        
+        std::vector<int> codes(chunk_keys.size());
+        TOTPKernel::batchCodes(chunk_keys.data(), counters.data(), chunk_keys.size(), codes.data());
+        Metrics::addHMAC(chunk_keys.size());
+        
+        for (size_t k = 0; k < owners.size(); k++) {
+            size_t i = owners[k];
+            int index = TOTPKernel::matchIndex(codes.data() + k * candidate_count, candidate_count, input_codes[i]);
+            // 같은 배치 안의 중복 항목도 재사용으로 보고 하나만 통과
+            uint64_t step = first_counter + static_cast<uint64_t>(index);
+            results[i].success = index >= 0 && replay_table.accept(slots[i], step);
+            if (results[i].success && accept_listener) accept_listener(items[i].user_id, step);
+        }
+        
+        uint64_t elapsed = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+        for (size_t i = begin; i < end; i++) {
+            results[i].verify_ns = elapsed / (end - begin);
         }
+    };
+    
+    // 작은 배치는 스레드 생성 비용이 더 크므로 현재 스레드에서 처리
+    constexpr size_t MIN_ITEMS_PER_THREAD = 64;
+    unsigned int thread_count = max_threads ? max_threads : std::max(1u, std::thread::hardware_concurrency());
+    thread_count = static_cast<unsigned int>(std::min<size_t>(thread_count, (items.size() + MIN_ITEMS_PER_THREAD - 1) / MIN_ITEMS_PER_THREAD));
+    
+    if (thread_count <= 1) {
+        if (!items.empty()) verifyChunk(0, items.size());
+        return results;
     }
     
-    std::cout << "[MFA_CORE] No OTP match found" << std::endl;
-    return false;
+    size_t chunk_size = (items.size() + thread_count - 1) / thread_count;
+    std::vector<std::thread> workers;
+    for (unsigned int t = 1; t < thread_count; t++) {
+        size_t begin = t * chunk_size;
+        size_t end = std::min(items.size(), begin + chunk_size);
+        if (begin < end) workers.emplace_back(verifyChunk, begin, end);
+    }
+    verifyChunk(0, std::min(items.size(), chunk_size));
+    for (auto& worker : workers) worker.join();
+    
+    return results;
 }
 
 std::string MFACore::generateOTPURI(const User& user) {
@@ -238,63 +1006,43 @@ std::string MFACore::generateOTPURI(const User& user) {
 }
 
 std::string MFACore::generateQRCodeURL(const User& user) {
-    std::string otp_uri = generateOTPURI(user);
-    std::ostringstream url;
-    
-    url << "https://api.qrserver.com/v1/create-qr-code/?size=200x200&data=";
-    
-    // URL 인코딩
-    for (char c : otp_uri) {
-        if (c == ':') url << "%3A";
-        else if (c == '/') url << "%2F";
-        else if (c == '?') url << "%3F";
-        else if (c == '&') url << "%26";
-        else if (c == '=') url << "%3D";
-        else url << c;
-    }
+    // 시크릿이 담긴 URI를 외부 서비스로 보내지 않고 이 서버의 렌더링 엔드포인트를 가리킴
+    static const char hex[] = "0123456789ABCDEF";
+    std::string url = "/api/qr/";
+    url.reserve(url.size() + user.user_id.size() * 3);
     
-    return url.str();
-}
-
-bool MFACore::saveUserToFile(const User& user) {
-    std::cout << "[MFA_CORE] saveUserToFile called for: " << user.user_id << std::endl;
-    std::cout << "[MFA_CORE] File path: " << user_file_path << std::endl;
-    
-    std::ofstream file(user_file_path, std::ios::binary | std::ios::app);
-    if (!file.is_open()) {
-        std::cerr << "[MFA_CORE] 사용자 파일 열기 실패: " << user_file_path << std::endl;
-        return false;
+    // URL 인코딩 (비예약 문자만 그대로)
+    for (unsigned char c : user.user_id) {
+        if (isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
+            url += static_cast<char>(c);
+        } else {
+            url += '%';
+            url += hex[c >> 4];
+            url += hex[c & 0xF];
+        }
     }
     
-    // 간단한 바이너리 형식으로 저장 (기존 C 구조체와 호환)
-    char user_id_buf[MAX_USER_ID_LENGTH] = {0};
-    char secret_buf[BASE32_ENCODED_MAX_LENGTH] = {0};
-    
-    strncpy(user_id_buf, user.user_id.c_str(), MAX_USER_ID_LENGTH - 1);
-    strncpy(secret_buf, user.secret_base32.c_str(), BASE32_ENCODED_MAX_LENGTH - 1);
-    
-    std::cout << "[MFA_CORE] Writing user data to file..." << std::endl;
-    file.write(user_id_buf, MAX_USER_ID_LENGTH);
-    file.write(secret_buf, BASE32_ENCODED_MAX_LENGTH);
-    
-    bool result = file.good();
-    std::cout << "[MFA_CORE] File write result: " << (result ? "SUCCESS" : "FAILED") << std::endl;
-    
-    return result;
+    return url;
 }
 
 std::vector<User> MFACore::loadUsersFromFile() {
-    std::cout << "[MFA_CORE] loadUsersFromFile called" << std::endl;
-    std::cout << "[MFA_CORE] File path: " << user_file_path << std::endl;
+    MFA_LOG_DEBUG("MFA_CORE", "loadUsersFromFile: " << user_file_path);
     
     std::vector<User> users;
-    std::ifstream file(user_file_path, std::ios::binary);
+    std::ifstream file(user_file_path, std::ios::binary | std::ios::ate);
     
     if (!file.is_open()) {
-        std::cout << "[MFA_CORE] File does not exist or cannot be opened" << std::endl;
+        MFA_LOG_INFO("MFA_CORE", "User file does not exist or cannot be opened: " << user_file_path);
         return users; // 파일이 없으면 빈 벡터 반환
     }
     
+    // 레코드 수만큼 미리 할당 (고정 크기 레코드)
+    std::streamoff file_size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    if (file_size > 0) {
+        users.reserve(static_cast<size_t>(file_size) / (MAX_USER_ID_LENGTH + BASE32_ENCODED_MAX_LENGTH));
+    }
+    
     char user_id_buf[MAX_USER_ID_LENGTH];
     char secret_buf[BASE32_ENCODED_MAX_LENGTH];
     
@@ -314,57 +1062,194 @@ std::vector<User> MFACore::loadUsersFromFile() {
             user.secret_base32 = user.secret_base32.substr(0, pos);
         }
         
-        std::cout << "[MFA_CORE] Loaded user " << user_count << ": " << user.user_id << std::endl;
-        users.push_back(user);
+        users.push_back(std::move(user));
         user_count++;
     }
     
-    std::cout << "[MFA_CORE] Total users loaded: " << user_count << std::endl;
+    MFA_LOG_INFO("MFA_CORE", "Total users loaded: " << user_count);
     
     return users;
 }
 
-bool MFACore::deleteUser(const std::string& user_id) {
-    std::vector<User> users = loadUsersFromFile();
-    
-    auto it = std::remove_if(users.begin(), users.end(),
-        [&user_id](const User& user) {
-            return user.user_id == user_id;
-        });
-    
-    if (it == users.end()) {
-        return false; // 사용자를 찾지 못함
+bool MFACore::writeSnapshot(const std::vector<User>& users) {
+    // 임시 파일에 전체를 쓴 뒤 rename으로 교체 (중간에 죽어도 기존 파일 유지)
+    std::string tmp_path = user_file_path + ".tmp";
+    int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        MFA_LOG_ERROR("MFA_CORE", "스냅샷 파일 열기 실패: " << tmp_path);
+        return false;
     }
     
-    users.erase(it, users.end());
+    const size_t record_size = MAX_USER_ID_LENGTH + BASE32_ENCODED_MAX_LENGTH;
+    std::vector<char> buffer;
+    buffer.reserve(record_size * 4096);
+    bool ok = true;
     
-    // 파일 다시 쓰기
-    std::ofstream file(user_file_path, std::ios::binary | std::ios::trunc);
-    if (!file.is_open()) {
-        return false;
-    }
+    auto flush = [&]() {
+        size_t written = 0;
+        while (ok && written < buffer.size()) {
+            ssize_t n = ::write(fd, buffer.data() + written, buffer.size() - written);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) ok = false;
+            else written += static_cast<size_t>(n);
+        }
+        buffer.clear();
+    };
     
     for (const auto& user : users) {
+        // 간단한 바이너리 형식으로 저장 (기존 C 구조체와 호환)
         char user_id_buf[MAX_USER_ID_LENGTH] = {0};
         char secret_buf[BASE32_ENCODED_MAX_LENGTH] = {0};
         
         strncpy(user_id_buf, user.user_id.c_str(), MAX_USER_ID_LENGTH - 1);
         strncpy(secret_buf, user.secret_base32.c_str(), BASE32_ENCODED_MAX_LENGTH - 1);
         
-        file.write(user_id_buf, MAX_USER_ID_LENGTH);
-        file.write(secret_buf, BASE32_ENCODED_MAX_LENGTH);
+        buffer.insert(buffer.end(), user_id_buf, user_id_buf + MAX_USER_ID_LENGTH);
+        buffer.insert(buffer.end(), secret_buf, secret_buf + BASE32_ENCODED_MAX_LENGTH);
+        if (buffer.size() >= record_size * 4096) flush();
+    }
+    flush();
+    
+    ok = ok && ::fdatasync(fd) == 0;
+    ::close(fd);
+    
+    if (!ok || ::rename(tmp_path.c_str(), user_file_path.c_str()) != 0) {
+        MFA_LOG_ERROR("MFA_CORE", "스냅샷 기록 실패: " << user_file_path);
+        ::unlink(tmp_path.c_str());
+        return false;
+    }
+    UserWAL::syncParentDirectory(user_file_path);
+    return true;
+}
+
+bool MFACore::checkpoint() {
+    if (mapped_store) {
+        std::lock_guard<std::mutex> lock(mutation_mutex);
+        return mapped_store->sync();
+    }
+    
+    std::lock_guard<std::mutex> run_lock(checkpoint_run_mutex);
+    
+    std::vector<User> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(mutation_mutex);
+        
+        // 이전 체크포인트가 남긴 .1 파일이 있으면 회전 없이 그 내용까지 포함해 스냅샷 작성
+        if (::access(wal->rotatedPath().c_str(), F_OK) != 0 && !wal->rotate()) {
+            MFA_LOG_ERROR("MFA_CORE", "WAL rotate failed");
+            return false;
+        }
+        
+        snapshot.reserve(user_table.size() + pending_registrations.size());
+        user_table.forEach([&](const UserRecord& record) {
+            snapshot.push_back(record.user);
+        });
+        // 회전된 WAL에만 있는 등록이 체크포인트 뒤에 사라지지 않도록 반영을 기다리는 등록도 포함
+        for (const auto& [user_id, pending] : pending_registrations) {
+            snapshot.push_back(pending);
+        }
+    }
+    
+    if (!writeSnapshot(snapshot)) {
+        return false;
     }
+    wal->removeRotated();
     
-    return file.good();
+    MFA_LOG_INFO("MFA_CORE", "Checkpoint completed: " << snapshot.size() << " users");
+    return true;
+}
+
+void MFACore::checkpointLoop() {
+    std::unique_lock<std::mutex> lock(checkpoint_mutex);
+    auto next_replay_flush = std::chrono::steady_clock::now() + std::chrono::seconds(REPLAY_FLUSH_INTERVAL_SECONDS);
+    
+    while (!stopping) {
+        checkpoint_cv.wait_for(lock, std::chrono::seconds(1));
+        if (stopping) {
+            break;
+        }
+    
+        // Mapped 모드는 WAL이 없고 재사용 방지 상태 저장만 수행
+        bool wal_full = wal && wal->sizeBytes() >= WAL_CHECKPOINT_BYTES;
+        bool flush_due = std::chrono::steady_clock::now() >= next_replay_flush;
+        if (!wal_full && !flush_due) {
+            continue;
+        }
+    
+        lock.unlock();
+        if (wal_full) {
+            checkpoint();
+        }
+        if (flush_due) {
+            // 인증마다 쓰지 않고 주기마다 한 번에 기록
+            flushReplayState();
+            next_replay_flush = std::chrono::steady_clock::now() + std::chrono::seconds(REPLAY_FLUSH_INTERVAL_SECONDS);
+        }
+        lock.lock();
+    }
+}
+
+bool MFACore::deleteUser(const std::string& user_id) {
+    Metrics::StoreTimer timer(Metrics::StoreOp::Remove);
+    uint64_t lsn = 0;
+    User removed;
+    
+    if (mapped_store) {
+        std::lock_guard<std::mutex> lock(mutation_mutex);
+        if (!mapped_store->remove(user_id)) {
+            return false;
+        }
+        if (mutation_listener) mutation_listener(WALOp::Delete, user_id, {});
+        return true;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutation_mutex);
+        
+        if (!user_table.find(user_id, &removed, nullptr)) {
+            return false; // 사용자를 찾지 못함
+        }
+        
+        // 파일 재작성 없이 삭제 레코드만 추가 (O(1))
+        lsn = wal->append(WALOp::Delete, user_id);
+        if (lsn == 0) {
+            return false;
+        }
+        removeFromIndex(user_id);
+        if (mutation_listener) mutation_listener(WALOp::Delete, user_id, {});
+    }
+    
+    if (!wal->waitDurable(lsn)) {
+        // 로그 반영 실패 시 인덱스 원상 복구
+        std::lock_guard<std::mutex> lock(mutation_mutex);
+        if (!user_table.find(user_id, nullptr, nullptr)) {
+            insertIntoIndex(removed);
+            if (mutation_listener) mutation_listener(WALOp::Register, removed.user_id, removed.secret_base32);
+        }
+        return false;
+    }
+    
+    if (wal->sizeBytes() >= WAL_CHECKPOINT_BYTES) {
+        checkpoint_cv.notify_one();
+    }
+    return true;
 }
 
 std::vector<std::string> MFACore::listUsers() {
     std::vector<std::string> user_ids;
-    std::vector<User> users = loadUsersFromFile();
     
-    for (const auto& user : users) {
-        user_ids.push_back(user.user_id);
+    if (mapped_store) {
+        user_ids.reserve(mapped_store->size());
+        mapped_store->forEach([&](const MappedUserRecord& record) {
+            user_ids.emplace_back(record.user_id, strnlen(record.user_id, MAPPED_USER_ID_LENGTH));
+        });
+        return user_ids;
     }
     
+    user_ids.reserve(user_table.size());
+    user_table.forEach([&](const UserRecord& record) {
+        user_ids.push_back(record.user.user_id);
+    });
+    
     return user_ids;
 }
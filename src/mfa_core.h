@@ -1,9 +1,21 @@
 #ifndef MFA_CORE_H
 #define MFA_CORE_H
 
+#include <cstring>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <condition_variable>
+#include <functional>
+#include "hmac_sha1.h"
+#include "user_wal.h"
+#include "mapped_user_store.h"
+#include "user_table.h"
+#include "replay_table.h"
 
 // 상수 정의
 constexpr int SECRET_KEY_LENGTH = 20;
@@ -14,47 +26,194 @@ constexpr int ALLOWED_DRIFT_STEPS = 1;
 constexpr int MAX_USER_ID_LENGTH = 50;
 constexpr const char* ISSUER_NAME = "My_Awesome_Project";
 constexpr const char* DEFAULT_USER_FILE = "data/users.dat";
+constexpr size_t USER_SCAN_MAX_SLOTS = 65536;                   // 목록 페이지 하나에서 검사할 최대 슬롯 수
+constexpr uint64_t WAL_CHECKPOINT_BYTES = 16ull * 1024 * 1024;  // WAL이 이 크기를 넘으면 스냅샷으로 압축
+constexpr int REPLAY_FLUSH_INTERVAL_SECONDS = 5;                // 재사용 방지 상태를 파일에 모아 쓰는 주기
+constexpr uint64_t REPLAY_RETAIN_STEPS = 10;                    // 이보다 오래된 time step 기록은 파일에 남기지 않음
+constexpr size_t IMPORT_LOCK_BATCH = 4096;                      // 대량 등록 시 mutation_mutex를 한 번 잡고 넣는 최대 사용자 수
+constexpr size_t MIN_IMPORTED_SECRET_BYTES = 16;                // 가져오는 시크릿의 최소 길이 (RFC 4226 권장 128비트)
 
 /**
- * @brief 사용자 정보 구조체
+ * @brief 사용자 저장소 방식
  */
-struct User {
+enum class StorageMode {
+    Memory,     // users.dat 스냅샷 + WAL, 시작 시 메모리 인덱스 구성
+    Mapped      // mmap 고정 레코드 파일 + 파일 해시 인덱스 (시작 시 로드 없음)
+};
+
+/**
+ * @brief 일괄 인증 요청 항목
+ */
+struct AuthItem {
+    std::string user_id;
+    std::string otp_code;
+};
+
+/**
+ * @brief 일괄 인증 항목별 결과
+ */
+struct AuthItemResult {
+    bool success = false;
+    bool valid_request = true;   // user_id/otp_code 형식이 올바른지
+    uint64_t lookup_ns = 0;      // 인덱스 조회 시간
+    uint64_t verify_ns = 0;      // HMAC 계산 + 비교 시간 (청크 단위 평균)
+};
+
+/**
+ * @brief 대량 등록 항목 (secret_base32가 비어 있으면 새로 생성해 채움)
+ */
+struct ImportItem {
     std::string user_id;
     std::string secret_base32;
-    
-    User() = default;
-    User(const std::string& id, const std::string& secret) 
-        : user_id(id), secret_base32(secret) {}
 };
 
+/**
+ * @brief 대량 등록 항목별 결과
+ */
+enum class ImportStatus : uint8_t {
+    Created,
+    Exists,     // 이미 등록된 사용자 (같은 요청 안에서 앞서 나온 user_id 포함)
+    Invalid,    // user_id 길이 또는 시크릿 형식 오류
+    Failed      // 시크릿 생성 또는 저장 실패
+};
+
+/**
+ * @brief 등록/삭제 통지 (복제 리더가 변경 로그를 만드는 데 사용)
+ *
+ * mutation_mutex를 잡은 채 변경 순서대로 호출되므로 짧게 끝나야 하고 MFACore를 다시 부르면 안 됩니다.
+ * 디스크 반영에 실패해 되돌린 변경은 반대 변경(등록이면 Delete, 삭제면 Register)으로 한 번 더 통지합니다.
+ * (std::string_view user_id, std::string_view secret_base32: Delete는 빈 문자열, 호출 중에만 유효)
+ */
+using MutationListener = std::function<void(WALOp op, std::string_view user_id, std::string_view secret_base32)>;
+
+/**
+ * @brief OTP 통과 통지 (복제 노드끼리 재사용 방지 상태를 나누는 데 사용, 인증 스레드에서 호출)
+ * (std::string_view user_id, uint64_t 통과한 time step)
+ */
+using AcceptListener = std::function<void(std::string_view user_id, uint64_t step)>;
+
 /**
  * @brief MFA 핵심 기능을 제공하는 클래스
  */
 class MFACore {
 private:
     std::string user_file_path;
+    StorageMode storage_mode;
 
-    // Base32 인코딩/디코딩 헬퍼 함수들
-    int base32_decode(const std::string& encoded, std::vector<unsigned char>& result);
-    std::string base32_encode(const std::vector<unsigned char>& data);
+    // 매핑 저장소 (StorageMode::Mapped일 때만 사용)
+    std::unique_ptr<MappedUserStore> mapped_store;
+
+    // 메모리 사용자 인덱스 (생성 시 한 번 로드, 읽기는 잠금 없음, 쓰기는 mutation_mutex로 직렬화)
+    UserTable user_table;
+
+    // 변경 로그 (등록/삭제는 WAL에 기록하고 주기적으로 users.dat 스냅샷에 체크포인트)
+    std::unique_ptr<UserWAL> wal;
+    std::mutex mutation_mutex;                            // 등록/삭제 직렬화 (유일한 쓰기 경로)
+    // WAL에 적었지만 디스크 반영을 기다리는 단건 등록 (mutation_mutex, 반영된 뒤에야 인덱스와 통지에 나타남)
+    std::unordered_map<std::string, User> pending_registrations;
+    std::mutex checkpoint_run_mutex;                      // 체크포인트 동시 실행 방지
+    std::mutex checkpoint_mutex;
+    std::condition_variable checkpoint_cv;
+    std::thread checkpoint_thread;
+    bool stopping = false;
+
+    // OTP 재사용 방지 (사용자 슬롯별 마지막 통과 time step, <user_file>.replay에 주기적으로 저장)
+    ReplayTable replay_table;
+    std::string replay_path;
+    std::mutex replay_flush_mutex;
+
+    // 복제 통지 (서버 시작 전에 한 번 설정)
+    MutationListener mutation_listener;
+    AcceptListener accept_listener;
+
+    // OTP 문자열을 정수로 변환 (6자리 숫자가 아니면 -1)
+    static int parseOTPCode(std::string_view otp_code);
+
+    // Base32 시크릿을 디코딩해 HMAC 키 상태를 미리 계산
+    bool computeKeyState(const std::string& secret_base32, HMACKeyState& state);
+
+    // 대량 등록 1단계: 시크릿 생성/검증과 키 계산 (잠금 없음, 청크별 병렬)
+    void prepareImport(std::vector<ImportItem>& items, size_t begin, size_t end,
+                       std::vector<HMACKeyState>& keys, std::vector<ImportStatus>& statuses);
 
     // 파일 I/O 헬퍼 함수들
-    bool saveUserToFile(const User& user);
+    bool writeSnapshot(const std::vector<User>& users);
     std::vector<User> loadUsersFromFile();
 
+    // 인덱스 헬퍼 함수들
+    void loadUserIndex();
+    void insertIntoIndex(const User& user);
+    bool insertIntoIndex(const User& user, const HMACKeyState& key);
+    bool removeFromIndex(const std::string& user_id);
+    void applyWALRecord(const WALRecord& record);
+    bool lookupKey(std::string_view user_id, HMACKeyState& key, uint64_t& slot) const;
+
+    // 재사용 방지 상태 복원 (인덱스 구성 후 한 번)
+    void loadReplayState();
+
+    // 기존 users.dat + WAL 내용을 매핑 저장소로 한 번 옮김
+    void migrateToMappedStore();
+
+    // 체크포인트 스레드 (WAL 체크포인트 + 재사용 방지 상태 저장)
+    void checkpointLoop();
+
 public:
     /**
      * @brief 생성자
+     *
+     * Memory 모드는 사용자 파일을 한 번 읽어 메모리 인덱스를 구성하고,
+     * Mapped 모드는 <user_file>.map / <user_file>.idx 파일을 매핑만 합니다.
+     *
      * @param user_file 사용자 데이터 파일 경로
+     * @param mode 저장소 방식
+     */
+    explicit MFACore(const std::string& user_file = DEFAULT_USER_FILE,
+                     StorageMode mode = StorageMode::Memory);
+
+    /**
+     * @brief 소멸자 (체크포인트 스레드 종료, 남은 WAL 기록)
      */
-    explicit MFACore(const std::string& user_file = DEFAULT_USER_FILE);
+    ~MFACore();
+
+    MFACore(const MFACore&) = delete;
+    MFACore& operator=(const MFACore&) = delete;
 
     /**
-     * @brief 랜덤 시크릿 키 생성
-     * @return Base32로 인코딩된 시크릿 키
+     * @brief Base32 디코딩 ('=' 패딩에서 멈춤)
+     * @param encoded Base32 문자열
+     * @param result 디코딩된 바이트 (덮어씀)
+     * @return 디코딩된 바이트 수, 유효하지 않은 문자가 있으면 -1
+     */
+    int base32_decode(const std::string& encoded, std::vector<unsigned char>& result);
+
+    /**
+     * @brief Base32 인코딩 (8자 단위 '=' 패딩)
+     * @param data 인코딩할 바이트
+     * @return Base32 문자열
+     */
+    std::string base32_encode(const std::vector<unsigned char>& data);
+    std::string base32_encode(const unsigned char* data, size_t size);
+
+    /**
+     * @brief 랜덤 시크릿 키 생성 (스레드별 엔트로피 풀 사용)
+     * @return Base32로 인코딩된 시크릿 키, 안전한 난수 소스를 쓸 수 없으면 빈 문자열
      */
     std::string generateSecret();
 
+    /**
+     * @brief 시크릿 키 여러 개를 한 번에 생성 (대량 등록용)
+     * @param count 생성할 개수
+     * @param secrets Base32로 인코딩된 시크릿 키 count개 (덮어씀)
+     * @return 안전한 난수 소스를 쓸 수 없으면 false
+     */
+    bool generateSecrets(size_t count, std::vector<std::string>& secrets);
+
+    /**
+     * @brief 파일 레코드(고정 길이, NUL 종료)에 그대로 담을 수 있는 사용자 ID인지
+     * @return 비어 있지 않고 MAX_USER_ID_LENGTH - 1자 이하이며 NUL 문자가 없으면 true
+     */
+    static bool isValidUserId(std::string_view user_id);
+
     /**
      * @brief 새 사용자 등록
      * @param user_id 사용자 ID
@@ -63,6 +222,62 @@ public:
      */
     bool registerUser(const std::string& user_id, User& user);
 
+    /**
+     * @brief 여러 사용자를 한 번에 등록 (대량 가져오기)
+     *
+     * 시크릿 생성과 HMAC 키 계산은 잠금 밖에서 여러 스레드로 나눠 수행하고,
+     * 중복 확인과 저장은 IMPORT_LOCK_BATCH명씩 mutation_mutex를 한 번 잡고 순서대로 처리합니다.
+     * Memory 모드는 WAL에 이어 쓴 뒤 마지막 LSN을 한 번만 기다리고(실패하면 이번 호출로
+     * 추가한 사용자를 모두 되돌림), Mapped 모드는 msync 없이 넣은 뒤 sync()를 한 번 호출합니다.
+     *
+     * @param items 등록할 항목 (secret_base32가 빈 항목은 생성된 시크릿으로 채움)
+     * @param max_threads 사용할 최대 스레드 수 (0이면 하드웨어 코어 수)
+     * @return 요청 순서와 동일한 항목별 결과
+     */
+    std::vector<ImportStatus> importUsers(std::vector<ImportItem>& items, unsigned int max_threads = 0);
+
+    /**
+     * @brief 모든 사용자를 (user_id, 시크릿)으로 순회 (내보내기용)
+     *
+     * 순회하는 동안 mutation_mutex를 잡으므로 이 프로세스의 등록/삭제와 섞이지 않은
+     * 한 시점의 상태를 보며, 그동안 등록/삭제는 대기합니다. 복사본을 만들지 않으므로
+     * 메모리 사용량은 사용자 수와 무관합니다.
+     * (Mapped 모드에서 다른 프로세스가 쓰기 중이면 레코드 단위로만 일관됩니다.)
+     *
+     * @param fn 사용자마다 호출 (std::string_view user_id, std::string_view secret_base32, 호출 중에만 유효)
+     * @return 내보낸 사용자 수
+     */
+    template <typename Fn>
+    size_t exportUsers(Fn&& fn);
+
+    /**
+     * @brief 복제/재배치로 받은 변경을 순서대로 반영 (팔로워, 클러스터 노드)
+     *
+     * Register는 받은 시크릿으로 등록하며, 같은 user_id가 다른 시크릿으로 있으면 바꾸고
+     * 같은 시크릿이면 건너뜁니다. Delete는 없으면 건너뜁니다. 그래서 이미 반영한 변경을
+     * 다시 받아도 최종 상태가 같습니다 (재연결 후 겹쳐 받는 구간, 스냅샷 직후 구간).
+     * 묶음 전체를 mutation_mutex 한 번으로 넣고 WAL(Mapped는 msync) 반영을 한 번만 기다립니다.
+     * 실패하면 일부만 반영된 채로 false를 돌려주며, 호출자가 같은 변경부터 다시 보내면 됩니다.
+     * 실제로 바뀐 사용자만 MutationListener로 통지합니다 (샤드 노드가 복제 리더이기도 하면 재배치가 팔로워에게도 전해짐).
+     *
+     * @param records 반영할 변경 (lsn은 쓰지 않음)
+     * @return 모두 디스크에 반영했으면 true
+     */
+    bool applyReplicated(const std::vector<WALRecord>& records);
+
+    /**
+     * @brief 다른 노드에서 통과한 OTP를 재사용 방지 상태에 기록 (AcceptListener는 부르지 않음)
+     * @return 기록했으면 true, 없는 사용자이거나 step이 지금 ± ALLOWED_DRIFT_STEPS 밖이거나
+     *         이미 같거나 이후 step이 기록돼 있으면 false
+     */
+    bool acceptReplicated(std::string_view user_id, uint64_t step);
+
+    /**
+     * @brief 복제 통지 설정 (서버가 요청을 받기 전에 호출, 빈 함수면 끔)
+     */
+    void setMutationListener(MutationListener listener) { mutation_listener = std::move(listener); }
+    void setAcceptListener(AcceptListener listener) { accept_listener = std::move(listener); }
+
     /**
      * @brief 사용자 찾기
      * @param user_id 찾을 사용자 ID
@@ -81,12 +296,31 @@ public:
 
     /**
      * @brief TOTP 검증
+     *
+     * 코드가 일치한 time step이 그 사용자가 마지막으로 통과한 step보다 커야 성공하므로,
+     * 한 번 통과한 코드(와 그 이전 step의 코드)는 윈도우 안에 있어도 다시 쓸 수 없습니다.
+     *
      * @param user_id 사용자 ID
      * @param otp_code 입력받은 OTP 코드
      * @param window 허용할 시간 윈도우 (기본값: ALLOWED_DRIFT_STEPS)
      * @return 성공 시 true, 실패 시 false
      */
-    bool verifyTOTP(const std::string& user_id, const std::string& otp_code, int window = ALLOWED_DRIFT_STEPS);
+    bool verifyTOTP(std::string_view user_id, std::string_view otp_code, int window = ALLOWED_DRIFT_STEPS);
+
+    /**
+     * @brief 여러 사용자의 TOTP를 한 번에 검증
+     *
+     * 모든 사용자를 한 번의 인덱스 패스로 조회한 뒤, 항목을 청크로 나눠
+     * 여러 스레드에서 TOTP 커널 배치로 검증합니다.
+     *
+     * @param items 검증할 (user_id, otp_code) 목록
+     * @param window 허용할 시간 윈도우
+     * @param max_threads 사용할 최대 스레드 수 (0이면 하드웨어 코어 수)
+     * @return 요청 순서와 동일한 항목별 결과
+     */
+    std::vector<AuthItemResult> verifyTOTPBatch(const std::vector<AuthItem>& items,
+                                                int window = ALLOWED_DRIFT_STEPS,
+                                                unsigned int max_threads = 0);
 
     /**
      * @brief OTP URI 생성 (QR 코드용)
@@ -96,9 +330,9 @@ public:
     std::string generateOTPURI(const User& user);
 
     /**
-     * @brief QR 코드 URL 생성 (웹 서비스용)
+     * @brief QR 코드 이미지 경로 생성 (서버의 GET /api/qr/{user_id}, 외부 서비스 사용 안 함)
      * @param user 사용자 정보
-     * @return QR 코드 이미지 URL
+     * @return QR 코드 이미지 경로 (user_id는 URL 인코딩)
      */
     std::string generateQRCodeURL(const User& user);
 
@@ -114,6 +348,83 @@ public:
      * @return 사용자 ID 목록
      */
     std::vector<std::string> listUsers();
+
+    /**
+     * @brief 사용자 ID를 커서 순서로 한 페이지씩 순회 (잠금 없음, 페이지 크기만큼의 메모리만 사용)
+     *
+     * 커서는 저장소별 위치(Memory: user_id 해시, Mapped: 레코드 슬롯)를 나타내는 불투명한 값입니다.
+     * 순회 내내 존재한 사용자는 페이지를 이어 가는 동안 정확히 한 번씩 나오며,
+     * 도중에 등록/삭제된 사용자는 나올 수도 안 나올 수도 있습니다.
+     * 한 번에 검사하는 슬롯 수가 USER_SCAN_MAX_SLOTS로 제한되므로 접두사 필터를 쓰면
+     * 페이지가 limit보다 적은데도 남은 사용자가 있을 수 있습니다.
+     *
+     * @param cursor 시작 커서 (처음이면 0, 이후에는 이전 호출의 next_cursor)
+     * @param limit 최대 사용자 수
+     * @param prefix user_id 접두사 필터 (빈 문자열이면 전체)
+     * @param fn 사용자마다 호출 (std::string_view user_id, 호출 중에만 유효)
+     * @param next_cursor 다음 페이지 커서를 받을 변수
+     * @return 남은 사용자가 있으면 true
+     */
+    template <typename Fn>
+    bool scanUsers(uint64_t cursor, size_t limit, std::string_view prefix, Fn&& fn, uint64_t& next_cursor) const;
+
+    /**
+     * @brief 재사용 방지 상태를 지금 <user_file>.replay에 기록
+     *
+     * 체크포인트 스레드가 REPLAY_FLUSH_INTERVAL_SECONDS마다, 그리고 소멸자가 호출합니다.
+     * 마지막 기록 이후 통과한 인증이 없으면 아무것도 하지 않습니다.
+     * @return 성공(또는 기록할 것이 없음) 시 true
+     */
+    bool flushReplayState();
+
+    /**
+     * @brief 현재 상태를 users.dat 스냅샷으로 기록하고 WAL 비우기
+     *        (Mapped 모드에서는 매핑 파일을 디스크에 동기화)
+     * @return 성공 시 true
+     */
+    bool checkpoint();
+
+    /**
+     * @brief 등록된 사용자 수 반환
+     * @return 사용자 수
+     */
+    size_t userCount() const {
+        return mapped_store ? mapped_store->size() : user_table.size();
+    }
+
+    /**
+     * @brief 현재 저장소 방식 반환
+     */
+    StorageMode storageMode() const { return storage_mode; }
 };
 
+template <typename Fn>
+bool MFACore::scanUsers(uint64_t cursor, size_t limit, std::string_view prefix, Fn&& fn, uint64_t& next_cursor) const {
+    if (mapped_store) {
+        return mapped_store->scan(cursor, limit, USER_SCAN_MAX_SLOTS, prefix, fn, next_cursor);
+    }
+    return user_table.scan(cursor, limit, USER_SCAN_MAX_SLOTS, prefix, [&](const UserRecord& record) {
+        fn(std::string_view(record.user.user_id));
+    }, next_cursor);
+}
+
+template <typename Fn>
+size_t MFACore::exportUsers(Fn&& fn) {
+    std::lock_guard<std::mutex> lock(mutation_mutex);
+    size_t count = 0;
+    if (mapped_store) {
+        mapped_store->forEach([&](const MappedUserRecord& record) {
+            fn(std::string_view(record.user_id, strnlen(record.user_id, MAPPED_USER_ID_LENGTH)),
+               std::string_view(record.secret_base32, strnlen(record.secret_base32, MAPPED_SECRET_LENGTH)));
+            count++;
+        });
+        return count;
+    }
+    user_table.forEach([&](const UserRecord& record) {
+        fn(std::string_view(record.user.user_id), std::string_view(record.user.secret_base32));
+        count++;
+    });
+    return count;
+}
+
 #endif // MFA_CORE_H
@@ -0,0 +1,290 @@
+#include "qr_code.h"
+#include <charconv>
+#include <cstring>
+#include <functional>
+#include <vector>
+#include <openssl/evp.h>
+#include <qrencode.h>
+#include <zlib.h>
+
+namespace {
+
+    /**
+     * @brief QRcode 소유 래퍼 (QRcode_free 자동 호출)
+     */
+    struct QRMatrix {
+        QRcode* code = nullptr;
+
+        explicit QRMatrix(std::string_view text) {
+            // libqrencode는 널 종료 문자열을 받으므로 스택 버퍼에 복사 (OTP URI는 수백 바이트 이하)
+            char buffer[1024];
+            if (text.size() >= sizeof(buffer) || memchr(text.data(), '\0', text.size())) {
+                return;
+            }
+            memcpy(buffer, text.data(), text.size());
+            buffer[text.size()] = '\0';
+            code = QRcode_encodeString(buffer, 0, QR_ECLEVEL_M, QR_MODE_8, 1);
+        }
+
+        ~QRMatrix() {
+            if (code) QRcode_free(code);
+        }
+
+        QRMatrix(const QRMatrix&) = delete;
+        QRMatrix& operator=(const QRMatrix&) = delete;
+
+        int width() const { return code->width; }
+        bool dark(int x, int y) const { return code->data[y * code->width + x] & 1; }
+    };
+
+    void appendBE32(std::string& out, uint32_t value) {
+        char bytes[4] = {static_cast<char>(value >> 24), static_cast<char>(value >> 16),
+                         static_cast<char>(value >> 8), static_cast<char>(value)};
+        out.append(bytes, 4);
+    }
+
+    void appendChunk(std::string& out, const char* type, const unsigned char* data, size_t size) {
+        appendBE32(out, static_cast<uint32_t>(size));
+        size_t type_pos = out.size();
+        out.append(type, 4);
+        out.append(reinterpret_cast<const char*>(data), size);
+        // CRC는 타입 + 데이터에 대해 계산
+        uLong crc = crc32(0L, reinterpret_cast<const Bytef*>(out.data() + type_pos), static_cast<uInt>(size + 4));
+        appendBE32(out, static_cast<uint32_t>(crc));
+    }
+
+    bool renderPNG(const QRMatrix& matrix, int scale, std::string& out) {
+        const int modules = matrix.width() + 2 * QRCode::QUIET_ZONE;
+        const uint32_t pixels = static_cast<uint32_t>(modules * scale);
+        const size_t row_bytes = 1 + (pixels + 7) / 8;     // 필터 바이트 + 1비트 픽셀
+
+        // 모듈 한 줄이 scale개의 같은 픽셀 행이 되므로 행을 한 번 만들고 복사
+        std::vector<unsigned char> raw(row_bytes * pixels, 0);
+        std::vector<unsigned char> row(row_bytes);
+        for (int my = 0; my < modules; my++) {
+            std::fill(row.begin(), row.end(), 0xFF);
+            row[0] = 0;     // 필터 없음
+            int y = my - QRCode::QUIET_ZONE;
+            if (y >= 0 && y < matrix.width()) {
+                for (int x = 0; x < matrix.width(); x++) {
+                    if (!matrix.dark(x, y)) continue;
+                    uint32_t first = static_cast<uint32_t>((x + QRCode::QUIET_ZONE) * scale);
+                    for (uint32_t px = first; px < first + static_cast<uint32_t>(scale); px++) {
+                        row[1 + px / 8] &= static_cast<unsigned char>(~(0x80u >> (px % 8)));   // 0 = 검정
+                    }
+                }
+            }
+            for (int s = 0; s < scale; s++) {
+                memcpy(&raw[(static_cast<size_t>(my) * scale + s) * row_bytes], row.data(), row_bytes);
+            }
+        }
+
+        uLongf compressed_size = compressBound(static_cast<uLong>(raw.size()));
+        std::vector<unsigned char> compressed(compressed_size);
+        if (compress2(compressed.data(), &compressed_size, raw.data(), static_cast<uLong>(raw.size()),
+                      Z_DEFAULT_COMPRESSION) != Z_OK) {
+            return false;
+        }
+
+        static const unsigned char SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        unsigned char header[13] = {
+            static_cast<unsigned char>(pixels >> 24), static_cast<unsigned char>(pixels >> 16),
+            static_cast<unsigned char>(pixels >> 8), static_cast<unsigned char>(pixels),
+            static_cast<unsigned char>(pixels >> 24), static_cast<unsigned char>(pixels >> 16),
+            static_cast<unsigned char>(pixels >> 8), static_cast<unsigned char>(pixels),
+            1,      // 비트 깊이
+            0,      // 그레이스케일
+            0, 0, 0
+        };
+
+        out.clear();
+        out.reserve(8 + 25 + 12 + compressed_size + 12);
+        out.append(reinterpret_cast<const char*>(SIGNATURE), sizeof(SIGNATURE));
+        appendChunk(out, "IHDR", header, sizeof(header));
+        appendChunk(out, "IDAT", compressed.data(), compressed_size);
+        appendChunk(out, "IEND", nullptr, 0);
+        return true;
+    }
+
+    void appendNumber(std::string& out, int value) {
+        char digits[12];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        out.append(digits, static_cast<size_t>(result.ptr - digits));
+    }
+
+    bool renderSVG(const QRMatrix& matrix, int scale, std::string& out) {
+        const int modules = matrix.width() + 2 * QRCode::QUIET_ZONE;
+        out.clear();
+        out.reserve(static_cast<size_t>(matrix.width()) * matrix.width() * 4 + 256);
+
+        out += "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"";
+        appendNumber(out, modules * scale);
+        out += "\" height=\"";
+        appendNumber(out, modules * scale);
+        out += "\" viewBox=\"0 0 ";
+        appendNumber(out, modules);
+        out += ' ';
+        appendNumber(out, modules);
+        out += "\" shape-rendering=\"crispEdges\"><rect width=\"100%\" height=\"100%\" fill=\"#fff\"/><path fill=\"#000\" d=\"";
+
+        // 가로로 이어진 어두운 모듈은 사각형 하나로 합침
+        for (int y = 0; y < matrix.width(); y++) {
+            for (int x = 0; x < matrix.width();) {
+                if (!matrix.dark(x, y)) {
+                    x++;
+                    continue;
+                }
+                int run = 1;
+                while (x + run < matrix.width() && matrix.dark(x + run, y)) run++;
+                out += 'M';
+                appendNumber(out, x + QRCode::QUIET_ZONE);
+                out += ' ';
+                appendNumber(out, y + QRCode::QUIET_ZONE);
+                out += 'h';
+                appendNumber(out, run);
+                out += "v1h-";
+                appendNumber(out, run);
+                out += 'z';
+                x += run;
+            }
+        }
+        out += "\"/></svg>";
+        return true;
+    }
+}
+
+namespace QRCode {
+
+    bool parseFormat(std::string_view text, Format& format) {
+        if (text == "png") {
+            format = Format::PNG;
+            return true;
+        }
+        if (text == "svg") {
+            format = Format::SVG;
+            return true;
+        }
+        return false;
+    }
+
+    const char* contentType(Format format) {
+        return format == Format::PNG ? "image/png" : "image/svg+xml";
+    }
+
+    bool render(std::string_view text, Format format, int scale, std::string& out) {
+        if (scale < 1 || scale > MAX_SCALE) {
+            return false;
+        }
+        QRMatrix matrix(text);
+        if (!matrix.code) {
+            return false;
+        }
+        return format == Format::PNG ? renderPNG(matrix, scale, out) : renderSVG(matrix, scale, out);
+    }
+
+    std::string dataURI(Format format, std::string_view image) {
+        std::string uri = "data:";
+        uri += contentType(format);
+        uri += ";base64,";
+        size_t prefix = uri.size();
+        uri.resize(prefix + 4 * ((image.size() + 2) / 3) + 1);     // EVP_EncodeBlock은 널 문자까지 씀
+        int written = EVP_EncodeBlock(reinterpret_cast<unsigned char*>(&uri[prefix]),
+                                      reinterpret_cast<const unsigned char*>(image.data()),
+                                      static_cast<int>(image.size()));
+        uri.resize(prefix + static_cast<size_t>(written));
+        return uri;
+    }
+
+    // ==================== RenderCache ====================
+
+    RenderCache::RenderCache(size_t max_bytes)
+        : max_bytes(max_bytes), shard_budget(max_bytes / SHARD_COUNT), shards(new Shard[SHARD_COUNT]) {}
+
+    size_t RenderCache::entryBytes(const Entry& entry) {
+        // 이미지와 키에 노드/인덱스 오버헤드를 대략 더함
+        return entry.image->size() + entry.key.size() + 128;
+    }
+
+    std::shared_ptr<const std::string> RenderCache::get(std::string_view text, Format format, int scale) {
+        std::string key;
+        key.reserve(text.size() + 4);
+        key += format == Format::PNG ? 'p' : 's';
+        key += static_cast<char>('a' + scale);
+        key += text;
+
+        Shard& shard = shards[std::hash<std::string>()(key) % SHARD_COUNT];
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.index.find(key);
+            if (it != shard.index.end()) {
+                shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+                shard.hits++;
+                return it->second->image;
+            }
+            shard.misses++;
+        }
+
+        // 렌더링은 잠금 밖에서 (같은 키를 동시에 요청하면 둘 다 렌더링하고 하나만 남음)
+        auto image = std::make_shared<std::string>();
+        if (!render(text, format, scale, *image)) {
+            return nullptr;
+        }
+
+        Entry entry{std::move(key), image};
+        size_t size = entryBytes(entry);
+        if (size > shard_budget) {
+            return image;   // 한도보다 큰 이미지는 캐시하지 않음
+        }
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.index.find(entry.key) != shard.index.end()) {
+            return image;
+        }
+        shard.lru.push_front(std::move(entry));
+        shard.index.emplace(shard.lru.front().key, shard.lru.begin());
+        shard.bytes += size;
+        while (shard.bytes > shard_budget) {
+            Entry& victim = shard.lru.back();
+            shard.bytes -= entryBytes(victim);
+            shard.index.erase(victim.key);
+            shard.lru.pop_back();
+        }
+        return image;
+    }
+
+    size_t RenderCache::bytes() const {
+        size_t total = 0;
+        for (size_t i = 0; i < SHARD_COUNT; i++) {
+            std::lock_guard<std::mutex> lock(shards[i].mutex);
+            total += shards[i].bytes;
+        }
+        return total;
+    }
+
+    size_t RenderCache::entries() const {
+        size_t total = 0;
+        for (size_t i = 0; i < SHARD_COUNT; i++) {
+            std::lock_guard<std::mutex> lock(shards[i].mutex);
+            total += shards[i].lru.size();
+        }
+        return total;
+    }
+
+    uint64_t RenderCache::hits() const {
+        uint64_t total = 0;
+        for (size_t i = 0; i < SHARD_COUNT; i++) {
+            std::lock_guard<std::mutex> lock(shards[i].mutex);
+            total += shards[i].hits;
+        }
+        return total;
+    }
+
+    uint64_t RenderCache::misses() const {
+        uint64_t total = 0;
+        for (size_t i = 0; i < SHARD_COUNT; i++) {
+            std::lock_guard<std::mutex> lock(shards[i].mutex);
+            total += shards[i].misses;
+        }
+        return total;
+    }
+}
@@ -0,0 +1,106 @@
+#ifndef QR_CODE_H
+#define QR_CODE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @brief OTP URI를 QR 코드 이미지(PNG/SVG)로 직접 렌더링 (libqrencode)
+ *
+ * 외부 QR 서비스에 시크릿이 담긴 URI를 보내지 않도록 서버 안에서 이미지를 만듭니다.
+ */
+namespace QRCode {
+
+    enum class Format {
+        PNG,        // 1비트 그레이스케일, zlib 압축
+        SVG         // 어두운 모듈을 path 하나로 표현
+    };
+
+    constexpr int DEFAULT_SCALE = 4;        // 모듈 하나의 픽셀 수 (PNG) / 사용자 단위 크기 (SVG)
+    constexpr int MAX_SCALE = 16;
+    constexpr int QUIET_ZONE = 4;           // 표준 여백 (모듈 수)
+
+    /**
+     * @brief "png" / "svg" 파싱
+     */
+    bool parseFormat(std::string_view text, Format& format);
+
+    /**
+     * @brief 응답 Content-Type ("image/png", "image/svg+xml")
+     */
+    const char* contentType(Format format);
+
+    /**
+     * @brief 문자열을 QR 코드 이미지로 렌더링 (오류 정정 레벨 M)
+     * @param text 담을 문자열 (OTP URI)
+     * @param format 이미지 형식
+     * @param scale 모듈 크기 (1..MAX_SCALE)
+     * @param out 결과 이미지 (덮어씀)
+     * @return 인코딩 실패(문자열이 너무 김 등) 시 false
+     */
+    bool render(std::string_view text, Format format, int scale, std::string& out);
+
+    /**
+     * @brief 이미지를 data URI로 변환 ("data:image/png;base64,...")
+     */
+    std::string dataURI(Format format, std::string_view image);
+
+    /**
+     * @brief 렌더링 결과의 크기 제한 LRU 캐시
+     *
+     * 키는 (형식, 크기, 담긴 문자열)이므로 같은 사용자가 새 시크릿으로 다시 등록하면
+     * 다른 항목이 되고, 이전 항목은 LRU로 밀려납니다.
+     * 샤드마다 뮤텍스 하나와 전체 용량의 1/SHARD_COUNT 바이트 한도를 가지며,
+     * 이미지는 shared_ptr로 넘기므로 응답에 복사하는 동안 잠금을 잡지 않습니다.
+     */
+    class RenderCache {
+    public:
+        static constexpr size_t SHARD_COUNT = 16;
+
+        explicit RenderCache(size_t max_bytes);
+
+        RenderCache(const RenderCache&) = delete;
+        RenderCache& operator=(const RenderCache&) = delete;
+
+        /**
+         * @brief 캐시에서 찾고, 없으면 렌더링해 넣은 뒤 반환
+         * @return 렌더링 실패 시 nullptr
+         */
+        std::shared_ptr<const std::string> get(std::string_view text, Format format, int scale);
+
+        size_t bytes() const;
+        size_t entries() const;
+        uint64_t hits() const;
+        uint64_t misses() const;
+        size_t capacity() const { return max_bytes; }
+
+    private:
+        struct Entry {
+            std::string key;
+            std::shared_ptr<const std::string> image;
+        };
+
+        struct Shard {
+            mutable std::mutex mutex;
+            std::list<Entry> lru;           // 앞쪽이 최근 사용
+            std::unordered_map<std::string_view, std::list<Entry>::iterator> index;     // 키는 lru 항목을 가리킴
+            size_t bytes = 0;
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+        };
+
+        size_t max_bytes;
+        size_t shard_budget;
+        std::unique_ptr<Shard[]> shards;
+
+        static size_t entryBytes(const Entry& entry);
+    };
+}
+
+#endif // QR_CODE_H
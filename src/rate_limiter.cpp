@@ -0,0 +1,271 @@
+#include "rate_limiter.h"
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <time.h>
+
+namespace {
+
+    constexpr unsigned TOKEN_BITS = 24;
+    constexpr uint64_t TOKEN_MASK = (uint64_t(1) << TOKEN_BITS) - 1;
+    constexpr uint64_t TOKEN_UNIT = 256;            // 토큰 1개 = 256 (부분 충전을 잃지 않도록)
+    constexpr uint32_t MAX_PERIOD_SECONDS = 86400;
+
+    uint64_t pack(uint64_t last_ms, uint64_t tokens) {
+        return (last_ms << TOKEN_BITS) | tokens;
+    }
+
+    uint64_t mix(uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    size_t roundUpPow2(size_t value) {
+        size_t result = 1;
+        while (result < value) result <<= 1;
+        return result;
+    }
+
+    uint32_t toSeconds(uint64_t ms) {
+        return static_cast<uint32_t>(std::max<uint64_t>((ms + 999) / 1000, 1));
+    }
+
+    bool parseNumber(std::string_view text, uint32_t max, uint32_t& value) {
+        if (text.empty() || text.size() > 10) return false;
+        uint64_t result = 0;
+        for (char c : text) {
+            if (c < '0' || c > '9') return false;
+            result = result * 10 + static_cast<uint64_t>(c - '0');
+        }
+        if (result > max) return false;
+        value = static_cast<uint32_t>(result);
+        return true;
+    }
+}
+
+bool RateLimit::parse(std::string_view text, RateLimit& limit) {
+    if (text == "0" || text == "off") {
+        limit = RateLimit();
+        return true;
+    }
+    size_t slash = text.find('/');
+    if (slash == std::string_view::npos) return false;
+
+    RateLimit parsed;
+    if (!parseNumber(text.substr(0, slash), RATE_LIMIT_MAX_BURST, parsed.burst) ||
+        !parseNumber(text.substr(slash + 1), MAX_PERIOD_SECONDS, parsed.period_seconds) ||
+        parsed.burst == 0 || parsed.period_seconds == 0) {
+        return false;
+    }
+    limit = parsed;
+    return true;
+}
+
+// ==================== TokenBucketTable ====================
+
+TokenBucketTable::TokenBucketTable(const RateLimit& limit, size_t capacity) : config(limit) {
+    full_tokens = uint64_t(config.burst) * TOKEN_UNIT;
+    full_refill_ms = uint64_t(config.period_seconds) * 1000;
+    refill_q32 = ((full_tokens << 32) + full_refill_ms - 1) / full_refill_ms;   // 올림: 주기 안에 확실히 가득 차도록
+
+    sets_per_shard = roundUpPow2(std::max<size_t>(capacity / (SHARD_COUNT * SET_SIZE), 1));
+    sets.reset(new Set[SHARD_COUNT * sets_per_shard]);
+    shards.reset(new Shard[SHARD_COUNT]);
+
+    uint64_t tick = RateLimiter::nowMs() / WHEEL_TICK_MS;
+    for (size_t i = 0; i < SHARD_COUNT; i++) {
+        shards[i].wheel_tick.store(tick, std::memory_order_relaxed);
+    }
+}
+
+uint64_t TokenBucketTable::refill(uint64_t state, uint64_t now_ms) const {
+    uint64_t last = state >> TOKEN_BITS;
+    uint64_t tokens = state & TOKEN_MASK;
+
+    // 한 번도 쓰지 않았거나 충분히 오래 쉬었으면 가득 참
+    if (last == 0 || (now_ms > last && now_ms - last >= full_refill_ms)) {
+        return pack(now_ms, full_tokens);
+    }
+    if (now_ms <= last) {
+        return state;
+    }
+
+    // 실제로 토큰으로 바뀐 시간만큼만 시각을 옮겨 남은 부분 충전을 보존
+    uint64_t added = ((now_ms - last) * refill_q32) >> 32;
+    if (tokens + added >= full_tokens) {
+        return pack(now_ms, full_tokens);
+    }
+    uint64_t used_ms = (added << 32) / refill_q32;
+    return pack(last + used_ms, tokens + added);
+}
+
+TokenBucketTable::Entry* TokenBucketTable::acquire(Entry* set, uint64_t key_hash, uint64_t now_ms) {
+    for (size_t i = 0; i < SET_SIZE; i++) {
+        if (set[i].key.load(std::memory_order_acquire) == key_hash) {
+            return &set[i];
+        }
+    }
+
+    // 빈 칸 차지 (이전 키가 만료로 비운 칸의 상태는 가득 찬 것과 같으므로 그대로 둠)
+    for (size_t i = 0; i < SET_SIZE; i++) {
+        uint64_t expected = 0;
+        if (set[i].key.load(std::memory_order_relaxed) == 0 &&
+            set[i].key.compare_exchange_strong(expected, key_hash, std::memory_order_acq_rel)) {
+            return &set[i];
+        }
+        if (expected == key_hash) {
+            return &set[i];
+        }
+    }
+
+    // 묶음이 가득 참: 만료된 칸, 없으면 토큰이 가장 많은(제한이 가장 약한) 칸을 재사용
+    size_t victim = 0;
+    uint64_t most_tokens = 0;
+    for (size_t i = 0; i < SET_SIZE; i++) {
+        uint64_t state = set[i].state.load(std::memory_order_relaxed);
+        uint64_t tokens = refill(state, now_ms) & TOKEN_MASK;
+        if (tokens >= full_tokens) {
+            victim = i;
+            break;
+        }
+        if (tokens > most_tokens) {
+            most_tokens = tokens;
+            victim = i;
+        }
+    }
+    uint64_t old_key = set[victim].key.load(std::memory_order_relaxed);
+    if (set[victim].key.compare_exchange_strong(old_key, key_hash, std::memory_order_acq_rel)) {
+        set[victim].state.store(0, std::memory_order_release);
+    }
+    return &set[victim];
+}
+
+void TokenBucketTable::advanceWheel(size_t shard, uint64_t now_ms) {
+    uint64_t tick = now_ms / WHEEL_TICK_MS;
+    uint64_t seen = shards[shard].wheel_tick.load(std::memory_order_relaxed);
+    if (tick <= seen || !shards[shard].wheel_tick.compare_exchange_strong(seen, tick, std::memory_order_relaxed)) {
+        return;
+    }
+
+    // 지나간 틱마다 바퀴 구간 하나씩 훑어 만료된 칸을 비움 (CAS에 이긴 스레드만 수행)
+    size_t segment = (sets_per_shard + WHEEL_SLOTS - 1) / WHEEL_SLOTS;
+    uint64_t steps = std::min<uint64_t>(tick - seen, WHEEL_SLOTS);
+    Set* base = &sets[shard * sets_per_shard];
+    for (uint64_t t = seen + 1; t <= seen + steps; t++) {
+        size_t first = static_cast<size_t>(t % WHEEL_SLOTS) * segment;
+        size_t last = std::min(first + segment, sets_per_shard);
+        for (size_t s = first; s < last; s++) {
+            for (Entry& entry : base[s].entries) {
+                uint64_t key = entry.key.load(std::memory_order_relaxed);
+                if (key == 0) continue;
+                uint64_t last_ms = entry.state.load(std::memory_order_relaxed) >> TOKEN_BITS;
+                if (last_ms != 0 && now_ms > last_ms && now_ms - last_ms >= full_refill_ms) {
+                    entry.key.compare_exchange_strong(key, 0, std::memory_order_acq_rel);
+                }
+            }
+        }
+    }
+}
+
+bool TokenBucketTable::consume(uint64_t key_hash, uint32_t cost, uint64_t now_ms, uint64_t& retry_after_ms) {
+    uint64_t need = uint64_t(cost) * TOKEN_UNIT;
+    if (need > full_tokens) {
+        retry_after_ms = full_refill_ms;
+        return false;
+    }
+
+    size_t shard = static_cast<size_t>(key_hash >> 58);
+    advanceWheel(shard, now_ms);
+
+    Set& set = sets[shard * sets_per_shard + (key_hash & (sets_per_shard - 1))];
+    Entry* entry = acquire(set.entries, key_hash, now_ms);
+
+    uint64_t state = entry->state.load(std::memory_order_acquire);
+    for (;;) {
+        uint64_t current = refill(state, now_ms);
+        uint64_t tokens = current & TOKEN_MASK;
+        if (tokens < need) {
+            retry_after_ms = (((need - tokens) << 32) + refill_q32 - 1) / refill_q32;
+            return false;
+        }
+        if (entry->state.compare_exchange_weak(state, current - need, std::memory_order_acq_rel)) {
+            return true;
+        }
+    }
+}
+
+size_t TokenBucketTable::occupancy() const {
+    size_t count = 0;
+    for (size_t s = 0; s < SHARD_COUNT * sets_per_shard; s++) {
+        for (const Entry& entry : sets[s].entries) {
+            if (entry.key.load(std::memory_order_relaxed) != 0) count++;
+        }
+    }
+    return count;
+}
+
+// ==================== RateLimiter ====================
+
+RateLimiter::RateLimiter(const RateLimit& user_limit, const RateLimit& ip_limit, size_t capacity) {
+    std::random_device device;
+    seed = (uint64_t(device()) << 32) ^ device();
+    if (user_limit.enabled()) {
+        users = std::make_unique<TokenBucketTable>(user_limit, capacity);
+    }
+    if (ip_limit.enabled()) {
+        clients = std::make_unique<TokenBucketTable>(ip_limit, capacity);
+    }
+}
+
+uint64_t RateLimiter::nowMs() {
+    // 밀리초 단위면 충분하므로 vDSO의 저해상도 시계 사용 (호출당 수 ns)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000 + static_cast<uint64_t>(ts.tv_nsec) / 1000000;
+}
+
+uint64_t RateLimiter::hashKey(std::string_view key) const {
+    // 8바이트 단위로 섞고 마지막에 한 번 더 섞음 (키는 보통 50바이트 이하)
+    uint64_t h = seed ^ (key.size() * 0x9E3779B97F4A7C15ULL);
+    size_t i = 0;
+    for (; i + 8 <= key.size(); i += 8) {
+        uint64_t chunk;
+        memcpy(&chunk, key.data() + i, 8);
+        h = (h ^ chunk) * 0x9E3779B97F4A7C15ULL;
+        h ^= h >> 29;
+    }
+    if (i < key.size()) {
+        uint64_t chunk = 0;
+        memcpy(&chunk, key.data() + i, key.size() - i);
+        h = (h ^ chunk) * 0x9E3779B97F4A7C15ULL;
+    }
+    h = mix(h);
+    return h ? h : 1;
+}
+
+bool RateLimiter::consume(TokenBucketTable* table, std::string_view key, uint32_t cost, uint64_t now_ms,
+                          uint32_t& retry_after_seconds) {
+    if (!table || key.empty()) return true;
+    uint64_t retry_ms = 0;
+    if (table->consume(hashKey(key), cost, now_ms, retry_ms)) return true;
+    retry_after_seconds = toSeconds(retry_ms);
+    return false;
+}
+
+bool RateLimiter::allowClient(std::string_view client_ip, uint32_t cost, uint32_t& retry_after_seconds) {
+    return consume(clients.get(), client_ip, cost, nowMs(), retry_after_seconds);
+}
+
+bool RateLimiter::allowUser(std::string_view user_id, uint32_t& retry_after_seconds) {
+    return consume(users.get(), user_id, 1, nowMs(), retry_after_seconds);
+}
+
+bool RateLimiter::allow(std::string_view user_id, std::string_view client_ip, uint32_t& retry_after_seconds) {
+    uint64_t now_ms = nowMs();
+    return consume(clients.get(), client_ip, 1, now_ms, retry_after_seconds) &&
+           consume(users.get(), user_id, 1, now_ms, retry_after_seconds);
+}
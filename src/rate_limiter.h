@@ -0,0 +1,150 @@
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+/**
+ * @brief 토큰 버킷 한도: period_seconds마다 burst개의 시도 (burst까지 몰아서 허용)
+ */
+struct RateLimit {
+    uint32_t burst = 0;             // 0이면 제한 없음
+    uint32_t period_seconds = 0;
+
+    bool enabled() const { return burst > 0 && period_seconds > 0; }
+
+    /**
+     * @brief "N/S" 형식 파싱 (예: "10/60" = 60초에 10번). "0" 또는 "off"는 제한 없음
+     */
+    static bool parse(std::string_view text, RateLimit& limit);
+};
+
+constexpr uint32_t RATE_LIMIT_MAX_BURST = 65535;
+
+/**
+ * @brief 키(사용자 ID 또는 클라이언트 IP)별 토큰 버킷의 잠금 없는 고정 크기 테이블
+ *
+ * - 키 해시 상위 비트로 샤드를 고르고, 샤드 안에서는 4칸 묶음(set, 캐시 라인 하나) 하나에만 들어감 (탐사 체인 없음)
+ * - 칸 하나는 키 해시와 (마지막 갱신 시각 | 토큰 수)를 담은 64비트 상태 두 개이며, 상태는 CAS로 갱신
+ * - 샤드마다 시간 바퀴(time wheel) 위치가 있어, 틱이 넘어갈 때 처음 본 스레드가 해당 구간을 훑어
+ *   가득 찬(= 새 키와 구별되지 않는) 버킷을 비움. 묶음이 가득 차면 토큰이 가장 많은 칸을 재사용
+ *
+ * 키 해시는 프로세스마다 다른 시드를 쓰므로 외부에서 같은 묶음으로 몰아넣기 어렵습니다.
+ * 드물게 해시가 같은 두 키는 버킷을 공유합니다 (제한이 조금 더 엄격해질 뿐 우회는 아님).
+ */
+class TokenBucketTable {
+public:
+    static constexpr size_t SHARD_COUNT = 64;
+    static constexpr size_t SET_SIZE = 4;
+    static constexpr size_t WHEEL_SLOTS = 64;            // 시간 바퀴 한 바퀴의 틱 수
+    static constexpr uint64_t WHEEL_TICK_MS = 1000;
+
+    /**
+     * @param limit 키별 한도
+     * @param capacity 전체 버킷 칸 수 (샤드 × 묶음 크기 단위로 올림)
+     */
+    TokenBucketTable(const RateLimit& limit, size_t capacity);
+
+    TokenBucketTable(const TokenBucketTable&) = delete;
+    TokenBucketTable& operator=(const TokenBucketTable&) = delete;
+
+    /**
+     * @brief 키의 버킷에서 토큰 cost개를 차감
+     * @param now_ms 단조 시계 (ms)
+     * @param retry_after_ms 거부 시 토큰이 충분히 찰 때까지의 시간을 받을 변수
+     * @return 허용이면 true
+     */
+    bool consume(uint64_t key_hash, uint32_t cost, uint64_t now_ms, uint64_t& retry_after_ms);
+
+    /**
+     * @brief 현재 버킷을 차지한 키 수 (만료 전 항목 포함, 통계용)
+     */
+    size_t occupancy() const;
+
+    const RateLimit& limit() const { return config; }
+
+private:
+    struct Entry {
+        std::atomic<uint64_t> key{0};       // 0: 빈 칸
+        std::atomic<uint64_t> state{0};     // (갱신 시각 ms << 24) | 토큰 (1/256 단위)
+    };
+
+    struct alignas(64) Set {
+        Entry entries[SET_SIZE];
+    };
+
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> wheel_tick{0};
+    };
+
+    RateLimit config;
+    uint64_t full_tokens;                   // burst * 256
+    uint64_t refill_q32;                    // ms당 충전량 (1/256 토큰 단위, 32비트 고정소수점)
+    uint64_t full_refill_ms;                // 0에서 가득 찰 때까지 걸리는 시간
+    size_t sets_per_shard;
+    std::unique_ptr<Set[]> sets;
+    std::unique_ptr<Shard[]> shards;
+
+    uint64_t refill(uint64_t state, uint64_t now_ms) const;
+    Entry* acquire(Entry* set, uint64_t key_hash, uint64_t now_ms);
+    void advanceWheel(size_t shard, uint64_t now_ms);
+};
+
+/**
+ * @brief 인증 시도 제한기 (사용자별 + 클라이언트 IP별 토큰 버킷)
+ *
+ * 저장소 조회나 HMAC 계산 전에 호출하며, 호출당 비용은 해시 두 번과 CAS 두 번 수준입니다.
+ */
+class RateLimiter {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 1 << 18;   // 테이블당 버킷 칸 수
+
+    RateLimiter(const RateLimit& user_limit, const RateLimit& ip_limit, size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * @brief 인증 시도 허용 여부 (IP 버킷, 사용자 버킷 순으로 차감)
+     * @param user_id 사용자 ID (빈 문자열이면 사용자 한도는 건너뜀)
+     * @param client_ip 클라이언트 주소 (빈 문자열이면 IP 한도는 건너뜀)
+     * @param retry_after_seconds 거부 시 Retry-After 값(초, 1 이상)을 받을 변수
+     * @return 허용이면 true
+     */
+    bool allow(std::string_view user_id, std::string_view client_ip, uint32_t& retry_after_seconds);
+
+    /**
+     * @brief 클라이언트 IP 버킷에서 cost개를 차감 (일괄 인증 요청의 항목 수만큼)
+     */
+    bool allowClient(std::string_view client_ip, uint32_t cost, uint32_t& retry_after_seconds);
+
+    /**
+     * @brief 사용자 버킷만 검사 (일괄 인증 항목별)
+     */
+    bool allowUser(std::string_view user_id, uint32_t& retry_after_seconds);
+
+    bool enabled() const { return users || clients; }
+
+    /**
+     * @brief 현재 시각 (제한기가 쓰는 단조 시계, ms)
+     */
+    static uint64_t nowMs();
+
+    /**
+     * @brief 시드가 적용된 키 해시 (0은 쓰지 않음)
+     */
+    uint64_t hashKey(std::string_view key) const;
+
+    TokenBucketTable* userTable() { return users.get(); }
+    TokenBucketTable* clientTable() { return clients.get(); }
+
+private:
+    uint64_t seed;
+    std::unique_ptr<TokenBucketTable> users;
+    std::unique_ptr<TokenBucketTable> clients;
+
+    bool consume(TokenBucketTable* table, std::string_view key, uint32_t cost, uint64_t now_ms,
+                 uint32_t& retry_after_seconds);
+};
+
+#endif // RATE_LIMITER_H
@@ -0,0 +1,178 @@
+#include "replay_table.h"
+#include "logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+    // 파일 형식: 매직 8바이트 뒤에 (user_id 50바이트 | step 8바이트 리틀 엔디언) 레코드가 이어짐
+    constexpr char REPLAY_MAGIC[8] = {'M', 'F', 'A', 'R', 'P', 'L', '0', '1'};
+    constexpr size_t REPLAY_ID_LENGTH = 50;     // users.dat와 같은 user_id 필드 폭
+    constexpr size_t REPLAY_RECORD_SIZE = REPLAY_ID_LENGTH + 8;
+
+    bool writeAll(int fd, const char* data, size_t size) {
+        size_t written = 0;
+        while (written < size) {
+            ssize_t n = ::write(fd, data + written, size - written);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            written += static_cast<size_t>(n);
+        }
+        return true;
+    }
+}
+
+ReplayTable::ReplayTable() : chunks(new std::atomic<Chunk*>[MAX_CHUNKS]) {
+    for (size_t i = 0; i < MAX_CHUNKS; i++) {
+        chunks[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+ReplayTable::~ReplayTable() {
+    for (size_t i = 0; i < MAX_CHUNKS; i++) {
+        delete chunks[i].load(std::memory_order_relaxed);
+    }
+}
+
+ReplayTable::Chunk* ReplayTable::chunkFor(uint64_t slot) {
+    std::atomic<Chunk*>& entry = chunks[slot >> CHUNK_BITS];
+    Chunk* chunk = entry.load(std::memory_order_acquire);
+    if (chunk) {
+        return chunk;
+    }
+
+    // 처음 쓰이는 청크: 먼저 설치한 스레드의 것을 쓰고 진 쪽은 버림 (청크당 한 번)
+    Chunk* created = new Chunk;
+    for (auto& step : created->steps) step.store(0, std::memory_order_relaxed);
+    if (entry.compare_exchange_strong(chunk, created, std::memory_order_acq_rel)) {
+        return created;
+    }
+    delete created;
+    return chunk;
+}
+
+bool ReplayTable::accept(uint64_t slot, uint64_t step) {
+    if (slot >= MAX_SLOTS) {
+        // 기록할 수 없는 슬롯을 통과시키면 재사용 방지가 조용히 빠지므로 거부
+        if (!overflow_logged.exchange(true, std::memory_order_relaxed)) {
+            MFA_LOG_ERROR("REPLAY", "재사용 방지 테이블 범위를 벗어난 슬롯 " << slot << " (최대 " << MAX_SLOTS
+                          << "): 해당 사용자의 인증을 거부합니다.");
+        }
+        return false;
+    }
+
+    Chunk* chunk = chunks[slot >> CHUNK_BITS].load(std::memory_order_acquire);
+    if (!chunk) {
+        chunk = chunkFor(slot);     // 다른 프로세스가 추가한 슬롯 (읽기 전용 매핑)
+    }
+    std::atomic<uint64_t>& last = chunk->steps[slot & (CHUNK_SIZE - 1)];
+    uint64_t seen = last.load(std::memory_order_acquire);
+    do {
+        if (step <= seen) {
+            return false;
+        }
+    } while (!last.compare_exchange_weak(seen, step, std::memory_order_acq_rel));
+
+    // 이미 표시되어 있으면 쓰지 않음 (저장 주기당 공유 캐시 라인 쓰기 한 번)
+    if (!dirty.load(std::memory_order_relaxed)) {
+        dirty.store(true, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+uint64_t ReplayTable::lastStep(uint64_t slot) const {
+    if (slot >= MAX_SLOTS) {
+        return 0;
+    }
+    const Chunk* chunk = chunks[slot >> CHUNK_BITS].load(std::memory_order_acquire);
+    return chunk ? chunk->steps[slot & (CHUNK_SIZE - 1)].load(std::memory_order_acquire) : 0;
+}
+
+void ReplayTable::reset(uint64_t slot) {
+    if (slot >= MAX_SLOTS) {
+        return;
+    }
+    chunkFor(slot)->steps[slot & (CHUNK_SIZE - 1)].store(0, std::memory_order_release);
+}
+
+void ReplayTable::reserve(uint64_t slot_count) {
+    uint64_t count = std::min(slot_count, MAX_SLOTS);
+    for (uint64_t slot = 0; slot < count; slot += CHUNK_SIZE) {
+        chunkFor(slot);
+    }
+}
+
+bool ReplayTable::takeDirty() {
+    return dirty.exchange(false, std::memory_order_acq_rel);
+}
+
+bool ReplayTable::writeFile(const std::string& path, const std::vector<ReplayEntry>& entries) {
+    std::string buffer(REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+    buffer.reserve(sizeof(REPLAY_MAGIC) + entries.size() * REPLAY_RECORD_SIZE);
+    for (const auto& entry : entries) {
+        char record[REPLAY_RECORD_SIZE] = {0};
+        memcpy(record, entry.user_id.data(), std::min(entry.user_id.size(), REPLAY_ID_LENGTH - 1));
+        for (int i = 0; i < 8; i++) {
+            record[REPLAY_ID_LENGTH + i] = static_cast<char>(entry.step >> (8 * i));
+        }
+        buffer.append(record, sizeof(record));
+    }
+
+    // 임시 파일에 쓴 뒤 rename (중간에 죽어도 이전 파일 유지)
+    std::string tmp_path = path + ".tmp";
+    int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = writeAll(fd, buffer.data(), buffer.size()) && ::fdatasync(fd) == 0;
+    ::close(fd);
+    if (!ok || ::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        ::unlink(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool ReplayTable::readFile(const std::string& path, std::vector<ReplayEntry>& entries) {
+    entries.clear();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return errno == ENOENT;
+    }
+
+    std::string content;
+    char chunk[64 * 1024];
+    for (;;) {
+        ssize_t n = ::read(fd, chunk, sizeof(chunk));
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            ::close(fd);
+            return false;
+        }
+        if (n == 0) break;
+        content.append(chunk, static_cast<size_t>(n));
+    }
+    ::close(fd);
+
+    if (content.size() < sizeof(REPLAY_MAGIC) || memcmp(content.data(), REPLAY_MAGIC, sizeof(REPLAY_MAGIC)) != 0) {
+        return false;
+    }
+
+    size_t count = (content.size() - sizeof(REPLAY_MAGIC)) / REPLAY_RECORD_SIZE;
+    entries.reserve(count);
+    const char* record = content.data() + sizeof(REPLAY_MAGIC);
+    for (size_t i = 0; i < count; i++, record += REPLAY_RECORD_SIZE) {
+        ReplayEntry entry;
+        entry.user_id.assign(record, strnlen(record, REPLAY_ID_LENGTH));
+        for (int b = 0; b < 8; b++) {
+            entry.step |= uint64_t(static_cast<unsigned char>(record[REPLAY_ID_LENGTH + b])) << (8 * b);
+        }
+        if (!entry.user_id.empty()) {
+            entries.push_back(std::move(entry));
+        }
+    }
+    return true;
+}
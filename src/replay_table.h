@@ -0,0 +1,94 @@
+#ifndef REPLAY_TABLE_H
+#define REPLAY_TABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief 재사용 방지 파일 항목 (user_id, 마지막으로 통과한 time step)
+ */
+struct ReplayEntry {
+    std::string user_id;
+    uint64_t step = 0;
+};
+
+/**
+ * @brief 사용자 슬롯별 마지막 통과 time step을 담는 조밀한 배열 (OTP 재사용 방지)
+ *
+ * 슬롯은 저장소가 부여한 작은 정수(Memory: UserTable 슬롯, Mapped: 레코드 슬롯)이며,
+ * 칸 하나는 64비트 원자 변수 하나입니다. 배열은 CHUNK_SIZE칸 단위 청크로 나뉘어
+ * 슬롯이 사용자에게 부여될 때(reset/reserve) CAS로 설치되고 소멸 전까지 해제되지 않으므로,
+ * 검사 경로는 할당/잠금 없이 해당 칸에 대한 CAS 한 번으로 끝납니다.
+ */
+class ReplayTable {
+public:
+    static constexpr unsigned CHUNK_BITS = 16;
+    static constexpr size_t CHUNK_SIZE = size_t(1) << CHUNK_BITS;
+    static constexpr size_t MAX_CHUNKS = 65536;                      // 최대 2^32 슬롯 (두 저장소의 슬롯 번호 범위 전체)
+    static constexpr uint64_t MAX_SLOTS = uint64_t(MAX_CHUNKS) * CHUNK_SIZE;
+
+    ReplayTable();
+    ~ReplayTable();
+
+    ReplayTable(const ReplayTable&) = delete;
+    ReplayTable& operator=(const ReplayTable&) = delete;
+
+    /**
+     * @brief step이 슬롯에 기록된 마지막 step보다 크면 기록하고 통과
+     * @return 통과면 true, 같거나 이전 step(재사용)이면 false
+     *
+     * 같은 코드를 동시에 제출한 요청 중 정확히 하나만 true를 받습니다.
+     * 범위를 벗어난 슬롯은 기록할 수 없으므로 거부합니다 (처음 한 번 로그).
+     * 청크는 reset/reserve에서 미리 만들어 두므로 할당하지 않습니다
+     * (읽기 전용 매핑에서 다른 프로세스가 새로 연 청크만 처음 한 번 만듦).
+     */
+    bool accept(uint64_t slot, uint64_t step);
+
+    /**
+     * @brief 슬롯의 마지막 통과 step (기록이 없으면 0)
+     */
+    uint64_t lastStep(uint64_t slot) const;
+
+    /**
+     * @brief 슬롯을 새 사용자용으로 준비: 청크가 없으면 만들고 이전 기록을 지움 (사용자를 넣을 때)
+     */
+    void reset(uint64_t slot);
+
+    /**
+     * @brief 슬롯 [0, slot_count)가 쓰는 청크를 미리 만듦 (저장소를 연 직후, 기존 사용자용)
+     */
+    void reserve(uint64_t slot_count);
+
+    /**
+     * @brief 마지막 호출 이후 accept가 기록한 적이 있는지 확인하고 표시를 지움 (지연 저장 판단용)
+     */
+    bool takeDirty();
+
+    /**
+     * @brief 재사용 방지 파일 기록 (임시 파일에 쓴 뒤 rename)
+     */
+    static bool writeFile(const std::string& path, const std::vector<ReplayEntry>& entries);
+
+    /**
+     * @brief 재사용 방지 파일 읽기 (파일이 없으면 빈 목록으로 성공)
+     */
+    static bool readFile(const std::string& path, std::vector<ReplayEntry>& entries);
+
+private:
+    struct Chunk {
+        std::atomic<uint64_t> steps[CHUNK_SIZE];
+    };
+
+    std::unique_ptr<std::atomic<Chunk*>[]> chunks;
+    std::atomic<bool> dirty{false};
+    std::atomic<bool> overflow_logged{false};
+
+    Chunk* chunkFor(uint64_t slot);
+};
+
+#endif // REPLAY_TABLE_H
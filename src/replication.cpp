@@ -0,0 +1,1047 @@
+#include "replication.h"
+#include "replication_protocol.h"
+#include "logger.h"
+#include "metrics.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <random>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using ReplicationProtocol::FrameReader;
+using ReplicationProtocol::FrameType;
+using ReplicationProtocol::FrameWriter;
+
+namespace {
+
+    constexpr size_t RECORDS_PER_SEND = 4096;            // 리더가 한 번에 꺼내 보내는 최대 변경 수
+    constexpr size_t READ_LIMIT = 1024 * 1024;           // 한 번에 읽는 최대 바이트 (팔로워의 반영 묶음 크기 상한)
+    constexpr size_t MAX_OUTBOX_BYTES = 1024 * 1024;     // 리더로 못 보낸 ACCEPT가 이보다 쌓이면 버림
+    constexpr const char* POSITION_MAGIC = "mfa-replica";
+
+    uint64_t randomEpoch() {
+        std::random_device device;
+        uint64_t epoch = 0;
+        while (epoch == 0) {
+            epoch = (uint64_t(device()) << 32) | device();
+        }
+        return epoch;
+    }
+
+    // 쓰기/연결 제한 시간 (블로킹 send가 느린 상대 때문에 무한정 멈추지 않도록)
+    void setSendTimeout(int fd, int milliseconds) {
+        timeval timeout{};
+        timeout.tv_sec = milliseconds / 1000;
+        timeout.tv_usec = (milliseconds % 1000) * 1000;
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    }
+
+    bool sendAll(int fd, const std::string& data) {
+        size_t offset = 0;
+        while (offset < data.size()) {
+            ssize_t n = ::send(fd, data.data() + offset, data.size() - offset, MSG_NOSIGNAL);
+            if (n > 0) {
+                offset += static_cast<size_t>(n);
+            } else if (n < 0 && errno == EINTR) {
+                continue;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 지금 읽을 수 있는 바이트를 in에 추가 (READ_LIMIT까지), 상대가 닫았으면 0, 오류면 -1
+    int receiveAvailable(int fd, std::string& in) {
+        char buffer[64 * 1024];
+        size_t received = 0;
+        while (received < READ_LIMIT) {
+            ssize_t n = ::recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+            if (n > 0) {
+                in.append(buffer, static_cast<size_t>(n));
+                received += static_cast<size_t>(n);
+                continue;
+            }
+            if (n == 0) return 0;
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return -1;
+        }
+        return 1;
+    }
+
+    void drainEventFd(int fd) {
+        uint64_t value;
+        ssize_t n = ::read(fd, &value, sizeof(value));
+        (void)n;
+    }
+
+    void signalEventFd(int fd) {
+        uint64_t one = 1;
+        ssize_t n = ::write(fd, &one, sizeof(one));
+        (void)n;
+    }
+
+    std::string formatPeer(const sockaddr_storage& addr) {
+        char host[INET6_ADDRSTRLEN] = "?";
+        int port = 0;
+        if (addr.ss_family == AF_INET6) {
+            const auto* in6 = reinterpret_cast<const sockaddr_in6*>(&addr);
+            inet_ntop(AF_INET6, &in6->sin6_addr, host, sizeof(host));
+            port = ntohs(in6->sin6_port);
+            return std::string("[") + host + "]:" + std::to_string(port);
+        }
+        const auto* in4 = reinterpret_cast<const sockaddr_in*>(&addr);
+        inet_ntop(AF_INET, &in4->sin_addr, host, sizeof(host));
+        port = ntohs(in4->sin_port);
+        return std::string(host) + ":" + std::to_string(port);
+    }
+
+    uint64_t millisecondsSince(uint64_t since_ns, uint64_t now_ns) {
+        return now_ns > since_ns ? (now_ns - since_ns) / 1000000 : 0;
+    }
+
+    // 핸드셰이크 nonce (만들 수 없으면 빈 문자열)
+    std::string randomNonce() {
+        std::string nonce(ReplicationProtocol::NONCE_BYTES, '\0');
+        if (RAND_bytes(reinterpret_cast<unsigned char*>(nonce.data()), static_cast<int>(nonce.size())) != 1) {
+            return {};
+        }
+        return nonce;
+    }
+
+    // HMAC-SHA256(key, label | first | second | epoch | seq) (replication_protocol.h 참고)
+    std::string handshakeMac(const std::string& key, std::string_view label, std::string_view first,
+                             std::string_view second, uint64_t epoch, uint64_t seq) {
+        std::string message;
+        message.append(label).append(first).append(second);
+        for (uint64_t value : {epoch, seq}) {
+            for (int shift = 56; shift >= 0; shift -= 8) {
+                message.push_back(static_cast<char>(value >> shift));
+            }
+        }
+        unsigned char mac[EVP_MAX_MD_SIZE];
+        unsigned int length = 0;
+        if (!HMAC(EVP_sha256(), key.data(), static_cast<int>(key.size()),
+                  reinterpret_cast<const unsigned char*>(message.data()), message.size(), mac, &length)) {
+            return {};
+        }
+        return std::string(reinterpret_cast<const char*>(mac), length);
+    }
+
+    bool sameMac(std::string_view received, const std::string& expected) {
+        return !expected.empty() && received.size() == expected.size() &&
+               CRYPTO_memcmp(received.data(), expected.data(), expected.size()) == 0;
+    }
+
+    // 프레임 하나가 올 때까지 대기 (REPLICATION_TIMEOUT_MS 안에 오지 않거나, 닫히거나, 길이가 잘못되면 false)
+    bool waitFrame(int fd, std::string& in, FrameType& type, std::string_view& body, size_t& consumed) {
+        int found = 0;
+        while ((found = ReplicationProtocol::nextFrame(in.data(), in.size(), type, body, consumed)) == 0) {
+            pollfd target{fd, POLLIN, 0};
+            if (::poll(&target, 1, REPLICATION_TIMEOUT_MS) <= 0 || receiveAvailable(fd, in) <= 0) return false;
+        }
+        return found > 0;
+    }
+}
+
+/**
+ * @brief 팔로워 연결 하나 (스레드 하나가 맡음)
+ */
+struct ReplicationLeader::Session {
+    uint64_t id = 0;
+    int fd = -1;
+    int wake_fd = -1;                       // 새 변경/통과 기록이 생겼음을 알림 (eventfd)
+    std::string peer;
+    std::atomic<bool> wake_pending{false};
+    std::atomic<uint64_t> acked_seq{0};
+    std::atomic<bool> snapshot{false};
+    std::atomic<bool> done{false};
+    uint64_t sent_seq = 0;                  // 세션 스레드만 접근
+    uint64_t sent_accept = 0;
+    std::thread thread;
+
+    // 이미 깨운 뒤 아직 처리하지 않았으면 다시 쓰지 않음 (인증마다 시스템 콜을 하지 않도록)
+    void wake() {
+        if (!wake_pending.exchange(true, std::memory_order_acq_rel)) {
+            signalEventFd(wake_fd);
+        }
+    }
+};
+
+ReplicationLeader::ReplicationLeader(MFACore& core, const Config& config)
+    : core(core), config(config), leader_epoch(randomEpoch()) {
+    core.setMutationListener([this](WALOp op, std::string_view user_id, std::string_view secret_base32) {
+        onMutation(op, user_id, secret_base32);
+    });
+    core.setAcceptListener([this](std::string_view user_id, uint64_t step) { onAccept(user_id, step, 0); });
+}
+
+ReplicationLeader::~ReplicationLeader() {
+    stop();
+    if (listen_fd >= 0) ::close(listen_fd);
+}
+
+bool ReplicationLeader::listen(const std::string& host, int port) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE | AI_NUMERICSERV;
+    addrinfo* result = nullptr;
+    std::string service = std::to_string(port);
+    if (getaddrinfo(host.empty() ? nullptr : host.c_str(), service.c_str(), &hints, &result) != 0) {
+        MFA_LOG_ERROR("REPLICATION", "주소를 해석할 수 없습니다: " << host);
+        return false;
+    }
+
+    for (addrinfo* info = result; info && listen_fd < 0; info = info->ai_next) {
+        int fd = socket(info->ai_family, info->ai_socktype | SOCK_CLOEXEC, info->ai_protocol);
+        if (fd < 0) continue;
+        int yes = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+        if (::bind(fd, info->ai_addr, info->ai_addrlen) == 0 && ::listen(fd, config.listen_backlog) == 0) {
+            listen_fd = fd;
+        } else {
+            ::close(fd);
+        }
+    }
+    freeaddrinfo(result);
+    if (listen_fd < 0) {
+        MFA_LOG_ERROR("REPLICATION", "복제 포트 " << port << "에 바인드할 수 없습니다: " << strerror(errno));
+        return false;
+    }
+
+    sockaddr_storage addr{};
+    socklen_t length = sizeof(addr);
+    getsockname(listen_fd, reinterpret_cast<sockaddr*>(&addr), &length);
+    listen_port = addr.ss_family == AF_INET6 ? ntohs(reinterpret_cast<sockaddr_in6*>(&addr)->sin6_port)
+                                             : ntohs(reinterpret_cast<sockaddr_in*>(&addr)->sin_port);
+    return true;
+}
+
+bool ReplicationLeader::start() {
+    if (listen_fd < 0 || accept_thread.joinable()) return false;
+    if (config.key.size() < ReplicationProtocol::MIN_KEY_BYTES) {
+        MFA_LOG_ERROR("REPLICATION", "복제 키가 없거나 너무 짧습니다 (" << ReplicationProtocol::MIN_KEY_BYTES
+                      << "바이트 이상)");
+        return false;
+    }
+    accept_thread = std::thread([this] { acceptLoop(); });
+    MFA_LOG_INFO("REPLICATION", "복제 리더: 포트 " << listen_port << ", 변경 로그 " << config.log_entries << "건");
+    return true;
+}
+
+void ReplicationLeader::stop() {
+    stopping.store(true, std::memory_order_release);
+    if (listen_fd >= 0) ::shutdown(listen_fd, SHUT_RDWR);    // 블로킹 accept()를 깨움
+    if (accept_thread.joinable()) accept_thread.join();
+    {
+        std::lock_guard<std::mutex> lock(sessions_mutex);
+        for (auto& session : sessions) {
+            ::shutdown(session->fd, SHUT_RDWR);
+            session->wake();
+        }
+    }
+    reapSessions(true);
+}
+
+uint64_t ReplicationLeader::lastSeq() const {
+    std::lock_guard<std::mutex> lock(log_mutex);
+    return last_seq;
+}
+
+std::vector<ReplicationLeader::FollowerStatus> ReplicationLeader::followers() const {
+    std::vector<FollowerStatus> result;
+    std::lock_guard<std::mutex> lock(sessions_mutex);
+    for (const auto& session : sessions) {
+        if (session->done.load(std::memory_order_acquire)) continue;
+        result.push_back(FollowerStatus{session->peer, session->acked_seq.load(std::memory_order_relaxed),
+                                        session->snapshot.load(std::memory_order_relaxed)});
+    }
+    return result;
+}
+
+// MFACore::mutation_mutex 안에서 변경 순서대로 호출됨
+void ReplicationLeader::onMutation(WALOp op, std::string_view user_id, std::string_view secret_base32) {
+    {
+        std::lock_guard<std::mutex> lock(log_mutex);
+        entries.push_back(Entry{++last_seq, op, std::string(user_id), std::string(secret_base32)});
+        while (entries.size() > config.log_entries) {
+            entries.pop_front();
+        }
+    }
+    wakeSessions();
+}
+
+void ReplicationLeader::onAccept(std::string_view user_id, uint64_t step, uint64_t origin) {
+    // 새 세션은 연결 시점 이후의 통과 기록만 받으므로 팔로워가 없으면 쌓을 필요가 없음
+    if (active_sessions.load(std::memory_order_relaxed) == 0) return;
+    {
+        std::lock_guard<std::mutex> lock(log_mutex);
+        accepts.push_back(AcceptEntry{++last_accept_seq, step, origin, std::string(user_id)});
+        while (accepts.size() > REPLICATION_ACCEPT_LOG_ENTRIES) {
+            accepts.pop_front();
+        }
+    }
+    wakeSessions();
+}
+
+void ReplicationLeader::wakeSessions() {
+    std::lock_guard<std::mutex> lock(sessions_mutex);
+    for (auto& session : sessions) {
+        session->wake();
+    }
+}
+
+void ReplicationLeader::acceptLoop() {
+    while (!stopping.load(std::memory_order_acquire)) {
+        sockaddr_storage addr{};
+        socklen_t length = sizeof(addr);
+        int fd = accept4(listen_fd, reinterpret_cast<sockaddr*>(&addr), &length, SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (stopping.load(std::memory_order_acquire)) break;
+            if (errno != EINTR && errno != ECONNABORTED) {
+                MFA_LOG_WARN("REPLICATION", "팔로워 연결을 받을 수 없습니다: " << strerror(errno));
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+            continue;
+        }
+
+        int yes = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+        setSendTimeout(fd, REPLICATION_TIMEOUT_MS);
+
+        auto session = std::make_unique<Session>();
+        session->fd = fd;
+        session->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        session->peer = formatPeer(addr);
+        if (session->wake_fd < 0) {
+            MFA_LOG_WARN("REPLICATION", "eventfd를 만들 수 없습니다: " << strerror(errno));
+            ::close(fd);
+            continue;
+        }
+
+        // 끝난 세션(대개 다시 연결해 온 같은 팔로워의 이전 연결)을 먼저 정리
+        reapSessions(false);
+
+        std::lock_guard<std::mutex> lock(sessions_mutex);
+        session->id = next_session_id++;
+        Session& target = *session;
+        sessions.push_back(std::move(session));
+        active_sessions.fetch_add(1, std::memory_order_relaxed);
+        target.thread = std::thread([this, &target] {
+            serve(target);
+            target.done.store(true, std::memory_order_release);
+            active_sessions.fetch_sub(1, std::memory_order_relaxed);
+        });
+    }
+}
+
+void ReplicationLeader::reapSessions(bool all) {
+    std::list<std::unique_ptr<Session>> finished;
+    {
+        std::lock_guard<std::mutex> lock(sessions_mutex);
+        for (auto it = sessions.begin(); it != sessions.end();) {
+            auto current = it++;
+            if (all || (*current)->done.load(std::memory_order_acquire)) {
+                finished.splice(finished.end(), sessions, current);
+            }
+        }
+    }
+    // 세션 스레드가 wakeSessions()로 sessions_mutex를 잡을 수 있으므로 잠금 밖에서 기다림
+    for (auto& session : finished) {
+        if (session->thread.joinable()) session->thread.join();
+        ::close(session->fd);
+        ::close(session->wake_fd);
+    }
+}
+
+void ReplicationLeader::serve(Session& session) {
+    // CHALLENGE를 보내고 그 nonce에 복제 키로 MAC을 붙인 HELLO를 받음
+    // (키를 모르는 상대에게는 WELCOME/스냅샷을 보내지 않고 그 상대의 프레임도 받지 않음)
+    std::string challenge = randomNonce();
+    if (challenge.empty()) {
+        MFA_LOG_WARN("REPLICATION", "핸드셰이크 nonce를 만들 수 없습니다");
+        return;
+    }
+    std::string out;
+    FrameWriter(out, FrameType::Challenge).str(challenge).finish();
+    if (!sendAll(session.fd, out)) return;
+
+    std::string in;
+    FrameType type{};
+    std::string_view body;
+    size_t consumed = 0;
+    if (!waitFrame(session.fd, in, type, body, consumed)) {
+        MFA_LOG_WARN("REPLICATION", "팔로워 " << session.peer << "가 HELLO를 보내지 않았습니다");
+        return;
+    }
+    FrameReader hello(body.data(), body.size());
+    uint64_t follower_epoch = hello.u64();
+    uint64_t follower_seq = hello.u64();
+    std::string follower_nonce(hello.str());
+    std::string_view hello_mac = hello.str();
+    if (type != FrameType::Hello || !hello.atEnd() || follower_nonce.size() != ReplicationProtocol::NONCE_BYTES) {
+        MFA_LOG_WARN("REPLICATION", "팔로워 " << session.peer << "의 HELLO가 잘못되었습니다");
+        return;
+    }
+    if (!sameMac(hello_mac, handshakeMac(config.key, "hello", challenge, follower_nonce, follower_epoch, follower_seq))) {
+        MFA_LOG_WARN("REPLICATION", "팔로워 " << session.peer << "의 복제 키가 맞지 않아 연결을 닫습니다");
+        return;
+    }
+    in.erase(0, consumed);
+
+    // 로그에서 이어 줄 수 있으면 그 다음부터, 아니면 지금 seq를 기준으로 스냅샷
+    // (기준 seq를 스냅샷보다 먼저 읽으므로 그 사이 변경은 스냅샷과 RECORD 양쪽에 들어갈 수 있으며,
+    //  팔로워의 반영이 멱등이라 결과는 같음)
+    bool incremental;
+    {
+        std::lock_guard<std::mutex> lock(log_mutex);
+        incremental = follower_epoch == leader_epoch && follower_seq <= last_seq &&
+                      follower_seq + 1 >= firstSeqLocked();
+        session.sent_seq = incremental ? follower_seq : last_seq;
+        session.sent_accept = last_accept_seq;
+    }
+    session.acked_seq.store(incremental ? follower_seq : 0, std::memory_order_relaxed);
+    session.snapshot.store(!incremental, std::memory_order_relaxed);
+
+    out.clear();
+    FrameWriter(out, FrameType::Welcome)
+        .u64(leader_epoch)
+        .u64(session.sent_seq)
+        .u8(incremental ? 0 : 1)
+        .u16(static_cast<uint16_t>(http_port.load(std::memory_order_relaxed)))
+        .u8(config.tls ? 1 : 0)
+        .str(handshakeMac(config.key, "welcome", follower_nonce, challenge, leader_epoch, session.sent_seq))
+        .finish();
+    if (!sendAll(session.fd, out)) return;
+
+    MFA_LOG_INFO("REPLICATION", "팔로워 연결: " << session.peer
+                 << (incremental ? " (seq " : " (스냅샷, 기준 seq ") << session.sent_seq
+                 << (incremental ? "부터 이어 받음)" : ")"));
+    if (!incremental && !sendSnapshot(session)) return;
+
+    uint64_t last_send_ns = Metrics::nowNs();
+    uint64_t last_receive_ns = last_send_ns;
+    while (!stopping.load(std::memory_order_acquire)) {
+        // 새 변경과 통과 기록을 꺼내 프레임으로 (잠금 안에서는 복사만)
+        out.clear();
+        bool behind = false;
+        bool more = false;
+        uint64_t leader_seq = 0;
+        {
+            std::lock_guard<std::mutex> lock(log_mutex);
+            leader_seq = last_seq;
+            uint64_t first = firstSeqLocked();
+            if (session.sent_seq + 1 < first) {
+                behind = true;
+            } else {
+                size_t sent = 0;
+                for (size_t i = session.sent_seq + 1 - first; i < entries.size() && sent < RECORDS_PER_SEND; i++, sent++) {
+                    const Entry& entry = entries[i];
+                    FrameWriter(out, FrameType::Record)
+                        .u64(entry.seq)
+                        .u8(static_cast<uint8_t>(entry.op))
+                        .str(entry.user_id)
+                        .str(entry.secret_base32)
+                        .finish();
+                    session.sent_seq = entry.seq;
+                }
+                more = session.sent_seq < last_seq;
+            }
+
+            // 통과 기록은 최선 노력: 밀려난 것은 건너뜀
+            uint64_t first_accept = accepts.empty() ? last_accept_seq + 1 : accepts.front().seq;
+            session.sent_accept = std::max(session.sent_accept, first_accept - 1);
+            for (size_t i = session.sent_accept + 1 - first_accept; i < accepts.size(); i++) {
+                const AcceptEntry& accept = accepts[i];
+                if (accept.origin == session.id) continue;
+                FrameWriter(out, FrameType::LeaderAccept).u64(accept.step).str(accept.user_id).finish();
+            }
+            session.sent_accept = last_accept_seq;
+        }
+        if (behind) {
+            MFA_LOG_WARN("REPLICATION", "팔로워 " << session.peer << "가 변경 로그에서 밀려났습니다 (다시 연결하면 스냅샷부터)");
+            return;
+        }
+
+        uint64_t now = Metrics::nowNs();
+        if (out.empty() && millisecondsSince(last_send_ns, now) >= static_cast<uint64_t>(REPLICATION_HEARTBEAT_MS)) {
+            FrameWriter(out, FrameType::Heartbeat).u64(leader_seq).finish();
+        }
+        if (!out.empty()) {
+            if (!sendAll(session.fd, out)) {
+                MFA_LOG_WARN("REPLICATION", "팔로워 " << session.peer << "에게 보낼 수 없습니다: " << strerror(errno));
+                return;
+            }
+            last_send_ns = now;
+        }
+
+        pollfd fds[2] = {{session.fd, POLLIN, 0}, {session.wake_fd, POLLIN, 0}};
+        int wait_ms = more ? 0 : REPLICATION_HEARTBEAT_MS - static_cast<int>(millisecondsSince(last_send_ns, Metrics::nowNs()));
+        if (::poll(fds, 2, std::max(wait_ms, 0)) < 0 && errno != EINTR) return;
+
+        if (fds[1].revents & POLLIN) {
+            drainEventFd(session.wake_fd);
+            session.wake_pending.store(false, std::memory_order_release);
+        }
+        now = Metrics::nowNs();
+        if (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+            int status = receiveAvailable(session.fd, in);
+            if (status <= 0 || !handleFollowerFrames(session, in)) {
+                MFA_LOG_INFO("REPLICATION", "팔로워 연결 종료: " << session.peer);
+                return;
+            }
+            last_receive_ns = now;
+        } else if (millisecondsSince(last_receive_ns, now) >= static_cast<uint64_t>(REPLICATION_TIMEOUT_MS)) {
+            MFA_LOG_WARN("REPLICATION", "팔로워 " << session.peer << "의 응답이 없어 연결을 닫습니다");
+            return;
+        }
+    }
+}
+
+bool ReplicationLeader::sendSnapshot(Session& session) {
+    // exportUsers가 mutation_mutex를 잡은 동안에는 메모리에 프레임을 만들기만 하고, 보내기는 잠금 밖에서
+    std::string out;
+    std::optional<FrameWriter> frame;
+    size_t count_offset = 0;
+    uint32_t in_frame = 0;
+    auto finishFrame = [&] {
+        frame->patchU32(count_offset, in_frame);
+        frame->finish();
+        frame.reset();
+        in_frame = 0;
+    };
+
+    uint64_t start = Metrics::nowNs();
+    size_t users = core.exportUsers([&](std::string_view user_id, std::string_view secret_base32) {
+        if (!frame) {
+            frame.emplace(out, FrameType::Snapshot);
+            count_offset = frame->offset();
+            frame->u32(0);
+        }
+        frame->str(user_id).str(secret_base32);
+        if (++in_frame == ReplicationProtocol::SNAPSHOT_USERS_PER_FRAME) finishFrame();
+    });
+    if (frame) finishFrame();
+    FrameWriter(out, FrameType::SnapshotEnd).finish();
+
+    if (!sendAll(session.fd, out)) {
+        MFA_LOG_WARN("REPLICATION", "팔로워 " << session.peer << "에게 스냅샷을 보낼 수 없습니다: " << strerror(errno));
+        return false;
+    }
+    MFA_LOG_INFO("REPLICATION", "팔로워 " << session.peer << "에게 스냅샷 전송: 사용자 " << users << "명, "
+                 << out.size() / 1024 << "KB, " << millisecondsSince(start, Metrics::nowNs()) << "ms");
+    return true;
+}
+
+bool ReplicationLeader::handleFollowerFrames(Session& session, std::string& in) {
+    size_t offset = 0;
+    for (;;) {
+        FrameType type{};
+        std::string_view body;
+        size_t consumed = 0;
+        int found = ReplicationProtocol::nextFrame(in.data() + offset, in.size() - offset, type, body, consumed);
+        if (found < 0) return false;
+        if (found == 0) break;
+        offset += consumed;
+
+        FrameReader reader(body.data(), body.size());
+        if (type == FrameType::Ack) {
+            uint64_t seq = reader.u64();
+            if (!reader.atEnd()) return false;
+            session.acked_seq.store(seq, std::memory_order_relaxed);
+        } else if (type == FrameType::FollowerAccept) {
+            uint64_t step = reader.u64();
+            std::string_view user_id = reader.str();
+            if (!reader.atEnd()) return false;
+            // 리더 자신의 상태에 기록한 뒤 보낸 팔로워를 뺀 나머지에게 돌림
+            core.acceptReplicated(user_id, step);
+            onAccept(user_id, step, session.id);
+        } else {
+            return false;
+        }
+    }
+    in.erase(0, offset);
+    return true;
+}
+
+ReplicationFollower::ReplicationFollower(MFACore& core, const Config& config)
+    : core(core), config(config) {
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    uint64_t epoch = 0;
+    uint64_t seq = 0;
+    if (loadPosition(epoch, seq)) {
+        state.epoch = epoch;
+        state.applied_seq = seq;
+        state.leader_seq = seq;
+    }
+    core.setAcceptListener([this](std::string_view user_id, uint64_t step) { onAccept(user_id, step); });
+}
+
+ReplicationFollower::~ReplicationFollower() {
+    stop();
+    if (wake_fd >= 0) ::close(wake_fd);
+}
+
+bool ReplicationFollower::parseAddress(std::string_view text, std::string& host, int& port) {
+    size_t colon = text.rfind(':');
+    if (colon == std::string_view::npos || colon == 0) return false;
+    std::string_view host_part = text.substr(0, colon);
+    if (host_part.size() >= 2 && host_part.front() == '[' && host_part.back() == ']') {
+        host_part = host_part.substr(1, host_part.size() - 2);
+    }
+    std::string_view port_part = text.substr(colon + 1);
+    if (host_part.empty() || port_part.empty() || port_part.size() > 5) return false;
+    int value = 0;
+    for (char c : port_part) {
+        if (c < '0' || c > '9') return false;
+        value = value * 10 + (c - '0');
+    }
+    if (value < 1 || value > 65535) return false;
+    host.assign(host_part);
+    port = value;
+    return true;
+}
+
+bool ReplicationFollower::start() {
+    if (wake_fd < 0 || thread.joinable()) return false;
+    if (config.key.size() < ReplicationProtocol::MIN_KEY_BYTES) {
+        MFA_LOG_ERROR("REPLICATION", "복제 키가 없거나 너무 짧습니다 (" << ReplicationProtocol::MIN_KEY_BYTES
+                      << "바이트 이상)");
+        return false;
+    }
+    MFA_LOG_INFO("REPLICATION", "복제 팔로워: 리더 " << config.leader_host << ":" << config.leader_port
+                 << " (반영 위치 seq " << status().applied_seq << ")");
+    thread = std::thread([this] { run(); });
+    return true;
+}
+
+void ReplicationFollower::stop() {
+    stopping.store(true, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(socket_mutex);
+        if (socket_fd >= 0) ::shutdown(socket_fd, SHUT_RDWR);
+    }
+    {
+        std::lock_guard<std::mutex> lock(retry_mutex);
+        retry_cv.notify_all();
+    }
+    if (thread.joinable()) thread.join();
+}
+
+ReplicationFollower::Status ReplicationFollower::status() const {
+    std::lock_guard<std::mutex> lock(state_mutex);
+    Status result = state;
+    uint64_t now = Metrics::nowNs();
+    result.lag_seconds = behind_since_ns ? static_cast<double>(now - behind_since_ns) / 1e9 : 0.0;
+    result.last_contact_seconds = last_contact_ns ? static_cast<double>(now - last_contact_ns) / 1e9 : -1.0;
+    return result;
+}
+
+std::string ReplicationFollower::leaderURL() const {
+    std::lock_guard<std::mutex> lock(state_mutex);
+    return leader_url;
+}
+
+void ReplicationFollower::run() {
+    bool reported_failure = false;
+    while (!stopping.load(std::memory_order_acquire)) {
+        int fd = connectLeader();
+        if (fd >= 0) {
+            reported_failure = false;
+            {
+                std::lock_guard<std::mutex> lock(socket_mutex);
+                socket_fd = fd;
+            }
+            if (!stopping.load(std::memory_order_acquire)) {
+                follow(fd);
+            }
+            {
+                std::lock_guard<std::mutex> lock(socket_mutex);
+                socket_fd = -1;
+            }
+            ::close(fd);
+            std::lock_guard<std::mutex> lock(state_mutex);
+            state.connected = false;
+        } else if (!reported_failure) {
+            // 리더가 내려가 있는 동안 같은 경고를 반복하지 않음
+            MFA_LOG_WARN("REPLICATION", "리더 " << config.leader_host << ":" << config.leader_port
+                         << "에 연결할 수 없습니다: " << strerror(errno) << " (계속 다시 시도)");
+            reported_failure = true;
+        }
+
+        std::unique_lock<std::mutex> lock(retry_mutex);
+        retry_cv.wait_for(lock, std::chrono::milliseconds(REPLICATION_RETRY_MS),
+                          [this] { return stopping.load(std::memory_order_acquire); });
+    }
+}
+
+int ReplicationFollower::connectLeader() {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_NUMERICSERV;
+    addrinfo* result = nullptr;
+    std::string service = std::to_string(config.leader_port);
+    if (getaddrinfo(config.leader_host.c_str(), service.c_str(), &hints, &result) != 0) {
+        errno = EHOSTUNREACH;
+        return -1;
+    }
+
+    int fd = -1;
+    int last_errno = 0;
+    for (addrinfo* info = result; info && fd < 0; info = info->ai_next) {
+        int candidate = socket(info->ai_family, info->ai_socktype | SOCK_CLOEXEC, info->ai_protocol);
+        if (candidate < 0) continue;
+        setSendTimeout(candidate, REPLICATION_TIMEOUT_MS);       // connect()에도 적용됨
+        if (::connect(candidate, info->ai_addr, info->ai_addrlen) == 0) {
+            fd = candidate;
+        } else {
+            last_errno = errno;
+            ::close(candidate);
+        }
+    }
+    freeaddrinfo(result);
+    if (fd < 0) {
+        errno = last_errno;
+        return -1;
+    }
+    int yes = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+    return fd;
+}
+
+bool ReplicationFollower::follow(int fd) {
+    // 리더의 CHALLENGE nonce와 이쪽 nonce에 복제 키로 MAC을 붙여 HELLO
+    std::string in;
+    FrameType type{};
+    std::string_view body;
+    size_t consumed = 0;
+    if (!waitFrame(fd, in, type, body, consumed)) {
+        MFA_LOG_WARN("REPLICATION", "리더가 CHALLENGE를 보내지 않았습니다");
+        return false;
+    }
+    FrameReader challenge(body.data(), body.size());
+    leader_nonce.assign(challenge.str());
+    if (type != FrameType::Challenge || !challenge.atEnd() ||
+        leader_nonce.size() != ReplicationProtocol::NONCE_BYTES) {
+        MFA_LOG_WARN("REPLICATION", "리더가 보낸 프레임이 잘못되었습니다: CHALLENGE");
+        return false;
+    }
+    in.erase(0, consumed);
+    hello_nonce = randomNonce();
+    if (hello_nonce.empty()) {
+        MFA_LOG_WARN("REPLICATION", "핸드셰이크 nonce를 만들 수 없습니다");
+        return false;
+    }
+
+    uint64_t hello_epoch;
+    uint64_t hello_seq;
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        hello_epoch = state.epoch;
+        hello_seq = state.applied_seq;
+    }
+    std::string out;
+    FrameWriter(out, FrameType::Hello)
+        .u64(hello_epoch)
+        .u64(hello_seq)
+        .str(hello_nonce)
+        .str(handshakeMac(config.key, "hello", leader_nonce, hello_nonce, hello_epoch, hello_seq))
+        .finish();
+    if (!sendAll(fd, out)) return false;
+
+    snapshot_active = false;
+    session_epoch = 0;
+    std::string reply;
+    uint64_t last_receive_ns = Metrics::nowNs();
+    uint64_t last_ack_ns = last_receive_ns;
+    while (!stopping.load(std::memory_order_acquire)) {
+        pollfd fds[2] = {{fd, POLLIN, 0}, {wake_fd, POLLIN, 0}};
+        if (::poll(fds, 2, REPLICATION_HEARTBEAT_MS) < 0 && errno != EINTR) return false;
+
+        if (fds[1].revents & POLLIN) {
+            drainEventFd(wake_fd);
+            wake_pending.store(false, std::memory_order_release);
+        }
+        uint64_t now = Metrics::nowNs();
+        if (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+            int status = receiveAvailable(fd, in);
+            if (status <= 0) {
+                MFA_LOG_WARN("REPLICATION", "리더와의 연결이 끊겼습니다");
+                return false;
+            }
+            last_receive_ns = now;
+            {
+                std::lock_guard<std::mutex> lock(state_mutex);
+                last_contact_ns = now;
+            }
+            if (!handleLeaderFrames(in, reply)) return false;
+        } else if (millisecondsSince(last_receive_ns, now) >= static_cast<uint64_t>(REPLICATION_TIMEOUT_MS)) {
+            MFA_LOG_WARN("REPLICATION", "리더의 응답이 없어 다시 연결합니다");
+            return false;
+        }
+
+        // 이 노드에서 통과한 OTP와 주기적 ACK (리더가 연결 상태를 판단하는 근거)
+        {
+            std::lock_guard<std::mutex> lock(outbox_mutex);
+            reply.append(outbox);
+            outbox.clear();
+        }
+        if (session_epoch != 0 && !snapshot_active &&
+            millisecondsSince(last_ack_ns, now) >= static_cast<uint64_t>(REPLICATION_HEARTBEAT_MS)) {
+            FrameWriter(reply, FrameType::Ack).u64(status().applied_seq).finish();
+            last_ack_ns = now;
+        }
+        if (!reply.empty()) {
+            if (!sendAll(fd, reply)) {
+                MFA_LOG_WARN("REPLICATION", "리더에게 보낼 수 없습니다: " << strerror(errno));
+                return false;
+            }
+            reply.clear();
+        }
+    }
+    return true;
+}
+
+bool ReplicationFollower::handleLeaderFrames(std::string& in, std::string& reply) {
+    std::vector<WALRecord> batch;
+    std::vector<std::pair<std::string, uint64_t>> accepted;
+    uint64_t applied = status().applied_seq;
+
+    auto protocolError = [](const char* what) {
+        MFA_LOG_WARN("REPLICATION", "리더가 보낸 프레임이 잘못되었습니다: " << what);
+        return false;
+    };
+
+    size_t offset = 0;
+    for (;;) {
+        FrameType type{};
+        std::string_view body;
+        size_t consumed = 0;
+        int found = ReplicationProtocol::nextFrame(in.data() + offset, in.size() - offset, type, body, consumed);
+        if (found < 0) return protocolError("길이");
+        if (found == 0) break;
+        offset += consumed;
+
+        // WELCOME으로 리더가 키를 가졌음을 확인하기 전에는 아무것도 반영하지 않음
+        if (session_epoch == 0 && type != FrameType::Welcome) return protocolError("WELCOME 전 프레임");
+
+        FrameReader reader(body.data(), body.size());
+        switch (type) {
+            case FrameType::Welcome: {
+                uint64_t epoch = reader.u64();
+                uint64_t base = reader.u64();
+                bool snapshot = reader.u8() != 0;
+                uint16_t http_port = reader.u16();
+                bool tls = reader.u8() != 0;
+                std::string_view mac = reader.str();
+                if (!reader.atEnd() || session_epoch != 0) return protocolError("WELCOME");
+                if (!sameMac(mac, handshakeMac(config.key, "welcome", hello_nonce, leader_nonce, epoch, base))) {
+                    return protocolError("WELCOME MAC (복제 키가 다름)");
+                }
+                if (!snapshot && base != applied) return protocolError("WELCOME 기준 seq");
+                session_epoch = epoch;
+                {
+                    std::lock_guard<std::mutex> lock(state_mutex);
+                    state.connected = true;
+                    bool ipv6 = config.leader_host.find(':') != std::string::npos;
+                    leader_url = http_port == 0 ? std::string()
+                                                : std::string(tls ? "https://" : "http://") +
+                                                      (ipv6 ? "[" + config.leader_host + "]" : config.leader_host) +
+                                                      ":" + std::to_string(http_port);
+                }
+                if (snapshot) {
+                    // 스냅샷을 반영하는 도중 멈추면 다음 시작 때 처음부터 다시 받도록 위치를 지움
+                    savePosition(0, 0);
+                    snapshot_active = true;
+                    snapshot_base = base;
+                    snapshot_users.clear();
+                    MFA_LOG_INFO("REPLICATION", "리더에 연결: 스냅샷 수신 (기준 seq " << base << ")");
+                } else {
+                    MFA_LOG_INFO("REPLICATION", "리더에 연결: seq " << base << "부터 이어 받음");
+                }
+                noteLeaderSeq(base);
+                break;
+            }
+            case FrameType::Snapshot: {
+                if (!snapshot_active) return protocolError("SNAPSHOT");
+                uint32_t count = reader.u32();
+                for (uint32_t i = 0; i < count && reader.ok(); i++) {
+                    std::string_view user_id = reader.str();
+                    std::string_view secret_base32 = reader.str();
+                    if (!MFACore::isValidUserId(user_id)) return protocolError("SNAPSHOT user_id");
+                    snapshot_users[std::string(user_id)] = std::string(secret_base32);
+                }
+                if (!reader.atEnd()) return protocolError("SNAPSHOT");
+                break;
+            }
+            case FrameType::SnapshotEnd: {
+                if (!snapshot_active || !reader.atEnd()) return protocolError("SNAPSHOT_END");
+                if (!applySnapshot()) return false;
+                snapshot_active = false;
+                applied = snapshot_base;
+                savePosition(session_epoch, applied);
+                setApplied(session_epoch, applied, 0);
+                {
+                    std::lock_guard<std::mutex> lock(state_mutex);
+                    state.resyncs++;
+                }
+                FrameWriter(reply, FrameType::Ack).u64(applied).finish();
+                break;
+            }
+            case FrameType::Record: {
+                uint64_t seq = reader.u64();
+                uint8_t op = reader.u8();
+                std::string_view user_id = reader.str();
+                std::string_view secret_base32 = reader.str();
+                if (!reader.atEnd() || snapshot_active || session_epoch == 0 || !MFACore::isValidUserId(user_id) ||
+                    (op != static_cast<uint8_t>(WALOp::Register) && op != static_cast<uint8_t>(WALOp::Delete))) {
+                    return protocolError("RECORD");
+                }
+                if (seq != applied + batch.size() + 1) return protocolError("seq가 이어지지 않음");
+                batch.push_back(WALRecord{static_cast<WALOp>(op), seq, std::string(user_id), std::string(secret_base32)});
+                break;
+            }
+            case FrameType::LeaderAccept: {
+                uint64_t step = reader.u64();
+                std::string_view user_id = reader.str();
+                if (!reader.atEnd()) return protocolError("ACCEPT");
+                accepted.emplace_back(std::string(user_id), step);
+                break;
+            }
+            case FrameType::Heartbeat: {
+                uint64_t seq = reader.u64();
+                if (!reader.atEnd()) return protocolError("HEARTBEAT");
+                noteLeaderSeq(seq);
+                break;
+            }
+            default:
+                return protocolError("알 수 없는 종류");
+        }
+    }
+    in.erase(0, offset);
+
+    // 받은 변경을 한 번에 반영 (WAL 대기 한 번) 한 뒤 위치를 남기므로 위치가 데이터보다 앞서지 않음
+    if (!batch.empty()) {
+        noteLeaderSeq(batch.back().lsn);
+        if (!core.applyReplicated(batch)) {
+            MFA_LOG_ERROR("REPLICATION", "복제 변경을 반영하지 못했습니다 (seq " << batch.front().lsn << "~)");
+            return false;
+        }
+        applied = batch.back().lsn;
+        savePosition(session_epoch, applied);
+        setApplied(session_epoch, applied, batch.size());
+        FrameWriter(reply, FrameType::Ack).u64(applied).finish();
+    }
+
+    // 통과 기록은 같은 묶음의 등록이 반영된 뒤에 적용
+    for (const auto& [user_id, step] : accepted) {
+        core.acceptReplicated(user_id, step);
+    }
+    return true;
+}
+
+bool ReplicationFollower::applySnapshot() {
+    // 로컬에만 있는 사용자는 삭제, 시크릿이 같은 사용자는 그대로 두고 나머지는 등록(덮어쓰기)
+    std::vector<WALRecord> records;
+    core.exportUsers([&](std::string_view user_id, std::string_view secret_base32) {
+        auto it = snapshot_users.find(std::string(user_id));
+        if (it == snapshot_users.end()) {
+            records.push_back(WALRecord{WALOp::Delete, 0, std::string(user_id), {}});
+        } else if (it->second == secret_base32) {
+            snapshot_users.erase(it);
+        }
+    });
+    size_t removed = records.size();
+    for (auto& [user_id, secret_base32] : snapshot_users) {
+        records.push_back(WALRecord{WALOp::Register, 0, user_id, std::move(secret_base32)});
+    }
+    std::unordered_map<std::string, std::string>().swap(snapshot_users);
+
+    // 인증 경로는 잠금 없이 읽으므로, 나눠 반영하는 동안에도 계속 처리됨
+    for (size_t begin = 0; begin < records.size(); begin += IMPORT_LOCK_BATCH) {
+        size_t end = std::min(records.size(), begin + IMPORT_LOCK_BATCH);
+        std::vector<WALRecord> chunk(std::make_move_iterator(records.begin() + begin),
+                                     std::make_move_iterator(records.begin() + end));
+        if (!core.applyReplicated(chunk)) {
+            MFA_LOG_ERROR("REPLICATION", "스냅샷을 반영하지 못했습니다");
+            return false;
+        }
+    }
+    MFA_LOG_INFO("REPLICATION", "스냅샷 반영: 사용자 " << core.userCount() << "명 (삭제 " << removed << ", 등록/변경 "
+                 << records.size() - removed << ")");
+    return true;
+}
+
+void ReplicationFollower::onAccept(std::string_view user_id, uint64_t step) {
+    {
+        std::lock_guard<std::mutex> lock(outbox_mutex);
+        if (outbox.size() >= MAX_OUTBOX_BYTES) return;
+        FrameWriter(outbox, FrameType::FollowerAccept).u64(step).str(user_id).finish();
+    }
+    if (!wake_pending.exchange(true, std::memory_order_acq_rel)) {
+        signalEventFd(wake_fd);
+    }
+}
+
+void ReplicationFollower::setApplied(uint64_t epoch, uint64_t seq, size_t records) {
+    std::lock_guard<std::mutex> lock(state_mutex);
+    state.epoch = epoch;
+    state.applied_seq = seq;
+    state.applied_records += records;
+    if (seq >= state.leader_seq) {
+        state.leader_seq = seq;
+        behind_since_ns = 0;
+    }
+}
+
+void ReplicationFollower::noteLeaderSeq(uint64_t seq) {
+    std::lock_guard<std::mutex> lock(state_mutex);
+    state.leader_seq = seq;
+    if (seq > state.applied_seq) {
+        if (behind_since_ns == 0) behind_since_ns = Metrics::nowNs();
+    } else {
+        behind_since_ns = 0;
+    }
+}
+
+bool ReplicationFollower::loadPosition(uint64_t& epoch, uint64_t& seq) const {
+    if (config.position_path.empty()) return false;
+    std::ifstream file(config.position_path);
+    std::string magic;
+    file >> magic >> std::hex >> epoch >> std::dec >> seq;
+    return file && magic == POSITION_MAGIC;
+}
+
+void ReplicationFollower::savePosition(uint64_t epoch, uint64_t seq) const {
+    if (config.position_path.empty()) return;
+    // 임시 파일에 쓴 뒤 rename (fsync는 하지 않음: 위치가 뒤처지는 것은 다시 받으면 되므로 안전)
+    std::string temp_path = config.position_path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::trunc);
+        file << POSITION_MAGIC << " " << std::hex << epoch << std::dec << " " << seq << "\n";
+        if (!file) {
+            MFA_LOG_WARN("REPLICATION", "반영 위치를 기록할 수 없습니다: " << temp_path);
+            return;
+        }
+    }
+    if (std::rename(temp_path.c_str(), config.position_path.c_str()) != 0) {
+        MFA_LOG_WARN("REPLICATION", "반영 위치를 기록할 수 없습니다: " << config.position_path);
+    }
+}
@@ -0,0 +1,233 @@
+#ifndef REPLICATION_H
+#define REPLICATION_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "mfa_core.h"
+
+constexpr size_t DEFAULT_REPLICATION_LOG_ENTRIES = 262144;  // 리더가 들고 있는 최근 변경 수 (팔로워가 이어 받을 수 있는 범위)
+constexpr size_t REPLICATION_ACCEPT_LOG_ENTRIES = 65536;    // 팔로워에게 돌리기 위해 들고 있는 최근 OTP 통과 기록 수
+constexpr int REPLICATION_HEARTBEAT_MS = 1000;              // 보낼 변경이 없을 때 리더가 HEARTBEAT를 보내는 주기
+constexpr int REPLICATION_TIMEOUT_MS = 5000;                // 이 시간 동안 아무것도 못 받으면 연결이 끊긴 것으로 봄
+constexpr int REPLICATION_RETRY_MS = 1000;                  // 팔로워 재연결 간격
+
+/**
+ * @brief 복제 리더 (--replication-port)
+ *
+ * MFACore의 등록/삭제 통지를 받아 seq를 붙여 최근 변경 로그(메모리, log_entries개)에 쌓고,
+ * 팔로워 연결마다 스레드 하나가 그 로그를 따라가며 RECORD를 보냅니다. 팔로워가 로그 밖의 위치에서
+ * 시작하면 MFACore::exportUsers로 스냅샷을 만들어 먼저 보냅니다 (사용자 수만큼의 메모리를 잠시 씀).
+ * OTP 통과 기록은 로그와 별도로 최근 것만 들고 있다가 모든 팔로워에게 돌립니다 (최선 노력, 디스크에 남기지 않음).
+ *
+ * seq는 프로세스 안에서만 이어지는 번호라 리더가 다시 시작하면 epoch가 바뀌고 팔로워는 스냅샷부터 다시 받습니다.
+ */
+class ReplicationLeader {
+public:
+    struct Config {
+        size_t log_entries = DEFAULT_REPLICATION_LOG_ENTRIES;
+        int listen_backlog = 16;
+        bool tls = false;                   // 팔로워가 쓰기 요청을 돌려보낼 HTTP 주소가 https인지
+        std::string key;                    // 팔로워와 나눠 가진 복제 키 (MIN_KEY_BYTES 이상, 비우면 시작하지 않음)
+    };
+
+    struct FollowerStatus {
+        std::string peer;                   // 팔로워 주소 (ip:port)
+        uint64_t acked_seq = 0;             // 팔로워가 반영했다고 알린 마지막 seq
+        bool snapshot = false;              // 이번 연결을 스냅샷으로 시작했는지
+    };
+
+    /**
+     * @brief 생성 시 core에 등록/삭제/OTP 통과 통지를 연결 (core보다 오래 살아 있어야 함)
+     */
+    ReplicationLeader(MFACore& core, const Config& config);
+    ~ReplicationLeader();
+
+    ReplicationLeader(const ReplicationLeader&) = delete;
+    ReplicationLeader& operator=(const ReplicationLeader&) = delete;
+
+    /**
+     * @brief 팔로워 수신 소켓 열기 (start() 전에 호출)
+     * @param port 0이면 임의 포트 (port()로 확인)
+     */
+    bool listen(const std::string& host, int port);
+
+    /**
+     * @brief 수락 스레드 시작 (바로 반환, 복제 키가 짧으면 false)
+     */
+    bool start();
+
+    /**
+     * @brief 모든 팔로워 연결을 닫고 스레드가 끝날 때까지 기다림
+     */
+    void stop();
+
+    /**
+     * @brief 팔로워에게 알려 줄 리더의 HTTP 포트 (쓰기 요청을 돌려보낼 주소)
+     */
+    void setHTTPPort(int port) { http_port.store(port, std::memory_order_relaxed); }
+
+    int port() const { return listen_port; }
+    uint64_t epoch() const { return leader_epoch; }
+    uint64_t lastSeq() const;
+    std::vector<FollowerStatus> followers() const;
+
+private:
+    struct Entry {
+        uint64_t seq;
+        WALOp op;
+        std::string user_id;
+        std::string secret_base32;
+    };
+
+    struct AcceptEntry {
+        uint64_t seq;
+        uint64_t step;
+        uint64_t origin;                    // 보낸 팔로워의 세션 번호 (그 팔로워에게는 돌려보내지 않음, 0이면 리더)
+        std::string user_id;
+    };
+
+    struct Session;
+
+    MFACore& core;
+    Config config;
+    uint64_t leader_epoch;
+    std::atomic<int> http_port{0};
+    int listen_fd = -1;
+    int listen_port = 0;
+    std::thread accept_thread;
+    std::atomic<bool> stopping{false};
+
+    mutable std::mutex log_mutex;
+    std::deque<Entry> entries;              // seq가 연속인 최근 변경 (앞이 가장 오래됨)
+    uint64_t last_seq = 0;
+    std::deque<AcceptEntry> accepts;
+    uint64_t last_accept_seq = 0;
+
+    mutable std::mutex sessions_mutex;
+    std::list<std::unique_ptr<Session>> sessions;
+    uint64_t next_session_id = 1;
+    std::atomic<size_t> active_sessions{0};
+
+    uint64_t firstSeqLocked() const { return entries.empty() ? last_seq + 1 : entries.front().seq; }
+    void onMutation(WALOp op, std::string_view user_id, std::string_view secret_base32);
+    void onAccept(std::string_view user_id, uint64_t step, uint64_t origin);
+    void wakeSessions();
+    void acceptLoop();
+    void reapSessions(bool all);
+    void serve(Session& session);
+    bool sendSnapshot(Session& session);
+    bool handleFollowerFrames(Session& session, std::string& in);
+};
+
+/**
+ * @brief 복제 팔로워 (--follow)
+ *
+ * 스레드 하나가 리더에 연결해 받은 변경을 MFACore::applyReplicated로 묶어 반영하고,
+ * 반영한 (epoch, seq)를 <user_file>.replica에 남겨 다시 시작하면 거기서부터 이어 받습니다.
+ * 연결이 끊기면 REPLICATION_RETRY_MS마다 다시 연결하며, 그동안에도 가진 복제본으로 읽기 요청을 처리합니다.
+ * 이 노드에서 통과한 OTP는 리더로 보내 다른 노드의 재사용 방지 상태에도 반영되게 합니다.
+ */
+class ReplicationFollower {
+public:
+    struct Config {
+        std::string leader_host;
+        int leader_port = 0;
+        std::string position_path;          // 반영 위치 파일 (비우면 남기지 않고 매번 스냅샷부터)
+        std::string key;                    // 리더와 나눠 가진 복제 키 (MIN_KEY_BYTES 이상, 비우면 시작하지 않음)
+    };
+
+    struct Status {
+        bool connected = false;
+        uint64_t epoch = 0;                 // 따르는 리더의 epoch (0이면 아직 없음)
+        uint64_t applied_seq = 0;           // 반영한 마지막 seq
+        uint64_t leader_seq = 0;            // 리더에게서 마지막으로 들은 seq
+        double lag_seconds = 0;             // applied_seq < leader_seq 상태가 이어진 시간
+        double last_contact_seconds = -1;   // 리더에게서 마지막으로 받은 뒤 지난 시간 (-1이면 받은 적 없음)
+        uint64_t resyncs = 0;               // 스냅샷으로 다시 맞춘 횟수
+        uint64_t applied_records = 0;       // 이 프로세스가 반영한 변경 수
+    };
+
+    /**
+     * @brief 생성 시 core에 OTP 통과 통지를 연결하고 반영 위치 파일을 읽음 (core보다 오래 살아 있어야 함)
+     */
+    ReplicationFollower(MFACore& core, const Config& config);
+    ~ReplicationFollower();
+
+    ReplicationFollower(const ReplicationFollower&) = delete;
+    ReplicationFollower& operator=(const ReplicationFollower&) = delete;
+
+    /**
+     * @brief 복제 스레드 시작 (바로 반환, 리더가 없어도 성공하고 계속 다시 시도, 복제 키가 짧으면 false)
+     */
+    bool start();
+
+    /**
+     * @brief 연결을 닫고 스레드가 끝날 때까지 기다림
+     */
+    void stop();
+
+    Status status() const;
+
+    /**
+     * @brief 쓰기 요청을 돌려보낼 리더의 HTTP 주소 ("http://host:port", WELCOME을 받기 전에는 빈 문자열)
+     */
+    std::string leaderURL() const;
+
+    /**
+     * @brief "host:port" 해석 ("[::1]:port" 형식 포함)
+     */
+    static bool parseAddress(std::string_view text, std::string& host, int& port);
+
+private:
+    MFACore& core;
+    Config config;
+    std::thread thread;
+    std::atomic<bool> stopping{false};
+    std::mutex retry_mutex;
+    std::condition_variable retry_cv;
+
+    mutable std::mutex state_mutex;
+    Status state;
+    uint64_t behind_since_ns = 0;           // applied_seq < leader_seq가 된 시각 (0이면 따라잡은 상태)
+    uint64_t last_contact_ns = 0;
+    std::string leader_url;
+
+    std::mutex socket_mutex;                // 연결 fd 교체와 stop()의 shutdown 사이
+    int socket_fd = -1;
+    int wake_fd = -1;                       // 인증 스레드가 보낼 ACCEPT가 생겼음을 알림 (eventfd)
+    std::atomic<bool> wake_pending{false};
+    std::mutex outbox_mutex;
+    std::string outbox;                     // 리더로 보낼 ACCEPT 프레임
+
+    // 연결 하나를 따라가는 동안의 상태 (복제 스레드만 접근)
+    bool snapshot_active = false;
+    uint64_t snapshot_base = 0;
+    uint64_t session_epoch = 0;
+    std::string leader_nonce;               // 리더가 CHALLENGE로 보낸 nonce
+    std::string hello_nonce;                // HELLO에 담아 보낸 nonce (WELCOME의 MAC 확인용)
+    std::unordered_map<std::string, std::string> snapshot_users;
+
+    void run();
+    int connectLeader();
+    bool follow(int fd);
+    bool handleLeaderFrames(std::string& in, std::string& reply);
+    bool applySnapshot();
+    void onAccept(std::string_view user_id, uint64_t step);
+    void setApplied(uint64_t epoch, uint64_t seq, size_t records);
+    void noteLeaderSeq(uint64_t seq);
+    bool loadPosition(uint64_t& epoch, uint64_t& seq) const;
+    void savePosition(uint64_t epoch, uint64_t seq) const;
+};
+
+#endif // REPLICATION_H
@@ -0,0 +1,193 @@
+#ifndef REPLICATION_PROTOCOL_H
+#define REPLICATION_PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief 리더-팔로워 복제 프로토콜 (TCP, --replication-port / --follow)
+ *
+ * 프레임: u32 길이 | u8 종류 | 본문. 길이는 자기 자신(4바이트)을 뺀 크기이고, 모든 정수는 빅 엔디언,
+ * 문자열은 u8 길이 뒤에 바이트가 옵니다.
+ *
+ * 팔로워 → 리더
+ *   HELLO     u64 epoch | u64 적용한 seq | str 팔로워 nonce | str MAC   (CHALLENGE를 받은 뒤 한 번, 처음이면 둘 다 0)
+ *   ACK       u64 적용한 seq                   (변경 묶음을 반영할 때마다)
+ *   ACCEPT    u64 time step | str user_id      (팔로워에서 통과한 OTP, 재사용 방지 공유용)
+ *
+ * 리더 → 팔로워
+ *   CHALLENGE str 리더 nonce                  (연결 직후 한 번)
+ *   WELCOME   u64 epoch | u64 기준 seq | u8 스냅샷 여부 | u16 HTTP 포트 | u8 TLS 여부 | str MAC
+ *   SNAPSHOT  u32 사용자 수 | (str user_id | str secret)...   (스냅샷일 때만, 여러 프레임)
+ *   SNAPSHOT_END
+ *   RECORD    u64 seq | u8 op | str user_id | str secret
+ *   ACCEPT    u64 time step | str user_id
+ *   HEARTBEAT u64 리더의 마지막 seq          (보낼 변경이 없을 때 주기적으로)
+ *
+ * epoch는 리더 프로세스가 시작할 때 고르는 임의 값이고 seq는 그 리더가 등록/삭제마다 1씩 올리는 번호입니다.
+ * 팔로워가 보낸 (epoch, seq)를 리더가 최근 변경 로그에서 이어 줄 수 있으면 그 다음 RECORD부터,
+ * 아니면(리더 재시작, 로그에서 밀려남, 첫 연결) 스냅샷을 보낸 뒤 기준 seq 다음 RECORD부터 보냅니다.
+ *
+ * 양쪽은 같은 복제 키(--replication-key)를 가지며, HELLO의 MAC은
+ * HMAC-SHA256(키, "hello" | 리더 nonce | 팔로워 nonce | epoch | seq), WELCOME의 MAC은
+ * HMAC-SHA256(키, "welcome" | 팔로워 nonce | 리더 nonce | epoch | 기준 seq)입니다. 리더는 HELLO의 MAC이
+ * 맞아야 WELCOME/스냅샷을 보내고 이후 프레임을 받으며, 팔로워는 WELCOME의 MAC이 맞아야 반영을 시작합니다.
+ * 키를 모르는 상대는 연결할 수 없지만 이후 프레임은 암호화하지 않으므로 복제 포트는 내부 주소에만 엽니다.
+ */
+namespace ReplicationProtocol {
+
+    enum class FrameType : uint8_t {
+        Hello = 0x01,
+        Ack = 0x02,
+        FollowerAccept = 0x03,
+        Welcome = 0x81,
+        Snapshot = 0x82,
+        SnapshotEnd = 0x83,
+        Record = 0x84,
+        LeaderAccept = 0x85,
+        Heartbeat = 0x86,
+        Challenge = 0x87
+    };
+
+    constexpr size_t LENGTH_BYTES = 4;
+    constexpr size_t MAX_FRAME_BYTES = 1024 * 1024;     // 길이 필드 제외 (스냅샷 프레임 하나의 상한)
+    constexpr size_t SNAPSHOT_USERS_PER_FRAME = 1024;
+    constexpr size_t NONCE_BYTES = 16;
+    constexpr size_t MAC_BYTES = 32;                    // HMAC-SHA256
+    constexpr size_t MIN_KEY_BYTES = 32;
+
+    /**
+     * @brief 프레임 하나를 out 뒤에 만들어 가는 도우미 (finish()가 길이를 채움)
+     */
+    class FrameWriter {
+    public:
+        FrameWriter(std::string& out, FrameType type) : out(out), start(out.size()) {
+            out.append(LENGTH_BYTES, '\0');
+            u8(static_cast<uint8_t>(type));
+        }
+
+        FrameWriter& u8(uint8_t value) {
+            out.push_back(static_cast<char>(value));
+            return *this;
+        }
+
+        FrameWriter& u16(uint16_t value) {
+            u8(static_cast<uint8_t>(value >> 8));
+            return u8(static_cast<uint8_t>(value));
+        }
+
+        FrameWriter& u32(uint32_t value) {
+            u16(static_cast<uint16_t>(value >> 16));
+            return u16(static_cast<uint16_t>(value));
+        }
+
+        FrameWriter& u64(uint64_t value) {
+            u32(static_cast<uint32_t>(value >> 32));
+            return u32(static_cast<uint32_t>(value));
+        }
+
+        // 255바이트를 넘는 문자열은 잘림 (user_id/시크릿은 저장소 상한이 그보다 작음)
+        FrameWriter& str(std::string_view value) {
+            size_t length = value.size() < 255 ? value.size() : 255;
+            u8(static_cast<uint8_t>(length));
+            out.append(value.data(), length);
+            return *this;
+        }
+
+        // 앞에서 쓴 u32 자리를 나중에 채울 때 (스냅샷 사용자 수)
+        size_t offset() const { return out.size(); }
+
+        void patchU32(size_t at, uint32_t value) {
+            out[at] = static_cast<char>(value >> 24);
+            out[at + 1] = static_cast<char>(value >> 16);
+            out[at + 2] = static_cast<char>(value >> 8);
+            out[at + 3] = static_cast<char>(value);
+        }
+
+        void finish() {
+            patchU32(start, static_cast<uint32_t>(out.size() - start - LENGTH_BYTES));
+        }
+
+    private:
+        std::string& out;
+        size_t start;
+    };
+
+    /**
+     * @brief 프레임 본문 읽기 도우미 (범위를 넘으면 ok()가 false가 되고 이후 값은 0/빈 문자열)
+     */
+    class FrameReader {
+    public:
+        FrameReader(const char* data, size_t size) : p(reinterpret_cast<const unsigned char*>(data)), left(size) {}
+
+        uint8_t u8() {
+            if (left < 1) return fail();
+            left--;
+            return *p++;
+        }
+
+        uint16_t u16() {
+            uint16_t high = u8();
+            return static_cast<uint16_t>((high << 8) | u8());
+        }
+
+        uint32_t u32() {
+            uint32_t high = u16();
+            return (high << 16) | u16();
+        }
+
+        uint64_t u64() {
+            uint64_t high = u32();
+            return (high << 32) | u32();
+        }
+
+        std::string_view str() {
+            size_t length = u8();
+            if (left < length) {
+                fail();
+                return {};
+            }
+            std::string_view value(reinterpret_cast<const char*>(p), length);
+            p += length;
+            left -= length;
+            return value;
+        }
+
+        bool ok() const { return valid; }
+        bool atEnd() const { return valid && left == 0; }
+
+    private:
+        const unsigned char* p;
+        size_t left;
+        bool valid = true;
+
+        uint8_t fail() {
+            valid = false;
+            left = 0;
+            return 0;
+        }
+    };
+
+    /**
+     * @brief 버퍼 앞의 프레임 하나 찾기
+     * @param type 프레임 종류
+     * @param body 본문 (data를 가리킴)
+     * @param consumed 프레임 전체 크기
+     * @return 완성된 프레임이 있으면 1, 더 받아야 하면 0, 길이가 범위를 벗어나면 -1
+     */
+    inline int nextFrame(const char* data, size_t size, FrameType& type, std::string_view& body, size_t& consumed) {
+        if (size < LENGTH_BYTES) return 0;
+        const auto* p = reinterpret_cast<const unsigned char*>(data);
+        size_t length = (size_t(p[0]) << 24) | (size_t(p[1]) << 16) | (size_t(p[2]) << 8) | size_t(p[3]);
+        if (length < 1 || length > MAX_FRAME_BYTES) return -1;
+        if (size < LENGTH_BYTES + length) return 0;
+        type = static_cast<FrameType>(p[LENGTH_BYTES]);
+        body = std::string_view(data + LENGTH_BYTES + 1, length - 1);
+        consumed = LENGTH_BYTES + length;
+        return 1;
+    }
+}
+
+#endif // REPLICATION_PROTOCOL_H
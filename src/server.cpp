@@ -1,9 +1,24 @@
 #include "server.h"
+#include "logger.h"
+#include "json_reader.h"
+#include "json_writer.h"
+#include "user_io.h"
+#include "metrics.h"
+#include "worker_pool.h"
+#include "replication_protocol.h"
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <memory>
 #include <map>
-#include <sstream>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <regex>
+#include <thread>
+#include <sys/socket.h>
 
 // cpp-httplib 사용 여부 확인
 #if __has_include(<httplib.h>)
@@ -19,6 +34,19 @@
             std::string body; 
             std::string method;
             std::string path;
+            std::string remote_addr;
+            std::string target;
+            
+            bool has_param(const std::string& key) const { (void)key; return false; }
+            std::string get_param_value(const std::string& key) const { (void)key; return ""; }
+        };
+        struct ContentReader {
+            template<typename Receiver>
+            bool operator()(Receiver receiver) const { (void)receiver; return false; }
+        };
+        struct DataSink {
+            std::function<bool(const char* data, size_t size)> write;
+            std::function<void()> done;
         };
         struct Response { 
             int status = 200;
@@ -27,9 +55,16 @@
             void set_content(const std::string& content, const std::string& type) {
                 (void)content; (void)type; // unused warning 방지
             }
+            void set_content(const char* data, size_t size, const std::string& type) {
+                (void)data; (void)size; (void)type; // unused warning 방지
+            }
             void set_header(const std::string& key, const std::string& value) {
                 headers[key] = value;
             }
+            template<typename Provider, typename Releaser>
+            void set_chunked_content_provider(const std::string& type, Provider provider, Releaser releaser) {
+                (void)type; (void)provider; (void)releaser; // unused warning 방지
+            }
         };
         class Server {
         public:
@@ -53,11 +88,334 @@
     }
 #endif
 
-MFAServer::MFAServer(int port, const std::string& cert_path, const std::string& key_path, const std::string& user_file) 
-    : port(port), cert_path(cert_path), key_path(key_path) {
+#ifdef HTTPLIB_AVAILABLE
+    #include "event_server.h"
+#endif
+
+/**
+ * @brief 라우트 하나 (httplib 등록과 이벤트 리스너 디스패치가 같은 표를 사용)
+ */
+struct MFAServer::RouteEntry {
+    const char* method;
+    const char* pattern;
+    std::regex regex;
+    Metrics::Route metric;
+    std::function<void(const httplib::Request&, httplib::Response&, const httplib::ContentReader*)> handler;
+    bool reads_content;                 // 본문을 ContentReader로 나눠 읽는 라우트
+};
+
+namespace {
+
+    constexpr size_t REQUEST_SCRATCH_SIZE = 1024;         // 이스케이프된 필드 디코딩용 (요청당 스택 버퍼)
+    constexpr size_t BATCH_BYTES_PER_ITEM = 256;          // 일괄 요청 본문 크기 상한 계산용
+    constexpr std::string_view REGISTER_FIELDS[] = {"user_id", "qr"};
+    constexpr std::string_view AUTH_FIELDS[] = {"user_id", "otp_code"};
+
+    constexpr size_t CURSOR_HEX_DIGITS = 16;
+
+    // 목록 커서: 저장소 위치(uint64)를 16자리 소문자 16진수로 표현
+    bool parseCursor(std::string_view text, uint64_t& cursor) {
+        if (text.size() != CURSOR_HEX_DIGITS) return false;
+        cursor = 0;
+        for (char c : text) {
+            int digit;
+            if (c >= '0' && c <= '9') digit = c - '0';
+            else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+            else return false;
+            cursor = (cursor << 4) | static_cast<uint64_t>(digit);
+        }
+        return true;
+    }
+
+    std::string_view formatCursor(uint64_t cursor, char (&digits)[CURSOR_HEX_DIGITS]) {
+        static const char hex[] = "0123456789abcdef";
+        for (size_t i = CURSOR_HEX_DIGITS; i-- > 0; cursor >>= 4) {
+            digits[i] = hex[cursor & 0xF];
+        }
+        return std::string_view(digits, CURSOR_HEX_DIGITS);
+    }
+
+    // 1 이상 max 이하의 10진수
+    bool parseLimit(std::string_view text, size_t max, size_t& limit) {
+        if (text.empty() || text.size() > 6) return false;
+        limit = 0;
+        for (char c : text) {
+            if (c < '0' || c > '9') return false;
+            limit = limit * 10 + static_cast<size_t>(c - '0');
+        }
+        return limit >= 1 && limit <= max;
+    }
+
+    int statusForParseError(Json::Error error) {
+        return error == Json::Error::TooLarge ? 413 : 400;
+    }
+
+    // 헤더 이름/값과 정적 응답 본문은 요청마다 임시 문자열을 만들지 않도록 미리 생성
+    const std::string JSON_CONTENT_TYPE = "application/json";
+    const std::string CORS_ALLOW_ORIGIN = "Access-Control-Allow-Origin";
+    const std::string CORS_ANY_ORIGIN = "*";
+    const std::string CACHE_CONTROL_HEADER = "Cache-Control";
+    const std::string NO_STORE = "no-store";          // 시크릿이 담긴 QR 이미지는 중간 캐시에 남기지 않음
+    const std::string CONTENT_TYPE_HEADER = "Content-Type";
+    const std::string IMPORT_COUNT_HEADERS[] = {"X-Import-Created", "X-Import-Exists", "X-Import-Invalid",
+                                                "X-Import-Failed"};     // ImportStatus 순서
+
+    constexpr std::string_view AUTH_SUCCESS_BODY = "{\"success\": true, \"message\": \"Authentication successful\"}";
+    constexpr std::string_view AUTH_FAILURE_BODY = "{\"success\": false, \"message\": \"Authentication failed\"}";
+    constexpr std::string_view HEALTH_BODY = "{\"status\": \"healthy\", \"service\": \"mfa-server\"}";
+    constexpr std::string_view RATE_LIMITED_BODY = "{\"success\": false, \"error\": \"Too many authentication attempts\"}";
+    const std::string RETRY_AFTER_HEADER = "Retry-After";
+    constexpr std::string_view INTERNAL_ERROR_BODY = "{\"success\": false, \"error\": \"Internal server error\"}";
+    const std::string METRICS_CONTENT_TYPE = "text/plain; version=0.0.4; charset=utf-8";
+
+    // 요청 처리 스레드의 지표 상태 (httplib는 요청 하나를 한 스레드에서 끝까지 처리하므로
+    // 라우팅 전 훅에서 시작 시각을, 라우트 핸들러에서 라우트를 남기고 응답을 보낸 뒤 로거 훅에서 기록)
+    struct RequestMetrics {
+        uint64_t start_ns = 0;
+        Metrics::Route route = Metrics::Route::Other;
+    };
+    thread_local RequestMetrics request_metrics;
+
+    // 지금 처리 중인 요청이 다른 노드가 내부 리스너로 보낸 것인지 (다시 넘기지 않고, 시도 제한은 사용자 버킷만)
+    // 내부 리스너가 클러스터 키를 확인한 요청에만 켜짐
+    thread_local bool cluster_request = false;
+
+#ifdef HTTPLIB_AVAILABLE
+    // 응답을 보낸 뒤 이 스레드의 요청 지표 기록
+    void recordRequestMetrics(const httplib::Response& res) {
+        if (request_metrics.start_ns == 0) return;
+        Metrics::recordRequest(request_metrics.route, res.status, Metrics::nowNs() - request_metrics.start_ns);
+        request_metrics.start_ns = 0;
+    }
+
+    // httplib 기본값과 같은 작업 스레드 수
+    size_t defaultWorkerThreads() {
+        unsigned int cores = std::thread::hardware_concurrency();
+        return std::max(8u, cores > 0 ? cores - 1 : 0u);
+    }
+
+    /**
+     * @brief httplib 작업 큐 어댑터 (WorkerPool + 대기 연결 수/거절 지표)
+     *
+     * enqueue()가 false면 httplib가 그 연결을 바로 닫습니다 (대기열 상한 초과).
+     */
+    class WorkerTaskQueue : public httplib::TaskQueue {
+    public:
+        explicit WorkerTaskQueue(const ServerTuning& tuning)
+            : pool(tuning.worker_threads > 0 ? tuning.worker_threads : defaultWorkerThreads(), tuning.max_queued,
+                   tuning.pin_workers) {
+            if (tuning.pin_workers) {
+                MFA_LOG_INFO("SERVER", "작업 스레드 " << pool.threadCount() << "개 시작 (CPU 고정)");
+            }
+        }
+
+        bool enqueue(std::function<void()> fn) override {
+            Metrics::addQueueDepth(1);
+            bool queued = pool.submit([fn = std::move(fn)]() {
+                Metrics::addQueueDepth(-1);
+                fn();
+            });
+            if (!queued) {
+                Metrics::addQueueDepth(-1);
+                Metrics::addQueueRejected();
+            }
+            return queued;
+        }
+
+        void shutdown() override { pool.shutdown(); }
+
+    private:
+        WorkerPool pool;
+    };
+#endif
+
+    // 10진수 정수 (min 이상 max 이하)
+    template <typename T>
+    bool parseNumber(std::string_view text, T min, T max, T& value) {
+        T parsed{};
+        auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), parsed);
+        if (ec != std::errc() || end != text.data() + text.size() || parsed < min || parsed > max) return false;
+        value = parsed;
+        return true;
+    }
+
+    bool parseSwitch(std::string_view text, bool& value) {
+        if (text == "on" || text == "1" || text == "true") value = true;
+        else if (text == "off" || text == "0" || text == "false") value = false;
+        else return false;
+        return true;
+    }
+
+    // 노드끼리 나눠 가진 키 파일 (내용 전체가 키, min_bytes 이상)
+    bool readKeyFile(const std::string& path, size_t min_bytes, std::string& key, std::string& error) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            error = "키 파일을 열 수 없습니다: " + path;
+            return false;
+        }
+        key.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        if (key.size() < min_bytes) {
+            error = "키 파일이 너무 짧습니다 (" + std::to_string(min_bytes) + "바이트 이상): " + path;
+            return false;
+        }
+        return true;
+    }
+
+    // 배치 요청 본문의 "items" 배열에서 {user_id, otp_code} 객체들을 추출
+    // max_items를 넘으면 나머지는 읽지 않고 max_items + 1개까지만 담음
+    Json::Error parseBatchItems(std::string_view body, size_t max_items, std::vector<AuthItem>& items,
+                                bool& has_items) {
+        Json::Limits limits;
+        limits.max_bytes = std::max(limits.max_bytes, max_items * BATCH_BYTES_PER_ITEM);
+        Json::Tokenizer tokenizer(body, limits);
+        has_items = false;
+
+        Json::Token token = tokenizer.next();
+        if (token != Json::Token::ObjectBegin) {
+            return token == Json::Token::Error ? tokenizer.error() : Json::Error::NotObject;
+        }
+
+        char scratch[REQUEST_SCRATCH_SIZE];
+        for (;;) {
+            token = tokenizer.next();
+            if (token == Json::Token::ObjectEnd) break;
+            if (token != Json::Token::Key) return tokenizer.error();
+
+            std::string_view key;
+            if (!Json::unescape(tokenizer.text(), scratch, sizeof(scratch), key) || key != "items") {
+                if (!tokenizer.skipValue()) return tokenizer.error();
+                continue;
+            }
+
+            if (tokenizer.peek() != Json::Token::ArrayBegin) {
+                if (!tokenizer.skipValue()) return tokenizer.error();
+                continue;
+            }
+            tokenizer.next();
+            has_items = true;
+            items.clear();
+
+            while (tokenizer.peek() != Json::Token::ArrayEnd) {
+                std::string_view fields[2];
+                Json::Error error = Json::readStringFields(tokenizer, AUTH_FIELDS, fields, nullptr, 2,
+                                                           scratch, sizeof(scratch));
+                if (error != Json::Error::None) return error;
+
+                items.push_back(AuthItem{std::string(fields[0]), std::string(fields[1])});
+                if (items.size() > max_items) {
+                    return Json::Error::None;   // 호출자가 413으로 응답
+                }
+            }
+            tokenizer.next();
+        }
+
+        if (tokenizer.next() != Json::Token::End) {
+            return tokenizer.error();
+        }
+        return Json::Error::None;
+    }
+
+    // 클러스터 목록 커서: 링의 노드 순서대로 노드별 커서(16자리 16진수, 다 읽은 노드는 "x")를 '-'로 이음
+    constexpr std::string_view CLUSTER_CURSOR_DONE = "x";
+    constexpr std::string_view SHARD_UNAVAILABLE = "Shard unavailable";
+
+    bool parseClusterCursor(std::string_view text, size_t nodes, std::vector<std::string>& cursors) {
+        cursors.clear();
+        for (size_t i = 0; i < nodes; i++) {
+            size_t dash = text.find('-');
+            if ((dash == std::string_view::npos) != (i + 1 == nodes)) return false;
+            std::string_view part = text.substr(0, dash);
+            uint64_t cursor = 0;
+            if (part != CLUSTER_CURSOR_DONE && !parseCursor(part, cursor)) return false;
+            cursors.emplace_back(part);
+            text = dash == std::string_view::npos ? std::string_view() : text.substr(dash + 1);
+        }
+        return true;
+    }
+
+    std::string formatClusterCursor(const std::vector<std::string>& cursors) {
+        std::string text;
+        for (const std::string& cursor : cursors) {
+            if (!text.empty()) text += '-';
+            text += cursor;
+        }
+        return text;
+    }
+
+    std::string encodeQueryValue(std::string_view value) {
+        static const char HEX[] = "0123456789ABCDEF";
+        std::string out;
+        for (unsigned char c : value) {
+            bool plain = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+                         c == '-' || c == '_' || c == '.' || c == '~';
+            if (plain) {
+                out += static_cast<char>(c);
+            } else {
+                out += '%';
+                out += HEX[c >> 4];
+                out += HEX[c & 15];
+            }
+        }
+        return out;
+    }
+
+    // 다른 노드의 GET /api/users 응답에서 사용자와 next_cursor 추출
+    bool parseUserPage(std::string_view body, std::vector<std::string>& users, std::string& next_cursor) {
+        Json::Limits limits;
+        limits.max_bytes = std::max(limits.max_bytes, body.size());
+        Json::Tokenizer tokenizer(body, limits);
+        if (tokenizer.next() != Json::Token::ObjectBegin) return false;
+
+        char scratch[REQUEST_SCRATCH_SIZE];
+        next_cursor.clear();
+        for (;;) {
+            Json::Token token = tokenizer.next();
+            if (token == Json::Token::ObjectEnd) break;
+            if (token != Json::Token::Key) return false;
+            std::string_view key = tokenizer.text();
+            if (key == "users") {
+                if (tokenizer.next() != Json::Token::ArrayBegin) return false;
+                while ((token = tokenizer.next()) == Json::Token::String) {
+                    std::string_view user_id;
+                    if (!Json::unescape(tokenizer.text(), scratch, sizeof(scratch), user_id)) return false;
+                    users.emplace_back(user_id);
+                }
+                if (token != Json::Token::ArrayEnd) return false;
+            } else if (key == "next_cursor") {
+                token = tokenizer.next();
+                if (token == Json::Token::String) next_cursor.assign(tokenizer.text());
+                else if (token != Json::Token::Null) return false;
+            } else if (!tokenizer.skipValue()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 넘겨받은 응답에서 그대로 옮기지 않는 헤더 (연결 단위 헤더, 본문과 함께 다시 정해지는 헤더)
+    bool isHopByHopHeader(std::string_view name) {
+        static constexpr std::string_view SKIPPED[] = {"connection", "keep-alive", "transfer-encoding",
+                                                       "content-length", "content-type", "x-mfa-ring"};
+        for (std::string_view skipped : SKIPPED) {
+            if (skipped.size() != name.size()) continue;
+            bool same = true;
+            for (size_t i = 0; i < name.size() && same; i++) {
+                char c = name[i];
+                if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+                same = c == skipped[i];
+            }
+            if (same) return true;
+        }
+        return false;
+    }
+}
+
+MFAServer::MFAServer(int port, const std::string& cert_path, const std::string& key_path, const std::string& user_file,
+                     StorageMode storage_mode) 
+    : user_file(user_file), port(port), cert_path(cert_path), key_path(key_path) {
     
     // MFA 코어 초기화
-    mfa_core = std::make_unique<MFACore>(user_file);
+    mfa_core = std::make_unique<MFACore>(user_file, storage_mode);
     
     // SSL 사용 여부 결정
     use_ssl = !cert_path.empty() && !key_path.empty();
@@ -83,8 +441,218 @@ MFAServer::MFAServer(int port, const std::string& cert_path, const std::string&
     std::cout << "경고: cpp-httplib이 설치되지 않았습니다. 더미 모드로 실행됩니다." << std::endl;
 #endif
     
+    setRateLimits(DEFAULT_USER_RATE_LIMIT, DEFAULT_IP_RATE_LIMIT);
+    
     setupRoutes();
     setupErrorHandlers();
+    setupMetrics();
+}
+
+void MFAServer::setRateLimits(const RateLimit& user_limit, const RateLimit& ip_limit) {
+    if (user_limit.enabled() || ip_limit.enabled()) {
+        rate_limiter = std::make_unique<RateLimiter>(user_limit, ip_limit);
+    } else {
+        rate_limiter.reset();
+    }
+}
+
+bool ServerTuning::isOption(std::string_view name) {
+    static constexpr std::string_view OPTIONS[] = {
+        "--listener", "--event-threads", "--workers", "--max-queue", "--pin-workers", "--keep-alive-max", "--keep-alive-timeout",
+        "--read-timeout", "--write-timeout", "--backlog", "--tcp-nodelay", "--tls-tickets", "--tls-ticket-key",
+        "--tls-ticket-rotation", "--tls-session-cache", "--tls-session-timeout", "--tls-ciphers",
+        "--tls-ciphersuites", "--tls-groups", "--tls-ktls", "--ecdsa-cert", "--ecdsa-key", "--binary-port",
+        "--binary-socket", "--binary-threads", "--replication-port", "--replication-log", "--replication-key",
+        "--replication-bind", "--follow", "--leader-url", "--cluster", "--node-id", "--cluster-key", "--cluster-vnodes",
+        "--cluster-threads", "--cluster-forward-threads"
+    };
+    return std::find(std::begin(OPTIONS), std::end(OPTIONS), name) != std::end(OPTIONS);
+}
+
+bool ServerTuning::parseOption(std::string_view name, std::string_view value, ServerTuning& tuning,
+                               std::string& error) {
+    constexpr time_t MAX_TIMEOUT_SEC = 3600;
+    bool ok = false;
+    const char* what = "";
+    if (name == "--listener") {
+        what = "리스너 방식";
+        ok = value == "threads" || value == "epoll";
+        if (ok) tuning.listener = value == "epoll" ? ListenerMode::Epoll : ListenerMode::Threads;
+    } else if (name == "--event-threads") {
+        what = "리액터 스레드 수";
+        ok = parseNumber<size_t>(value, 1, 1024, tuning.event_threads);
+    } else if (name == "--workers") {
+        what = "작업 스레드 수";
+        ok = parseNumber<size_t>(value, 1, 4096, tuning.worker_threads);
+    } else if (name == "--max-queue") {
+        what = "대기 연결 상한";
+        ok = parseNumber<size_t>(value, 0, 1000000, tuning.max_queued);
+    } else if (name == "--pin-workers") {
+        what = "CPU 고정 여부";
+        ok = parseSwitch(value, tuning.pin_workers);
+    } else if (name == "--keep-alive-max") {
+        what = "keep-alive 최대 요청 수";
+        ok = parseNumber<size_t>(value, 1, 1000000, tuning.keep_alive_max_count);
+    } else if (name == "--keep-alive-timeout") {
+        what = "keep-alive 유지 시간";
+        ok = parseNumber<time_t>(value, 1, MAX_TIMEOUT_SEC, tuning.keep_alive_timeout_sec);
+    } else if (name == "--read-timeout") {
+        what = "읽기 제한 시간";
+        ok = parseNumber<time_t>(value, 1, MAX_TIMEOUT_SEC, tuning.read_timeout_sec);
+    } else if (name == "--write-timeout") {
+        what = "쓰기 제한 시간";
+        ok = parseNumber<time_t>(value, 1, MAX_TIMEOUT_SEC, tuning.write_timeout_sec);
+    } else if (name == "--backlog") {
+        what = "수락 대기열 길이";
+        ok = parseNumber<int>(value, 1, 65535, tuning.listen_backlog);
+    } else if (name == "--tcp-nodelay") {
+        what = "TCP_NODELAY 여부";
+        ok = parseSwitch(value, tuning.tcp_nodelay);
+    } else if (name == "--tls-tickets") {
+        what = "세션 티켓 사용 여부";
+        ok = parseSwitch(value, tuning.tls.tickets);
+    } else if (name == "--tls-ticket-rotation") {
+        what = "티켓 키 회전 주기";
+        ok = parseNumber<uint32_t>(value, 0, 7 * 24 * 3600, tuning.tls.ticket_rotation_sec);
+    } else if (name == "--tls-session-cache") {
+        what = "세션 캐시 크기";
+        ok = parseNumber<size_t>(value, 0, 10000000, tuning.tls.session_cache_size);
+    } else if (name == "--tls-session-timeout") {
+        what = "세션 수명";
+        ok = parseNumber<uint32_t>(value, 1, 7 * 24 * 3600, tuning.tls.session_timeout_sec);
+    } else if (name == "--tls-ktls") {
+        what = "kTLS 사용 여부";
+        ok = parseSwitch(value, tuning.tls.ktls);
+    } else if (name == "--binary-port") {
+        what = "바이너리 프로토콜 포트";
+        ok = parseNumber<int>(value, 0, 65535, tuning.binary_port);
+    } else if (name == "--binary-socket") {
+        what = "바이너리 프로토콜 소켓 경로";
+        ok = !value.empty();
+        if (ok) tuning.binary_socket.assign(value);
+    } else if (name == "--binary-threads") {
+        what = "바이너리 리액터 스레드 수";
+        ok = parseNumber<size_t>(value, 1, 1024, tuning.binary_threads);
+    } else if (name == "--replication-port") {
+        what = "복제 포트";
+        ok = parseNumber<int>(value, 0, 65535, tuning.replication_port);
+    } else if (name == "--replication-log") {
+        what = "복제 로그 길이";
+        ok = parseNumber<size_t>(value, 1024, 100000000, tuning.replication_log_entries);
+    } else if (name == "--replication-key") {
+        what = "복제 키 파일";
+        ok = !value.empty();
+        if (ok) tuning.replication_key_file.assign(value);
+    } else if (name == "--replication-bind") {
+        what = "복제 포트 주소";
+        ok = !value.empty();
+        if (ok) tuning.replication_bind.assign(value);
+    } else if (name == "--follow") {
+        what = "리더 복제 주소";
+        std::string host;
+        int leader_port = 0;
+        ok = ReplicationFollower::parseAddress(value, host, leader_port);
+        if (ok) tuning.follow.assign(value);
+    } else if (name == "--leader-url") {
+        what = "리더 주소";
+        ok = value.rfind("http://", 0) == 0 || value.rfind("https://", 0) == 0;
+        if (ok) tuning.leader_url.assign(value);
+    } else if (name == "--cluster") {
+        what = "클러스터 노드 목록";
+        ok = HashRing::parseNodes(value, tuning.cluster_nodes);
+    } else if (name == "--node-id") {
+        what = "노드 id";
+        ok = !value.empty();
+        if (ok) tuning.node_id.assign(value);
+    } else if (name == "--cluster-key") {
+        what = "클러스터 키 파일";
+        ok = !value.empty();
+        if (ok) tuning.cluster_key_file.assign(value);
+    } else if (name == "--cluster-vnodes") {
+        what = "가상 노드 수";
+        ok = parseNumber<size_t>(value, 1, 4096, tuning.cluster_vnodes);
+    } else if (name == "--cluster-threads") {
+        what = "내부 리스너 리액터 스레드 수";
+        ok = parseNumber<size_t>(value, 1, 1024, tuning.cluster_threads);
+    } else if (name == "--cluster-forward-threads") {
+        what = "노드 간 요청 작업 스레드 수";
+        ok = parseNumber<size_t>(value, 1, 1024, tuning.cluster_forward_threads);
+    } else if (name == "--tls-ticket-key" || name == "--tls-ciphers" || name == "--tls-ciphersuites" ||
+               name == "--tls-groups" || name == "--ecdsa-cert" || name == "--ecdsa-key") {
+        // 문자열 값 (내용은 서버 시작 시 OpenSSL이 검사)
+        std::string* target = name == "--tls-ticket-key"     ? &tuning.tls.ticket_key_file
+                              : name == "--tls-ciphers"      ? &tuning.tls.ciphers
+                              : name == "--tls-ciphersuites" ? &tuning.tls.ciphersuites
+                              : name == "--tls-groups"       ? &tuning.tls.groups
+                              : name == "--ecdsa-cert"       ? &tuning.tls.ecdsa_cert_path
+                                                             : &tuning.tls.ecdsa_key_path;
+        what = "TLS 설정";
+        ok = !value.empty();
+        if (ok) target->assign(value);
+    } else {
+        return false;
+    }
+    if (!ok) {
+        error = std::string("유효하지 않은 ") + what + ": " + std::string(value);
+    }
+    return ok;
+}
+
+void ServerTuning::printUsage(std::ostream& out) {
+    ServerTuning defaults;
+    out << "  --listener threads|epoll  연결 처리 방식: 연결마다 작업 스레드(threads) 또는 epoll 리액터(epoll)"
+        << " (기본값: threads)" << std::endl;
+    out << "  --event-threads <수> epoll 리액터 스레드 수 (기본값: 코어 수)" << std::endl;
+    out << "  --workers <수>       HTTP 작업 스레드 수 (기본값: max(8, 코어 수 - 1))" << std::endl;
+    out << "  --max-queue <수>     작업 스레드를 기다릴 연결 상한, 넘으면 바로 닫음 (기본값: 0 = 제한 없음)" << std::endl;
+    out << "  --pin-workers on|off 작업 스레드를 CPU에 하나씩 고정 (기본값: off)" << std::endl;
+    out << "  --keep-alive-max <수>     연결 하나로 처리할 최대 요청 수 (기본값: "
+        << defaults.keep_alive_max_count << ")" << std::endl;
+    out << "  --keep-alive-timeout <초> 요청 사이 연결 유지 시간 (기본값: " << defaults.keep_alive_timeout_sec << ")"
+        << std::endl;
+    out << "  --read-timeout <초>  요청 읽기 제한 시간 (기본값: " << defaults.read_timeout_sec << ")" << std::endl;
+    out << "  --write-timeout <초> 응답 쓰기 제한 시간 (기본값: " << defaults.write_timeout_sec << ")" << std::endl;
+    out << "  --backlog <수>       수락 대기열 길이, net.core.somaxconn이 상한 (기본값: "
+        << defaults.listen_backlog << ")" << std::endl;
+    out << "  --tcp-nodelay on|off 응답 전송 시 Nagle 알고리즘 끄기 (기본값: off)" << std::endl;
+    out << "  --tls-tickets on|off 세션 티켓으로 재연결 시 핸드셰이크 단축 (기본값: on)" << std::endl;
+    out << "  --tls-ticket-key <파일>   티켓 마스터 키, 32바이트 이상 (인스턴스끼리 공유, 기본값: 시작 시 무작위)"
+        << std::endl;
+    out << "  --tls-ticket-rotation <초> 티켓 키 회전 주기, 0이면 회전 안 함 (기본값: "
+        << defaults.tls.ticket_rotation_sec << ")" << std::endl;
+    out << "  --tls-session-cache <수>  서버 세션 캐시 항목 수, 0이면 끔 (기본값: " << defaults.tls.session_cache_size
+        << ")" << std::endl;
+    out << "  --tls-session-timeout <초> 세션 재개 가능 시간 (기본값: " << defaults.tls.session_timeout_sec << ")"
+        << std::endl;
+    out << "  --tls-ciphers <목록>      TLS 1.2 암호 목록 (기본값: AES-GCM 우선, ChaCha20)" << std::endl;
+    out << "  --tls-ciphersuites <목록> TLS 1.3 암호 목록 (기본값: " << TLS::DEFAULT_CIPHERSUITES << ")" << std::endl;
+    out << "  --tls-groups <목록>       키 교환 곡선 (기본값: " << TLS::DEFAULT_GROUPS << ")" << std::endl;
+    out << "  --ecdsa-cert <파일>, --ecdsa-key <파일>  기본 인증서와 함께 둘 ECDSA 인증서/키" << std::endl;
+    out << "  --tls-ktls on|off    레코드 암호화를 커널 TLS로 넘기기 (기본값: off)" << std::endl;
+    out << "  --binary-port <포트>      바이너리 검증 프로토콜 TCP 포트 (기본값: 0 = 끔)" << std::endl;
+    out << "  --binary-socket <경로>    바이너리 검증 프로토콜 Unix 소켓 (기본값: 끔)" << std::endl;
+    out << "  --binary-threads <수>     바이너리 리스너 리액터 스레드 수 (기본값: " << defaults.binary_threads << ")"
+        << std::endl;
+    out << "  --replication-port <포트> 복제 리더로 동작, 팔로워 연결을 받을 포트 (기본값: 0 = 끔)" << std::endl;
+    out << "  --replication-log <수>    팔로워가 스냅샷 없이 이어 받을 수 있는 최근 변경 수 (기본값: "
+        << defaults.replication_log_entries << ")" << std::endl;
+    out << "  --replication-key <파일>  리더와 팔로워가 나눠 가진 복제 키, "
+        << ReplicationProtocol::MIN_KEY_BYTES << "바이트 이상 (복제를 쓰면 필수)" << std::endl;
+    out << "  --replication-bind <주소> 복제 포트를 열 주소 (기본값: " << defaults.replication_bind << ")" << std::endl;
+    out << "  --follow <host:port>      읽기 전용 팔로워로 동작, 리더의 복제 포트에 연결" << std::endl;
+    out << "  --leader-url <URL>        팔로워가 쓰기 요청을 돌려보낼 리더 주소 (기본값: 리더가 알려 준 HTTP 포트)"
+        << std::endl;
+    out << "  --cluster <id=host:port,...> 일관 해시 샤딩 클러스터의 노드와 내부 리스너 주소 (자기 자신 포함)"
+        << std::endl;
+    out << "  --node-id <id>            --cluster에서 이 노드의 id (없으면 사용자를 맡지 않고 요청만 넘기는 라우터)"
+        << std::endl;
+    out << "  --cluster-key <파일>      노드끼리 나눠 가진 클러스터 키, " << CLUSTER_MIN_KEY_BYTES
+        << "바이트 이상 (--cluster를 쓰면 필수)" << std::endl;
+    out << "  --cluster-vnodes <수>     노드당 가상 노드 수 (기본값: " << defaults.cluster_vnodes << ")" << std::endl;
+    out << "  --cluster-threads <수>    내부 리스너 리액터 스레드 수 (기본값: " << defaults.cluster_threads << ")"
+        << std::endl;
+    out << "  --cluster-forward-threads <수> 다른 노드를 기다리는 요청을 epoll/바이너리 리스너 대신 처리할 작업 스레드 수 (기본값: "
+        << defaults.cluster_forward_threads << ")" << std::endl;
 }
 
 MFAServer::~MFAServer() {
@@ -92,6 +660,47 @@ MFAServer::~MFAServer() {
 }
 
 void MFAServer::setupRoutes() {
+    // 라우트 표 (httplib 등록과 이벤트 리스너 디스패치가 같이 사용)
+    auto route = [this](const char* method, const char* pattern, Metrics::Route metric,
+                        void (MFAServer::*handler)(const httplib::Request&, httplib::Response&)) {
+        routes.push_back(RouteEntry{method, pattern, std::regex(pattern), metric,
+                                    [this, handler](const httplib::Request& req, httplib::Response& res,
+                                                    const httplib::ContentReader*) { (this->*handler)(req, res); },
+                                    false});
+    };
+    
+    // API 라우트 설정
+    route("POST", "/api/register", Metrics::Route::Register, &MFAServer::handleRegister);
+    route("POST", "/api/authenticate", Metrics::Route::Authenticate, &MFAServer::handleAuthenticate);
+    route("POST", "/api/authenticate/batch", Metrics::Route::AuthenticateBatch, &MFAServer::handleAuthenticateBatch);
+    routes.push_back(RouteEntry{"POST", "/api/users/bulk", std::regex("/api/users/bulk"), Metrics::Route::BulkImport,
+                                [this](const httplib::Request& req, httplib::Response& res,
+                                       const httplib::ContentReader* content_reader) {
+                                    handleBulkImport(req, res, *content_reader);
+                                },
+                                true});
+    route("DELETE", "/api/user/(.+)", Metrics::Route::Delete, &MFAServer::handleDelete);
+    route("GET", "/api/users", Metrics::Route::List, &MFAServer::handleList);
+    route("GET", "/api/qr/(.+)", Metrics::Route::QRCode, &MFAServer::handleQRCode);
+    route("GET", "/metrics", Metrics::Route::Metrics, &MFAServer::handleMetrics);
+    route("GET", "/health", Metrics::Route::Health, &MFAServer::handleHealth);
+    route("GET", "/api/replication", Metrics::Route::Replication, &MFAServer::handleReplication);
+    route("GET", "/api/cluster", Metrics::Route::Cluster, &MFAServer::handleCluster);
+    route("POST", "/api/cluster/nodes", Metrics::Route::Cluster, &MFAServer::handleClusterJoin);
+    // 노드 간 요청 (내부 리스너에서만 처리, 공개 포트에서는 404)
+    route("GET", "/api/cluster/(ring|migration)", Metrics::Route::Cluster, &MFAServer::handleClusterInternal);
+    route("POST", "/api/cluster/(prepare|commit|abort|transfer|verify|import)", Metrics::Route::Cluster,
+          &MFAServer::handleClusterInternal);
+    
+    // CORS 프리플라이트 요청 처리
+    routes.push_back(RouteEntry{"OPTIONS", ".*", std::regex(".*"), Metrics::Route::Options,
+                                [this](const httplib::Request& req, httplib::Response& res,
+                                       const httplib::ContentReader*) {
+                                    (void)req; // unused parameter warning 방지
+                                    setupCORS(res);
+                                },
+                                false});
+
 #ifdef HTTPLIB_AVAILABLE
     httplib::Server* server = nullptr;
     
@@ -103,36 +712,80 @@ void MFAServer::setupRoutes() {
     
     if (!server) return;
     
-    // API 라우트 설정
-    server->Post("/api/register", [this](const httplib::Request& req, httplib::Response& res) {
-        handleRegister(req, res);
-    });
+    for (const RouteEntry& entry : routes) {
+        const RouteEntry* target = &entry;
+        if (entry.reads_content) {
+            server->Post(entry.pattern, [target](const httplib::Request& req, httplib::Response& res,
+                                                 const httplib::ContentReader& content_reader) {
+                request_metrics.route = target->metric;
+                target->handler(req, res, &content_reader);
+            });
+            continue;
+        }
+        
+        httplib::Server::Handler handler = [target](const httplib::Request& req, httplib::Response& res) {
+            request_metrics.route = target->metric;
+            target->handler(req, res, nullptr);
+        };
+        std::string_view method = entry.method;
+        if (method == "GET") server->Get(entry.pattern, std::move(handler));
+        else if (method == "POST") server->Post(entry.pattern, std::move(handler));
+        else if (method == "DELETE") server->Delete(entry.pattern, std::move(handler));
+        else server->Options(entry.pattern, std::move(handler));
+    }
+#endif
+}
+
+void MFAServer::setupErrorHandlers() {
+#ifdef HTTPLIB_AVAILABLE
+    httplib::Server* server = nullptr;
     
-    server->Post("/api/authenticate", [this](const httplib::Request& req, httplib::Response& res) {
-        handleAuthenticate(req, res);
-    });
+    if (use_ssl && ssl_server) {
+        server = ssl_server.get();
+    } else if (!use_ssl && http_server) {
+        server = http_server.get();
+    }
     
-    server->Delete("/api/user/(.+)", [this](const httplib::Request& req, httplib::Response& res) {
-        handleDelete(req, res);
-    });
+    if (!server) return;
     
-    server->Get("/api/users", [this](const httplib::Request& req, httplib::Response& res) {
-        handleList(req, res);
+    server->set_error_handler([](const httplib::Request& req, httplib::Response& res) {
+        (void)req; // unused parameter warning 방지
+        res.set_content(INTERNAL_ERROR_BODY.data(), INTERNAL_ERROR_BODY.size(), JSON_CONTENT_TYPE);
     });
+#endif
+}
+
+void MFAServer::setupMetrics() {
+#ifdef HTTPLIB_AVAILABLE
+    httplib::Server* server = nullptr;
+    
+    if (use_ssl && ssl_server) {
+        server = ssl_server.get();
+    } else if (!use_ssl && http_server) {
+        server = http_server.get();
+    }
+    
+    if (!server) return;
+    
+    // 작업 큐는 listen 때 만들어지므로 start() 전에 바꾼 설정도 반영됨
+    server->new_task_queue = [this] { return new WorkerTaskQueue(tuning); };
     
-    server->Get("/health", [this](const httplib::Request& req, httplib::Response& res) {
-        handleHealth(req, res);
+    server->set_pre_routing_handler([](const httplib::Request& req, httplib::Response& res) {
+        (void)req; (void)res; // unused parameter warning 방지
+        request_metrics.start_ns = Metrics::nowNs();
+        request_metrics.route = Metrics::Route::Other;
+        return httplib::Server::HandlerResponse::Unhandled;
     });
     
-    // CORS 프리플라이트 요청 처리
-    server->Options(".*", [this](const httplib::Request& req, httplib::Response& res) {
+    // 로거는 응답을 다 보낸 뒤 호출되므로 기록 비용이 응답 지연에 더해지지 않음
+    server->set_logger([](const httplib::Request& req, const httplib::Response& res) {
         (void)req; // unused parameter warning 방지
-        setupCORS(res);
+        recordRequestMetrics(res);
     });
 #endif
 }
 
-void MFAServer::setupErrorHandlers() {
+bool MFAServer::applyTuning() {
 #ifdef HTTPLIB_AVAILABLE
     httplib::Server* server = nullptr;
     
@@ -142,17 +795,44 @@ void MFAServer::setupErrorHandlers() {
         server = http_server.get();
     }
     
-    if (!server) return;
+    if (!server) return false;
     
-    server->set_error_handler([](const httplib::Request& req, httplib::Response& res) {
-        (void)req; // unused parameter warning 방지
-        res.set_content("{\"success\": false, \"error\": \"Internal server error\"}", "application/json");
+    server->set_keep_alive_max_count(tuning.keep_alive_max_count);
+    server->set_keep_alive_timeout(tuning.keep_alive_timeout_sec);
+    server->set_read_timeout(tuning.read_timeout_sec, 0);
+    server->set_write_timeout(tuning.write_timeout_sec, 0);
+    server->set_tcp_nodelay(tuning.tcp_nodelay);
+    
+    if (use_ssl && ssl_server) {
+        std::string error;
+        if (!TLS::configure(ssl_server->ssl_context(), tuning.tls, error)) {
+            MFA_LOG_ERROR("SERVER", "TLS 설정을 적용하지 못했습니다: " << error);
+            return false;
+        }
+    }
+    
+    // 기본 소켓 옵션(SO_REUSEADDR)을 대신하므로 같이 설정하고, 대기열 길이 변경용으로 소켓을 기억
+    listen_socket = -1;
+    server->set_socket_options([this](httplib::socket_t sock) {
+        int yes = 1;
+        setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+        listen_socket = static_cast<int>(sock);
     });
 #endif
+    return true;
 }
 
 bool MFAServer::start() {
 #ifdef HTTPLIB_AVAILABLE
+    // 복제, 클러스터 내부 리스너와 바이너리 리스너는 자체 스레드에서 돌고, 아래 HTTP 리스너가 블로킹
+    if (!startReplication() || !startCluster() || !startBinaryListener()) {
+        return false;
+    }
+    
+    if (tuning.listener == ListenerMode::Epoll) {
+        return startEventListener();
+    }
+    
     httplib::Server* server = nullptr;
     
     if (use_ssl && ssl_server) {
@@ -162,14 +842,29 @@ bool MFAServer::start() {
     }
     
     if (!server) {
-        std::cerr << "서버 인스턴스가 초기화되지 않았습니다." << std::endl;
+        MFA_LOG_ERROR("SERVER", "서버 인스턴스가 초기화되지 않았습니다.");
+        return false;
+    }
+    
+    if (!applyTuning()) {
+        return false;
+    }
+    
+    MFA_LOG_INFO("SERVER", (use_ssl ? "HTTPS" : "HTTP") << " 서버가 포트 " << port << "에서 시작됩니다...");
+    
+    if (!server->bind_to_port("0.0.0.0", port)) {
+        MFA_LOG_ERROR("SERVER", "포트 " << port << "에 바인드할 수 없습니다.");
         return false;
     }
     
-    std::cout << (use_ssl ? "HTTPS" : "HTTP") << " 서버가 포트 " << port << "에서 시작됩니다..." << std::endl;
+    // httplib은 listen 대기열 길이를 컴파일 시 값(CPPHTTPLIB_LISTEN_BACKLOG)으로 고정하므로
+    // 같은 소켓에 listen()을 다시 불러 길이만 바꿈 (Linux는 이미 listen 중인 소켓에 허용)
+    if (listen_socket >= 0 && ::listen(listen_socket, tuning.listen_backlog) != 0) {
+        MFA_LOG_WARN("SERVER", "수락 대기열 길이를 " << tuning.listen_backlog << "(으)로 바꾸지 못했습니다.");
+    }
     
     // 서버 시작 (블로킹)
-    return server->listen("0.0.0.0", port);
+    return server->listen_after_bind();
 #else
     std::cerr << "오류: cpp-httplib 라이브러리가 설치되어 있지 않습니다." << std::endl;
     std::cerr << "설치 방법:" << std::endl;
@@ -181,163 +876,955 @@ bool MFAServer::start() {
 
 void MFAServer::stop() {
 #ifdef HTTPLIB_AVAILABLE
+    if (binary_server) {
+        binary_server->stop();
+    }
+    if (event_server) {
+        event_server->stop();
+    }
     if (use_ssl && ssl_server) {
         ssl_server->stop();
     } else if (!use_ssl && http_server) {
         http_server->stop();
     }
+    if (cluster_server) {
+        cluster_server->stop();
+    }
+    if (cluster_thread.joinable()) {
+        cluster_thread.join();
+    }
+    if (cluster) {
+        cluster->stop();
+    }
+    if (replication_follower) {
+        replication_follower->stop();
+    }
+    if (replication_leader) {
+        replication_leader->stop();
+    }
 #endif
 }
 
-void MFAServer::setupCORS(httplib::Response& res) {
-    res.set_header("Access-Control-Allow-Origin", "*");
-    res.set_header("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
-    res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
-    res.set_header("Access-Control-Max-Age", "3600");
+bool MFAServer::startEventListener() {
+#ifdef HTTPLIB_AVAILABLE
+    EventServer::Config config;
+    config.threads = tuning.event_threads;
+    config.keep_alive_max_count = tuning.keep_alive_max_count;
+    config.keep_alive_timeout_sec = tuning.keep_alive_timeout_sec;
+    config.read_timeout_sec = tuning.read_timeout_sec;
+    config.write_timeout_sec = tuning.write_timeout_sec;
+    config.listen_backlog = tuning.listen_backlog;
+    config.tcp_nodelay = tuning.tcp_nodelay;
+    // 대량 등록 본문은 메모리에 다 받은 뒤 처리하므로 요청당 사용자 수 상한에 맞춰 허용
+    config.max_body_bytes = std::max(config.max_body_bytes, max_import_items * BATCH_BYTES_PER_ITEM);
+    if (use_ssl) {
+        config.cert_path = cert_path;
+        config.key_path = key_path;
+        config.tls = tuning.tls;
+    }
+    
+    // 클러스터면 다른 노드로 넘기는 요청이 리액터의 다른 연결을 막지 않도록 작업 스레드에서 처리
+    EventServer::Offload offload;
+    if (cluster) {
+        config.offload_threads = tuning.cluster_forward_threads;
+        offload = [this](const httplib::Request& req) { return waitsOnPeers(req); };
+    }
+    
+    size_t file_limit = EventServer::raiseFileLimit();
+    event_server = std::make_unique<EventServer>(
+        config, [this](httplib::Request& req, httplib::Response& res) { dispatchEvent(req, res); },
+        [](const httplib::Request& req, const httplib::Response& res) {
+            (void)req; // unused parameter warning 방지
+            recordRequestMetrics(res);
+        },
+        std::move(offload));
+    
+    if (!event_server->bind("0.0.0.0", port)) {
+        MFA_LOG_ERROR("SERVER", "포트 " << port << "에 바인드할 수 없습니다.");
+        return false;
+    }
+    port = event_server->boundPort();
+    if (replication_leader) {
+        replication_leader->setHTTPPort(port);
+    }
+    
+    MFA_LOG_INFO("SERVER", (use_ssl ? "HTTPS" : "HTTP") << " 서버가 포트 " << port << "에서 시작됩니다... (epoll 리액터 "
+                 << (config.threads ? config.threads : std::max(1u, std::thread::hardware_concurrency()))
+                 << "개, 최대 파일 수 " << file_limit << ")");
+    
+    // 서버 시작 (블로킹)
+    return event_server->run();
+#else
+    return false;
+#endif
 }
 
-void MFAServer::sendJSONResponse(httplib::Response& res, int status, const std::string& json) {
-    setupCORS(res);
-    res.status = status;
-    res.set_content(json, "application/json");
+bool MFAServer::startBinaryListener() {
+    if (tuning.binary_port == 0 && tuning.binary_socket.empty()) {
+        return true;
+    }
+    
+    BinaryServer::Config config;
+    config.threads = tuning.binary_threads;
+    config.listen_backlog = std::max(tuning.listen_backlog, 128);
+    // 클러스터면 다른 노드가 맡은 항목이 있는 묶음은 작업 스레드에서 검증 (startCluster가 먼저 돎)
+    BinaryServer::Offload offload;
+    if (cluster) {
+        config.offload_threads = tuning.cluster_forward_threads;
+        offload = [this](const BinaryServer::Item* items, size_t count) {
+            for (size_t i = 0; i < count; i++) {
+                if (!items[i].request.user_id.empty() && !cluster->owns(items[i].request.user_id)) return true;
+            }
+            return false;
+        };
+    }
+    binary_server = std::make_unique<BinaryServer>(
+        config, [this](BinaryServer::Item* items, size_t count, const std::string& peer) {
+            handleBinaryVerify(items, count, peer);
+        },
+        std::move(offload));
+    
+    if ((tuning.binary_port != 0 && !binary_server->listenTcp("0.0.0.0", tuning.binary_port)) ||
+        (!tuning.binary_socket.empty() && !binary_server->listenUnix(tuning.binary_socket)) ||
+        !binary_server->start()) {
+        MFA_LOG_ERROR("SERVER", "바이너리 프로토콜 리스너를 시작할 수 없습니다.");
+        binary_server.reset();
+        return false;
+    }
+    
+    MFA_LOG_INFO("SERVER", "바이너리 검증 프로토콜: "
+                 << (tuning.binary_port != 0 ? "TCP " + std::to_string(binary_server->tcpPort()) : std::string())
+                 << (tuning.binary_port != 0 && !tuning.binary_socket.empty() ? ", " : "")
+                 << (tuning.binary_socket.empty() ? std::string() : "Unix " + tuning.binary_socket));
+    return true;
 }
 
-void MFAServer::sendErrorResponse(httplib::Response& res, int status, const std::string& message) {
-    std::string json = "{\"success\": false, \"error\": \"" + message + "\"}";
-    sendJSONResponse(res, status, json);
-}
+bool MFAServer::startReplication() {
+    if (tuning.replication_port != 0 && !tuning.follow.empty()) {
+        MFA_LOG_ERROR("SERVER", "--replication-port와 --follow는 함께 쓸 수 없습니다.");
+        return false;
+    }
 
-void MFAServer::handleRegister(const httplib::Request& req, httplib::Response& res) {
-    std::cout << "\n=== [DEBUG] Register Request Received ===" << std::endl;
-    std::cout << "Request body: " << req.body << std::endl;
+    // 키를 모르는 상대가 스냅샷(모든 시크릿)을 받거나 OTP 통과 기록을 보내지 못하도록 키 없이는 시작하지 않음
+    std::string key;
+    if (tuning.replication_port != 0 || !tuning.follow.empty()) {
+        std::string error;
+        if (tuning.replication_key_file.empty()) {
+            MFA_LOG_ERROR("SERVER", "복제에는 --replication-key가 필요합니다.");
+            return false;
+        }
+        if (!readKeyFile(tuning.replication_key_file, ReplicationProtocol::MIN_KEY_BYTES, key, error)) {
+            MFA_LOG_ERROR("SERVER", error);
+            return false;
+        }
+    }
     
-    try {
-        // JSON 파싱 - user_id 추출
-        std::string user_id;
-        size_t start = req.body.find("\"user_id\"");
-        if (start != std::string::npos) {
-            start = req.body.find(":", start);
-            if (start != std::string::npos) {
-                start = req.body.find("\"", start) + 1;
-                size_t end = req.body.find("\"", start);
-                if (end != std::string::npos) {
-                    user_id = req.body.substr(start, end - start);
-                }
-            }
+    if (tuning.replication_port != 0) {
+        ReplicationLeader::Config config;
+        config.log_entries = tuning.replication_log_entries;
+        config.tls = use_ssl;
+        config.key = key;
+        replication_leader = std::make_unique<ReplicationLeader>(*mfa_core, config);
+        replication_leader->setHTTPPort(port);
+        if (!replication_leader->listen(tuning.replication_bind, tuning.replication_port) ||
+            !replication_leader->start()) {
+            MFA_LOG_ERROR("SERVER", "복제 리더를 시작할 수 없습니다.");
+            mfa_core->setMutationListener(nullptr);
+            mfa_core->setAcceptListener(nullptr);
+            replication_leader.reset();
+            return false;
         }
-        
-        std::cout << "[DEBUG] Parsed user_id: '" << user_id << "'" << std::endl;
-        
-        if (user_id.empty()) {
-            std::cout << "[DEBUG] Error: user_id is empty" << std::endl;
-            sendErrorResponse(res, 400, "Invalid request: user_id is required");
-            return;
+        MFA_LOG_INFO("SERVER", "복제 리더: 포트 " << replication_leader->port() << ", epoch "
+                     << std::hex << replication_leader->epoch() << std::dec);
+    } else if (!tuning.follow.empty()) {
+        ReplicationFollower::Config config;
+        if (!ReplicationFollower::parseAddress(tuning.follow, config.leader_host, config.leader_port)) {
+            MFA_LOG_ERROR("SERVER", "유효하지 않은 리더 복제 주소: " << tuning.follow);
+            return false;
         }
-        
-        std::cout << "[DEBUG] Attempting to register user: " << user_id << std::endl;
-        
-        // 사용자 등록 시도
-        User new_user;
-        if (!mfa_core->registerUser(user_id, new_user)) {
-            std::cout << "[DEBUG] Registration failed for user: " << user_id << std::endl;
-            sendErrorResponse(res, 409, "User already exists or registration failed");
-            return;
+        config.position_path = user_file + ".replica";
+        config.key = key;
+        replication_follower = std::make_unique<ReplicationFollower>(*mfa_core, config);
+        if (!replication_follower->start()) {
+            MFA_LOG_ERROR("SERVER", "복제 팔로워를 시작할 수 없습니다.");
+            mfa_core->setAcceptListener(nullptr);
+            replication_follower.reset();
+            return false;
         }
-        
-        std::cout << "[DEBUG] User registered successfully!" << std::endl;
-        std::cout << "[DEBUG] User ID: " << new_user.user_id << std::endl;
-        std::cout << "[DEBUG] Secret: " << new_user.secret_base32 << std::endl;
-        
-        // QR 코드 URL 생성
-        std::string qr_url = mfa_core->generateQRCodeURL(new_user);
-        std::cout << "[DEBUG] QR URL: " << qr_url << std::endl;
-        
-        // 성공 응답 생성
-        std::ostringstream json;
-        json << "{"
-             << "\"success\": true,"
-             << "\"user_id\": \"" << new_user.user_id << "\","
-             << "\"secret\": \"" << new_user.secret_base32 << "\","
-             << "\"qr_code_url\": \"" << qr_url << "\","
-             << "\"otp_uri\": \"" << mfa_core->generateOTPURI(new_user) << "\""
-             << "}";
-        
-        std::cout << "[DEBUG] Sending response: " << json.str() << std::endl;
-        sendJSONResponse(res, 200, json.str());
-        std::cout << "=== [DEBUG] Register Request Completed ===" << std::endl;
-        
-    } catch (const std::exception& e) {
-        std::cout << "[DEBUG] Exception in handleRegister: " << e.what() << std::endl;
-        sendErrorResponse(res, 500, "Internal server error: " + std::string(e.what()));
+        MFA_LOG_INFO("SERVER", "복제 팔로워: 리더 " << tuning.follow << " (쓰기 요청은 리더로 돌려보냄)");
     }
+    return true;
 }
 
-void MFAServer::handleAuthenticate(const httplib::Request& req, httplib::Response& res) {
-    std::cout << "\n=== [DEBUG] Authenticate Request Received ===" << std::endl;
-    std::cout << "Request body: " << req.body << std::endl;
+bool MFAServer::startCluster() {
+    if (tuning.cluster_nodes.empty()) {
+        if (!tuning.node_id.empty()) {
+            MFA_LOG_ERROR("SERVER", "--node-id는 --cluster와 함께 써야 합니다.");
+            return false;
+        }
+        return true;
+    }
+    if (!tuning.follow.empty()) {
+        MFA_LOG_ERROR("SERVER", "--cluster와 --follow는 함께 쓸 수 없습니다.");
+        return false;
+    }
     
-    try {
-        // JSON 파싱 - user_id와 otp_code 추출
-        std::string user_id, otp_code;
-        
-        // user_id 추출
-        size_t start = req.body.find("\"user_id\"");
-        if (start != std::string::npos) {
-            start = req.body.find(":", start);
-            if (start != std::string::npos) {
-                start = req.body.find("\"", start) + 1;
-                size_t end = req.body.find("\"", start);
-                if (end != std::string::npos) {
-                    user_id = req.body.substr(start, end - start);
+#ifdef HTTPLIB_AVAILABLE
+    // 내부 리스너는 재배치로 TOTP 비밀키를 주고받으므로 키를 가진 노드의 요청만 받음
+    Cluster::Config config;
+    std::string error;
+    if (tuning.cluster_key_file.empty()) {
+        MFA_LOG_ERROR("SERVER", "--cluster에는 --cluster-key가 필요합니다.");
+        return false;
+    }
+    if (!readKeyFile(tuning.cluster_key_file, CLUSTER_MIN_KEY_BYTES, config.key, error)) {
+        MFA_LOG_ERROR("SERVER", error);
+        return false;
+    }
+    config.node_id = tuning.node_id;
+    config.nodes = tuning.cluster_nodes;
+    config.vnodes = tuning.cluster_vnodes;
+    const ClusterNode* self = nullptr;
+    for (const ClusterNode& node : config.nodes) {
+        if (node.id == config.node_id) self = &node;
+    }
+    if (!config.node_id.empty() && !self) {
+        MFA_LOG_ERROR("SERVER", "--cluster에 이 노드의 id가 없습니다: " << config.node_id);
+        return false;
+    }
+    cluster = std::make_unique<Cluster>(*mfa_core, config);
+    
+    // 사용자를 맡는 노드는 다른 노드가 넘긴 요청을 받을 내부 리스너를 엶 (라우터는 보내기만 함)
+    if (self) {
+        EventServer::Config server_config;
+        server_config.threads = tuning.cluster_threads;
+        // PeerClient는 CLUSTER_IDLE_REUSE_MS 안에서만 연결을 다시 쓰므로 그보다 길게 유지
+        server_config.keep_alive_max_count = 1000000;
+        server_config.keep_alive_timeout_sec = std::max<time_t>(tuning.keep_alive_timeout_sec,
+                                                                CLUSTER_IDLE_REUSE_MS / 1000 + 3);
+        server_config.read_timeout_sec = tuning.read_timeout_sec;
+        server_config.write_timeout_sec = tuning.write_timeout_sec;
+        server_config.listen_backlog = std::max(tuning.listen_backlog, 128);
+        server_config.tcp_nodelay = true;
+        server_config.max_body_bytes = std::max(server_config.max_body_bytes, max_import_items * BATCH_BYTES_PER_ITEM);
+        cluster_server = std::make_unique<EventServer>(
+            server_config,
+            [this](httplib::Request& req, httplib::Response& res) {
+                // 키가 맞는 노드의 /api/cluster/* 요청과 넘겨받은 공개 API 요청만 처리
+                // (나머지는 공개 포트에서 받을 요청이므로 IP별 시도 제한을 건너뛰지 않도록 여기서는 없는 경로)
+                if (!cluster->authorized(req.get_header_value(CLUSTER_KEY_HEADER))) {
+                    res.status = 403;
+                    return;
                 }
-            }
-        }
-        
-        // otp_code 추출
-        start = req.body.find("\"otp_code\"");
-        if (start != std::string::npos) {
-            start = req.body.find(":", start);
-            if (start != std::string::npos) {
-                start = req.body.find("\"", start) + 1;
-                size_t end = req.body.find("\"", start);
-                if (end != std::string::npos) {
-                    otp_code = req.body.substr(start, end - start);
+                if (req.path.rfind("/api/cluster/", 0) != 0 && !req.has_header(CLUSTER_FORWARDED_HEADER)) {
+                    res.status = 404;
+                    return;
                 }
-            }
+                cluster_request = true;
+                dispatchEvent(req, res);
+                cluster_request = false;
+                res.set_header(CLUSTER_RING_HEADER, std::to_string(cluster->ringVersion()));
+            },
+            [](const httplib::Request& req, const httplib::Response& res) {
+                (void)req; (void)res; // unused parameter warning 방지
+                // 노드 간 요청은 진입 노드가 이미 기록하므로 지표에 남기지 않음
+                request_metrics.start_ns = 0;
+            });
+        if (!cluster_server->bind(self->host, self->port)) {
+            MFA_LOG_ERROR("SERVER", "클러스터 내부 주소 " << self->address() << "에 바인드할 수 없습니다.");
+            cluster_server.reset();
+            cluster.reset();
+            return false;
         }
-        
-        std::cout << "[DEBUG] Parsed user_id: '" << user_id << "'" << std::endl;
-        std::cout << "[DEBUG] Parsed otp_code: '" << otp_code << "'" << std::endl;
-        
-        if (user_id.empty() || otp_code.empty()) {
-            std::cout << "[DEBUG] Error: user_id or otp_code is empty" << std::endl;
-            sendErrorResponse(res, 400, "Invalid request: user_id and otp_code are required");
+        cluster_thread = std::thread([this] { cluster_server->run(); });
+    }
+    
+    cluster->start();
+    std::shared_ptr<const HashRing> ring = cluster->ring();
+    MFA_LOG_INFO("SERVER", "클러스터: " << (self ? "노드 " + config.node_id + " (내부 포트 " + std::to_string(self->port) + ")"
+                                               : std::string("라우터"))
+                 << ", 링 버전 " << ring->version() << ", 노드 " << ring->nodes().size() << "개");
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool MFAServer::forwardToOwner(const httplib::Request& req, httplib::Response& res, std::string_view user_id) {
+    if (!cluster) {
+        return false;
+    }
+    if (cluster_request) {
+        // 보낸 노드의 링이 오래됐으면 421로 알려 링을 새로 받아 다시 보내게 함 (내부 요청은 다시 넘기지 않음)
+        if (cluster->owns(user_id)) {
+            return false;
+        }
+        sendErrorResponse(res, 421, "Misdirected request: user is owned by another node");
+        return true;
+    }
+    
+    // HEAD는 GET으로 넘기고 본문은 리스너가 빼고 보냄
+    std::string method = req.method == "HEAD" ? std::string("GET") : req.method;
+    const std::string& target = req.target.empty() ? req.path : req.target;
+    ClusterNode owner;
+    PeerClient::Response response;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        if (!cluster->route(user_id, owner)) {
+            return false;   // 새 링으로는 이 노드가 주인
+        }
+        if (!cluster->peers().request(owner, method, target, req.get_header_value(CONTENT_TYPE_HEADER), req.body,
+                                      response, true)) {
+            MFA_LOG_WARN("SERVER", owner.id << " 노드(" << owner.address() << ")로 요청을 넘기지 못했습니다.");
+            res.set_header(RETRY_AFTER_HEADER, "1");
+            sendErrorResponse(res, 503, SHARD_UNAVAILABLE);
+            return true;
+        }
+        uint64_t version = 0;
+        if (parseNumber<uint64_t>(response.header(CLUSTER_RING_HEADER), 0, UINT64_MAX, version)) {
+            cluster->noteRingVersion(owner, version);
+        }
+        if (response.status != 421) break;
+    }
+    
+    res.status = response.status;
+    for (const auto& [name, value] : response.headers) {
+        if (!isHopByHopHeader(name)) res.set_header(name, value);
+    }
+    std::string content_type(response.header(CONTENT_TYPE_HEADER));
+    res.set_content(std::move(response.body), content_type.empty() ? JSON_CONTENT_TYPE : content_type);
+    return true;
+}
+
+bool MFAServer::waitsOnPeers(const httplib::Request& req) const {
+    // 라우팅 전에 리액터 스레드에서 부르므로 경로와 user_id만 봄 (틀려도 처리 스레드만 달라짐)
+    std::string_view path = req.path;
+    if (path == "/api/authenticate/batch" || path == "/api/users/bulk" || path == "/api/users") {
+        return true;        // 항목/목록을 여러 노드에 나눠 보냄
+    }
+    std::string_view user_id;
+    std::string_view fields[1];
+    char scratch[REQUEST_SCRATCH_SIZE];
+    if (path == "/api/register" || path == "/api/authenticate") {
+        if (Json::parseStringFields(req.body, AUTH_FIELDS, fields, 1, scratch, sizeof(scratch)) != Json::Error::None) {
+            return false;
+        }
+        user_id = fields[0];
+    } else if (path.rfind("/api/user/", 0) == 0 || path.rfind("/api/qr/", 0) == 0) {
+        user_id = path.substr(path.find_last_of('/') + 1);
+    }
+    return !user_id.empty() && !cluster->owns(user_id);
+}
+
+void MFAServer::verifyOnOwners(const std::vector<AuthItem>& items, const std::vector<ClusterNode>& owners,
+                               std::vector<BinaryProtocol::Status>& statuses, std::vector<uint16_t>& retry_after) {
+    using BinaryProtocol::Status;
+    statuses.assign(items.size(), Status::ServerError);
+    retry_after.assign(items.size(), 0);
+    
+    // 주인 노드별로 묶어 노드마다 요청 하나 (노드끼리는 동시에)
+    std::vector<PeerClient::Call> calls;
+    std::vector<std::vector<size_t>> groups;
+    for (size_t i = 0; i < items.size(); i++) {
+        size_t group = 0;
+        while (group < calls.size() && calls[group].node->id != owners[i].id) group++;
+        if (group == calls.size()) {
+            calls.push_back(PeerClient::Call{&owners[i], "POST", "/api/cluster/verify", ClusterProtocol::CONTENT_TYPE,
+                                             {}, {}, false});
+            groups.emplace_back();
+        }
+        ClusterProtocol::putString(calls[group].body, items[i].user_id);
+        ClusterProtocol::putString(calls[group].body, items[i].otp_code);
+        groups[group].push_back(i);
+    }
+    cluster->peers().requestAll(calls);
+    
+    for (size_t group = 0; group < calls.size(); group++) {
+        const PeerClient::Call& call = calls[group];
+        if (!call.ok || call.response.status != 200) {
+            MFA_LOG_WARN("SERVER", call.node->id << " 노드에서 인증하지 못했습니다 (" << groups[group].size() << "건)");
+            continue;
+        }
+        uint64_t version = 0;
+        if (parseNumber<uint64_t>(call.response.header(CLUSTER_RING_HEADER), 0, UINT64_MAX, version)) {
+            cluster->noteRingVersion(*call.node, version);
+        }
+        ClusterProtocol::Reader reader(call.response.body.data(), call.response.body.size());
+        for (size_t i : groups[group]) {
+            uint8_t status = reader.u8();
+            uint16_t retry = reader.u16();
+            if (!reader.ok() || status > static_cast<uint8_t>(Status::ServerError)) break;
+            statuses[i] = static_cast<Status>(status);
+            retry_after[i] = retry;
+        }
+    }
+}
+
+std::vector<ImportStatus> MFAServer::importAcrossCluster(std::vector<ImportItem>& items) {
+    std::vector<ImportStatus> statuses(items.size(), ImportStatus::Failed);
+    
+    // 새 사용자의 시크릿은 이 노드에서 만들어 결과에 담음 (주인 노드는 받은 시크릿을 그대로 저장)
+    size_t missing = 0;
+    for (const ImportItem& item : items) {
+        if (item.secret_base32.empty()) missing++;
+    }
+    std::vector<std::string> secrets;
+    if (missing > 0 && !mfa_core->generateSecrets(missing, secrets)) {
+        return statuses;
+    }
+    for (size_t i = 0, next = 0; i < items.size(); i++) {
+        if (items[i].secret_base32.empty()) items[i].secret_base32 = std::move(secrets[next++]);
+    }
+    
+    // 주인 노드별로 나눔 (형식이 잘못된 항목은 넘기지 않고 Invalid)
+    std::shared_ptr<const HashRing> ring = cluster->ring();
+    std::vector<size_t> local;
+    std::vector<PeerClient::Call> calls;
+    std::vector<std::vector<size_t>> groups;
+    for (size_t i = 0; i < items.size(); i++) {
+        const ImportItem& item = items[i];
+        if (!MFACore::isValidUserId(item.user_id) || item.secret_base32.size() > 255) {
+            statuses[i] = ImportStatus::Invalid;
+            continue;
+        }
+        const ClusterNode* owner = ring->owner(item.user_id);
+        if (!owner) continue;
+        if (owner->id == cluster->nodeId()) {
+            local.push_back(i);
+            continue;
+        }
+        size_t group = 0;
+        while (group < calls.size() && calls[group].node != owner) group++;
+        if (group == calls.size()) {
+            calls.push_back(PeerClient::Call{owner, "POST", "/api/cluster/import", ClusterProtocol::CONTENT_TYPE,
+                                             {}, {}, false});
+            groups.emplace_back();
+        }
+        ClusterProtocol::putString(calls[group].body, item.user_id);
+        ClusterProtocol::putString(calls[group].body, item.secret_base32);
+        groups[group].push_back(i);
+    }
+    
+    // 다른 노드로 보내는 동안 이 노드 몫을 등록
+    std::thread remote([this, &calls] { cluster->peers().requestAll(calls); });
+    importOnThisNode(items, local, statuses);
+    remote.join();
+    
+    for (size_t group = 0; group < calls.size(); group++) {
+        const PeerClient::Call& call = calls[group];
+        if (!call.ok || call.response.status != 200 || call.response.body.size() != groups[group].size()) {
+            MFA_LOG_WARN("SERVER", call.node->id << " 노드에 등록하지 못했습니다 (" << groups[group].size() << "명)");
+            continue;
+        }
+        for (size_t k = 0; k < groups[group].size(); k++) {
+            uint8_t status = static_cast<uint8_t>(call.response.body[k]);
+            statuses[groups[group][k]] = status <= static_cast<uint8_t>(ImportStatus::Failed)
+                                             ? static_cast<ImportStatus>(status) : ImportStatus::Failed;
+        }
+    }
+    return statuses;
+}
+
+void MFAServer::importOnThisNode(std::vector<ImportItem>& items, const std::vector<size_t>& indices,
+                                 std::vector<ImportStatus>& statuses) {
+    if (indices.empty()) {
+        return;
+    }
+    // 다른 노드로 옮겨 가는 중이라 쓰기가 막힌 사용자는 Failed (다시 보내면 새 주인에게 감)
+    Cluster::WriteGuard guard = cluster->guardWrites();
+    std::vector<ImportItem> batch;
+    std::vector<size_t> positions;
+    batch.reserve(indices.size());
+    positions.reserve(indices.size());
+    for (size_t i : indices) {
+        if (guard.blocked(items[i].user_id)) {
+            statuses[i] = ImportStatus::Failed;
+            continue;
+        }
+        batch.push_back(std::move(items[i]));
+        positions.push_back(i);
+    }
+    std::vector<ImportStatus> results = mfa_core->importUsers(batch);
+    for (size_t k = 0; k < batch.size(); k++) {
+        if (results[k] == ImportStatus::Created) guard.changed(batch[k].user_id);
+        statuses[positions[k]] = results[k];
+        items[positions[k]] = std::move(batch[k]);
+    }
+}
+
+bool MFAServer::rejectFollowerWrite(const httplib::Request& req, httplib::Response& res) {
+    if (!replication_follower) {
+        return false;
+    }
+    
+    std::string leader = tuning.leader_url.empty() ? replication_follower->leaderURL() : tuning.leader_url;
+    if (leader.empty()) {
+        sendErrorResponse(res, 503, "Read-only replica: leader is not known yet");
+        return true;
+    }
+    while (!leader.empty() && leader.back() == '/') {
+        leader.pop_back();
+    }
+    
+    // 307은 메서드와 본문을 그대로 유지한 채 다시 보내게 함
+    std::string location = leader + (req.target.empty() ? req.path : req.target);
+    Json::Writer& json = Json::Writer::local();
+    json.beginObject()
+        .key("success").boolean(false)
+        .key("error").string("Read-only replica: send writes to the leader")
+        .key("leader").string(leader)
+        .endObject();
+    res.set_header("Location", location);
+    sendJSONResponse(res, 307, json.view());
+    return true;
+}
+
+void MFAServer::dispatchEvent(httplib::Request& req, httplib::Response& res) {
+#ifdef HTTPLIB_AVAILABLE
+    request_metrics.start_ns = Metrics::nowNs();
+    request_metrics.route = Metrics::Route::Other;
+    
+    // HEAD는 GET 라우트로 처리하고 본문은 리스너가 빼고 보냄
+    std::string_view method = req.method == "HEAD" ? std::string_view("GET") : std::string_view(req.method);
+    const RouteEntry* target = nullptr;
+    for (const RouteEntry& entry : routes) {
+        if (method == entry.method && std::regex_match(req.path, req.matches, entry.regex)) {
+            target = &entry;
+            break;
+        }
+    }
+    
+    if (!target) {
+        res.status = 404;
+    } else {
+        request_metrics.route = target->metric;
+        if (target->reads_content) {
+            // 이벤트 리스너는 본문을 다 받은 뒤 호출하므로 받은 본문을 한 번에 넘김
+            httplib::ContentReader content_reader(
+                [&req](httplib::ContentReceiver receiver) {
+                    return req.body.empty() || receiver(req.body.data(), req.body.size());
+                },
+                [](httplib::MultipartContentHeader header, httplib::ContentReceiver receiver) {
+                    (void)header; (void)receiver; // unused parameter warning 방지
+                    return false;
+                });
+            target->handler(req, res, &content_reader);
+        } else {
+            target->handler(req, res, nullptr);
+        }
+    }
+    
+    if (res.status >= 400 && res.body.empty() && !res.content_provider_) {
+        res.set_content(INTERNAL_ERROR_BODY.data(), INTERNAL_ERROR_BODY.size(), JSON_CONTENT_TYPE);
+    }
+#else
+    (void)req; (void)res; // unused parameter warning 방지
+#endif
+}
+
+void MFAServer::setupCORS(httplib::Response& res) {
+    res.set_header("Access-Control-Allow-Origin", "*");
+    res.set_header("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
+    res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
+    res.set_header("Access-Control-Max-Age", "3600");
+}
+
+void MFAServer::sendJSONResponse(httplib::Response& res, int status, std::string_view json) {
+    // 일반 응답에는 Allow-Origin만 필요 (나머지 CORS 헤더는 프리플라이트 응답에서만 의미가 있음)
+    res.set_header(CORS_ALLOW_ORIGIN, CORS_ANY_ORIGIN);
+    res.status = status;
+    // 스레드 버퍼(또는 정적 본문)에서 httplib가 소유하는 본문으로 한 번만 복사
+    res.set_content(json.data(), json.size(), JSON_CONTENT_TYPE);
+}
+
+void MFAServer::sendErrorResponse(httplib::Response& res, int status, std::string_view message, std::string_view detail) {
+    Json::Writer& json = Json::Writer::local();
+    json.beginObject()
+        .key("success").boolean(false)
+        .key("error").string(message, detail, {})
+        .endObject();
+    sendJSONResponse(res, status, json.view());
+}
+
+void MFAServer::handleRegister(const httplib::Request& req, httplib::Response& res) {
+    MFA_LOG_DEBUG("SERVER", "Register request received (" << req.body.size() << " bytes)");
+    
+    if (rejectFollowerWrite(req, res)) {
+        return;
+    }
+    
+    try {
+        // JSON 파싱 - user_id와 선택 필드 qr("png" | "svg": 응답에 QR 이미지를 data URI로 포함) 추출
+        std::string_view fields[2];
+        char scratch[REQUEST_SCRATCH_SIZE];
+        Json::Error parse_error = Json::parseStringFields(req.body, REGISTER_FIELDS, fields, 2, scratch, sizeof(scratch));
+        if (parse_error != Json::Error::None) {
+            MFA_LOG_DEBUG("SERVER", "Register rejected: " << Json::errorMessage(parse_error));
+            sendErrorResponse(res, statusForParseError(parse_error), "Invalid request: ", Json::errorMessage(parse_error));
+            return;
+        }
+        std::string user_id(fields[0]);
+        
+        MFA_LOG_DEBUG("SERVER", "Parsed user_id: '" << user_id << "'");
+        
+        if (user_id.empty()) {
+            MFA_LOG_DEBUG("SERVER", "Register rejected: user_id is empty");
+            sendErrorResponse(res, 400, "Invalid request: user_id is required");
+            return;
+        }
+        
+        QRCode::Format qr_format = QRCode::Format::PNG;
+        bool inline_qr = !fields[1].empty();
+        if (inline_qr && !QRCode::parseFormat(fields[1], qr_format)) {
+            sendErrorResponse(res, 400, "Invalid request: qr must be \"png\" or \"svg\"");
+            return;
+        }
+        
+        if (forwardToOwner(req, res, user_id)) {
+            return;
+        }
+        
+        // 사용자 등록 시도 (다른 노드로 옮겨 가는 중인 사용자는 옮긴 뒤 다시 시도하게 함)
+        User new_user;
+        bool registered = false;
+        {
+            Cluster::WriteGuard guard = cluster ? cluster->guardWrites() : Cluster::WriteGuard();
+            if (guard.blocked(user_id)) {
+                res.set_header(RETRY_AFTER_HEADER, "1");
+                sendErrorResponse(res, 503, "User is moving to another node, retry shortly");
+                return;
+            }
+            registered = mfa_core->registerUser(user_id, new_user);
+            if (registered) guard.changed(user_id);
+        }
+        if (!registered) {
+            MFA_LOG_INFO("SERVER", "Registration failed for user: " << user_id);
+            sendErrorResponse(res, 409, "User already exists or registration failed");
+            return;
+        }
+        
+        MFA_LOG_INFO("SERVER", "User registered: " << new_user.user_id);
+        
+        // QR 코드 URL 생성 (이 서버의 /api/qr/{user_id})
+        std::string qr_url = mfa_core->generateQRCodeURL(new_user);
+        
+        std::string otp_uri = mfa_core->generateOTPURI(new_user);
+        
+        std::shared_ptr<const std::string> qr_image;
+        if (inline_qr) {
+            qr_image = qr_cache.get(otp_uri, qr_format, QRCode::DEFAULT_SCALE);
+        }
+        
+        // 성공 응답 생성
+        Json::Writer& json = Json::Writer::local();
+        json.beginObject()
+            .key("success").boolean(true)
+            .key("user_id").string(new_user.user_id)
+            .key("secret").string(new_user.secret_base32)
+            .key("qr_code_url").string(qr_url)
+            .key("otp_uri").string(otp_uri);
+        if (qr_image) {
+            json.key("qr_image").string(QRCode::dataURI(qr_format, *qr_image));
+        }
+        json.endObject();
+        
+        sendJSONResponse(res, 200, json.view());
+        
+    } catch (const std::exception& e) {
+        MFA_LOG_ERROR("SERVER", "Exception in handleRegister: " << e.what());
+        sendErrorResponse(res, 500, "Internal server error: " + std::string(e.what()));
+    }
+}
+
+void MFAServer::handleAuthenticate(const httplib::Request& req, httplib::Response& res) {
+    MFA_LOG_DEBUG("SERVER", "Authenticate request received (" << req.body.size() << " bytes)");
+    
+    try {
+        // JSON 파싱 - user_id와 otp_code 추출 (본문 버퍼를 가리키는 view, 할당 없음)
+        std::string_view fields[2];
+        char scratch[REQUEST_SCRATCH_SIZE];
+        Json::Error parse_error = Json::parseStringFields(req.body, AUTH_FIELDS, fields, 2, scratch, sizeof(scratch));
+        if (parse_error != Json::Error::None) {
+            MFA_LOG_DEBUG("SERVER", "Authenticate rejected: " << Json::errorMessage(parse_error));
+            sendErrorResponse(res, statusForParseError(parse_error), "Invalid request: ", Json::errorMessage(parse_error));
             return;
         }
+        std::string_view user_id = fields[0];
+        std::string_view otp_code = fields[1];
+        
+        MFA_LOG_DEBUG("SERVER", "Parsed user_id: '" << user_id << "', otp_code: " << Log::redact(otp_code));
         
-        std::cout << "[DEBUG] Attempting to verify TOTP for user: " << user_id << std::endl;
+        if (user_id.empty() || otp_code.empty()) {
+            MFA_LOG_DEBUG("SERVER", "Authenticate rejected: user_id or otp_code is empty");
+            sendErrorResponse(res, 400, "Invalid request: user_id and otp_code are required");
+            return;
+        }
+        
+        // 시도 제한은 저장소 조회/HMAC 계산 전에 검사 (클러스터에서 IP 버킷은 진입 노드, 사용자 버킷은 주인 노드가 검사)
+        std::string_view limited_user = user_id;
+        std::string_view limited_ip = req.remote_addr;
+        ClusterNode owner;
+        if (cluster && cluster_request) {
+            limited_ip = {};
+        } else if (cluster && cluster->route(user_id, owner)) {
+            limited_user = {};
+        }
+        uint32_t retry_after = 0;
+        if (rate_limiter && !rate_limiter->allow(limited_user, limited_ip, retry_after)) {
+            MFA_LOG_DEBUG("SERVER", "Authenticate rate limited: " << user_id << " from " << req.remote_addr);
+            Metrics::addRateLimited();
+            sendRateLimitedResponse(res, retry_after);
+            return;
+        }
+        
+        if (forwardToOwner(req, res, user_id)) {
+            return;
+        }
         
         // TOTP 검증
         bool is_valid = mfa_core->verifyTOTP(user_id, otp_code);
         
-        std::cout << "[DEBUG] TOTP verification result: " << (is_valid ? "SUCCESS" : "FAILED") << std::endl;
+        MFA_LOG_DEBUG("SERVER", "TOTP verification for " << user_id << ": " << (is_valid ? "SUCCESS" : "FAILED"));
         
         if (is_valid) {
-            std::cout << "[DEBUG] Sending success response" << std::endl;
-            sendJSONResponse(res, 200, "{\"success\": true, \"message\": \"Authentication successful\"}");
+            sendJSONResponse(res, 200, AUTH_SUCCESS_BODY);
         } else {
-            std::cout << "[DEBUG] Sending failure response" << std::endl;
-            sendJSONResponse(res, 401, "{\"success\": false, \"message\": \"Authentication failed\"}");
+            sendJSONResponse(res, 401, AUTH_FAILURE_BODY);
+        }
+        
+    } catch (const std::exception& e) {
+        sendErrorResponse(res, 500, "Internal server error: " + std::string(e.what()));
+    }
+}
+
+void MFAServer::handleAuthenticateBatch(const httplib::Request& req, httplib::Response& res) {
+    MFA_LOG_DEBUG("SERVER", "Batch authenticate request received (" << req.body.size() << " bytes)");
+    
+    try {
+        auto start = std::chrono::steady_clock::now();
+        
+        std::vector<AuthItem> items;
+        bool has_items = false;
+        Json::Error parse_error = parseBatchItems(req.body, max_batch_size, items, has_items);
+        if (parse_error != Json::Error::None) {
+            sendErrorResponse(res, statusForParseError(parse_error), "Invalid request: ", Json::errorMessage(parse_error));
+            return;
+        }
+        if (!has_items) {
+            sendErrorResponse(res, 400, "Invalid request: items array is required");
+            return;
         }
         
-        std::cout << "=== [DEBUG] Authenticate Request Completed ===" << std::endl;
+        if (items.empty()) {
+            sendErrorResponse(res, 400, "Invalid request: items array is empty");
+            return;
+        }
+        if (items.size() > max_batch_size) {
+            sendErrorResponse(res, 413, "Batch too large: maximum is " + std::to_string(max_batch_size) + " items");
+            return;
+        }
+        
+        // 시도 제한: IP 버킷은 항목 수만큼 한 번에 차감, 사용자 버킷은 항목별로 검사해
+        // 제한된 항목은 조회/HMAC 없이 실패 처리 (OTP를 비워 형식 오류로 건너뛰게 함)
+        std::vector<bool> limited;
+        if (rate_limiter) {
+            uint32_t retry_after = 0;
+            uint32_t cost = static_cast<uint32_t>(std::min<size_t>(items.size(), UINT32_MAX));
+            if (!rate_limiter->allowClient(req.remote_addr, cost, retry_after)) {
+                MFA_LOG_DEBUG("SERVER", "Batch rate limited: " << items.size() << " items from " << req.remote_addr);
+                Metrics::addRateLimited(items.size());
+                sendRateLimitedResponse(res, retry_after);
+                return;
+            }
+        }
+        
+        // 클러스터면 다른 노드가 맡은 항목을 골라 그 노드에서 검증 (사용자 버킷도 그 노드가 검사)
+        std::vector<char> remote;
+        std::vector<BinaryProtocol::Status> remote_status;
+        std::vector<uint16_t> remote_retry;
+        if (cluster) {
+            std::vector<AuthItem> remote_items;
+            std::vector<ClusterNode> owners;
+            std::vector<size_t> remote_index;
+            ClusterNode owner;
+            remote.assign(items.size(), 0);
+            for (size_t i = 0; i < items.size(); i++) {
+                if (items[i].user_id.empty() || items[i].otp_code.empty() || !cluster->route(items[i].user_id, owner)) {
+                    continue;
+                }
+                remote[i] = 1;
+                remote_items.push_back(items[i]);
+                owners.push_back(owner);
+                remote_index.push_back(i);
+            }
+            if (!remote_items.empty()) {
+                std::vector<BinaryProtocol::Status> statuses;
+                std::vector<uint16_t> retry;
+                verifyOnOwners(remote_items, owners, statuses, retry);
+                remote_status.assign(items.size(), BinaryProtocol::Status::Ok);
+                remote_retry.assign(items.size(), 0);
+                for (size_t k = 0; k < remote_index.size(); k++) {
+                    remote_status[remote_index[k]] = statuses[k];
+                    remote_retry[remote_index[k]] = retry[k];
+                    items[remote_index[k]].otp_code.clear();    // 이 노드에서는 형식 오류로 건너뜀
+                }
+            }
+        }
+        
+        if (rate_limiter) {
+            uint32_t retry_after = 0;
+            limited.assign(items.size(), false);
+            size_t limited_count = 0;
+            for (size_t i = 0; i < items.size(); i++) {
+                if (!remote.empty() && remote[i]) continue;
+                if (!rate_limiter->allowUser(items[i].user_id, retry_after)) {
+                    limited[i] = true;
+                    items[i].otp_code.clear();
+                    limited_count++;
+                }
+            }
+            if (limited_count > 0) Metrics::addRateLimited(limited_count);
+        }
+        
+        std::vector<AuthItemResult> results = mfa_core->verifyTOTPBatch(items);
+        for (size_t i = 0; i < remote_status.size(); i++) {
+            if (!remote[i]) continue;
+            results[i] = AuthItemResult();
+            results[i].success = remote_status[i] == BinaryProtocol::Status::Ok;
+        }
+        
+        size_t success_count = 0;
+        Json::Writer& json = Json::Writer::local();
+        json.beginObject()
+            .key("success").boolean(true)
+            .key("count").number(uint64_t(results.size()))
+            .key("results").beginArray();
+        for (size_t i = 0; i < results.size(); i++) {
+            const AuthItemResult& result = results[i];
+            if (result.success) success_count++;
+            
+            json.beginObject()
+                .key("user_id").string(items[i].user_id)
+                .key("success").boolean(result.success);
+            if (!remote_status.empty() && remote[i]) {
+                if (remote_status[i] == BinaryProtocol::Status::RateLimited) {
+                    json.key("error").string("Too many authentication attempts");
+                } else if (remote_status[i] == BinaryProtocol::Status::BadRequest) {
+                    json.key("error").string("user_id and 6-digit otp_code are required");
+                } else if (remote_status[i] == BinaryProtocol::Status::ServerError) {
+                    json.key("error").string(SHARD_UNAVAILABLE);
+                }
+            } else if (!limited.empty() && limited[i]) {
+                json.key("error").string("Too many authentication attempts");
+            } else if (!result.valid_request) {
+                json.key("error").string("user_id and 6-digit otp_code are required");
+            }
+            json.key("lookup_ns").number(result.lookup_ns)
+                .key("verify_ns").number(result.verify_ns)
+                .endObject();
+        }
+        
+        uint64_t total_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+        json.endArray()
+            .key("succeeded").number(uint64_t(success_count))
+            .key("total_ns").number(total_ns)
+            .endObject();
+        
+        MFA_LOG_DEBUG("SERVER", "Batch verified: " << success_count << "/" << results.size() << " succeeded");
+        sendJSONResponse(res, 200, json.view());
         
     } catch (const std::exception& e) {
         sendErrorResponse(res, 500, "Internal server error: " + std::string(e.what()));
     }
 }
 
+void MFAServer::handleBinaryVerify(BinaryServer::Item* items, size_t count, const std::string& peer) {
+    using BinaryProtocol::Status;
+    uint64_t start_ns = Metrics::nowNs();
+    
+    // 형식 오류/시도 제한을 먼저 거르고 남은 항목만 검증 (파이프라이닝된 묶음은 TOTP 커널 배치 한 번)
+    // 클러스터면 다른 노드가 맡은 항목은 IP 버킷만 검사하고 그 노드에 모아 보냄
+    thread_local std::vector<AuthItem> pending;
+    thread_local std::vector<size_t> pending_index;
+    thread_local std::vector<AuthItem> remote;
+    thread_local std::vector<ClusterNode> remote_owner;
+    thread_local std::vector<size_t> remote_index;
+    pending.clear();
+    pending_index.clear();
+    remote.clear();
+    remote_owner.clear();
+    remote_index.clear();
+    ClusterNode owner;
+    for (size_t i = 0; i < count; i++) {
+        BinaryServer::Item& item = items[i];
+        std::string_view user_id = item.request.user_id;
+        std::string_view otp_code = item.request.otp_code;
+        if (user_id.empty() || otp_code.empty()) {
+            item.status = Status::BadRequest;
+            continue;
+        }
+        bool is_remote = cluster && cluster->route(user_id, owner);
+        uint32_t retry_after = 0;
+        if (rate_limiter && !rate_limiter->allow(is_remote ? std::string_view() : user_id, peer, retry_after)) {
+            Metrics::addRateLimited();
+            item.status = Status::RateLimited;
+            item.retry_after = static_cast<uint16_t>(std::min<uint32_t>(retry_after, UINT16_MAX));
+            continue;
+        }
+        if (is_remote) {
+            remote.push_back(AuthItem{std::string(user_id), std::string(otp_code)});
+            remote_owner.push_back(owner);
+            remote_index.push_back(i);
+            continue;
+        }
+        pending.push_back(AuthItem{std::string(user_id), std::string(otp_code)});
+        pending_index.push_back(i);
+    }
+    
+    if (!remote.empty()) {
+        std::vector<Status> statuses;
+        std::vector<uint16_t> retry;
+        verifyOnOwners(remote, remote_owner, statuses, retry);
+        for (size_t k = 0; k < remote_index.size(); k++) {
+            items[remote_index[k]].status = statuses[k];
+            items[remote_index[k]].retry_after = retry[k];
+        }
+    }
+    
+    if (pending.size() == 1) {
+        bool is_valid = mfa_core->verifyTOTP(pending[0].user_id, pending[0].otp_code);
+        items[pending_index[0]].status = is_valid ? Status::Ok : Status::Invalid;
+    } else if (!pending.empty()) {
+        // 리액터 스레드에서 바로 처리 (검증 스레드를 따로 띄우지 않음)
+        std::vector<AuthItemResult> results = mfa_core->verifyTOTPBatch(pending, ALLOWED_DRIFT_STEPS, 1);
+        for (size_t k = 0; k < results.size(); k++) {
+            items[pending_index[k]].status = results[k].success        ? Status::Ok
+                                             : results[k].valid_request ? Status::Invalid
+                                                                        : Status::BadRequest;
+        }
+    }
+    
+    // 지표는 HTTP 인증과 같은 상태 코드로 기록 (시간은 묶음 전체 처리 시간)
+    uint64_t duration_ns = Metrics::nowNs() - start_ns;
+    for (size_t i = 0; i < count; i++) {
+        int code = 500;
+        switch (items[i].status) {
+            case Status::Ok: code = 200; break;
+            case Status::Invalid: code = 401; break;
+            case Status::RateLimited: code = 429; break;
+            case Status::BadRequest: code = 400; break;
+            case Status::ServerError: code = 500; break;
+        }
+        Metrics::recordRequest(Metrics::Route::BinaryVerify, code, duration_ns);
+    }
+    MFA_LOG_DEBUG("SERVER", "Binary verify: " << count << " requests from " << peer);
+}
+
 void MFAServer::handleDelete(const httplib::Request& req, httplib::Response& res) {
+    if (rejectFollowerWrite(req, res)) {
+        return;
+    }
+    
     try {
         // URL에서 사용자 ID 추출 (/api/user/{user_id})
         std::string path = req.path;
@@ -355,65 +1842,782 @@ void MFAServer::handleDelete(const httplib::Request& req, httplib::Response& res
             return;
         }
         
+        if (forwardToOwner(req, res, user_id)) {
+            return;
+        }
+        
         // 사용자 삭제 시도
-        bool deleted = mfa_core->deleteUser(user_id);
+        bool deleted = false;
+        {
+            Cluster::WriteGuard guard = cluster ? cluster->guardWrites() : Cluster::WriteGuard();
+            if (guard.blocked(user_id)) {
+                res.set_header(RETRY_AFTER_HEADER, "1");
+                sendErrorResponse(res, 503, "User is moving to another node, retry shortly");
+                return;
+            }
+            deleted = mfa_core->deleteUser(user_id);
+            if (deleted) guard.changed(user_id);
+        }
         
-        if (deleted) {
-            std::ostringstream json;
-            json << "{\"success\": true, \"message\": \"User '" << user_id << "' deleted successfully\"}";
-            sendJSONResponse(res, 200, json.str());
-        } else {
-            std::ostringstream json;
-            json << "{\"success\": false, \"message\": \"User '" << user_id << "' not found\"}";
-            sendJSONResponse(res, 404, json.str());
+        Json::Writer& json = Json::Writer::local();
+        json.beginObject()
+            .key("success").boolean(deleted)
+            .key("message").string("User '", user_id, deleted ? "' deleted successfully" : "' not found")
+            .endObject();
+        sendJSONResponse(res, deleted ? 200 : 404, json.view());
+        
+    } catch (const std::exception& e) {
+        sendErrorResponse(res, 500, "Internal server error: " + std::string(e.what()));
+    }
+}
+
+void MFAServer::handleQRCode(const httplib::Request& req, httplib::Response& res) {
+    try {
+        // URL에서 사용자 ID 추출 (/api/qr/{user_id}), 쿼리 파라미터: format(png | svg), scale(1..16)
+        std::string path = req.path;
+        size_t last_slash = path.find_last_of('/');
+        if (last_slash == std::string::npos || last_slash == path.length() - 1) {
+            sendErrorResponse(res, 400, "Invalid request: user_id is required in URL");
+            return;
+        }
+        std::string user_id = path.substr(last_slash + 1);
+        
+        if (forwardToOwner(req, res, user_id)) {
+            return;
+        }
+        
+        QRCode::Format format = QRCode::Format::PNG;
+        if (req.has_param("format") && !QRCode::parseFormat(req.get_param_value("format"), format)) {
+            sendErrorResponse(res, 400, "Invalid request: format must be \"png\" or \"svg\"");
+            return;
+        }
+        
+        size_t scale = QRCode::DEFAULT_SCALE;
+        if (req.has_param("scale") && !parseLimit(req.get_param_value("scale"), QRCode::MAX_SCALE, scale)) {
+            sendErrorResponse(res, 400, "Invalid request: scale must be between 1 and ", std::to_string(QRCode::MAX_SCALE));
+            return;
+        }
+        
+        User user;
+        if (!mfa_core->findUser(user_id, user)) {
+            sendErrorResponse(res, 404, "User not found");
+            return;
+        }
+        
+        // 캐시 키에 시크릿이 포함된 URI를 쓰므로 재등록한 사용자는 새 이미지를 받음
+        std::shared_ptr<const std::string> image = qr_cache.get(mfa_core->generateOTPURI(user), format,
+                                                                static_cast<int>(scale));
+        if (!image) {
+            sendErrorResponse(res, 500, "QR code rendering failed");
+            return;
         }
         
+        res.set_header(CORS_ALLOW_ORIGIN, CORS_ANY_ORIGIN);
+        res.set_header(CACHE_CONTROL_HEADER, NO_STORE);
+        res.status = 200;
+        res.set_content(image->data(), image->size(), QRCode::contentType(format));
+        
     } catch (const std::exception& e) {
         sendErrorResponse(res, 500, "Internal server error: " + std::string(e.what()));
     }
 }
 
-void MFAServer::handleList(const httplib::Request& req, httplib::Response& res) {
-    std::cout << "\n=== [DEBUG] List Request Received ===" << std::endl;
+void MFAServer::handleBulkImport(const httplib::Request& req, httplib::Response& res,
+                                 const httplib::ContentReader& content_reader) {
+    if (rejectFollowerWrite(req, res)) {
+        return;
+    }
     
     try {
-        (void)req; // unused parameter warning 방지
+        // 형식: ?format=csv|ndjson, 없으면 Content-Type (text/csv, application/x-ndjson)
+        UserIO::Format format = UserIO::Format::CSV;
+        bool known_format = req.has_param("format")
+            ? UserIO::parseFormat(req.get_param_value("format"), format)
+            : UserIO::formatFromContentType(req.get_header_value(CONTENT_TYPE_HEADER), format);
+        if (!known_format) {
+            sendErrorResponse(res, 415, "Unsupported format: use text/csv or application/x-ndjson");
+            return;
+        }
+        
+        UserIO::Reader reader(format);
+        std::vector<ImportItem> items;
+        std::vector<size_t> lines;
+        size_t counts[4] = {0, 0, 0, 0};
+        size_t processed = 0;
+        bool too_many = false;
+        
+        // 결과는 입력 줄 순서대로 같은 형식으로 (새로 등록된 사용자만 시크릿 포함)
+        std::string body;
+        UserIO::appendResultHeader(body, format);
+        auto importPending = [&]() {
+            // 클러스터면 주인 노드별로 나눠 등록
+            std::vector<ImportStatus> statuses = cluster ? importAcrossCluster(items) : mfa_core->importUsers(items);
+            for (size_t i = 0; i < items.size(); i++) {
+                UserIO::appendResultRecord(body, format, lines[i], items[i], statuses[i]);
+                counts[static_cast<size_t>(statuses[i])]++;
+            }
+            processed += items.size();
+            items.clear();
+            lines.clear();
+        };
         
-        std::cout << "[DEBUG] Calling mfa_core->listUsers()" << std::endl;
+        // 본문 전체를 메모리에 두지 않고 읽는 대로 청크 단위로 등록
+        content_reader([&](const char* data, size_t size) {
+            reader.feed(std::string_view(data, size), items, lines);
+            if (processed + items.size() > max_import_items) {
+                too_many = true;
+                return false;
+            }
+            if (items.size() >= BULK_IMPORT_CHUNK_ITEMS) {
+                importPending();
+            }
+            return true;
+        });
+        if (!too_many) {
+            reader.finish(items, lines);
+            too_many = processed + items.size() > max_import_items;
+        }
+        if (too_many) {
+            // 한도를 넘은 청크는 등록하지 않음 (앞서 등록된 줄의 결과는 시크릿 전달을 위해 그대로 반환)
+            items.clear();
+            lines.clear();
+        } else {
+            importPending();
+        }
+        
+        MFA_LOG_INFO("SERVER", "Bulk import: " << processed << " lines, " << counts[0] << " created"
+                     << (too_many ? " (truncated)" : ""));
+        
+        for (size_t i = 0; i < 4; i++) {
+            res.set_header(IMPORT_COUNT_HEADERS[i], std::to_string(counts[i]));
+        }
+        res.set_header(CORS_ALLOW_ORIGIN, CORS_ANY_ORIGIN);
+        res.set_header(CACHE_CONTROL_HEADER, NO_STORE);
+        res.status = too_many ? 413 : 200;
+        res.set_content(std::move(body), UserIO::contentType(format));
+        
+    } catch (const std::exception& e) {
+        MFA_LOG_ERROR("SERVER", "Exception in handleBulkImport: " << e.what());
+        sendErrorResponse(res, 500, "Internal server error: ", e.what());
+    }
+}
+
+void MFAServer::handleList(const httplib::Request& req, httplib::Response& res) {
+    try {
+        // 쿼리 파라미터: cursor(이전 응답의 next_cursor), limit, prefix, stream
+        size_t limit = DEFAULT_LIST_LIMIT;
+        if (req.has_param("limit") && !parseLimit(req.get_param_value("limit"), MAX_LIST_LIMIT, limit)) {
+            sendErrorResponse(res, 400, "Invalid request: limit must be between 1 and ", std::to_string(MAX_LIST_LIMIT));
+            return;
+        }
         
-        // 모든 사용자 목록 조회
-        std::vector<std::string> users = mfa_core->listUsers();
+        std::string prefix = req.has_param("prefix") ? req.get_param_value("prefix") : std::string();
+        if (prefix.size() > MAX_USER_ID_LENGTH) {
+            sendErrorResponse(res, 400, "Invalid request: prefix is longer than a user_id");
+            return;
+        }
         
-        std::cout << "[DEBUG] Retrieved " << users.size() << " users" << std::endl;
-        for (size_t i = 0; i < users.size(); i++) {
-            std::cout << "[DEBUG] User " << i << ": " << users[i] << std::endl;
+        // 클러스터면 모든 노드의 목록을 모음 (내부 요청은 이 노드 것만)
+        if (cluster && !cluster_request) {
+            handleClusterList(req, res, limit, std::move(prefix));
+            return;
         }
         
-        // JSON 응답 생성
-        std::ostringstream json;
-        json << "{"
-             << "\"success\": true,"
-             << "\"count\": " << users.size() << ","
-             << "\"users\": [";
+        uint64_t cursor = 0;
+        if (req.has_param("cursor") && !parseCursor(req.get_param_value("cursor"), cursor)) {
+            sendErrorResponse(res, 400, "Invalid request: cursor must be a value returned as next_cursor");
+            return;
+        }
         
-        for (size_t i = 0; i < users.size(); i++) {
-            if (i > 0) json << ",";
-            json << "\"" << users[i] << "\"";
+        if (req.has_param("stream")) {
+            streamUserList(res, cursor, std::move(prefix));
+            return;
         }
         
-        json << "]}";
+        // 한 페이지만 인덱스에서 바로 응답 버퍼로 기록 (사용자 수와 무관하게 페이지 크기만큼의 메모리)
+        Json::Writer& json = Json::Writer::local();
+        uint64_t count = 0;
+        uint64_t next_cursor = 0;
+        json.beginObject()
+            .key("success").boolean(true)
+            .key("users").beginArray();
+        bool more = mfa_core->scanUsers(cursor, limit, prefix, [&](std::string_view user_id) {
+            json.string(user_id);
+            count++;
+        }, next_cursor);
+        json.endArray()
+            .key("count").number(count)
+            .key("next_cursor");
+        if (more) {
+            char digits[CURSOR_HEX_DIGITS];
+            json.string(formatCursor(next_cursor, digits));
+        } else {
+            json.null();
+        }
+        json.endObject();
         
-        std::cout << "[DEBUG] Sending response: " << json.str() << std::endl;
-        sendJSONResponse(res, 200, json.str());
-        std::cout << "=== [DEBUG] List Request Completed ===" << std::endl;
+        MFA_LOG_DEBUG("SERVER", "List request: " << count << " users" << (more ? " (more)" : ""));
+        sendJSONResponse(res, 200, json.view());
         
     } catch (const std::exception& e) {
-        std::cout << "[DEBUG] Exception in handleList: " << e.what() << std::endl;
-        sendErrorResponse(res, 500, "Internal server error: " + std::string(e.what()));
+        MFA_LOG_ERROR("SERVER", "Exception in handleList: " << e.what());
+        sendErrorResponse(res, 500, "Internal server error: ", e.what());
     }
 }
 
+void MFAServer::handleClusterList(const httplib::Request& req, httplib::Response& res, size_t limit, std::string prefix) {
+    // 커서는 링의 노드별 커서를 이은 값이므로 그사이 노드가 늘었으면 처음부터 다시 받아야 함
+    std::shared_ptr<const HashRing> ring = cluster->ring();
+    const std::vector<ClusterNode>& nodes = ring->nodes();
+    std::vector<std::string> cursors;
+    if (!req.has_param("cursor")) {
+        cursors.assign(nodes.size(), std::string(CURSOR_HEX_DIGITS, '0'));
+    } else if (!parseClusterCursor(req.get_param_value("cursor"), nodes.size(), cursors)) {
+        sendErrorResponse(res, 400, "Invalid request: cursor must be a value returned as next_cursor");
+        return;
+    }
+    
+    // 노드 하나의 다음 페이지 (이 노드면 인덱스에서 바로, 아니면 그 노드의 /api/users)
+    MFACore* core = mfa_core.get();
+    Cluster* group = cluster.get();
+    auto localPage = [core](const std::string& cursor, size_t count, const std::string& prefix,
+                            std::vector<std::string>& users, std::string& next) {
+        uint64_t position = 0;
+        uint64_t next_position = 0;
+        parseCursor(cursor, position);
+        bool more = core->scanUsers(position, count, prefix, [&](std::string_view user_id) {
+            users.emplace_back(user_id);
+        }, next_position);
+        char digits[CURSOR_HEX_DIGITS];
+        next = more ? std::string(formatCursor(next_position, digits)) : std::string();
+    };
+    auto pageTarget = [](const std::string& cursor, size_t count, const std::string& prefix) {
+        std::string target = "/api/users?limit=" + std::to_string(count) + "&cursor=" + cursor;
+        if (!prefix.empty()) target += "&prefix=" + encodeQueryValue(prefix);
+        return target;
+    };
+    
+    if (req.has_param("stream")) {
+        // 노드를 링 순서대로 하나씩 끝까지 읽어 청크로 보냄
+        struct ClusterStream {
+            std::shared_ptr<const HashRing> ring;
+            std::vector<std::string> cursors;
+            std::string prefix;
+            std::string chunk;
+            std::vector<std::string> users;
+            size_t node = 0;
+            uint64_t count = 0;
+            bool started = false;
+        };
+        auto stream = std::make_shared<ClusterStream>();
+        stream->ring = ring;
+        stream->cursors = std::move(cursors);
+        stream->prefix = std::move(prefix);
+        res.set_header(CORS_ALLOW_ORIGIN, CORS_ANY_ORIGIN);
+        res.status = 200;
+        res.set_chunked_content_provider(JSON_CONTENT_TYPE,
+            [stream, group, localPage, pageTarget](size_t offset, httplib::DataSink& sink) {
+                (void)offset; // unused parameter warning 방지
+                const std::vector<ClusterNode>& members = stream->ring->nodes();
+                while (stream->node < members.size() && stream->cursors[stream->node] == CLUSTER_CURSOR_DONE) {
+                    stream->node++;
+                }
+                std::string& chunk = stream->chunk;
+                chunk.clear();
+                if (!stream->started) {
+                    chunk += "{\"success\": true, \"users\": [";
+                    stream->started = true;
+                }
+                
+                if (stream->node < members.size()) {
+                    const ClusterNode& member = members[stream->node];
+                    std::string& cursor = stream->cursors[stream->node];
+                    std::string next;
+                    stream->users.clear();
+                    if (member.id == group->nodeId()) {
+                        localPage(cursor, LIST_STREAM_PAGE_SIZE, stream->prefix, stream->users, next);
+                    } else {
+                        PeerClient::Response response;
+                        if (!group->peers().request(member, "GET", pageTarget(cursor, LIST_STREAM_PAGE_SIZE, stream->prefix),
+                                                    {}, {}, response, true) ||
+                            response.status != 200 || !parseUserPage(response.body, stream->users, next)) {
+                            MFA_LOG_WARN("SERVER", member.id << " 노드의 사용자 목록을 받지 못해 스트림을 끊습니다.");
+                            return false;
+                        }
+                    }
+                    for (const std::string& user_id : stream->users) {
+                        if (stream->count++ > 0) chunk += ',';
+                        chunk += '"';
+                        Json::appendEscaped(chunk, user_id);
+                        chunk += '"';
+                    }
+                    cursor = next.empty() ? std::string(CLUSTER_CURSOR_DONE) : next;
+                    if (next.empty()) stream->node++;
+                }
+                
+                bool more = stream->node < members.size();
+                if (!more) {
+                    chunk += "], \"count\": ";
+                    chunk += std::to_string(stream->count);
+                    chunk += ", \"next_cursor\": null}";
+                }
+                // 빈 청크는 스트림 끝으로 해석되므로 보내지 않음
+                if (!chunk.empty() && !sink.write(chunk.data(), chunk.size())) {
+                    return false;
+                }
+                if (!more) {
+                    sink.done();
+                }
+                return true;
+            },
+            [](bool success) {
+                (void)success; // unused parameter warning 방지
+            });
+        return;
+    }
+    
+    // 남은 노드에 limit을 정확히 나눠 동시에 요청 (응답 사용자 수는 limit 이하)
+    // 노드마다 limit / active명, 앞의 limit % active개 노드는 한 명 더. 몫이 0인 노드는 이번에 읽지 않고 커서를 그대로 둠
+    size_t active = 0;
+    for (const std::string& cursor : cursors) {
+        if (cursor != CLUSTER_CURSOR_DONE) active++;
+    }
+    std::vector<size_t> shares(nodes.size(), 0);
+    for (size_t i = 0, rank = 0; i < nodes.size(); i++) {
+        if (cursors[i] == CLUSTER_CURSOR_DONE) continue;
+        shares[i] = limit / active + (rank < limit % active ? 1 : 0);
+        rank++;
+    }
+    std::vector<PeerClient::Call> calls;
+    std::vector<size_t> call_node(nodes.size(), SIZE_MAX);
+    for (size_t i = 0; i < nodes.size(); i++) {
+        if (shares[i] == 0 || nodes[i].id == cluster->nodeId()) continue;
+        call_node[i] = calls.size();
+        calls.push_back(PeerClient::Call{&nodes[i], "GET", pageTarget(cursors[i], shares[i], prefix), {}, {}, {}, false,
+                                         true});
+    }
+    cluster->peers().requestAll(calls);
+    
+    std::vector<std::string> users;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        if (shares[i] == 0) continue;
+        std::string next;
+        if (call_node[i] == SIZE_MAX) {
+            localPage(cursors[i], shares[i], prefix, users, next);
+        } else {
+            const PeerClient::Call& call = calls[call_node[i]];
+            if (!call.ok || call.response.status != 200 || !parseUserPage(call.response.body, users, next)) {
+                MFA_LOG_WARN("SERVER", nodes[i].id << " 노드의 사용자 목록을 받지 못했습니다.");
+                res.set_header(RETRY_AFTER_HEADER, "1");
+                sendErrorResponse(res, 503, SHARD_UNAVAILABLE);
+                return;
+            }
+        }
+        cursors[i] = next.empty() ? std::string(CLUSTER_CURSOR_DONE) : next;
+    }
+    
+    bool more = false;
+    for (const std::string& cursor : cursors) {
+        if (cursor != CLUSTER_CURSOR_DONE) more = true;
+    }
+    Json::Writer& json = Json::Writer::local();
+    json.beginObject()
+        .key("success").boolean(true)
+        .key("users").beginArray();
+    for (const std::string& user_id : users) {
+        json.string(user_id);
+    }
+    json.endArray()
+        .key("count").number(uint64_t(users.size()))
+        .key("next_cursor");
+    if (more) {
+        json.string(formatClusterCursor(cursors));
+    } else {
+        json.null();
+    }
+    json.endObject();
+    sendJSONResponse(res, 200, json.view());
+}
+
+void MFAServer::sendRateLimitedResponse(httplib::Response& res, uint32_t retry_after_seconds) {
+    char digits[12];
+    auto result = std::to_chars(digits, digits + sizeof(digits), retry_after_seconds);
+    res.set_header(RETRY_AFTER_HEADER, std::string(digits, static_cast<size_t>(result.ptr - digits)));
+    sendJSONResponse(res, 429, RATE_LIMITED_BODY);
+}
+
+void MFAServer::streamUserList(httplib::Response& res, uint64_t cursor, std::string prefix) {
+    // 청크 하나에 LIST_STREAM_PAGE_SIZE명씩 기록하고 다음 청크는 커서에서 이어서 읽음
+    struct ListStream {
+        uint64_t cursor;
+        std::string prefix;
+        std::string chunk;
+        uint64_t count = 0;
+        bool started = false;
+    };
+    auto stream = std::make_shared<ListStream>();
+    stream->cursor = cursor;
+    stream->prefix = std::move(prefix);
+    
+    MFACore* core = mfa_core.get();
+    res.set_header(CORS_ALLOW_ORIGIN, CORS_ANY_ORIGIN);
+    res.status = 200;
+    res.set_chunked_content_provider(JSON_CONTENT_TYPE,
+        [stream, core](size_t offset, httplib::DataSink& sink) {
+            (void)offset; // unused parameter warning 방지
+            std::string& chunk = stream->chunk;
+            chunk.clear();
+            if (!stream->started) {
+                chunk += "{\"success\": true, \"users\": [";
+                stream->started = true;
+            }
+            
+            bool more = core->scanUsers(stream->cursor, LIST_STREAM_PAGE_SIZE, stream->prefix,
+                [&](std::string_view user_id) {
+                    if (stream->count++ > 0) chunk += ',';
+                    chunk += '"';
+                    Json::appendEscaped(chunk, user_id);
+                    chunk += '"';
+                }, stream->cursor);
+            
+            if (!more) {
+                chunk += "], \"count\": ";
+                chunk += std::to_string(stream->count);
+                chunk += ", \"next_cursor\": null}";
+            }
+            // 빈 청크는 스트림 끝으로 해석되므로 보내지 않음 (접두사 필터로 한 페이지가 비는 경우)
+            if (!chunk.empty() && !sink.write(chunk.data(), chunk.size())) {
+                return false;
+            }
+            if (!more) {
+                sink.done();
+            }
+            return true;
+        },
+        [](bool success) {
+            (void)success; // unused parameter warning 방지
+        });
+}
+
 void MFAServer::handleHealth(const httplib::Request& req, httplib::Response& res) {
     (void)req; // unused parameter warning 방지
-    sendJSONResponse(res, 200, "{\"status\": \"healthy\", \"service\": \"mfa-server\"}");
+    sendJSONResponse(res, 200, HEALTH_BODY);
+}
+
+void MFAServer::handleReplication(const httplib::Request& req, httplib::Response& res) {
+    (void)req; // unused parameter warning 방지
+    
+    char digits[CURSOR_HEX_DIGITS];
+    Json::Writer& json = Json::Writer::local();
+    json.beginObject();
+    if (replication_leader) {
+        uint64_t seq = replication_leader->lastSeq();
+        json.key("role").string("leader")
+            .key("epoch").string(formatCursor(replication_leader->epoch(), digits))
+            .key("seq").number(seq)
+            .key("followers").beginArray();
+        for (const auto& follower : replication_leader->followers()) {
+            json.beginObject()
+                .key("peer").string(follower.peer)
+                .key("applied_seq").number(follower.acked_seq)
+                .key("lag").number(seq - std::min(seq, follower.acked_seq))
+                .key("snapshot").boolean(follower.snapshot)
+                .endObject();
+        }
+        json.endArray();
+    } else if (replication_follower) {
+        ReplicationFollower::Status status = replication_follower->status();
+        std::string leader_url = tuning.leader_url.empty() ? replication_follower->leaderURL() : tuning.leader_url;
+        json.key("role").string("follower")
+            .key("leader").string(tuning.follow)
+            .key("leader_url").string(leader_url)
+            .key("connected").boolean(status.connected)
+            .key("epoch").string(formatCursor(status.epoch, digits))
+            .key("applied_seq").number(status.applied_seq)
+            .key("leader_seq").number(status.leader_seq)
+            .key("lag").number(status.leader_seq - std::min(status.leader_seq, status.applied_seq))
+            .key("lag_ms").number(static_cast<uint64_t>(status.lag_seconds * 1000))
+            .key("resyncs").number(status.resyncs);
+    } else {
+        json.key("role").string("standalone");
+    }
+    json.key("users").number(static_cast<uint64_t>(mfa_core->userCount()))
+        .endObject();
+    sendJSONResponse(res, 200, json.view());
+}
+
+void MFAServer::handleCluster(const httplib::Request& req, httplib::Response& res) {
+    (void)req; // unused parameter warning 방지
+    
+    Json::Writer& json = Json::Writer::local();
+    json.beginObject();
+    if (!cluster) {
+        json.key("enabled").boolean(false);
+    } else {
+        Cluster::Status status = cluster->status();
+        json.key("enabled").boolean(true)
+            .key("node_id");
+        if (cluster->nodeId().empty()) {
+            json.null();    // 라우터
+        } else {
+            json.string(cluster->nodeId());
+        }
+        json.key("version").number(status.ring->version())
+            .key("vnodes").number(uint64_t(status.ring->vnodes()))
+            .key("nodes").beginArray();
+        char share[16];
+        for (size_t i = 0; i < status.ring->nodes().size(); i++) {
+            const ClusterNode& node = status.ring->nodes()[i];
+            snprintf(share, sizeof(share), "%.4f", status.ring->share(i));
+            json.beginObject()
+                .key("id").string(node.id)
+                .key("address").string(node.address())
+                .key("share").raw(share)
+                .endObject();
+        }
+        json.endArray()
+            .key("rebalance");
+        if (status.pending || status.coordinating || !status.last_error.empty()) {
+            json.beginObject()
+                .key("state").string(Cluster::stateName(status.state))
+                .key("version").number(status.pending ? status.pending->version() : status.ring->version())
+                .key("coordinating").boolean(status.coordinating)
+                .key("moving_users").number(uint64_t(status.moving_users))
+                .key("sent_users").number(uint64_t(status.sent_users));
+            if (!status.last_error.empty()) {
+                json.key("error").string(status.last_error);
+            }
+            json.endObject();
+        } else {
+            json.null();
+        }
+    }
+    json.key("users").number(static_cast<uint64_t>(mfa_core->userCount()))
+        .endObject();
+    sendJSONResponse(res, 200, json.view());
+}
+
+void MFAServer::handleClusterJoin(const httplib::Request& req, httplib::Response& res) {
+    // 참여한 노드는 재배치로 TOTP 비밀키를 받으므로 노드끼리 쓰는 내부 리스너에서만 받는다
+    if (!cluster || !cluster_request) {
+        res.status = 404;   // 공개 포트에는 없는 경로
+        return;
+    }
+    
+    // 본문: {"id": "<노드 id>", "address": "<내부 리스너 host:port>"}
+    static constexpr std::string_view JOIN_FIELDS[] = {"id", "address"};
+    std::string_view fields[2];
+    char scratch[REQUEST_SCRATCH_SIZE];
+    Json::Error parse_error = Json::parseStringFields(req.body, JOIN_FIELDS, fields, 2, scratch, sizeof(scratch));
+    if (parse_error != Json::Error::None) {
+        sendErrorResponse(res, statusForParseError(parse_error), "Invalid request: ", Json::errorMessage(parse_error));
+        return;
+    }
+    ClusterNode node;
+    node.id.assign(fields[0]);
+    if (node.id.empty() || !ReplicationFollower::parseAddress(fields[1], node.host, node.port)) {
+        sendErrorResponse(res, 400, "Invalid request: id and address (host:port) are required");
+        return;
+    }
+    
+    std::string error;
+    if (!cluster->addNode(node, error)) {
+        sendErrorResponse(res, error == "Invalid node" ? 400 : 409, error);
+        return;
+    }
+    Json::Writer& json = Json::Writer::local();
+    json.beginObject()
+        .key("success").boolean(true)
+        .key("message").string("Rebalance started for node '", node.id, "'")
+        .endObject();
+    sendJSONResponse(res, 202, json.view());
+}
+
+void MFAServer::handleClusterInternal(const httplib::Request& req, httplib::Response& res) {
+    using BinaryProtocol::Status;
+    if (!cluster || !cluster_request) {
+        res.status = 404;   // 공개 포트에는 없는 경로
+        return;
+    }
+    
+    std::string_view action = std::string_view(req.path).substr(req.path.find_last_of('/') + 1);
+    const std::string TEXT_CONTENT_TYPE = "text/plain";
+    std::string error;
+    if (action == "ring") {
+        res.set_content(cluster->ring()->serialize(), TEXT_CONTENT_TYPE);
+    } else if (action == "migration") {
+        uint64_t version = 0;
+        Cluster::MigrationState state = cluster->migrationState(version);
+        res.set_content(std::string(Cluster::stateName(state)) + " " + std::to_string(version) + "\n", TEXT_CONTENT_TYPE);
+    } else if (action == "prepare") {
+        HashRing next;
+        if (!HashRing::parse(req.body, next)) {
+            res.status = 400;
+            res.set_content("invalid ring\n", TEXT_CONTENT_TYPE);
+        } else if (!cluster->prepare(next, error)) {
+            res.status = 409;
+            res.set_content(error + "\n", TEXT_CONTENT_TYPE);
+        } else {
+            res.set_content("ok\n", TEXT_CONTENT_TYPE);
+        }
+    } else if (action == "commit" || action == "abort") {
+        uint64_t version = 0;
+        std::string_view body = req.body;
+        while (!body.empty() && (body.back() == '\n' || body.back() == '\r')) body.remove_suffix(1);
+        if (!parseNumber<uint64_t>(body, 1, UINT64_MAX, version)) {
+            res.status = 400;
+        } else if (action == "commit" ? !cluster->commit(version) : !cluster->abort(version)) {
+            res.status = 409;
+        }
+        res.set_content(res.status == 200 ? "ok\n" : "rejected\n", TEXT_CONTENT_TYPE);
+    } else if (action == "transfer") {
+        // 재배치로 옮겨 오는 사용자 (덮어쓰기/삭제라 다시 받아도 같음)
+        if (!cluster->applyTransfer(req.body)) {
+            res.status = 500;
+        }
+        res.set_content(res.status == 200 ? "ok\n" : "failed\n", TEXT_CONTENT_TYPE);
+    } else if (action == "verify") {
+        // (str user_id | str otp_code)... -> (u8 상태 | u16 retry_after)...
+        ClusterProtocol::Reader reader(req.body.data(), req.body.size());
+        std::vector<AuthItem> items;
+        while (!reader.atEnd()) {
+            std::string_view user_id = reader.str();
+            std::string_view otp_code = reader.str();
+            if (!reader.ok()) {
+                res.status = 400;
+                return;
+            }
+            items.push_back(AuthItem{std::string(user_id), std::string(otp_code)});
+        }
+        
+        // 이 노드가 맡지 않은 사용자(링이 바뀜)와 시도 제한에 걸린 사용자는 검증하지 않음 (OTP를 비워 건너뜀)
+        std::vector<Status> statuses(items.size(), Status::Ok);
+        std::vector<uint16_t> retry(items.size(), 0);
+        std::vector<char> decided(items.size(), 0);
+        for (size_t i = 0; i < items.size(); i++) {
+            uint32_t retry_after = 0;
+            if (!cluster->owns(items[i].user_id)) {
+                statuses[i] = Status::ServerError;
+            } else if (rate_limiter && !rate_limiter->allowUser(items[i].user_id, retry_after)) {
+                Metrics::addRateLimited();
+                statuses[i] = Status::RateLimited;
+                retry[i] = static_cast<uint16_t>(std::min<uint32_t>(retry_after, UINT16_MAX));
+            } else {
+                continue;
+            }
+            decided[i] = 1;
+            items[i].otp_code.clear();
+        }
+        std::vector<AuthItemResult> results = mfa_core->verifyTOTPBatch(items, ALLOWED_DRIFT_STEPS, 1);
+        
+        std::string body;
+        body.reserve(items.size() * 3);
+        for (size_t i = 0; i < items.size(); i++) {
+            Status status = decided[i]                ? statuses[i]
+                            : results[i].success       ? Status::Ok
+                            : results[i].valid_request ? Status::Invalid
+                                                       : Status::BadRequest;
+            ClusterProtocol::putU8(body, static_cast<uint8_t>(status));
+            ClusterProtocol::putU16(body, retry[i]);
+        }
+        res.set_content(std::move(body), ClusterProtocol::CONTENT_TYPE);
+    } else if (action == "import") {
+        // (str user_id | str secret)... -> (u8 ImportStatus)...
+        ClusterProtocol::Reader reader(req.body.data(), req.body.size());
+        std::vector<ImportItem> items;
+        while (!reader.atEnd()) {
+            std::string_view user_id = reader.str();
+            std::string_view secret = reader.str();
+            if (!reader.ok()) {
+                res.status = 400;
+                return;
+            }
+            items.push_back(ImportItem{std::string(user_id), std::string(secret)});
+        }
+        
+        std::vector<ImportStatus> statuses(items.size(), ImportStatus::Failed);
+        std::vector<size_t> owned;
+        for (size_t i = 0; i < items.size(); i++) {
+            if (cluster->owns(items[i].user_id)) owned.push_back(i);
+        }
+        importOnThisNode(items, owned, statuses);
+        
+        std::string body;
+        body.reserve(statuses.size());
+        for (ImportStatus status : statuses) {
+            ClusterProtocol::putU8(body, static_cast<uint8_t>(status));
+        }
+        res.set_content(std::move(body), ClusterProtocol::CONTENT_TYPE);
+    }
+}
+
+void MFAServer::handleMetrics(const httplib::Request& req, httplib::Response& res) {
+    (void)req; // unused parameter warning 방지
+    
+    try {
+        std::string body;
+        body.reserve(32 * 1024);
+        Metrics::render(body);
+        Metrics::renderGauge(body, "mfa_users", "Registered users.", static_cast<double>(mfa_core->userCount()));
+        Metrics::renderGauge(body, "mfa_qr_cache_bytes", "QR image render cache size in bytes.",
+                             static_cast<double>(qr_cache.bytes()));
+#ifdef HTTPLIB_AVAILABLE
+        if (event_server) {
+            Metrics::renderGauge(body, "mfa_http_open_connections", "Open connections on the epoll listener.",
+                                 static_cast<double>(event_server->connectionCount()));
+        }
+#endif
+        if (binary_server) {
+            Metrics::renderGauge(body, "mfa_binary_open_connections", "Open connections on the binary protocol listener.",
+                                 static_cast<double>(binary_server->connectionCount()));
+        }
+        if (replication_leader) {
+            uint64_t seq = replication_leader->lastSeq();
+            std::vector<ReplicationLeader::FollowerStatus> followers = replication_leader->followers();
+            uint64_t max_lag = 0;
+            for (const auto& follower : followers) {
+                max_lag = std::max(max_lag, seq - std::min(seq, follower.acked_seq));
+            }
+            Metrics::renderGauge(body, "mfa_replication_seq", "Last replication sequence number on the leader.",
+                                 static_cast<double>(seq));
+            Metrics::renderGauge(body, "mfa_replication_followers", "Connected replication followers.",
+                                 static_cast<double>(followers.size()));
+            Metrics::renderGauge(body, "mfa_replication_max_follower_lag", "Largest follower lag in unacknowledged changes.",
+                                 static_cast<double>(max_lag));
+        }
+        if (replication_follower) {
+            ReplicationFollower::Status status = replication_follower->status();
+            Metrics::renderGauge(body, "mfa_replication_connected", "Whether the follower is connected to its leader.",
+                                 status.connected ? 1.0 : 0.0);
+            Metrics::renderGauge(body, "mfa_replication_applied_seq", "Last replication sequence number applied.",
+                                 static_cast<double>(status.applied_seq));
+            Metrics::renderGauge(body, "mfa_replication_lag_entries", "Changes the leader has that are not applied yet.",
+                                 static_cast<double>(status.leader_seq - std::min(status.leader_seq, status.applied_seq)));
+            Metrics::renderGauge(body, "mfa_replication_lag_seconds", "Seconds the follower has been behind the leader.",
+                                 status.lag_seconds);
+            Metrics::renderGauge(body, "mfa_replication_last_contact_seconds",
+                                 "Seconds since the last frame from the leader (-1 if never).", status.last_contact_seconds);
+            Metrics::renderGauge(body, "mfa_replication_resyncs", "Full snapshot resynchronizations.",
+                                 static_cast<double>(status.resyncs));
+        }
+        
+        if (cluster) {
+            Cluster::Status status = cluster->status();
+            Metrics::renderGauge(body, "mfa_cluster_ring_version", "Hash ring version this node routes with.",
+                                 static_cast<double>(status.ring->version()));
+            Metrics::renderGauge(body, "mfa_cluster_nodes", "Nodes in the hash ring.",
+                                 static_cast<double>(status.ring->nodes().size()));
+            Metrics::renderGauge(body, "mfa_cluster_rebalancing", "Whether a rebalance is in progress on this node.",
+                                 status.pending ? 1.0 : 0.0);
+            Metrics::renderGauge(body, "mfa_cluster_moving_users", "Users this node is moving in the current rebalance.",
+                                 static_cast<double>(status.pending ? status.moving_users : 0));
+        }
+        
+        res.status = 200;
+        res.set_header(CACHE_CONTROL_HEADER, NO_STORE);
+        res.set_content(std::move(body), METRICS_CONTENT_TYPE);
+    } catch (const std::exception& e) {
+        MFA_LOG_ERROR("SERVER", "Exception in handleMetrics: " << e.what());
+        sendErrorResponse(res, 500, "Internal server error: " + std::string(e.what()));
+    }
 }
@@ -1,9 +1,93 @@
 #ifndef SERVER_H
 #define SERVER_H
 
+#include <ctime>
+#include <iosfwd>
 #include <string>
+#include <string_view>
 #include <memory>
+#include <thread>
+#include <vector>
 #include "mfa_core.h"
+#include "rate_limiter.h"
+#include "qr_code.h"
+#include "tls_config.h"
+#include "binary_server.h"
+#include "replication.h"
+#include "cluster.h"
+
+constexpr size_t DEFAULT_MAX_BATCH_SIZE = 1000;
+constexpr size_t DEFAULT_LIST_LIMIT = 1000;          // GET /api/users 기본 페이지 크기
+constexpr size_t MAX_LIST_LIMIT = 10000;             // GET /api/users 최대 페이지 크기
+constexpr size_t LIST_STREAM_PAGE_SIZE = 1000;       // 스트리밍 목록 청크 하나에 담는 사용자 수
+constexpr RateLimit DEFAULT_USER_RATE_LIMIT{10, 60};  // 사용자별 인증 시도: 60초에 10번
+constexpr RateLimit DEFAULT_IP_RATE_LIMIT{600, 60};   // 클라이언트 IP별 인증 시도: 60초에 600번
+constexpr size_t DEFAULT_QR_CACHE_BYTES = 8 * 1024 * 1024;  // QR 이미지 렌더링 캐시 크기
+constexpr size_t DEFAULT_MAX_IMPORT_ITEMS = 1000000;  // POST /api/users/bulk 요청당 최대 사용자 수
+constexpr size_t BULK_IMPORT_CHUNK_ITEMS = 65536;     // 본문을 읽는 동안 이만큼 모이면 등록
+
+/**
+ * @brief 연결을 받아 처리하는 방식
+ */
+enum class ListenerMode {
+    Threads,    // httplib: 연결 하나가 keep-alive 동안 작업 스레드 하나를 차지
+    Epoll       // EventServer: 리액터 스레드 몇 개가 epoll로 모든 연결을 나눠 맡음
+};
+
+/**
+ * @brief HTTP 작업 스레드와 연결 설정 (기본값은 httplib 기본값과 같음)
+ */
+struct ServerTuning {
+    ListenerMode listener = ListenerMode::Threads;
+    size_t event_threads = 0;           // epoll 리스너의 리액터 스레드 수 (0이면 코어 수)
+    size_t worker_threads = 0;          // 0이면 max(8, 코어 수 - 1)
+    size_t max_queued = 0;              // 작업 스레드를 기다릴 수 있는 연결 수 (0이면 제한 없음, 넘으면 바로 닫음)
+    bool pin_workers = false;           // 작업 스레드를 CPU에 하나씩 고정
+    size_t keep_alive_max_count = 5;    // 연결 하나로 처리할 최대 요청 수
+    time_t keep_alive_timeout_sec = 5;  // 요청 사이 유휴 연결 유지 시간
+    time_t read_timeout_sec = 5;
+    time_t write_timeout_sec = 5;
+    int listen_backlog = 5;             // 수락 대기열 길이
+    bool tcp_nodelay = false;
+    TLS::Settings tls;                  // --cert/--key를 줄 때만 사용
+    int binary_port = 0;                // 바이너리 검증 프로토콜 TCP 포트 (0이면 끔)
+    std::string binary_socket;          // 바이너리 검증 프로토콜 Unix 소켓 경로 (비우면 끔)
+    size_t binary_threads = 1;          // 바이너리 리스너 리액터 스레드 수
+    int replication_port = 0;           // 복제 리더로서 팔로워 연결을 받을 포트 (0이면 끔)
+    std::string follow;                 // 따를 리더의 복제 주소 host:port (비우면 팔로워가 아님)
+    std::string leader_url;             // 팔로워가 쓰기 요청을 돌려보낼 주소 (비우면 리더가 알려 준 HTTP 포트)
+    size_t replication_log_entries = DEFAULT_REPLICATION_LOG_ENTRIES;
+    std::string replication_key_file;   // 리더와 팔로워가 나눠 가진 복제 키 파일 (복제를 쓰면 필수)
+    std::string replication_bind = "0.0.0.0";  // 복제 포트를 열 주소
+    std::vector<ClusterNode> cluster_nodes;  // 샤딩 클러스터 구성 (비우면 단일 노드)
+    std::string node_id;                // 이 노드의 id (비우면 사용자를 맡지 않는 라우터)
+    std::string cluster_key_file;       // 노드끼리 나눠 가진 클러스터 키 파일 (--cluster를 쓰면 필수)
+    size_t cluster_vnodes = DEFAULT_CLUSTER_VNODES;
+    size_t cluster_threads = 2;         // 노드 간 요청을 받는 내부 리스너 리액터 스레드 수
+    size_t cluster_forward_threads = 16;  // 다른 노드를 기다리는 요청을 epoll/바이너리 리스너 대신 처리할 작업 스레드 수
+
+    /**
+     * @brief 명령행 옵션 하나 적용 (--listener, --event-threads, --workers, --max-queue, --pin-workers,
+     *        --keep-alive-max, --keep-alive-timeout, --read-timeout, --write-timeout, --backlog, --tcp-nodelay,
+     *        --tls-*, --ecdsa-cert, --ecdsa-key, --binary-port, --binary-socket, --binary-threads,
+     *        --replication-port, --replication-log, --replication-key, --replication-bind, --follow, --leader-url,
+     *        --cluster, --node-id, --cluster-key, --cluster-vnodes, --cluster-threads, --cluster-forward-threads)
+     * @param name 옵션 이름 ("--" 포함)
+     * @param value 값 (켜고 끄는 옵션은 on/off)
+     * @return 튜닝 옵션이 아니면 false, 값이 잘못되면 error에 메시지를 담고 false
+     */
+    static bool parseOption(std::string_view name, std::string_view value, ServerTuning& tuning, std::string& error);
+
+    /**
+     * @brief parseOption이 받는 옵션 이름인지
+     */
+    static bool isOption(std::string_view name);
+
+    /**
+     * @brief 옵션 도움말 출력 (printUsage용)
+     */
+    static void printUsage(std::ostream& out);
+};
 
 // cpp-httplib 사용 여부 확인 및 조건부 포함
 #if __has_include(<httplib.h>)
@@ -17,16 +101,24 @@
     namespace httplib {
         struct Request { std::string body; };
         struct Response { int status = 200; };
+        struct ContentReader {
+            template<typename Receiver>
+            bool operator()(Receiver receiver) const { (void)receiver; return false; }
+        };
         class Server {};
         class SSLServer {};
     }
 #endif
 
+class EventServer;
+
 /**
  * @brief MFA HTTPS 서버 클래스
  */
 class MFAServer {
 private:
+    struct RouteEntry;
+
 #ifdef HTTPLIB_AVAILABLE
     std::unique_ptr<httplib::SSLServer> ssl_server;
     std::unique_ptr<httplib::Server> http_server;
@@ -34,27 +126,72 @@ private:
     void* ssl_server = nullptr;  // 더미 포인터
     void* http_server = nullptr; // 더미 포인터
 #endif
+    // 복제 (MFACore가 이들의 통지 함수를 들고 있으므로 mfa_core보다 먼저 선언해 나중에 소멸)
+    std::unique_ptr<ReplicationLeader> replication_leader;      // --replication-port일 때만
+    std::unique_ptr<ReplicationFollower> replication_follower;  // --follow일 때만
     std::unique_ptr<MFACore> mfa_core;
+    // 샤딩 (재배치 스레드가 MFACore를 쓰므로 mfa_core보다 나중에 선언해 먼저 소멸)
+    std::unique_ptr<Cluster> cluster;                           // --cluster일 때만
+    std::string user_file;
     
     int port;
     bool use_ssl;
     std::string cert_path;
     std::string key_path;
+    size_t max_batch_size = DEFAULT_MAX_BATCH_SIZE;
+    size_t max_import_items = DEFAULT_MAX_IMPORT_ITEMS;
+    std::unique_ptr<RateLimiter> rate_limiter;           // 인증 시도 제한 (없으면 제한 없음)
+    QRCode::RenderCache qr_cache{DEFAULT_QR_CACHE_BYTES};
+    ServerTuning tuning;
+    int listen_socket = -1;                              // 수락 대기열 길이를 바꾸기 위해 기억
+    std::vector<RouteEntry> routes;
+    std::unique_ptr<EventServer> event_server;           // --listener epoll일 때만
+    std::unique_ptr<BinaryServer> binary_server;         // --binary-port/--binary-socket일 때만
+    std::unique_ptr<EventServer> cluster_server;         // 노드 간 요청 리스너 (--node-id일 때만)
+    std::thread cluster_thread;
 
     // 핸들러 메서드들
     void handleRegister(const httplib::Request& req, httplib::Response& res);
     void handleAuthenticate(const httplib::Request& req, httplib::Response& res);
+    void handleAuthenticateBatch(const httplib::Request& req, httplib::Response& res);
     void handleDelete(const httplib::Request& req, httplib::Response& res);
     void handleList(const httplib::Request& req, httplib::Response& res);
     void handleHealth(const httplib::Request& req, httplib::Response& res);
+    void handleMetrics(const httplib::Request& req, httplib::Response& res);
+    void handleQRCode(const httplib::Request& req, httplib::Response& res);
+    void handleBulkImport(const httplib::Request& req, httplib::Response& res,
+                          const httplib::ContentReader& content_reader);
+    void handleBinaryVerify(BinaryServer::Item* items, size_t count, const std::string& peer);
+    void handleReplication(const httplib::Request& req, httplib::Response& res);
+    void handleCluster(const httplib::Request& req, httplib::Response& res);
+    void handleClusterJoin(const httplib::Request& req, httplib::Response& res);
+    void handleClusterInternal(const httplib::Request& req, httplib::Response& res);
 
     // 유틸리티 메서드들
     void setupRoutes();
     void setupCORS(httplib::Response& res);
     void setupErrorHandlers();
+    void setupMetrics();
+    bool applyTuning();
+    bool startEventListener();
+    bool startBinaryListener();
+    bool startReplication();
+    bool rejectFollowerWrite(const httplib::Request& req, httplib::Response& res);
+    bool startCluster();
+    bool forwardToOwner(const httplib::Request& req, httplib::Response& res, std::string_view user_id);
+    bool waitsOnPeers(const httplib::Request& req) const;
+    void verifyOnOwners(const std::vector<AuthItem>& items, const std::vector<ClusterNode>& owners,
+                        std::vector<BinaryProtocol::Status>& statuses, std::vector<uint16_t>& retry_after);
+    std::vector<ImportStatus> importAcrossCluster(std::vector<ImportItem>& items);
+    void importOnThisNode(std::vector<ImportItem>& items, const std::vector<size_t>& indices,
+                          std::vector<ImportStatus>& statuses);
+    void handleClusterList(const httplib::Request& req, httplib::Response& res, size_t limit, std::string prefix);
+    void dispatchEvent(httplib::Request& req, httplib::Response& res);
     bool validateJSONRequest(const std::string& body);
-    void sendJSONResponse(httplib::Response& res, int status, const std::string& json);
-    void sendErrorResponse(httplib::Response& res, int status, const std::string& message);
+    void sendJSONResponse(httplib::Response& res, int status, std::string_view json);
+    void sendErrorResponse(httplib::Response& res, int status, std::string_view message, std::string_view detail = {});
+    void streamUserList(httplib::Response& res, uint64_t cursor, std::string prefix);
+    void sendRateLimitedResponse(httplib::Response& res, uint32_t retry_after_seconds);
 
 public:
     /**
@@ -63,11 +200,13 @@ public:
      * @param cert_path SSL 인증서 파일 경로 (선택사항)
      * @param key_path SSL 키 파일 경로 (선택사항)
      * @param user_file 사용자 데이터 파일 경로
+     * @param storage_mode 사용자 저장소 방식
      */
     MFAServer(int port, 
               const std::string& cert_path = "", 
               const std::string& key_path = "",
-              const std::string& user_file = DEFAULT_USER_FILE);
+              const std::string& user_file = DEFAULT_USER_FILE,
+              StorageMode storage_mode = StorageMode::Memory);
 
     /**
      * @brief 소멸자
@@ -85,6 +224,33 @@ public:
      */
     void stop();
 
+    /**
+     * @brief 일괄 인증 요청 한 번에 허용할 최대 항목 수 설정
+     * @param size 최대 항목 수
+     */
+    void setMaxBatchSize(size_t size) { max_batch_size = size; }
+
+    /**
+     * @brief 대량 등록 요청 한 번에 허용할 최대 사용자 수 설정
+     * @param count 최대 사용자 수
+     */
+    void setMaxImportItems(size_t count) { max_import_items = count; }
+
+    /**
+     * @brief 인증 시도 제한 설정 (둘 다 꺼져 있으면 제한기를 두지 않음)
+     * @param user_limit 사용자별 한도
+     * @param ip_limit 클라이언트 IP별 한도
+     */
+    void setRateLimits(const RateLimit& user_limit, const RateLimit& ip_limit);
+
+    /**
+     * @brief 작업 스레드/연결 설정 (start() 전에 호출)
+     * @param server_tuning 설정값
+     */
+    void setTuning(const ServerTuning& server_tuning) { tuning = server_tuning; }
+
+    const ServerTuning& getTuning() const { return tuning; }
+
     /**
      * @brief SSL 사용 여부 확인
      * @return SSL 사용 시 true, HTTP 사용 시 false
@@ -0,0 +1,103 @@
+#ifndef SHA1_LANES_H
+#define SHA1_LANES_H
+
+// SIMD 레인별 HMAC-SHA1(8바이트 카운터) 템플릿
+//
+// GCC 벡터 확장 타입 V(uint32_t x LANES)로 레인마다 독립된 SHA-1 상태를
+// 동시에 압축합니다. ISA 전용 번역 단위(-mavx2 등)에서 포함되므로
+// 서로 다른 인스턴스가 섞이지 않도록 익명 네임스페이스에 둡니다.
+
+#include <cstddef>
+#include <cstdint>
+#include "hmac_sha1.h"
+
+namespace {
+
+template <typename V, int LANES>
+struct SHA1Lanes {
+    static inline V rotl(V x, int n) {
+        return (x << n) | (x >> (32 - n));
+    }
+
+    static inline V splat(uint32_t value) {
+        V v = {};
+        return v + value;
+    }
+
+    static void compress(V state[5], V w[16]) {
+        V a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+
+#define LANE_W(i) (w[(i) & 15] = rotl(w[((i) + 13) & 15] ^ w[((i) + 8) & 15] ^ w[((i) + 2) & 15] ^ w[(i) & 15], 1))
+#define LANE_ROUND(f, k, wi) { V t = rotl(a, 5) + (f) + e + splat(k) + (wi); e = d; d = c; c = rotl(b, 30); b = a; a = t; }
+        for (int i = 0; i < 16; i++) LANE_ROUND((b & c) | (~b & d), 0x5A827999u, w[i])
+        for (int i = 16; i < 20; i++) LANE_ROUND((b & c) | (~b & d), 0x5A827999u, LANE_W(i))
+        for (int i = 20; i < 40; i++) LANE_ROUND(b ^ c ^ d, 0x6ED9EBA1u, LANE_W(i))
+        for (int i = 40; i < 60; i++) LANE_ROUND((b & c) | (b & d) | (c & d), 0x8F1BBCDCu, LANE_W(i))
+        for (int i = 60; i < 80; i++) LANE_ROUND(b ^ c ^ d, 0xCA62C1D6u, LANE_W(i))
+#undef LANE_ROUND
+#undef LANE_W
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+    }
+
+    /**
+     * @brief 최대 LANES개의 (키, 카운터) 쌍을 한 번에 계산
+     */
+    static void hmacCounters(const HMACKeyState* const* keys, const uint64_t* counters, int count, int* codes) {
+        V h[5], o[5], w[16];
+
+        // 빈 레인은 0번 레인 값으로 채움
+        for (int j = 0; j < 5; j++) {
+            for (int l = 0; l < LANES; l++) {
+                int src = l < count ? l : 0;
+                h[j][l] = keys[src]->inner[j];
+                o[j][l] = keys[src]->outer[j];
+            }
+        }
+
+        // 내부 해시 블록: counter || 0x80 || 0... || 길이(576비트)
+        for (int l = 0; l < LANES; l++) {
+            uint64_t counter = counters[l < count ? l : 0];
+            w[0][l] = static_cast<uint32_t>(counter >> 32);
+            w[1][l] = static_cast<uint32_t>(counter);
+        }
+        w[2] = splat(0x80000000u);
+        for (int i = 3; i < 15; i++) w[i] = splat(0);
+        w[15] = splat((SHA1_BLOCK_LENGTH + 8) * 8);
+        compress(h, w);
+
+        // 외부 해시 블록: inner_digest || 0x80 || 0... || 길이(672비트)
+        for (int i = 0; i < 5; i++) w[i] = h[i];
+        w[5] = splat(0x80000000u);
+        for (int i = 6; i < 15; i++) w[i] = splat(0);
+        w[15] = splat((SHA1_BLOCK_LENGTH + SHA1_DIGEST_LENGTH) * 8);
+        compress(o, w);
+
+        for (int l = 0; l < count; l++) {
+            unsigned char digest[SHA1_DIGEST_LENGTH];
+            for (int j = 0; j < 5; j++) {
+                uint32_t word = o[j][l];
+                digest[j * 4] = static_cast<unsigned char>(word >> 24);
+                digest[j * 4 + 1] = static_cast<unsigned char>(word >> 16);
+                digest[j * 4 + 2] = static_cast<unsigned char>(word >> 8);
+                digest[j * 4 + 3] = static_cast<unsigned char>(word);
+            }
+            codes[l] = HMACSHA1::truncate(digest);
+        }
+    }
+
+    static void batch(const HMACKeyState* const* keys, const uint64_t* counters, size_t count, int* codes) {
+        for (size_t i = 0; i < count; i += LANES) {
+            int n = static_cast<int>(count - i < static_cast<size_t>(LANES) ? count - i : LANES);
+            hmacCounters(keys + i, counters + i, n, codes + i);
+        }
+    }
+};
+
+} // namespace
+
+#endif // SHA1_LANES_H
@@ -0,0 +1,275 @@
+#include "tls_config.h"
+#include "metrics.h"
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <vector>
+#include <openssl/core_names.h>
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+#include <openssl/ssl.h>
+
+namespace {
+
+    constexpr size_t TICKET_NAME_BYTES = 16;
+    constexpr size_t TICKET_SECRET_BYTES = 32;
+    constexpr size_t MAX_TICKET_KEYS = 8;                // 현재 키 + 아직 유효한 티켓을 풀 이전 키들
+    const unsigned char SESSION_ID_CONTEXT[] = "mfa-server";
+
+    struct TicketKey {
+        unsigned char name[TICKET_NAME_BYTES];
+        unsigned char aes[TICKET_SECRET_BYTES];
+        unsigned char hmac[TICKET_SECRET_BYTES];
+    };
+
+    /**
+     * @brief 회전 주기마다 마스터 키에서 유도하는 티켓 키 묶음 (여러 리액터/작업 스레드가 공유)
+     */
+    class TicketKeys {
+    public:
+        TicketKeys(std::vector<unsigned char> master, uint32_t rotation_sec, uint32_t lifetime_sec)
+            : master(std::move(master)), rotation_sec(rotation_sec) {
+            // 수명 안의 티켓을 만든 키가 모두 남도록 (회전하지 않으면 키 하나)
+            size_t needed = rotation_sec ? 1 + (lifetime_sec + rotation_sec - 1) / rotation_sec : 1;
+            key_count = std::min(needed, MAX_TICKET_KEYS);
+        }
+
+        // 새 티켓을 암호화할 키
+        TicketKey current() {
+            std::lock_guard<std::mutex> lock(mutex);
+            refresh();
+            return keys.front();
+        }
+
+        // 티켓 이름으로 키 찾기 (is_current면 다시 발급할 필요 없음)
+        bool find(const unsigned char* name, TicketKey& key, bool& is_current) {
+            std::lock_guard<std::mutex> lock(mutex);
+            refresh();
+            for (size_t i = 0; i < keys.size(); i++) {
+                if (memcmp(keys[i].name, name, TICKET_NAME_BYTES) == 0) {
+                    key = keys[i];
+                    is_current = i == 0;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    private:
+        std::vector<unsigned char> master;
+        uint32_t rotation_sec;
+        size_t key_count;
+        std::mutex mutex;
+        uint64_t period = UINT64_MAX;
+        std::vector<TicketKey> keys;            // [0]이 현재 주기
+
+        // 인스턴스끼리 같은 주기 번호를 쓰도록 벽시계 기준
+        uint64_t currentPeriod() const {
+            if (rotation_sec == 0) return 0;
+            auto now = std::chrono::system_clock::now().time_since_epoch();
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::seconds>(now).count()) / rotation_sec;
+        }
+
+        void derive(const char* label, uint64_t index, unsigned char* out, size_t size) const {
+            unsigned char input[24] = {0};
+            size_t label_length = std::min<size_t>(strlen(label), 16);
+            memcpy(input, label, label_length);
+            for (int i = 0; i < 8; i++) input[16 + i] = static_cast<unsigned char>(index >> (56 - 8 * i));
+            unsigned char digest[EVP_MAX_MD_SIZE];
+            unsigned int digest_length = 0;
+            HMAC(EVP_sha256(), master.data(), static_cast<int>(master.size()), input, sizeof(input), digest,
+                 &digest_length);
+            memcpy(out, digest, std::min<size_t>(size, digest_length));
+        }
+
+        void refresh() {
+            uint64_t now = currentPeriod();
+            if (now == period) return;
+            period = now;
+            keys.clear();
+            for (size_t i = 0; i < key_count && i <= now; i++) {
+                TicketKey key;
+                derive("mfa ticket name", now - i, key.name, sizeof(key.name));
+                derive("mfa ticket aes", now - i, key.aes, sizeof(key.aes));
+                derive("mfa ticket hmac", now - i, key.hmac, sizeof(key.hmac));
+                keys.push_back(key);
+            }
+        }
+    };
+
+    void freeTicketKeys(void* parent, void* ptr, CRYPTO_EX_DATA* ad, int index, long argl, void* argp) {
+        (void)parent; (void)ad; (void)index; (void)argl; (void)argp; // unused parameter warning 방지
+        delete static_cast<TicketKeys*>(ptr);
+    }
+
+    int ticketKeysIndex() {
+        static const int index = SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, freeTicketKeys);
+        return index;
+    }
+
+    // 연결마다 핸드셰이크 완료를 한 번만 세기 위한 표시 (TLS 1.3은 티켓을 보낼 때도 HANDSHAKE_DONE이 옴)
+    int countedIndex() {
+        static const int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+        return index;
+    }
+
+    bool setMacKey(EVP_MAC_CTX* mac, unsigned char* key) {
+        char digest[] = "SHA256";
+        OSSL_PARAM params[] = {
+            OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY, key, TICKET_SECRET_BYTES),
+            OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, digest, 0),
+            OSSL_PARAM_construct_end(),
+        };
+        return EVP_MAC_CTX_set_params(mac, params) == 1;
+    }
+
+    // 반환값: 1 = 사용, 2 = 이전 키로 풀었으니 새 티켓 발급, 0 = 모르는 키(전체 핸드셰이크), -1 = 오류
+    int ticketKeyCallback(SSL* ssl, unsigned char* key_name, unsigned char* iv, EVP_CIPHER_CTX* cipher,
+                          EVP_MAC_CTX* mac, int encrypt) {
+        auto* keys = static_cast<TicketKeys*>(SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), ticketKeysIndex()));
+        if (!keys) return -1;
+
+        if (encrypt) {
+            TicketKey key = keys->current();
+            if (RAND_bytes(iv, EVP_MAX_IV_LENGTH) != 1) return -1;
+            memcpy(key_name, key.name, TICKET_NAME_BYTES);
+            if (EVP_EncryptInit_ex(cipher, EVP_aes_256_cbc(), nullptr, key.aes, iv) != 1) return -1;
+            return setMacKey(mac, key.hmac) ? 1 : -1;
+        }
+
+        TicketKey key;
+        bool is_current = false;
+        if (!keys->find(key_name, key, is_current)) return 0;
+        if (!setMacKey(mac, key.hmac)) return -1;
+        if (EVP_DecryptInit_ex(cipher, EVP_aes_256_cbc(), nullptr, key.aes, iv) != 1) return -1;
+        return is_current ? 1 : 2;
+    }
+
+    void infoCallback(const SSL* ssl, int where, int ret) {
+        (void)ret; // unused parameter warning 방지
+        if (!(where & SSL_CB_HANDSHAKE_DONE)) return;
+        SSL* mutable_ssl = const_cast<SSL*>(ssl);
+        if (SSL_get_ex_data(mutable_ssl, countedIndex())) return;
+        SSL_set_ex_data(mutable_ssl, countedIndex(), mutable_ssl);
+
+        bool ktls = false;
+#ifdef SSL_OP_ENABLE_KTLS
+        ktls = BIO_get_ktls_send(SSL_get_wbio(ssl)) > 0;
+#endif
+        Metrics::addTLSHandshake(SSL_session_reused(mutable_ssl) == 1, ktls);
+    }
+
+    std::string lastError(const std::string& what) {
+        unsigned long code = ERR_get_error();
+        ERR_clear_error();
+        if (code == 0) return what;
+        char text[256];
+        ERR_error_string_n(code, text, sizeof(text));
+        return what + " (" + text + ")";
+    }
+
+    bool readTicketKey(const std::string& path, std::vector<unsigned char>& master, std::string& error) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            error = "티켓 키 파일을 열 수 없습니다: " + path;
+            return false;
+        }
+        master.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        if (master.size() < TLS::MIN_TICKET_KEY_BYTES) {
+            error = "티켓 키 파일이 너무 짧습니다 (" + std::to_string(TLS::MIN_TICKET_KEY_BYTES) + "바이트 이상): " + path;
+            return false;
+        }
+        return true;
+    }
+}
+
+namespace TLS {
+
+    bool ktlsSupported() {
+#ifdef SSL_OP_ENABLE_KTLS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool configure(SSL_CTX* ctx, const Settings& settings, std::string& error) {
+        if (!ctx) {
+            error = "SSL 컨텍스트가 없습니다.";
+            return false;
+        }
+
+        SSL_CTX_set_min_proto_version(ctx, TLS1_2_VERSION);
+        SSL_CTX_set_options(ctx, SSL_OP_CIPHER_SERVER_PREFERENCE | SSL_OP_NO_RENEGOTIATION);
+        if (!settings.ciphers.empty() && SSL_CTX_set_cipher_list(ctx, settings.ciphers.c_str()) != 1) {
+            error = lastError("TLS 1.2 암호 목록이 잘못되었습니다: " + settings.ciphers);
+            return false;
+        }
+        if (!settings.ciphersuites.empty() && SSL_CTX_set_ciphersuites(ctx, settings.ciphersuites.c_str()) != 1) {
+            error = lastError("TLS 1.3 암호 목록이 잘못되었습니다: " + settings.ciphersuites);
+            return false;
+        }
+        if (!settings.groups.empty() && SSL_CTX_set1_groups_list(ctx, settings.groups.c_str()) != 1) {
+            error = lastError("키 교환 곡선 목록이 잘못되었습니다: " + settings.groups);
+            return false;
+        }
+
+        // 기본 인증서와 다른 키 종류면 별도 슬롯에 들어가 클라이언트가 지원하는 쪽으로 선택됨
+        if (!settings.ecdsa_cert_path.empty() || !settings.ecdsa_key_path.empty()) {
+            if (SSL_CTX_use_certificate_chain_file(ctx, settings.ecdsa_cert_path.c_str()) != 1 ||
+                SSL_CTX_use_PrivateKey_file(ctx, settings.ecdsa_key_path.c_str(), SSL_FILETYPE_PEM) != 1 ||
+                SSL_CTX_check_private_key(ctx) != 1) {
+                error = lastError("ECDSA 인증서/키를 읽을 수 없습니다: " + settings.ecdsa_cert_path + ", " +
+                                  settings.ecdsa_key_path);
+                return false;
+            }
+        }
+
+        // 세션 캐시 (세션 ID 재개, 그리고 티켓을 끈 TLS 1.3의 상태 저장 티켓)
+        SSL_CTX_set_session_id_context(ctx, SESSION_ID_CONTEXT, sizeof(SESSION_ID_CONTEXT) - 1);
+        SSL_CTX_set_timeout(ctx, static_cast<long>(settings.session_timeout_sec));
+        if (settings.session_cache_size > 0) {
+            SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER);
+            SSL_CTX_sess_set_cache_size(ctx, static_cast<long>(settings.session_cache_size));
+        } else {
+            SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+        }
+
+        if (settings.tickets) {
+            std::vector<unsigned char> master;
+            if (!settings.ticket_key_file.empty()) {
+                if (!readTicketKey(settings.ticket_key_file, master, error)) return false;
+            } else {
+                master.resize(MIN_TICKET_KEY_BYTES);
+                if (RAND_bytes(master.data(), static_cast<int>(master.size())) != 1) {
+                    error = lastError("티켓 키를 만들 수 없습니다.");
+                    return false;
+                }
+            }
+            delete static_cast<TicketKeys*>(SSL_CTX_get_ex_data(ctx, ticketKeysIndex()));
+            SSL_CTX_set_ex_data(ctx, ticketKeysIndex(),
+                                new TicketKeys(std::move(master), settings.ticket_rotation_sec,
+                                               settings.session_timeout_sec));
+            SSL_CTX_clear_options(ctx, SSL_OP_NO_TICKET);
+            SSL_CTX_set_tlsext_ticket_key_evp_cb(ctx, ticketKeyCallback);
+        } else {
+            SSL_CTX_set_options(ctx, SSL_OP_NO_TICKET);
+        }
+
+        if (settings.ktls) {
+#ifdef SSL_OP_ENABLE_KTLS
+            SSL_CTX_set_options(ctx, SSL_OP_ENABLE_KTLS);
+#else
+            error = "이 OpenSSL은 kTLS를 지원하지 않습니다.";
+            return false;
+#endif
+        }
+
+        SSL_CTX_set_info_callback(ctx, infoCallback);
+        return true;
+    }
+}
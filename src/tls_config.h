@@ -0,0 +1,61 @@
+#ifndef TLS_CONFIG_H
+#define TLS_CONFIG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+typedef struct ssl_ctx_st SSL_CTX;
+
+/**
+ * @brief TLS 핸드셰이크 설정 (세션 재개, 암호 목록, 추가 인증서, kTLS)
+ *
+ * 클라이언트가 자주 다시 연결하면 전체 핸드셰이크(인증서 서명 + 키 교환)가 CPU를 대부분 씁니다.
+ * 세션 재개는 서명을 건너뛰므로 훨씬 가볍습니다.
+ * - 세션 티켓: 서버가 세션 상태를 암호화해 클라이언트에 맡김 (서버 메모리 없음, 인스턴스끼리 키를 공유하면
+ *   어느 인스턴스에서도 재개). 티켓 키는 마스터 키와 회전 주기 번호에서 HMAC으로 유도하므로 같은 키 파일을
+ *   가진 인스턴스들은 따로 맞추지 않아도 같은 키를 씀. 이전 주기의 키로 만든 티켓도 세션 수명 동안 받아 주고
+ *   새 키로 다시 발급
+ * - 세션 캐시: 티켓을 쓰지 않는 클라이언트(또는 --tls-tickets off)를 위한 서버 메모리 캐시 (세션 ID)
+ */
+namespace TLS {
+
+    // AES-NI가 있는 x86에서 가장 빠른 AES-GCM을 앞에 두고, 없는 클라이언트용으로 ChaCha20을 남김
+    constexpr const char* DEFAULT_CIPHERS =
+        "ECDHE-ECDSA-AES128-GCM-SHA256:ECDHE-RSA-AES128-GCM-SHA256:ECDHE-ECDSA-AES256-GCM-SHA384:"
+        "ECDHE-RSA-AES256-GCM-SHA384:ECDHE-ECDSA-CHACHA20-POLY1305:ECDHE-RSA-CHACHA20-POLY1305";
+    constexpr const char* DEFAULT_CIPHERSUITES =
+        "TLS_AES_128_GCM_SHA256:TLS_AES_256_GCM_SHA384:TLS_CHACHA20_POLY1305_SHA256";
+    constexpr const char* DEFAULT_GROUPS = "X25519:P-256:P-384";
+    constexpr size_t MIN_TICKET_KEY_BYTES = 32;
+
+    struct Settings {
+        bool tickets = true;                        // 세션 티켓 발급
+        std::string ticket_key_file;                // 티켓 마스터 키 (32바이트 이상, 비우면 시작 시 무작위)
+        uint32_t ticket_rotation_sec = 3600;        // 티켓 키 회전 주기 (0이면 회전 안 함)
+        size_t session_cache_size = 20480;          // 서버 세션 캐시 항목 수 (0이면 끔)
+        uint32_t session_timeout_sec = 7200;        // 세션(티켓 포함) 수명
+        std::string ciphers = DEFAULT_CIPHERS;      // TLS 1.2 암호 목록
+        std::string ciphersuites = DEFAULT_CIPHERSUITES;    // TLS 1.3 암호 목록
+        std::string groups = DEFAULT_GROUPS;        // 키 교환 곡선
+        std::string ecdsa_cert_path;                // 기본 인증서와 함께 둘 ECDSA 인증서 (지원하는 클라이언트에 우선)
+        std::string ecdsa_key_path;
+        bool ktls = false;                          // 커널 TLS로 레코드 암호화 넘기기 (커널/OpenSSL이 지원할 때)
+    };
+
+    /**
+     * @brief 인증서가 이미 들어간 서버 SSL_CTX에 설정 적용
+     *
+     * 핸드셰이크가 끝날 때마다 전체/재개 여부와 kTLS 사용 여부를 지표에 기록하는 콜백도 등록합니다.
+     * @param error 실패 원인
+     * @return 값이 잘못되었거나 파일을 읽을 수 없으면 false (ctx는 일부만 바뀌었을 수 있음)
+     */
+    bool configure(SSL_CTX* ctx, const Settings& settings, std::string& error);
+
+    /**
+     * @brief 이 OpenSSL 빌드가 kTLS를 켤 수 있는지 (실제 사용은 커널 tls 모듈과 암호에 따라 연결마다 결정)
+     */
+    bool ktlsSupported();
+}
+
+#endif // TLS_CONFIG_H
@@ -0,0 +1,239 @@
+#include "totp_kernel.h"
+#include "logger.h"
+#include "sha1_lanes.h"
+#include <atomic>
+#include <cstring>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+typedef uint32_t v4u32 __attribute__((vector_size(16)));
+
+namespace TOTPKernel {
+    namespace detail {
+#ifdef MFA_HAVE_AVX2_KERNEL
+        void avx2BatchCodes(const HMACKeyState* const* keys, const uint64_t* counters, size_t count, int* codes);
+#endif
+#ifdef MFA_HAVE_SHANI_KERNEL
+        void shaniBatchCodes(const HMACKeyState* const* keys, const uint64_t* counters, size_t count, int* codes);
+#endif
+    }
+}
+
+namespace {
+
+    using BatchFn = void (*)(const HMACKeyState* const*, const uint64_t*, size_t, int*);
+
+    struct Implementation {
+        const char* name;
+        BatchFn batch;
+        bool (*supported)();
+    };
+
+    void scalarBatchCodes(const HMACKeyState* const* keys, const uint64_t* counters, size_t count, int* codes) {
+        for (size_t i = 0; i < count; i++) {
+            codes[i] = HMACSHA1::totpCode(*keys[i], counters[i]);
+        }
+    }
+
+    // SSE2(x86-64 기본) / NEON 등 기본 ISA의 4레인 벡터
+    void vec4BatchCodes(const HMACKeyState* const* keys, const uint64_t* counters, size_t count, int* codes) {
+        SHA1Lanes<v4u32, 4>::batch(keys, counters, count, codes);
+    }
+
+    bool alwaysSupported() { return true; }
+
+#if defined(__x86_64__) || defined(__i386__)
+    bool cpuHasAVX2() {
+        unsigned int eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+        // OS가 YMM 상태를 저장하는지 확인 (OSXSAVE + XCR0)
+        if (!(ecx & bit_OSXSAVE) || !(ecx & bit_AVX)) return false;
+        unsigned int xcr0_lo, xcr0_hi;
+        __asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+        if ((xcr0_lo & 0x6) != 0x6) return false;
+        if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) return false;
+        return (ebx & bit_AVX2) != 0;
+    }
+
+    bool cpuHasSHANI() {
+        unsigned int eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+        if (!(ecx & bit_SSE4_1) || !(ecx & bit_SSSE3)) return false;
+        if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) return false;
+        return (ebx & bit_SHA) != 0;
+    }
+#endif
+
+    // 우선순위 순서 (앞쪽이 우선)
+    const Implementation IMPLEMENTATIONS[] = {
+#if defined(MFA_HAVE_SHANI_KERNEL) && (defined(__x86_64__) || defined(__i386__))
+        {"shani", TOTPKernel::detail::shaniBatchCodes, cpuHasSHANI},
+#endif
+#if defined(MFA_HAVE_AVX2_KERNEL) && (defined(__x86_64__) || defined(__i386__))
+        {"avx2", TOTPKernel::detail::avx2BatchCodes, cpuHasAVX2},
+#endif
+        {"vec4", vec4BatchCodes, alwaysSupported},
+        {"scalar", scalarBatchCodes, alwaysSupported},
+    };
+
+    const Implementation& scalarImplementation() {
+        return IMPLEMENTATIONS[sizeof(IMPLEMENTATIONS) / sizeof(IMPLEMENTATIONS[0]) - 1];
+    }
+
+    /**
+     * @brief RFC 6238 부록 B 테스트 벡터(SHA-1)와 레인별로 다른 키의 스칼라 결과로 구현 검증
+     */
+    bool selfTest(const Implementation& impl) {
+        static const unsigned char RFC_KEY[] = "12345678901234567890";
+        static const struct {
+            uint64_t time;
+            int code;
+        } VECTORS[] = {
+            {59ull, 287082},          {1111111109ull, 81804},   {1111111111ull, 50471},
+            {1234567890ull, 5924},    {2000000000ull, 279037},  {20000000000ull, 353130},
+        };
+        constexpr size_t VECTOR_COUNT = sizeof(VECTORS) / sizeof(VECTORS[0]);
+
+        HMACKeyState key;
+        if (!HMACSHA1::precompute(RFC_KEY, 20, key)) return false;
+
+        // 레인 경계(4/8)를 넘기도록 벡터를 반복해 배치 구성
+        constexpr size_t BATCH = VECTOR_COUNT * 3;
+        const HMACKeyState* keys[BATCH];
+        uint64_t counters[BATCH];
+        int codes[BATCH];
+        for (size_t i = 0; i < BATCH; i++) {
+            keys[i] = &key;
+            counters[i] = VECTORS[i % VECTOR_COUNT].time / 30;
+        }
+
+        impl.batch(keys, counters, BATCH, codes);
+
+        for (size_t i = 0; i < BATCH; i++) {
+            int expected = VECTORS[i % VECTOR_COUNT].code;
+            if (codes[i] != expected || HMACSHA1::totpCode(key, counters[i]) != expected) {
+                return false;
+            }
+        }
+
+        // 레인마다 길이와 내용이 다른 키 (모든 레인이 같은 키면 레인/키가 섞여도 드러나지 않음)
+        HMACKeyState lane_keys[BATCH];
+        for (size_t i = 0; i < BATCH; i++) {
+            unsigned char lane_key[20 + 3 * BATCH];
+            size_t length = 20 + 3 * i;     // 블록(64바이트)보다 긴 키 포함
+            for (size_t j = 0; j < length; j++) {
+                lane_key[j] = static_cast<unsigned char>(RFC_KEY[j % 20] ^ (i * 37 + j));
+            }
+            if (!HMACSHA1::precompute(lane_key, length, lane_keys[i])) return false;
+            keys[i] = &lane_keys[i];
+            counters[i] += i;
+        }
+
+        impl.batch(keys, counters, BATCH, codes);
+
+        for (size_t i = 0; i < BATCH; i++) {
+            if (codes[i] != HMACSHA1::totpCode(lane_keys[i], counters[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 후보가 적으면 단일 스트림 SHA-NI, 5개 이상이면 AVX2 8레인이 유리 (mfa-bench totp_kernel 기준)
+    constexpr size_t WIDE_BATCH_THRESHOLD = 5;
+    const char* const NARROW_PREFERENCE[] = {"shani", "avx2", "vec4", "scalar"};
+    const char* const WIDE_PREFERENCE[] = {"avx2", "shani", "vec4", "scalar"};
+
+    const Implementation* findImplementation(const char* name) {
+        for (const auto& impl : IMPLEMENTATIONS) {
+            if (strcmp(impl.name, name) == 0) return &impl;
+        }
+        return nullptr;
+    }
+
+    template <size_t N>
+    const Implementation* detectImplementation(const char* const (&preference)[N]) {
+        for (const char* name : preference) {
+            const Implementation* impl = findImplementation(name);
+            if (!impl || !impl->supported()) continue;
+            if (selfTest(*impl)) return impl;
+            MFA_LOG_WARN("TOTP_KERNEL", "Self-test failed for " << impl->name << ", trying next");
+        }
+        return &scalarImplementation();
+    }
+
+    std::atomic<const Implementation*> narrow_impl{nullptr};
+    std::atomic<const Implementation*> wide_impl{nullptr};
+
+    const Implementation& activeImplementation(size_t count) {
+        std::atomic<const Implementation*>& slot = count >= WIDE_BATCH_THRESHOLD ? wide_impl : narrow_impl;
+        const Implementation* impl = slot.load(std::memory_order_acquire);
+        if (!impl) {
+            impl = count >= WIDE_BATCH_THRESHOLD ? detectImplementation(WIDE_PREFERENCE)
+                                                 : detectImplementation(NARROW_PREFERENCE);
+            slot.store(impl, std::memory_order_release);
+        }
+        return *impl;
+    }
+}
+
+namespace TOTPKernel {
+
+    void windowCodes(const HMACKeyState& key, uint64_t first_counter, int count, int* codes) {
+        const HMACKeyState* keys[MAX_WINDOW_CANDIDATES];
+        uint64_t counters[MAX_WINDOW_CANDIDATES];
+
+        for (int done = 0; done < count; done += MAX_WINDOW_CANDIDATES) {
+            int n = count - done < MAX_WINDOW_CANDIDATES ? count - done : MAX_WINDOW_CANDIDATES;
+            for (int i = 0; i < n; i++) {
+                keys[i] = &key;
+                counters[i] = first_counter + static_cast<uint64_t>(done + i);
+            }
+            activeImplementation(static_cast<size_t>(n)).batch(keys, counters, static_cast<size_t>(n), codes + done);
+        }
+    }
+
+    void batchCodes(const HMACKeyState* const* keys, const uint64_t* counters, size_t count, int* codes) {
+        activeImplementation(count).batch(keys, counters, count, codes);
+    }
+
+    bool matchAny(const int* codes, int count, int input_code) {
+        uint32_t matched = 0;
+        for (int i = 0; i < count; i++) {
+            uint32_t diff = static_cast<uint32_t>(codes[i]) ^ static_cast<uint32_t>(input_code);
+            // diff == 0 이면 1, 아니면 0 (분기 없음)
+            matched |= ((diff | (0u - diff)) >> 31) ^ 1u;
+        }
+        return matched != 0;
+    }
+
+    int matchIndex(const int* codes, int count, int input_code) {
+        uint32_t index = ~0u;
+        for (int i = 0; i < count; i++) {
+            uint32_t diff = static_cast<uint32_t>(codes[i]) ^ static_cast<uint32_t>(input_code);
+            // 일치하면 전부 1인 마스크로 인덱스를 골라 넣음 (분기 없음)
+            uint32_t mask = 0u - (((diff | (0u - diff)) >> 31) ^ 1u);
+            index = (static_cast<uint32_t>(i) & mask) | (index & ~mask);
+        }
+        return static_cast<int>(index);
+    }
+
+    const char* implementationName() {
+        return activeImplementation(1).name;
+    }
+
+    bool selectImplementation(const char* name) {
+        if (strcmp(name, "auto") == 0) {
+            narrow_impl.store(nullptr, std::memory_order_release);
+            wide_impl.store(nullptr, std::memory_order_release);
+            return true;
+        }
+
+        const Implementation* impl = findImplementation(name);
+        if (!impl || !impl->supported() || !selfTest(*impl)) return false;
+        narrow_impl.store(impl, std::memory_order_release);
+        wide_impl.store(impl, std::memory_order_release);
+        return true;
+    }
+}
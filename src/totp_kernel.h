@@ -0,0 +1,63 @@
+#ifndef TOTP_KERNEL_H
+#define TOTP_KERNEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include "hmac_sha1.h"
+
+/**
+ * @brief 여러 TOTP 후보를 한 번에 계산하는 HMAC-SHA1 커널
+ *
+ * 윈도우 후보(-w..+w)나 여러 사용자의 코드는 서로 독립적이므로
+ * SIMD 레인(SSE2 4레인, AVX2 8레인) 또는 SHA-NI로 묶어서 계산합니다.
+ * 구현은 실행 시 CPU 기능을 확인해 선택하며, 선택된 구현이 RFC 6238
+ * 테스트 벡터 자체 검증에 실패하면 스칼라 구현으로 되돌아갑니다.
+ */
+namespace TOTPKernel {
+
+    constexpr int MAX_WINDOW_CANDIDATES = 32;
+
+    /**
+     * @brief 사용자 한 명의 연속된 카운터 후보 코드 계산
+     * @param key 미리 계산된 키 상태
+     * @param first_counter 첫 번째 카운터 (time / OTP_PERIOD - window)
+     * @param count 후보 개수
+     * @param codes 결과 코드 (count개)
+     */
+    void windowCodes(const HMACKeyState& key, uint64_t first_counter, int count, int* codes);
+
+    /**
+     * @brief 여러 (키, 카운터) 쌍의 코드를 병렬 계산
+     * @param keys 키 상태 포인터 배열
+     * @param counters 카운터 배열
+     * @param count 쌍 개수
+     * @param codes 결과 코드 (count개)
+     */
+    void batchCodes(const HMACKeyState* const* keys, const uint64_t* counters, size_t count, int* codes);
+
+    /**
+     * @brief 후보 중 입력 코드와 일치하는 것이 있는지 상수 시간으로 확인
+     * @return 일치하는 후보가 있으면 true (조기 종료 없음)
+     */
+    bool matchAny(const int* codes, int count, int input_code);
+
+    /**
+     * @brief 입력 코드와 일치하는 마지막 후보의 위치를 상수 시간으로 찾음 (재사용 방지용 time step 계산)
+     * @return 일치한 후보 중 가장 큰 인덱스, 없으면 -1 (조기 종료 없음)
+     */
+    int matchIndex(const int* codes, int count, int input_code);
+
+    /**
+     * @brief 윈도우 검증에 쓰이는 구현 이름 ("scalar", "vec4", "avx2", "shani")
+     */
+    const char* implementationName();
+
+    /**
+     * @brief 구현 강제 선택 (벤치마크/진단용)
+     * @param name 구현 이름 ("auto"는 자동 선택으로 복귀)
+     * @return 해당 구현이 이 CPU에서 사용 가능하고 자체 검증을 통과하면 true
+     */
+    bool selectImplementation(const char* name);
+}
+
+#endif // TOTP_KERNEL_H
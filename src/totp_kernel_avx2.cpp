@@ -0,0 +1,12 @@
+// AVX2 8레인 커널 (이 파일만 -mavx2로 컴파일, 실행 시 CPU 확인 후 호출)
+#include "sha1_lanes.h"
+
+typedef uint32_t v8u32 __attribute__((vector_size(32)));
+
+namespace TOTPKernel {
+    namespace detail {
+        void avx2BatchCodes(const HMACKeyState* const* keys, const uint64_t* counters, size_t count, int* codes) {
+            SHA1Lanes<v8u32, 8>::batch(keys, counters, count, codes);
+        }
+    }
+}
@@ -0,0 +1,114 @@
+// SHA-NI 커널 (이 파일만 -msha -msse4.1로 컴파일, 실행 시 CPU 확인 후 호출)
+#include "hmac_sha1.h"
+#include <cstring>
+#include <immintrin.h>
+
+namespace {
+
+    // 4라운드 묶음 g (g >= 3): 메시지 스케줄 갱신과 라운드를 교차 수행
+#define SHANI_GROUP(g, E_CUR, E_NEXT, M_CUR, M_NEXT, M_PREV2, M_PREV3, FUNC) \
+    E_CUR = _mm_sha1nexte_epu32(E_CUR, M_CUR);                              \
+    E_NEXT = abcd;                                                          \
+    M_NEXT = _mm_sha1msg2_epu32(M_NEXT, M_CUR);                             \
+    abcd = _mm_sha1rnds4_epu32(abcd, E_CUR, FUNC);                          \
+    M_PREV3 = _mm_sha1msg1_epu32(M_PREV3, M_CUR);                           \
+    M_PREV2 = _mm_xor_si128(M_PREV2, M_CUR);
+
+    void compressSHANI(uint32_t state[5], const unsigned char block[SHA1_BLOCK_LENGTH]) {
+        const __m128i mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+        __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0x1B);
+        __m128i e0 = _mm_set_epi32(static_cast<int>(state[4]), 0, 0, 0);
+        __m128i e1;
+        const __m128i abcd_save = abcd;
+        const __m128i e0_save = e0;
+
+        __m128i m0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block)), mask);
+        __m128i m1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16)), mask);
+        __m128i m2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 32)), mask);
+        __m128i m3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 48)), mask);
+
+        // 라운드 0-11: 메시지 스케줄 시작 구간
+        e0 = _mm_add_epi32(e0, m0);
+        e1 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+        e1 = _mm_sha1nexte_epu32(e1, m1);
+        e0 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+        m0 = _mm_sha1msg1_epu32(m0, m1);
+
+        e0 = _mm_sha1nexte_epu32(e0, m2);
+        e1 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+        m1 = _mm_sha1msg1_epu32(m1, m2);
+        m0 = _mm_xor_si128(m0, m2);
+
+        // 라운드 12-79
+        SHANI_GROUP(3, e1, e0, m3, m0, m1, m2, 0)
+        SHANI_GROUP(4, e0, e1, m0, m1, m2, m3, 0)
+        SHANI_GROUP(5, e1, e0, m1, m2, m3, m0, 1)
+        SHANI_GROUP(6, e0, e1, m2, m3, m0, m1, 1)
+        SHANI_GROUP(7, e1, e0, m3, m0, m1, m2, 1)
+        SHANI_GROUP(8, e0, e1, m0, m1, m2, m3, 1)
+        SHANI_GROUP(9, e1, e0, m1, m2, m3, m0, 1)
+        SHANI_GROUP(10, e0, e1, m2, m3, m0, m1, 2)
+        SHANI_GROUP(11, e1, e0, m3, m0, m1, m2, 2)
+        SHANI_GROUP(12, e0, e1, m0, m1, m2, m3, 2)
+        SHANI_GROUP(13, e1, e0, m1, m2, m3, m0, 2)
+        SHANI_GROUP(14, e0, e1, m2, m3, m0, m1, 2)
+        SHANI_GROUP(15, e1, e0, m3, m0, m1, m2, 3)
+        SHANI_GROUP(16, e0, e1, m0, m1, m2, m3, 3)
+        SHANI_GROUP(17, e1, e0, m1, m2, m3, m0, 3)
+        SHANI_GROUP(18, e0, e1, m2, m3, m0, m1, 3)
+        SHANI_GROUP(19, e1, e0, m3, m0, m1, m2, 3)
+
+        e0 = _mm_sha1nexte_epu32(e0, e0_save);
+        abcd = _mm_add_epi32(abcd, abcd_save);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1B));
+        state[4] = static_cast<uint32_t>(_mm_extract_epi32(e0, 3));
+    }
+
+#undef SHANI_GROUP
+
+    inline void storeBE32(unsigned char* p, uint32_t v) {
+        p[0] = static_cast<unsigned char>(v >> 24);
+        p[1] = static_cast<unsigned char>(v >> 16);
+        p[2] = static_cast<unsigned char>(v >> 8);
+        p[3] = static_cast<unsigned char>(v);
+    }
+
+    int totpCodeSHANI(const HMACKeyState& key, uint64_t counter) {
+        unsigned char block[SHA1_BLOCK_LENGTH] = {0};
+        uint32_t h[5];
+
+        storeBE32(block, static_cast<uint32_t>(counter >> 32));
+        storeBE32(block + 4, static_cast<uint32_t>(counter));
+        block[8] = 0x80;
+        storeBE32(block + 60, (SHA1_BLOCK_LENGTH + 8) * 8);
+        memcpy(h, key.inner, sizeof(h));
+        compressSHANI(h, block);
+
+        memset(block, 0, sizeof(block));
+        for (int i = 0; i < 5; i++) storeBE32(block + i * 4, h[i]);
+        block[SHA1_DIGEST_LENGTH] = 0x80;
+        storeBE32(block + 60, (SHA1_BLOCK_LENGTH + SHA1_DIGEST_LENGTH) * 8);
+        memcpy(h, key.outer, sizeof(h));
+        compressSHANI(h, block);
+
+        unsigned char digest[SHA1_DIGEST_LENGTH];
+        for (int i = 0; i < 5; i++) storeBE32(digest + i * 4, h[i]);
+        return HMACSHA1::truncate(digest);
+    }
+}
+
+namespace TOTPKernel {
+    namespace detail {
+        void shaniBatchCodes(const HMACKeyState* const* keys, const uint64_t* counters, size_t count, int* codes) {
+            for (size_t i = 0; i < count; i++) {
+                codes[i] = totpCodeSHANI(*keys[i], counters[i]);
+            }
+        }
+    }
+}
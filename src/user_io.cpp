@@ -0,0 +1,247 @@
+#include "user_io.h"
+#include "json_reader.h"
+#include "json_writer.h"
+#include <charconv>
+
+namespace {
+
+    constexpr std::string_view IMPORT_FIELDS[] = {"user_id", "secret"};
+    constexpr size_t LINE_SCRATCH_SIZE = 1024;      // 이스케이프된 필드 디코딩용
+
+    bool needsQuoting(std::string_view field) {
+        return field.find_first_of(",\"\r\n") != std::string_view::npos;
+    }
+
+    void appendCSVField(std::string& out, std::string_view field) {
+        if (!needsQuoting(field)) {
+            out += field;
+            return;
+        }
+        out += '"';
+        for (char c : field) {
+            if (c == '"') out += '"';
+            out += c;
+        }
+        out += '"';
+    }
+
+    void appendNumber(std::string& out, size_t value) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        out.append(digits, static_cast<size_t>(result.ptr - digits));
+    }
+
+    void appendJSONString(std::string& out, std::string_view value) {
+        out += '"';
+        Json::appendEscaped(out, value);
+        out += '"';
+    }
+
+    std::string_view trim(std::string_view text) {
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+        while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) text.remove_suffix(1);
+        return text;
+    }
+}
+
+namespace UserIO {
+
+    bool parseFormat(std::string_view text, Format& format) {
+        if (text == "csv") {
+            format = Format::CSV;
+            return true;
+        }
+        if (text == "ndjson" || text == "jsonl") {
+            format = Format::NDJSON;
+            return true;
+        }
+        return false;
+    }
+
+    bool formatFromContentType(std::string_view content_type, Format& format) {
+        std::string_view type = trim(content_type.substr(0, content_type.find(';')));
+        if (type == "text/csv") {
+            format = Format::CSV;
+            return true;
+        }
+        if (type == "application/x-ndjson" || type == "application/ndjson" || type == "application/jsonl" ||
+            type == "application/x-jsonlines") {
+            format = Format::NDJSON;
+            return true;
+        }
+        return false;
+    }
+
+    const char* contentType(Format format) {
+        return format == Format::CSV ? "text/csv" : "application/x-ndjson";
+    }
+
+    const char* statusName(ImportStatus status) {
+        switch (status) {
+            case ImportStatus::Created: return "created";
+            case ImportStatus::Exists: return "exists";
+            case ImportStatus::Invalid: return "invalid";
+            case ImportStatus::Failed: return "failed";
+        }
+        return "failed";
+    }
+
+    // ==================== Reader ====================
+
+    void Reader::feed(std::string_view data, std::vector<ImportItem>& items, std::vector<size_t>& lines) {
+        // 이전 조각에서 남은 줄이 있으면 이어 붙인 뒤 그 줄만 먼저 처리
+        if (!pending.empty()) {
+            size_t newline = data.find('\n');
+            if (newline == std::string_view::npos) {
+                pending.append(data.data(), data.size());
+                return;
+            }
+            pending.append(data.data(), newline);
+            parseLine(pending, items, lines);
+            pending.clear();
+            data.remove_prefix(newline + 1);
+        }
+
+        // 나머지 완성된 줄은 복사 없이 입력 조각에서 바로 해석
+        size_t start = 0;
+        for (size_t newline; (newline = data.find('\n', start)) != std::string_view::npos; start = newline + 1) {
+            parseLine(data.substr(start, newline - start), items, lines);
+        }
+        pending.assign(data.data() + start, data.size() - start);
+    }
+
+    void Reader::finish(std::vector<ImportItem>& items, std::vector<size_t>& lines) {
+        if (!pending.empty()) {
+            parseLine(pending, items, lines);
+            pending.clear();
+        }
+    }
+
+    void Reader::parseLine(std::string_view line, std::vector<ImportItem>& items, std::vector<size_t>& lines) {
+        line_number++;
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (trim(line).empty()) {
+            return;
+        }
+
+        bool header = first_line && format == Format::CSV && line.substr(0, 7) == "user_id" &&
+                      (line.size() == 7 || line[7] == ',');
+        first_line = false;
+        if (header) {
+            return;
+        }
+
+        ImportItem item;
+        bool ok = format == Format::CSV ? parseCSV(line, item) : parseNDJSON(line, item);
+        if (!ok) {
+            item = ImportItem{};    // user_id가 비어 있으면 Invalid로 처리됨
+        }
+        items.push_back(std::move(item));
+        lines.push_back(line_number);
+    }
+
+    bool Reader::parseCSV(std::string_view line, ImportItem& item) {
+        std::string* fields[2] = {&item.user_id, &item.secret_base32};
+        size_t field = 0;
+        size_t pos = 0;
+        for (;;) {
+            if (field == 2) {
+                return false;   // 열이 너무 많음
+            }
+            std::string& out = *fields[field];
+            if (pos < line.size() && line[pos] == '"') {
+                // 큰따옴표 필드: ""는 따옴표 하나
+                pos++;
+                for (;;) {
+                    if (pos >= line.size()) return false;
+                    if (line[pos] == '"') {
+                        if (pos + 1 < line.size() && line[pos + 1] == '"') {
+                            out += '"';
+                            pos += 2;
+                            continue;
+                        }
+                        pos++;
+                        break;
+                    }
+                    out += line[pos++];
+                }
+                if (pos < line.size() && line[pos] != ',') return false;
+            } else {
+                size_t comma = line.find(',', pos);
+                size_t end = comma == std::string_view::npos ? line.size() : comma;
+                out.assign(trim(line.substr(pos, end - pos)));
+                pos = end;
+            }
+            field++;
+            if (pos >= line.size()) break;
+            pos++;      // 쉼표
+        }
+        return !item.user_id.empty();
+    }
+
+    bool Reader::parseNDJSON(std::string_view line, ImportItem& item) {
+        std::string_view values[2];
+        char scratch[LINE_SCRATCH_SIZE];
+        if (Json::parseStringFields(line, IMPORT_FIELDS, values, 2, scratch, sizeof(scratch)) != Json::Error::None) {
+            return false;
+        }
+        item.user_id.assign(values[0]);
+        item.secret_base32.assign(values[1]);
+        return !item.user_id.empty();
+    }
+
+    // ==================== 출력 ====================
+
+    void appendExportHeader(std::string& out, Format format) {
+        if (format == Format::CSV) {
+            out += "user_id,secret\n";
+        }
+    }
+
+    void appendExportRecord(std::string& out, Format format, std::string_view user_id, std::string_view secret) {
+        if (format == Format::CSV) {
+            appendCSVField(out, user_id);
+            out += ',';
+            appendCSVField(out, secret);
+            out += '\n';
+            return;
+        }
+        out += "{\"user_id\": ";
+        appendJSONString(out, user_id);
+        out += ", \"secret\": ";
+        appendJSONString(out, secret);
+        out += "}\n";
+    }
+
+    void appendResultHeader(std::string& out, Format format) {
+        if (format == Format::CSV) {
+            out += "line,user_id,secret,status\n";
+        }
+    }
+
+    void appendResultRecord(std::string& out, Format format, size_t line, const ImportItem& item, ImportStatus status) {
+        std::string_view secret = status == ImportStatus::Created ? std::string_view(item.secret_base32) : std::string_view();
+        if (format == Format::CSV) {
+            appendNumber(out, line);
+            out += ',';
+            appendCSVField(out, item.user_id);
+            out += ',';
+            appendCSVField(out, secret);
+            out += ',';
+            out += statusName(status);
+            out += '\n';
+            return;
+        }
+        out += "{\"line\": ";
+        appendNumber(out, line);
+        out += ", \"user_id\": ";
+        appendJSONString(out, item.user_id);
+        if (!secret.empty()) {
+            out += ", \"secret\": ";
+            appendJSONString(out, secret);
+        }
+        out += ", \"status\": \"";
+        out += statusName(status);
+        out += "\"}\n";
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef USER_IO_H
+#define USER_IO_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "mfa_core.h"
+
+/**
+ * @brief 대량 가져오기/내보내기용 CSV, NDJSON 형식 (mfa-admin, POST /api/users/bulk)
+ *
+ * 입력 한 줄이 사용자 한 명입니다.
+ * - CSV: user_id[,secret] (첫 줄이 "user_id"로 시작하는 헤더면 건너뜀, 큰따옴표 필드 지원)
+ * - NDJSON: {"user_id": "...", "secret": "..."} (secret은 선택)
+ * secret이 없으면 새로 생성하고, 있으면 그 시크릿으로 등록합니다 (다른 시스템에서 옮겨 오기).
+ */
+namespace UserIO {
+
+    enum class Format {
+        CSV,
+        NDJSON
+    };
+
+    /**
+     * @brief "csv" / "ndjson" 파싱
+     */
+    bool parseFormat(std::string_view text, Format& format);
+
+    /**
+     * @brief Content-Type에서 형식 추론 ("text/csv", "application/x-ndjson", "application/jsonl" 등, 매개변수 무시)
+     */
+    bool formatFromContentType(std::string_view content_type, Format& format);
+
+    /**
+     * @brief 응답 Content-Type ("text/csv", "application/x-ndjson")
+     */
+    const char* contentType(Format format);
+
+    /**
+     * @brief 결과 이름 ("created", "exists", "invalid", "failed")
+     */
+    const char* statusName(ImportStatus status);
+
+    /**
+     * @brief 입력을 임의의 조각 단위로 받아 줄마다 ImportItem으로 변환
+     *
+     * 조각 경계에 걸친 줄은 다음 조각까지 보관합니다. 해석할 수 없는 줄은
+     * user_id가 빈 항목으로 내보내므로 importUsers()가 Invalid로 처리합니다.
+     */
+    class Reader {
+    public:
+        explicit Reader(Format format) : format(format) {}
+
+        /**
+         * @brief 입력 조각 처리
+         * @param data 입력 조각
+         * @param items 완성된 줄의 항목을 뒤에 추가
+         * @param lines 항목별 입력 줄 번호 (1부터)를 뒤에 추가
+         */
+        void feed(std::string_view data, std::vector<ImportItem>& items, std::vector<size_t>& lines);
+
+        /**
+         * @brief 입력 끝 (줄바꿈 없이 끝난 마지막 줄 처리)
+         */
+        void finish(std::vector<ImportItem>& items, std::vector<size_t>& lines);
+
+        size_t lineCount() const { return line_number; }
+
+    private:
+        Format format;
+        std::string pending;            // 아직 줄바꿈을 만나지 못한 입력
+        size_t line_number = 0;
+        bool first_line = true;
+
+        void parseLine(std::string_view line, std::vector<ImportItem>& items, std::vector<size_t>& lines);
+        bool parseCSV(std::string_view line, ImportItem& item);
+        bool parseNDJSON(std::string_view line, ImportItem& item);
+    };
+
+    /**
+     * @brief 내보내기 헤더 (CSV: "user_id,secret", NDJSON: 없음)
+     */
+    void appendExportHeader(std::string& out, Format format);
+
+    /**
+     * @brief 내보내기 한 줄 (user_id, 시크릿)
+     */
+    void appendExportRecord(std::string& out, Format format, std::string_view user_id, std::string_view secret);
+
+    /**
+     * @brief 가져오기 결과 헤더 (CSV: "line,user_id,secret,status", NDJSON: 없음)
+     */
+    void appendResultHeader(std::string& out, Format format);
+
+    /**
+     * @brief 가져오기 결과 한 줄 (시크릿은 새로 등록된 항목만 포함)
+     */
+    void appendResultRecord(std::string& out, Format format, size_t line, const ImportItem& item, ImportStatus status);
+}
+
+#endif // USER_IO_H
@@ -0,0 +1,247 @@
+#include "user_table.h"
+#include <algorithm>
+#include <functional>
+
+namespace {
+    constexpr size_t MIN_CAPACITY = 1024;
+
+    // 재구성 후 부하율이 50%를 넘지 않는 2의 거듭제곱 용량
+    size_t capacityFor(size_t count) {
+        size_t capacity = MIN_CAPACITY;
+        while (count * 2 > capacity) capacity *= 2;
+        return capacity;
+    }
+}
+
+UserTable::Node* UserTable::tombstone() {
+    static Node marker;
+    return &marker;
+}
+
+uint64_t UserTable::hashOf(std::string_view user_id) {
+    return std::hash<std::string_view>()(user_id);
+}
+
+size_t UserTable::bucketOf(const Slots* table, uint64_t hash) {
+    return static_cast<size_t>(hash >> table->shift);
+}
+
+UserTable::Slots* UserTable::allocate(size_t capacity) {
+    Slots* table = new Slots;
+    table->capacity = capacity;
+    table->shift = 64;
+    for (size_t c = capacity; c > 1; c >>= 1) table->shift--;
+    table->slots = new std::atomic<Node*>[capacity];
+    for (size_t i = 0; i < capacity; i++) {
+        table->slots[i].store(nullptr, std::memory_order_relaxed);
+    }
+    return table;
+}
+
+void UserTable::release(Slots* table) {
+    delete[] table->slots;
+    delete table;
+}
+
+UserTable::UserTable() : current(allocate(MIN_CAPACITY)) {}
+
+UserTable::~UserTable() {
+    // 소멸 시점에는 읽기 쪽이 없다고 가정하고 바로 해제
+    Slots* table = current.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < table->capacity; i++) {
+        Node* node = table->slots[i].load(std::memory_order_relaxed);
+        if (node && node != tombstone()) delete node;
+    }
+    release(table);
+}
+
+const UserTable::Node* UserTable::findNode(const Slots* table, std::string_view user_id, uint64_t hash) const {
+    size_t mask = table->capacity - 1;
+    for (size_t probe = 0, pos = bucketOf(table, hash); probe < table->capacity; probe++, pos = (pos + 1) & mask) {
+        const Node* node = table->slots[pos].load(std::memory_order_acquire);
+        if (!node) {
+            return nullptr;
+        }
+        if (node != tombstone() && node->hash == hash && node->record.user.user_id == user_id) {
+            return node;
+        }
+    }
+    return nullptr;
+}
+
+bool UserTable::find(std::string_view user_id, User* user, HMACKeyState* key, uint32_t* slot) const {
+    Epoch::Guard guard;
+    const Node* node = findNode(current.load(std::memory_order_acquire), user_id, hashOf(user_id));
+    if (!node) {
+        return false;
+    }
+    if (user) *user = node->record.user;
+    if (key) *key = node->record.key;
+    if (slot) *slot = node->record.slot;
+    return true;
+}
+
+void UserTable::rebuild(size_t capacity) {
+    Slots* old_table = current.load(std::memory_order_relaxed);
+    Slots* new_table = allocate(capacity);
+    size_t mask = capacity - 1;
+
+    // 노드는 불변이므로 포인터만 옮김 (삭제 표시는 버림)
+    for (size_t i = 0; i < old_table->capacity; i++) {
+        Node* node = old_table->slots[i].load(std::memory_order_relaxed);
+        if (!node || node == tombstone()) continue;
+        size_t pos = bucketOf(new_table, node->hash);
+        while (new_table->slots[pos].load(std::memory_order_relaxed)) pos = (pos + 1) & mask;
+        new_table->slots[pos].store(node, std::memory_order_relaxed);
+        new_table->used++;
+    }
+
+    current.store(new_table, std::memory_order_release);
+    Epoch::retire([old_table] { release(old_table); });
+}
+
+bool UserTable::insert(const User& user, const HMACKeyState& key, uint32_t* slot) {
+    uint64_t hash = hashOf(user.user_id);
+    Slots* table = current.load(std::memory_order_relaxed);
+    if (findNode(table, user.user_id, hash)) {
+        return false;
+    }
+
+    // 부하율 70% 초과 시 재구성 (삭제 표시가 대부분이면 같은 크기로)
+    if ((table->used + 1) * 10 > table->capacity * 7) {
+        rebuild(capacityFor(live_count.load(std::memory_order_relaxed) + 1));
+        table = current.load(std::memory_order_relaxed);
+    }
+
+    uint32_t record_slot = next_record_slot;
+    if (!free_record_slots.empty()) {
+        record_slot = free_record_slots.back();
+        free_record_slots.pop_back();
+    } else {
+        next_record_slot++;
+    }
+    if (slot) *slot = record_slot;
+
+    Node* node = new Node{hash, UserRecord{user, key, record_slot}};
+    size_t mask = table->capacity - 1;
+    size_t pos = bucketOf(table, hash);
+    for (;;) {
+        Node* existing = table->slots[pos].load(std::memory_order_relaxed);
+        if (!existing || existing == tombstone()) {
+            if (!existing) table->used++;
+            break;
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    // 노드 내용이 먼저 보이도록 release로 공개
+    table->slots[pos].store(node, std::memory_order_release);
+    live_count.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool UserTable::remove(std::string_view user_id, User* removed) {
+    uint64_t hash = hashOf(user_id);
+    Slots* table = current.load(std::memory_order_relaxed);
+    size_t mask = table->capacity - 1;
+
+    for (size_t probe = 0, pos = bucketOf(table, hash); probe < table->capacity; probe++, pos = (pos + 1) & mask) {
+        Node* node = table->slots[pos].load(std::memory_order_relaxed);
+        if (!node) {
+            return false;
+        }
+        if (node == tombstone() || node->hash != hash || node->record.user.user_id != user_id) {
+            continue;
+        }
+
+        if (removed) *removed = node->record.user;
+        free_record_slots.push_back(node->record.slot);
+        table->slots[pos].store(tombstone(), std::memory_order_release);
+        live_count.fetch_sub(1, std::memory_order_relaxed);
+        Epoch::retire([node] { delete node; });
+        return true;
+    }
+    return false;
+}
+
+std::vector<const UserTable::Node*>& UserTable::pageBuffer() {
+    thread_local std::vector<const Node*> page;
+    return page;
+}
+
+bool UserTable::collectPage(const Slots* table, uint64_t cursor, size_t limit, size_t max_slots,
+                            std::string_view prefix, std::vector<const Node*>& page, uint64_t& next) const {
+    const size_t capacity = table->capacity;
+    const size_t mask = capacity - 1;
+    const size_t start = bucketOf(table, cursor);
+    page.clear();
+
+    // 버킷은 해시 상위 비트이므로 슬롯 순서가 곧 해시 순서 (클러스터 안에서만 뒤섞임).
+    // 빈 슬롯은 클러스터 경계라서, 경계에서 멈추면 그 앞의 레코드는 모두 모은 상태가 됨.
+    // v >= capacity 구간은 테이블 끝에서 0번 슬롯으로 넘어간 레코드만 다룸.
+    bool reached_end = true;
+    size_t v = start;
+    for (; v < 2 * capacity; v++) {
+        size_t pos = v & mask;
+        const Node* node = table->slots[pos].load(std::memory_order_acquire);
+        if (!node) {
+            if (v >= capacity) break;
+            if (page.size() >= limit || v - start >= max_slots) {
+                reached_end = false;
+                break;
+            }
+            continue;
+        }
+        if (node == tombstone()) continue;
+
+        bool wrapped = bucketOf(table, node->hash) > pos;
+        if (wrapped != (v >= capacity) || node->hash < cursor) continue;
+        const std::string& user_id = node->record.user.user_id;
+        if (user_id.compare(0, prefix.size(), prefix) != 0) continue;
+        page.push_back(node);
+    }
+
+    std::sort(page.begin(), page.end(), [](const Node* a, const Node* b) {
+        return a->hash != b->hash ? a->hash < b->hash : a->record.user.user_id < b->record.user.user_id;
+    });
+
+    // limit을 넘으면 잘라내되 같은 해시는 한 페이지에 모두 포함 (커서가 해시 단위이므로)
+    if (page.size() > limit) {
+        size_t keep = limit;
+        while (keep < page.size() && page[keep]->hash == page[keep - 1]->hash) keep++;
+        if (keep < page.size()) {
+            next = page[keep - 1]->hash + 1;
+            page.resize(keep);
+            return true;
+        }
+    }
+    if (reached_end) {
+        next = 0;
+        return false;
+    }
+    next = static_cast<uint64_t>(v) << table->shift;   // 빈 슬롯 v 앞의 버킷은 모두 방문함
+    return true;
+}
+
+void UserTable::reserve(size_t count) {
+    Slots* table = current.load(std::memory_order_relaxed);
+    size_t capacity = capacityFor(count);
+    if (capacity > table->capacity) {
+        rebuild(capacity);
+    }
+}
+
+void UserTable::clear() {
+    Slots* old_table = current.load(std::memory_order_relaxed);
+    current.store(allocate(MIN_CAPACITY), std::memory_order_release);
+    live_count.store(0, std::memory_order_relaxed);
+    free_record_slots.clear();
+    next_record_slot = 0;
+    Epoch::retire([old_table] {
+        for (size_t i = 0; i < old_table->capacity; i++) {
+            Node* node = old_table->slots[i].load(std::memory_order_relaxed);
+            if (node && node != tombstone()) delete node;
+        }
+        release(old_table);
+    });
+}
@@ -0,0 +1,170 @@
+#ifndef USER_TABLE_H
+#define USER_TABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "epoch.h"
+#include "hmac_sha1.h"
+
+/**
+ * @brief 사용자 정보 구조체
+ */
+struct User {
+    std::string user_id;
+    std::string secret_base32;
+
+    User() = default;
+    User(const std::string& id, const std::string& secret)
+        : user_id(id), secret_base32(secret) {}
+};
+
+/**
+ * @brief 사용자 레코드 (사용자 정보 + 미리 계산된 HMAC 키 상태)
+ */
+struct UserRecord {
+    User user;
+    HMACKeyState key;
+    uint32_t slot = 0;      // 사용자별 조밀한 번호 (삭제 후 재사용, 재사용 방지 테이블 인덱스)
+};
+
+/**
+ * @brief 잠금 없는 읽기를 지원하는 user_id 해시 테이블
+ *
+ * 슬롯 배열은 불변 레코드 노드의 포인터만 담는 오픈 어드레싱 테이블입니다.
+ * - 읽기: Epoch::Guard 안에서 슬롯을 따라가며 노드를 읽음 (잠금/대기 없음)
+ * - 쓰기: 노드를 새로 만들어 슬롯에 공개하거나, 슬롯을 삭제 표시로 바꾼 뒤 노드를 retire
+ * - 확장: 새 슬롯 배열에 같은 노드 포인터를 옮겨 담아 교체하고 이전 배열을 retire
+ *
+ * 쓰기 메서드는 호출자가 직렬화해야 합니다 (MFACore::mutation_mutex).
+ */
+class UserTable {
+private:
+    struct Node {
+        uint64_t hash;
+        UserRecord record;
+    };
+
+    struct Slots {
+        size_t capacity;                    // 2의 거듭제곱
+        unsigned shift;                     // 버킷 = hash >> shift (상위 비트, 슬롯 순서가 해시 순서를 따르도록)
+        size_t used = 0;                    // 사용 중 + 삭제 표시 슬롯 수 (쓰기 쪽 전용)
+        std::atomic<Node*>* slots;
+    };
+
+    std::atomic<Slots*> current;
+    std::atomic<size_t> live_count{0};
+
+    // 레코드 슬롯 번호 할당 (쓰기 쪽 전용)
+    std::vector<uint32_t> free_record_slots;
+    uint32_t next_record_slot = 0;
+
+    static Node* tombstone();
+    static uint64_t hashOf(std::string_view user_id);
+    static size_t bucketOf(const Slots* table, uint64_t hash);
+    static Slots* allocate(size_t capacity);
+    static void release(Slots* table);
+
+    const Node* findNode(const Slots* table, std::string_view user_id, uint64_t hash) const;
+    void rebuild(size_t capacity);
+
+    // scan 구현용: 페이지에 들어갈 노드를 해시 순서로 모음 (스레드별 버퍼 재사용)
+    static std::vector<const Node*>& pageBuffer();
+    bool collectPage(const Slots* table, uint64_t cursor, size_t limit, size_t max_slots,
+                     std::string_view prefix, std::vector<const Node*>& page, uint64_t& next) const;
+
+public:
+    UserTable();
+    ~UserTable();
+
+    UserTable(const UserTable&) = delete;
+    UserTable& operator=(const UserTable&) = delete;
+
+    /**
+     * @brief 사용자 조회 (잠금 없음, 결과를 복사)
+     * @param user 사용자 정보를 받을 구조체 (nullptr이면 생략)
+     * @param key 키 상태를 받을 구조체 (nullptr이면 생략)
+     * @param slot 레코드 슬롯 번호를 받을 변수 (nullptr이면 생략)
+     * @return 찾았으면 true
+     */
+    bool find(std::string_view user_id, User* user, HMACKeyState* key, uint32_t* slot = nullptr) const;
+
+    /**
+     * @brief 모든 레코드 순회 (잠금 없음, 순회 중 변경은 반영될 수도 안 될 수도 있음)
+     */
+    template <typename Fn>
+    void forEach(Fn&& fn) const;
+
+    /**
+     * @brief 해시 순서로 cursor 이후의 레코드를 최대 limit개 순회 (잠금 없음)
+     *
+     * 커서는 user_id 해시 값이라 테이블 확장/재구성 후에도 유효하며, 순회 내내 존재한
+     * 레코드는 페이지를 이어 가는 동안 정확히 한 번씩 방문합니다.
+     * @param cursor 시작 커서 (처음이면 0)
+     * @param limit 최대 레코드 수 (같은 해시의 레코드는 나누지 않으므로 드물게 넘을 수 있음)
+     * @param max_slots 한 번에 검사할 최대 슬롯 수 (접두사 필터로 결과가 적을 때 작업량 상한)
+     * @param prefix user_id 접두사 필터 (빈 문자열이면 전체)
+     * @param next 다음 커서를 받을 변수
+     * @return 남은 레코드가 있으면 true (페이지가 limit보다 적어도 true일 수 있음)
+     */
+    template <typename Fn>
+    bool scan(uint64_t cursor, size_t limit, size_t max_slots, std::string_view prefix,
+              Fn&& fn, uint64_t& next) const;
+
+    size_t size() const { return live_count.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 사용자 추가 (쓰기 직렬화 필요)
+     *
+     * 레코드 슬롯 번호는 삭제된 사용자의 번호를 먼저 재사용하므로 0..최대 사용자 수 범위에 머뭅니다.
+     * @param slot 부여된 레코드 슬롯 번호를 받을 변수 (nullptr이면 생략)
+     * @return 이미 있으면 false
+     */
+    bool insert(const User& user, const HMACKeyState& key, uint32_t* slot = nullptr);
+
+    /**
+     * @brief 사용자 삭제 (쓰기 직렬화 필요)
+     * @param removed 삭제된 사용자 정보를 받을 구조체 (nullptr이면 생략)
+     * @return 삭제했으면 true
+     */
+    bool remove(std::string_view user_id, User* removed = nullptr);
+
+    /**
+     * @brief 최소 용량 확보 (대량 적재 전, 쓰기 직렬화 필요)
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief 모든 사용자 삭제 (쓰기 직렬화 필요)
+     */
+    void clear();
+};
+
+template <typename Fn>
+void UserTable::forEach(Fn&& fn) const {
+    Epoch::Guard guard;
+    const Slots* table = current.load(std::memory_order_acquire);
+    for (size_t i = 0; i < table->capacity; i++) {
+        const Node* node = table->slots[i].load(std::memory_order_acquire);
+        if (node && node != tombstone()) {
+            fn(node->record);
+        }
+    }
+}
+
+template <typename Fn>
+bool UserTable::scan(uint64_t cursor, size_t limit, size_t max_slots, std::string_view prefix,
+                     Fn&& fn, uint64_t& next) const {
+    Epoch::Guard guard;
+    std::vector<const Node*>& page = pageBuffer();
+    bool more = collectPage(current.load(std::memory_order_acquire), cursor, limit, max_slots, prefix, page, next);
+    for (const Node* node : page) {
+        fn(node->record);
+    }
+    return more;
+}
+
+#endif // USER_TABLE_H
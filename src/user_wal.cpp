@@ -0,0 +1,304 @@
+#include "user_wal.h"
+#include "logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+    constexpr char WAL_MAGIC[8] = {'M', 'F', 'A', 'W', 'A', 'L', '0', '1'};
+    constexpr size_t WAL_HEADER_SIZE = 16;
+    constexpr size_t RECORD_HEADER_SIZE = 20;
+
+    // CRC-32 (IEEE 802.3) 테이블
+    struct CRC32Table {
+        uint32_t values[256];
+
+        constexpr CRC32Table() : values() {
+            for (uint32_t i = 0; i < 256; i++) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; k++) {
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                values[i] = c;
+            }
+        }
+    };
+
+    constexpr CRC32Table CRC32_TABLE;
+
+    uint32_t crc32(const unsigned char* data, size_t len) {
+        uint32_t c = 0xFFFFFFFFu;
+        for (size_t i = 0; i < len; i++) {
+            c = CRC32_TABLE.values[(c ^ data[i]) & 0xFF] ^ (c >> 8);
+        }
+        return c ^ 0xFFFFFFFFu;
+    }
+
+    bool writeAll(int fd, const char* data, size_t len) {
+        while (len > 0) {
+            ssize_t n = ::write(fd, data, len);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            data += n;
+            len -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+}
+
+void UserWAL::syncParentDirectory(const std::string& file_path) {
+    std::string dir = ".";
+    if (auto pos = file_path.find_last_of('/'); pos != std::string::npos) {
+        dir = file_path.substr(0, pos);
+    }
+    int dir_fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dir_fd >= 0) {
+        ::fsync(dir_fd);
+        ::close(dir_fd);
+    }
+}
+
+UserWAL::UserWAL(const std::string& wal_path) : path(wal_path) {}
+
+UserWAL::~UserWAL() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    commit_cv.notify_all();
+    if (commit_thread.joinable()) {
+        commit_thread.join();
+    }
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
+bool UserWAL::readFile(const std::string& file_path, std::vector<WALRecord>& records, uint64_t& start_lsn, uint64_t& next_lsn, uint64_t* valid_size) {
+    int in = ::open(file_path.c_str(), O_RDONLY);
+    if (in < 0) {
+        return false;
+    }
+
+    std::string data;
+    char buffer[1 << 16];
+    ssize_t n;
+    while ((n = ::read(in, buffer, sizeof(buffer))) > 0) {
+        data.append(buffer, static_cast<size_t>(n));
+    }
+    ::close(in);
+
+    if (data.size() < WAL_HEADER_SIZE || memcmp(data.data(), WAL_MAGIC, sizeof(WAL_MAGIC)) != 0) {
+        return false;
+    }
+
+    memcpy(&start_lsn, data.data() + 8, sizeof(start_lsn));
+    next_lsn = std::max(next_lsn, start_lsn);
+
+    size_t pos = WAL_HEADER_SIZE;
+    while (pos + RECORD_HEADER_SIZE <= data.size()) {
+        const unsigned char* rec = reinterpret_cast<const unsigned char*>(data.data() + pos);
+
+        uint32_t crc, length;
+        memcpy(&crc, rec, 4);
+        memcpy(&length, rec + 4, 4);
+        if (length > 510 || pos + RECORD_HEADER_SIZE + length > data.size()) {
+            break; // 잘린 꼬리
+        }
+        if (crc32(rec + 4, RECORD_HEADER_SIZE - 4 + length) != crc) {
+            break; // 손상된 레코드
+        }
+
+        WALRecord record;
+        memcpy(&record.lsn, rec + 8, 8);
+        record.op = static_cast<WALOp>(rec[16]);
+        uint8_t id_len = rec[17];
+        uint8_t secret_len = rec[18];
+        if (static_cast<uint32_t>(id_len) + secret_len != length) {
+            break;
+        }
+        record.user_id.assign(reinterpret_cast<const char*>(rec + RECORD_HEADER_SIZE), id_len);
+        record.secret_base32.assign(reinterpret_cast<const char*>(rec + RECORD_HEADER_SIZE + id_len), secret_len);
+
+        next_lsn = record.lsn + 1;
+        records.push_back(std::move(record));
+        pos += RECORD_HEADER_SIZE + length;
+    }
+
+    if (valid_size) {
+        *valid_size = pos;
+    }
+    return true;
+}
+
+bool UserWAL::createFile(uint64_t start_lsn) {
+    std::string tmp_path = path + ".tmp";
+    int out = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (out < 0) {
+        MFA_LOG_ERROR("WAL", "WAL 파일 생성 실패: " << tmp_path << " (" << strerror(errno) << ")");
+        return false;
+    }
+
+    char header[WAL_HEADER_SIZE];
+    memcpy(header, WAL_MAGIC, sizeof(WAL_MAGIC));
+    memcpy(header + 8, &start_lsn, sizeof(start_lsn));
+    if (!writeAll(out, header, sizeof(header)) || ::fdatasync(out) != 0) {
+        ::close(out);
+        return false;
+    }
+    ::close(out);
+
+    if (::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        return false;
+    }
+    syncParentDirectory(path);
+
+    fd = ::open(path.c_str(), O_WRONLY | O_APPEND);
+    base_lsn = start_lsn;
+    file_size = WAL_HEADER_SIZE;
+    return fd >= 0;
+}
+
+bool UserWAL::open(std::vector<WALRecord>& replay, bool& has_rotated) {
+    uint64_t next_lsn = 1;
+
+    uint64_t start_lsn = 1;
+
+    // 체크포인트 도중 중단된 경우 회전된 파일부터 재생
+    has_rotated = readFile(rotatedPath(), replay, start_lsn, next_lsn, nullptr);
+
+    uint64_t valid_size = 0;
+    if (readFile(path, replay, start_lsn, next_lsn, &valid_size)) {
+        // 손상된 꼬리 제거 후 이어서 기록
+        if (::truncate(path.c_str(), static_cast<off_t>(valid_size)) != 0) {
+            return false;
+        }
+        fd = ::open(path.c_str(), O_WRONLY | O_APPEND);
+        if (fd < 0) {
+            return false;
+        }
+        base_lsn = start_lsn;
+        file_size = valid_size;
+    } else if (!createFile(next_lsn)) {
+        return false;
+    }
+
+    appended_lsn = next_lsn - 1;
+    durable_lsn = appended_lsn;
+
+    commit_thread = std::thread(&UserWAL::commitLoop, this);
+    return true;
+}
+
+uint64_t UserWAL::append(WALOp op, const std::string& user_id, const std::string& secret_base32) {
+    if (user_id.size() > 255 || secret_base32.size() > 255) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (failed || fd < 0) {
+        return 0;
+    }
+
+    uint64_t lsn = ++appended_lsn;
+    uint32_t length = static_cast<uint32_t>(user_id.size() + secret_base32.size());
+
+    unsigned char header[RECORD_HEADER_SIZE] = {0};
+    memcpy(header + 4, &length, 4);
+    memcpy(header + 8, &lsn, 8);
+    header[16] = static_cast<unsigned char>(op);
+    header[17] = static_cast<unsigned char>(user_id.size());
+    header[18] = static_cast<unsigned char>(secret_base32.size());
+
+    size_t offset = pending.size();
+    pending.append(reinterpret_cast<const char*>(header), RECORD_HEADER_SIZE);
+    pending.append(user_id);
+    pending.append(secret_base32);
+
+    uint32_t crc = crc32(reinterpret_cast<const unsigned char*>(pending.data() + offset + 4),
+                         RECORD_HEADER_SIZE - 4 + length);
+    memcpy(&pending[offset], &crc, 4);
+
+    commit_cv.notify_one();
+    return lsn;
+}
+
+void UserWAL::commitLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        commit_cv.wait(lock, [this] { return stopping || !pending.empty(); });
+        if (pending.empty()) {
+            break; // stopping
+        }
+
+        // 그동안 쌓인 레코드를 한 번에 기록 (그룹 커밋)
+        std::string batch;
+        batch.swap(pending);
+        uint64_t batch_lsn = appended_lsn;
+        int batch_fd = fd;
+        lock.unlock();
+
+        bool ok = writeAll(batch_fd, batch.data(), batch.size()) && ::fdatasync(batch_fd) == 0;
+
+        lock.lock();
+        if (ok) {
+            durable_lsn = batch_lsn;
+            file_size += batch.size();
+        } else {
+            MFA_LOG_ERROR("WAL", "로그 기록 실패: " << strerror(errno));
+            failed = true;
+        }
+        durable_cv.notify_all();
+    }
+}
+
+bool UserWAL::waitDurable(uint64_t lsn) {
+    std::unique_lock<std::mutex> lock(mutex);
+    durable_cv.wait(lock, [this, lsn] { return durable_lsn >= lsn || failed; });
+    return durable_lsn >= lsn;
+}
+
+bool UserWAL::rotate() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    // 커밋 스레드가 버퍼를 모두 내려보낼 때까지 대기
+    durable_cv.wait(lock, [this] { return durable_lsn >= appended_lsn || failed; });
+    if (failed) {
+        return false;
+    }
+
+    ::close(fd);
+    fd = -1;
+    if (::rename(path.c_str(), rotatedPath().c_str()) != 0) {
+        fd = ::open(path.c_str(), O_WRONLY | O_APPEND);
+        return false;
+    }
+
+    if (!createFile(appended_lsn + 1)) {
+        failed = true;
+        return false;
+    }
+    return true;
+}
+
+void UserWAL::removeRotated() {
+    ::unlink(rotatedPath().c_str());
+    syncParentDirectory(path);
+}
+
+uint64_t UserWAL::sizeBytes() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return file_size + pending.size();
+}
+
+uint64_t UserWAL::lastLSN() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return appended_lsn;
+}
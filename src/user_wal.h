@@ -0,0 +1,111 @@
+#ifndef USER_WAL_H
+#define USER_WAL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief WAL 레코드 종류
+ */
+enum class WALOp : uint8_t {
+    Register = 1,
+    Delete = 2
+};
+
+/**
+ * @brief WAL 레코드 (재생/복제용)
+ */
+struct WALRecord {
+    WALOp op = WALOp::Register;
+    uint64_t lsn = 0;
+    std::string user_id;
+    std::string secret_base32;   // Delete 레코드는 빈 문자열
+};
+
+/**
+ * @brief 사용자 등록/삭제용 추가 전용 로그 (그룹 커밋)
+ *
+ * 파일 형식: 헤더(매직 8바이트 + 시작 LSN 8바이트) 뒤에 레코드가 이어집니다.
+ * 레코드: crc32(4) | payload 길이(4) | lsn(8) | op(1) | id 길이(1) | secret 길이(1) | 예약(1) | payload
+ * CRC는 crc 필드를 제외한 레코드 전체에 대해 계산하며, 검증에 실패한 지점 이후는
+ * 충돌 중 잘린 꼬리로 보고 잘라냅니다.
+ *
+ * append()는 메모리 버퍼에만 기록하고, 커밋 스레드가 그동안 쌓인 레코드를
+ * 한 번의 write + fdatasync로 내려보냅니다.
+ */
+class UserWAL {
+private:
+    std::string path;
+    int fd = -1;
+
+    std::mutex mutex;
+    std::condition_variable commit_cv;    // 커밋 스레드 깨우기
+    std::condition_variable durable_cv;   // 대기 중인 writer 깨우기
+    std::thread commit_thread;
+
+    std::string pending;                  // 아직 파일에 쓰지 않은 레코드
+    uint64_t base_lsn = 1;                // 현재 파일의 첫 LSN
+    uint64_t appended_lsn = 0;            // 마지막으로 append된 LSN
+    uint64_t durable_lsn = 0;             // fdatasync까지 끝난 LSN
+    uint64_t file_size = 0;
+    bool stopping = false;
+    bool failed = false;
+
+    void commitLoop();
+    bool createFile(uint64_t start_lsn);
+    bool readFile(const std::string& file_path, std::vector<WALRecord>& records,
+                  uint64_t& start_lsn, uint64_t& next_lsn, uint64_t* valid_size);
+
+public:
+    explicit UserWAL(const std::string& wal_path);
+    ~UserWAL();
+
+    UserWAL(const UserWAL&) = delete;
+    UserWAL& operator=(const UserWAL&) = delete;
+
+    /**
+     * @brief WAL 파일 열기 및 재생할 레코드 읽기 (커밋 스레드 시작)
+     * @param replay 체크포인트 이후의 레코드 (회전 중이던 .1 파일 포함, LSN 순)
+     * @param has_rotated 회전된 .1 파일이 남아 있었으면 true (체크포인트 미완료)
+     * @return 성공 시 true
+     */
+    bool open(std::vector<WALRecord>& replay, bool& has_rotated);
+
+    /**
+     * @brief 레코드를 커밋 버퍼에 추가 (호출자가 변경 순서를 직렬화해야 함)
+     * @return 할당된 LSN, 실패 시 0
+     */
+    uint64_t append(WALOp op, const std::string& user_id, const std::string& secret_base32 = "");
+
+    /**
+     * @brief LSN까지 디스크에 내려갈 때까지 대기
+     * @return 내구성 확보 시 true, 쓰기 실패 시 false
+     */
+    bool waitDurable(uint64_t lsn);
+
+    /**
+     * @brief 체크포인트 시작: 버퍼를 비우고 현재 파일을 .1로 돌린 뒤 새 파일 시작
+     * @return 성공 시 true
+     */
+    bool rotate();
+
+    /**
+     * @brief 체크포인트 완료: 회전된 .1 파일 삭제
+     */
+    void removeRotated();
+
+    /**
+     * @brief 파일 생성/rename 후 상위 디렉토리 엔트리를 디스크에 반영
+     */
+    static void syncParentDirectory(const std::string& file_path);
+
+    std::string rotatedPath() const { return path + ".1"; }
+    uint64_t sizeBytes();
+    uint64_t lastLSN();
+};
+
+#endif // USER_WAL_H
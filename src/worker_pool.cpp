@@ -0,0 +1,105 @@
+#include "worker_pool.h"
+#include "logger.h"
+#include <pthread.h>
+#include <sched.h>
+
+namespace {
+
+    // 이 프로세스가 쓸 수 있는 CPU 목록 (taskset/cgroup 제한 반영)
+    std::vector<int> allowedCPUs() {
+        std::vector<int> cpus;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+                if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+            }
+        }
+        return cpus;
+    }
+
+    bool pinCurrentThread(int cpu) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    }
+}
+
+WorkerPool::WorkerPool(size_t thread_count, size_t max_queued, bool pin_threads) : max_queued(max_queued) {
+    std::vector<int> cpus;
+    if (pin_threads) {
+        cpus = allowedCPUs();
+        if (cpus.empty()) {
+            MFA_LOG_WARN("POOL", "허용된 CPU 목록을 읽을 수 없어 작업 스레드를 고정하지 않습니다.");
+        }
+    }
+
+    if (thread_count == 0) thread_count = 1;
+    threads.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; i++) {
+        int cpu = cpus.empty() ? -1 : cpus[i % cpus.size()];
+        threads.emplace_back([this, cpu]() { run(cpu); });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    shutdown();
+}
+
+bool WorkerPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping || (max_queued > 0 && tasks.size() >= max_queued)) {
+            return false;
+        }
+        tasks.push_back(std::move(task));
+    }
+    available.notify_one();
+    return true;
+}
+
+void WorkerPool::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    available.notify_all();
+    for (auto& thread : threads) {
+        if (thread.joinable()) thread.join();
+    }
+}
+
+size_t WorkerPool::queued() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return tasks.size();
+}
+
+size_t WorkerPool::pinnedThreads() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return pinned;
+}
+
+void WorkerPool::run(int cpu) {
+    if (cpu >= 0) {
+        bool ok = pinCurrentThread(cpu);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (ok) {
+            pinned++;
+        } else {
+            MFA_LOG_WARN("POOL", "작업 스레드를 CPU " << cpu << "에 고정하지 못했습니다.");
+        }
+    }
+
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            available.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (tasks.empty()) return;      // stopping이고 남은 작업 없음
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief HTTP 연결을 처리하는 고정 크기 작업 스레드 풀
+ *
+ * httplib::ThreadPool과 같은 FIFO 풀에 두 가지를 더했습니다.
+ * - 대기열 상한: 기다리는 작업이 max_queued개면 submit()이 바로 false (호출자가 연결을 닫음)
+ * - CPU 고정: 스레드 i를 이 프로세스에 허용된 CPU 중 i번째(나머지 연산)에 고정
+ *
+ * shutdown()은 이미 받은 작업을 모두 처리한 뒤 스레드를 합류시킵니다.
+ */
+class WorkerPool {
+public:
+    /**
+     * @param threads 작업 스레드 수 (0이면 1)
+     * @param max_queued 대기 작업 상한 (0이면 제한 없음)
+     * @param pin_threads 스레드를 CPU에 하나씩 고정할지
+     */
+    WorkerPool(size_t threads, size_t max_queued = 0, bool pin_threads = false);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * @brief 작업 추가
+     * @return 대기열이 가득 찼거나 종료 중이면 false (작업은 실행되지 않음)
+     */
+    bool submit(std::function<void()> task);
+
+    /**
+     * @brief 남은 작업을 처리한 뒤 모든 스레드 종료 (여러 번 불러도 됨)
+     */
+    void shutdown();
+
+    size_t threadCount() const { return threads.size(); }
+
+    /**
+     * @brief 스레드를 기다리는 작업 수
+     */
+    size_t queued() const;
+
+    /**
+     * @brief CPU 고정에 성공한 스레드 수 (고정을 요청하지 않았으면 0)
+     */
+    size_t pinnedThreads() const;
+
+private:
+    std::vector<std::thread> threads;
+    std::deque<std::function<void()>> tasks;
+    mutable std::mutex mutex;
+    std::condition_variable available;
+    size_t max_queued;
+    size_t pinned = 0;
+    bool stopping = false;
+
+    void run(int cpu);
+};
+
+#endif // WORKER_POOL_H